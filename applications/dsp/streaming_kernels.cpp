@@ -0,0 +1,276 @@
+// streaming_kernels.cpp: verification of the streaming FIR, polyphase, biquad, and FFT kernels of the DSP library
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/dsp/dsp.hpp>
+#include <universal/verification/test_suite.hpp>
+
+namespace sw { namespace universal { namespace dsp {
+
+	// reproducible test signal: a sum of two tones and uniform noise, in [-1, 1]
+	std::vector<double> TestSignal(size_t N, unsigned seed) {
+		constexpr double pi = 3.14159265358979323846;
+		std::mt19937_64 engine(seed);
+		std::uniform_real_distribution<double> noise(-0.1, 0.1);
+		std::vector<double> x(N);
+		for (size_t i = 0; i < N; ++i) {
+			double t = static_cast<double>(i);
+			x[i] = 0.5 * std::sin(2.0 * pi * 0.01 * t) + 0.3 * std::sin(2.0 * pi * 0.23 * t) + noise(engine);
+		}
+		return x;
+	}
+
+	template<typename Sample>
+	std::vector<Sample> Quantize(const std::vector<double>& v) {
+		std::vector<Sample> q(v.size());
+		for (size_t i = 0; i < v.size(); ++i) q[i] = Sample(v[i]);
+		return q;
+	}
+
+	// maximum absolute difference between a sample sequence and a double reference
+	template<typename Sample>
+	double MaxError(const std::vector<Sample>& v, const std::vector<double>& ref, size_t n) {
+		double maxError{ 0.0 };
+		for (size_t i = 0; i < n; ++i) {
+			double e = std::abs(double(v[i]) - ref[i]);
+			if (e > maxError) maxError = e;
+		}
+		return maxError;
+	}
+
+	int VerifyRingBuffer(bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		ring_buffer<int> rb(4);
+		int in[6] = { 1, 2, 3, 4, 5, 6 }, out[6] = { 0 };
+		if (rb.write(in, 6) != 4 || !rb.full()) ++nrOfFailedTestCases;
+		if (rb.read(out, 2) != 2 || out[0] != 1 || out[1] != 2) ++nrOfFailedTestCases;
+		if (rb.write(in + 4, 2) != 2 || rb[0] != 3 || rb[3] != 6) ++nrOfFailedTestCases;
+		rb.push(7);  // overwrites the oldest sample
+		if (rb.pop() != 4 || rb.size() != 3) ++nrOfFailedTestCases;
+
+		delay_line<int> dl(3);
+		for (int i = 1; i <= 5; ++i) dl.push(i);
+		const int* w = dl.window();
+		if (w[0] != 3 || w[1] != 4 || w[2] != 5 || dl[0] != 5 || dl[2] != 3) ++nrOfFailedTestCases;
+		if (nrOfFailedTestCases && reportTestCases) std::cerr << "FAIL: ring buffer and delay line\n";
+		return nrOfFailedTestCases;
+	}
+
+	// direct form convolution in double as the reference
+	std::vector<double> Convolve(const std::vector<double>& h, const std::vector<double>& x) {
+		std::vector<double> y(x.size(), 0.0);
+		for (size_t n = 0; n < x.size(); ++n) {
+			for (size_t k = 0; k < h.size() && k <= n; ++k) y[n] += h[k] * x[n - k];
+		}
+		return y;
+	}
+
+	// FIR filter, decimator, and interpolator against the double reference
+	template<typename Sample, typename Coef = Sample>
+	int VerifyFir(double tolerance, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		constexpr size_t N = 256, M = 4, L = 3;
+		std::vector<double> h = fir_lowpass(31, 0.1);
+		std::vector<double> x = TestSignal(N, 7);
+		std::vector<Sample> xs = Quantize<Sample>(x);
+
+		// the reference uses the taps and samples that the filter sees
+		std::vector<double> hq(h.size()), xq(N);
+		for (size_t k = 0; k < h.size(); ++k) hq[k] = double(coefficient_cast<Sample, Coef>(h[k]));
+		for (size_t i = 0; i < N; ++i) xq[i] = double(xs[i]);
+		std::vector<double> ref = Convolve(hq, xq);
+
+		// streaming in blocks of different sizes must match a single pass
+		fir_filter<Sample, Coef> fir(h);
+		std::vector<Sample> y(N);
+		size_t blocks[] = { 1, 7, 64, 184 };
+		for (size_t b = 0, i = 0; b < 4; i += blocks[b], ++b) fir.process(xs.data() + i, y.data() + i, blocks[b]);
+		double e = MaxError(y, ref, N);
+		if (e > tolerance) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: fir max error " << e << '\n';
+		}
+
+		// the decimator keeps every M-th output of the filter
+		fir_decimator<Sample, Coef> decimator(h, M);
+		std::vector<Sample> yd(N / M + 1);
+		size_t nrOutputs = decimator.process(xs.data(), yd.data(), 101);
+		nrOutputs += decimator.process(xs.data() + 101, yd.data() + nrOutputs, N - 101);
+		if (nrOutputs != N / M) ++nrOfFailedTestCases;
+		for (size_t i = 0; i < nrOutputs; ++i) {
+			if (yd[i] != y[i * M]) {
+				++nrOfFailedTestCases;
+				if (reportTestCases) std::cerr << "FAIL: decimator output " << i << " : " << yd[i] << " != " << y[i * M] << '\n';
+				break;
+			}
+		}
+
+		// the interpolator is the filter applied to the zero-stuffed signal
+		fir_interpolator<Sample, Coef> interpolator(h, L);
+		std::vector<Sample> yi(N * L);
+		interpolator.process(xs.data(), yi.data(), N);
+		std::vector<double> stuffed(N * L, 0.0);
+		for (size_t i = 0; i < N; ++i) stuffed[i * L] = xq[i];
+		std::vector<double> iref = Convolve(hq, stuffed);
+		e = MaxError(yi, iref, N * L);
+		if (e > tolerance) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: interpolator max error " << e << '\n';
+		}
+		return nrOfFailedTestCases;
+	}
+
+	// biquad cascade against the difference equations evaluated in double
+	template<typename Sample, typename Coef = Sample>
+	int VerifyBiquad(double tolerance, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		constexpr size_t N = 256;
+		std::vector<biquad_coefficients> sections = { biquad_lowpass(1000.0, 48000.0), biquad_highpass(100.0, 48000.0), biquad_lowpass(2000.0, 48000.0, 1.3) };
+		std::vector<double> x = TestSignal(N, 11);
+		std::vector<Sample> xs = Quantize<Sample>(x);
+
+		std::vector<double> ref(N);
+		for (size_t i = 0; i < N; ++i) ref[i] = double(xs[i]);
+		for (const auto& c : sections) {
+			double b0 = double(coefficient_cast<Sample, Coef>(c.b0)), b1 = double(coefficient_cast<Sample, Coef>(c.b1)), b2 = double(coefficient_cast<Sample, Coef>(c.b2));
+			double a1 = double(coefficient_cast<Sample, Coef>(c.a1)), a2 = double(coefficient_cast<Sample, Coef>(c.a2));
+			double x1{ 0 }, x2{ 0 }, y1{ 0 }, y2{ 0 };
+			for (size_t i = 0; i < N; ++i) {
+				double xi = ref[i];
+				double yi = b0 * xi + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+				x2 = x1; x1 = xi; y2 = y1; y1 = yi;
+				ref[i] = yi;
+			}
+		}
+
+		biquad_cascade<Sample, Coef> block(sections), streaming(sections);
+		std::vector<Sample> y(xs), ys(N);
+		block.process(y.data(), y.data(), 100);   // in place, in two blocks
+		block.process(y.data() + 100, y.data() + 100, N - 100);
+		for (size_t i = 0; i < N; ++i) ys[i] = streaming.process(xs[i]);
+		double e = MaxError(y, ref, N);
+		if (e > tolerance) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: biquad cascade max error " << e << '\n';
+		}
+		for (size_t i = 0; i < N; ++i) {
+			if (y[i] != ys[i]) {
+				++nrOfFailedTestCases;
+				if (reportTestCases) std::cerr << "FAIL: block and sample processing differ at " << i << '\n';
+				break;
+			}
+		}
+		return nrOfFailedTestCases;
+	}
+
+	// FFT against the direct DFT in double, and the round trip through the inverse
+	template<typename Sample, typename Twiddle = Sample>
+	int VerifyFft(size_t N, double tolerance, bool reportTestCases) {
+		constexpr double pi = 3.14159265358979323846;
+		int nrOfFailedTestCases = 0;
+		using Complex = std::complex<Sample>;
+		std::vector<double> re = TestSignal(N, 3), im = TestSignal(N, 5);
+		std::vector<Complex> x(N);
+		for (size_t i = 0; i < N; ++i) x[i] = Complex(Sample(re[i]), Sample(im[i]));
+
+		fft<Sample, Twiddle> transform(N);
+		std::vector<Complex> X(x);
+		transform.forward(X);
+		double maxError{ 0.0 };
+		for (size_t k = 0; k < N; ++k) {
+			double sr{ 0 }, si{ 0 };
+			for (size_t n = 0; n < N; ++n) {
+				double angle = -2.0 * pi * static_cast<double>((n * k) % N) / static_cast<double>(N);
+				double xr = double(x[n].real()), xi = double(x[n].imag());
+				sr += xr * std::cos(angle) - xi * std::sin(angle);
+				si += xr * std::sin(angle) + xi * std::cos(angle);
+			}
+			maxError = std::max(maxError, std::max(std::abs(double(X[k].real()) - sr), std::abs(double(X[k].imag()) - si)));
+		}
+		if (maxError > tolerance * static_cast<double>(N)) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: fft of length " << N << " max error " << maxError << '\n';
+		}
+
+		transform.inverse(X);
+		maxError = 0.0;
+		for (size_t i = 0; i < N; ++i) {
+			maxError = std::max(maxError, std::max(std::abs(double(X[i].real()) - double(x[i].real())), std::abs(double(X[i].imag()) - double(x[i].imag()))));
+		}
+		if (maxError > tolerance * 4.0) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: inverse fft of length " << N << " max error " << maxError << '\n';
+		}
+		return nrOfFailedTestCases;
+	}
+
+}}} // namespace sw::universal::dsp
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::dsp;
+
+	std::string test_suite  = "DSP streaming kernels";
+	std::string test_tag    = "dsp";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	using Posit16 = posit<16, 1>;
+	using Posit32 = posit<32, 2>;
+	using Fixed   = fixpnt<16, 12, Saturate, uint16_t>;
+	using Float32 = cfloat<32, 8, uint32_t, true, false, false>;
+	using Lns16   = lns<16, 10, uint16_t>;
+
+	nrOfFailedTestCases += ReportTestResult(VerifyRingBuffer(reportTestCases), "ring_buffer", "streaming buffers");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<double>(1.0e-14, reportTestCases), "double", "fir");
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<Float32>(1.0e-6, reportTestCases), "cfloat<32,8>", "fir");
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<Posit16>(1.0e-3, reportTestCases), "posit<16,1>", "fir");
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<Fixed>(1.0e-3, reportTestCases), "fixpnt<16,12>", "fir");
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<Lns16>(1.0e-2, reportTestCases), "lns<16,10>", "fir");
+	nrOfFailedTestCases += ReportTestResult(VerifyFir<float, Posit16>(1.0e-5, reportTestCases), "float with posit<16,1> taps", "fir");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBiquad<double>(1.0e-12, reportTestCases), "double", "biquad cascade");
+	nrOfFailedTestCases += ReportTestResult(VerifyBiquad<Posit32>(1.0e-5, reportTestCases), "posit<32,2>", "biquad cascade");
+	nrOfFailedTestCases += ReportTestResult(VerifyBiquad<Float32>(1.0e-4, reportTestCases), "cfloat<32,8>", "biquad cascade");
+
+	for (size_t N : { 1, 2, 8, 32, 64, 256 }) {
+		nrOfFailedTestCases += ReportTestResult(VerifyFft<double>(N, 1.0e-14, reportTestCases), "double", "fft");
+	}
+	nrOfFailedTestCases += ReportTestResult(VerifyFft<Posit32>(128, 1.0e-6, reportTestCases), "posit<32,2>", "fft");
+	nrOfFailedTestCases += ReportTestResult(VerifyFft<Float32>(128, 1.0e-6, reportTestCases), "cfloat<32,8>", "fft");
+	nrOfFailedTestCases += ReportTestResult(VerifyFft<double, Posit16>(128, 1.0e-3, reportTestCases), "double with posit<16,1> twiddles", "fft");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -24,6 +24,7 @@
 #include <universal/blas/blas.hpp>
 #include <universal/blas/generators.hpp>
 #include <universal/blas/solvers/cg.hpp>
+#include <universal/blas/solvers/stencil.hpp>
 
 // CG residual trajectory experiment for tridiag(-1, 2, -1)
 template<typename Scalar, size_t MAX_ITERATIONS = 100>
@@ -49,6 +50,28 @@ size_t Experiment(size_t DoF) {
 	return itr;
 }
 
+// the same experiment with tridiag(-1, 2, -1) as the 3-point stencil operator of a 1D grid
+template<typename Scalar, size_t MAX_ITERATIONS = 100>
+size_t StencilExperiment(size_t DoF) {
+	using Matrix = sw::universal::blas::stencil_operator<Scalar>;
+	using Vector = sw::universal::blas::vector<Scalar>;
+
+	Matrix A(DoF, 1);
+	A.set(-1, 0, 0, Scalar(-1));
+	A.set( 0, 0, 0, Scalar(2));
+	A.set( 1, 0, 0, Scalar(-1));
+	Vector ones(DoF);
+	ones = Scalar(1);
+	Vector b = A * ones;
+	Matrix M = sw::universal::blas::inverse_diagonal(A);
+	Vector x(DoF);
+	Vector residuals;
+	size_t itr = sw::universal::blas::cg<Matrix, Vector, MAX_ITERATIONS>(M, A, b, x, residuals);
+	std::cout << "\"stencil " << typeid(Scalar).name() << "\" " << residuals << std::endl;
+
+	return itr;
+}
+
 #define MANUAL_TESTING 0
 #define STRESS_TESTING 0
 
@@ -115,6 +138,10 @@ try {
 	Experiment<posit<28, 1>>(64);
 	Experiment<posit<32,2>>(64);
 
+	// matrix-free
+	StencilExperiment<float>(64);
+	StencilExperiment<posit<32,2>>(64);
+
 
 /* results
 * Native IEEE floating point
@@ -20,6 +20,22 @@
 #include <universal/blas/blas.hpp>
 //#include <universal/blas/generators.hpp>
 #include <universal/blas/solvers/gauss_seidel.hpp>
+#include <universal/blas/solvers/stencil.hpp>
+
+// Gauss-Seidel iteration on the matrix-free 5-point Laplacian of an m x m grid, with the known solution x = 1
+template<typename Scalar>
+void StencilTest(size_t m) {
+	using namespace sw::universal::blas;
+	stencil_operator<Scalar> A;
+	laplace2D(A, m, m);
+	vector<Scalar> ones(A.size()), x(A.size());
+	ones = Scalar(1);
+	vector<Scalar> b = A * ones;
+	size_t iterations = GaussSeidel<Scalar, 1000>(A, b, x, Scalar(1.0e-4));
+	double error = 0.0;
+	for (size_t p = 0; p < A.size(); ++p) error = std::max(error, std::fabs(double(x[p]) - 1.0));
+	std::cout << "Gauss-Seidel iteration on the " << m << 'x' << m << " grid Laplacian: solution in " << iterations << " iterations, max error " << error << '\n';
+}
 
 int main(int argc, char** argv)
 try {
@@ -51,6 +67,10 @@ try {
 	std::cout << "solution in " << iterations << " iterations" << '\n';
 	std::cout << "solution is " << x << '\n';
 	std::cout << A * x << " = " << b << '\n';
+
+	// the same iteration on a stencil operator: no matrix is formed
+	StencilTest<float>(8);
+	StencilTest<Scalar>(8);
 	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 catch (char const* msg) {
@@ -18,6 +18,7 @@
 #include <universal/blas/blas.hpp>
 #include <universal/blas/generators.hpp>
 #include <universal/blas/solvers/jacobi.hpp>
+#include <universal/blas/solvers/stencil.hpp>
 
 // specialized for native floating-point
 template<typename Scalar,
@@ -59,6 +60,21 @@ void Test() {
 	std::cout << "-----------------------\n";
 }
 
+// Jacobi iteration on the matrix-free 5-point Laplacian of an m x m grid, with the known solution x = 1
+template<typename Scalar>
+void StencilTest(size_t m) {
+	using namespace sw::universal::blas;
+	stencil_operator<Scalar> A;
+	laplace2D(A, m, m);
+	vector<Scalar> ones(A.size()), x(A.size());
+	ones = Scalar(1);
+	vector<Scalar> b = A * ones;
+	size_t iterations = Jacobi<Scalar, 1000>(A, b, x, Scalar(1.0e-4));
+	double error = 0.0;
+	for (size_t p = 0; p < A.size(); ++p) error = std::max(error, std::fabs(double(x[p]) - 1.0));
+	std::cout << "Jacobi iteration on the " << m << 'x' << m << " grid Laplacian: solution in " << iterations << " iterations, max error " << error << '\n';
+}
+
 int main()
 try {
 	using namespace sw::universal;
@@ -70,6 +86,10 @@ try {
 
 	Test<posit<32, 2>>();
 
+	// the same iteration on a stencil operator: no matrix is formed
+	StencilTest<float>(8);
+	StencilTest<cfloat<32, 8, uint32_t>>(8);
+	StencilTest<posit<32, 2>>(8);
 
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,88 @@
+// poisson.cpp: Poisson equation on large grids with matrix-free stencil operators in different number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/solvers/krylov.hpp>
+#include <universal/blas/solvers/stencil.hpp>
+
+/*
+   -laplace(u) = f on the unit square with u = 0 on the boundary, discretized with the
+   5-point stencil on an m x m grid of interior points. The dense laplace2D matrix of a
+   1024 x 1024 grid would have 1.1e12 elements: the stencil operator stores five coefficients.
+   The grids of the native and the emulated types are the command line arguments, so that the
+   regression run stays short and 'poisson 1024 64' runs the large solves.
+
+   The right hand side is generated from the solution u(x,y) = 16 x (1 - x) y (1 - y) e^(x - y),
+   so the error of the solver can be measured against the discrete solution A u = b.
+*/
+
+template<typename Scalar, typename DotPolicy = sw::universal::blas::plain_dot>
+void Poisson(size_t m) {
+	using namespace sw::universal::blas;
+	stencil_operator<Scalar> A;
+	laplace2D(A, m, m);
+	A.threads(0);
+	const size_t N = A.size();
+	vector<Scalar> u(N), b(N), x(N);
+	double h = 1.0 / double(m + 1);
+	for (size_t j = 0; j < m; ++j) {
+		for (size_t i = 0; i < m; ++i) {
+			double x = h * double(i + 1), y = h * double(j + 1);
+			u[A.index(i, j)] = Scalar(16.0 * x * (1.0 - x) * y * (1.0 - y) * std::exp(x - y));
+		}
+	}
+	A.apply(u, b);
+
+	pcg_workspace<Scalar> ws;
+	krylov_configuration cfg;
+	cfg.tolerance = 1.0e-6;
+	cfg.maxIterations = 10 * m;
+	krylov_report report = pcg<DotPolicy>(A, inverse_diagonal(A), b, x, ws, cfg);
+	double error = 0.0;
+	for (size_t p = 0; p < N; ++p) error = std::max(error, std::fabs(double(x[p]) - double(u[p])));
+	std::cout << std::setw(30) << sw::universal::type_tag(Scalar()) << " : " << m << 'x' << m
+		<< " status " << report.status << " iterations " << std::setw(5) << report.iterations
+		<< " residual " << std::setw(12) << report.residual << " max error " << error << '\n';
+}
+
+int main(int argc, char** argv)
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	if (argc == 1) std::cout << argv[0] << '\n';
+
+	// native types on a grid of the size given on the command line, default 128 x 128:
+	// 'poisson 1024 64' solves on a grid that is out of reach of the dense operator
+	size_t grid = (argc > 1 ? size_t(std::stoul(argv[1])) : 128);
+	Poisson<float>(grid);
+	Poisson<double>(grid);
+
+	// emulated types on a smaller grid, the second command line argument, default 32 x 32
+	size_t m = (argc > 2 ? size_t(std::stoul(argv[2])) : 32);
+	Poisson<float>(m);
+	Poisson<posit<32, 2>>(m);
+	Poisson<posit<32, 2>, fused_dot>(m);
+
+	return EXIT_SUCCESS;
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
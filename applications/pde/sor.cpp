@@ -20,6 +20,7 @@
 #include <universal/blas/blas.hpp>
 #include <universal/blas/generators.hpp>
 #include <universal/blas/solvers/sor.hpp>
+#include <universal/blas/solvers/stencil.hpp>
 
 template<typename Matrix, typename Vector>
 void report(const Matrix& A, const Vector& b, const Vector& x, size_t itr, typename Vector::value_type& w) {
@@ -29,6 +30,26 @@ void report(const Matrix& A, const Vector& b, const Vector& x, size_t itr, typen
 	std::cout << "validation\n" << A * x << " = " << b << std::endl;
 }
 
+// SOR on the matrix-free 5-point Laplacian of an m x m grid, with the known solution x = 1,
+// for Gauss-Seidel (w = 1) and the optimal relaxation w = 2 / (1 + sin(pi h))
+template<typename Scalar>
+void StencilTest(size_t m) {
+	using namespace sw::universal::blas;
+	stencil_operator<Scalar> A;
+	laplace2D(A, m, m);
+	vector<Scalar> ones(A.size());
+	ones = Scalar(1);
+	vector<Scalar> b = A * ones;
+	double h = 1.0 / double(m + 1);
+	for (double w : { 1.0, 2.0 / (1.0 + std::sin(3.14159265358979323846 * h)) }) {
+		vector<Scalar> x(A.size());
+		size_t iterations = sor<Scalar, 1000>(A, b, x, Scalar(w), Scalar(1.0e-4));
+		double error = 0.0;
+		for (size_t p = 0; p < A.size(); ++p) error = std::max(error, std::fabs(double(x[p]) - 1.0));
+		std::cout << "SOR with w = " << w << " on the " << m << 'x' << m << " grid Laplacian: solution in " << iterations << " iterations, max error " << error << '\n';
+	}
+}
+
 int main(int argc, char** argv)
 try {
 	using namespace sw::universal;
@@ -93,6 +114,10 @@ try {
 
 	// TODO eig() operator
 
+	// SOR on a stencil operator: no matrix is formed
+	StencilTest<float>(16);
+	StencilTest<Scalar>(16);
+
 	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 catch (char const* msg) {
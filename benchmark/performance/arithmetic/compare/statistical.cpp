@@ -0,0 +1,70 @@
+// statistical.cpp : reproducible arithmetic operator benchmarks across number systems with machine-readable output
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#define POSIT_FAST_POSIT_8_0  1
+#define POSIT_FAST_POSIT_16_1 1
+#define POSIT_FAST_POSIT_32_2 1
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/benchmark/benchmark_harness.hpp>
+
+/*
+   Usage: benchmark_compare_statistical [--warmup N] [--samples N] [--cpu N] [--perf] [--json FILE] [--csv FILE]
+
+   Each workload is run warmup times untimed and then samples times timed. The report
+   shows the median time and its median absolute deviation, and the JSON output can be
+   compared against a baseline with the benchmark_compare tool:
+
+       benchmark_compare_statistical --cpu 2 --json v3.73.json
+       benchmark_compare_statistical --cpu 2 --json candidate.json
+       benchmark_compare v3.73.json candidate.json
+*/
+
+template<typename Scalar>
+void MeasureArithmeticOperators(sw::universal::BenchmarkHarness& harness, const std::string& tag, size_t NR_OPS) {
+	using namespace sw::universal;
+	harness.run(tag + " add/subtract", AdditionSubtractionWorkload<Scalar>, NR_OPS);
+	harness.run(tag + " multiply", MultiplicationWorkload<Scalar>, NR_OPS);
+	harness.run(tag + " division", DivisionWorkload<Scalar>, NR_OPS);
+}
+
+int main(int argc, char* argv[])
+try {
+	using namespace sw::universal;
+
+	BenchmarkConfiguration cfg;
+	cfg.warmup  = 1;
+	cfg.samples = 5;
+	if (!ParseBenchmarkCommandLine(argc, argv, cfg)) return EXIT_FAILURE;
+
+	BenchmarkHarness harness("arithmetic operators", cfg);
+
+	constexpr size_t NR_OPS = 100000;
+	MeasureArithmeticOperators< float >                                      (harness, "float", NR_OPS);
+	MeasureArithmeticOperators< double >                                     (harness, "double", NR_OPS);
+	MeasureArithmeticOperators< cfloat<16, 5, uint16_t, true, false, false> >(harness, "cfloat<16,5>", NR_OPS);
+	MeasureArithmeticOperators< cfloat<32, 8, uint32_t, true, false, false> >(harness, "cfloat<32,8>", NR_OPS);
+	MeasureArithmeticOperators< posit<16, 1> >                               (harness, "posit<16,1>", NR_OPS);
+	MeasureArithmeticOperators< posit<32, 2> >                               (harness, "posit<32,2>", NR_OPS);
+	MeasureArithmeticOperators< fixpnt<32, 16, Modulo, uint32_t> >           (harness, "fixpnt<32,16,Modulo,uint32_t>", NR_OPS);
+	MeasureArithmeticOperators< lns<16, 8> >                                 (harness, "lns<16,8>", NR_OPS);
+
+	return (harness.save() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (char const* msg) {
+	std::cerr << "Caught exception: " << msg << '\n';
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << '\n';
+	return EXIT_FAILURE;
+}
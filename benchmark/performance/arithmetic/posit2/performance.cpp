@@ -0,0 +1,90 @@
+// performance.cpp: performance characterization of the arithmetic operators of generalized posits
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+// Configure the posit template environment
+// first: enable general or specialized configurations
+#define POSIT_FAST_SPECIALIZATION
+// second: disable posit arithmetic exceptions
+#define POSIT_THROW_ARITHMETIC_EXCEPTION 0
+#include <universal/number/posit2/posit.hpp>
+#include <universal/verification/test_suite.hpp>
+#include <universal/benchmark/performance_runner.hpp>
+
+/*
+   The operators decode the encodings into a significand word and round the result
+   once: the word is a uint64_t when the fraction bits and the guard, round, and
+   sticky bits fit in 64 bits, and an array of uint64_t limbs otherwise.
+   posit<16,1> and posit<32,2> compare directly to the bitblock posit benchmarks
+   in ../posit, which run the same workloads.
+*/
+
+// measure performance of arithmetic operators
+void TestArithmeticOperatorPerformance() {
+	using namespace sw::universal;
+	std::cout << "generalized posit arithmetic operator performance\n";
+
+	uint64_t NR_OPS = 1000000;
+
+	PerformanceRunner("posit<8,0>               add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<8,0> >, NR_OPS);
+	PerformanceRunner("posit<16,1>              add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<16,1> >, NR_OPS);
+	PerformanceRunner("posit<32,2>              add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<32,2> >, NR_OPS);
+	PerformanceRunner("posit<64,2>              add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<64,2> >, NR_OPS);
+	PerformanceRunner("posit<128,2>             add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<128,2> >, NR_OPS / 2);
+	PerformanceRunner("posit<256,2>             add/subtract   ", AdditionSubtractionWorkload< sw::universal::posit<256,2> >, NR_OPS / 4);
+
+	NR_OPS = 1024 * 32;
+	PerformanceRunner("posit<8,0>               division       ", DivisionWorkload< sw::universal::posit<8,0> >, NR_OPS);
+	PerformanceRunner("posit<16,1>              division       ", DivisionWorkload< sw::universal::posit<16,1> >, NR_OPS);
+	PerformanceRunner("posit<32,2>              division       ", DivisionWorkload< sw::universal::posit<32,2> >, NR_OPS);
+	PerformanceRunner("posit<64,2>              division       ", DivisionWorkload< sw::universal::posit<64,2> >, NR_OPS);
+	PerformanceRunner("posit<128,2>             division       ", DivisionWorkload< sw::universal::posit<128,2> >, NR_OPS / 2);
+	PerformanceRunner("posit<256,2>             division       ", DivisionWorkload< sw::universal::posit<256,2> >, NR_OPS / 4);
+
+	NR_OPS = 1024 * 32;
+	PerformanceRunner("posit<8,0>               multiplication ", MultiplicationWorkload< sw::universal::posit<8,0> >, NR_OPS);
+	PerformanceRunner("posit<16,1>              multiplication ", MultiplicationWorkload< sw::universal::posit<16,1> >, NR_OPS);
+	PerformanceRunner("posit<32,2>              multiplication ", MultiplicationWorkload< sw::universal::posit<32,2> >, NR_OPS);
+	PerformanceRunner("posit<64,2>              multiplication ", MultiplicationWorkload< sw::universal::posit<64,2> >, NR_OPS);
+	PerformanceRunner("posit<128,2>             multiplication ", MultiplicationWorkload< sw::universal::posit<128,2> >, NR_OPS / 2);
+	PerformanceRunner("posit<256,2>             multiplication ", MultiplicationWorkload< sw::universal::posit<256,2> >, NR_OPS / 4);
+}
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "generalized posit operator performance benchmarking";
+	std::string test_tag    = "posit2 performance";
+	bool reportTestCases    = false;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	TestArithmeticOperatorPerformance();
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -30,14 +30,6 @@ std::string conditional_fdp(const sw::universal::blas::vector< sw::universal::po
 	return ss.str();
 }
 
-#if EDECIMAL_OPERATIONS_COUNT
-
-// create the static storage for the occurrence measurements of the decimal number system
-bool sw::universal::edecimal::enableAdd = true;
-sw::universal::occurrence<sw::universal::edecimal> sw::universal::edecimal::ops;
-
-#endif
-
 int main()
 try {
 	using namespace sw::universal::blas;
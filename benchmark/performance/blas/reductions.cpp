@@ -0,0 +1,112 @@
+// reductions.cpp: performance of the reduction policies of the blas dot product and sum
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/benchmark/benchmark_harness.hpp>
+
+/*
+   Usage: performance_reductions [harness options]
+
+   Measures blas::dot and blas::sum with each reduction policy. The compensated policies,
+   neumaier and dot2, are the accurate alternatives for the number systems without a
+   quire, and the interesting figure is their cost relative to the naive policy, which
+   the harness reports as the ratio of the median times.
+*/
+
+// volatile sink so that the optimizer cannot remove the kernels
+static volatile double sink;
+
+template<typename Scalar>
+void fill_uniform(sw::universal::blas::vector<Scalar>& v, unsigned seed) {
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	for (auto& e : v) e = Scalar(dist(engine));
+}
+
+template<typename Scalar, typename ReductionPolicy>
+double MeasureDot(sw::universal::BenchmarkHarness& harness, const std::string& tag, const std::string& policy, const sw::universal::blas::vector<Scalar>& x, const sw::universal::blas::vector<Scalar>& y) {
+	using namespace sw::universal::blas;
+	size_t N = size(x);
+	const auto& r = harness.run(tag + " dot " + policy + " N=" + std::to_string(N), [&](size_t) { sink = double(dot<ReductionPolicy>(x, y)); }, 2 * N, 2 * N * sizeof(Scalar));
+	return r.stats.median;
+}
+
+template<typename Scalar, typename ReductionPolicy>
+double MeasureSum(sw::universal::BenchmarkHarness& harness, const std::string& tag, const std::string& policy, const sw::universal::blas::vector<Scalar>& x) {
+	using namespace sw::universal::blas;
+	size_t N = size(x);
+	const auto& r = harness.run(tag + " sum " + policy + " N=" + std::to_string(N), [&](size_t) { sink = double(sum<ReductionPolicy>(x)); }, N, N * sizeof(Scalar));
+	return r.stats.median;
+}
+
+template<typename Scalar>
+void MeasureReductions(sw::universal::BenchmarkHarness& harness, const std::string& tag, size_t N) {
+	using namespace sw::universal::blas;
+	vector<Scalar> x(N), y(N);
+	fill_uniform(x, 1);
+	fill_uniform(y, 2);
+
+	double naive = MeasureDot<Scalar, naive_reduction>(harness, tag, "naive", x, y);
+	double unrolled = MeasureDot<Scalar, unrolled_reduction>(harness, tag, "unrolled", x, y);
+	double pairwise = MeasureDot<Scalar, pairwise_reduction>(harness, tag, "pairwise", x, y);
+	double neumaier = MeasureDot<Scalar, neumaier_reduction>(harness, tag, "neumaier", x, y);
+	double dot2 = MeasureDot<Scalar, dot2_reduction>(harness, tag, "dot2", x, y);
+	double quire = MeasureDot<Scalar, quire_reduction>(harness, tag, "quire", x, y);
+	std::cout << tag << " dot time relative to naive: unrolled " << unrolled / naive << ", pairwise " << pairwise / naive << ", neumaier " << neumaier / naive
+		<< ", dot2 " << dot2 / naive << ", quire " << quire / naive << "\n\n";
+
+	naive = MeasureSum<Scalar, naive_reduction>(harness, tag, "naive", x);
+	unrolled = MeasureSum<Scalar, unrolled_reduction>(harness, tag, "unrolled", x);
+	pairwise = MeasureSum<Scalar, pairwise_reduction>(harness, tag, "pairwise", x);
+	neumaier = MeasureSum<Scalar, neumaier_reduction>(harness, tag, "neumaier", x);
+	std::cout << tag << " sum time relative to naive: unrolled " << unrolled / naive << ", pairwise " << pairwise / naive << ", neumaier " << neumaier / naive << "\n\n";
+}
+
+int main(int argc, char* argv[])
+try {
+	using namespace sw::universal;
+
+	BenchmarkConfiguration cfg;
+	cfg.warmup = 1;
+	cfg.samples = 5;
+	if (!ParseBenchmarkCommandLine(argc, argv, cfg)) return EXIT_FAILURE;
+
+	BenchmarkHarness harness("blas reductions", cfg);
+
+	MeasureReductions< float >                                       (harness, "float", 1'000'000);
+	MeasureReductions< double >                                      (harness, "double", 1'000'000);
+	MeasureReductions< cfloat<32, 8, uint32_t, true, false, false> > (harness, "cfloat<32,8>", 10'000);
+	MeasureReductions< posit<32, 2> >                                (harness, "posit<32,2>", 10'000);
+
+	return (harness.save() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (char const* msg) {
+	std::cerr << "Caught exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
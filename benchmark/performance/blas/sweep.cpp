@@ -0,0 +1,229 @@
+// sweep.cpp: BLAS L1/L2/L3 performance sweep across problem sizes and number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+// configure posit environment using fast posits
+#define POSIT_FAST_POSIT_8_0 1
+#define POSIT_FAST_POSIT_16_1 1
+#define POSIT_FAST_POSIT_32_2 1
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/number/bfloat/bfloat.hpp>
+// the fdp variants measure the fused dot and matrix-vector products
+#define BLAS_FUSED_DOT_PRODUCT 1
+#include <universal/blas/blas.hpp>
+#include <universal/benchmark/benchmark_harness.hpp>
+
+/*
+   Usage: performance_sweep [--full] [--level 1|2|3] [harness options]
+
+   Sweeps the BLAS kernels over problem sizes and number systems and reports the
+   throughput in FLOP-equivalents per second (one multiply and one add per term)
+   together with the compulsory memory traffic of the kernel:
+
+       dot    :  2N   FLOPs,  2N       elements moved
+       matvec :  2N^2 FLOPs,  N^2 + 2N elements moved
+       gemm   :  2N^3 FLOPs,  3N^2     elements moved
+
+   Number systems with a quire report the fused-dot product variant ("fdp") separately
+   from the plain variant that rounds after every multiply and add ("dot"). The posits
+   use their quire for all three kernels, cfloat, fixpnt, lns, and bfloat16 use the
+   Kulisch quire for dot and matvec.
+
+   The default sweep is sized to run as a regression test. --full sweeps the L1 kernels
+   from 10^2 to 10^7 elements and the L2/L3 kernels up to 4096 x 4096, which takes hours
+   for the slower software-emulated types. Use the harness options --json/--csv to
+   capture the results, and benchmark_compare to detect regressions between runs.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+// reproducible operands: the same seed yields the same values for every run and every type
+template<typename Scalar>
+void fill_uniform(vector<Scalar>& v, unsigned seed) {
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	for (auto& e : v) e = Scalar(dist(engine));
+}
+template<typename Scalar>
+void fill_uniform(matrix<Scalar>& A, unsigned seed) {
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	for (auto& e : A) e = Scalar(dist(engine));
+}
+
+// plain dot product and matrix-vector product that round after every operation:
+// blas::dot and blas::matvec are fused for the number systems with a Kulisch quire
+template<typename Scalar>
+Scalar dot_plain(const vector<Scalar>& x, const vector<Scalar>& y) {
+	Scalar sum{ 0 };
+	for (size_t i = 0; i < size(x); ++i) sum += x[i] * y[i];
+	return sum;
+}
+template<typename Scalar>
+void matvec_plain(vector<Scalar>& b, const matrix<Scalar>& A, const vector<Scalar>& x) {
+	for (unsigned i = 0; i < A.rows(); ++i) {
+		Scalar e{ 0 };
+		for (unsigned j = 0; j < A.cols(); ++j) e += A(i, j) * x[j];
+		b[i] = e;
+	}
+}
+
+// plain matrix-matrix product that rounds after every operation, independent of any fdp overloads
+template<typename Scalar>
+void gemm_plain(matrix<Scalar>& C, const matrix<Scalar>& A, const matrix<Scalar>& B) {
+	unsigned rows = A.rows(), cols = B.cols(), dots = A.cols();
+	for (unsigned i = 0; i < rows; ++i) {
+		for (unsigned j = 0; j < cols; ++j) {
+			Scalar e{ 0 };
+			for (unsigned k = 0; k < dots; ++k) e += A(i, k) * B(k, j);
+			C(i, j) = e;
+		}
+	}
+}
+
+}}} // namespace sw::universal::blas
+
+struct SweepConfiguration {
+	bool     full{ false };
+	int      level{ 0 };  // 0 is all levels
+	// the budget caps the number of multiply-adds of the slowest sample so that
+	// slow software types are not swept to sizes that take hours per sample
+	uint64_t budget{ 1ull << 16 };
+};
+
+// volatile sink so that the optimizer cannot remove the kernels
+static volatile double sink;
+
+template<typename Scalar>
+void SweepL1(sw::universal::BenchmarkHarness& harness, const std::string& tag, const SweepConfiguration& cfg) {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+	size_t maxN = (cfg.full ? 10'000'000 : 10'000);
+	for (size_t N = 100; N <= maxN; N *= 10) {
+		if (N > cfg.budget) break;
+		vector<Scalar> x(N), y(N);
+		fill_uniform(x, 1);
+		fill_uniform(y, 2);
+		size_t bytes = 2 * N * sizeof(Scalar);
+		harness.run(tag + " dot N=" + std::to_string(N), [&](size_t) { sink = double(dot_plain(x, y)); }, 2 * N, bytes);
+		if constexpr (is_posit<Scalar> || is_kulisch_enabled<Scalar>) {
+			harness.run(tag + " fdp N=" + std::to_string(N), [&](size_t) { sink = double(fdp(x, y)); }, 2 * N, bytes);
+		}
+		harness.run(tag + " axpy N=" + std::to_string(N), [&](size_t) { axpy(N, Scalar(0.5), x, 1, y, 1); }, 2 * N, 3 * N * sizeof(Scalar));
+	}
+}
+
+template<typename Scalar>
+void SweepL2(sw::universal::BenchmarkHarness& harness, const std::string& tag, const SweepConfiguration& cfg) {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+	unsigned maxN = (cfg.full ? 4096 : 64);
+	for (unsigned N = 16; N <= maxN; N *= 2) {
+		if (uint64_t(N) * N > cfg.budget) break;
+		matrix<Scalar> A(N, N);
+		vector<Scalar> x(N), b(N);
+		fill_uniform(A, 3);
+		fill_uniform(x, 4);
+		size_t flops = 2ull * N * N;
+		size_t bytes = (size_t(N) * N + 2ull * N) * sizeof(Scalar);
+		harness.run(tag + " matvec dot N=" + std::to_string(N), [&](size_t) { matvec_plain(b, A, x); sink = double(b[0]); }, flops, bytes);
+		if constexpr (is_posit<Scalar>) {
+			harness.run(tag + " matvec fdp N=" + std::to_string(N), [&](size_t) { b = A * x; sink = double(b[0]); }, flops, bytes);
+		}
+		else if constexpr (is_kulisch_enabled<Scalar>) {
+			harness.run(tag + " matvec fdp N=" + std::to_string(N), [&](size_t) { matvec(b, A, x); sink = double(b[0]); }, flops, bytes);
+		}
+	}
+}
+
+template<typename Scalar>
+void SweepL3(sw::universal::BenchmarkHarness& harness, const std::string& tag, const SweepConfiguration& cfg) {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+	unsigned maxN = (cfg.full ? 4096 : 32);
+	for (unsigned N = 16; N <= maxN; N *= 2) {
+		if (uint64_t(N) * N * N > cfg.budget) break;
+		matrix<Scalar> A(N, N), B(N, N), C(N, N);
+		fill_uniform(A, 5);
+		fill_uniform(B, 6);
+		size_t flops = 2ull * N * N * N;
+		size_t bytes = 3ull * N * N * sizeof(Scalar);
+		harness.run(tag + " gemm dot N=" + std::to_string(N), [&](size_t) { gemm_plain(C, A, B); sink = double(C(0, 0)); }, flops, bytes);
+		if constexpr (is_posit<Scalar>) {
+			harness.run(tag + " gemm fdp N=" + std::to_string(N), [&](size_t) { C = A * B; sink = double(C(0, 0)); }, flops, bytes);
+		}
+	}
+}
+
+template<typename Scalar>
+void Sweep(sw::universal::BenchmarkHarness& harness, const std::string& tag, const SweepConfiguration& cfg, uint64_t budget) {
+	SweepConfiguration typeCfg = cfg;
+	typeCfg.budget = (cfg.full ? ~0ull : budget);
+	if (cfg.level == 0 || cfg.level == 1) SweepL1<Scalar>(harness, tag, typeCfg);
+	if (cfg.level == 0 || cfg.level == 2) SweepL2<Scalar>(harness, tag, typeCfg);
+	if (cfg.level == 0 || cfg.level == 3) SweepL3<Scalar>(harness, tag, typeCfg);
+}
+
+int main(int argc, char* argv[])
+try {
+	using namespace sw::universal;
+
+	// split the sweep options from the harness options
+	SweepConfiguration sweep;
+	std::vector<char*> harnessArgs{ argv[0] };
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg == "--full") sweep.full = true;
+		else if (arg == "--level" && i + 1 < argc) sweep.level = std::stoi(argv[++i]);
+		else harnessArgs.push_back(argv[i]);
+	}
+	BenchmarkConfiguration cfg;
+	cfg.warmup = 1;
+	cfg.samples = 3;
+	if (!ParseBenchmarkCommandLine(static_cast<int>(harnessArgs.size()), harnessArgs.data(), cfg)) return EXIT_FAILURE;
+
+	BenchmarkHarness harness("blas sweep", cfg);
+
+	// budgets, in multiply-adds per sample, for the regression sweep reflect the relative cost of the emulation
+	Sweep< float >                                        (harness, "float", sweep, 1ull << 24);
+	Sweep< double >                                       (harness, "double", sweep, 1ull << 24);
+	Sweep< bfloat16 >                                     (harness, "bfloat16", sweep, 1ull << 20);
+	Sweep< posit<16, 1> >                                 (harness, "posit<16,1>", sweep, 1ull << 16);
+	Sweep< posit<32, 2> >                                 (harness, "posit<32,2>", sweep, 1ull << 16);
+	Sweep< cfloat<16, 5, uint16_t, true, false, false> >  (harness, "cfloat<16,5>", sweep, 1ull << 14);
+	Sweep< cfloat<32, 8, uint32_t, true, false, false> >  (harness, "cfloat<32,8>", sweep, 1ull << 14);
+	Sweep< fixpnt<16, 8, Modulo, uint16_t> >              (harness, "fixpnt<16,8>", sweep, 1ull << 14);
+	Sweep< lns<16, 8> >                                   (harness, "lns<16,8>", sweep, 1ull << 12);
+
+	return (harness.save() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (char const* msg) {
+	std::cerr << "Caught exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
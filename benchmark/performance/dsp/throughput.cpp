@@ -0,0 +1,121 @@
+// throughput.cpp: sample-rate throughput of the streaming DSP kernels across number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+// configure posit environment using fast posits
+#define POSIT_FAST_POSIT_16_1 1
+#define POSIT_FAST_POSIT_32_2 1
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/dsp/dsp.hpp>
+#include <universal/benchmark/benchmark_harness.hpp>
+
+/*
+   Usage: dsp_throughput [--full] [harness options]
+
+   Streams a test signal through the DSP kernels and reports the throughput in samples per
+   second, which is the highest sample rate that a single core sustains for the kernel:
+
+       fir        :  64-tap lowpass filter, one output per input sample
+       decimate   :  64-tap lowpass filter and downsampling by 4, per input sample
+       biquad     :  cascade of 4 second-order sections, per sample
+       fft        :  1024-point complex transform, per transformed sample
+
+   The filters accumulate posits in their quire and cfloat, fixpnt, and lns in a Kulisch
+   quire, unless DSP_FUSED_DOT_PRODUCT is set to 0. The default block is sized to run as a
+   regression test, --full streams one second of audio at 48kHz per sample.
+*/
+
+// volatile sink so that the optimizer cannot remove the kernels
+static volatile double sink;
+
+template<typename Sample>
+void Throughput(sw::universal::BenchmarkHarness& harness, const std::string& tag, size_t N) {
+	using namespace sw::universal::dsp;
+	using Complex = std::complex<Sample>;
+
+	std::mt19937_64 engine(1);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	std::vector<Sample> x(N), y(N);
+	for (auto& v : x) v = Sample(dist(engine));
+
+	std::vector<double> taps = fir_lowpass(64, 0.1);
+	fir_filter<Sample> fir(taps);
+	harness.run(tag + " fir 64 taps", [&](size_t n) { fir.process(x.data(), y.data(), n); sink = double(y[0]); }, N);
+
+	fir_decimator<Sample> decimator(taps, 4);
+	harness.run(tag + " decimate by 4", [&](size_t n) { sink = double(decimator.process(x.data(), y.data(), n)); }, N);
+
+	biquad_cascade<Sample> biquad({ biquad_lowpass(4000.0, 48000.0), biquad_lowpass(4000.0, 48000.0, 1.3),
+		biquad_highpass(50.0, 48000.0), biquad_highpass(50.0, 48000.0, 1.3) });
+	harness.run(tag + " biquad 4 sections", [&](size_t n) { biquad.process(x.data(), y.data(), n); sink = double(y[0]); }, N);
+
+	constexpr size_t FFT_SIZE = 1024;
+	fft<Sample> transform(FFT_SIZE);
+	std::vector<Complex> frame(FFT_SIZE);
+	size_t nrFrames = (N + FFT_SIZE - 1) / FFT_SIZE;
+	harness.run(tag + " fft 1024", [&](size_t) {
+		for (size_t f = 0; f < nrFrames; ++f) {
+			for (size_t i = 0; i < FFT_SIZE; ++i) frame[i] = Complex(x[(f * FFT_SIZE + i) % N], Sample(0));
+			transform.forward(frame.data());
+		}
+		sink = double(frame[1].real());
+	}, nrFrames * FFT_SIZE);
+}
+
+int main(int argc, char* argv[])
+try {
+	using namespace sw::universal;
+
+	bool full{ false };
+	std::vector<char*> harnessArgs{ argv[0] };
+	for (int i = 1; i < argc; ++i) {
+		if (std::string(argv[i]) == "--full") full = true; else harnessArgs.push_back(argv[i]);
+	}
+	BenchmarkConfiguration cfg;
+	cfg.warmup = 1;
+	cfg.samples = 3;
+	if (!ParseBenchmarkCommandLine(static_cast<int>(harnessArgs.size()), harnessArgs.data(), cfg)) return EXIT_FAILURE;
+
+	BenchmarkHarness harness("dsp throughput", cfg);
+
+	size_t N = (full ? 48000 : 2048);
+	Throughput< float >                                        (harness, "float", N);
+	Throughput< double >                                       (harness, "double", N);
+	Throughput< posit<16, 1> >                                 (harness, "posit<16,1>", N);
+	Throughput< posit<32, 2> >                                 (harness, "posit<32,2>", N);
+	Throughput< cfloat<32, 8, uint32_t, true, false, false> >  (harness, "cfloat<32,8>", N);
+	Throughput< fixpnt<16, 12, Saturate, uint16_t> >           (harness, "fixpnt<16,12>", N);
+	Throughput< lns<16, 10, uint16_t> >                        (harness, "lns<16,10>", N);
+
+	return (harness.save() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (char const* msg) {
+	std::cerr << "Caught exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -3,6 +3,12 @@
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#if defined(__GNUC__) && !defined(__clang__)
+// gcc folds the identical std::bitset members of the different bitblock sizes of the generic posits
+// into one function, and -Warray-bounds then checks the folded body against the smaller bitblock
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+#include <new>
 #include <tuple>
 #include <universal/number/posit/posit_c_api.h>
 
@@ -13,11 +19,14 @@
 // POSIT_ENABLE_LITERALS
 // Disable exceptions
 #define POSIT_THROW_ARITHMETIC_EXCEPTION 0
-// Disable standard posit specializations for the shim
+// Enable the fast posit specializations for the shim, so that C programs run the same arithmetic as C++ programs
+// posit<8,0> is built on the C implementation in posit_8_0.h, whose function names collide with this API,
+// and posit<4,0> has no quire support: both use the generic posit, as do posit<64,3>, posit<128,4>,
+// and posit<256,5>, which do not have a fast specialization yet
 #define POSIT_FAST_POSIT_4_0   0
 #define POSIT_FAST_POSIT_8_0   0
-#define POSIT_FAST_POSIT_16_1  0
-#define POSIT_FAST_POSIT_32_2  0
+#define POSIT_FAST_POSIT_16_1  1
+#define POSIT_FAST_POSIT_32_2  1
 #define POSIT_FAST_POSIT_64_3  0
 #define POSIT_FAST_POSIT_128_4 0
 #define POSIT_FAST_POSIT_256_5 0
@@ -130,6 +139,21 @@ template<size_t nbits, size_t es, class positN_t> class convert_bytes : convert<
 	}
 };
 
+// convert_bits moves the encoding of posits up to 64 bits as a single word: there is no marshalling through a bitblock
+template<size_t nbits, size_t es, class positN_t> class convert_bits : convert<nbits,es,positN_t> {
+	public:
+	static sw::universal::posit<nbits, es> decode(positN_t bits) {
+		sw::universal::posit<nbits, es> pa;
+		pa.setbits(bits.v);
+		return pa;
+	}
+	static positN_t encode(sw::universal::posit<nbits, es> p) {
+		positN_t out;
+		out.v = static_cast<decltype(out.v)>(p.encoding());
+		return out;
+	}
+};
+
 // operation<2,1> = 2 args, 1 result
 template<size_t nbits, size_t es> class operation21 {
 	public:
@@ -259,13 +283,83 @@ template<size_t _nbits, size_t _es, class positN_t, class positNx2_t, class conv
 		posit<nbits, es> pb = convert::decode(b);
 		return (pa > pb) ? 1 : (pa < pb) ? -1 : 0;
 	}
+
+	// array entry points: a single call across the C ABI processes n elements
+
+	template<class operation21>
+	static void op21_array(const positN_t* a, const positN_t* b, positN_t* c, size_t n) {
+		using namespace sw::universal;
+		for (size_t i = 0; i < n; ++i) {
+			posit<nbits, es> res = operation21::op(convert::decode(a[i]), convert::decode(b[i]));
+			c[i] = convert::encode(res);
+		}
+	}
+
+	template<class in>
+	static void from_array(const in* a, positN_t* out, size_t n) {
+		using namespace sw::universal;
+		for (size_t i = 0; i < n; ++i) {
+			posit<nbits, es> pa(a[i]);
+			out[i] = convert::encode(pa);
+		}
+	}
+
+	template<class out>
+	static void to_array(const positN_t* a, out* o, size_t n) {
+		using namespace sw::universal;
+		for (size_t i = 0; i < n; ++i) {
+			o[i] = static_cast<out>(convert::decode(a[i]));
+		}
+	}
+
+	// dot product that rounds each multiply and add
+	static positN_t dot(const positN_t* x, const positN_t* y, size_t n) {
+		using namespace sw::universal;
+		posit<nbits, es> sum(0);
+		for (size_t i = 0; i < n; ++i) {
+			sum += convert::decode(x[i]) * convert::decode(y[i]);
+		}
+		return convert::encode(sum);
+	}
+
+	// quire accumulation: the products are exact and there is a single rounding when the quire is converted to a posit
+	using quire_type = sw::universal::quire<nbits, es>;
+
+	static void quire_fdp(quire_type& q, const positN_t* x, const positN_t* y, size_t n) {
+		using namespace sw::universal;
+		for (size_t i = 0; i < n; ++i) {
+			q += quire_mul(convert::decode(x[i]), convert::decode(y[i]));
+		}
+	}
+
+	static void quire_fma(quire_type& q, positN_t a, positN_t b) {
+		using namespace sw::universal;
+		q += quire_mul(convert::decode(a), convert::decode(b));
+	}
+
+	static void quire_add(quire_type& q, positN_t a) {
+		q += convert::decode(a);
+	}
+
+	static positN_t quire_round(const quire_type& q) {
+		using namespace sw::universal;
+		posit<nbits, es> sum;
+		sw::universal::convert(q.to_value(), sum);
+		return convert::encode(sum);
+	}
+
+	static positN_t fdp(const positN_t* x, const positN_t* y, size_t n) {
+		quire_type q;
+		quire_fdp(q, x, y, n);
+		return quire_round(q);
+	}
 };
 
-typedef capi<4,0,posit4_t,posit4x2_t,convert_bytes<4,0,posit4_t>> capi4;
-typedef capi<8,0,posit8_t,posit8x2_t,convert_bytes<8,0,posit8_t>> capi8;
-typedef capi<16,1,posit16_t,posit16x2_t,convert_bytes<16,1,posit16_t>> capi16;
-typedef capi<32,2,posit32_t,posit32x2_t,convert_bytes<32,2,posit32_t>> capi32;
-typedef capi<64,3,posit64_t,posit64x2_t,convert_bytes<64,3,posit64_t>> capi64;
+typedef capi<4,0,posit4_t,posit4x2_t,convert_bits<4,0,posit4_t>> capi4;
+typedef capi<8,0,posit8_t,posit8x2_t,convert_bits<8,0,posit8_t>> capi8;
+typedef capi<16,1,posit16_t,posit16x2_t,convert_bits<16,1,posit16_t>> capi16;
+typedef capi<32,2,posit32_t,posit32x2_t,convert_bits<32,2,posit32_t>> capi32;
+typedef capi<64,3,posit64_t,posit64x2_t,convert_bits<64,3,posit64_t>> capi64;
 typedef capi<128,4,posit128_t,posit128x2_t,convert_bytes<128,4,posit128_t>> capi128;
 typedef capi<256,5,posit256_t,posit256x2_t,convert_bytes<256,5,posit256_t>> capi256;
 
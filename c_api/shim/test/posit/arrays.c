@@ -0,0 +1,113 @@
+// arrays.c: test of the array functions and the quire handles of the posit API for C programs
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#if defined(_MSC_VER)
+#define POSIT_NO_GENERICS // MSVC doesn't support _Generic so we'll leave it out from these tests
+#endif
+#include <universal/number/posit/posit_c_api.h>
+
+#define N 256
+
+int main(int argc, char* argv[])
+{
+	static posit8_t a8[N * N], b8[N * N], c8[N * N];
+	posit32_t x[N], y[N], z[N];
+	double dx[N], dy[N];
+	bool failures = false;
+
+	// the array operators of posit8_t against the scalar operators for all pairs of encodings
+	for (int a = 0; a < N; ++a) {
+		for (int b = 0; b < N; ++b) {
+			a8[a * N + b] = posit8_reinterpret((uint8_t)a);
+			b8[a * N + b] = posit8_reinterpret((uint8_t)b);
+		}
+	}
+	int fails = 0;
+	posit8_add_array(a8, b8, c8, N * N);
+	for (int i = 0; i < N * N; ++i) if (posit8_bits(c8[i]) != posit8_bits(posit8_add(a8[i], b8[i]))) ++fails;
+	posit8_sub_array(a8, b8, c8, N * N);
+	for (int i = 0; i < N * N; ++i) if (posit8_bits(c8[i]) != posit8_bits(posit8_sub(a8[i], b8[i]))) ++fails;
+	posit8_mul_array(a8, b8, c8, N * N);
+	for (int i = 0; i < N * N; ++i) if (posit8_bits(c8[i]) != posit8_bits(posit8_mul(a8[i], b8[i]))) ++fails;
+	posit8_div_array(a8, b8, c8, N * N);
+	for (int i = 0; i < N * N; ++i) if (posit8_bits(c8[i]) != posit8_bits(posit8_div(a8[i], b8[i]))) ++fails;
+	if (fails) {
+		printf("posit8 arrays     FAIL\n");
+		failures = true;
+	}
+	else {
+		printf("posit8 arrays     PASS\n");
+	}
+
+	// conversion of double arrays, and the array operators of posit32_t
+	for (int i = 0; i < N; ++i) {
+		dx[i] = 1.0 + i / 16.0;
+		dy[i] = 0.5 - i / 64.0;
+	}
+	posit32_from_double_array(dx, x, N);
+	posit32_from_double_array(dy, y, N);
+	fails = 0;
+	for (int i = 0; i < N; ++i) if (posit32_bits(x[i]) != posit32_bits(posit32_fromd(dx[i]))) ++fails;
+	posit32_to_double_array(x, dy, N);
+	for (int i = 0; i < N; ++i) if (dy[i] != dx[i]) ++fails;  // the values are exact in posit32_t
+	posit32_mul_array(x, y, z, N);
+	for (int i = 0; i < N; ++i) if (posit32_bits(z[i]) != posit32_bits(posit32_mul(x[i], y[i]))) ++fails;
+	if (fails) {
+		printf("posit32 arrays    FAIL\n");
+		failures = true;
+	}
+	else {
+		printf("posit32 arrays    PASS\n");
+	}
+
+	// dot rounds every operation and matches the scalar loop
+	posit32_t sum = posit32_fromsi(0);
+	for (int i = 0; i < N; ++i) sum = posit32_add(sum, posit32_mul(x[i], y[i]));
+	fails = (posit32_bits(posit32_dot(x, y, N)) != posit32_bits(sum));
+
+	// fdp rounds once: the unit survives the cancellation of the large terms
+	double dl[3] = { 1.0e10, 1.0, -1.0e10 };
+	double dr[3] = { 1.0, 1.0, 1.0 };
+	posit32_t l[3], r[3];
+	posit32_from_double_array(dl, l, 3);
+	posit32_from_double_array(dr, r, 3);
+	if (posit32_tod(posit32_dot(l, r, 3)) != 0.0) ++fails;
+	if (posit32_tod(posit32_fdp(l, r, 3)) != 1.0) ++fails;
+	if (fails) {
+		printf("posit32 dot/fdp   FAIL\n");
+		failures = true;
+	}
+	else {
+		printf("posit32 dot/fdp   PASS\n");
+	}
+
+	// a quire handle accumulates across calls
+	fails = 0;
+	posit32_quire_t q = posit32_quire_new();
+	if (q == NULL) {
+		printf("posit32 quire     FAIL: allocation\n");
+		return EXIT_FAILURE;
+	}
+	posit32_quire_fdp(q, x, y, N / 2);
+	posit32_quire_fdp(q, x + N / 2, y + N / 2, N - N / 2);
+	if (posit32_bits(posit32_quire_round(q)) != posit32_bits(posit32_fdp(x, y, N))) ++fails;
+	posit32_quire_clear(q);
+	posit32_quire_fma(q, l[0], r[0]);
+	posit32_quire_add(q, l[1]);
+	posit32_quire_fma(q, l[2], r[2]);
+	if (posit32_tod(posit32_quire_round(q)) != 1.0) ++fails;
+	posit32_quire_clear(q);
+	if (posit32_tod(posit32_quire_round(q)) != 0.0) ++fails;
+	posit32_quire_free(q);
+	if (fails) {
+		printf("posit32 quire     FAIL\n");
+		failures = true;
+	}
+	else {
+		printf("posit32 quire     PASS\n");
+	}
+
+	return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
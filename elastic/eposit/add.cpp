@@ -1,6 +1,6 @@
 // add.cpp: functional tests for addition on adaptive precision tapered floating-point
 //
-// Copyright (C) 2017-2022 Stillwater Supercomputing, Inc.
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 #include <universal/utility/directives.hpp>
@@ -10,19 +10,18 @@
 #include <string>
 #include <cmath>
 #include <limits>
+#include <random>
 
 // minimum set of include files to reflect source code dependencies
 #include <universal/number/eposit/eposit.hpp>
+#include <universal/number/posit/posit.hpp>
 #include <universal/verification/test_suite.hpp>
 
-// generate specific test case that you can trace with the trace conditions in mpreal.hpp
-// for most bugs they are traceable with _trace_conversion and _trace_add
+// generate specific test case that you can trace
 template<typename Ty>
-void GenerateTestCase(Ty _a, Ty _b) {
+void GenerateTestCase(Ty _a, Ty _b, unsigned maxNbits) {
 	Ty ref;
-	sw::universal::eposit a, b, aref, asum;
-	a = _a;
-	b = _b;
+	sw::universal::eposit a(_a, maxNbits), b(_b, maxNbits), aref(0, maxNbits), asum;
 	asum = a + b;
 	ref = _a + _b;
 	aref = ref;
@@ -31,46 +30,101 @@ void GenerateTestCase(Ty _a, Ty _b) {
 	constexpr size_t ndigits = std::numeric_limits<Ty>::digits10;
 	std::cout << std::setprecision(ndigits);
 	std::cout << std::setw(ndigits) << _a << " + " << std::setw(ndigits) << _b << " = " << std::setw(ndigits) << ref << std::endl;
-	std::cout << a << " + " << b << " = " << asum << " (reference: " << aref << ")   " ;
+	std::cout << a << " + " << b << " = " << asum << " (reference: " << aref << ")   nbits = " << asum.nbits() << "   ";
 	std::cout << (aref == asum ? "PASS" : "FAIL") << std::endl << std::endl;
 	std::cout << std::setprecision(precision);
 }
 
-// progressions
-void Progressions(uint32_t digit) {
-	using BlockType = uint32_t;
-	sw::universal::eposit f;
-	std::vector<BlockType> coef;
-
-	constexpr size_t digitsInWord = 9;
-	coef.clear();
-	coef.push_back(digit);
-	for (size_t i = 0; i < digitsInWord; ++i) {
-		f.test(false, -1, coef);
-		std::cout << "(+, exp = -1, coef = " << coef[0] << ") = " << f << '\n';
-		coef[0] *= 10;
-		coef[0] += digit;
+/// <summary>
+/// an eposit with a maxbits cap of nbits rounds like posit<nbits, 2>: the sum and difference of
+/// the encodings i and j must have the value of the posit sum and difference
+/// </summary>
+template<unsigned nbits>
+int VerifyAgainstPosit(uint64_t i, uint64_t j, bool reportTestCases) {
+	using namespace sw::universal;
+	posit<nbits, 2> pa, pb;
+	pa.setbits(i);
+	pb.setbits(j);
+	eposit a(0, nbits), b(0, nbits);
+	a.setbits(i);
+	b.setbits(j);
+	posit<nbits, 2> pref[2] = { pa + pb, pa - pb };
+	eposit result[2] = { a + b, a - b };
+	int nrOfFailedTests = 0;
+	for (unsigned k = 0; k < 2; ++k) {
+		uint64_t bits = pref[k].get().to_ullong();
+		eposit ref(0, nbits);
+		ref.setbits(bits);
+		// the narrowest posit that holds the value drops the trailing zeros of the encoding
+		unsigned width = 2;
+		if (!pref[k].iszero() && !pref[k].isnar()) {
+			width = nbits;
+			while ((bits & 1u) == 0) { bits >>= 1; --width; }
+		}
+		if (result[k] != ref || result[k].nbits() != width) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: " << double(pa) << " " << "+-"[k] << " " << double(pb) << " = " << result[k] << " reference " << pref[k] << '\n';
+		}
+	}
+	return nrOfFailedTests;
+}
+
+template<unsigned nbits>
+int VerifyExhaustive(bool reportTestCases) {
+	int nrOfFailedTests = 0;
+	constexpr uint64_t NR_ENCODINGS = (1ull << nbits);
+	for (uint64_t i = 0; i < NR_ENCODINGS; ++i) {
+		for (uint64_t j = 0; j < NR_ENCODINGS; ++j) {
+			nrOfFailedTests += VerifyAgainstPosit<nbits>(i, j, reportTestCases);
+			if (nrOfFailedTests > 10) return nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+template<unsigned nbits>
+int VerifyRandoms(unsigned nrOfRandoms, bool reportTestCases) {
+	std::mt19937_64 engine(nbits);
+	std::uniform_int_distribution<uint64_t> distribution(0, (nbits < 64 ? (1ull << (nbits % 64)) - 1 : ~0ull));
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		nrOfFailedTests += VerifyAgainstPosit<nbits>(distribution(engine), distribution(engine), reportTestCases);
+		if (nrOfFailedTests > 10) return nrOfFailedTests;
+	}
+	return nrOfFailedTests;
+}
+
+// the precision of a sum grows until it reaches the maxbits cap
+int VerifyGrowth(bool reportTestCases) {
+	using namespace sw::universal;
+	int nrOfFailedTests = 0;
+	eposit one(1, 64), tiny(std::ldexp(1.0, -20), 64);
+	eposit sum = one + tiny;
+	if (double(sum) != 1.0 + std::ldexp(1.0, -20) || sum.nbits() <= 16 || sum.nbits() > 64) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 + 2^-20 at maxbits 64 is " << sum << " with nbits " << sum.nbits() << '\n';
 	}
-	coef.clear();
-	coef.push_back(digit);
-	for (size_t i = 0; i < digitsInWord; ++i) {
-		f.test(false, 0, coef);
-		std::cout << "(+, exp = 0, coef = " << coef[0] << ") = " << f << '\n';
-		coef[0] *= 10;
-		coef[0] += digit;
+	if (one.nbits() != 2 || (one - one).nbits() != 2 || !(one - one).iszero()) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 is stored in " << one.nbits() << " bits\n";
 	}
-	coef.clear();
-	coef.push_back(digit);
-	for (size_t i = 0; i < digitsInWord; ++i) {
-		f.test(false, 1, coef);
-		std::cout << "(+, exp = 1, coef = " << coef[0] << ") = " << f << '\n';
-		coef[0] *= 10;
-		coef[0] += digit;
+	sum.setmaxbits(16);
+	if (double(sum) != 1.0) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 + 2^-20 at maxbits 16 is " << sum << '\n';
 	}
+	// the result takes the larger cap of the operands, and stores the significand of a wide cap on the heap
+	eposit wide(1, 512), narrow(std::ldexp(1.0, -300), 16);
+	eposit r = wide + narrow;
+	if (r.maxbits() != 512 || (r - wide) != narrow) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 + 2^-300 at maxbits 512 lost the small term\n";
+	}
+	return nrOfFailedTests;
 }
 
 // Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
-#define MANUAL_TESTING 1
+#define MANUAL_TESTING 0
 // REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
 // It is the responsibility of the regression test to organize the tests in a quartile progression.
 //#undef REGRESSION_LEVEL_OVERRIDE
@@ -85,7 +139,7 @@ void Progressions(uint32_t digit) {
 #define REGRESSION_LEVEL_4 0
 #endif
 
-int main(int argc, char** argv)
+int main()
 try {
 	using namespace sw::universal;
 
@@ -99,47 +153,30 @@ try {
 #if MANUAL_TESTING
 
 	// generate individual testcases to hand trace/debug
-	GenerateTestCase(INFINITY, INFINITY);
-
-	eposit f;
-	f = 0;
-	std::cout << f << '\n';
-
-	std::vector<uint32_t> coef;
-
-	Progressions(1);
-	Progressions(9);
-
-	coef.clear();
-	coef.push_back(0);
-	f.test(false, 0, coef);
-	for (int i = 0; i < 13; ++i) {
-		coef[0] += 1;
-		f.test(false, 0, coef);
-		std::cout << "(+, exp = 0, coef = " << coef[0] << ") = " << f << '\n';
-	}
-	coef[0] = 999999999;
-	f.test(false, 0, coef);
-	std::cout << "(+, exp = 0, coef = " << coef[0] << ") = " << f << '\n';
-	coef.push_back(0);
-	for (int i = 0; i < 13; ++i) {
-		coef[0] = 0;
-		coef[1] += 1;
-		f.test(false, 0, coef);
-		std::cout << "(+, exp = 0, coef = " << coef[0] << ", " << coef[1] << ") = " << f << '\n';
-		coef[0] = 999999999;
-		f.test(false, 0, coef);
-		std::cout << "(+, exp = 0, coef = " << coef[0] << ", " << coef[1] << ") = " << f << '\n';
-	}
+	GenerateTestCase(1.0, std::ldexp(1.0, -20), 16);
+	GenerateTestCase(1.0, std::ldexp(1.0, -20), 64);
+	GenerateTestCase(INFINITY, INFINITY, 32);
 
 	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
 	return EXIT_SUCCESS;   // ignore errors
 #else
 
 #if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyExhaustive<8>(reportTestCases), "eposit maxbits 8", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyGrowth(reportTestCases), "eposit", "precision growth");
+#endif
 
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<16>(10000, reportTestCases), "eposit maxbits 16", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<32>(10000, reportTestCases), "eposit maxbits 32", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<64>(10000, reportTestCases), "eposit maxbits 64", test_tag);
 #endif
 
+#if REGRESSION_LEVEL_3
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
 
 	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
 	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
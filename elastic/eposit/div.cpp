@@ -0,0 +1,202 @@
+// div.cpp: functional tests for division on adaptive precision tapered floating-point
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// minimum set of include files to reflect source code dependencies
+#include <universal/number/eposit/eposit.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// generate specific test case that you can trace
+template<typename Ty>
+void GenerateTestCase(Ty _a, Ty _b, unsigned maxNbits) {
+	Ty ref;
+	sw::universal::eposit a(_a, maxNbits), b(_b, maxNbits), aref(0, maxNbits), asum;
+	asum = a / b;
+	ref = _a / _b;
+	aref = ref;
+
+	auto precision = std::cout.precision();
+	constexpr size_t ndigits = std::numeric_limits<Ty>::digits10;
+	std::cout << std::setprecision(ndigits);
+	std::cout << std::setw(ndigits) << _a << " / " << std::setw(ndigits) << _b << " = " << std::setw(ndigits) << ref << std::endl;
+	std::cout << a << " / " << b << " = " << asum << " (reference: " << aref << ")   nbits = " << asum.nbits() << "   ";
+	std::cout << (aref == asum ? "PASS" : "FAIL") << std::endl << std::endl;
+	std::cout << std::setprecision(precision);
+}
+
+/// <summary>
+/// an eposit with a maxbits cap of nbits rounds like posit<nbits, 2>: the quotient of
+/// the encodings i and j must have the value of the posit quotient
+/// </summary>
+template<unsigned nbits>
+int VerifyAgainstPosit(uint64_t i, uint64_t j, bool reportTestCases) {
+	using namespace sw::universal;
+	posit<nbits, 2> pa, pb;
+	pa.setbits(i);
+	pb.setbits(j);
+#if EPOSIT_THROW_ARITHMETIC_EXCEPTION
+	if (pb.iszero()) return 0;  // tested by VerifyDivision
+#endif
+	eposit a(0, nbits), b(0, nbits);
+	a.setbits(i);
+	b.setbits(j);
+	posit<nbits, 2> pref[1] = { pa / pb };
+	eposit result[1] = { a / b };
+	int nrOfFailedTests = 0;
+	for (unsigned k = 0; k < 1; ++k) {
+		uint64_t bits = pref[k].get().to_ullong();
+		eposit ref(0, nbits);
+		ref.setbits(bits);
+		// the narrowest posit that holds the value drops the trailing zeros of the encoding
+		unsigned width = 2;
+		if (!pref[k].iszero() && !pref[k].isnar()) {
+			width = nbits;
+			while ((bits & 1u) == 0) { bits >>= 1; --width; }
+		}
+		if (result[k] != ref || result[k].nbits() != width) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: " << double(pa) << " / " << double(pb) << " = " << result[k] << " reference " << pref[k] << '\n';
+		}
+	}
+	return nrOfFailedTests;
+}
+
+template<unsigned nbits>
+int VerifyExhaustive(bool reportTestCases) {
+	int nrOfFailedTests = 0;
+	constexpr uint64_t NR_ENCODINGS = (1ull << nbits);
+	for (uint64_t i = 0; i < NR_ENCODINGS; ++i) {
+		for (uint64_t j = 0; j < NR_ENCODINGS; ++j) {
+			nrOfFailedTests += VerifyAgainstPosit<nbits>(i, j, reportTestCases);
+			if (nrOfFailedTests > 10) return nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+template<unsigned nbits>
+int VerifyRandoms(unsigned nrOfRandoms, bool reportTestCases) {
+	std::mt19937_64 engine(nbits);
+	std::uniform_int_distribution<uint64_t> distribution(0, (nbits < 64 ? (1ull << (nbits % 64)) - 1 : ~0ull));
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		nrOfFailedTests += VerifyAgainstPosit<nbits>(distribution(engine), distribution(engine), reportTestCases);
+		if (nrOfFailedTests > 10) return nrOfFailedTests;
+	}
+	return nrOfFailedTests;
+}
+
+// division by zero and the growth of a quotient
+int VerifyDivision(bool reportTestCases) {
+	using namespace sw::universal;
+	int nrOfFailedTests = 0;
+	eposit one(1, 32), zero(0, 32);
+#if EPOSIT_THROW_ARITHMETIC_EXCEPTION
+	try {
+		eposit q = one / zero;
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 / 0 did not throw and returned " << q << '\n';
+	}
+	catch (const eposit_divide_by_zero&) {}
+#else
+	if (!(one / zero).isnar()) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 / 0 is not NaR\n";
+	}
+#endif
+	// 1/3 is not finite in binary, so the quotient uses the full cap
+	eposit third = one / 3;
+	if (third.nbits() != 32 || double(third) != double(posit<32, 2>(1) / posit<32, 2>(3))) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 / 3 at maxbits 32 is " << third << " with nbits " << third.nbits() << '\n';
+	}
+	// 1/4 is exact and narrow
+	eposit quarter = one / 4;
+	if (quarter.nbits() > 4 || double(quarter) != 0.25) {
+		++nrOfFailedTests;
+		if (reportTestCases) std::cerr << "FAIL: 1 / 4 is " << quarter << " with nbits " << quarter.nbits() << '\n';
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 0
+#define REGRESSION_LEVEL_4 0
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "adaptive posit division";
+	std::string test_tag    = "division";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	// generate individual testcases to hand trace/debug
+	GenerateTestCase(1.0, 3.0, 16);
+	GenerateTestCase(1.0, 3.0, 64);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;   // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyExhaustive<8>(reportTestCases), "eposit maxbits 8", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyDivision(reportTestCases), "eposit", "special cases");
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<16>(10000, reportTestCases), "eposit maxbits 16", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<32>(10000, reportTestCases), "eposit maxbits 32", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyRandoms<64>(10000, reportTestCases), "eposit maxbits 64", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_3
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
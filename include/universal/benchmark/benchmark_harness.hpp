@@ -0,0 +1,193 @@
+#pragma once
+// benchmark_harness.hpp: reproducible benchmark harness with warm-up, repeated samples, and robust statistics
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <universal/benchmark/benchmark_statistics.hpp>
+#include <universal/benchmark/cpu_affinity.hpp>
+#include <universal/benchmark/perf_counters.hpp>
+#include <universal/benchmark/benchmark_report.hpp>
+#include <universal/benchmark/performance_runner.hpp>  // toPowerOfTen
+
+namespace sw { namespace universal {
+
+	struct BenchmarkConfiguration {
+		unsigned    warmup{ 2 };          // untimed runs to settle caches, branch predictors, and clock frequency
+		unsigned    samples{ 11 };        // timed runs, an odd count yields an exact median sample
+		int         cpu{ -1 };            // logical cpu to pin the benchmark thread to, -1 leaves scheduling to the OS
+		bool        perfCounters{ false };// collect hardware counters through perf_event_open when available
+		bool        verbose{ true };      // print a human-readable line per workload
+		std::string jsonFile;             // when set, save() writes the results as JSON to this file
+		std::string csvFile;              // when set, save() writes the results as CSV to this file
+	};
+
+	/// <summary>
+	/// parse the standard benchmark command line options
+	///   --warmup N  --samples N  --cpu N  --perf  --quiet  --json FILE  --csv FILE
+	/// </summary>
+	/// <returns>false if an unknown option or a missing argument was encountered</returns>
+	inline bool ParseBenchmarkCommandLine(int argc, char* argv[], BenchmarkConfiguration& cfg) {
+		for (int i = 1; i < argc; ++i) {
+			std::string arg(argv[i]);
+			bool hasValue = (i + 1 < argc);
+			if (arg == "--perf")                    cfg.perfCounters = true;
+			else if (arg == "--quiet")              cfg.verbose = false;
+			else if (arg == "--warmup" && hasValue)  cfg.warmup = static_cast<unsigned>(std::stoul(argv[++i]));
+			else if (arg == "--samples" && hasValue) cfg.samples = std::max(1u, static_cast<unsigned>(std::stoul(argv[++i])));
+			else if (arg == "--cpu" && hasValue)     cfg.cpu = std::stoi(argv[++i]);
+			else if (arg == "--json" && hasValue)    cfg.jsonFile = argv[++i];
+			else if (arg == "--csv" && hasValue)     cfg.csvFile = argv[++i];
+			else {
+				std::cerr << "unknown or incomplete benchmark option: " << arg << '\n'
+					<< "usage: " << argv[0] << " [--warmup N] [--samples N] [--cpu N] [--perf] [--quiet] [--json FILE] [--csv FILE]\n";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline std::string compiler_identification() {
+#if defined(__clang__)
+		return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+		return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+		return std::string("msvc ") + std::to_string(_MSC_VER);
+#else
+		return std::string("unknown");
+#endif
+	}
+
+	/// <summary>
+	/// BenchmarkHarness runs a workload with the same signature as the PerformanceRunner workloads,
+	/// void(size_t NR_OPS), warmup + samples times, and collects the per-sample elapsed times,
+	/// their robust statistics, and optionally the hardware counters of the median sample.
+	/// Kernels that are characterized by their memory traffic, such as the BLAS operators,
+	/// pass the bytes moved per sample to also report the achieved bandwidth.
+	/// </summary>
+	class BenchmarkHarness {
+	public:
+		explicit BenchmarkHarness(const std::string& suite, const BenchmarkConfiguration& cfg = BenchmarkConfiguration())
+			: config(cfg), pinned(false) {
+			resultSet.context.suite     = suite;
+			resultSet.context.compiler  = compiler_identification();
+			resultSet.context.timestamp = timestamp();
+			resultSet.context.warmup    = config.warmup;
+			resultSet.context.samples   = config.samples;
+			if (config.cpu >= 0) {
+				pinned = pin_thread_to_cpu(config.cpu);
+				if (!pinned) std::cerr << "benchmark harness: unable to pin to cpu " << config.cpu << ", continuing unpinned\n";
+			}
+			resultSet.context.cpu = (pinned ? config.cpu : -1);
+			if (config.perfCounters) {
+				counters.reset(new PerfCounterGroup);
+				if (!counters->available()) {
+					std::cerr << "benchmark harness: hardware counters are not available (check /proc/sys/kernel/perf_event_paranoid)\n";
+					counters.reset();
+				}
+			}
+		}
+
+		template<typename Workload>
+		const BenchmarkResult& run(const std::string& name, Workload&& workload, size_t NR_OPS, size_t bytes = 0) {
+			using namespace std::chrono;
+			for (unsigned i = 0; i < config.warmup; ++i) workload(NR_OPS);
+
+			BenchmarkResult result;
+			result.name = name;
+			result.nrOps = NR_OPS;
+			result.bytes = bytes;
+			result.samples.reserve(config.samples);
+			std::vector<PerfCounterValues> sampleCounters;
+			for (unsigned i = 0; i < config.samples; ++i) {
+				if (counters) counters->start();
+				steady_clock::time_point begin = steady_clock::now();
+				workload(NR_OPS);
+				steady_clock::time_point end = steady_clock::now();
+				if (counters) sampleCounters.push_back(counters->stop());
+				result.samples.push_back(duration_cast<duration<double>>(end - begin).count());
+			}
+			result.stats = ComputeSampleStatistics(result.samples);
+			if (!sampleCounters.empty()) result.counters = medianCounters(result.samples, sampleCounters);
+			resultSet.results.push_back(result);
+			if (config.verbose) report(std::cout, resultSet.results.back());
+			return resultSet.results.back();
+		}
+
+		// human-readable line, in the format of the PerformanceRunner
+		static void report(std::ostream& ostr, const BenchmarkResult& r) {
+			ostr << std::left << std::setw(48) << r.name << std::right << ' ' << std::setw(10) << r.nrOps << " per " << std::setw(15) << r.stats.median << "sec (mad "
+				<< std::setw(5) << std::fixed << std::setprecision(1) << 100.0 * r.stats.relativeMad() << std::defaultfloat << std::setprecision(6)
+				<< "%) -> " << toPowerOfTen(r.opsPerSecond()) << "ops/sec";
+			if (r.bytes > 0) ostr << "  " << toPowerOfTen(r.bytesPerSecond()) << "B/sec";
+			if (r.counters.valid) {
+				ostr << "  IPC " << std::fixed << std::setprecision(2) << r.counters.ipc() << std::defaultfloat << std::setprecision(6)
+					<< "  cache-misses " << r.counters.cacheMisses << "  branch-misses " << r.counters.branchMisses;
+			}
+			ostr << std::endl;
+		}
+
+		const BenchmarkResultSet& results() const noexcept { return resultSet; }
+		const BenchmarkConfiguration& configuration() const noexcept { return config; }
+
+		void writeJSON(std::ostream& ostr) const { WriteBenchmarkJSON(ostr, resultSet); }
+		void writeCSV(std::ostream& ostr) const { WriteBenchmarkCSV(ostr, resultSet); }
+
+		// write the results to the files named in the configuration, returns false if a file could not be written
+		bool save() const {
+			bool success = true;
+			if (!config.jsonFile.empty()) success = writeFile(config.jsonFile, [this](std::ostream& o) { writeJSON(o); }) && success;
+			if (!config.csvFile.empty())  success = writeFile(config.csvFile,  [this](std::ostream& o) { writeCSV(o); })  && success;
+			return success;
+		}
+
+	private:
+		BenchmarkConfiguration            config;
+		BenchmarkResultSet                resultSet;
+		std::unique_ptr<PerfCounterGroup> counters;
+		bool                              pinned;
+
+		// counters of the sample with the median elapsed time, so that they describe a representative run
+		static PerfCounterValues medianCounters(const std::vector<double>& samples, const std::vector<PerfCounterValues>& values) {
+			std::vector<size_t> order(samples.size());
+			for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+			std::sort(order.begin(), order.end(), [&samples](size_t a, size_t b) { return samples[a] < samples[b]; });
+			return values[order[order.size() / 2]];
+		}
+
+		static std::string timestamp() {
+			std::time_t now = std::time(nullptr);
+			char buffer[32] = { 0 };
+			std::tm utc{};
+#if defined(_MSC_VER)
+			gmtime_s(&utc, &now);
+#else
+			gmtime_r(&now, &utc);
+#endif
+			std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+			return std::string(buffer);
+		}
+
+		template<typename Writer>
+		static bool writeFile(const std::string& filename, Writer&& writer) {
+			std::ofstream ofs(filename);
+			if (!ofs) {
+				std::cerr << "benchmark harness: unable to open " << filename << " for writing\n";
+				return false;
+			}
+			writer(ofs);
+			return bool(ofs);
+		}
+	};
+
+}} // namespace sw::universal
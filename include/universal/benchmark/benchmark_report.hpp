@@ -0,0 +1,403 @@
+#pragma once
+// benchmark_report.hpp: machine-readable benchmark results, JSON/CSV serialization, and regression comparison
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <universal/benchmark/benchmark_statistics.hpp>
+#include <universal/benchmark/perf_counters.hpp>
+
+namespace sw { namespace universal {
+
+	// version of the JSON schema written by WriteBenchmarkJSON
+	constexpr int UNIVERSAL_BENCHMARK_SCHEMA_VERSION = 1;
+
+	// measurement of a single workload
+	struct BenchmarkResult {
+		std::string         name;
+		size_t              nrOps{ 0 };
+		size_t              bytes{ 0 };      // memory traffic of a single sample, 0 when not applicable
+		std::vector<double> samples;        // elapsed time of each sample in seconds
+		SampleStatistics    stats;
+		PerfCounterValues   counters;       // median counts of a single sample, valid only when collected
+
+		// throughput based on the median sample
+		double opsPerSecond() const noexcept { return (stats.median > 0.0 ? double(nrOps) / stats.median : 0.0); }
+		double bytesPerSecond() const noexcept { return (stats.median > 0.0 ? double(bytes) / stats.median : 0.0); }
+	};
+
+	// environment in which a set of results was collected
+	struct BenchmarkContext {
+		std::string suite;
+		std::string compiler;
+		std::string timestamp;
+		int         cpu{ -1 };
+		unsigned    warmup{ 0 };
+		unsigned    samples{ 0 };
+	};
+
+	struct BenchmarkResultSet {
+		BenchmarkContext             context;
+		std::vector<BenchmarkResult> results;
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////
+	// serialization
+
+	inline std::string json_escape(const std::string& s) {
+		std::stringstream ss;
+		for (char c : s) {
+			switch (c) {
+			case '"':  ss << "\\\""; break;
+			case '\\': ss << "\\\\"; break;
+			case '\n': ss << "\\n";  break;
+			case '\t': ss << "\\t";  break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+				}
+				else {
+					ss << c;
+				}
+			}
+		}
+		return ss.str();
+	}
+
+	inline std::string csv_escape(const std::string& s) {
+		if (s.find_first_of(",\"\n") == std::string::npos) return s;
+		std::string quoted("\"");
+		for (char c : s) {
+			if (c == '"') quoted += '"';
+			quoted += c;
+		}
+		return quoted + '"';
+	}
+
+	inline void WriteBenchmarkJSON(std::ostream& ostr, const BenchmarkResultSet& set) {
+		auto prec = ostr.precision();
+		ostr << std::setprecision(std::numeric_limits<double>::max_digits10);
+		const BenchmarkContext& ctx = set.context;
+		ostr << "{\n"
+			<< "  \"schema\": " << UNIVERSAL_BENCHMARK_SCHEMA_VERSION << ",\n"
+			<< "  \"context\": {\n"
+			<< "    \"suite\": \"" << json_escape(ctx.suite) << "\",\n"
+			<< "    \"compiler\": \"" << json_escape(ctx.compiler) << "\",\n"
+			<< "    \"timestamp\": \"" << json_escape(ctx.timestamp) << "\",\n"
+			<< "    \"cpu\": " << ctx.cpu << ",\n"
+			<< "    \"warmup\": " << ctx.warmup << ",\n"
+			<< "    \"samples\": " << ctx.samples << "\n"
+			<< "  },\n"
+			<< "  \"results\": [";
+		for (size_t i = 0; i < set.results.size(); ++i) {
+			const BenchmarkResult& r = set.results[i];
+			ostr << (i == 0 ? "\n" : ",\n")
+				<< "    {\n"
+				<< "      \"name\": \"" << json_escape(r.name) << "\",\n"
+				<< "      \"ops\": " << r.nrOps << ",\n"
+				<< "      \"median\": " << r.stats.median << ",\n"
+				<< "      \"mad\": " << r.stats.mad << ",\n"
+				<< "      \"mean\": " << r.stats.mean << ",\n"
+				<< "      \"stddev\": " << r.stats.stddev << ",\n"
+				<< "      \"min\": " << r.stats.minimum << ",\n"
+				<< "      \"max\": " << r.stats.maximum << ",\n"
+				<< "      \"ops_per_sec\": " << r.opsPerSecond() << ",\n";
+			if (r.bytes > 0) {
+				ostr << "      \"bytes\": " << r.bytes << ",\n"
+					<< "      \"bytes_per_sec\": " << r.bytesPerSecond() << ",\n";
+			}
+			if (r.counters.valid) {
+				ostr << "      \"counters\": { \"cycles\": " << r.counters.cycles
+					<< ", \"instructions\": " << r.counters.instructions
+					<< ", \"cache_misses\": " << r.counters.cacheMisses
+					<< ", \"branch_misses\": " << r.counters.branchMisses << " },\n";
+			}
+			ostr << "      \"samples\": [";
+			for (size_t s = 0; s < r.samples.size(); ++s) ostr << (s == 0 ? "" : ", ") << r.samples[s];
+			ostr << "]\n"
+				<< "    }";
+		}
+		ostr << "\n  ]\n}\n";
+		ostr << std::setprecision(prec);
+	}
+
+	inline void WriteBenchmarkCSV(std::ostream& ostr, const BenchmarkResultSet& set, bool header = true) {
+		auto prec = ostr.precision();
+		ostr << std::setprecision(std::numeric_limits<double>::max_digits10);
+		if (header) ostr << "suite,name,ops,samples,median,mad,mean,stddev,min,max,ops_per_sec,bytes,bytes_per_sec,cycles,instructions,cache_misses,branch_misses\n";
+		for (const BenchmarkResult& r : set.results) {
+			ostr << csv_escape(set.context.suite) << ',' << csv_escape(r.name) << ',' << r.nrOps << ',' << r.stats.nrSamples << ','
+				<< r.stats.median << ',' << r.stats.mad << ',' << r.stats.mean << ',' << r.stats.stddev << ','
+				<< r.stats.minimum << ',' << r.stats.maximum << ',' << r.opsPerSecond() << ','
+				<< r.bytes << ',' << r.bytesPerSecond() << ',';
+			if (r.counters.valid) {
+				ostr << r.counters.cycles << ',' << r.counters.instructions << ',' << r.counters.cacheMisses << ',' << r.counters.branchMisses;
+			}
+			else {
+				ostr << ",,,";
+			}
+			ostr << '\n';
+		}
+		ostr << std::setprecision(prec);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////
+	// deserialization of the JSON result files written by WriteBenchmarkJSON
+
+	// minimal JSON document model: sufficient for the benchmark schema, not a general purpose parser
+	struct JsonNode {
+		enum class Kind { Null, Boolean, Number, String, Array, Object };
+		Kind                                          kind{ Kind::Null };
+		bool                                          boolean{ false };
+		double                                        number{ 0.0 };
+		std::string                                   text;
+		std::vector<JsonNode>                         elements;
+		std::vector<std::pair<std::string, JsonNode>> members;
+
+		const JsonNode* find(const std::string& key) const {
+			for (const auto& m : members) if (m.first == key) return &m.second;
+			return nullptr;
+		}
+		double numberOr(const std::string& key, double fallback) const {
+			const JsonNode* n = find(key);
+			return (n != nullptr && n->kind == Kind::Number) ? n->number : fallback;
+		}
+		std::string textOr(const std::string& key, const std::string& fallback) const {
+			const JsonNode* n = find(key);
+			return (n != nullptr && n->kind == Kind::String) ? n->text : fallback;
+		}
+	};
+
+	class JsonReader {
+	public:
+		explicit JsonReader(const std::string& document) : doc(document), pos(0) {}
+
+		// throws std::runtime_error on malformed input
+		JsonNode parse() {
+			JsonNode root = parseValue();
+			skipWhitespace();
+			if (pos != doc.size()) error("trailing characters");
+			return root;
+		}
+
+	private:
+		const std::string& doc;
+		size_t pos;
+
+		[[noreturn]] void error(const std::string& msg) const {
+			throw std::runtime_error(std::string("json parse error at offset ") + std::to_string(pos) + ": " + msg);
+		}
+		void skipWhitespace() {
+			while (pos < doc.size() && std::isspace(static_cast<unsigned char>(doc[pos]))) ++pos;
+		}
+		char peek() {
+			skipWhitespace();
+			if (pos >= doc.size()) error("unexpected end of document");
+			return doc[pos];
+		}
+		void expect(char c) {
+			if (peek() != c) error(std::string("expected '") + c + '\'');
+			++pos;
+		}
+		bool consumeLiteral(const char* literal) {
+			size_t len = std::strlen(literal);
+			if (doc.compare(pos, len, literal) != 0) return false;
+			pos += len;
+			return true;
+		}
+		JsonNode parseValue() {
+			JsonNode node;
+			char c = peek();
+			if (c == '{') {
+				node.kind = JsonNode::Kind::Object;
+				++pos;
+				if (peek() == '}') { ++pos; return node; }
+				for (;;) {
+					std::string key = parseString();
+					expect(':');
+					node.members.emplace_back(key, parseValue());
+					if (peek() == ',') { ++pos; continue; }
+					expect('}');
+					break;
+				}
+			}
+			else if (c == '[') {
+				node.kind = JsonNode::Kind::Array;
+				++pos;
+				if (peek() == ']') { ++pos; return node; }
+				for (;;) {
+					node.elements.push_back(parseValue());
+					if (peek() == ',') { ++pos; continue; }
+					expect(']');
+					break;
+				}
+			}
+			else if (c == '"') {
+				node.kind = JsonNode::Kind::String;
+				node.text = parseString();
+			}
+			else if (consumeLiteral("true")) {
+				node.kind = JsonNode::Kind::Boolean;
+				node.boolean = true;
+			}
+			else if (consumeLiteral("false")) {
+				node.kind = JsonNode::Kind::Boolean;
+			}
+			else if (consumeLiteral("null")) {
+				node.kind = JsonNode::Kind::Null;
+			}
+			else {
+				const char* begin = doc.c_str() + pos;
+				char* end = nullptr;
+				node.kind = JsonNode::Kind::Number;
+				node.number = std::strtod(begin, &end);
+				if (end == begin) error("invalid value");
+				pos += static_cast<size_t>(end - begin);
+			}
+			return node;
+		}
+		std::string parseString() {
+			expect('"');
+			std::string s;
+			while (pos < doc.size() && doc[pos] != '"') {
+				char c = doc[pos++];
+				if (c == '\\') {
+					if (pos >= doc.size()) break;
+					char e = doc[pos++];
+					switch (e) {
+					case 'n': s += '\n'; break;
+					case 't': s += '\t'; break;
+					case 'r': s += '\r'; break;
+					case 'b': s += '\b'; break;
+					case 'f': s += '\f'; break;
+					case 'u':
+						if (pos + 4 > doc.size()) error("truncated unicode escape");
+						s += static_cast<char>(std::strtol(doc.substr(pos, 4).c_str(), nullptr, 16) & 0x7F);
+						pos += 4;
+						break;
+					default: s += e; break;
+					}
+				}
+				else {
+					s += c;
+				}
+			}
+			if (pos >= doc.size()) error("unterminated string");
+			++pos;
+			return s;
+		}
+	};
+
+	// read a result set that was written by WriteBenchmarkJSON
+	inline BenchmarkResultSet ReadBenchmarkJSON(std::istream& istr) {
+		std::stringstream buffer;
+		buffer << istr.rdbuf();
+		std::string document = buffer.str();
+		JsonNode root = JsonReader(document).parse();
+
+		BenchmarkResultSet set;
+		if (const JsonNode* ctx = root.find("context")) {
+			set.context.suite     = ctx->textOr("suite", "");
+			set.context.compiler  = ctx->textOr("compiler", "");
+			set.context.timestamp = ctx->textOr("timestamp", "");
+			set.context.cpu       = static_cast<int>(ctx->numberOr("cpu", -1));
+			set.context.warmup    = static_cast<unsigned>(ctx->numberOr("warmup", 0));
+			set.context.samples   = static_cast<unsigned>(ctx->numberOr("samples", 0));
+		}
+		const JsonNode* results = root.find("results");
+		if (results == nullptr || results->kind != JsonNode::Kind::Array) return set;
+		for (const JsonNode& e : results->elements) {
+			BenchmarkResult r;
+			r.name          = e.textOr("name", "");
+			r.nrOps         = static_cast<size_t>(e.numberOr("ops", 0));
+			r.bytes         = static_cast<size_t>(e.numberOr("bytes", 0));
+			r.stats.median  = e.numberOr("median", 0.0);
+			r.stats.mad     = e.numberOr("mad", 0.0);
+			r.stats.mean    = e.numberOr("mean", 0.0);
+			r.stats.stddev  = e.numberOr("stddev", 0.0);
+			r.stats.minimum = e.numberOr("min", 0.0);
+			r.stats.maximum = e.numberOr("max", 0.0);
+			if (const JsonNode* samples = e.find("samples")) {
+				for (const JsonNode& s : samples->elements) r.samples.push_back(s.number);
+			}
+			r.stats.nrSamples = r.samples.size();
+			if (const JsonNode* counters = e.find("counters")) {
+				r.counters.valid        = true;
+				r.counters.cycles       = static_cast<uint64_t>(counters->numberOr("cycles", 0));
+				r.counters.instructions = static_cast<uint64_t>(counters->numberOr("instructions", 0));
+				r.counters.cacheMisses  = static_cast<uint64_t>(counters->numberOr("cache_misses", 0));
+				r.counters.branchMisses = static_cast<uint64_t>(counters->numberOr("branch_misses", 0));
+			}
+			set.results.push_back(r);
+		}
+		return set;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////
+	// regression analysis between two result sets
+
+	enum class BenchmarkVerdict { Unchanged, Improvement, Regression, Missing };
+
+	struct BenchmarkComparison {
+		std::string      name;
+		double           baseline{ 0.0 };   // median elapsed time of the baseline in seconds
+		double           candidate{ 0.0 };  // median elapsed time of the candidate in seconds
+		double           change{ 0.0 };     // relative change of the median time: positive is slower
+		BenchmarkVerdict verdict{ BenchmarkVerdict::Unchanged };
+	};
+
+	// A change is significant when it exceeds the relative threshold AND is larger than
+	// noiseFactor times the combined dispersion of the two measurements, so that a noisy
+	// workload does not flag a regression on a single unlucky run.
+	inline std::vector<BenchmarkComparison> CompareBenchmarkResults(const BenchmarkResultSet& baseline, const BenchmarkResultSet& candidate, double threshold = 0.05, double noiseFactor = 3.0) {
+		std::map<std::string, const BenchmarkResult*> lookup;
+		for (const BenchmarkResult& r : candidate.results) lookup[r.name] = &r;
+
+		std::vector<BenchmarkComparison> comparisons;
+		for (const BenchmarkResult& b : baseline.results) {
+			BenchmarkComparison c;
+			c.name = b.name;
+			c.baseline = b.stats.median;
+			auto it = lookup.find(b.name);
+			if (it == lookup.end() || b.stats.median <= 0.0) {
+				c.verdict = BenchmarkVerdict::Missing;
+				comparisons.push_back(c);
+				continue;
+			}
+			const BenchmarkResult& r = *it->second;
+			// normalize to time per operation so that runs with different NR_OPS remain comparable
+			double perOpBaseline  = b.stats.median / double(b.nrOps > 0 ? b.nrOps : 1);
+			double perOpCandidate = r.stats.median / double(r.nrOps > 0 ? r.nrOps : 1);
+			c.candidate = r.stats.median;
+			c.change = perOpCandidate / perOpBaseline - 1.0;
+			double noise = noiseFactor * std::hypot(b.stats.sigma() / b.stats.median, (r.stats.median > 0.0 ? r.stats.sigma() / r.stats.median : 0.0));
+			double bound = (threshold > noise ? threshold : noise);
+			if (c.change > bound)       c.verdict = BenchmarkVerdict::Regression;
+			else if (c.change < -bound) c.verdict = BenchmarkVerdict::Improvement;
+			comparisons.push_back(c);
+		}
+		return comparisons;
+	}
+
+	inline const char* to_string(BenchmarkVerdict v) {
+		switch (v) {
+		case BenchmarkVerdict::Improvement: return "improvement";
+		case BenchmarkVerdict::Regression:  return "REGRESSION";
+		case BenchmarkVerdict::Missing:     return "missing";
+		default:                            return "unchanged";
+		}
+	}
+
+}} // namespace sw::universal
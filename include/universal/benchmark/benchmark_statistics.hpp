@@ -0,0 +1,66 @@
+#pragma once
+// benchmark_statistics.hpp: robust summary statistics of repeated benchmark samples
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace sw { namespace universal {
+
+	// summary statistics of a set of timing samples
+	// The median and the median absolute deviation (MAD) are the primary metrics:
+	// they are insensitive to the outliers caused by interrupts, frequency transitions,
+	// and page faults, which routinely contaminate the mean and standard deviation.
+	struct SampleStatistics {
+		size_t nrSamples{ 0 };
+		double minimum{ 0.0 };
+		double maximum{ 0.0 };
+		double mean{ 0.0 };
+		double stddev{ 0.0 };
+		double median{ 0.0 };
+		double mad{ 0.0 };
+
+		// MAD scaled to be a consistent estimator of the standard deviation of a normal distribution
+		double sigma() const noexcept { return 1.4826 * mad; }
+		// relative dispersion of the samples
+		double relativeMad() const noexcept { return (median > 0.0 ? mad / median : 0.0); }
+	};
+
+	// median of a set of values, the argument is taken by value as it gets partially sorted
+	inline double median_of(std::vector<double> v) {
+		if (v.empty()) return 0.0;
+		size_t mid = v.size() / 2;
+		std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(mid), v.end());
+		double m = v[mid];
+		if ((v.size() & 1) == 0) {
+			// even number of elements: average with the largest element of the lower half
+			double lower = *std::max_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(mid));
+			m = 0.5 * (lower + m);
+		}
+		return m;
+	}
+
+	inline SampleStatistics ComputeSampleStatistics(const std::vector<double>& samples) {
+		SampleStatistics stats;
+		stats.nrSamples = samples.size();
+		if (samples.empty()) return stats;
+
+		auto mm = std::minmax_element(samples.begin(), samples.end());
+		stats.minimum = *mm.first;
+		stats.maximum = *mm.second;
+		stats.mean    = std::accumulate(samples.begin(), samples.end(), 0.0) / double(samples.size());
+		double sumOfSquares{ 0.0 };
+		for (double s : samples) sumOfSquares += (s - stats.mean) * (s - stats.mean);
+		stats.stddev  = (samples.size() > 1 ? std::sqrt(sumOfSquares / double(samples.size() - 1)) : 0.0);
+		stats.median  = median_of(samples);
+		std::vector<double> deviations(samples.size());
+		for (size_t i = 0; i < samples.size(); ++i) deviations[i] = std::abs(samples[i] - stats.median);
+		stats.mad     = median_of(deviations);
+		return stats;
+	}
+
+}} // namespace sw::universal
@@ -0,0 +1,36 @@
+#pragma once
+// cpu_affinity.hpp: pin the benchmarking thread to a single core to reduce timing variance
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace sw { namespace universal {
+
+	// pin the calling thread to the given logical cpu
+	// returns false when the platform does not support pinning or the request is rejected
+	inline bool pin_thread_to_cpu(int cpu) {
+		if (cpu < 0) return false;
+#if defined(__linux__)
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(cpu, &cpuset);
+		return sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0;
+#else
+		return false;
+#endif
+	}
+
+	// the logical cpu the calling thread is currently executing on, -1 if unknown
+	inline int current_cpu() {
+#if defined(__linux__)
+		return sched_getcpu();
+#else
+		return -1;
+#endif
+	}
+
+}} // namespace sw::universal
@@ -0,0 +1,122 @@
+#pragma once
+// perf_counters.hpp: hardware performance counter collection through the Linux perf_event_open interface
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define UNIVERSAL_PERF_COUNTERS_SUPPORTED 1
+#else
+#define UNIVERSAL_PERF_COUNTERS_SUPPORTED 0
+#endif
+
+namespace sw { namespace universal {
+
+	// hardware event counts collected over a measurement interval
+	struct PerfCounterValues {
+		bool     valid{ false };
+		uint64_t cycles{ 0 };
+		uint64_t instructions{ 0 };
+		uint64_t cacheMisses{ 0 };
+		uint64_t branchMisses{ 0 };
+
+		double ipc() const noexcept { return (cycles > 0 ? double(instructions) / double(cycles) : 0.0); }
+	};
+
+	// A group of hardware counters that are enabled and disabled atomically.
+	// The group is user-space only (kernel and hypervisor excluded) so that it can be
+	// opened with the default perf_event_paranoid setting of most distributions.
+	// Events that the PMU, or the virtualization layer, does not expose are silently dropped;
+	// when not even the cycle counter can be opened, available() returns false and
+	// stop() returns an invalid PerfCounterValues.
+	class PerfCounterGroup {
+	public:
+		PerfCounterGroup() {
+#if UNIVERSAL_PERF_COUNTERS_SUPPORTED
+			leader = open_event(PERF_COUNT_HW_CPU_CYCLES, -1);
+			if (leader < 0) return;
+			slot[CYCLES] = nrEvents++;
+			add_event(PERF_COUNT_HW_INSTRUCTIONS, INSTRUCTIONS);
+			add_event(PERF_COUNT_HW_CACHE_MISSES, CACHE_MISSES);
+			add_event(PERF_COUNT_HW_BRANCH_MISSES, BRANCH_MISSES);
+#endif
+		}
+		PerfCounterGroup(const PerfCounterGroup&) = delete;
+		PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+		~PerfCounterGroup() {
+#if UNIVERSAL_PERF_COUNTERS_SUPPORTED
+			for (int i = 0; i < nrFollowers; ++i) close(followers[i]);
+			if (leader >= 0) close(leader);
+#endif
+		}
+
+		bool available() const noexcept { return leader >= 0; }
+
+		void start() noexcept {
+#if UNIVERSAL_PERF_COUNTERS_SUPPORTED
+			if (leader < 0) return;
+			ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+		}
+
+		PerfCounterValues stop() noexcept {
+			PerfCounterValues v;
+#if UNIVERSAL_PERF_COUNTERS_SUPPORTED
+			if (leader < 0) return v;
+			ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+			// PERF_FORMAT_GROUP layout: { u64 nr; u64 values[nr]; }
+			uint64_t buffer[1 + NR_COUNTERS] = { 0 };
+			ssize_t bytes = read(leader, buffer, sizeof(buffer));
+			if (bytes < static_cast<ssize_t>(sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(nrEvents)) return v;
+			v.valid        = true;
+			v.cycles       = value(buffer, CYCLES);
+			v.instructions = value(buffer, INSTRUCTIONS);
+			v.cacheMisses  = value(buffer, CACHE_MISSES);
+			v.branchMisses = value(buffer, BRANCH_MISSES);
+#endif
+			return v;
+		}
+
+	private:
+		enum Counter { CYCLES = 0, INSTRUCTIONS = 1, CACHE_MISSES = 2, BRANCH_MISSES = 3, NR_COUNTERS = 4 };
+		int leader{ -1 };
+		int followers[NR_COUNTERS]{ -1, -1, -1, -1 };
+		int nrFollowers{ 0 };
+		int nrEvents{ 0 };
+		int slot[NR_COUNTERS]{ -1, -1, -1, -1 };  // position of the counter in the group read buffer
+
+		uint64_t value(const uint64_t* buffer, Counter c) const noexcept {
+			return (slot[c] < 0 ? 0 : buffer[1 + slot[c]]);
+		}
+
+#if UNIVERSAL_PERF_COUNTERS_SUPPORTED
+		static int open_event(uint64_t config, int groupFd) noexcept {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.type           = PERF_TYPE_HARDWARE;
+			attr.size           = sizeof(attr);
+			attr.config         = config;
+			attr.disabled       = (groupFd == -1 ? 1 : 0);
+			attr.exclude_kernel = 1;
+			attr.exclude_hv     = 1;
+			attr.read_format    = PERF_FORMAT_GROUP;
+			return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+		}
+		void add_event(uint64_t config, Counter c) noexcept {
+			int fd = open_event(config, leader);
+			if (fd < 0) return;
+			followers[nrFollowers++] = fd;
+			slot[c] = nrEvents++;
+		}
+#endif
+	};
+
+}} // namespace sw::universal
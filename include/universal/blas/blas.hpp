@@ -88,5 +88,6 @@ constexpr uint64_t SIZE_512G = 512 * SIZE_1G;
 
 // type specific overloads
 #include <universal/blas/modifiers/posit_fdp.hpp>
+#include <universal/blas/modifiers/bfloat16_kernels.hpp>
 
 #endif // _UNIVERSAL_BLAS_LIBRARY
@@ -4,33 +4,41 @@
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <universal/math/math>  // injection of native IEEE-754 math library functions into sw::universal namespace
 #include <universal/number/posit/posit.hpp>
+#include <universal/number/quire/fdp.hpp>
 #include <universal/blas/vector.hpp>
 
+// compilation flags
+// BLAS_FUSED_DOT_PRODUCT
+// when set the dot products of number systems with a Kulisch quire (cfloat, fixpnt, lns, bfloat16) are fused:
+// opt-in, as it changes the rounding of the results, and the lns quire is not exact
+#ifndef BLAS_FUSED_DOT_PRODUCT
+#define BLAS_FUSED_DOT_PRODUCT 0
+#endif
+#include <universal/blas/reduction.hpp>
+
 namespace sw { namespace universal { namespace blas { 
 
 // 1-norm of a vector: sum of magnitudes of the vector elements, default increment stride is 1
-template<typename Vector>
+template<typename ReductionPolicy = default_reduction, typename Vector>
 typename Vector::value_type asum(size_t n, const Vector& x, size_t incx = 1) {
-	typename Vector::value_type sum = 0;
-	size_t ix;
-	for (ix = 0; ix < n; ix += incx) {
-		sum += (x[ix] < 0 ? -x[ix] : x[ix]);
-	}
-	return sum;
+	using value_type = typename Vector::value_type;
+	size_t cnt = (n + incx - 1) / incx;
+	return ReductionPolicy::template sum<value_type>(cnt, [&](size_t i) {
+		const value_type& e = x[i * incx];
+		return (e < 0 ? value_type(-e) : e);
+	});
 }
 
 // sum of the vector elements, default increment stride is 1
-template<typename Vector>
+template<typename ReductionPolicy = default_reduction, typename Vector>
 typename Vector::value_type sum(const Vector& x) {
-	typename Vector::value_type sum = 0;
-	size_t ix;
-	for (ix = 0; ix < size(x); ++ix) {
-		sum += x[ix];
-	}
-	return sum;
+	using value_type = typename Vector::value_type;
+	return ReductionPolicy::template sum<value_type>(size(x), [&](size_t i) { return x[i]; });
 }
 
 // a times x plus y
@@ -42,6 +50,33 @@ void axpy(size_t n, Scalar a, const Vector& x, size_t incx, Vector& y, size_t in
 	}
 }
 
+// a times x plus y over the full length of the vectors: y = a * x + y
+template<typename Scalar, typename XVector, typename Vector>
+void axpy(const Scalar& a, const XVector& x, Vector& y) {
+	size_t n = std::min(size_t(size(x)), size_t(size(y)));
+	for (size_t i = 0; i < n; ++i) {
+		y[i] += a * x[i];
+	}
+}
+
+// a times x plus b times y in a single pass: y = a * x + b * y
+template<typename Scalar, typename XVector, typename Vector>
+void axpby(const Scalar& a, const XVector& x, const Scalar& b, Vector& y) {
+	size_t n = std::min(size_t(size(x)), size_t(size(y)));
+	for (size_t i = 0; i < n; ++i) {
+		y[i] = a * x[i] + b * y[i];
+	}
+}
+
+// x plus b times y in a single pass: y = x + b * y, the search direction update of the Krylov solvers
+template<typename Scalar, typename XVector, typename Vector>
+void xpby(const XVector& x, const Scalar& b, Vector& y) {
+	size_t n = std::min(size_t(size(x)), size_t(size(y)));
+	for (size_t i = 0; i < n; ++i) {
+		y[i] = x[i] + b * y[i];
+	}
+}
+
 // vector copy
 template<typename Vector>
 void copy(size_t n, const Vector& x, size_t incx, Vector& y, size_t incy) {
@@ -58,28 +93,39 @@ template<typename Scalar> auto size(const std::vector<Scalar>& v) { return v.siz
 // The library does support arbitrary posit configuration conversions, but to simplify the 
 // behavior of the dot product, the element type of the vectors x and y are declared to be the same.
 // TODO: investigate if the vector<> index is always a 32bit entity?
-template<typename Vector>
+template<typename ReductionPolicy = default_reduction, typename Vector>
 typename Vector::value_type dot(size_t n, const Vector& x, size_t incx, const Vector& y, size_t incy) {
 	using value_type = typename Vector::value_type;
-	value_type sum_of_products = value_type(0);
-	size_t cnt, ix, iy;
-	for (cnt = 0, ix = 0, iy = 0; cnt < n && ix < size(x) && iy < size(y); ++cnt, ix += incx, iy += incy) {
-		sum_of_products += x[ix] * y[iy];
-	}
-	return sum_of_products;
+	size_t cnt = std::min(n, std::min((size(x) + incx - 1) / incx, (size(y) + incy - 1) / incy));
+	return ReductionPolicy::template dot<value_type>(cnt, [&](size_t i) { return x[i * incx]; }, [&](size_t i) { return y[i * incy]; });
 }
 // specialized dot product assuming constant stride
-template<typename Vector>
+template<typename ReductionPolicy = default_reduction, typename Vector>
 typename Vector::value_type dot(const Vector& x, const Vector& y) {
 	using value_type = typename Vector::value_type;
-	value_type sum_of_products = value_type(0);
 	size_t nx = size(x);
-	if (nx <= size(y)) {
-		for (size_t i = 0; i < nx; ++i) {
-			sum_of_products += x[i] * y[i];
-		}
+	if (nx > size(y)) return value_type(0);
+	return ReductionPolicy::template dot<value_type>(nx, [&](size_t i) { return x[i]; }, [&](size_t i) { return y[i]; });
+}
+
+// Euclidean norm of a vector: the square root of the sum of squares of the vector elements, default increment stride is 1
+// The elements are scaled by the largest magnitude, as in LAPACK's dnrm2, so that the squares neither overflow nor underflow:
+// the sum of the scaled squares is in [1, n], and is accumulated with the reduction policy.
+template<typename ReductionPolicy = default_reduction, typename Vector>
+typename Vector::value_type nrm2(size_t n, const Vector& x, size_t incx = 1) {
+	using value_type = typename Vector::value_type;
+	using std::sqrt;
+	size_t cnt = (n + incx - 1) / incx;
+	value_type scale(0);
+	for (size_t i = 0; i < cnt; ++i) {
+		value_type e = x[i * incx];
+		if (e < 0) e = -e;
+		if (!(e == e)) return e;  // NaN
+		if (e > scale) scale = e;
 	}
-	return sum_of_products;
+	if (scale == 0 || scale > std::numeric_limits<value_type>::max()) return scale;
+	auto element = [&](size_t i) { return value_type(x[i * incx] / scale); };
+	return scale * sqrt(ReductionPolicy::template dot<value_type>(cnt, element, element));
 }
 
 // rotation of points in the plane
@@ -261,6 +307,25 @@ Scalar norm(const sw::universal::blas::vector<Scalar>& v, int p) {
 	return norm;
 }
 
+// L1-norm of a vector expression, accumulated element by element without evaluating the expression
+template<typename Expression>
+auto normL1(const vector_expression<Expression>& x) {
+	using namespace sw::universal; // to specialize abs()
+	const Expression& e = x.self();
+	expression_detail::value_type_t<Expression> L1Norm{ 0 };
+	for (size_t i = 0; i < size(x); ++i) {
+		L1Norm += abs(e[i]);
+	}
+	return L1Norm;
+}
+
+// norm of a vector expression: the L1-norm of the solver convergence tests streams, the others evaluate the expression first
+template<typename Expression>
+auto norm(const vector_expression<Expression>& x, int p) {
+	if (p == 1) return normL1(x);
+	return norm(expression_detail::evaluate(x), p);
+}
+
 }}} // namespace sw::universal::blas
 
 // specializations for STL vectors
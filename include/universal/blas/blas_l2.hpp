@@ -7,6 +7,7 @@
 #include <iostream>
 #include <universal/blas/vector.hpp>
 #include <universal/blas/matrix.hpp>
+#include <universal/number/quire/kulisch.hpp>
 
 // compilation flags
 // BLAS_TRACE_ROUNDING_EVENTS
@@ -14,6 +15,12 @@
 #ifndef BLAS_TRACE_ROUNDING_EVENTS
 #define BLAS_TRACE_ROUNDING_EVENTS 0
 #endif
+// BLAS_FUSED_DOT_PRODUCT
+// when set the matrix-vector products of number systems with a Kulisch quire (cfloat, fixpnt, lns, bfloat16) are fused:
+// opt-in, as it changes the rounding of the results, and the lns quire is not exact
+#ifndef BLAS_FUSED_DOT_PRODUCT
+#define BLAS_FUSED_DOT_PRODUCT 0
+#endif
 
 namespace sw { namespace universal { namespace blas {
 
@@ -21,6 +28,19 @@ namespace sw { namespace universal { namespace blas {
 template<typename Matrix, typename Vector>
 void matvec(Vector& b, const Matrix& A, const Vector& x) {
 	using Scalar = typename Vector::value_type;
+#if BLAS_FUSED_DOT_PRODUCT
+	if constexpr (is_kulisch_enabled<Scalar>) {
+		kulisch_quire<Scalar> q;
+		for (size_t i = 0; i < A.rows(); ++i) {
+			q.clear();
+			for (size_t j = 0; j < A.cols(); ++j) {
+				q += quire_mul(A(i, j), x[j]);
+			}
+			b[i] = q.to_value();  // one and only rounding step of the fused-dot product
+		}
+		return;
+	}
+#endif
 	for (size_t i = 0; i < A.rows(); ++i) {
 		b[i] = Scalar(0);
 		for (size_t j = 0; j < A.cols(); ++j) {
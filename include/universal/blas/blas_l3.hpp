@@ -8,7 +8,7 @@
 namespace sw { namespace universal { namespace blas {
 
 // sum entire matrix (dim == 0), all rows (dim == 1), or all columns (dim == 2)
-template<typename Matrix>
+template<typename ReductionPolicy = default_reduction, typename Matrix>
 vector<typename Matrix::value_type> sumOfElements(Matrix& A, int dim = 0) {
 	using value_type = typename Matrix::value_type;
 	using size_type = typename Matrix::size_type;
@@ -19,12 +19,7 @@ vector<typename Matrix::value_type> sumOfElements(Matrix& A, int dim = 0) {
 	switch (dim) {
 	case 0:
 	{
-		value_type sum{ 0 };
-		for (size_type i = 0; i < rows; ++i) {
-			for (size_type j = 0; j < cols; ++j) {
-				sum += A(i, j);
-			}
-		}
+		value_type sum = ReductionPolicy::template sum<value_type>(size_t(rows) * size_t(cols), [&](size_t k) { return A(size_type(k / cols), size_type(k % cols)); });
 		return vector<value_type>{sum};
 	}
 
@@ -32,9 +27,7 @@ vector<typename Matrix::value_type> sumOfElements(Matrix& A, int dim = 0) {
 	{
 		vector<value_type> rowSums(rows);
 		for (size_type i = 0; i < rows; ++i) {
-			for (size_type j = 0; j < cols; ++j) {
-				rowSums[i] += A(i, j);
-			}
+			rowSums[i] = ReductionPolicy::template sum<value_type>(cols, [&](size_t j) { return A(i, size_type(j)); });
 		}
 		return rowSums;
 	}
@@ -42,10 +35,8 @@ vector<typename Matrix::value_type> sumOfElements(Matrix& A, int dim = 0) {
 	case 2:
 	{
 		vector<value_type> colSums(cols);
-		for (size_type i = 0; i < rows; ++i) {
-			for (size_type j = 0; j < cols; ++j) {
-				colSums[j] += A(i, j);
-			}
+		for (size_type j = 0; j < cols; ++j) {
+			colSums[j] = ReductionPolicy::template sum<value_type>(rows, [&](size_t i) { return A(size_type(i), j); });
 		}
 		return colSums;
 	}
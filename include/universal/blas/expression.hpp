@@ -0,0 +1,373 @@
+#pragma once
+// expression.hpp: expression templates for the element-wise arithmetic of blas::vector and blas::matrix
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <universal/blas/exceptions.hpp>
+
+/*
+   The element-wise operators of blas::vector and blas::matrix with container operands,
+   x + y, x - y, -x, alpha * x, x * alpha, and x / alpha, return new containers, so that
+   the result can be stored with auto, updated in place, and passed to the functions that
+   deduce their Scalar from a blas::vector<Scalar> or blas::matrix<Scalar> argument.
+
+   The lazy evaluation of an update is requested by wrapping a container in lazy(): an
+   operator with an operand that is not a container returns an expression object, which is
+   evaluated element by element when it is assigned to, added to, or used to construct a
+   container, so that
+
+       x = lazy(x) + alpha * lazy(p);
+       r = b - lazy(A * x);
+
+   run as a single loop without temporary containers. Every element of the result depends
+   only on the same element of the operands, so the target can appear on the right-hand side.
+   The products that are not element-wise, A * x, A * B, and the dot product x * y, are
+   evaluated eagerly and return containers and scalars.
+
+   Named containers are held by reference, temporaries and sub-expressions are held by value,
+   so an expression stored with auto is valid as long as the named containers it references
+   are. Functions that deduce their Scalar from a container need an evaluated expression:
+   vector<Scalar>(lazy(x) - y), or a variable declared with its type instead of auto.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+template<typename Scalar> class vector;
+template<typename Scalar> class matrix;
+
+// CRTP base of vector<Scalar> and of the vector expression nodes
+template<typename Expression>
+class vector_expression {
+public:
+	const Expression& self() const noexcept { return static_cast<const Expression&>(*this); }
+
+	// reductions of an expression without evaluating it into a vector
+	auto sum() const {
+		typename Expression::value_type sum(0);
+		for (size_t i = 0; i < self().size(); ++i) sum += self()[i];
+		return sum;
+	}
+	auto norm() const {
+		using std::sqrt;
+		typename Expression::value_type twoNorm(0);
+		for (size_t i = 0; i < self().size(); ++i) {
+			typename Expression::value_type e = self()[i];
+			twoNorm += e * e;
+		}
+		return sqrt(twoNorm);
+	}
+	auto infnorm() const {
+		using std::abs;
+		typename Expression::value_type infNorm(0);
+		for (size_t i = 0; i < self().size(); ++i) {
+			typename Expression::value_type e = abs(self()[i]);
+			if (e > infNorm) infNorm = e;
+		}
+		return infNorm;
+	}
+};
+
+// CRTP base of matrix<Scalar> and of the matrix expression nodes
+template<typename Expression>
+class matrix_expression {
+public:
+	const Expression& self() const noexcept { return static_cast<const Expression&>(*this); }
+};
+
+template<typename T>
+constexpr bool is_vector_expression = std::is_base_of_v<vector_expression<std::decay_t<T>>, std::decay_t<T>>;
+template<typename T>
+constexpr bool is_matrix_expression = std::is_base_of_v<matrix_expression<std::decay_t<T>>, std::decay_t<T>>;
+
+template<typename Expression>
+size_t size(const vector_expression<Expression>& x) { return x.self().size(); }
+
+namespace expression_detail {
+
+	template<typename T> struct is_container : std::false_type {};
+	template<typename Scalar> struct is_container<vector<Scalar>> : std::true_type {};
+	template<typename Scalar> struct is_container<matrix<Scalar>> : std::true_type {};
+
+	// the container of an expression: containers pass through, expression nodes are evaluated
+	template<typename Expression>
+	decltype(auto) evaluate(const vector_expression<Expression>& e) {
+		if constexpr (is_container<Expression>::value) return e.self();
+		else return vector<typename Expression::value_type>(e.self());
+	}
+	template<typename Expression>
+	decltype(auto) evaluate(const matrix_expression<Expression>& e) {
+		if constexpr (is_container<Expression>::value) return e.self();
+		else return matrix<typename Expression::value_type>(e.self());
+	}
+
+	// how an expression holds an operand: a reference to a named container, a copy of anything else
+	template<typename T>
+	using operand_t = std::conditional_t<std::is_lvalue_reference_v<T> && is_container<std::decay_t<T>>::value, const std::decay_t<T>&, std::decay_t<T>>;
+
+	template<typename T>
+	using value_type_t = typename std::decay_t<T>::value_type;
+
+	// the operators of container operands are eager, see vector.hpp and matrix.hpp
+	template<typename L, typename R>
+	constexpr bool lazy_operands = !(is_container<std::decay_t<L>>::value && is_container<std::decay_t<R>>::value);
+	template<typename X>
+	constexpr bool lazy_operand = !is_container<std::decay_t<X>>::value;
+
+	struct add {
+		static constexpr const char* symbol = "+";
+		template<typename A, typename B> auto operator()(const A& a, const B& b) const { return a + b; }
+	};
+	struct subtract {
+		static constexpr const char* symbol = "-";
+		template<typename A, typename B> auto operator()(const A& a, const B& b) const { return a - b; }
+	};
+	struct negate {
+		template<typename A> auto operator()(const A& a) const { return -a; }
+	};
+	template<typename Scalar>
+	struct scale_left {
+		Scalar alpha;
+		template<typename A> auto operator()(const A& a) const { return alpha * a; }
+	};
+	template<typename Scalar>
+	struct scale_right {
+		Scalar alpha;
+		template<typename A> auto operator()(const A& a) const { return a * alpha; }
+	};
+	template<typename Scalar>
+	struct divide_by {
+		Scalar alpha;
+		template<typename A> auto operator()(const A& a) const { return a / alpha; }
+	};
+
+} // namespace expression_detail
+
+/// <summary>
+/// element-wise binary operation of two vector expressions
+/// </summary>
+template<typename Op, typename Lhs, typename Rhs>
+class vector_binary_expression : public vector_expression<vector_binary_expression<Op, Lhs, Rhs>> {
+public:
+	using value_type = expression_detail::value_type_t<Lhs>;
+	static_assert(std::is_same_v<value_type, expression_detail::value_type_t<Rhs>>, "element-wise vector arithmetic requires operands of the same element type");
+
+	template<typename L, typename R>
+	vector_binary_expression(L&& lhs, R&& rhs) : _lhs(std::forward<L>(lhs)), _rhs(std::forward<R>(rhs)) {
+		if (_lhs.size() != _rhs.size()) {
+			throw matmul_incompatible_matrices(incompatible_matrices(_lhs.size(), 1, _rhs.size(), 1, Op::symbol).what());
+		}
+	}
+
+	size_t size() const { return _lhs.size(); }
+	value_type operator[](size_t i) const { return value_type(Op{}(_lhs[i], _rhs[i])); }
+	value_type operator()(size_t i) const { return (*this)[i]; }
+
+private:
+	Lhs _lhs;
+	Rhs _rhs;
+};
+
+/// <summary>
+/// element-wise unary operation of a vector expression: negation and scaling
+/// </summary>
+template<typename Op, typename Operand>
+class vector_unary_expression : public vector_expression<vector_unary_expression<Op, Operand>> {
+public:
+	using value_type = expression_detail::value_type_t<Operand>;
+
+	template<typename X>
+	vector_unary_expression(const Op& op, X&& x) : _op(op), _x(std::forward<X>(x)) {}
+
+	size_t size() const { return _x.size(); }
+	value_type operator[](size_t i) const { return value_type(_op(_x[i])); }
+	value_type operator()(size_t i) const { return (*this)[i]; }
+
+private:
+	Op      _op;
+	Operand _x;
+};
+
+/// <summary>
+/// element-wise binary operation of two matrix expressions
+/// </summary>
+template<typename Op, typename Lhs, typename Rhs>
+class matrix_binary_expression : public matrix_expression<matrix_binary_expression<Op, Lhs, Rhs>> {
+public:
+	using value_type = expression_detail::value_type_t<Lhs>;
+	static_assert(std::is_same_v<value_type, expression_detail::value_type_t<Rhs>>, "element-wise matrix arithmetic requires operands of the same element type");
+
+	template<typename L, typename R>
+	matrix_binary_expression(L&& lhs, R&& rhs) : _lhs(std::forward<L>(lhs)), _rhs(std::forward<R>(rhs)) {
+		if (_lhs.rows() != _rhs.rows() || _lhs.cols() != _rhs.cols()) {
+			throw matmul_incompatible_matrices(incompatible_matrices(_lhs.rows(), _lhs.cols(), _rhs.rows(), _rhs.cols(), Op::symbol).what());
+		}
+	}
+
+	unsigned rows() const { return _lhs.rows(); }
+	unsigned cols() const { return _lhs.cols(); }
+	value_type operator()(unsigned i, unsigned j) const { return value_type(Op{}(_lhs(i, j), _rhs(i, j))); }
+
+private:
+	Lhs _lhs;
+	Rhs _rhs;
+};
+
+/// <summary>
+/// element-wise unary operation of a matrix expression: negation and scaling
+/// </summary>
+template<typename Op, typename Operand>
+class matrix_unary_expression : public matrix_expression<matrix_unary_expression<Op, Operand>> {
+public:
+	using value_type = expression_detail::value_type_t<Operand>;
+
+	template<typename X>
+	matrix_unary_expression(const Op& op, X&& x) : _op(op), _x(std::forward<X>(x)) {}
+
+	unsigned rows() const { return _x.rows(); }
+	unsigned cols() const { return _x.cols(); }
+	value_type operator()(unsigned i, unsigned j) const { return value_type(_op(_x(i, j))); }
+
+private:
+	Op      _op;
+	Operand _x;
+};
+
+/// <summary>
+/// a vector as the operand of a lazily evaluated expression: a named vector by reference, a temporary by value
+/// </summary>
+template<typename Operand>
+class lazy_vector : public vector_expression<lazy_vector<Operand>> {
+public:
+	using value_type = expression_detail::value_type_t<Operand>;
+
+	template<typename X, std::enable_if_t<!std::is_same_v<std::decay_t<X>, lazy_vector>, int> = 0>
+	explicit lazy_vector(X&& x) : _x(std::forward<X>(x)) {}
+
+	size_t size() const { return _x.size(); }
+	value_type operator[](size_t i) const { return _x[i]; }
+	value_type operator()(size_t i) const { return _x[i]; }
+
+private:
+	Operand _x;
+};
+
+/// <summary>
+/// a matrix as the operand of a lazily evaluated expression: a named matrix by reference, a temporary by value
+/// </summary>
+template<typename Operand>
+class lazy_matrix : public matrix_expression<lazy_matrix<Operand>> {
+public:
+	using value_type = expression_detail::value_type_t<Operand>;
+
+	template<typename X, std::enable_if_t<!std::is_same_v<std::decay_t<X>, lazy_matrix>, int> = 0>
+	explicit lazy_matrix(X&& A) : _A(std::forward<X>(A)) {}
+
+	unsigned rows() const { return _A.rows(); }
+	unsigned cols() const { return _A.cols(); }
+	value_type operator()(unsigned i, unsigned j) const { return _A(i, j); }
+
+private:
+	Operand _A;
+};
+
+// the operators of a lazy operand build expressions instead of containers
+template<typename Scalar>
+lazy_vector<const vector<Scalar>&> lazy(const vector<Scalar>& x) { return lazy_vector<const vector<Scalar>&>(x); }
+template<typename Scalar>
+lazy_vector<vector<Scalar>> lazy(vector<Scalar>&& x) { return lazy_vector<vector<Scalar>>(std::move(x)); }
+template<typename Scalar>
+lazy_matrix<const matrix<Scalar>&> lazy(const matrix<Scalar>& A) { return lazy_matrix<const matrix<Scalar>&>(A); }
+template<typename Scalar>
+lazy_matrix<matrix<Scalar>> lazy(matrix<Scalar>&& A) { return lazy_matrix<matrix<Scalar>>(std::move(A)); }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// vector operators
+
+template<typename L, typename R, std::enable_if_t<is_vector_expression<L> && is_vector_expression<R> && expression_detail::lazy_operands<L, R>, int> = 0>
+auto operator+(L&& lhs, R&& rhs) {
+	using namespace expression_detail;
+	return vector_binary_expression<add, operand_t<L>, operand_t<R>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename L, typename R, std::enable_if_t<is_vector_expression<L> && is_vector_expression<R> && expression_detail::lazy_operands<L, R>, int> = 0>
+auto operator-(L&& lhs, R&& rhs) {
+	using namespace expression_detail;
+	return vector_binary_expression<subtract, operand_t<L>, operand_t<R>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename X, std::enable_if_t<is_vector_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator-(X&& x) {
+	using namespace expression_detail;
+	return vector_unary_expression<negate, operand_t<X>>(negate{}, std::forward<X>(x));
+}
+
+// scale a vector expression
+template<typename X, std::enable_if_t<is_vector_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator*(const expression_detail::value_type_t<X>& alpha, X&& x) {
+	using namespace expression_detail;
+	using Op = scale_left<value_type_t<X>>;
+	return vector_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(x));
+}
+
+template<typename X, std::enable_if_t<is_vector_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator*(X&& x, const expression_detail::value_type_t<X>& alpha) {
+	using namespace expression_detail;
+	using Op = scale_right<value_type_t<X>>;
+	return vector_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(x));
+}
+
+template<typename X, std::enable_if_t<is_vector_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator/(X&& x, const expression_detail::value_type_t<X>& alpha) {
+	using namespace expression_detail;
+	using Op = divide_by<value_type_t<X>>;
+	return vector_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(x));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// matrix operators
+
+template<typename L, typename R, std::enable_if_t<is_matrix_expression<L> && is_matrix_expression<R> && expression_detail::lazy_operands<L, R>, int> = 0>
+auto operator+(L&& A, R&& B) {
+	using namespace expression_detail;
+	return matrix_binary_expression<add, operand_t<L>, operand_t<R>>(std::forward<L>(A), std::forward<R>(B));
+}
+
+template<typename L, typename R, std::enable_if_t<is_matrix_expression<L> && is_matrix_expression<R> && expression_detail::lazy_operands<L, R>, int> = 0>
+auto operator-(L&& A, R&& B) {
+	using namespace expression_detail;
+	return matrix_binary_expression<subtract, operand_t<L>, operand_t<R>>(std::forward<L>(A), std::forward<R>(B));
+}
+
+template<typename X, std::enable_if_t<is_matrix_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator-(X&& A) {
+	using namespace expression_detail;
+	return matrix_unary_expression<negate, operand_t<X>>(negate{}, std::forward<X>(A));
+}
+
+template<typename X, std::enable_if_t<is_matrix_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator*(const expression_detail::value_type_t<X>& alpha, X&& A) {
+	using namespace expression_detail;
+	using Op = scale_left<value_type_t<X>>;
+	return matrix_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(A));
+}
+
+template<typename X, std::enable_if_t<is_matrix_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator*(X&& A, const expression_detail::value_type_t<X>& alpha) {
+	using namespace expression_detail;
+	using Op = scale_right<value_type_t<X>>;
+	return matrix_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(A));
+}
+
+template<typename X, std::enable_if_t<is_matrix_expression<X> && expression_detail::lazy_operand<X>, int> = 0>
+auto operator/(X&& A, const expression_detail::value_type_t<X>& alpha) {
+	using namespace expression_detail;
+	using Op = divide_by<value_type_t<X>>;
+	return matrix_unary_expression<Op, operand_t<X>>(Op{ alpha }, std::forward<X>(A));
+}
+
+}}} // namespace sw::universal::blas
@@ -16,6 +16,7 @@
 #include <universal/blas/generators/minij.hpp>
 
 // random matrices
+#include <universal/blas/generators/random_stream.hpp>
 #include <universal/blas/generators/uniform_random.hpp>
 #include <universal/blas/generators/gaussian_random.hpp>
 #include <universal/blas/generators/randsvd.hpp>
@@ -1,10 +1,10 @@
 #pragma once
-// uniform_random.hpp: uniform random matrix generator
+// gaussian_random.hpp: gaussian random matrix generator
 //
 // Copyright (C) 2017-2022 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
-#include <random>
+#include <universal/blas/generators/random_stream.hpp>
 
 namespace sw { namespace universal { namespace blas {  
 
@@ -13,35 +13,18 @@ namespace sw { namespace universal { namespace blas {
     vector<Scalar> gaussian_random_vector(unsigned N, double mean = 100.00, double stddev = 6.00) {
         vector<Scalar> v(N);
         return gaussian_random(v, mean, stddev);
-
     }
 
+    // fill a vector with gaussian random values from a stream seeded by the entropy source:
+    // use a random_stream for reproducible values
     template<typename Scalar>
     inline std::vector<Scalar>& gaussian_random(std::vector<Scalar>& v, double mean = 100.00, double stddev = 6.00) {
-        using value_type = typename vector<Scalar>::value_type;
-        using size_type = typename vector<Scalar>::size_type;
-        const size_type nrElements = size(v);
-        std::random_device rd;
-        std::mt19937 rng(rd());
-        for (size_type i = 0; i < nrElements; ++i) {
-            std::normal_distribution<double> s(mean, stddev);
-            v[i] = value_type(s(rng));
-        }
-        return v;
+        return gaussian_random(v, mean, stddev, random_stream(random_detail::entropy()));
     }
 
     template<typename Scalar>
     inline vector<Scalar>& gaussian_random(vector<Scalar>& v, double mean = 100.00, double stddev = 6.00) {
-        using value_type = typename vector<Scalar>::value_type;
-        using size_type = typename vector<Scalar>::size_type;
-        const size_type nrElements = size(v);
-        std::random_device rd;
-        std::mt19937 rng(rd());
-        for (size_type i = 0; i < nrElements; ++i) {
-            std::normal_distribution<double> s(mean, stddev);
-            v[i] = value_type(s(rng));
-        }
-        return v;
+        return gaussian_random(v, mean, stddev, random_stream(random_detail::entropy()));
     }
 
     // generate a gaussian random MxN matrix
@@ -53,32 +36,7 @@ namespace sw { namespace universal { namespace blas {
 
     template<typename Scalar>
     inline matrix<Scalar>& gaussian_random(matrix<Scalar>& A, double mean = 100.00, double stddev = 6.00){
-        using value_type = typename matrix<Scalar>::value_type;
-        using size_type = typename matrix<Scalar>::size_type;
-        const size_type ncols = num_cols(A), nrows = num_rows(A);                
-        std::random_device rd;
-        std::mt19937 rng(rd());                
-        for(size_t i=0; i<nrows; ++i) {
-            for(size_t j=0; j<ncols; ++j) {
-                std::normal_distribution<double> s(mean, stddev);
-                A[i][j]=value_type(s(rng));
-            }
-        }
-        return A;
-    }
-
-
-template<typename Scalar>
-inline void gaussian_random(vector<Scalar>& omega, double mean = 100.00, double stddev = 6.00){
-    using value_type = typename vector<Scalar>::value_type;
-    // using unsigned = typename vector<Scalar>::size_type;
-    const unsigned nelements = size(omega);                
-    std::random_device rd;
-    std::mt19937 rng(rd());                
-    for(unsigned j=0; j<nelements; ++j) {
-        std::normal_distribution<double> s(mean, stddev);
-        omega[j]=value_type(s(rng));
+        return gaussian_random(A, mean, stddev, random_stream(random_detail::entropy()));
     }
-}
 
-}}} // namespace sw::universal::blas
\ No newline at end of file
+}}} // namespace sw::universal::blas
@@ -0,0 +1,65 @@
+#pragma once
+// philox.hpp: Philox4x32-10 counter-based random number generator
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <array>
+#include <cstdint>
+
+/*
+   Philox4x32-10 of Salmon, Moraes, Dror, and Shaw, "Parallel random numbers: as easy as 1, 2, 3",
+   SC'11, as in the Random123 library. The generator is a bijection of a 128-bit counter under a
+   64-bit key: the random numbers of element i of a stream are a function of (key, i) only, so
+   that any thread can produce any part of the stream without state and without a skip-ahead,
+   and the results do not depend on how the work is split.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+class philox4x32 {
+public:
+	using counter_type = std::array<uint32_t, 4>;
+	using key_type = std::array<uint32_t, 2>;
+	static constexpr unsigned rounds = 10;
+
+	constexpr explicit philox4x32(uint64_t seed = 0) noexcept : _key{ uint32_t(seed), uint32_t(seed >> 32) } {}
+	constexpr explicit philox4x32(key_type key) noexcept : _key{ key } {}
+
+	constexpr key_type key() const noexcept { return _key; }
+
+	// the four random words of the 128-bit counter
+	constexpr counter_type operator()(counter_type counter) const noexcept {
+		key_type key = _key;
+		counter = round(counter, key);
+		for (unsigned r = 1; r < rounds; ++r) {
+			key[0] += W0;
+			key[1] += W1;
+			counter = round(counter, key);
+		}
+		return counter;
+	}
+	// the four random words of block b of the stream
+	constexpr counter_type operator()(uint64_t b) const noexcept {
+		return (*this)(counter_type{ uint32_t(b), uint32_t(b >> 32), 0, 0 });
+	}
+	// random word i of the stream: word i % 4 of block i / 4
+	constexpr uint32_t word(uint64_t i) const noexcept {
+		return (*this)(i >> 2)[i & 3];
+	}
+
+private:
+	static constexpr uint32_t M0 = 0xD2511F53u;
+	static constexpr uint32_t M1 = 0xCD9E8D57u;
+	static constexpr uint32_t W0 = 0x9E3779B9u;  // golden ratio
+	static constexpr uint32_t W1 = 0xBB67AE85u;  // sqrt(3) - 1
+	key_type _key;
+
+	static constexpr counter_type round(const counter_type& c, const key_type& k) noexcept {
+		uint64_t p0 = uint64_t(M0) * c[0];
+		uint64_t p1 = uint64_t(M1) * c[2];
+		return counter_type{ uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1), uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0) };
+	}
+};
+
+}}} // namespace sw::universal::blas
@@ -0,0 +1,192 @@
+#pragma once
+// random_stream.hpp: reproducible, counter-based random streams and parallel random fills
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <universal/blas/vector.hpp>
+#include <universal/blas/matrix.hpp>
+#include <universal/blas/generators/philox.hpp>
+
+/*
+   A random_stream is a Philox4x32-10 generator keyed by a 64-bit seed, with a 32-bit stream
+   number for independent streams of the same seed. The random numbers of element i are the
+   bijection of the counter (i, stream, draw), so element i of a fill is a function of the seed
+   and i only: the elements can be generated in any order, by any number of threads, and the
+   result is bit identical. The draw counts the retries of a rejection, and keeps them on the
+   same element.
+
+   The uniform samples have 53 random bits. The gaussian samples of elements 2k and 2k + 1 are
+   the cosine and the sine half of the Box-Muller transform of the two uniform samples of
+   block k, and the gaussian fills compute the transform once for the pair. The values are
+   rounded once to the Scalar by its own conversion. random_encodings generates the Scalar directly from the bits:
+   every encoding is equally likely, which is the sampling of a number system that exhaustive
+   and Monte-Carlo sweeps of the format need, and does not go through double.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+class random_stream {
+public:
+	explicit random_stream(uint64_t seed = 0, uint32_t stream = 0) noexcept : _rng{ seed }, _stream{ stream } {}
+
+	uint32_t stream() const noexcept { return _stream; }
+
+	// the 128 random bits of element i
+	philox4x32::counter_type block(uint64_t i, uint32_t draw = 0) const noexcept {
+		return _rng(philox4x32::counter_type{ uint32_t(i), uint32_t(i >> 32), _stream, draw });
+	}
+	// 64 random bits of element i
+	uint64_t bits(uint64_t i, uint32_t draw = 0) const noexcept {
+		auto r = block(i, draw);
+		return (uint64_t(r[1]) << 32) | r[0];
+	}
+	// uniform sample of element i in [0, 1)
+	double uniform(uint64_t i) const noexcept {
+		return double(bits(i) >> 11) * 0x1.0p-53;
+	}
+	// standard normal samples of elements 2k and 2k + 1: the cosine and the sine half of one Box-Muller transform
+	std::pair<double, double> normal_pair(uint64_t k) const noexcept {
+		constexpr double twoPi = 6.283185307179586476925286766559;
+		auto r = block(k);
+		double u1 = double(((uint64_t(r[1]) << 32 | r[0]) >> 11) + 1) * 0x1.0p-53;  // (0, 1]
+		double u2 = double((uint64_t(r[3]) << 32 | r[2]) >> 11) * 0x1.0p-53;
+		double radius = std::sqrt(-2.0 * std::log(u1));
+		return { radius * std::cos(twoPi * u2), radius * std::sin(twoPi * u2) };
+	}
+	// standard normal sample of element i
+	double normal(uint64_t i) const noexcept {
+		auto z = normal_pair(i >> 1);
+		return ((i & 1) ? z.second : z.first);
+	}
+
+private:
+	philox4x32 _rng;
+	uint32_t   _stream;
+};
+
+namespace random_detail {
+
+	// a seed from the entropy source of the platform
+	inline uint64_t entropy() {
+		std::random_device rd;
+		return (uint64_t(rd()) << 32) | rd();
+	}
+
+	// f(i) for i in [0, n), split over nrThreads threads
+	template<typename Function>
+	void parallel_fill(size_t n, unsigned nrThreads, Function&& f) {
+		if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+		nrThreads = unsigned(std::min(size_t(nrThreads), std::max(size_t(1), n / 1024)));
+		auto chunk = [&f, n, nrThreads](unsigned t) {
+			size_t first = n * t / nrThreads, last = n * (t + 1) / nrThreads;
+			for (size_t i = first; i < last; ++i) f(i);
+		};
+		if (nrThreads == 1) {
+			chunk(0);
+			return;
+		}
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < nrThreads; ++t) threads.emplace_back(chunk, t);
+		for (auto& t : threads) t.join();
+	}
+
+	// f(i, z) for the standard normal sample z of element i in [0, n): one Box-Muller transform for elements 2k and 2k + 1
+	template<typename Function>
+	void parallel_normal_fill(size_t n, unsigned nrThreads, const random_stream& rng, Function&& f) {
+		parallel_fill((n + 1) / 2, nrThreads, [&f, &rng, n](size_t k) {
+			auto z = rng.normal_pair(k);
+			f(2 * k, z.first);
+			if (2 * k + 1 < n) f(2 * k + 1, z.second);
+		});
+	}
+
+} // namespace random_detail
+
+/// <summary>
+/// fill a vector with uniform random values in [lowerbound, upperbound), element i is sample i of the stream
+/// </summary>
+/// <param name="nrThreads">number of threads, 0 selects the hardware concurrency: the values do not depend on it</param>
+template<typename Scalar>
+vector<Scalar>& uniform_random(vector<Scalar>& v, double lowerbound, double upperbound, const random_stream& rng, unsigned nrThreads = 1) {
+	double range = upperbound - lowerbound;
+	random_detail::parallel_fill(size(v), nrThreads, [&](size_t i) { v[i] = Scalar(lowerbound + range * rng.uniform(i)); });
+	return v;
+}
+
+/// <summary>
+/// fill a matrix with uniform random values in [lowerbound, upperbound), element (i, j) is sample i * cols + j of the stream
+/// </summary>
+template<typename Scalar>
+matrix<Scalar>& uniform_random(matrix<Scalar>& A, double lowerbound, double upperbound, const random_stream& rng, unsigned nrThreads = 1) {
+	double range = upperbound - lowerbound;
+	size_t n = num_cols(A);
+	random_detail::parallel_fill(size_t(num_rows(A)) * n, nrThreads, [&](size_t p) { A(unsigned(p / n), unsigned(p % n)) = Scalar(lowerbound + range * rng.uniform(p)); });
+	return A;
+}
+
+/// <summary>
+/// fill a vector with gaussian random values, element i is sample i of the stream
+/// </summary>
+template<typename Scalar>
+vector<Scalar>& gaussian_random(vector<Scalar>& v, double mean, double stddev, const random_stream& rng, unsigned nrThreads = 1) {
+	random_detail::parallel_normal_fill(size(v), nrThreads, rng, [&](size_t i, double z) { v[i] = Scalar(mean + stddev * z); });
+	return v;
+}
+
+template<typename Scalar>
+std::vector<Scalar>& gaussian_random(std::vector<Scalar>& v, double mean, double stddev, const random_stream& rng, unsigned nrThreads = 1) {
+	random_detail::parallel_normal_fill(v.size(), nrThreads, rng, [&](size_t i, double z) { v[i] = Scalar(mean + stddev * z); });
+	return v;
+}
+
+/// <summary>
+/// fill a matrix with gaussian random values, element (i, j) is sample i * cols + j of the stream
+/// </summary>
+template<typename Scalar>
+matrix<Scalar>& gaussian_random(matrix<Scalar>& A, double mean, double stddev, const random_stream& rng, unsigned nrThreads = 1) {
+	size_t n = num_cols(A);
+	random_detail::parallel_normal_fill(size_t(num_rows(A)) * n, nrThreads, rng, [&](size_t p, double z) { A(unsigned(p / n), unsigned(p % n)) = Scalar(mean + stddev * z); });
+	return A;
+}
+
+/// <summary>
+/// the Scalar of uniformly distributed encoding of element i of the stream
+/// </summary>
+/// <param name="finite">redraw the encodings that are NaN or infinite</param>
+template<typename Scalar>
+Scalar random_encoding(const random_stream& rng, uint64_t i, bool finite = false) {
+	static_assert(Scalar::nbits <= 64, "random_encoding: Scalar must have at most 64 bits");
+	constexpr uint64_t mask = (Scalar::nbits == 64 ? ~uint64_t(0) : (uint64_t(1) << (Scalar::nbits % 64)) - 1);
+	Scalar s;
+	uint32_t draw = 0;
+	do {
+		s.setbits(rng.bits(i, draw++) & mask);
+	} while (finite && !std::isfinite(double(s)));
+	return s;
+}
+
+/// <summary>
+/// fill a vector with uniformly distributed encodings of the Scalar, element i is encoding i of the stream
+/// </summary>
+template<typename Scalar>
+vector<Scalar>& random_encodings(vector<Scalar>& v, const random_stream& rng, bool finite = false, unsigned nrThreads = 1) {
+	random_detail::parallel_fill(size(v), nrThreads, [&](size_t i) { v[i] = random_encoding<Scalar>(rng, i, finite); });
+	return v;
+}
+
+template<typename Scalar>
+matrix<Scalar>& random_encodings(matrix<Scalar>& A, const random_stream& rng, bool finite = false, unsigned nrThreads = 1) {
+	size_t n = num_cols(A);
+	random_detail::parallel_fill(size_t(num_rows(A)) * n, nrThreads, [&](size_t p) { A(unsigned(p / n), unsigned(p % n)) = random_encoding<Scalar>(rng, p, finite); });
+	return A;
+}
+
+}}} // namespace sw::universal::blas
@@ -5,7 +5,7 @@
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 #include <cstdint>
-#include <random>
+#include <universal/blas/generators/random_stream.hpp>
 
 namespace sw { namespace universal { namespace blas {
 
@@ -16,26 +16,12 @@ namespace sw { namespace universal { namespace blas {
 		return uniform_random(v, lowerbound, upperbound);
 	}
 
-	// fill a dense vector with random values between [lowerbound, upperbound]
+	// fill a dense vector with random values between [lowerbound, upperbound)
+	// from a stream seeded by the entropy source: use a random_stream for reproducible values
 	template <typename Scalar>
 	vector<Scalar>& uniform_random(vector<Scalar>& v, double lowerbound = 0.0, double upperbound = 1.0)
 	{
-		// Use random_device to generate a seed for Mersenne twister engine.
-		std::random_device rd{};
-		// Use Mersenne twister engine to generate pseudo-random numbers.
-		std::mt19937 engine{ rd() };
-		// "Filter" MT engine's output to generate pseudo-random double values,
-		// **uniformly distributed** on the closed interval [lowerbound, upperbound].
-		// (Note that the range is [inclusive, inclusive].)
-		std::uniform_real_distribution<double> dist{ lowerbound, upperbound };
-		// Pattern to generate pseudo-random number.
-		// double rnd_value = dist(engine);
-
-		// generate and insert random values in A
-		for (unsigned i = 0; i < v.size(); ++i) {
-			v[i] = Scalar(dist(engine));
-		}
-		return v;
+		return uniform_random(v, lowerbound, upperbound, random_stream(random_detail::entropy()));
 	}
 
 	// generate a uniform random MxN matrix
@@ -45,34 +31,12 @@ namespace sw { namespace universal { namespace blas {
 		return uniform_random(A, lowerbound, upperbound);
 	}
 
-	// fill a dense matrix with random values between [lowerbound, upperbound]
+	// fill a dense matrix with random values between [lowerbound, upperbound)
+	// from a stream seeded by the entropy source: use a random_stream for reproducible values
 	template <typename Scalar>
 	matrix<Scalar>& uniform_random(matrix<Scalar>& A, double lowerbound = 0.0, double upperbound = 1.0)
 	{
-		// Use random_device to generate a seed for Mersenne twister engine.
-		std::random_device rd{};
-		// Use Mersenne twister engine to generate pseudo-random numbers.
-		std::mt19937 engine{ rd() };
-		// "Filter" MT engine's output to generate pseudo-random double values,
-		// **uniformly distributed** on the closed interval [lowerbound, upperbound].
-		// (Note that the range is [inclusive, inclusive].)
-		std::uniform_real_distribution<double> dist{ lowerbound, upperbound };
-		// Pattern to generate pseudo-random number.
-		// double rnd_value = dist(engine);
-
-		using Matrix = matrix<Scalar>;
-		typedef typename Matrix::value_type    value_type;
-		typedef typename Matrix::size_type     size_type;
-
-		// inserters add to the elements, so we need to set the value to 0 before we begin
-		A = 0.0;
-		// generate and insert random values in A
-		for (size_type r = 0; r < num_rows(A); r++) {
-			for (size_type c = 0; c < num_cols(A); c++) {
-				A[r][c] = value_type(dist(engine));
-			}
-		}
-		return A;
+		return uniform_random(A, lowerbound, upperbound, random_stream(random_detail::entropy()));
 	}
 
-}}} // namespace sw::universal::blas
\ No newline at end of file
+}}} // namespace sw::universal::blas
@@ -9,6 +9,7 @@
 #include <initializer_list>
 #include <map>
 #include <universal/blas/exceptions.hpp>
+#include <universal/blas/expression.hpp>
 
 #if defined(__clang__)
 /* Clang/LLVM. ---------------------------------------------- */
@@ -73,7 +74,7 @@ private:
 };
 
 template<typename Scalar>
-class matrix {
+class matrix : public matrix_expression<matrix<Scalar>> {
 public:
 	typedef Scalar									value_type;
 	typedef const value_type&						const_reference;
@@ -107,6 +108,12 @@ public:
 		_n = ncols;
 	}
 	matrix(const matrix& A) : _m{ A._m }, _n{ A._n }, data(A.data) {}
+	matrix(matrix&& A) = default;
+	// evaluate an element-wise expression
+	template<typename Expression>
+	matrix(const matrix_expression<Expression>& e) : _m{ e.self().rows() }, _n{ e.self().cols() }, data(size_t(_m) * _n) {
+		assign(e.self());
+	}
 
 	// Converting Constructor (SourceType A --> Scalar B)
 	template<typename SourceType>
@@ -125,6 +132,18 @@ public:
 	*/
 	matrix& operator=(const matrix& M) = default;
 	matrix& operator=(matrix&& M) = default;
+	// evaluate an element-wise expression in a single pass: the expression may reference this matrix
+	template<typename Expression>
+	matrix& operator=(const matrix_expression<Expression>& e) {
+		const Expression& expr = e.self();
+		if (expr.rows() != _m || expr.cols() != _n) {
+			_m = expr.rows();
+			_n = expr.cols();
+			data.resize(size_t(_m) * _n);
+		}
+		assign(expr);
+		return *this;
+	}
 
 	// Identity matrix operator
 	matrix& operator=(const Scalar& one) {
@@ -148,28 +167,36 @@ public:
 	}
 
 	// matrix element-wise sum
-	matrix& operator+=(const matrix& rhs) {
+	template<typename Expression>
+	matrix& operator+=(const matrix_expression<Expression>& rhs) {
+		const Expression& expr = rhs.self();
 		// check if the matrices are compatible
-		if (_m != rhs._m || _n != rhs._n) {
+		if (_m != expr.rows() || _n != expr.cols()) {
 			std::cerr << "Element-wise matrix sum received incompatible matrices ("
-				<< _m << ", " << _n << ") += (" << rhs._m << ", " << rhs._n << ")\n";
+				<< _m << ", " << _n << ") += (" << expr.rows() << ", " << expr.cols() << ")\n";
 			return *this; // return without changing
 		}
-		for (size_type e = 0; e < _m * _n; ++e) {
-			data[e] += rhs.data[e];
+		for (unsigned i = 0; i < _m; ++i) {
+			for (unsigned j = 0; j < _n; ++j) {
+				data[i * _n + j] += expr(i, j);
+			}
 		}
 		return *this;
 	}
 	// matrix element-wise difference
-	matrix& operator-=(const matrix& rhs) {
+	template<typename Expression>
+	matrix& operator-=(const matrix_expression<Expression>& rhs) {
+		const Expression& expr = rhs.self();
 		// check if the matrices are compatible
-		if (_m != rhs._m || _n != rhs._n) {
+		if (_m != expr.rows() || _n != expr.cols()) {
 			std::cerr << "Element-wise matrix difference received incompatible matrices ("
-				<< _m << ", " << _n << ") -= (" << rhs._m << ", " << rhs._n << ")\n";
+				<< _m << ", " << _n << ") -= (" << expr.rows() << ", " << expr.cols() << ")\n";
 			return *this; // return without changing
 		}
-		for (size_type e = 0; e < _m*_n; ++e) {
-			data[e] -= rhs.data[e];
+		for (unsigned i = 0; i < _m; ++i) {
+			for (unsigned j = 0; j < _n; ++j) {
+				data[i * _n + j] -= expr(i, j);
+			}
 		}
 		return *this;
 	}
@@ -267,6 +294,15 @@ private:
 	unsigned _m, _n; // m rows and n columns
 	std::vector<Scalar> data;
 
+	template<typename Expression>
+	void assign(const Expression& expr) {
+		for (unsigned i = 0; i < _m; ++i) {
+			for (unsigned j = 0; j < _n; ++j) {
+				data[i * _n + j] = Scalar(expr(i, j));
+			}
+		}
+	}
+
 };
 
 template<typename Scalar>
@@ -291,6 +327,12 @@ std::ostream& operator<<(std::ostream& ostr, const matrix<Scalar>& A) {
 	return ostr;
 }
 
+// print a matrix expression: the expression is evaluated first
+template<typename Expression>
+std::ostream& operator<<(std::ostream& ostr, const matrix_expression<Expression>& e) {
+	return ostr << expression_detail::evaluate(e);
+}
+
 // generate a posit format ASCII format nbits.esxNN...NNp
 template<unsigned nbits, unsigned es>
 inline std::string hex_format(const matrix< sw::universal::posit<nbits, es> >& A) {
@@ -328,6 +370,18 @@ matrix<Scalar> operator-(const matrix<Scalar>& A, const matrix<Scalar>& B) {
 	return Diff -= B;
 }
 
+// matrix negation
+template<typename Scalar>
+matrix<Scalar> operator-(const matrix<Scalar>& A) {
+	matrix<Scalar> Neg(A);
+	for (unsigned i = 0; i < num_rows(A); ++i) {
+		for (unsigned j = 0; j < num_cols(A); ++j) {
+			Neg(i, j) = -A(i, j);
+		}
+	}
+	return Neg;
+}
+
 // matrix scaling through Scalar multiply
 template<typename Scalar>
 matrix<Scalar> operator*(const Scalar& a, const matrix<Scalar>& B) {
@@ -335,6 +389,12 @@ matrix<Scalar> operator*(const Scalar& a, const matrix<Scalar>& B) {
 	return A *= a;
 }
 
+template<typename Scalar>
+matrix<Scalar> operator*(const matrix<Scalar>& B, const Scalar& a) {
+	matrix<Scalar> A(B);
+	return A *= a;
+}
+
 // matrix scaling through Scalar divide
 template<typename Scalar>
 matrix<Scalar> operator/(const matrix<Scalar>& A, const Scalar& b) {
@@ -342,7 +402,8 @@ matrix<Scalar> operator/(const matrix<Scalar>& A, const Scalar& b) {
 	return B /= b;
 }
 
- 
+// the operators of lazy(A) operands are expression templates: see expression.hpp
+
 // matrix-vector multiply
 template<typename Scalar>
 vector<Scalar> operator*(const matrix<Scalar>& A, const vector<Scalar>& x) {
@@ -356,6 +417,11 @@ vector<Scalar> operator*(const matrix<Scalar>& A, const vector<Scalar>& x) {
 	return b;
 }
 
+// matrix-vector multiply of expressions: the operands are evaluated first
+template<typename MatrixExpression, typename VectorExpression>
+auto operator*(const matrix_expression<MatrixExpression>& A, const vector_expression<VectorExpression>& x) {
+	return expression_detail::evaluate(A) * expression_detail::evaluate(x);
+}
 
 template<typename Scalar>
 matrix<Scalar> operator*(const matrix<Scalar>& A, const matrix<Scalar>& B) {
@@ -377,7 +443,11 @@ matrix<Scalar> operator*(const matrix<Scalar>& A, const matrix<Scalar>& B) {
 }
 
 
-
+// matrix-matrix multiply of expressions: the operands are evaluated first
+template<typename Lhs, typename Rhs>
+auto operator*(const matrix_expression<Lhs>& A, const matrix_expression<Rhs>& B) {
+	return expression_detail::evaluate(A) * expression_detail::evaluate(B);
+}
 
 template<typename Scalar>
 matrix<Scalar> operator%(const matrix<Scalar>& A, const matrix<Scalar>& B) {
@@ -437,6 +507,7 @@ matrix<Scalar> operator>(const matrix<Scalar>& A, const Scalar& x) {
 // maxelement (jq 2022-10-15)
 template<typename Scalar>
 Scalar maxelement(const matrix<Scalar>&A) {
+	using std::abs;
 	auto x = abs(A(0,0));
 	for (size_t i = 0; i < num_rows(A); ++i) {
 		for (size_t j = 0; j < num_cols(A); ++j) {
@@ -449,6 +520,7 @@ Scalar maxelement(const matrix<Scalar>&A) {
 // minelement (jq 2022-10-15)
 template<typename Scalar>
 Scalar minelement(const matrix<Scalar>&A) {
+	using std::abs;
 	auto x = maxelement(A);
 	for (size_t i = 0; i < num_rows(A); ++i) {
 		for (size_t j = 0; j < num_cols(A); ++j) {
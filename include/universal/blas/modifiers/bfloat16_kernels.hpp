@@ -0,0 +1,81 @@
+#pragma once
+// bfloat16_kernels.hpp: bfloat16 vector and matrix operators that dispatch to the bfloat16 array kernels
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/number/bfloat/bfloat.hpp>
+
+namespace sw { namespace universal { namespace blas {
+
+namespace bfloat16_detail {
+	inline const bfloat16* data(const vector<bfloat16>& v) { return (v.size() ? &*v.begin() : nullptr); }
+	inline bfloat16* data(vector<bfloat16>& v) { return (v.size() ? &*v.begin() : nullptr); }
+	inline const bfloat16* data(const matrix<bfloat16>& A) { return (A.size() ? &*A.begin() : nullptr); }
+	inline bfloat16* data(matrix<bfloat16>& A) { return (A.size() ? &*A.begin() : nullptr); }
+}
+
+// element-wise sum
+inline vector<bfloat16> operator+(const vector<bfloat16>& lhs, const vector<bfloat16>& rhs) {
+	vector<bfloat16> sum(size(lhs));
+	bfloat16_add(bfloat16_detail::data(lhs), bfloat16_detail::data(rhs), bfloat16_detail::data(sum), size(lhs));
+	return sum;
+}
+
+// element-wise difference
+inline vector<bfloat16> operator-(const vector<bfloat16>& lhs, const vector<bfloat16>& rhs) {
+	vector<bfloat16> difference(size(lhs));
+	bfloat16_sub(bfloat16_detail::data(lhs), bfloat16_detail::data(rhs), bfloat16_detail::data(difference), size(lhs));
+	return difference;
+}
+
+// scale a vector
+inline vector<bfloat16> operator*(const bfloat16& alpha, const vector<bfloat16>& x) {
+	vector<bfloat16> scaled(size(x));
+	bfloat16_scale(float(alpha), bfloat16_detail::data(x), bfloat16_detail::data(scaled), size(x));
+	return scaled;
+}
+inline vector<bfloat16> operator*(const vector<bfloat16>& x, const bfloat16& alpha) {
+	return alpha * x;
+}
+
+// dot product with float accumulation
+inline bfloat16 operator*(const vector<bfloat16>& a, const vector<bfloat16>& b) {
+	size_t N = size(a);
+	if (size(a) != size(b)) {
+		std::cerr << "vector sizes are different: " << N << " vs " << size(b) << '\n';
+		return bfloat16{ 0 };
+	}
+	return bfloat16(bfloat16_dot(bfloat16_detail::data(a), bfloat16_detail::data(b), N));
+}
+
+// matrix-vector product with float accumulation
+inline vector<bfloat16> operator*(const matrix<bfloat16>& A, const vector<bfloat16>& x) {
+	if (A.cols() != size(x)) throw matmul_incompatible_matrices(incompatible_matrices(A.rows(), A.cols(), size(x), 1, "*").what());
+	vector<bfloat16> b(A.rows());
+	const bfloat16* a = bfloat16_detail::data(A);
+	for (unsigned i = 0; i < A.rows(); ++i) {
+		b[i] = bfloat16(bfloat16_dot(a + size_t(i) * A.cols(), bfloat16_detail::data(x), A.cols()));
+	}
+	return b;
+}
+
+// mixed-precision matrix-matrix product: C = A * B with bfloat16 operands and float accumulation and result
+inline void gemm(const matrix<bfloat16>& A, const matrix<bfloat16>& B, matrix<float>& C) {
+	if (A.cols() != B.rows()) throw matmul_incompatible_matrices(incompatible_matrices(A.rows(), A.cols(), B.rows(), B.cols(), "gemm").what());
+	C.resize(A.rows(), B.cols());
+	C.setzero();
+	if (C.size() == 0 || A.cols() == 0) return;
+	bfloat16_gemm(A.rows(), B.cols(), A.cols(), bfloat16_detail::data(A), A.cols(), bfloat16_detail::data(B), B.cols(), &*C.begin(), C.cols());
+}
+
+// matrix-matrix product with float accumulation, rounded once to bfloat16
+inline matrix<bfloat16> operator*(const matrix<bfloat16>& A, const matrix<bfloat16>& B) {
+	matrix<float> C;
+	gemm(A, B, C);
+	matrix<bfloat16> R(C.rows(), C.cols());
+	if (R.size()) float_to_bfloat16(&*C.begin(), bfloat16_detail::data(R), R.size());
+	return R;
+}
+
+}}} // namespace sw::universal::blas
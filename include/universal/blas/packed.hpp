@@ -0,0 +1,449 @@
+#pragma once
+// packed.hpp: packed storage of vectors and matrices of 2 to 16-bit number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <universal/blas/vector.hpp>
+#include <universal/blas/matrix.hpp>
+
+/*
+   A vector<posit<4,0>> stores each element in the block type of the number system, a byte at
+   least, so the memory footprint and the memory traffic of a 4-bit format are those of an 8-bit
+   format. The packed containers store the nbits-bit encodings contiguously in 64-bit words:
+   element i occupies the bits [i * nbits, (i + 1) * nbits) of the word array, least significant
+   bit first, and an element may straddle two words. Read as little-endian bytes, this is the
+   packed layout of quantize_packed, so the output of the quantizer can be loaded as is.
+
+   Element access goes through a proxy reference that extracts or deposits the encoding, which
+   is correct but slow for loops. The bulk kernels unpack a run of elements into an array of the
+   number system, the registers, streaming the words through a 64-bit buffer, and pack a run
+   back into the words, merging the partial words at both ends. The arithmetic kernels operate
+   on blocks of packed_block elements that are unpacked into registers on the stack: the packed
+   data is read once, and the arithmetic is the arithmetic of the number system.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+// number of elements the arithmetic kernels unpack at a time
+constexpr size_t packed_block = 256;
+
+namespace packed_detail {
+
+	template<typename T, typename = void> struct has_encoding : std::false_type {};
+	template<typename T> struct has_encoding<T, std::void_t<decltype(std::declval<const T&>().encoding())>> : std::true_type {};
+	template<typename T, typename = void> struct has_block : std::false_type {};
+	template<typename T> struct has_block<T, std::void_t<decltype(std::declval<const T&>().block(0u))>> : std::true_type {};
+	template<typename T, typename = void> struct has_bits : std::false_type {};
+	template<typename T> struct has_bits<T, std::void_t<decltype(std::declval<const T&>().bits().block(0u))>> : std::true_type {};
+
+	// the bits of a block storage as an integer
+	template<unsigned nbits, typename Blocks>
+	uint64_t blocks(const Blocks& b) {
+		using bt = std::make_unsigned_t<std::decay_t<decltype(b.block(0u))>>;
+		constexpr unsigned bitsInBlock = sizeof(bt) * 8;
+		uint64_t raw = 0;
+		for (unsigned i = 0; i * bitsInBlock < nbits; ++i) raw |= uint64_t(bt(b.block(i))) << (i * bitsInBlock);
+		return raw;
+	}
+
+	// the nbits-bit encoding of a value, the inverse of setbits
+	template<typename Scalar>
+	uint64_t encoding(const Scalar& v) {
+		constexpr uint64_t mask = (uint64_t(1) << Scalar::nbits) - 1;
+		if constexpr (has_encoding<Scalar>::value) {
+			return uint64_t(v.encoding()) & mask;
+		}
+		else if constexpr (has_block<Scalar>::value) {
+			return blocks<Scalar::nbits>(v) & mask;
+		}
+		else {
+			static_assert(has_bits<Scalar>::value, "packed: Scalar does not give access to its encoding");
+			return blocks<Scalar::nbits>(v.bits()) & mask;
+		}
+	}
+
+	// the values of all the encodings of the Scalar
+	template<typename Scalar>
+	const std::vector<Scalar>& decode() {
+		static const std::vector<Scalar> table = [] {
+			std::vector<Scalar> t(size_t(1) << Scalar::nbits);
+			for (size_t e = 0; e < t.size(); ++e) t[e].setbits(uint64_t(e));
+			return t;
+		}();
+		return table;
+	}
+
+	// reads nbits-bit encodings from the bit position p on
+	template<unsigned nbits>
+	class reader {
+	public:
+		reader(const uint64_t* words, size_t p) : _words{ words + (p >> 6) + 1 } {
+			unsigned offset = unsigned(p & 63);
+			_buffer = words[p >> 6] >> offset;
+			_bits = 64 - offset;
+		}
+		uint64_t operator()() {
+			constexpr uint64_t mask = (uint64_t(1) << nbits) - 1;
+			uint64_t e;
+			if (_bits >= nbits) {
+				e = _buffer & mask;
+				_buffer >>= nbits;
+				_bits -= nbits;
+			}
+			else {
+				uint64_t w = *_words++;
+				e = (_buffer | (w << _bits)) & mask;
+				_buffer = w >> (nbits - _bits);
+				_bits += 64 - nbits;
+			}
+			return e;
+		}
+	private:
+		const uint64_t* _words;
+		uint64_t _buffer;
+		unsigned _bits;
+	};
+
+	// writes nbits-bit encodings from the bit position p on, flush merges the last partial word
+	template<unsigned nbits>
+	class writer {
+	public:
+		writer(uint64_t* words, size_t p) : _words{ words + (p >> 6) }, _bits{ unsigned(p & 63) } {
+			_buffer = words[p >> 6] & ((uint64_t(1) << _bits) - 1);
+		}
+		void operator()(uint64_t e) {
+			_buffer |= e << _bits;
+			_bits += nbits;
+			if (_bits >= 64) {
+				*_words++ = _buffer;
+				_bits -= 64;
+				_buffer = e >> (nbits - _bits);
+			}
+		}
+		void flush() {
+			if (_bits > 0) {
+				uint64_t low = (uint64_t(1) << _bits) - 1;
+				*_words = (*_words & ~low) | _buffer;
+			}
+		}
+	private:
+		uint64_t* _words;
+		uint64_t _buffer;
+		unsigned _bits;
+	};
+
+	// the encoding at the bit position p
+	template<unsigned nbits>
+	uint64_t extract(const uint64_t* words, size_t p) noexcept {
+		constexpr uint64_t mask = (uint64_t(1) << nbits) - 1;
+		size_t w = p >> 6;
+		unsigned offset = unsigned(p & 63);
+		uint64_t e = words[w] >> offset;
+		if (offset + nbits > 64) e |= words[w + 1] << (64 - offset);
+		return e & mask;
+	}
+	// replace the encoding at the bit position p
+	template<unsigned nbits>
+	void deposit(uint64_t* words, size_t p, uint64_t e) noexcept {
+		constexpr uint64_t mask = (uint64_t(1) << nbits) - 1;
+		size_t w = p >> 6;
+		unsigned offset = unsigned(p & 63);
+		words[w] = (words[w] & ~(mask << offset)) | (e << offset);
+		if (offset + nbits > 64) words[w + 1] = (words[w + 1] & ~(mask >> (64 - offset))) | (e >> (64 - offset));
+	}
+
+	constexpr size_t nr_words(size_t n, unsigned nbits) noexcept { return (n * nbits + 63) / 64; }
+
+} // namespace packed_detail
+
+// reference to the packed element at a bit position of a word array
+template<typename Scalar>
+class packed_reference {
+public:
+	static constexpr unsigned nbits = Scalar::nbits;
+	static constexpr uint64_t mask = (uint64_t(1) << nbits) - 1;
+
+	packed_reference(uint64_t* words, size_t p) noexcept : _words{ words }, _p{ p } {}
+	packed_reference(const packed_reference&) = default;
+
+	operator Scalar() const { return packed_detail::decode<Scalar>()[encoding()]; }
+	packed_reference& operator=(const Scalar& v) { setencoding(packed_detail::encoding(v)); return *this; }
+	packed_reference& operator=(const packed_reference& r) { setencoding(r.encoding()); return *this; }
+
+	packed_reference& operator+=(const Scalar& v) { return *this = Scalar(*this) + v; }
+	packed_reference& operator-=(const Scalar& v) { return *this = Scalar(*this) - v; }
+	packed_reference& operator*=(const Scalar& v) { return *this = Scalar(*this) * v; }
+	packed_reference& operator/=(const Scalar& v) { return *this = Scalar(*this) / v; }
+
+	Scalar value() const { return Scalar(*this); }
+	uint64_t encoding() const noexcept { return packed_detail::extract<nbits>(_words, _p); }
+	void setencoding(uint64_t e) noexcept { packed_detail::deposit<nbits>(_words, _p, e & mask); }
+
+	// the operators of the Scalar are templates that do not see the conversion of the proxy
+	friend bool operator==(const packed_reference& a, const Scalar& b) { return a.value() == b; }
+	friend bool operator!=(const packed_reference& a, const Scalar& b) { return a.value() != b; }
+	friend bool operator==(const Scalar& a, const packed_reference& b) { return a == b.value(); }
+	friend bool operator!=(const Scalar& a, const packed_reference& b) { return a != b.value(); }
+	friend std::ostream& operator<<(std::ostream& ostr, const packed_reference& r) { return ostr << r.value(); }
+
+private:
+	uint64_t* _words;
+	size_t    _p;
+};
+
+/// <summary>
+/// vector of the nbits-bit encodings of a Scalar, packed in 64-bit words
+/// </summary>
+template<typename Scalar>
+class packed_vector {
+public:
+	static_assert(Scalar::nbits >= 2 && Scalar::nbits <= 16, "packed_vector: Scalar must have 2 to 16 bits");
+	typedef Scalar                    value_type;
+	typedef packed_reference<Scalar>  reference;
+	typedef size_t                    size_type;
+	static constexpr unsigned nbits = Scalar::nbits;
+
+	packed_vector() : _n{ 0 } {}
+	packed_vector(size_t N) : _n{ N }, _words(packed_detail::nr_words(N, nbits)) { *this = Scalar(0); }
+	packed_vector(size_t N, const Scalar& v) : _n{ N }, _words(packed_detail::nr_words(N, nbits)) { *this = v; }
+	packed_vector(std::initializer_list<Scalar> iList) : _n{ iList.size() }, _words(packed_detail::nr_words(_n, nbits)) {
+		pack(iList.begin(), _n);
+	}
+	explicit packed_vector(const vector<Scalar>& v) : _n{ v.size() }, _words(packed_detail::nr_words(_n, nbits)) {
+		if (_n > 0) pack(&*v.begin(), _n);
+	}
+	// the packed encodings in the byte layout of quantize_packed
+	packed_vector(const uint8_t* bytes, size_t N) : _n{ N }, _words(packed_detail::nr_words(N, nbits)) {
+		size_t nrBytes = (N * nbits + 7) / 8;
+		for (size_t b = 0; b < nrBytes; ++b) _words[b >> 3] |= uint64_t(bytes[b]) << (8 * (b & 7));
+		if (N * nbits % 64) _words.back() &= (uint64_t(1) << (N * nbits % 64)) - 1;
+	}
+
+	packed_vector& operator=(const Scalar& v) {
+		fill(0, _n, packed_detail::encoding(v));
+		return *this;
+	}
+
+	size_t size() const noexcept { return _n; }
+	// the new elements are zero, the bits past the end are kept clear
+	void resize(size_t N) {
+		size_t n = _n;
+		_words.resize(packed_detail::nr_words(N, nbits));
+		_n = N;
+		if (N > n) fill(n, N - n, packed_detail::encoding(Scalar(0)));
+		else if (N * nbits % 64) _words.back() &= (uint64_t(1) << (N * nbits % 64)) - 1;
+	}
+	// bytes of storage of the elements
+	size_t storage() const noexcept { return _words.size() * sizeof(uint64_t); }
+	const uint64_t* data() const noexcept { return _words.data(); }
+	uint64_t* data() noexcept { return _words.data(); }
+
+	Scalar operator[](size_t i) const { return packed_detail::decode<Scalar>()[encoding(i)]; }
+	reference operator[](size_t i) { return reference(_words.data(), i * nbits); }
+	Scalar operator()(size_t i) const { return (*this)[i]; }
+	reference operator()(size_t i) { return (*this)[i]; }
+	uint64_t encoding(size_t i) const { return packed_detail::extract<nbits>(_words.data(), i * nbits); }
+
+	// unpack the elements [first, first + n) into the registers
+	void unpack(size_t first, size_t n, Scalar* registers) const {
+		if (n == 0) return;
+		const Scalar* table = packed_detail::decode<Scalar>().data();
+		packed_detail::reader<nbits> get(_words.data(), first * nbits);
+		for (size_t i = 0; i < n; ++i) registers[i] = table[get()];
+	}
+	// pack the registers into the elements [first, first + n)
+	void pack(const Scalar* registers, size_t n, size_t first = 0) {
+		if (n == 0) return;
+		packed_detail::writer<nbits> put(_words.data(), first * nbits);
+		for (size_t i = 0; i < n; ++i) put(packed_detail::encoding(registers[i]));
+		put.flush();
+	}
+	// the packed encodings in the byte layout of quantize_packed
+	std::vector<uint8_t> bytes() const {
+		std::vector<uint8_t> b((_n * nbits + 7) / 8);
+		for (size_t i = 0; i < b.size(); ++i) b[i] = uint8_t(_words[i >> 3] >> (8 * (i & 7)));
+		return b;
+	}
+	vector<Scalar> unpacked() const {
+		vector<Scalar> v(_n);
+		if (_n > 0) unpack(0, _n, &*v.begin());
+		return v;
+	}
+
+private:
+	size_t _n;
+	std::vector<uint64_t> _words;
+
+	void fill(size_t first, size_t n, uint64_t e) {
+		if (n == 0) return;
+		packed_detail::writer<nbits> put(_words.data(), first * nbits);
+		for (size_t i = 0; i < n; ++i) put(e);
+		put.flush();
+	}
+};
+
+/// <summary>
+/// row-major matrix of the nbits-bit encodings of a Scalar, packed in 64-bit words without row padding
+/// </summary>
+template<typename Scalar>
+class packed_matrix {
+public:
+	static_assert(Scalar::nbits >= 2 && Scalar::nbits <= 16, "packed_matrix: Scalar must have 2 to 16 bits");
+	typedef Scalar                    value_type;
+	typedef packed_reference<Scalar>  reference;
+	static constexpr unsigned nbits = Scalar::nbits;
+
+	packed_matrix() : _m{ 0 }, _n{ 0 } {}
+	packed_matrix(unsigned m, unsigned n) : _m{ m }, _n{ n }, _words(packed_detail::nr_words(size_t(m) * n, nbits)) {
+		Scalar zero(0);
+		std::vector<Scalar> row(n, zero);
+		for (unsigned i = 0; i < m; ++i) pack_row(i, row.data());
+	}
+	explicit packed_matrix(const matrix<Scalar>& A) : _m{ A.rows() }, _n{ A.cols() }, _words(packed_detail::nr_words(size_t(_m) * _n, nbits)) {
+		std::vector<Scalar> row(_n);
+		for (unsigned i = 0; i < _m; ++i) {
+			for (unsigned j = 0; j < _n; ++j) row[j] = A(i, j);
+			pack_row(i, row.data());
+		}
+	}
+
+	unsigned rows() const noexcept { return _m; }
+	unsigned cols() const noexcept { return _n; }
+	size_t storage() const noexcept { return _words.size() * sizeof(uint64_t); }
+	const uint64_t* data() const noexcept { return _words.data(); }
+
+	Scalar operator()(unsigned i, unsigned j) const { return packed_detail::decode<Scalar>()[packed_detail::extract<nbits>(_words.data(), position(i, j))]; }
+	reference operator()(unsigned i, unsigned j) { return reference(_words.data(), position(i, j)); }
+
+	// unpack the elements [first, first + n) of row i into the registers
+	void unpack_row(unsigned i, Scalar* registers, unsigned first = 0, unsigned n = unsigned(-1)) const {
+		if (n == unsigned(-1)) n = _n - first;
+		if (n == 0) return;
+		const Scalar* table = packed_detail::decode<Scalar>().data();
+		packed_detail::reader<nbits> get(_words.data(), position(i, first));
+		for (unsigned j = 0; j < n; ++j) registers[j] = table[get()];
+	}
+	// pack the registers into the elements [first, first + n) of row i
+	void pack_row(unsigned i, const Scalar* registers, unsigned first = 0, unsigned n = unsigned(-1)) {
+		if (n == unsigned(-1)) n = _n - first;
+		if (n == 0) return;
+		packed_detail::writer<nbits> put(_words.data(), position(i, first));
+		for (unsigned j = 0; j < n; ++j) put(packed_detail::encoding(registers[j]));
+		put.flush();
+	}
+	matrix<Scalar> unpacked() const {
+		matrix<Scalar> A(_m, _n);
+		std::vector<Scalar> row(_n);
+		for (unsigned i = 0; i < _m; ++i) {
+			unpack_row(i, row.data());
+			for (unsigned j = 0; j < _n; ++j) A(i, j) = row[j];
+		}
+		return A;
+	}
+
+private:
+	unsigned _m, _n;
+	std::vector<uint64_t> _words;
+
+	size_t position(unsigned i, unsigned j) const noexcept { return (size_t(i) * _n + j) * nbits; }
+};
+
+template<typename Scalar> inline size_t size(const packed_vector<Scalar>& v) { return v.size(); }
+template<typename Scalar> inline unsigned num_rows(const packed_matrix<Scalar>& A) { return A.rows(); }
+template<typename Scalar> inline unsigned num_cols(const packed_matrix<Scalar>& A) { return A.cols(); }
+
+////////////////////////////////////////////////////////////////////////
+// arithmetic on unpacked registers
+
+// dot product, accumulated in the Scalar in the order of the elements
+template<typename Scalar>
+Scalar dot(const packed_vector<Scalar>& x, const packed_vector<Scalar>& y) {
+	Scalar rx[packed_block], ry[packed_block];
+	if (x.size() != y.size()) throw matmul_incompatible_matrices(incompatible_matrices(x.size(), 1, y.size(), 1, "dot").what());
+	Scalar sum(0);
+	size_t n = x.size();
+	for (size_t first = 0; first < n; first += packed_block) {
+		size_t len = std::min(packed_block, n - first);
+		x.unpack(first, len, rx);
+		y.unpack(first, len, ry);
+		for (size_t i = 0; i < len; ++i) sum += rx[i] * ry[i];
+	}
+	return sum;
+}
+
+// y = a * x + y
+template<typename Scalar>
+void axpy(const Scalar& a, const packed_vector<Scalar>& x, packed_vector<Scalar>& y) {
+	if (x.size() != y.size()) throw matmul_incompatible_matrices(incompatible_matrices(x.size(), 1, y.size(), 1, "axpy").what());
+	Scalar rx[packed_block], ry[packed_block];
+	size_t n = x.size();
+	for (size_t first = 0; first < n; first += packed_block) {
+		size_t len = std::min(packed_block, n - first);
+		x.unpack(first, len, rx);
+		y.unpack(first, len, ry);
+		for (size_t i = 0; i < len; ++i) ry[i] += a * rx[i];
+		y.pack(ry, len, first);
+	}
+}
+
+// x = alpha * x
+template<typename Scalar>
+void scale(const Scalar& alpha, packed_vector<Scalar>& x) {
+	Scalar rx[packed_block];
+	for (size_t first = 0; first < x.size(); first += packed_block) {
+		size_t len = std::min(packed_block, x.size() - first);
+		x.unpack(first, len, rx);
+		for (size_t i = 0; i < len; ++i) rx[i] *= alpha;
+		x.pack(rx, len, first);
+	}
+}
+
+// matrix-vector product, the rows are streamed through the registers
+template<typename Scalar>
+vector<Scalar> operator*(const packed_matrix<Scalar>& A, const vector<Scalar>& x) {
+	if (A.cols() != size(x)) throw matmul_incompatible_matrices(incompatible_matrices(A.rows(), A.cols(), size(x), 1, "*").what());
+	Scalar ra[packed_block];
+	unsigned m = A.rows(), n = A.cols();
+	vector<Scalar> y(m);
+	for (unsigned i = 0; i < m; ++i) {
+		Scalar sum(0);
+		for (unsigned first = 0; first < n; first += unsigned(packed_block)) {
+			unsigned len = std::min(unsigned(packed_block), n - first);
+			A.unpack_row(i, ra, first, len);
+			for (unsigned j = 0; j < len; ++j) sum += ra[j] * x[first + j];
+		}
+		y[i] = sum;
+	}
+	return y;
+}
+
+template<typename Scalar>
+vector<Scalar> operator*(const packed_matrix<Scalar>& A, const packed_vector<Scalar>& x) {
+	return A * x.unpacked();
+}
+
+template<typename Scalar>
+std::ostream& operator<<(std::ostream& ostr, const packed_vector<Scalar>& v) {
+	auto width = ostr.width();
+	for (size_t i = 0; i < v.size(); ++i) ostr << std::setw(width) << v[i] << ' ';
+	return ostr;
+}
+
+template<typename Scalar>
+std::ostream& operator<<(std::ostream& ostr, const packed_matrix<Scalar>& A) {
+	auto width = ostr.width();
+	for (unsigned i = 0; i < A.rows(); ++i) {
+		for (unsigned j = 0; j < A.cols(); ++j) ostr << std::setw(width) << A(i, j) << ' ';
+		ostr << '\n';
+	}
+	return ostr;
+}
+
+}}} // namespace sw::universal::blas
@@ -0,0 +1,337 @@
+#pragma once
+// quantization.hpp: bulk quantization of double data to 2 to 16-bit number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <universal/blas/vector.hpp>
+#include <universal/blas/statistics.hpp>
+#include <universal/blas/generators/philox.hpp>
+
+/*
+   A quantization maps the data x to q = Target((x - offset) / scale), and back to
+   x ~ offset + scale * double(q). The scale and the offset come from the range of the data,
+   which quantization_parameters computes in one pass, or takes from the streaming_statistics
+   of the data. A symmetric quantization has offset 0 and a power of two scale, so that the
+   scaling is exact, and an affine quantization centers the range of the data on zero.
+
+   The quantizer does not convert element by element through the constructor of the Target.
+   A Target of at most 16 bits has at most 65536 values, and the quantizer builds a table of
+   them once per type: the finite values in increasing order, and for each value the smallest
+   double that the Target rounds to it. The doubles are compared as integers, by a key that
+   maps the order of the doubles onto the order of the unsigned integers, and the conversion
+   of an element is a branchless binary search of its key in the boundaries of the table.
+   The boundaries are found by bisection with the Target's own conversion, so the result is
+   the encoding that Target(x) produces, including the ties and the signed zeros; values that
+   are NaN or outside the finite range of the table are converted by the Target.
+
+   Stochastic rounding rounds x, that lies between the consecutive values v0 < x < v1, up to
+   v1 with probability (x - v0) / (v1 - v0), which makes the quantization unbiased. The random
+   number of element i is word i % 4 of block i / 4 of the Philox4x32-10 stream of the seed, so
+   the result does not depend on the chunking of the data: the index of the first element of a
+   chunk is passed in. A block is generated once for the four consecutive elements that use it.
+
+   The packed format stores the nbits-bit encodings contiguously, element i in the bits
+   [i * nbits, (i + 1) * nbits) of the buffer, least significant bit first: two 4-bit
+   encodings per byte.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+enum class QuantizationMode { symmetric, affine };
+enum class QuantizationRounding { nearest, stochastic };
+
+// x ~ offset + scale * double(q)
+struct quantization_scale {
+	double scale{ 1.0 };
+	double offset{ 0.0 };
+};
+
+/// <summary>
+/// scale and offset that map the range [minValue, maxValue] into [-targetMax, targetMax]
+/// </summary>
+/// <param name="targetMax">value of the Target that the largest magnitude maps to, 0 selects the maximum of the Target</param>
+template<typename Target>
+quantization_scale quantization_parameters(double minValue, double maxValue, QuantizationMode mode = QuantizationMode::symmetric, double targetMax = 0.0) {
+	quantization_scale q;
+	if (targetMax <= 0.0) targetMax = double(std::numeric_limits<Target>::max());
+	if (mode == QuantizationMode::affine) {
+		q.offset = (minValue + maxValue) / 2.0;
+		double halfRange = (maxValue - minValue) / 2.0;
+		if (halfRange > 0.0) q.scale = halfRange / targetMax;
+		return q;
+	}
+	double amax = std::max(std::fabs(minValue), std::fabs(maxValue));
+	if (amax > 0.0) {
+		// smallest power of two scale with amax / scale <= targetMax
+		int e;
+		double m = std::frexp(amax / targetMax, &e);
+		q.scale = std::ldexp(1.0, (m == 0.5 ? e - 1 : e));
+	}
+	return q;
+}
+
+// quantization parameters of a data set in a single pass over the data
+template<typename Target, typename Vector>
+quantization_scale quantization_parameters(const Vector& data, QuantizationMode mode = QuantizationMode::symmetric, double targetMax = 0.0) {
+	double minValue = 0.0, maxValue = 0.0;
+	bool first = true;
+	for (const auto& e : data) {
+		double v = double(e);
+		if (!std::isfinite(v)) continue;
+		if (first) { minValue = maxValue = v; first = false; }
+		else if (v < minValue) minValue = v;
+		else if (v > maxValue) maxValue = v;
+	}
+	return quantization_parameters<Target>(minValue, maxValue, mode, targetMax);
+}
+
+// quantization parameters from the statistics of a data set
+template<typename Target, typename Scalar, typename Accumulator>
+quantization_scale quantization_parameters(const streaming_statistics<Scalar, Accumulator>& stats, QuantizationMode mode = QuantizationMode::symmetric, double targetMax = 0.0) {
+	if (stats.count() == 0) return quantization_scale{};
+	return quantization_parameters<Target>(double(stats.min()), double(stats.max()), mode, targetMax);
+}
+
+namespace quantization_detail {
+
+	// order preserving map of the doubles onto the unsigned integers, -0 is the key right below +0
+	inline uint64_t key(double x) noexcept {
+		uint64_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		return (bits >> 63) ? ~bits : (bits | 0x8000'0000'0000'0000ull);
+	}
+	inline double from_key(uint64_t k) noexcept {
+		uint64_t bits = (k >> 63) ? (k & 0x7FFF'FFFF'FFFF'FFFFull) : ~k;
+		double x;
+		std::memcpy(&x, &bits, sizeof(x));
+		return x;
+	}
+
+	// index of the last element of a[0, n) that is <= k, with a[0] <= k
+	inline size_t search(const uint64_t* a, size_t n, uint64_t k) noexcept {
+		const uint64_t* base = a;
+		while (n > 1) {
+			size_t half = n / 2;
+			base = (base[half] <= k) ? base + half : base;
+			n -= half;
+		}
+		return size_t(base - a);
+	}
+
+	/// <summary>
+	/// the finite values of the Target in increasing order, with their encodings and rounding boundaries
+	/// </summary>
+	template<typename Target>
+	struct table {
+		std::vector<uint64_t> keys;        // keys of the values
+		std::vector<double>   values;
+		std::vector<Target>   targets;
+		std::vector<uint32_t> encodings;
+		std::vector<uint64_t> boundaries;  // smallest key that rounds to values[i], boundaries[0] = keys[0]
+		std::vector<double>   decode;      // value of each encoding, NaN for the encodings that are not finite
+
+		table() {
+			constexpr uint32_t NR_ENCODINGS = uint32_t(1) << Target::nbits;
+			decode.assign(NR_ENCODINGS, std::numeric_limits<double>::quiet_NaN());
+			std::vector< std::pair<uint64_t, uint32_t> > entries;
+			for (uint32_t e = 0; e < NR_ENCODINGS; ++e) {
+				Target t;
+				t.setbits(e);
+				double v = double(t);
+				if (!std::isfinite(v)) continue;
+				decode[e] = v;
+				entries.emplace_back(key(v), e);
+			}
+			std::sort(entries.begin(), entries.end());
+			for (const auto& entry : entries) {
+				if (!keys.empty() && keys.back() == entry.first) continue;  // the first of the encodings of a value
+				Target t;
+				t.setbits(entry.second);
+				keys.push_back(entry.first);
+				values.push_back(from_key(entry.first));
+				targets.push_back(t);
+				encodings.push_back(entry.second);
+			}
+			// the boundary between values i-1 and i by bisection with the conversion of the Target.
+			// The bisection halves the values, and only halves the keys when the values do not
+			// progress, so that it stays near the boundary and away from the tiny doubles.
+			boundaries.resize(keys.size());
+			boundaries[0] = keys[0];
+			for (size_t i = 1; i < keys.size(); ++i) {
+				uint64_t lo = keys[i - 1], hi = keys[i];
+				while (hi - lo > 1) {
+					double a = from_key(lo), b = from_key(hi);
+					uint64_t mid = key(a + (b - a) / 2.0);
+					if (mid <= lo || mid >= hi) mid = lo + (hi - lo) / 2;
+					if (key(double(Target(from_key(mid)))) >= keys[i]) hi = mid; else lo = mid;
+				}
+				boundaries[i] = hi;
+			}
+		}
+	};
+
+	template<typename Target>
+	const table<Target>& lookup() {
+		static const table<Target> t;
+		return t;
+	}
+
+	// word i of a Philox stream for increasing i: a block is generated once for its four words
+	class random_words {
+	public:
+		explicit random_words(const philox4x32& rng) noexcept : _rng{ rng } {}
+		uint32_t operator()(uint64_t i) noexcept {
+			uint64_t b = i >> 2;
+			if (!_valid || b != _block) {
+				_words = _rng(b);
+				_block = b;
+				_valid = true;
+			}
+			return _words[i & 3];
+		}
+	private:
+		const philox4x32&         _rng;
+		philox4x32::counter_type  _words{};
+		uint64_t                  _block{ 0 };
+		bool                      _valid{ false };
+	};
+
+} // namespace quantization_detail
+
+/// <summary>
+/// bulk quantizer of double data to a Target number system of 2 to 16 bits
+/// </summary>
+template<typename Target>
+class quantizer {
+public:
+	static_assert(Target::nbits >= 2 && Target::nbits <= 16, "quantizer: Target must have 2 to 16 bits");
+	static constexpr unsigned nbits = Target::nbits;
+
+	explicit quantizer(quantization_scale q = {}, QuantizationRounding rounding = QuantizationRounding::nearest, uint64_t seed = 0)
+		: _q{ q }, _rounding{ rounding }, _rng{ seed }, _t{ quantization_detail::lookup<Target>() } {}
+
+	const quantization_scale& parameters() const noexcept { return _q; }
+	QuantizationRounding rounding() const noexcept { return _rounding; }
+
+	// quantize x[0, n) into q[0, n), element i is element first + i of the random stream
+	void quantize(const double* x, size_t n, Target* q, uint64_t first = 0) const {
+		quantization_detail::random_words words(_rng);
+		for (size_t i = 0; i < n; ++i) {
+			size_t r = rank(x[i], words, first + i);
+			q[i] = (r == npos ? Target((x[i] - _q.offset) / _q.scale) : _t.targets[r]);
+		}
+	}
+	// quantize x[0, n) into the packed encodings, the buffer holds packed_size(n) bytes
+	void quantize_packed(const double* x, size_t n, uint8_t* packed, uint64_t first = 0) const {
+		quantization_detail::random_words words(_rng);
+		uint64_t buffer = 0;
+		unsigned bits = 0;
+		for (size_t i = 0; i < n; ++i) {
+			size_t r = rank(x[i], words, first + i);
+			uint64_t e = (r == npos ? encoding(Target((x[i] - _q.offset) / _q.scale)) : _t.encodings[r]);
+			buffer |= e << bits;
+			bits += nbits;
+			while (bits >= 8) {
+				*packed++ = uint8_t(buffer);
+				buffer >>= 8;
+				bits -= 8;
+			}
+		}
+		if (bits > 0) *packed = uint8_t(buffer);
+	}
+
+	// x[i] = offset + scale * double(q[i])
+	void dequantize(const Target* q, size_t n, double* x) const {
+		for (size_t i = 0; i < n; ++i) x[i] = _q.offset + _q.scale * double(q[i]);
+	}
+	void dequantize_packed(const uint8_t* packed, size_t n, double* x) const {
+		constexpr uint64_t mask = (uint64_t(1) << nbits) - 1;
+		uint64_t buffer = 0;
+		unsigned bits = 0;
+		for (size_t i = 0; i < n; ++i) {
+			while (bits < nbits) {
+				buffer |= uint64_t(*packed++) << bits;
+				bits += 8;
+			}
+			uint32_t e = uint32_t(buffer & mask);
+			buffer >>= nbits;
+			bits -= nbits;
+			double v = _t.decode[e];
+			if (std::isnan(v)) {  // an encoding that is not finite
+				Target t;
+				t.setbits(e);
+				v = double(t);
+			}
+			x[i] = _q.offset + _q.scale * v;
+		}
+	}
+
+	static constexpr size_t packed_size(size_t n) noexcept { return (n * nbits + 7) / 8; }
+
+private:
+	static constexpr size_t npos = size_t(-1);
+	quantization_scale _q;
+	QuantizationRounding _rounding;
+	philox4x32 _rng;
+	const quantization_detail::table<Target>& _t;
+
+	// rank of the quantized value in the table, npos when the Target converts the element
+	size_t rank(double x, quantization_detail::random_words& words, uint64_t index) const noexcept {
+		double y = (x - _q.offset) / _q.scale;
+		uint64_t k = quantization_detail::key(y);
+		if (std::isnan(y) || k < _t.keys.front() || k > _t.keys.back()) return npos;
+		const size_t n = _t.keys.size();
+		if (_rounding == QuantizationRounding::nearest) {
+			return quantization_detail::search(_t.boundaries.data(), n, k);
+		}
+		size_t r = quantization_detail::search(_t.keys.data(), n, k);
+		if (_t.keys[r] == k || r + 1 == n) return r;
+		double probability = (y - _t.values[r]) / (_t.values[r + 1] - _t.values[r]);
+		return (double(words(index)) < probability * 4294967296.0) ? r + 1 : r;
+	}
+
+	// encoding of a value that the Target converted
+	uint64_t encoding(const Target& t) const {
+		double v = double(t);
+		if (std::isfinite(v)) return _t.encodings[quantization_detail::search(_t.keys.data(), _t.keys.size(), quantization_detail::key(v))];
+		for (uint32_t e = 0; e < _t.decode.size(); ++e) {
+			Target c;
+			c.setbits(e);
+			if (c == t || (std::isnan(double(c)) && std::isnan(double(t)))) return e;
+		}
+		return 0;
+	}
+};
+
+// quantize a vector of doubles to the nbits-bit encodings of the Target, packed in bytes
+template<typename Target>
+std::vector<uint8_t> quantize_packed(const vector<double>& v, const quantization_scale& q, QuantizationRounding rounding = QuantizationRounding::nearest, uint64_t seed = 0) {
+	std::vector<uint8_t> packed(quantizer<Target>::packed_size(size(v)));
+	if (size(v) > 0) quantizer<Target>(q, rounding, seed).quantize_packed(&*v.begin(), size(v), packed.data());
+	return packed;
+}
+
+// quantize a vector of doubles to the Target
+template<typename Target>
+vector<Target> quantize(const vector<double>& v, const quantization_scale& q, QuantizationRounding rounding = QuantizationRounding::nearest, uint64_t seed = 0) {
+	vector<Target> t(size(v));
+	if (size(v) > 0) quantizer<Target>(q, rounding, seed).quantize(&*v.begin(), size(v), &*t.begin());
+	return t;
+}
+
+// the doubles that a vector of quantized values represents
+template<typename Target>
+vector<double> dequantize(const vector<Target>& t, const quantization_scale& q) {
+	vector<double> v(size(t));
+	if (size(t) > 0) quantizer<Target>(q).dequantize(&*t.begin(), size(t), &*v.begin());
+	return v;
+}
+
+}}} // namespace sw::universal::blas
@@ -0,0 +1,298 @@
+#pragma once
+// reduction.hpp: summation policies of the BLAS reductions
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <universal/numerics/twosum.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/quire/kulisch.hpp>
+
+/*
+   The reductions of the BLAS library, dot, asum, nrm2, sum, and sumOfElements, take a
+   reduction policy as their first template argument:
+
+       naive_reduction       recursive summation with a single accumulator, in element order
+       unrolled_reduction    recursive summation with four interleaved accumulators
+       pairwise_reduction    recursive summation of blocks, and a binary tree of the block sums:
+                             the error bound grows with log2(N) instead of N
+       neumaier_reduction    compensated summation: the rounding error of every addition is
+                             recovered with twoSum and accumulated separately (Kahan-Babuska-Neumaier)
+       dot2_reduction        compensated summation of products whose rounding errors are
+                             recovered with twoProd: the result is as accurate as if it was
+                             computed in twice the working precision, and rounded (Ogita, Rump, Oishi)
+       quire_reduction       exact accumulation in a posit quire or a Kulisch quire, and a single
+                             rounding; number systems without a quire use dot2_reduction
+       default_reduction     recursive summation, or the quire for the number systems with a
+                             Kulisch quire when BLAS_FUSED_DOT_PRODUCT is set to 1 (opt-in)
+
+   The default and naive policies round exactly as a loop of s += x[i] * y[i] does. The
+   unrolled and compensated kernels keep four independent accumulators, so the additions of
+   consecutive elements do not wait on each other, and the compensated kernels stay within a
+   small factor of recursive summation. The lanes are combined with the same policy at the end.
+
+   twoProduct is an error free transformation for the IEEE-754 types, and for the number
+   systems with a quire, which compute the error of the product in the quire. For the other
+   number systems it uses Dekker's product, which is error free only for a fixed precision
+   and round-to-nearest: for the tapered types without a quire the error term is approximate.
+
+   A policy reduces a sequence that is described by its length and an accessor:
+
+       Policy::template sum<Scalar>(n, term)        sum of term(i) for i in [0, n)
+       Policy::template dot<Scalar>(n, x, y)        sum of x(i) * y(i) for i in [0, n)
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+namespace reduction_detail {
+
+	constexpr size_t lanes = 4;
+	constexpr size_t pairwiseBlock = 128;
+
+	// hardware fma: without it std::fma is a slow library call, and Dekker's product is faster
+#if defined(FP_FAST_FMA) && defined(FP_FAST_FMAF)
+	constexpr bool fastFma = true;
+#else
+	constexpr bool fastFma = false;
+#endif
+
+	// error free transformation of a product: a * b = p + e
+	template<typename Scalar>
+	void twoProduct(const Scalar& a, const Scalar& b, Scalar& p, Scalar& e) {
+		if constexpr (fastFma && std::is_floating_point_v<Scalar>) {
+			p = a * b;
+			e = std::fma(a, b, -p);
+		}
+		else if constexpr (std::is_same_v<Scalar, float>) {
+			// the product of two floats is exact in double
+			double exact = double(a) * double(b);
+			p = float(exact);
+			e = float(exact - double(p));
+		}
+		else if constexpr (is_posit<Scalar>) {
+			// the product is exact in the quire, and so is its difference with the rounded product
+			quire<Scalar::nbits, Scalar::es, 2> q;
+			q += quire_mul(a, b);
+			convert(q.to_value(), p);
+			q -= p;
+			convert(q.to_value(), e);
+		}
+		else if constexpr (is_kulisch_enabled<Scalar>) {
+			if constexpr (quire_traits<Scalar>::exact) {
+				kulisch_quire<Scalar> q;
+				q += quire_mul(a, b);
+				p = q.to_value();
+				q -= p;
+				e = q.to_value();
+			}
+			else {
+				p = a * b;
+				e = Scalar(0);  // lns: the product is a sum of logarithms, and is exact
+			}
+		}
+		else {
+			p = a * b;
+			// Dekker's product with Veltkamp's splitting of the operands into halves
+			constexpr int halfDigits = (std::numeric_limits<Scalar>::digits + 1) / 2;
+			const Scalar splitter = Scalar(static_cast<double>((uint64_t(1) << halfDigits) + 1));
+			Scalar ca = splitter * a, cb = splitter * b;
+			Scalar ahi = ca - (ca - a), bhi = cb - (cb - b);
+			Scalar alo = a - ahi, blo = b - bhi;
+			e = ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo;
+		}
+	}
+
+	template<typename Scalar, typename Term>
+	Scalar naive_sum(size_t n, const Term& term) {
+		Scalar s(0);
+		for (size_t i = 0; i < n; ++i) s += term(i);
+		return s;
+	}
+
+	template<typename Scalar, typename Term>
+	Scalar unrolled_sum(size_t n, const Term& term) {
+		Scalar s0(0), s1(0), s2(0), s3(0);
+		size_t i = 0;
+		for (; i + lanes <= n; i += lanes) {
+			s0 += term(i);
+			s1 += term(i + 1);
+			s2 += term(i + 2);
+			s3 += term(i + 3);
+		}
+		for (; i < n; ++i) s0 += term(i);
+		return (s0 + s1) + (s2 + s3);
+	}
+
+	template<typename Scalar, typename Term>
+	Scalar pairwise_sum(size_t first, size_t n, const Term& term) {
+		if (n <= pairwiseBlock) return unrolled_sum<Scalar>(n, [&](size_t i) { return term(first + i); });
+		size_t half = ((n / 2 + pairwiseBlock - 1) / pairwiseBlock) * pairwiseBlock;  // split at a block boundary
+		return pairwise_sum<Scalar>(first, half, term) + pairwise_sum<Scalar>(first + half, n - half, term);
+	}
+
+	// sum of the lanes s[] with compensations c[]
+	template<typename Scalar>
+	Scalar combine(const Scalar* s, const Scalar* c) {
+		Scalar sum(s[0]), compensation(c[0]), t, e;
+		for (size_t l = 1; l < lanes; ++l) {
+			twoSum(sum, s[l], t, e);
+			sum = t;
+			compensation += e + c[l];
+		}
+		return sum + compensation;
+	}
+
+	template<typename Scalar, typename Term>
+	Scalar neumaier_sum(size_t n, const Term& term) {
+		Scalar s[lanes] = { Scalar(0), Scalar(0), Scalar(0), Scalar(0) };
+		Scalar c[lanes] = { Scalar(0), Scalar(0), Scalar(0), Scalar(0) };
+		Scalar t, e;
+		size_t i = 0;
+		for (; i + lanes <= n; i += lanes) {
+			for (size_t l = 0; l < lanes; ++l) {
+				twoSum(s[l], Scalar(term(i + l)), t, e);
+				s[l] = t;
+				c[l] += e;
+			}
+		}
+		for (; i < n; ++i) {
+			twoSum(s[0], Scalar(term(i)), t, e);
+			s[0] = t;
+			c[0] += e;
+		}
+		return combine(s, c);
+	}
+
+	template<typename Scalar, typename X, typename Y>
+	Scalar dot2(size_t n, const X& x, const Y& y) {
+		Scalar s[lanes] = { Scalar(0), Scalar(0), Scalar(0), Scalar(0) };
+		Scalar c[lanes] = { Scalar(0), Scalar(0), Scalar(0), Scalar(0) };
+		Scalar p, pe, t, se;
+		size_t i = 0;
+		for (; i + lanes <= n; i += lanes) {
+			for (size_t l = 0; l < lanes; ++l) {
+				twoProduct(Scalar(x(i + l)), Scalar(y(i + l)), p, pe);
+				twoSum(s[l], p, t, se);
+				s[l] = t;
+				c[l] += se + pe;
+			}
+		}
+		for (; i < n; ++i) {
+			twoProduct(Scalar(x(i)), Scalar(y(i)), p, pe);
+			twoSum(s[0], p, t, se);
+			s[0] = t;
+			c[0] += se + pe;
+		}
+		return combine(s, c);
+	}
+
+	template<typename Scalar, typename X, typename Y>
+	Scalar quire_dot(size_t n, const X& x, const Y& y) {
+		if constexpr (is_posit<Scalar>) {
+			constexpr unsigned capacity = 20; // FDP for vectors < 1,048,576 elements
+			quire<Scalar::nbits, Scalar::es, capacity> q;
+			for (size_t i = 0; i < n; ++i) q += quire_mul(Scalar(x(i)), Scalar(y(i)));
+			Scalar result;
+			convert(q.to_value(), result);  // one and only rounding step of the fused-dot product
+			return result;
+		}
+		else if constexpr (is_kulisch_enabled<Scalar>) {
+			kulisch_quire<Scalar> q;
+			for (size_t i = 0; i < n; ++i) q += quire_mul(Scalar(x(i)), Scalar(y(i)));
+			return q.to_value();
+		}
+		else {
+			return dot2<Scalar>(n, x, y);
+		}
+	}
+
+	template<typename Scalar, typename Term>
+	Scalar quire_sum(size_t n, const Term& term) {
+		if constexpr (is_posit<Scalar>) {
+			constexpr unsigned capacity = 20;
+			quire<Scalar::nbits, Scalar::es, capacity> q;
+			for (size_t i = 0; i < n; ++i) q += Scalar(term(i));
+			Scalar result;
+			convert(q.to_value(), result);
+			return result;
+		}
+		else if constexpr (is_kulisch_enabled<Scalar>) {
+			kulisch_quire<Scalar> q;
+			for (size_t i = 0; i < n; ++i) q += Scalar(term(i));
+			return q.to_value();
+		}
+		else {
+			return neumaier_sum<Scalar>(n, term);
+		}
+	}
+
+} // namespace reduction_detail
+
+struct naive_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::naive_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) {
+		return reduction_detail::naive_sum<Scalar>(n, [&](size_t i) { return Scalar(x(i) * y(i)); });
+	}
+};
+
+struct unrolled_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::unrolled_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) {
+		return reduction_detail::unrolled_sum<Scalar>(n, [&](size_t i) { return Scalar(x(i) * y(i)); });
+	}
+};
+
+struct pairwise_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::pairwise_sum<Scalar>(0, n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) {
+		return reduction_detail::pairwise_sum<Scalar>(0, n, [&](size_t i) { return Scalar(x(i) * y(i)); });
+	}
+};
+
+struct neumaier_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::neumaier_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) {
+		return reduction_detail::neumaier_sum<Scalar>(n, [&](size_t i) { return Scalar(x(i) * y(i)); });
+	}
+};
+
+struct dot2_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::neumaier_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) { return reduction_detail::dot2<Scalar>(n, x, y); }
+};
+
+struct quire_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::quire_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) { return reduction_detail::quire_dot<Scalar>(n, x, y); }
+};
+
+struct default_reduction {
+	template<typename Scalar, typename Term>
+	static Scalar sum(size_t n, const Term& term) { return reduction_detail::naive_sum<Scalar>(n, term); }
+	template<typename Scalar, typename X, typename Y>
+	static Scalar dot(size_t n, const X& x, const Y& y) {
+		if constexpr (BLAS_FUSED_DOT_PRODUCT && is_kulisch_enabled<Scalar>) {
+			return reduction_detail::quire_dot<Scalar>(n, x, y);
+		}
+		else {
+			return naive_reduction::dot<Scalar>(n, x, y);
+		}
+	}
+};
+
+}}} // namespace sw::universal::blas
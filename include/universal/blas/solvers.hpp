@@ -12,6 +12,7 @@
 #include <universal/blas/solvers/jacobi.hpp>
 #include <universal/blas/solvers/gauss_seidel.hpp>
 #include <universal/blas/solvers/sor.hpp>
+#include <universal/blas/solvers/stencil.hpp>
 #include <universal/blas/solvers/find_rank.hpp>
 #include <universal/blas/solvers/svd.hpp>
 
@@ -19,3 +20,6 @@
 #include <universal/blas/solvers/cg_dot_fdp.hpp>
 #include <universal/blas/solvers/cg_fdp_dot.hpp>
 #include <universal/blas/solvers/cg_fdp_fdp.hpp>
+
+// mixed-precision iterative refinement
+#include <universal/blas/solvers/ir.hpp>
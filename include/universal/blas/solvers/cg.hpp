@@ -45,13 +45,13 @@ size_t cg(const Matrix& M, const Matrix& A, const Vector& b, Vector& x, Vector&
 		}
 		else {
 			beta = sigma_1 / sigma_2;
-			p = zeta + beta * p;
+			p = zeta + beta * lazy(p);
 		}
 		q = A * p;
 		alpha = sigma_1 / (p * q); // adaptive dot product
 		Vector x_1(x);
-		x = x + alpha * p;
-		rho = rho - alpha * q;
+		x = x + alpha * lazy(p);
+		rho = rho - alpha * lazy(q);
 		// check for convergence of the system
 		residual = norm(x_1 - x, 1);
 		residuals.push_back(residual);
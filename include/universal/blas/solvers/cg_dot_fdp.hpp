@@ -45,13 +45,13 @@ size_t cg_dot_fdp(const Matrix& M, const Matrix& A, const Vector& b, Vector& x,
 		}
 		else {
 			beta = sigma_1 / sigma_2;
-			p = zeta + beta * p;
+			p = zeta + beta * lazy(p);
 		}
 		matvec(q, A, p);  // regular matrix-vector without quire
 		alpha = sigma_1 / sw::universal::fdp(p, q);
 		Vector x_1(x);
-		x = x + alpha * p;
-		rho = rho - alpha * q;
+		x = x + alpha * lazy(p);
+		rho = rho - alpha * lazy(q);
 		// check for convergence of the system
 		residual = norm1(x_1 - x);
 		//		std::cout << '[' << itr << "] " << std::setw(12) << x << " residual " << residual << std::endl;
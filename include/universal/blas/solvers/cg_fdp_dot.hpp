@@ -45,13 +45,13 @@ size_t cg_fdp_dot(const Matrix& M, const Matrix& A, const Vector& b, Vector& x,
 		}
 		else {
 			beta = sigma_1 / sigma_2;
-			p = zeta + beta * p;
+			p = zeta + beta * lazy(p);
 		}
 		q = A * p;  // adaptive matvec: native types use a direct FMA matvec, with posits use a FDP matvec, 
 		alpha = sigma_1 / dot(p, q);
 		Vector x_1(x);
-		x = x + alpha * p;
-		rho = rho - alpha * q;
+		x = x + alpha * lazy(p);
+		rho = rho - alpha * lazy(q);
 		// check for convergence of the system
 		residual = norm(x_1 - x, 1);
 		//		std::cout << '[' << itr << "] " << std::setw(12) << x << " residual " << residual << std::endl;
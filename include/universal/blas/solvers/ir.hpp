@@ -0,0 +1,364 @@
+#pragma once
+// ir.hpp: mixed-precision iterative refinement with LU and GMRES correction solvers
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/squeeze.hpp>
+
+/*
+   solve_ir<Low, Working, Residual>(A, b) is the three-precision iterative refinement of
+   Carson and Higham:
+
+       factor        squeeze A into the dynamic range of Low, and factor it: P A = L U in Low
+       initial       x = U \ (L \ P b), with the factors applied in Working
+       refine        r = b - A x          in Residual, rounded once per element
+                     solve A c = r        with the low precision factors
+                     x = x + c            in Working
+
+   The refinement has converged when the normwise backward error is at most the tolerance of
+   the configuration, N u by default, with u the unit roundoff of Working: the backward error
+   of a backward stable solver is a modest multiple of u, not u itself.
+
+   The O(N^3) factorization runs in the low precision type, the refinement steps are O(N^2).
+   The residual is a fused dot product for posits and the number systems with a Kulisch
+   quire, so with Residual = Working the residual is as accurate as Working allows.
+
+   The LU correction solve converges when the condition number of A is below the inverse
+   of the unit roundoff of Low. GMRES-IR solves the correction equation with GMRES on the
+   system that is left-preconditioned by the low precision factors, which converges for
+   condition numbers up to the inverse of the unit roundoff of Working.
+
+   The squeeze methods of squeeze.hpp (Higham, Pranesh, and Zounon) map A into the dynamic
+   range of Low before it is rounded: the factors are those of mu R A S, and every
+   correction solve undoes the scaling, so the refinement solves the unscaled system.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+// solver of the correction equation A c = r
+enum class RefinementSolver {
+	LU,      // c = U \ (L \ P r)
+	GMRES    // GMRES on the system left-preconditioned by the LU factors
+};
+
+// map of the matrix into the dynamic range of the low precision type
+enum class SqueezeMethod {
+	Round,               // round to Low
+	RoundReplace,        // round to Low and replace overflows by maxpos
+	ScaleRound,          // scale the largest element to theta and round
+	TwoSidedScaleRound   // equilibrate rows and columns, scale the largest element to theta, and round
+};
+
+struct ir_configuration {
+	RefinementSolver solver{ RefinementSolver::LU };
+	SqueezeMethod    squeeze{ SqueezeMethod::RoundReplace };
+	double           theta{ 0.4 };           // largest element of the scaled matrix
+	unsigned         maxIterations{ 20 };    // refinement steps
+	double           tolerance{ 0.0 };       // backward error of a converged solution, 0 selects N times the unit roundoff of Working
+	unsigned         krylovDimension{ 0 };   // GMRES iterations of a correction solve, 0 selects N
+	double           krylovTolerance{ 0.0 }; // relative residual of a correction solve, 0 selects the unit roundoff of Working
+	unsigned         blockSize{ 64 };        // panel width of the low precision factorization
+	unsigned         nrThreads{ 1 };         // threads of the low precision factorization, 0 selects the hardware concurrency
+};
+
+struct ir_report {
+	int      status{ 0 };             // 0 converged, 1 shape mismatch, 2 singular, 3 no convergence, 4 divergence
+	unsigned iterations{ 0 };         // refinement steps
+	unsigned krylovIterations{ 0 };   // GMRES iterations of all correction solves
+	double   backwardError{ 0.0 };    // normwise backward error ||b - Ax|| / (||A|| ||x|| + ||b||) of the solution
+};
+
+/// <summary>
+/// LU factors of a matrix that is squeezed into, and factored in, the low precision type.
+/// The factors are stored in Working, so that the triangular solves run in Working.
+/// </summary>
+template<typename Low, typename Working>
+class squeezed_lu {
+public:
+	/// <summary>
+	/// squeeze A into the dynamic range of Low and factor it in Low
+	/// </summary>
+	/// <returns>0 on success, 1 if the matrix is not square, 2 if the matrix is singular</returns>
+	int factor(const matrix<Working>& A, SqueezeMethod squeeze, double theta, unsigned blockSize, unsigned nrThreads) {
+		unsigned n = static_cast<unsigned>(num_rows(A));
+		if (n != num_cols(A)) return 1;
+		_squeeze = squeeze;
+		matrix<Working> As(A);
+		matrix<Low> Al;
+		Working T(theta);
+		_mu = Working(1.0);
+		switch (squeeze) {
+		case SqueezeMethod::Round:
+			Al = As;
+			break;
+		case SqueezeMethod::RoundReplace:
+			roundReplace(As, Al, n);
+			break;
+		case SqueezeMethod::ScaleRound:
+			scaleRound(As, Al, T, _mu);
+			break;
+		case SqueezeMethod::TwoSidedScaleRound:
+			_R.resize(n);
+			_S.resize(n);
+			twosideScaleRound(As, Al, _R, _S, T, _mu, n, 24);
+			break;
+		}
+		int status = blocked_ludcmp(Al, _indx, blockSize, nrThreads);
+		_LU = Al;
+		return status;
+	}
+
+	/// <summary>
+	/// solve A c = r with the factors of the squeezed matrix: c = S (LU \ (mu R r))
+	/// </summary>
+	vector<Working> solve(const vector<Working>& r) const {
+		size_t N = size(r);
+		vector<Working> y(r);
+		if (_squeeze == SqueezeMethod::ScaleRound) {
+			for (size_t i = 0; i < N; ++i) y[i] = _mu * y[i];
+		}
+		else if (_squeeze == SqueezeMethod::TwoSidedScaleRound) {
+			for (size_t i = 0; i < N; ++i) y[i] = _mu * (_R[i] * y[i]);
+		}
+		y = lubksb(_LU, _indx, y);
+		if (_squeeze == SqueezeMethod::TwoSidedScaleRound) {
+			for (size_t j = 0; j < N; ++j) y[j] = _S[j] * y[j];
+		}
+		return y;
+	}
+
+private:
+	SqueezeMethod   _squeeze{ SqueezeMethod::Round };
+	matrix<Working> _LU;
+	vector<size_t>  _indx;
+	vector<Working> _R, _S;   // row and column equilibration
+	Working         _mu{ 1.0 };
+};
+
+// r = b - A x with every element rounded once for the number systems with a Kulisch quire
+template<typename Residual>
+vector<Residual> ir_residual(const matrix<Residual>& A, const vector<Residual>& x, const vector<Residual>& b) {
+	const size_t N = num_rows(A);
+	vector<Residual> r(N);
+#if BLAS_FUSED_DOT_PRODUCT
+	if constexpr (is_kulisch_enabled<Residual>) {
+		kulisch_quire<Residual> q;
+		for (size_t i = 0; i < N; ++i) {
+			q = b[i];
+			for (size_t j = 0; j < num_cols(A); ++j) q -= quire_mul(A(i, j), x[j]);
+			r[i] = q.to_value();
+		}
+		return r;
+	}
+#endif
+	for (size_t i = 0; i < N; ++i) {
+		Residual sum = b[i];
+		for (size_t j = 0; j < num_cols(A); ++j) sum -= A(i, j) * x[j];
+		r[i] = sum;
+	}
+	return r;
+}
+
+// r = b - A x with every element rounded once, posit specialized
+template<unsigned nbits, unsigned es, unsigned capacity = 10>
+vector< posit<nbits, es> > ir_residual(const matrix< posit<nbits, es> >& A, const vector< posit<nbits, es> >& x, const vector< posit<nbits, es> >& b) {
+	const size_t N = num_rows(A);
+	vector< posit<nbits, es> > r(N);
+	for (size_t i = 0; i < N; ++i) {
+		quire<nbits, es, capacity> q(b[i]);
+		for (size_t j = 0; j < num_cols(A); ++j) q -= quire_mul(A(i, j), x[j]);
+		convert(q.to_value(), r[i]);  // one and only rounding step of the fused-dot product
+	}
+	return r;
+}
+
+// infinity norm of a vector or of the rows of a matrix, in double precision: NaN propagates
+template<typename Scalar>
+double ir_infnorm(const vector<Scalar>& v) {
+	double norm = 0.0;
+	for (size_t i = 0; i < size(v); ++i) {
+		double e = std::fabs(double(v[i]));
+		if (!(e <= norm)) norm = e;
+	}
+	return norm;
+}
+template<typename Scalar>
+double ir_infnorm(const matrix<Scalar>& A) {
+	double norm = 0.0;
+	for (size_t i = 0; i < num_rows(A); ++i) {
+		double rowSum = 0.0;
+		for (size_t j = 0; j < num_cols(A); ++j) rowSum += std::fabs(double(A(i, j)));
+		if (!(rowSum <= norm)) norm = rowSum;
+	}
+	return norm;
+}
+
+/// <summary>
+/// GMRES on the left-preconditioned correction equation M^-1 A c = M^-1 r, starting at c = 0.
+/// The products with A are computed in Residual, everything else in Working.
+/// The Arnoldi basis is orthogonalized with modified Gram-Schmidt, and the least squares
+/// problem is kept in triangular form with Givens rotations.
+/// </summary>
+/// <returns>number of GMRES iterations</returns>
+template<typename Working, typename Residual, typename Preconditioner>
+unsigned ir_gmres(const matrix<Residual>& A, const Preconditioner& M, const vector<Working>& r, vector<Working>& c, unsigned maxIterations, double tolerance) {
+	using std::sqrt;
+	using std::abs;
+	const size_t N = size(r);
+	c.resize(N);
+	c = Working(0);
+
+	auto norm2 = [](const vector<Working>& v) {
+		Working sumOfSquares(0);
+		for (size_t i = 0; i < size(v); ++i) sumOfSquares += v[i] * v[i];
+		return Working(sqrt(sumOfSquares));
+	};
+	auto apply = [&](const vector<Working>& v) {  // M^-1 A v
+		vector<Residual> vh(v);
+		vector<Residual> Av = A * vh;
+		return M.solve(vector<Working>(Av));
+	};
+
+	vector<Working> z = M.solve(r);
+	Working beta = norm2(z);
+	if (beta == Working(0)) return 0;
+	const size_t m = std::min<size_t>(maxIterations, N);
+	std::vector< vector<Working> > V(m + 1);
+	matrix<Working> H(m + 1, m);
+	vector<Working> cs(m), sn(m), g(m + 1);
+	g = Working(0);
+	g[0] = beta;
+	V[0] = z;
+	V[0] *= Working(1) / beta;
+
+	size_t k = 0;
+	while (k < m) {
+		vector<Working> w = apply(V[k]);
+		for (size_t i = 0; i <= k; ++i) {
+			Working h(0);
+			for (size_t l = 0; l < N; ++l) h += w[l] * V[i][l];
+			H(i, k) = h;
+			for (size_t l = 0; l < N; ++l) w[l] -= h * V[i][l];
+		}
+		Working hnext = norm2(w);
+		H(k + 1, k) = hnext;
+		// apply the previous rotations to the new column, and annihilate H(k+1, k)
+		for (size_t i = 0; i < k; ++i) {
+			Working t = cs[i] * H(i, k) + sn[i] * H(i + 1, k);
+			H(i + 1, k) = -sn[i] * H(i, k) + cs[i] * H(i + 1, k);
+			H(i, k) = t;
+		}
+		Working denom = Working(sqrt(H(k, k) * H(k, k) + hnext * hnext));
+		if (denom == Working(0)) break;
+		cs[k] = H(k, k) / denom;
+		sn[k] = hnext / denom;
+		H(k, k) = denom;
+		H(k + 1, k) = Working(0);
+		g[k + 1] = -sn[k] * g[k];
+		g[k] = cs[k] * g[k];
+		++k;
+		if (double(abs(g[k])) <= tolerance * double(beta) || hnext == Working(0)) break;
+		V[k] = w;
+		V[k] *= Working(1) / hnext;
+	}
+
+	// c = V y, with H y = g
+	vector<Working> y(k);
+	for (size_t i = k; i >= 1; --i) {
+		Working sum = g[i - 1];
+		for (size_t j = i; j < k; ++j) sum -= H(i - 1, j) * y[j];
+		y[i - 1] = sum / H(i - 1, i - 1);
+	}
+	for (size_t j = 0; j < k; ++j) {
+		for (size_t l = 0; l < N; ++l) c[l] += y[j] * V[j][l];
+	}
+	return static_cast<unsigned>(k);
+}
+
+/// <summary>
+/// solve A x = b with a factorization in the low precision type, residuals in the residual type,
+/// and refinement of the solution to working precision.
+/// </summary>
+/// <typeparam name="Low">type of the LU factorization</typeparam>
+/// <typeparam name="Working">type of A, b, and the solution</typeparam>
+/// <typeparam name="Residual">type of the residual computation</typeparam>
+/// <param name="A">square matrix</param>
+/// <param name="b">right hand side</param>
+/// <param name="cfg">correction solver, squeeze method, and iteration limits</param>
+/// <param name="report">optional convergence report</param>
+/// <returns>the solution, or an empty vector if the matrix is not square or singular</returns>
+template<typename Low, typename Working, typename Residual = Working>
+vector<Working> solve_ir(const matrix<Working>& A, const vector<Working>& b, const ir_configuration& cfg = ir_configuration{}, ir_report* report = nullptr) {
+	ir_report info;
+	const size_t N = num_rows(A);
+	if (N != num_cols(A) || N != size(b)) {
+		std::cerr << "solve_ir: matrix shape (" << num_rows(A) << " x " << num_cols(A) << ") is not congruous with vector size (" << size(b) << ")\n";
+		info.status = 1;
+		if (report) *report = info;
+		return vector<Working>{};
+	}
+
+	squeezed_lu<Low, Working> M;
+	if (M.factor(A, cfg.squeeze, cfg.theta, cfg.blockSize, cfg.nrThreads) != 0) {
+		std::cerr << "solve_ir: low precision factorization failed\n";
+		info.status = 2;
+		if (report) *report = info;
+		return vector<Working>{};
+	}
+
+	const double u = double(std::numeric_limits<Working>::epsilon()) / 2.0;   // unit roundoff of Working
+	const double tolerance = (cfg.tolerance > 0.0 ? cfg.tolerance : double(N) * u);
+	const double krylovTolerance = (cfg.krylovTolerance > 0.0 ? cfg.krylovTolerance : u);
+	const unsigned krylovDimension = (cfg.krylovDimension > 0 ? cfg.krylovDimension : static_cast<unsigned>(N));
+	const matrix<Residual> Ah(A);
+	const vector<Residual> bh(b);
+	const double normA = ir_infnorm(Ah);
+	const double normb = ir_infnorm(bh);
+
+	vector<Working> x = M.solve(b);
+	vector<Working> c;
+	double previousCorrection = std::numeric_limits<double>::infinity();
+	info.status = 3;
+	for (;;) {
+		vector<Residual> r = ir_residual(Ah, vector<Residual>(x), bh);
+		double normx = ir_infnorm(x);
+		info.backwardError = ir_infnorm(r) / (normA * normx + normb);
+		if (!std::isfinite(info.backwardError)) { info.status = 4; break; }
+		if (info.backwardError <= tolerance) { info.status = 0; break; }
+		if (info.iterations == cfg.maxIterations) break;
+
+		vector<Working> rw(r);
+		if (cfg.solver == RefinementSolver::GMRES) {
+			info.krylovIterations += ir_gmres(Ah, M, rw, c, krylovDimension, krylovTolerance);
+		}
+		else {
+			c = M.solve(rw);
+		}
+		x += c;
+		++info.iterations;
+
+		// stop when the corrections no longer shrink: the solution is as good as the factors can make it,
+		// and it has converged only if its backward error is within the tolerance
+		double correction = ir_infnorm(c);
+		bool negligible = (correction <= u * normx);
+		bool stagnant = (correction > 0.5 * previousCorrection);
+		if (negligible || stagnant) {
+			r = ir_residual(Ah, vector<Residual>(x), bh);
+			info.backwardError = ir_infnorm(r) / (normA * ir_infnorm(x) + normb);
+			if (info.backwardError <= tolerance) info.status = 0;
+			else info.status = (!std::isfinite(info.backwardError) || (!negligible && correction > previousCorrection) ? 4 : 3);
+			break;
+		}
+		previousCorrection = correction;
+	}
+	if (report) *report = info;
+	return x;
+}
+
+}}} // namespace sw::universal::blas
@@ -0,0 +1,275 @@
+#pragma once
+// krylov.hpp: preconditioned Krylov solvers with reusable workspaces: PCG, BiCGSTAB, and GMRES(m)
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/solvers/krylov_operators.hpp>
+
+/*
+   pcg        preconditioned conjugate gradients, for symmetric positive definite A and M
+   bicgstab   right-preconditioned BiCGSTAB of van der Vorst, for nonsymmetric A
+   gmres      right-preconditioned restarted GMRES(m), with modified Gram-Schmidt and
+              Givens rotations, for nonsymmetric A
+
+   All three solve A x = b starting at the x that is passed in, and stop when the relative
+   residual ||b - A x|| / ||b|| drops below the tolerance of the configuration.
+
+   The iteration vectors live in a workspace that the caller owns. The workspace sizes
+   itself on the first solve and is reused by the next solves of the same size, so that a
+   sequence of solves, such as the time steps of a simulation, does not allocate: the
+   iterations update the workspace vectors in place and never create vector temporaries.
+
+   The dot products of the iteration go through the DotPolicy, a reduction policy of
+   reduction.hpp, which selects plain, fused (quire), or compensated accumulation. Norms
+   are the square root of the policy's dot product, and are reported in double.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+struct krylov_configuration {
+	size_t maxIterations{ 1000 };
+	double tolerance{ 1.0e-8 };    // on the relative residual ||b - A x|| / ||b||
+	size_t restart{ 30 };          // dimension of the Krylov subspace of GMRES(m)
+};
+
+struct krylov_report {
+	int    status{ 0 };            // 0 converged, 1 maximum number of iterations reached, 2 breakdown
+	size_t iterations{ 0 };        // matrix-vector products for pcg and gmres, iterations for bicgstab
+	double residual{ 0.0 };        // relative residual of the last iteration
+};
+
+template<typename Scalar>
+struct pcg_workspace {
+	vector<Scalar> r, z, p, q;
+	void resize(size_t N) {
+		if (size(r) == N) return;
+		r.resize(N); z.resize(N); p.resize(N); q.resize(N);
+	}
+};
+
+template<typename Scalar>
+struct bicgstab_workspace {
+	vector<Scalar> r, rhat, p, v, s, t, phat, shat;
+	void resize(size_t N) {
+		if (size(r) == N) return;
+		r.resize(N); rhat.resize(N); p.resize(N); v.resize(N);
+		s.resize(N); t.resize(N); phat.resize(N); shat.resize(N);
+	}
+};
+
+template<typename Scalar>
+struct gmres_workspace {
+	std::vector< vector<Scalar> > V;  // Krylov basis, m + 1 vectors
+	matrix<Scalar> H;                 // Hessenberg matrix, reduced to triangular by the rotations
+	vector<Scalar> cs, sn, g, y, w, z;
+	void resize(size_t N, size_t m) {
+		if (V.size() == m + 1 && size(w) == N) return;
+		V.assign(m + 1, vector<Scalar>(N));
+		H.resize(static_cast<unsigned>(m + 1), static_cast<unsigned>(m));
+		cs.resize(m); sn.resize(m); g.resize(m + 1); y.resize(m);
+		w.resize(N); z.resize(N);
+	}
+};
+
+// residual r = b - A x
+template<typename Operator, typename Vector>
+void krylov_residual(const Operator& A, const Vector& b, const Vector& x, Vector& r) {
+	A.apply(x, r);
+	for (size_t i = 0; i < size(b); ++i) r[i] = b[i] - r[i];
+}
+
+template<typename DotPolicy, typename Scalar>
+double krylov_norm(const vector<Scalar>& x) {
+	return std::sqrt(double(dot<DotPolicy>(x, x)));
+}
+
+/// <summary>
+/// preconditioned conjugate gradients
+/// </summary>
+/// <param name="A">symmetric positive definite operator</param>
+/// <param name="M">symmetric positive definite preconditioner</param>
+/// <param name="b">right hand side</param>
+/// <param name="x">initial guess on input, solution on output</param>
+/// <param name="ws">workspace, reused across calls</param>
+/// <returns>convergence report</returns>
+template<typename DotPolicy = plain_dot, typename Operator, typename Preconditioner, typename Scalar>
+krylov_report pcg(const Operator& A, const Preconditioner& M, const vector<Scalar>& b, vector<Scalar>& x, pcg_workspace<Scalar>& ws, const krylov_configuration& cfg = {}) {
+	krylov_report report;
+	const size_t N = A.size();
+	ws.resize(N);
+	auto& r = ws.r; auto& z = ws.z; auto& p = ws.p; auto& q = ws.q;
+
+	double normb = krylov_norm<DotPolicy>(b);
+	if (normb == 0.0) normb = 1.0;
+	krylov_residual(A, b, x, r);
+	report.residual = krylov_norm<DotPolicy>(r) / normb;
+	if (report.residual <= cfg.tolerance) return report;
+
+	M.apply(r, z);
+	for (size_t i = 0; i < N; ++i) p[i] = z[i];
+	Scalar rz = dot<DotPolicy>(r, z);
+	while (report.iterations < cfg.maxIterations) {
+		A.apply(p, q);
+		++report.iterations;
+		Scalar pq = dot<DotPolicy>(p, q);
+		if (pq == Scalar(0)) { report.status = 2; return report; }
+		Scalar alpha = rz / pq;
+		for (size_t i = 0; i < N; ++i) {
+			x[i] += alpha * p[i];
+			r[i] -= alpha * q[i];
+		}
+		report.residual = krylov_norm<DotPolicy>(r) / normb;
+		if (report.residual <= cfg.tolerance) return report;
+		M.apply(r, z);
+		Scalar rzNext = dot<DotPolicy>(r, z);
+		Scalar beta = rzNext / rz;
+		rz = rzNext;
+		for (size_t i = 0; i < N; ++i) p[i] = z[i] + beta * p[i];
+	}
+	report.status = 1;
+	return report;
+}
+
+/// <summary>
+/// right-preconditioned BiCGSTAB
+/// </summary>
+/// <param name="A">operator</param>
+/// <param name="M">preconditioner</param>
+/// <param name="b">right hand side</param>
+/// <param name="x">initial guess on input, solution on output</param>
+/// <param name="ws">workspace, reused across calls</param>
+/// <returns>convergence report</returns>
+template<typename DotPolicy = plain_dot, typename Operator, typename Preconditioner, typename Scalar>
+krylov_report bicgstab(const Operator& A, const Preconditioner& M, const vector<Scalar>& b, vector<Scalar>& x, bicgstab_workspace<Scalar>& ws, const krylov_configuration& cfg = {}) {
+	krylov_report report;
+	const size_t N = A.size();
+	ws.resize(N);
+	auto& r = ws.r; auto& rhat = ws.rhat; auto& p = ws.p; auto& v = ws.v;
+	auto& s = ws.s; auto& t = ws.t; auto& phat = ws.phat; auto& shat = ws.shat;
+
+	double normb = krylov_norm<DotPolicy>(b);
+	if (normb == 0.0) normb = 1.0;
+	krylov_residual(A, b, x, r);
+	report.residual = krylov_norm<DotPolicy>(r) / normb;
+	if (report.residual <= cfg.tolerance) return report;
+
+	for (size_t i = 0; i < N; ++i) { rhat[i] = r[i]; p[i] = Scalar(0); v[i] = Scalar(0); }
+	Scalar rho(1), alpha(1), omega(1);
+	while (report.iterations < cfg.maxIterations) {
+		++report.iterations;
+		Scalar rhoNext = dot<DotPolicy>(rhat, r);
+		if (rhoNext == Scalar(0) || omega == Scalar(0)) { report.status = 2; return report; }
+		Scalar beta = (rhoNext / rho) * (alpha / omega);
+		rho = rhoNext;
+		for (size_t i = 0; i < N; ++i) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+		M.apply(p, phat);
+		A.apply(phat, v);
+		Scalar rhatv = dot<DotPolicy>(rhat, v);
+		if (rhatv == Scalar(0)) { report.status = 2; return report; }
+		alpha = rho / rhatv;
+		for (size_t i = 0; i < N; ++i) s[i] = r[i] - alpha * v[i];
+		double norms = krylov_norm<DotPolicy>(s) / normb;
+		if (norms <= cfg.tolerance) {
+			for (size_t i = 0; i < N; ++i) x[i] += alpha * phat[i];
+			report.residual = norms;
+			return report;
+		}
+		M.apply(s, shat);
+		A.apply(shat, t);
+		Scalar tt = dot<DotPolicy>(t, t);
+		if (tt == Scalar(0)) { report.status = 2; return report; }
+		omega = dot<DotPolicy>(t, s) / tt;
+		for (size_t i = 0; i < N; ++i) {
+			x[i] += alpha * phat[i] + omega * shat[i];
+			r[i] = s[i] - omega * t[i];
+		}
+		report.residual = krylov_norm<DotPolicy>(r) / normb;
+		if (report.residual <= cfg.tolerance) return report;
+	}
+	report.status = 1;
+	return report;
+}
+
+/// <summary>
+/// right-preconditioned restarted GMRES(m): the residual of the original system is minimized
+/// over x0 + M^-1 K_m(A M^-1, r0)
+/// </summary>
+/// <param name="A">operator</param>
+/// <param name="M">preconditioner</param>
+/// <param name="b">right hand side</param>
+/// <param name="x">initial guess on input, solution on output</param>
+/// <param name="ws">workspace, reused across calls</param>
+/// <returns>convergence report</returns>
+template<typename DotPolicy = plain_dot, typename Operator, typename Preconditioner, typename Scalar>
+krylov_report gmres(const Operator& A, const Preconditioner& M, const vector<Scalar>& b, vector<Scalar>& x, gmres_workspace<Scalar>& ws, const krylov_configuration& cfg = {}) {
+	using std::sqrt;
+	using std::abs;
+	krylov_report report;
+	const size_t N = A.size();
+	const size_t m = (cfg.restart == 0 ? size_t(1) : cfg.restart);
+	ws.resize(N, m);
+	auto& V = ws.V; auto& H = ws.H; auto& cs = ws.cs; auto& sn = ws.sn;
+	auto& g = ws.g; auto& y = ws.y; auto& w = ws.w; auto& z = ws.z;
+
+	double normb = krylov_norm<DotPolicy>(b);
+	if (normb == 0.0) normb = 1.0;
+	while (true) {
+		krylov_residual(A, b, x, V[0]);
+		Scalar beta = sqrt(dot<DotPolicy>(V[0], V[0]));
+		report.residual = double(beta) / normb;
+		if (report.residual <= cfg.tolerance) return report;
+		if (report.iterations >= cfg.maxIterations) { report.status = 1; return report; }
+		for (size_t i = 0; i < N; ++i) V[0][i] /= beta;
+		for (size_t i = 0; i <= m; ++i) g[i] = Scalar(0);
+		g[0] = beta;
+
+		size_t k = 0;  // dimension of the Krylov subspace of this cycle
+		while (k < m && report.iterations < cfg.maxIterations) {
+			M.apply(V[k], z);
+			A.apply(z, w);
+			++report.iterations;
+			for (size_t j = 0; j <= k; ++j) {  // modified Gram-Schmidt
+				H(j, k) = dot<DotPolicy>(w, V[j]);
+				for (size_t i = 0; i < N; ++i) w[i] -= H(j, k) * V[j][i];
+			}
+			H(k + 1, k) = sqrt(dot<DotPolicy>(w, w));
+			bool lucky = (H(k + 1, k) == Scalar(0));
+			if (!lucky) for (size_t i = 0; i < N; ++i) V[k + 1][i] = w[i] / H(k + 1, k);
+			for (size_t j = 0; j < k; ++j) {   // apply the previous rotations to the new column
+				Scalar h = cs[j] * H(j, k) + sn[j] * H(j + 1, k);
+				H(j + 1, k) = -sn[j] * H(j, k) + cs[j] * H(j + 1, k);
+				H(j, k) = h;
+			}
+			Scalar rho = sqrt(H(k, k) * H(k, k) + H(k + 1, k) * H(k + 1, k));
+			if (rho == Scalar(0)) { report.status = 2; return report; }
+			cs[k] = H(k, k) / rho;
+			sn[k] = H(k + 1, k) / rho;
+			H(k, k) = rho;
+			H(k + 1, k) = Scalar(0);
+			g[k + 1] = -sn[k] * g[k];
+			g[k] = cs[k] * g[k];
+			++k;
+			report.residual = double(abs(g[k])) / normb;
+			if (lucky || report.residual <= cfg.tolerance) break;
+		}
+
+		// x = x + M^-1 V y, with H y = g
+		for (size_t ii = k; ii >= 1; --ii) {
+			size_t i = ii - 1;
+			Scalar sum = g[i];
+			for (size_t j = i + 1; j < k; ++j) sum -= H(i, j) * y[j];
+			y[i] = sum / H(i, i);
+		}
+		for (size_t i = 0; i < N; ++i) w[i] = Scalar(0);
+		for (size_t j = 0; j < k; ++j) {
+			for (size_t i = 0; i < N; ++i) w[i] += y[j] * V[j][i];
+		}
+		M.apply(w, z);
+		for (size_t i = 0; i < N; ++i) x[i] += z[i];
+	}
+}
+
+}}} // namespace sw::universal::blas
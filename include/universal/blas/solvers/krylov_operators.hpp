@@ -0,0 +1,274 @@
+#pragma once
+// krylov_operators.hpp: operators, preconditioners, and dot product policies of the Krylov solvers
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <universal/blas/blas.hpp>
+
+/*
+   The Krylov solvers only touch the system through two calls, so that dense, sparse,
+   and matrix-free systems share one implementation:
+
+       operator        size_t size() const;
+                       void apply(const vector<Scalar>& x, vector<Scalar>& y) const;    y = A x
+       preconditioner  void apply(const vector<Scalar>& r, vector<Scalar>& z) const;    z = M^-1 r
+
+   Both write into caller-owned vectors and do not allocate.
+
+   The dot product policy selects how the inner products of the iteration are accumulated:
+
+       plain_dot          sum of rounded products, naive_reduction
+       fused_dot          fused dot product in a quire, for posits and the number systems with
+                          a Kulisch quire, quire_reduction; the other types use dot2_reduction
+       compensated_dot    sum of rounded products with a compensated (twoSum) accumulation,
+                          neumaier_reduction
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+///////////////////////////////////////////////////////////////////////////////////
+// dot product policies are reduction policies of the blas library
+
+using plain_dot       = naive_reduction;
+using fused_dot       = quire_reduction;
+using compensated_dot = neumaier_reduction;
+
+///////////////////////////////////////////////////////////////////////////////////
+// operators
+
+/// <summary>
+/// dense matrix operator: y = A x with the matrix-vector product of the blas library
+/// </summary>
+template<typename Scalar>
+class dense_operator {
+public:
+	using value_type = Scalar;
+	explicit dense_operator(const matrix<Scalar>& A) : _A{ A } {}
+	size_t size() const noexcept { return num_rows(_A); }
+	void apply(const vector<Scalar>& x, vector<Scalar>& y) const { matvec(y, _A, x); }
+private:
+	const matrix<Scalar>& _A;
+};
+
+/// <summary>
+/// sparse matrix operator in compressed sparse row format, compressed from a dense matrix.
+/// The column indices of a row are sorted.
+/// </summary>
+template<typename Scalar>
+class sparse_operator {
+public:
+	using value_type = Scalar;
+	explicit sparse_operator(const matrix<Scalar>& A) : _n{ num_rows(A) }, _rowPtr(num_rows(A) + 1) {
+		_rowPtr[0] = 0;
+		for (size_t i = 0; i < _n; ++i) {
+			for (size_t j = 0; j < num_cols(A); ++j) {
+				if (A(i, j) != Scalar(0)) {
+					_colIdx.push_back(j);
+					_values.push_back(A(i, j));
+				}
+			}
+			_rowPtr[i + 1] = _colIdx.size();
+		}
+	}
+	size_t size() const noexcept { return _n; }
+	size_t nnz() const noexcept { return _values.size(); }
+	void apply(const vector<Scalar>& x, vector<Scalar>& y) const {
+		for (size_t i = 0; i < _n; ++i) {
+			Scalar sum(0);
+			for (size_t k = _rowPtr[i]; k < _rowPtr[i + 1]; ++k) sum += _values[k] * x[_colIdx[k]];
+			y[i] = sum;
+		}
+	}
+
+	const std::vector<size_t>& rowPtr() const noexcept { return _rowPtr; }
+	const std::vector<size_t>& colIdx() const noexcept { return _colIdx; }
+	const std::vector<Scalar>& values() const noexcept { return _values; }
+
+private:
+	size_t              _n;
+	std::vector<size_t> _rowPtr;
+	std::vector<size_t> _colIdx;
+	std::vector<Scalar> _values;
+};
+
+/// <summary>
+/// matrix-free operator: y = A x is computed by a callable f(x, y)
+/// </summary>
+template<typename Scalar, typename Function>
+class function_operator {
+public:
+	using value_type = Scalar;
+	function_operator(size_t n, Function f) : _n{ n }, _f{ std::move(f) } {}
+	size_t size() const noexcept { return _n; }
+	void apply(const vector<Scalar>& x, vector<Scalar>& y) const { _f(x, y); }
+private:
+	size_t   _n;
+	Function _f;
+};
+
+template<typename Scalar, typename Function>
+function_operator<Scalar, Function> make_operator(size_t n, Function f) {
+	return function_operator<Scalar, Function>(n, std::move(f));
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// preconditioners
+
+template<typename Scalar>
+class identity_preconditioner {
+public:
+	void apply(const vector<Scalar>& r, vector<Scalar>& z) const {
+		for (size_t i = 0; i < size(r); ++i) z[i] = r[i];
+	}
+};
+
+/// <summary>
+/// Jacobi preconditioner: M = diag(A). Zero diagonal elements are skipped, that is, replaced by 1.
+/// </summary>
+template<typename Scalar>
+class jacobi_preconditioner {
+public:
+	explicit jacobi_preconditioner(const matrix<Scalar>& A) : _invDiag(num_rows(A)) {
+		for (size_t i = 0; i < num_rows(A); ++i) _invDiag[i] = (A(i, i) == Scalar(0) ? Scalar(1) : Scalar(1) / A(i, i));
+	}
+	void apply(const vector<Scalar>& r, vector<Scalar>& z) const {
+		for (size_t i = 0; i < size(r); ++i) z[i] = _invDiag[i] * r[i];
+	}
+private:
+	vector<Scalar> _invDiag;
+};
+
+/// <summary>
+/// incomplete LU factorization with the sparsity pattern of A, ILU(0): L and U are stored
+/// in the compressed rows of A, L has a unit diagonal. A pivot that is zero relative to
+/// its row is shifted to the square root of the machine epsilon times the row norm.
+/// </summary>
+template<typename Scalar>
+class ilu0_preconditioner {
+public:
+	explicit ilu0_preconditioner(const matrix<Scalar>& A) : ilu0_preconditioner(sparse_operator<Scalar>(A)) {}
+	explicit ilu0_preconditioner(const sparse_operator<Scalar>& A)
+		: _n{ A.size() }, _rowPtr{ A.rowPtr() }, _colIdx{ A.colIdx() }, _values{ A.values() }, _diag(A.size()) {
+		using std::abs;
+		using std::sqrt;
+		std::vector<size_t> position(_n, npos);   // position of column j in the current row
+		for (size_t i = 0; i < _n; ++i) {
+			for (size_t k = _rowPtr[i]; k < _rowPtr[i + 1]; ++k) position[_colIdx[k]] = k;
+			for (size_t k = _rowPtr[i]; k < _rowPtr[i + 1] && _colIdx[k] < i; ++k) {
+				size_t p = _colIdx[k];
+				_values[k] /= _values[_diag[p]];
+				Scalar lik = _values[k];
+				for (size_t kk = _diag[p] + 1; kk < _rowPtr[p + 1]; ++kk) {
+					size_t j = position[_colIdx[kk]];
+					if (j != npos) _values[j] -= lik * _values[kk];
+				}
+			}
+			size_t d = position[i];
+			if (d == npos) {  // structurally zero diagonal: add it to the pattern
+				d = insert_diagonal(i);
+			}
+			Scalar rowNorm(0);
+			for (size_t k = _rowPtr[i]; k < _rowPtr[i + 1]; ++k) rowNorm += abs(_values[k]);
+			if (abs(_values[d]) <= std::numeric_limits<Scalar>::epsilon() * rowNorm) {
+				Scalar shift = sqrt(std::numeric_limits<Scalar>::epsilon()) * (rowNorm == Scalar(0) ? Scalar(1) : rowNorm);
+				_values[d] = (_values[d] < Scalar(0) ? -shift : shift);
+			}
+			_diag[i] = d;
+			for (size_t k = _rowPtr[i]; k < _rowPtr[i + 1]; ++k) position[_colIdx[k]] = npos;
+		}
+	}
+
+	void apply(const vector<Scalar>& r, vector<Scalar>& z) const {
+		for (size_t i = 0; i < _n; ++i) {   // L y = r
+			Scalar sum = r[i];
+			for (size_t k = _rowPtr[i]; k < _diag[i]; ++k) sum -= _values[k] * z[_colIdx[k]];
+			z[i] = sum;
+		}
+		for (size_t i = _n; i >= 1; --i) {  // U z = y
+			size_t row = i - 1;
+			Scalar sum = z[row];
+			for (size_t k = _diag[row] + 1; k < _rowPtr[row + 1]; ++k) sum -= _values[k] * z[_colIdx[k]];
+			z[row] = sum / _values[_diag[row]];
+		}
+	}
+
+private:
+	static constexpr size_t npos = size_t(-1);
+	size_t              _n;
+	std::vector<size_t> _rowPtr;
+	std::vector<size_t> _colIdx;
+	std::vector<Scalar> _values;
+	std::vector<size_t> _diag;
+
+	// insert a zero diagonal element in row i, which is the row being factored
+	size_t insert_diagonal(size_t i) {
+		size_t k = _rowPtr[i];
+		while (k < _rowPtr[i + 1] && _colIdx[k] < i) ++k;
+		_colIdx.insert(_colIdx.begin() + static_cast<std::ptrdiff_t>(k), i);
+		_values.insert(_values.begin() + static_cast<std::ptrdiff_t>(k), Scalar(0));
+		for (size_t r = i + 1; r <= _n; ++r) ++_rowPtr[r];
+		return k;
+	}
+};
+
+/// <summary>
+/// row permutation that moves nonzero elements onto the diagonal, the maximum transversal of
+/// Duff (MC21): row perm[j] of A becomes row j of P A. Every row is matched by a depth-first
+/// search for an augmenting path, which visits the larger elements of a row first.
+/// ILU(0) and Jacobi need a zero-free diagonal: the permuted system P A x = P b of a matrix
+/// with structurally zero diagonals, such as west0132, can be preconditioned.
+/// </summary>
+/// <returns>the row permutation, empty when A is structurally singular</returns>
+template<typename Scalar>
+std::vector<size_t> zero_free_diagonal(const matrix<Scalar>& A) {
+	using std::abs;
+	constexpr size_t unmatched = size_t(-1);
+	const size_t N = num_rows(A);
+	std::vector< std::vector<size_t> > columns(N);  // nonzero columns of each row, larger elements first
+	for (size_t i = 0; i < N; ++i) {
+		for (size_t j = 0; j < N; ++j) if (A(i, j) != Scalar(0)) columns[i].push_back(j);
+		std::stable_sort(columns[i].begin(), columns[i].end(), [&](size_t a, size_t b) { return abs(A(i, a)) > abs(A(i, b)); });
+	}
+	std::vector<size_t> perm(N, unmatched);   // row matched to column j
+	std::vector<size_t> matched(N, unmatched);  // column matched to row i
+	std::vector<size_t> visited(N, unmatched);
+	std::vector<size_t> stackRow, stackPos;
+	for (size_t root = 0; root < N; ++root) {
+		// iterative depth-first search for an augmenting path that starts at row root
+		stackRow.assign(1, root);
+		stackPos.assign(1, 0);
+		bool augmented = false;
+		while (!stackRow.empty() && !augmented) {
+			size_t i = stackRow.back();
+			size_t& pos = stackPos.back();
+			if (pos == columns[i].size()) { stackRow.pop_back(); stackPos.pop_back(); continue; }
+			size_t j = columns[i][pos++];
+			if (visited[j] == root) continue;
+			visited[j] = root;
+			if (perm[j] == unmatched) {
+				// flip the matching along the path: row stackRow[k] takes the column that led to row stackRow[k+1]
+				for (size_t k = stackRow.size(); k >= 1; --k) {
+					size_t row = stackRow[k - 1];
+					size_t previous = matched[row];
+					perm[j] = row;
+					matched[row] = j;
+					j = previous;
+				}
+				augmented = true;
+			}
+			else {
+				stackRow.push_back(perm[j]);
+				stackPos.push_back(0);
+			}
+		}
+		if (!augmented) return std::vector<size_t>();
+	}
+	return perm;
+}
+
+}}} // namespace sw::universal::blas
@@ -1,6 +1,58 @@
 #pragma once
-// lsq.hpp: super-simple dense matrix implementation
+// lsq.hpp: linear least squares solvers with Householder QR
 //
-// Copyright (C) 2017-2020 Stillwater Supercomputing, Inc.
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
 //
-// This file is part of the universal numbers project, which is released under an MIT Open Source license.
\ No newline at end of file
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/blas/solvers/qr.hpp>
+
+/*
+   min || A x - b || for a tall m x n matrix A of full column rank: A = Q R with the blocked
+   Householder QR, then R x = (Q' b)(0:n). Q is never formed, the reflectors are applied to b.
+   The in-place solver overwrites A with its factors and b with Q' b, and keeps its scratch
+   space in the workspace, so that repeated fits of the same size do not allocate.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+/// <summary>
+/// in-place least squares solution of A x = b
+/// </summary>
+/// <param name="A">m x n matrix, m >= n, that is replaced by its QR factors</param>
+/// <param name="b">right hand side of m elements that is replaced by Q' b</param>
+/// <param name="x">the n element solution</param>
+/// <param name="ws">workspace, reused across calls</param>
+/// <param name="blockSize">number of columns of a panel of the QR factorization</param>
+/// <param name="nrThreads">number of threads of the trailing updates, 0 selects the hardware concurrency</param>
+/// <returns>0 on success, 1 if the system is underdetermined, 2 if A is rank deficient</returns>
+template<typename Scalar>
+int lsq(matrix<Scalar>& A, vector<Scalar>& b, vector<Scalar>& x, qr_workspace<Scalar>& ws, unsigned blockSize = 32, unsigned nrThreads = 0) {
+	const size_t m = num_rows(A), n = num_cols(A);
+	if (m < n || size(b) != m) {
+		std::cerr << "lsq: system of " << m << " equations in " << n << " unknowns is not a tall least squares problem\n";
+		return 1;
+	}
+	householder_qr(A, ws.tau, ws, blockSize, nrThreads);
+	householder_qt(A, ws.tau, b);
+	if (size(x) != n) x.resize(n);
+	// back substitution R x = (Q' b)(0:n)
+	for (size_t i = n; i-- > 0; ) {
+		if (A(i, i) == Scalar(0)) return 2;
+		Scalar sum = b[i];
+		for (size_t j = i + 1; j < n; ++j) sum -= A(i, j) * x[j];
+		x[i] = sum / A(i, i);
+	}
+	return 0;
+}
+
+// least squares solution of A x = b
+template<typename Scalar>
+vector<Scalar> lsq(const matrix<Scalar>& A, const vector<Scalar>& b, unsigned blockSize = 32, unsigned nrThreads = 0) {
+	matrix<Scalar> QR(A);
+	vector<Scalar> y(b), x;
+	qr_workspace<Scalar> ws;
+	if (lsq(QR, y, x, ws, blockSize, nrThreads) != 0) x = Scalar(0);
+	return x;
+}
+
+}}} // namespace sw::universal::blas
@@ -5,8 +5,12 @@
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 #include <universal/utility/directives.hpp>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <universal/number/posit/posit_fwd.hpp>
+#include <universal/traits/posit_traits.hpp>
 #include <universal/blas/matrix.hpp>
 
 #if defined(_MSC_VER)
@@ -353,6 +357,153 @@ int ludcmp(matrix< posit<nbits, es> >& A, vector<size_t>& indx) {
 	return 0; // success
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+/// right-looking blocked LU decomposition
+
+namespace lu_detail {
+
+	// A(i,j) - sum_p L(i,p) * U(p,j) over the p in [0, n), with L a row of n elements and U a column of n contiguous elements.
+	// posits accumulate in a quire so that the update of a block is a fused-dot product with a single rounding step
+	template<typename Scalar>
+	Scalar fused_update(const Scalar& aij, const Scalar* L, const Scalar* U, size_t n) {
+		if constexpr (is_posit<Scalar>) {
+			quire<Scalar::nbits, Scalar::es, 10> q(aij);
+			for (size_t p = 0; p < n; ++p) q -= quire_mul(L[p], U[p]);
+			Scalar sum;
+			convert(q.to_value(), sum);     // one and only rounding step of the fused-dot product
+			return sum;
+		}
+		else {
+			Scalar sum = aij;
+			for (size_t p = 0; p < n; ++p) sum -= L[p] * U[p];
+			return sum;
+		}
+	}
+
+	// execute f(first, last) over [begin, end) partitioned into contiguous ranges for nrThreads threads
+	template<typename Function>
+	void parallel_for(size_t begin, size_t end, unsigned nrThreads, Function&& f) {
+		size_t n = end - begin;
+		if (nrThreads <= 1 || n < 2 * size_t(nrThreads)) {
+			f(begin, end);
+			return;
+		}
+		std::vector<std::thread> threads;
+		size_t chunk = n / nrThreads, remainder = n % nrThreads, first = begin;
+		for (unsigned t = 0; t < nrThreads; ++t) {
+			size_t last = first + chunk + (t < remainder ? 1 : 0);
+			threads.emplace_back([&f, first, last]() { f(first, last); });
+			first = last;
+		}
+		for (auto& t : threads) t.join();
+	}
+
+} // namespace lu_detail
+
+/// <summary>
+/// in-place, right-looking blocked LU decomposition using partial pivoting with implicit pivoting applied.
+/// Each step factors a panel of blockSize columns, solves for the block row of U, and
+/// applies the rank-blockSize update to the trailing matrix, distributed over nrThreads threads.
+/// For posits every update of an element by a block is a fused-dot product.
+/// The result is compatible with ludcmp and can be passed to lubksb.
+/// </summary>
+/// <param name="A">square matrix that is replaced by its L + U factors</param>
+/// <param name="indx">row interchanges</param>
+/// <param name="blockSize">number of columns of a panel</param>
+/// <param name="nrThreads">number of threads of the trailing update, 0 selects the hardware concurrency</param>
+/// <returns>0 on success, 1 if the matrix is not square, 2 if the matrix is singular</returns>
+template<typename Scalar>
+int blocked_ludcmp(matrix<Scalar>& A, vector<size_t>& indx, unsigned blockSize = 64, unsigned nrThreads = 0) {
+	using std::fabs;
+	using namespace lu_detail;
+	const size_t N = num_rows(A);
+	if (N != num_cols(A)) {
+		std::cerr << "matrix argument to blocked_ludcmp is not square: (" << num_rows(A) << " x " << num_cols(A) << ")\n";
+		return 1;
+	}
+	if (blockSize == 0) blockSize = 1;
+	if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+	indx.resize(N);
+	indx = 0;
+	// implicit pivoting pre-calculation
+	vector<Scalar> implicitScale(N);
+	for (size_t i = 0; i < N; ++i) {
+		Scalar pivot = 0;
+		for (size_t j = 0; j < N; ++j) {
+			Scalar e = fabs(A(i, j));
+			if (e > pivot) pivot = e;
+		}
+		if (pivot == 0) {
+			std::cerr << "LU argument matrix is singular\n";
+			return 2;
+		}
+		implicitScale[i] = Scalar(1.0) / pivot;
+	}
+
+	std::vector<Scalar> L, U;  // contiguous copies of the rows of L and the columns of U of a block
+	for (size_t k = 0; k < N; k += blockSize) {
+		const size_t nb = std::min<size_t>(blockSize, N - k);
+		const size_t kb = k + nb;
+
+		// panel factorization of columns [k, kb): left-looking within the panel
+		U.resize(nb);
+		for (size_t j = k; j < kb; ++j) {
+			for (size_t i = k; i < j; ++i) {  // column j of U inside the panel
+				A(i, j) = fused_update(A(i, j), &A(i, k), &U[0], i - k);
+				U[i - k] = A(i, j);
+			}
+			Scalar pivot = 0;
+			size_t imax = j;
+			for (size_t i = j; i < N; ++i) {  // column j of L below the diagonal
+				Scalar sum = fused_update(A(i, j), &A(i, k), &U[0], j - k);
+				A(i, j) = sum;
+				Scalar dum = implicitScale[i] * fabs(sum);
+				if (dum >= pivot) {
+					pivot = dum;
+					imax = i;
+				}
+			}
+			if (j != imax) {
+				for (size_t c = 0; c < N; ++c) std::swap(A(imax, c), A(j, c));
+				implicitScale[imax] = implicitScale[j];
+			}
+			indx[j] = imax;
+			if (A(j, j) == 0) A(j, j) = std::numeric_limits<Scalar>::epsilon();
+			Scalar dum = Scalar(1) / A(j, j);
+			for (size_t i = j + 1; i < N; ++i) A(i, j) *= dum;
+		}
+		if (kb == N) break;
+
+		// block row of U: U12 = L11^-1 A12, the columns are independent
+		parallel_for(kb, N, nrThreads, [&A, k, kb](size_t first, size_t last) {
+			std::vector<Scalar> u(kb - k);
+			for (size_t j = first; j < last; ++j) {
+				for (size_t i = k; i < kb; ++i) {
+					u[i - k] = fused_update(A(i, j), &A(i, k), &u[0], i - k);
+					A(i, j) = u[i - k];
+				}
+			}
+		});
+
+		// trailing update: A22 -= L21 * U12, with U12 transposed so that its columns are contiguous
+		const size_t M = N - kb;
+		U.resize(M * nb);
+		for (size_t p = 0; p < nb; ++p) {
+			for (size_t j = 0; j < M; ++j) U[j * nb + p] = A(k + p, kb + j);
+		}
+		const Scalar* Ut = U.data();
+		parallel_for(kb, N, nrThreads, [&A, Ut, k, kb, nb, N](size_t first, size_t last) {
+			for (size_t i = first; i < last; ++i) {
+				const Scalar* Li = &A(i, k);
+				for (size_t j = kb; j < N; ++j) {
+					A(i, j) = fused_update(A(i, j), Li, Ut + (j - kb) * nb, nb);
+				}
+			}
+		});
+	}
+	return 0; // success
+}
+
 // LU decomposition using partial pivoting with implicit pivoting applied
 template<typename Scalar>
 matrix<Scalar> lu(const matrix<Scalar>& A) {
@@ -11,8 +11,14 @@
  * ***********************************************************************
  */
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
 #include<universal/blas/blas_l1.hpp>
 #include<universal/blas/blas.hpp>
+#include<universal/blas/solvers/lu.hpp>
 
 namespace sw { namespace universal { namespace blas {  
 
@@ -54,157 +60,322 @@ void mgs(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R){
     }
 }
 
+/*
+   The Householder QR factorizations work in place on the matrix: on return the upper
+   triangle holds R, and the part below the diagonal holds the Householder vectors v,
+   with the implicit v(0) = 1, so that Q = H(0) H(1) ... H(k-1) with H(j) = I - tau(j) v v'.
+   The kernels address the trailing submatrices through a pointer and the row stride of
+   the matrix, and do not copy them.
+
+   householder_qr is blocked: a panel of blockSize columns is factored column by column,
+   its reflectors are accumulated into the compact WY form H = I - V T V', with T upper
+   triangular, and the trailing matrix is updated with the matrix-matrix products
+   C -= V (T' (V' C)). The columns of the trailing matrix are distributed over the threads.
+   The scratch space of T, V'V, and V'C lives in a qr_workspace that the caller can reuse
+   across factorizations of the same size, so a factorization does not allocate.
+*/
+
 template<typename Scalar>
-void houseqr(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R){
-    size_t m = num_rows(A);
-    size_t n = num_cols(A);
-    Scalar c;
-    vector<Scalar> v(m);
-    for(size_t j=0; j<n;++j){
-        
-        // Extracting subvector from R
-        for(size_t k=j;k<m;++k){
-            v(k) = R(k,j);
-        }
-        auto w = subvec(v,j+1,m);
-        int sgn = w(0) < 0 ? -1 : 1; 
-        w(0) += sgn*normL2(w);
-        c = 2 / dot(w,w);
-        householder_update_R(R, w, c, j);
-        householder_update_Q(Q, w, c, j);
+struct qr_workspace {
+    vector<Scalar> tau;           // Householder scalars, used by the solvers that own the factorization
+    std::vector<Scalar> T, Y, W;  // block reflector, V'V of a panel, and V'C of the trailing matrix
+    void resize(size_t blockSize, size_t cols) {
+        if (T.size() < blockSize * blockSize) { T.resize(blockSize * blockSize); Y.resize(blockSize * blockSize); }
+        if (W.size() < blockSize * cols) W.resize(blockSize * cols);
     }
-}
+};
 
+namespace qr_detail {
 
-// Householder method with column pivoting
-template<typename Scalar>
-void houseqrpivot(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R, matrix<Scalar>& P){
-    // See https://netlib.org/lapack/lug/node42.html
-    size_t m = num_rows(A);
-    size_t n = num_cols(A);
-    
-    // Compute Norms of A
-    vector<Scalar> x(n);
-    vector<Scalar> r(n);
-    Scalar c;
-    
-    for(size_t k = 0; k < n; ++k){
-        x(k) = normL2(getCol(k,A));
-        x(k) *= x(k); // Norm squared
+    // element (i, p) of the unit lower trapezoidal V stored below the diagonal of a
+    template<typename Scalar>
+    inline Scalar reflector_element(const Scalar* V, size_t ldv, size_t i, size_t p) {
+        return (i == p) ? Scalar(1) : (i > p ? V[i * ldv + p] : Scalar(0));
     }
 
-    vector<Scalar> v(m);
-    for(size_t j=0; j<n;++j){
+    // generate the reflector H = I - tau v v' with H x = beta e1 of the column x of m elements at a,
+    // overwrite x with beta and v(1:m), and return tau
+    template<typename Scalar>
+    Scalar reflector(Scalar* a, size_t lda, size_t m) {
+        using std::sqrt;
+        Scalar alpha = a[0];
+        Scalar xnorm2(0);
+        for (size_t i = 1; i < m; ++i) xnorm2 += a[i * lda] * a[i * lda];
+        if (xnorm2 == Scalar(0)) return Scalar(0);
+        Scalar beta = sqrt(alpha * alpha + xnorm2);
+        if (alpha >= Scalar(0)) beta = -beta;
+        Scalar tau = (beta - alpha) / beta;
+        Scalar scale = Scalar(1) / (alpha - beta);
+        for (size_t i = 1; i < m; ++i) a[i * lda] *= scale;
+        a[0] = beta;
+        return tau;
+    }
 
-        // Which is largest?
-        size_t argmax = j;
-        for(size_t k = j+1; k < n; ++k){
-            if(x(j)  < x(k)  ){
-                argmax = k;
-            }
+    // apply H = I - tau v v' from the left to the columns [first, last) of the m rows of C, v is the column at V
+    template<typename Scalar>
+    void apply_reflector(const Scalar* V, size_t ldv, size_t m, Scalar tau, Scalar* C, size_t ldc, size_t first, size_t last, Scalar* w) {
+        if (tau == Scalar(0)) return;
+        for (size_t j = first; j < last; ++j) w[j] = C[j];
+        for (size_t i = 1; i < m; ++i) {
+            Scalar v = V[i * ldv];
+            const Scalar* c = C + i * ldc;
+            for (size_t j = first; j < last; ++j) w[j] += v * c[j];
         }
+        for (size_t j = first; j < last; ++j) {
+            w[j] *= tau;
+            C[j] -= w[j];
+        }
+        for (size_t i = 1; i < m; ++i) {
+            Scalar v = V[i * ldv];
+            Scalar* c = C + i * ldc;
+            for (size_t j = first; j < last; ++j) c[j] -= v * w[j];
+        }
+    }
 
-        // swap 
-        if (argmax != j){
-            std::cout << "Switch, (j, argmax) = " << j << ", " << argmax << std::endl;
-            Scalar tmp;
-            for(size_t k = 0; k < m; ++k){
-                tmp = R(k,j);
-                R(k,j) = R(k,argmax);
-                R(k,argmax) = tmp;
+    // the upper triangular T of the compact WY form of the nb reflectors of the m rows at V
+    template<typename Scalar>
+    void block_reflector(const Scalar* V, size_t ldv, size_t m, size_t nb, const Scalar* tau, Scalar* T, Scalar* Y) {
+        for (size_t p = 0; p < nb * nb; ++p) Y[p] = Scalar(0);
+        for (size_t i = 0; i < m; ++i) {
+            size_t last = std::min(i + 1, nb);
+            for (size_t p = 0; p < last; ++p) {
+                Scalar vp = reflector_element(V, ldv, i, p);
+                for (size_t q = p + 1; q < last; ++q) Y[p * nb + q] += vp * reflector_element(V, ldv, i, q);
             }
-            
-            // Record swap
-            P(j,1) = argmax;
-            P(argmax,1) = j; 
-
-            // swap ||a_i|| and ||a_k||
-            tmp = x(j);
-            x(j) = x(argmax);
-            x(argmax) = tmp;
         }
-        
-
-        // Extracting subvector from R
-        for(size_t k=j;k<m;++k){
-            v(k) = R(k,j);
+        // T(0:q, q) = -tau(q) T(0:q, 0:q) Y(0:q, q)
+        for (size_t q = 0; q < nb; ++q) {
+            for (size_t p = 0; p < q; ++p) {
+                Scalar sum(0);
+                for (size_t r = p; r < q; ++r) sum += T[p * nb + r] * Y[r * nb + q];
+                T[p * nb + q] = -tau[q] * sum;
+            }
+            for (size_t p = q + 1; p < nb; ++p) T[p * nb + q] = Scalar(0);
+            T[q * nb + q] = tau[q];
         }
-        auto w = subvec(v,j+1,m);
-        int sgn = w(0) < 0 ? -1 : 1; 
-        w(0) += sgn*normL2(w);
-        c = 2 / dot(w,w);
-        householder_update_R(R, w, c, j);
-        householder_update_Q(Q, w, c, j);
+    }
 
-        // Update norms
-        for(size_t k=j+1;k<n;++k){
-            r(k) = R(0,k)*R(0,k);
-            x(k) =abs(x(k) -  r(k));
-            // std::cout << "x(1,k) - r(1,k) = " << x(k) << std::endl;
+    // apply the block reflector I - V T V', or its transpose, from the left to the columns [first, last) of the m rows of C
+    template<typename Scalar>
+    void apply_block_reflector(const Scalar* V, size_t ldv, size_t m, size_t nb, const Scalar* T, bool transpose,
+                               Scalar* C, size_t ldc, size_t first, size_t last, Scalar* W, size_t ldw) {
+        if (first >= last) return;
+        // W = V' C
+        for (size_t p = 0; p < nb; ++p) {
+            Scalar* w = W + p * ldw;
+            for (size_t j = first; j < last; ++j) w[j] = Scalar(0);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            const Scalar* c = C + i * ldc;
+            size_t pend = std::min(i + 1, nb);
+            for (size_t p = 0; p < pend; ++p) {
+                Scalar v = reflector_element(V, ldv, i, p);
+                Scalar* w = W + p * ldw;
+                for (size_t j = first; j < last; ++j) w[j] += v * c[j];
+            }
         }
+        // W = T' W, or T W, in place
+        for (size_t j = first; j < last; ++j) {
+            if (transpose) {
+                for (size_t p = nb; p-- > 0; ) {
+                    Scalar sum(0);
+                    for (size_t r = 0; r <= p; ++r) sum += T[r * nb + p] * W[r * ldw + j];
+                    W[p * ldw + j] = sum;
+                }
+            }
+            else {
+                for (size_t p = 0; p < nb; ++p) {
+                    Scalar sum(0);
+                    for (size_t r = p; r < nb; ++r) sum += T[p * nb + r] * W[r * ldw + j];
+                    W[p * ldw + j] = sum;
+                }
+            }
+        }
+        // C -= V W
+        for (size_t i = 0; i < m; ++i) {
+            Scalar* c = C + i * ldc;
+            size_t pend = std::min(i + 1, nb);
+            for (size_t p = 0; p < pend; ++p) {
+                Scalar v = reflector_element(V, ldv, i, p);
+                const Scalar* w = W + p * ldw;
+                for (size_t j = first; j < last; ++j) c[j] -= v * w[j];
+            }
+        }
+    }
 
+} // namespace qr_detail
+
+/// <summary>
+/// in-place, blocked Householder QR factorization: the upper triangle of A is replaced by R,
+/// and the part below the diagonal by the Householder vectors
+/// </summary>
+/// <param name="A">m x n matrix that is replaced by its factors</param>
+/// <param name="tau">the min(m, n) Householder scalars</param>
+/// <param name="ws">workspace, reused across calls</param>
+/// <param name="blockSize">number of columns of a panel</param>
+/// <param name="nrThreads">number of threads of the trailing update, 0 selects the hardware concurrency</param>
+template<typename Scalar>
+void householder_qr(matrix<Scalar>& A, vector<Scalar>& tau, qr_workspace<Scalar>& ws, unsigned blockSize = 32, unsigned nrThreads = 0) {
+    using namespace qr_detail;
+    const size_t m = num_rows(A), n = num_cols(A), k = std::min(m, n);
+    if (blockSize == 0) blockSize = 1;
+    if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (size(tau) != k) tau.resize(k);
+    if (k == 0) return;
+    ws.resize(blockSize, n);
+    Scalar* a = &A(0, 0);
+    for (size_t kb = 0; kb < k; kb += blockSize) {
+        const size_t nb = std::min(size_t(blockSize), k - kb);
+        // factor the panel
+        for (size_t j = kb; j < kb + nb; ++j) {
+            tau[j] = reflector(a + j * n + j, n, m - j);
+            apply_reflector(a + j * n + j, n, m - j, tau[j], a + j * n, n, j + 1, kb + nb, ws.W.data());
+        }
+        if (kb + nb >= n) continue;
+        // update the trailing matrix with the block reflector
+        block_reflector(a + kb * n + kb, n, m - kb, nb, &tau[kb], ws.T.data(), ws.Y.data());
+        Scalar* T = ws.T.data();
+        Scalar* W = ws.W.data();
+        lu_detail::parallel_for(kb + nb, n, nrThreads, [=](size_t first, size_t last) {
+            apply_block_reflector(a + kb * n + kb, n, m - kb, nb, T, true, a + kb * n, n, first, last, W, n);
+        });
     }
 }
- 
 
-// Updates R matrix
+/// <summary>
+/// the orthogonal factor Q = H(0) H(1) ... H(k-1) of a Householder QR factorization, accumulated backwards in blocks
+/// </summary>
+/// <param name="QR">the factors of householder_qr or householder_qrp</param>
+/// <param name="Q">m x m orthogonal matrix, or the m x n thin factor if the matrix has n columns</param>
 template<typename Scalar>
-bool householder_update_R(matrix<Scalar>& R, const vector<Scalar> &v, Scalar c, size_t j){
-    size_t m = num_rows(R);
-    size_t n = num_cols(R);
-    if(j > m-1 || j > n-1){std::cerr << "Index out of bounds\n";return false;}
-   
-    auto XXt = xyt(v,v);
-    auto B = c * XXt * submat(R,j,m,j,n);
-    for(size_t i = 0; i < num_rows(B); ++i){
-        for(size_t k = 0; k < num_cols(B); ++k){
-            R(i+j,k+j) = R(i+j,k+j) - B(i,k);
-        }
+void householder_q(const matrix<Scalar>& QR, const vector<Scalar>& tau, matrix<Scalar>& Q, qr_workspace<Scalar>& ws, unsigned blockSize = 32, unsigned nrThreads = 0) {
+    using namespace qr_detail;
+    const size_t m = num_rows(QR), n = num_cols(QR), k = size(tau);
+    const size_t cols = num_cols(Q);
+    if (num_rows(Q) != m || cols < k) Q = matrix<Scalar>(unsigned(m), unsigned(m));
+    if (blockSize == 0) blockSize = 1;
+    if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    Q = 0;
+    for (size_t i = 0; i < std::min(m, size_t(num_cols(Q))); ++i) Q(i, i) = Scalar(1);
+    if (k == 0) return;
+    const size_t ldq = num_cols(Q);
+    ws.resize(blockSize, ldq);
+    const Scalar* a = &*QR.begin();
+    Scalar* q = &Q(0, 0);
+    for (size_t kb = ((k - 1) / blockSize) * blockSize; ; kb -= blockSize) {
+        const size_t nb = std::min(size_t(blockSize), k - kb);
+        block_reflector(a + kb * n + kb, n, m - kb, nb, &*tau.begin() + kb, ws.T.data(), ws.Y.data());
+        Scalar* T = ws.T.data();
+        Scalar* W = ws.W.data();
+        // the columns of Q to the left of the block are still unit vectors that the block does not change
+        lu_detail::parallel_for(kb, ldq, nrThreads, [=](size_t first, size_t last) {
+            apply_block_reflector(a + kb * n + kb, n, m - kb, nb, T, false, q + kb * ldq, ldq, first, last, W, ldq);
+        });
+        if (kb == 0) break;
     }
-    return true;
 }
 
-// Update Q matrix
+/// <summary>
+/// b = Q' b for the orthogonal factor Q of a Householder QR factorization
+/// </summary>
 template<typename Scalar>
-bool householder_update_Q(matrix<Scalar>& Q, const vector<Scalar> &v, Scalar c, size_t j){
-    size_t m = num_rows(Q);
-    size_t n = m;
-    if(j > m-1 || j > n-1){std::cerr << "Index out of bounds\n";return false;}
-    auto XXt = xyt(v,v);
-    auto B = c * submat(Q,0,m,j,n) * XXt;
+void householder_qt(const matrix<Scalar>& QR, const vector<Scalar>& tau, vector<Scalar>& b) {
+    const size_t m = num_rows(QR);
+    for (size_t j = 0; j < size(tau); ++j) {
+        if (tau[j] == Scalar(0)) continue;
+        Scalar w = b[j];
+        for (size_t i = j + 1; i < m; ++i) w += QR(i, j) * b[i];
+        w *= tau[j];
+        b[j] -= w;
+        for (size_t i = j + 1; i < m; ++i) b[i] -= QR(i, j) * w;
+    }
+}
 
-    for(size_t i = 0; i < num_rows(B); ++i){
-        for(size_t k = 0; k < num_cols(B); ++k){
-            Q(i,k+j) = Q(i,k+j) - B(i,k);
+/// <summary>
+/// in-place Householder QR factorization with column pivoting: A P = Q R, the column norms are downdated
+/// and recomputed when cancellation makes them unreliable
+/// </summary>
+/// <param name="A">m x n matrix that is replaced by the factors of the permuted matrix</param>
+/// <param name="perm">perm[j] is the column of the original matrix that is column j of A P</param>
+/// <param name="nrThreads">number of threads of the update of each column, 0 selects the hardware concurrency.
+/// The updates are matrix-vector products that start threads per column, so one thread is the default</param>
+template<typename Scalar>
+void householder_qrp(matrix<Scalar>& A, vector<Scalar>& tau, vector<size_t>& perm, qr_workspace<Scalar>& ws, unsigned nrThreads = 1) {
+    using namespace qr_detail;
+    const size_t m = num_rows(A), n = num_cols(A), k = std::min(m, n);
+    if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (size(tau) != k) tau.resize(k);
+    if (size(perm) != n) perm.resize(n);
+    for (size_t j = 0; j < n; ++j) perm[j] = j;
+    if (k == 0) return;
+    ws.resize(3, n);
+    // squared column norms: downdated in vn1, and at their last computation in vn2
+    Scalar* vn1 = ws.W.data();
+    Scalar* vn2 = ws.W.data() + n;
+    Scalar* w = ws.W.data() + 2 * n;
+    for (size_t j = 0; j < n; ++j) vn1[j] = Scalar(0);
+    for (size_t i = 0; i < m; ++i) for (size_t j = 0; j < n; ++j) vn1[j] += A(i, j) * A(i, j);
+    for (size_t j = 0; j < n; ++j) vn2[j] = vn1[j];
+    const double tolerance = std::sqrt(double(std::numeric_limits<Scalar>::epsilon()));
+    Scalar* a = &A(0, 0);
+    for (size_t j = 0; j < k; ++j) {
+        size_t pivot = j;
+        for (size_t c = j + 1; c < n; ++c) if (vn1[c] > vn1[pivot]) pivot = c;
+        if (pivot != j) {
+            for (size_t i = 0; i < m; ++i) std::swap(a[i * n + j], a[i * n + pivot]);
+            std::swap(perm[j], perm[pivot]);
+            std::swap(vn1[j], vn1[pivot]);
+            std::swap(vn2[j], vn2[pivot]);
+        }
+        tau[j] = reflector(a + j * n + j, n, m - j);
+        Scalar t = tau[j];
+        lu_detail::parallel_for(j + 1, n, nrThreads, [=](size_t first, size_t last) {
+            apply_reflector(a + j * n + j, n, m - j, t, a + j * n, n, first, last, w);
+        });
+        for (size_t c = j + 1; c < n; ++c) {
+            if (vn1[c] == Scalar(0)) continue;
+            vn1[c] -= a[j * n + c] * a[j * n + c];
+            if (!(double(vn1[c]) > tolerance * double(vn2[c]))) {
+                Scalar sum(0);
+                for (size_t i = j + 1; i < m; ++i) sum += a[i * n + c] * a[i * n + c];
+                vn1[c] = vn2[c] = sum;
+            }
         }
     }
-    return true;
 }
 
-
+// Householder QR: on return R is upper triangular and Q is m x m orthogonal with A = Q R
 template<typename Scalar>
-matrix<Scalar> submat(const matrix<Scalar>& A, size_t i,size_t m, size_t j,size_t n){
-    size_t a = m-i;
-    size_t b = n-j;
-    matrix<Scalar> B(a,b);
-    for(size_t p=0;p<a;++p){
-        for(size_t q=0;q<b;++q){
-            B(p,q) = A(i + p, j + q );
-        }
+void houseqr(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R){
+    size_t m = num_rows(A);
+    size_t n = num_cols(A);
+    qr_workspace<Scalar> ws;
+    R = A;
+    householder_qr(R, ws.tau, ws);
+    householder_q(R, ws.tau, Q, ws);
+    for (size_t i = 1; i < m; ++i) {
+        for (size_t j = 0; j < std::min(i, n); ++j) R(i, j) = 0;
     }
-    return B;
 }
 
 
+// Householder method with column pivoting: A P = Q R, P(j,1) is the column of A that is column j of A P
 template<typename Scalar>
-vector<Scalar> subvec(const vector<Scalar>& v, size_t j,size_t n){
-    size_t m = n-j+1;
-    vector<Scalar> x(m);
-    for(size_t i=0;i<m;++i){
-        x(i) = v(i+j-1);
+void houseqrpivot(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R, matrix<Scalar>& P){
+    // See https://netlib.org/lapack/lug/node42.html
+    size_t m = num_rows(A);
+    size_t n = num_cols(A);
+    qr_workspace<Scalar> ws;
+    vector<size_t> perm;
+    R = A;
+    householder_qrp(R, ws.tau, perm, ws);
+    householder_q(R, ws.tau, Q, ws);
+    for (size_t i = 1; i < m; ++i) {
+        for (size_t j = 0; j < std::min(i, n); ++j) R(i, j) = 0;
     }
-    return x;
+    for (size_t j = 0; j < std::min(n, size_t(num_rows(P))); ++j) P(j, 1) = Scalar(perm[j]);
 }
+ 
 
 // Given rotation setup (entries of rotation matrix)
 template<typename Scalar>
@@ -224,7 +395,7 @@ vector<Scalar> givens(const Scalar a, const Scalar b){
     return x;
 }
 
-// Perform Given's QR method
+// Perform Given's QR method: the rotations are applied in place to the two rows of R and the two columns of Q they change
 template<typename Scalar>
 void givensqr(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R){
     size_t m = num_rows(A);
@@ -232,16 +403,34 @@ void givensqr(const matrix<Scalar>& A, matrix<Scalar>& Q, matrix<Scalar>& R){
 
     for(size_t j = 0; j < n; ++j){
         for(size_t i = m - 1; i > j; --i){
-            matrix<Scalar> G(m,m);
-            G = 1;
-            vector<Scalar> x = givens(R(i-1, j),R(i,j));
-            G(i,i) = x(0);
-            G(i-1,i-1) = x(0);
-            G(i,i-1) = x(1);
-            G(i-1,i) = -x(1);
-
-            Q = Q*G;
-            R = G.transpose()*R;   
+            if (R(i, j) == 0) continue;
+            // the rotation of givens(), without the vector temporary
+            using std::abs;
+            using std::sqrt;
+            Scalar c, s, a = R(i-1, j), b = R(i, j);
+            if (abs(a) >= abs(b)) {
+                Scalar t = b / a;
+                c = Scalar(a < 0 ? -1 : 1) / sqrt(1 + t * t);
+                s = c * t;
+            }
+            else {
+                Scalar t = a / b;
+                s = Scalar(b < 0 ? -1 : 1) / sqrt(1 + t * t);
+                c = s * t;
+            }
+            // R = G' R
+            for (size_t k = j; k < n; ++k) {
+                Scalar a = R(i-1, k), b = R(i, k);
+                R(i-1, k) = c * a + s * b;
+                R(i, k) = c * b - s * a;
+            }
+            R(i, j) = 0;
+            // Q = Q G
+            for (size_t k = 0; k < m; ++k) {
+                Scalar a = Q(k, i-1), b = Q(k, i);
+                Q(k, i-1) = c * a + s * b;
+                Q(k, i) = c * b - s * a;
+            }
         }
     }
 }
@@ -271,7 +460,7 @@ std::pair<matrix<Scalar>, matrix<Scalar>> qr(const matrix<Scalar>& A, size_t whi
         givensqr(A, Q, R);
         for (size_t i = 0;i<num_rows(R);++i){
             for (size_t j = 0;j<num_cols(R);++j){
-                R(i,j) = (R(i,j) < 1.0e-18 ? 0 : R(i,j));
+                R(i,j) = (abs(R(i,j)) < 1.0e-18 ? 0 : R(i,j));
             }
         }
 		break;
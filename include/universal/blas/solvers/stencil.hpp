@@ -0,0 +1,397 @@
+#pragma once
+// stencil.hpp: matrix-free stencil operators on structured 2D and 3D grids, and the stationary and CG solvers on them
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <universal/blas/blas.hpp>
+
+/*
+   A finite difference discretization on a structured grid couples every grid point to the
+   same small set of neighbors. A stencil operator stores that set, the stencil, instead of
+   the (nx ny nz) x (nx ny nz) matrix: a 1000 x 1000 grid is a vector of 10^6 elements and a
+   five point stencil, where the dense laplace2D matrix would need 10^12 elements.
+
+   The grid point (i, j, k), 0 <= i < nx, 0 <= j < ny, 0 <= k < nz, is element
+   (k * ny + j) * nx + i of the grid vector, so i is the fastest running index. A 2D grid has
+   nz = 1, and laplace2D(S, m, n) numbers the unknowns as laplace2D(A, m, n) does for the
+   dense matrix, with nx = n and ny = m.
+
+   Each stencil point is an offset (di, dj, dk), with -1 <= di, dj, dk <= 1, and a coefficient
+   that is either the same for all grid points or given per grid point: the coefficient of
+   grid point p couples p to its neighbor p + offset. Neighbors outside of the grid are dropped,
+   which is a homogeneous Dirichlet boundary. The stencil points are kept in the order of their
+   linear offset, which is the column order of the equivalent matrix, so that the sums of a
+   row are accumulated in the same order as the dense matrix-vector product.
+
+   apply(x, y) computes y = A x. The grid is cut into tiles of tileRows rows by tileCols
+   columns, and a tile is marched through all planes of the grid so that the three planes of
+   a tile stay in cache for the 3D stencils. The tiles are distributed over the threads of
+   the operator. Within a row of a tile the loop over a stencil point has no bounds checks:
+   the range of the row that has the neighbor is computed once per row.
+
+   A stencil operator is an operator and a preconditioner of the Krylov solvers of krylov.hpp,
+   and it has the matrix-vector product A * x of the cg solver of cg.hpp. The stationary
+   solvers Jacobi, GaussSeidel, and sor have overloads for the stencil operator: Jacobi runs on
+   the threads of the operator, Gauss-Seidel and SOR sweep the grid in lexicographic order,
+   as the dense solvers do.
+*/
+
+namespace sw { namespace universal { namespace blas {
+
+template<typename Scalar>
+class stencil_operator {
+public:
+	using value_type = Scalar;
+	static constexpr size_t defaultTileRows = 16;
+	static constexpr size_t defaultTileCols = 512;
+
+	stencil_operator() : stencil_operator(0, 0, 0) {}
+	stencil_operator(size_t nx, size_t ny, size_t nz = 1) : _nx{ nx }, _ny{ ny }, _nz{ nz }, _points{},
+		_tileRows{ defaultTileRows }, _tileCols{ defaultTileCols }, _nrThreads{ 1 } {}
+
+	/// <summary>
+	/// set the coefficient of the stencil point (di, dj, dk) to the same value for all grid points
+	/// </summary>
+	void set(int di, int dj, int dk, const Scalar& c) {
+		point& p = find(di, dj, dk);
+		p.variable = false;
+		p.c.assign(1, c);
+	}
+	/// <summary>
+	/// set the coefficients of the stencil point (di, dj, dk) per grid point: c[p] couples grid point p to p + (di, dj, dk)
+	/// </summary>
+	void set(int di, int dj, int dk, const std::vector<Scalar>& c) {
+		if (c.size() != size()) throw std::runtime_error("stencil_operator: coefficient array does not match the grid");
+		point& p = find(di, dj, dk);
+		p.variable = true;
+		p.c = c;
+	}
+
+	// number of threads of apply and of the Jacobi iteration, 0 selects the hardware concurrency
+	void threads(unsigned nrThreads) { _nrThreads = (nrThreads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : nrThreads); }
+	unsigned threads() const noexcept { return _nrThreads; }
+	void tile(size_t tileRows, size_t tileCols) { _tileRows = std::max<size_t>(1, tileRows); _tileCols = std::max<size_t>(1, tileCols); }
+
+	size_t size() const noexcept { return _nx * _ny * _nz; }
+	size_t nx() const noexcept { return _nx; }
+	size_t ny() const noexcept { return _ny; }
+	size_t nz() const noexcept { return _nz; }
+	size_t points() const noexcept { return _points.size(); }
+	size_t index(size_t i, size_t j, size_t k = 0) const noexcept { return (k * _ny + j) * _nx + i; }
+
+	// coefficient of the stencil point (di, dj, dk) at grid point p, zero when the stencil does not have the point
+	Scalar coefficient(int di, int dj, int dk, size_t p) const noexcept {
+		for (const point& s : _points) {
+			if (s.di == di && s.dj == dj && s.dk == dk) return s.coefficient(p);
+		}
+		return Scalar(0);
+	}
+	Scalar diagonal(size_t p) const noexcept { return coefficient(0, 0, 0, p); }
+	vector<Scalar> diagonal() const {
+		vector<Scalar> d(size());
+		for (size_t p = 0; p < size(); ++p) d[p] = diagonal(p);
+		return d;
+	}
+
+	// y = A x
+	void apply(const vector<Scalar>& x, vector<Scalar>& y) const { multiply(x, y, false); }
+	// y = (A - D) x, the product with the off-diagonal part of A
+	void apply_offdiagonal(const vector<Scalar>& x, vector<Scalar>& y) const { multiply(x, y, true); }
+
+	// sum of the off-diagonal terms of row p = index(i, j, k), in the order of the stencil points
+	Scalar offdiagonal(const vector<Scalar>& x, size_t i, size_t j, size_t k) const {
+		size_t p = index(i, j, k);
+		Scalar sigma(0);
+		for (const point& s : _points) {
+			if (s.center()) continue;
+			if (!inside(i, s.di, _nx) || !inside(j, s.dj, _ny) || !inside(k, s.dk, _nz)) continue;
+			sigma += s.coefficient(p) * x[size_t(std::ptrdiff_t(p) + s.offset)];
+		}
+		return sigma;
+	}
+
+	// the dense matrix of the operator, for small grids
+	matrix<Scalar> to_matrix() const {
+		matrix<Scalar> A(size(), size());
+		A.setzero();
+		for (size_t k = 0; k < _nz; ++k) {
+			for (size_t j = 0; j < _ny; ++j) {
+				for (size_t i = 0; i < _nx; ++i) {
+					size_t p = index(i, j, k);
+					for (const point& s : _points) {
+						if (!inside(i, s.di, _nx) || !inside(j, s.dj, _ny) || !inside(k, s.dk, _nz)) continue;
+						A(p, size_t(std::ptrdiff_t(p) + s.offset)) = s.coefficient(p);
+					}
+				}
+			}
+		}
+		return A;
+	}
+
+private:
+	struct point {
+		int di, dj, dk;
+		std::ptrdiff_t offset;      // linear offset of the neighbor in the grid vector
+		bool variable;
+		std::vector<Scalar> c;      // one coefficient, or one per grid point when variable
+		bool center() const noexcept { return di == 0 && dj == 0 && dk == 0; }
+		Scalar coefficient(size_t p) const noexcept { return c[variable ? p : 0]; }
+	};
+
+	size_t _nx, _ny, _nz;
+	std::vector<point> _points;
+	size_t _tileRows, _tileCols;
+	unsigned _nrThreads;
+
+	static bool inside(size_t i, int d, size_t n) noexcept {
+		return (d >= 0 || i >= size_t(-d)) && i + size_t(std::max(d, 0)) < n;
+	}
+
+	// the stencil point (di, dj, dk), which is inserted in the order of the linear offsets when it does not exist
+	point& find(int di, int dj, int dk) {
+		if (di < -1 || di > 1 || dj < -1 || dj > 1 || dk < -1 || dk > 1) throw std::runtime_error("stencil_operator: stencil points are limited to the nearest neighbors");
+		if (dk != 0 && _nz == 1) throw std::runtime_error("stencil_operator: 3D stencil point on a 2D grid");
+		// on narrow grids different points can share a linear offset, so the point is looked up by its coordinates
+		auto it = std::find_if(_points.begin(), _points.end(), [=](const point& s) { return s.di == di && s.dj == dj && s.dk == dk; });
+		if (it != _points.end()) return *it;
+		std::ptrdiff_t offset = (std::ptrdiff_t(dk) * std::ptrdiff_t(_ny) + dj) * std::ptrdiff_t(_nx) + di;
+		it = std::find_if(_points.begin(), _points.end(), [=](const point& s) { return s.offset >= offset; });
+		return *_points.insert(it, point{ di, dj, dk, offset, false, std::vector<Scalar>(1, Scalar(0)) });
+	}
+
+	void multiply(const vector<Scalar>& x, vector<Scalar>& y, bool skipCenter) const {
+		const size_t rowTiles = (_ny + _tileRows - 1) / _tileRows;
+		const size_t colTiles = (_nx + _tileCols - 1) / _tileCols;
+		lu_detail::parallel_for(0, rowTiles * colTiles, _nrThreads, [&](size_t first, size_t last) {
+			for (size_t t = first; t < last; ++t) {
+				size_t j0 = (t / colTiles) * _tileRows, j1 = std::min(_ny, j0 + _tileRows);
+				size_t i0 = (t % colTiles) * _tileCols, i1 = std::min(_nx, i0 + _tileCols);
+				for (size_t k = 0; k < _nz; ++k) {
+					for (size_t j = j0; j < j1; ++j) {
+						size_t row = index(0, j, k);
+						for (size_t i = i0; i < i1; ++i) y[row + i] = Scalar(0);
+						for (const point& s : _points) {
+							if (skipCenter && s.center()) continue;
+							if (!inside(j, s.dj, _ny) || !inside(k, s.dk, _nz)) continue;
+							// the columns of the row that have the neighbor
+							size_t lo = std::max(i0, size_t(s.di < 0 ? 1 : 0));
+							size_t hi = std::min(i1, size_t(s.di > 0 ? _nx - 1 : _nx));
+							if (s.variable) {
+								for (size_t i = lo; i < hi; ++i) {
+									size_t p = row + i;
+									y[p] += s.c[p] * x[size_t(std::ptrdiff_t(p) + s.offset)];
+								}
+							}
+							else {
+								const Scalar c = s.c[0];
+								for (size_t i = lo; i < hi; ++i) {
+									size_t p = row + i;
+									y[p] += c * x[size_t(std::ptrdiff_t(p) + s.offset)];
+								}
+							}
+						}
+					}
+				}
+			}
+		});
+	}
+};
+
+// y = A x
+template<typename Scalar>
+vector<Scalar> operator*(const stencil_operator<Scalar>& A, const vector<Scalar>& x) {
+	vector<Scalar> y(A.size());
+	A.apply(x, y);
+	return y;
+}
+
+template<typename Scalar>
+size_t num_rows(const stencil_operator<Scalar>& A) { return A.size(); }
+template<typename Scalar>
+size_t num_cols(const stencil_operator<Scalar>& A) { return A.size(); }
+
+///////////////////////////////////////////////////////////////////////////////////
+// stencil generators
+
+// 5-point Laplacian on an m x n grid: the stencil operator of the dense laplace2D(A, m, n)
+template<typename Scalar>
+void laplace2D(stencil_operator<Scalar>& S, size_t m, size_t n) {
+	S = stencil_operator<Scalar>(n, m);
+	S.set( 0,  0, 0, Scalar(4));
+	S.set(-1,  0, 0, Scalar(-1));
+	S.set( 1,  0, 0, Scalar(-1));
+	S.set( 0, -1, 0, Scalar(-1));
+	S.set( 0,  1, 0, Scalar(-1));
+}
+
+// 9-point Laplacian on an m x n grid: the fourth order compact (Mehrstellen) stencil, scaled by 6
+template<typename Scalar>
+void laplace2D_9point(stencil_operator<Scalar>& S, size_t m, size_t n) {
+	S = stencil_operator<Scalar>(n, m);
+	for (int dj = -1; dj <= 1; ++dj) {
+		for (int di = -1; di <= 1; ++di) {
+			int distance = (di != 0) + (dj != 0);
+			S.set(di, dj, 0, Scalar(distance == 0 ? 20 : (distance == 1 ? -4 : -1)));
+		}
+	}
+}
+
+// 7-point Laplacian on an l x m x n grid, with nx = n, ny = m, nz = l
+template<typename Scalar>
+void laplace3D(stencil_operator<Scalar>& S, size_t l, size_t m, size_t n) {
+	S = stencil_operator<Scalar>(n, m, l);
+	S.set( 0,  0,  0, Scalar(6));
+	S.set(-1,  0,  0, Scalar(-1));
+	S.set( 1,  0,  0, Scalar(-1));
+	S.set( 0, -1,  0, Scalar(-1));
+	S.set( 0,  1,  0, Scalar(-1));
+	S.set( 0,  0, -1, Scalar(-1));
+	S.set( 0,  0,  1, Scalar(-1));
+}
+
+// 27-point operator on an l x m x n grid: 26 on the diagonal and -1 for all 26 neighbors, the HPCG benchmark operator
+template<typename Scalar>
+void laplace3D_27point(stencil_operator<Scalar>& S, size_t l, size_t m, size_t n) {
+	S = stencil_operator<Scalar>(n, m, l);
+	for (int dk = -1; dk <= 1; ++dk) {
+		for (int dj = -1; dj <= 1; ++dj) {
+			for (int di = -1; di <= 1; ++di) {
+				S.set(di, dj, dk, Scalar((di == 0 && dj == 0 && dk == 0) ? 26 : -1));
+			}
+		}
+	}
+}
+
+/// <summary>
+/// variable coefficient diffusion operator -div(kappa grad u) on a structured grid, with the
+/// 5-point stencil in 2D (nz = 1) and the 7-point stencil in 3D. kappa(i, j, k) is the diffusion
+/// coefficient of grid point (i, j, k), and the coefficient of the face between two grid points
+/// is the harmonic mean of theirs. The faces on the boundary take the coefficient of the grid
+/// point, so that the constant kappa = 1 yields laplace2D and laplace3D.
+/// </summary>
+template<typename Scalar, typename Kappa>
+void diffusion(stencil_operator<Scalar>& S, size_t nx, size_t ny, size_t nz, Kappa&& kappa) {
+	S = stencil_operator<Scalar>(nx, ny, nz);
+	const size_t N = S.size();
+	std::vector<Scalar> k(N);
+	for (size_t kk = 0; kk < nz; ++kk) {
+		for (size_t j = 0; j < ny; ++j) {
+			for (size_t i = 0; i < nx; ++i) k[S.index(i, j, kk)] = Scalar(kappa(i, j, kk));
+		}
+	}
+	auto face = [](const Scalar& a, const Scalar& b) { return Scalar(2) * a * b / (a + b); };
+	std::vector<Scalar> center(N, Scalar(0));
+	const int dims = (nz > 1 ? 3 : 2);
+	for (int d = 0; d < dims; ++d) {
+		for (int sign = -1; sign <= 1; sign += 2) {
+			int di = (d == 0 ? sign : 0), dj = (d == 1 ? sign : 0), dk = (d == 2 ? sign : 0);
+			std::vector<Scalar> c(N, Scalar(0));
+			for (size_t kk = 0; kk < nz; ++kk) {
+				for (size_t j = 0; j < ny; ++j) {
+					for (size_t i = 0; i < nx; ++i) {
+						size_t p = S.index(i, j, kk);
+						size_t n = (d == 0 ? nx : (d == 1 ? ny : nz));
+						size_t at = (d == 0 ? i : (d == 1 ? j : kk));
+						if ((sign < 0 && at == 0) || (sign > 0 && at + 1 == n)) {
+							center[p] += k[p];
+							continue;
+						}
+						size_t q = S.index(i + size_t(di), j + size_t(dj), kk + size_t(dk));
+						Scalar kf = face(k[p], k[q]);
+						c[p] = -kf;
+						center[p] += kf;
+					}
+				}
+			}
+			S.set(di, dj, dk, c);
+		}
+	}
+	S.set(0, 0, 0, center);
+}
+
+/// <summary>
+/// inverse of the diagonal of a stencil operator, the Jacobi preconditioner M^-1 = D^-1.
+/// Zero diagonal elements are replaced by 1.
+/// </summary>
+template<typename Scalar>
+stencil_operator<Scalar> inverse_diagonal(const stencil_operator<Scalar>& A) {
+	stencil_operator<Scalar> M(A.nx(), A.ny(), A.nz());
+	std::vector<Scalar> invDiag(A.size());
+	for (size_t p = 0; p < A.size(); ++p) {
+		Scalar d = A.diagonal(p);
+		invDiag[p] = (d == Scalar(0) ? Scalar(1) : Scalar(1) / d);
+	}
+	M.set(0, 0, 0, invDiag);
+	M.threads(A.threads());
+	return M;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// stationary solvers on stencil operators
+// The iterations stop when the L1 norm of the update of x drops below the tolerance,
+// as in the dense Jacobi, GaussSeidel, and sor solvers.
+
+// Jacobi: Solution of x in Ax=b using the Jacobi method, on the threads of the operator
+template<typename Scalar, size_t MAX_ITERATIONS = 100, bool traceIteration = false>
+size_t Jacobi(const stencil_operator<Scalar>& A, const vector<Scalar>& b, vector<Scalar>& x, typename stencil_operator<Scalar>::value_type tolerance = 0) {
+	using std::abs;
+	const size_t N = A.size();
+	vector<Scalar> sigma(N), diag(N);
+	for (size_t p = 0; p < N; ++p) diag[p] = A.diagonal(p);
+	Scalar residual = Scalar(std::numeric_limits<Scalar>::max());
+	size_t itr = 0;
+	while (residual > tolerance && itr < MAX_ITERATIONS) {
+		A.apply_offdiagonal(x, sigma);
+		residual = Scalar(0);
+		for (size_t p = 0; p < N; ++p) {
+			Scalar xp = (b[p] - sigma[p]) / diag[p];
+			residual += abs(x[p] - xp);
+			x[p] = xp;
+		}
+		if constexpr (traceIteration) std::cout << '[' << itr << "] residual " << residual << std::endl;
+		++itr;
+	}
+	return itr;
+}
+
+// sor: Solution of x in Ax=b using Successive Over-Relaxation, sweeping the grid in lexicographic order
+template<typename Scalar, size_t MAX_ITERATIONS = 100, bool traceIteration = false>
+size_t sor(const stencil_operator<Scalar>& A, const vector<Scalar>& b, vector<Scalar>& x, typename stencil_operator<Scalar>::value_type w, typename stencil_operator<Scalar>::value_type tolerance = Scalar(0.00001)) {
+	using std::abs;
+	Scalar residual = Scalar(std::numeric_limits<Scalar>::max());
+	const bool gaussSeidel = (w == Scalar(1));
+	size_t itr = 0;
+	while (residual > tolerance && itr < MAX_ITERATIONS) {
+		residual = Scalar(0);
+		for (size_t k = 0; k < A.nz(); ++k) {
+			for (size_t j = 0; j < A.ny(); ++j) {
+				for (size_t i = 0; i < A.nx(); ++i) {
+					size_t p = A.index(i, j, k);
+					Scalar sigma = A.offdiagonal(x, i, j, k);
+					Scalar xp = (gaussSeidel ? (b[p] - sigma) / A.diagonal(p) : (1 - w) * x[p] + w * (b[p] - sigma) / A.diagonal(p));
+					residual += abs(x[p] - xp);
+					x[p] = xp;
+				}
+			}
+		}
+		if constexpr (traceIteration) std::cout << '[' << itr << "] residual " << residual << std::endl;
+		++itr;
+	}
+	return itr;
+}
+
+// Gauss-Seidel: Solution of x in Ax=b using the Gauss-Seidel method, sweeping the grid in lexicographic order
+template<typename Scalar, size_t MAX_ITERATIONS = 100, bool traceIteration = false>
+size_t GaussSeidel(const stencil_operator<Scalar>& A, const vector<Scalar>& b, vector<Scalar>& x, typename stencil_operator<Scalar>::value_type tolerance = Scalar(0.00001)) {
+	return sor<Scalar, MAX_ITERATIONS, traceIteration>(A, b, x, Scalar(1), tolerance);
+}
+
+}}} // namespace sw::universal::blas
@@ -83,7 +83,7 @@ template<typename Working, typename Low>
 void roundReplace(blas::matrix<Working>& A, blas::matrix<Low>& Al, unsigned &n){
     /* Algo 21: round then replace infinities */
     Al = A;
-    Low maxpos(SpecificValue::maxpos);
+    Low maxpos = std::numeric_limits<Low>::max();
     for (unsigned i = 0; i < n; ++i){
         for (unsigned j = 0; j < n; ++j){
             Low sgn = (Al(i,j) > 0) ? 1 : ((Al(i,j) < 0) ? -1 : 0);
@@ -102,31 +102,36 @@ void scaleRound(blas::matrix<Working>& A,
                     Working &mu){
     /* Algo 22:  scale by scalar, then round */
     Working Amax = maxelement(A);
-    Low xmax(SpecificValue::maxpos);
-    Working Xmax(xmax);
-    
-    #define CFLOAT 0   // 0 = POSITS
-    // /** 
-    #if CFLOAT 
-        mu =(T*Xmax) / Amax;  // use for cfloats
-    #else
-        mu = T / Amax;  // use for posits
-    #endif
+    mu = T / Amax;
     
     A = mu*A;  // Scale A
     Al = A;    // Round A = fl(A)
-    // std::cout << "Al (after scaling)  = \n" << Al << std::endl;
-    // std::cout << "--------------------------------------------" << std::endl;
-    // std::cout << Xmax << "\t" << Amax << "\t  \t" << T << "\t" << mu << "\n" << std::endl;
-    /* 
-    std::cout << "A (after scaling)  = \n" << A << std::endl;
-    std::cout << "Xmax \t  Amax \t      T \t     mu " << std::endl;
-    std::cout << "--------------------------------------------" << std::endl;
-    std::cout << Xmax << "\t" << Amax << "\t  \t" << T << "\t" << mu << "\n" << std::endl;
-    */
 } // Scale and Round
 
 
+template<typename Scalar>
+void xyyEQU(blas::vector<Scalar>& R, 
+            blas::matrix<Scalar>& A, 
+            blas::vector<Scalar>& S, 
+            unsigned &n){
+    /* Algo 24: construct R and S */
+    /* Algo 24: row and column equilibration */
+    bool print = false;
+
+    getR(A,R,n);          // Lines:1-4
+    if (print){std::cout << "R = \n" << R << std::endl;}
+    
+    rowScale(R,A,n);      // Line: 5,  A is row equilibrated
+    if (print){std::cout << "RA = \n" << A << std::endl;}
+    
+    getS(A,S,n);          // Lines: 6 - 9
+    if (print){std::cout << "S = \n" << S << std::endl;}
+    
+    colScale(A,S,n);
+    if (print){std::cout << "RAS = \n" << A << std::endl;}
+} // Construct R and S
+
+
 template<typename Working, typename Low>
 void twosideScaleRound(blas::matrix<Working>& A, 
                        blas::matrix<Low>& Al, 
@@ -155,26 +160,4 @@ void twosideScaleRound(blas::matrix<Working>& A,
 } // Two-sided Scale and Round
 
 
-template<typename Scalar>
-void xyyEQU(blas::vector<Scalar>& R, 
-            blas::matrix<Scalar>& A, 
-            blas::vector<Scalar>& S, 
-            unsigned &n){
-    /* Algo 24: construct R and S */
-    /* Algo 24: row and column equilibration */
-    bool print = false;
-
-    getR(A,R,n);          // Lines:1-4
-    if (print){std::cout << "R = \n" << R << std::endl;}
-    
-    rowScale(R,A,n);      // Line: 5,  A is row equilibrated
-    if (print){std::cout << "RA = \n" << A << std::endl;}
-    
-    getS(A,S,n);          // Lines: 6 - 9
-    if (print){std::cout << "S = \n" << S << std::endl;}
-    
-    colScale(A,S,n);
-    if (print){std::cout << "RAS = \n" << A << std::endl;}
-} // Construct R and S
-
 }} // namespace
\ No newline at end of file
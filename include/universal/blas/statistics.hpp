@@ -5,9 +5,41 @@
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include <universal/blas/vector.hpp>
 
+/*
+   streaming_statistics is a one-pass accumulator of the count, mean, variance, minimum, and
+   maximum of a data stream, together with a quantile sketch and a histogram of the binary
+   scale of the values. It consumes the data once, in any number of chunks, and two
+   accumulators that have seen different chunks merge into the accumulator of the
+   concatenated data, so that a data set can be split over threads, or files, and reduced.
+
+   The mean and the variance follow Welford's update for a single value and the pairwise
+   combination of Chan, Golub, and LeVeque for a merge, computed in the Accumulator type.
+   The Accumulator is double for the number systems that are not more precise than double,
+   a posit<128, es + 1> for the posits of 33 to 64 bits, and the number system itself when it
+   is more precise than double, so that the moments are never less precise than the data.
+
+   The quantiles come from a relative-error sketch (DDSketch of Masson, Rim, and Lee): the
+   magnitudes are counted in buckets of ratio at most gamma = (1 + a) / (1 - a), so that every
+   quantile is returned with a relative error of at most a, and a merge adds the counts of
+   the buckets, which makes the merge exact and independent of the order of the chunks. The
+   bucket of a value is the linear interpolation of log2 between the powers of two, which
+   comes from the exponent and the fraction of the value instead of a call of log(), and
+   gives the binary scale of the value as well.
+
+   NaN and infinite values are counted, and propagate to the mean and the variance, as they
+   do in a direct computation, but do not enter the extremes, the sketch, or the scale histogram.
+*/
+
 namespace sw { namespace universal { namespace blas {
 
 	template<typename Scalar>
@@ -32,6 +64,271 @@ namespace sw { namespace universal { namespace blas {
 		return ostr;
 	}
 
+	// accumulation type of the moments of streaming_statistics: double, unless the Scalar is more precise
+	template<typename Scalar>
+	struct statistics_accumulator {
+		using type = std::conditional_t<(!std::numeric_limits<Scalar>::is_integer && std::numeric_limits<Scalar>::digits > std::numeric_limits<double>::digits), Scalar, double>;
+	};
+	template<unsigned nbits, unsigned es>
+	struct statistics_accumulator< posit<nbits, es> > {
+		using type = std::conditional_t<(nbits <= 32), double, std::conditional_t<(nbits <= 64), posit<128, es + 1>, posit<nbits, es>>>;
+	};
+	template<typename Scalar>
+	using statistics_accumulator_t = typename statistics_accumulator<Scalar>::type;
+
+	/// <summary>
+	/// counts indexed by an integer key, stored densely between the smallest and the largest key
+	/// </summary>
+	class bucket_store {
+	public:
+		void add(int key, size_t count = 1) {
+			if (_counts.empty()) {
+				_offset = key;
+				_counts.assign(1, 0);
+			}
+			else if (key < _offset) {
+				_counts.insert(_counts.begin(), size_t(_offset - key), 0);
+				_offset = key;
+			}
+			else if (key >= _offset + int(_counts.size())) {
+				_counts.resize(size_t(key - _offset) + 1, 0);
+			}
+			_counts[size_t(key - _offset)] += count;
+		}
+		void merge(const bucket_store& rhs) {
+			for (size_t i = 0; i < rhs._counts.size(); ++i) {
+				if (rhs._counts[i] != 0) add(rhs._offset + int(i), rhs._counts[i]);
+			}
+		}
+		bool empty() const noexcept { return _counts.empty(); }
+		int min_key() const noexcept { return _offset; }
+		int max_key() const noexcept { return _offset + int(_counts.size()) - 1; }
+		size_t operator[](int key) const noexcept {
+			return (key < _offset || key > max_key()) ? 0 : _counts[size_t(key - _offset)];
+		}
+	private:
+		int _offset{ 0 };
+		std::vector<size_t> _counts;
+	};
+
+	/// <summary>
+	/// mergeable quantile sketch with relative accuracy a: quantile(q) is within a factor (1 +- a) of the q-quantile of the data
+	/// </summary>
+	class quantile_sketch {
+	public:
+		explicit quantile_sketch(double relativeAccuracy = 0.01) : _alpha{ relativeAccuracy }, _zeros{ 0 }, _count{ 0 } {
+			if (!(_alpha > 0.0 && _alpha < 1.0)) throw std::runtime_error("quantile_sketch: relative accuracy must be in (0, 1)");
+			_gamma = (1.0 + _alpha) / (1.0 - _alpha);
+			_multiplier = 1.0 / std::log(_gamma);
+		}
+
+		void insert(double v) {
+			int exponent;
+			insert(v, std::frexp(v, &exponent), exponent);
+		}
+		// insert a value of which the caller has the fraction and the exponent of std::frexp
+		void insert(double v, double fraction, int exponent) {
+			++_count;
+			if (v > 0.0) _positive.add(key(fraction, exponent));
+			else if (v < 0.0) _negative.add(key(-fraction, exponent));
+			else ++_zeros;
+		}
+		void merge(const quantile_sketch& rhs) {
+			if (rhs._alpha != _alpha) throw std::runtime_error("quantile_sketch: cannot merge sketches of different accuracy");
+			_positive.merge(rhs._positive);
+			_negative.merge(rhs._negative);
+			_zeros += rhs._zeros;
+			_count += rhs._count;
+		}
+
+		size_t count() const noexcept { return _count; }
+		double relative_accuracy() const noexcept { return _alpha; }
+
+		// the value of rank q * (count - 1) in the sorted data, 0 <= q <= 1
+		double quantile(double q) const {
+			if (_count == 0) return std::numeric_limits<double>::quiet_NaN();
+			q = std::clamp(q, 0.0, 1.0);
+			double rank = q * double(_count - 1);
+			size_t cumulative = 0;
+			if (!_negative.empty()) {
+				for (int k = _negative.max_key(); k >= _negative.min_key(); --k) {
+					cumulative += _negative[k];
+					if (double(cumulative) > rank) return -value(k);
+				}
+			}
+			cumulative += _zeros;
+			if (double(cumulative) > rank) return 0.0;
+			for (int k = _positive.min_key(); k <= _positive.max_key(); ++k) {
+				cumulative += _positive[k];
+				if (double(cumulative) > rank) return value(k);
+			}
+			return value(_positive.max_key());
+		}
+
+	private:
+		double _alpha, _gamma, _multiplier;
+		bucket_store _positive, _negative;  // buckets of the magnitudes of the positive and negative values
+		size_t _zeros, _count;
+
+		// the magnitude f * 2^e, f in [0.5, 1), maps to l = e - 2 + 2f, which interpolates log2 linearly between the powers of two:
+		// dl / dln(magnitude) = 2f is at least 1, so the buckets of width 1 / ln(gamma) in l are at most a ratio gamma wide
+		// bucket k holds the magnitudes with l in ((k - 1) / multiplier, k / multiplier]
+		int key(double fraction, int exponent) const { return int(std::ceil((double(exponent) - 2.0 + 2.0 * fraction) * _multiplier)); }
+		// the magnitude of l
+		static double magnitude(double l) {
+			double e = std::floor(l);
+			return std::ldexp(1.0 + (l - e), int(e));
+		}
+		// the representative of bucket k, which is within a relative distance alpha of all values of the bucket
+		double value(int k) const {
+			double lo = magnitude(double(k - 1) / _multiplier), hi = magnitude(double(k) / _multiplier);
+			return 2.0 * lo * hi / (lo + hi);
+		}
+	};
+
+	/// <summary>
+	/// one-pass, mergeable accumulator of the summary statistics of a data stream
+	/// </summary>
+	template<typename Scalar, typename Accumulator = statistics_accumulator_t<Scalar>>
+	class streaming_statistics {
+	public:
+		using value_type = Scalar;
+		using accumulator_type = Accumulator;
+
+		explicit streaming_statistics(double relativeAccuracy = 0.01) : _sketch(relativeAccuracy) {}
+
+		void push(const Scalar& x) {
+			double v = double(x);
+			if (!std::isfinite(v)) {
+				++_nonfinite;
+				_nonfiniteSum += Accumulator(x);  // propagates to the mean and the variance
+				return;
+			}
+			if (_count == 0) {
+				_min = x;
+				_max = x;
+			}
+			else {
+				if (x < _min) _min = x;
+				if (x > _max) _max = x;
+			}
+			++_count;
+			Accumulator a(x);
+			Accumulator delta = a - _mean;
+			_mean += delta / Accumulator(double(_count));
+			_m2 += delta * (a - _mean);
+			int exponent;
+			double fraction = std::frexp(v, &exponent);
+			_sketch.insert(v, fraction, exponent);
+			if (v == 0.0) ++_zeros; else _scales.add(exponent - 1);
+		}
+		template<typename Iterator>
+		void push(Iterator first, Iterator last) {
+			for (; first != last; ++first) push(Scalar(*first));
+		}
+
+		// combine with the statistics of another chunk of the data
+		void merge(const streaming_statistics& rhs) {
+			if (rhs._count > 0) {
+				if (_count == 0) {
+					_mean = rhs._mean;
+					_m2 = rhs._m2;
+					_min = rhs._min;
+					_max = rhs._max;
+				}
+				else {
+					Accumulator na{ double(_count) }, nb{ double(rhs._count) }, n{ double(_count + rhs._count) };
+					Accumulator delta = rhs._mean - _mean;
+					_mean += delta * nb / n;
+					_m2 += rhs._m2 + delta * delta * na * nb / n;
+					if (rhs._min < _min) _min = rhs._min;
+					if (rhs._max > _max) _max = rhs._max;
+				}
+			}
+			_count += rhs._count;
+			_nonfinite += rhs._nonfinite;
+			_nonfiniteSum += rhs._nonfiniteSum;
+			_zeros += rhs._zeros;
+			_sketch.merge(rhs._sketch);
+			_scales.merge(rhs._scales);
+		}
+
+		size_t count() const noexcept { return _count; }           // number of finite values, the moments are of all values
+		size_t nonfinite() const noexcept { return _nonfinite; }   // number of NaN and infinite values
+		size_t zeros() const noexcept { return _zeros; }
+		Accumulator mean() const noexcept { return _nonfinite > 0 ? Accumulator(_mean + _nonfiniteSum) : _mean; }
+		Accumulator variance() const {  // population variance
+			if (_nonfinite > 0) return Accumulator(_nonfiniteSum - _nonfiniteSum);  // NaN
+			return _count > 0 ? _m2 / Accumulator(double(_count)) : Accumulator(0);
+		}
+		Accumulator sample_variance() const {
+			if (_nonfinite > 0) return Accumulator(_nonfiniteSum - _nonfiniteSum);
+			return _count > 1 ? _m2 / Accumulator(double(_count - 1)) : Accumulator(0);
+		}
+		Accumulator stddev() const { using std::sqrt; return sqrt(sample_variance()); }
+		Scalar min() const noexcept { return _min; }
+		Scalar max() const noexcept { return _max; }
+		// largest magnitude of the data, which sets the scale of a quantization
+		Scalar amax() const noexcept { return (_count == 0 || -_min < _max) ? _max : Scalar(-_min); }
+		double quantile(double q) const { return _sketch.quantile(q); }
+		const quantile_sketch& sketch() const noexcept { return _sketch; }
+
+		// number of nonzero values with binary scale s, that is, 2^s <= |x| < 2^(s+1)
+		size_t scale_count(int s) const noexcept { return _scales[s]; }
+		// smallest and largest binary scale of the nonzero values
+		std::pair<int, int> scale_range() const noexcept { return std::pair(_scales.min_key(), _scales.max_key()); }
+
+	private:
+		size_t      _count{ 0 }, _nonfinite{ 0 }, _zeros{ 0 };
+		Accumulator _mean{ 0 }, _m2{ 0 }, _nonfiniteSum{ 0 };
+		Scalar      _min{ 0 }, _max{ 0 };
+		quantile_sketch _sketch;
+		bucket_store    _scales;
+	};
+
+	template<typename Scalar, typename Accumulator>
+	std::ostream& operator<<(std::ostream& ostr, const streaming_statistics<Scalar, Accumulator>& stats) {
+		ostr << "count    : " << stats.count() << " (" << stats.nonfinite() << " nonfinite)\n";
+		ostr << "mean     : " << stats.mean() << '\n';
+		ostr << "stddev   : " << stats.stddev() << '\n';
+		ostr << "range    : [ " << stats.min() << ", " << stats.max() << "]\n";
+		ostr << "quartiles: [ " << stats.quantile(0.25) << ", " << stats.quantile(0.5) << ", " << stats.quantile(0.75) << "]\n";
+		if (stats.count() > stats.zeros()) {
+			std::pair<int, int> scales = stats.scale_range();
+			ostr << "scales   : [ " << scales.first << ", " << scales.second << "]\n";
+		}
+		return ostr;
+	}
+
+	/// <summary>
+	/// statistics of a data set in a single pass, split over nrThreads threads whose statistics are merged
+	/// </summary>
+	/// <param name="data">vector of the data</param>
+	/// <param name="nrThreads">number of threads, 0 selects the hardware concurrency</param>
+	/// <param name="relativeAccuracy">relative accuracy of the quantiles</param>
+	template<typename Vector, typename Accumulator = statistics_accumulator_t<typename Vector::value_type>>
+	streaming_statistics<typename Vector::value_type, Accumulator> streamingStatistics(const Vector& data, unsigned nrThreads = 1, double relativeAccuracy = 0.01) {
+		using Scalar = typename Vector::value_type;
+		if (nrThreads == 0) nrThreads = std::max(1u, std::thread::hardware_concurrency());
+		const size_t N = size(data);
+		if (N < 2 * size_t(nrThreads)) nrThreads = 1;
+		std::vector< streaming_statistics<Scalar, Accumulator> > partial(nrThreads, streaming_statistics<Scalar, Accumulator>(relativeAccuracy));
+		auto chunk = [&](unsigned t) {
+			size_t first = N * t / nrThreads, last = N * (t + 1) / nrThreads;
+			for (size_t i = first; i < last; ++i) partial[t].push(data[i]);
+		};
+		if (nrThreads == 1) {
+			chunk(0);
+		}
+		else {
+			std::vector<std::thread> threads;
+			for (unsigned t = 0; t < nrThreads; ++t) threads.emplace_back(chunk, t);
+			for (auto& t : threads) t.join();
+		}
+		for (unsigned t = 1; t < nrThreads; ++t) partial[0].merge(partial[t]);
+		return partial[0];
+	}
+
 	template<typename Vector>
 	SummaryStats<typename Vector::value_type> summaryStatistics(const Vector& data) {
 		using std::isnan;
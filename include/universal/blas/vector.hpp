@@ -13,6 +13,7 @@
 // special number system definitions
 #include <universal/number/posit/posit_fwd.hpp>
 #include <universal/traits/posit_traits.hpp>
+#include <universal/blas/expression.hpp>
 
 #if defined(__clang__)
 /* Clang/LLVM. ---------------------------------------------- */
@@ -58,7 +59,7 @@ namespace sw { namespace universal { namespace blas {
 
 // a column vector
 template<typename Scalar>
-class vector {
+class vector : public vector_expression<vector<Scalar>> {
 public:
 	typedef Scalar                            value_type;
 	typedef const value_type&                 const_reference;
@@ -82,6 +83,13 @@ public:
 			data[i] = Scalar(v(i));
 		}
 	}
+	// evaluate an element-wise expression
+	template<typename Expression>
+	vector(const vector_expression<Expression>& e) : data(e.self().size()) {
+		for (size_t i = 0; i < size(); ++i) {
+			data[i] = Scalar(e.self()[i]);
+		}
+	}
 	vector(const vector& v) = default;
 	vector(vector&& v) = default;
 
@@ -94,6 +102,16 @@ public:
 		}
 		return *this;
 	}
+	// evaluate an element-wise expression in a single pass: the expression may reference this vector
+	template<typename Expression>
+	vector& operator=(const vector_expression<Expression>& e) {
+		const Expression& expr = e.self();
+		if (expr.size() != size()) data.resize(expr.size());
+		for (size_t i = 0; i < size(); ++i) {
+			data[i] = Scalar(expr[i]);
+		}
+		return *this;
+	}
 
 // operators
 	vector& operator=(const Scalar& val) {
@@ -135,16 +153,20 @@ public:
 	}
 
 	// element-wise add
-	vector& operator+=(const vector<Scalar>& offset) {
+	template<typename Expression>
+	vector& operator+=(const vector_expression<Expression>& offset) {
+		const Expression& expr = offset.self();
 		for (size_t i = 0; i < size(); ++i) {
-			data[i] += offset[i];
+			data[i] += expr[i];
 		}
 		return *this;
 	}
 	// element-wise subtract
-	vector& operator-=(const vector<Scalar>& offset) {
+	template<typename Expression>
+	vector& operator-=(const vector_expression<Expression>& offset) {
+		const Expression& expr = offset.self();
 		for (size_t i = 0; i < size(); ++i) {
-			data[i] -= offset[i];
+			data[i] -= expr[i];
 		}
 		return *this;
 	}
@@ -179,6 +201,7 @@ public:
 
 	// inf-norm of a vector
 	Scalar infnorm() const {  // default is 2-norm
+		using std::abs;
 		Scalar infNorm = 0;
 		for (auto v : data) infNorm = (abs(v)>infNorm) ? abs(v) : infNorm;
 		return infNorm;
@@ -262,6 +285,12 @@ std::ostream& operator<<(std::ostream& ostr, const vector<Scalar>& v) {
 	return ostr;
 }
 
+// print a vector expression: the expression is evaluated first
+template<typename Expression>
+std::ostream& operator<<(std::ostream& ostr, const vector_expression<Expression>& e) {
+	return ostr << expression_detail::evaluate(e);
+}
+
 // serialization operators
 
 template<typename Scalar>
@@ -347,6 +376,8 @@ vector<Scalar> operator/(const vector<Scalar>& v, const int normalizer) {
 	return normalized /= Scalar(normalizer);
 }
 
+// the operators of lazy(x) operands are expression templates: see expression.hpp
+
 template<typename Scalar> auto size(const vector<Scalar>& v) { return v.size(); }
 
 // this design does not work well for universal as we would need to create
@@ -405,6 +436,12 @@ Scalar operator*(const vector<Scalar>& a, const vector<Scalar>& b) {
 	return sum;
 }
 
+// dot product of vector expressions: the operands are evaluated first
+template<typename Lhs, typename Rhs>
+auto operator*(const vector_expression<Lhs>& a, const vector_expression<Rhs>& b) {
+	return expression_detail::evaluate(a) * expression_detail::evaluate(b);
+}
+
 // fused dot product for posits
 template<unsigned nbits, unsigned es>
 posit<nbits, es> operator*(const vector< posit<nbits, es> >& a, const vector< posit<nbits, es> >& b) {
@@ -0,0 +1,92 @@
+#pragma once
+// accumulator.hpp: multiply-accumulate units of the DSP kernels
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+#include <type_traits>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/quire/fdp.hpp>
+
+// compilation flags
+// DSP_FUSED_DOT_PRODUCT
+// when set the filters accumulate posits in their quire and cfloat, fixpnt, lns, and bfloat16 in a Kulisch quire
+#ifndef DSP_FUSED_DOT_PRODUCT
+#define DSP_FUSED_DOT_PRODUCT 1
+#endif
+
+namespace sw { namespace universal { namespace dsp {
+
+/// <summary>
+/// round a coefficient, filter tap, or twiddle factor to its storage type Coef,
+/// and convert the result to the Sample type in which the kernels compute
+/// </summary>
+template<typename Sample, typename Coef>
+Sample coefficient_cast(double v) {
+	if constexpr (std::is_same_v<Sample, Coef>) {
+		return Sample(v);
+	}
+	else {
+		return Sample(double(Coef(v)));
+	}
+}
+
+/// <summary>
+/// mac_accumulator computes a sum of products. The default accumulates in the Sample type,
+/// rounding after every multiply and add.
+/// </summary>
+template<typename Sample, typename = void>
+class mac_accumulator {
+public:
+	static constexpr bool fused = false;
+
+	void clear() noexcept { _sum = Sample(0); }
+	void mac(const Sample& a, const Sample& b) { _sum += a * b; }
+	Sample value() const { return _sum; }
+
+private:
+	Sample _sum{ 0 };
+};
+
+// posits accumulate unrounded products in their quire
+template<typename Sample>
+class mac_accumulator<Sample, std::enable_if_t<DSP_FUSED_DOT_PRODUCT && is_posit<Sample>>> {
+public:
+	static constexpr bool fused = true;
+
+	void clear() { _q.clear(); }
+	void mac(const Sample& a, const Sample& b) { _q += quire_mul(a, b); }
+	Sample value() const {
+		Sample v;
+		convert(_q.to_value(), v);   // one and only rounding step
+		return v;
+	}
+
+private:
+	quire<Sample::nbits, Sample::es, 20> _q;   // supports sums of up to 1M products
+};
+
+// cfloat, fixpnt, lns, and bfloat16 accumulate unrounded products in a Kulisch quire
+template<typename Sample>
+class mac_accumulator<Sample, std::enable_if_t<DSP_FUSED_DOT_PRODUCT && is_kulisch_enabled<Sample>>> {
+public:
+	static constexpr bool fused = true;
+
+	void clear() noexcept { _q.clear(); }
+	void mac(const Sample& a, const Sample& b) { _q += quire_mul(a, b); }
+	Sample value() const { return _q.to_value(); }   // one and only rounding step
+
+private:
+	kulisch_quire<Sample> _q;
+};
+
+// dot product of two contiguous sample sequences
+template<typename Sample>
+Sample dot(mac_accumulator<Sample>& acc, const Sample* a, const Sample* b, size_t n) {
+	acc.clear();
+	for (size_t i = 0; i < n; ++i) acc.mac(a[i], b[i]);
+	return acc.value();
+}
+
+}}} // namespace sw::universal::dsp
@@ -0,0 +1,19 @@
+// dsp.hpp: top-level include for the Universal DSP library
+//
+// Streaming signal processing kernels, templated on the sample type, that
+// operate on preallocated buffers: FIR filters, polyphase decimators and
+// interpolators, biquad IIR cascades, and a radix-2/4 FFT.
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#ifndef _UNIVERSAL_DSP_LIBRARY
+#define _UNIVERSAL_DSP_LIBRARY
+
+#include <universal/dsp/ring_buffer.hpp>
+#include <universal/dsp/accumulator.hpp>
+#include <universal/dsp/fir.hpp>
+#include <universal/dsp/iir.hpp>
+#include <universal/dsp/fft.hpp>
+
+#endif // _UNIVERSAL_DSP_LIBRARY
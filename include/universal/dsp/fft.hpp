@@ -0,0 +1,133 @@
+#pragma once
+// fft.hpp: radix-2/4 fast Fourier transform templated on the sample and twiddle types
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <universal/dsp/accumulator.hpp>
+
+/*
+   The transform is an in-place decimation-in-time FFT of a power of two length N. After the
+   bit-reversal permutation, pairs of radix-2 stages are fused into radix-4 passes: a radix-4
+   butterfly needs three twiddle multiplications, where the two radix-2 stages it replaces
+   need four, and its fourth twiddle is a multiplication by -i, which is a swap of the real and
+   imaginary parts. An odd number of stages starts with a twiddle-free radix-2 pass.
+
+   The twiddle factors are rounded to the Twiddle type and held in the Sample type, so that the
+   butterflies do not convert. The permutation and the twiddle table are computed once, at
+   construction: the transforms do not allocate.
+*/
+
+namespace sw { namespace universal { namespace dsp {
+
+/// <summary>
+/// fft computes the forward transform X[k] = sum_n x[n] e^(-2 pi i n k / N) and its inverse,
+/// which includes the 1/N scaling
+/// </summary>
+/// <typeparam name="Sample">type of the real and imaginary parts of the samples, and of the arithmetic</typeparam>
+/// <typeparam name="Twiddle">type that the twiddle factors are rounded to</typeparam>
+template<typename Sample, typename Twiddle = Sample>
+class fft {
+public:
+	using sample_type  = Sample;
+	using twiddle_type = Twiddle;
+	using complex_type = std::complex<Sample>;
+
+	explicit fft(size_t N) : _N{ N }, _log2N{ 0 }, _cos(N), _sin(N), _bitrev(N) {
+		if (N == 0 || (N & (N - 1)) != 0) throw std::invalid_argument("fft length must be a power of 2");
+		while ((size_t(1) << _log2N) < N) ++_log2N;
+		constexpr double pi = 3.14159265358979323846;
+		for (size_t k = 0; k < N; ++k) {
+			double angle = 2.0 * pi * static_cast<double>(k) / static_cast<double>(N);
+			_cos[k] = coefficient_cast<Sample, Twiddle>(std::cos(angle));
+			_sin[k] = coefficient_cast<Sample, Twiddle>(std::sin(angle));
+			size_t r{ 0 };
+			for (unsigned b = 0; b < _log2N; ++b) if (k & (size_t(1) << b)) r |= size_t(1) << (_log2N - 1 - b);
+			_bitrev[k] = r;
+		}
+	}
+
+	size_t size() const noexcept { return _N; }
+
+	// in-place forward transform of N samples
+	void forward(complex_type* x) const { transform<false>(x); }
+	// in-place inverse transform of N samples
+	void inverse(complex_type* x) const {
+		transform<true>(x);
+		Sample scale = Sample(1.0 / static_cast<double>(_N));
+		for (size_t i = 0; i < _N; ++i) x[i] = complex_type(x[i].real() * scale, x[i].imag() * scale);
+	}
+
+	void forward(std::vector<complex_type>& x) const { if (x.size() != _N) throw std::invalid_argument("fft length mismatch"); forward(x.data()); }
+	void inverse(std::vector<complex_type>& x) const { if (x.size() != _N) throw std::invalid_argument("fft length mismatch"); inverse(x.data()); }
+
+private:
+	size_t              _N;
+	unsigned            _log2N;
+	std::vector<Sample> _cos, _sin;   // W_N^k = cos(2 pi k / N) - i sin(2 pi k / N)
+	std::vector<size_t> _bitrev;
+
+	// a * W^k, or a * conj(W^k) for the inverse transform
+	template<bool inv>
+	void twiddle(Sample& re, Sample& im, size_t k) const {
+		const Sample& c = _cos[k];
+		const Sample& s = _sin[k];
+		Sample r = (inv ? re * c - im * s : re * c + im * s);
+		im = (inv ? im * c + re * s : im * c - re * s);
+		re = r;
+	}
+
+	template<bool inv>
+	void transform(complex_type* x) const {
+		for (size_t i = 0; i < _N; ++i) {
+			size_t j = _bitrev[i];
+			if (i < j) std::swap(x[i], x[j]);
+		}
+
+		size_t m = 1;   // length of the sub-transforms that are combined by the next pass
+		if (_log2N & 1u) {
+			for (size_t i = 0; i < _N; i += 2) {
+				Sample ar = x[i].real(), ai = x[i].imag(), br = x[i + 1].real(), bi = x[i + 1].imag();
+				x[i]     = complex_type(ar + br, ai + bi);
+				x[i + 1] = complex_type(ar - br, ai - bi);
+			}
+			m = 2;
+		}
+		for (; 4 * m <= _N; m *= 4) {
+			size_t stride = _N / (4 * m);
+			for (size_t base = 0; base < _N; base += 4 * m) {
+				for (size_t j = 0; j < m; ++j) {
+					complex_type* p = x + base + j;
+					Sample a0r = p[0].real(),     a0i = p[0].imag();
+					Sample a1r = p[m].real(),     a1i = p[m].imag();
+					Sample a2r = p[2 * m].real(), a2i = p[2 * m].imag();
+					Sample a3r = p[3 * m].real(), a3i = p[3 * m].imag();
+					if (j > 0) {
+						size_t k = j * stride;
+						twiddle<inv>(a1r, a1i, 2 * k);
+						twiddle<inv>(a2r, a2i, k);
+						twiddle<inv>(a3r, a3i, 3 * k);
+					}
+					Sample u0r = a0r + a1r, u0i = a0i + a1i;
+					Sample u1r = a0r - a1r, u1i = a0i - a1i;
+					Sample t2r = a2r + a3r, t2i = a2i + a3i;
+					Sample t3r = a2r - a3r, t3i = a2i - a3i;
+					// multiply t3 by -i for the forward, and by +i for the inverse transform
+					Sample v3r = (inv ? -t3i : t3i), v3i = (inv ? t3r : -t3r);
+					p[0]     = complex_type(u0r + t2r, u0i + t2i);
+					p[2 * m] = complex_type(u0r - t2r, u0i - t2i);
+					p[m]     = complex_type(u1r + v3r, u1i + v3i);
+					p[3 * m] = complex_type(u1r - v3r, u1i - v3i);
+				}
+			}
+		}
+	}
+};
+
+}}} // namespace sw::universal::dsp
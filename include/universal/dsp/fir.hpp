@@ -0,0 +1,172 @@
+#pragma once
+// fir.hpp: block-streaming finite impulse response filters, decimators, and interpolators
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <universal/dsp/ring_buffer.hpp>
+#include <universal/dsp/accumulator.hpp>
+
+/*
+   The filters store their taps in reverse order next to a delay_line, so that every output
+   is a single dot product of two contiguous sequences, computed by the mac_accumulator of the
+   Sample type. The taps are rounded to the Coef type and held in the Sample type, which is
+   the type in which the kernels compute. All storage is allocated at construction: the
+   process() calls do not allocate.
+*/
+
+namespace sw { namespace universal { namespace dsp {
+
+/// <summary>
+/// windowed-sinc lowpass design with a Hamming window, normalized to unit DC gain
+/// </summary>
+/// <param name="nrTaps">number of taps</param>
+/// <param name="cutoff">cutoff frequency as a fraction of the sample rate, in (0, 0.5)</param>
+/// <returns>filter taps</returns>
+inline std::vector<double> fir_lowpass(size_t nrTaps, double cutoff) {
+	constexpr double pi = 3.14159265358979323846;
+	std::vector<double> h(nrTaps);
+	double center = 0.5 * static_cast<double>(nrTaps - 1);
+	double sum{ 0.0 };
+	for (size_t i = 0; i < nrTaps; ++i) {
+		double t = static_cast<double>(i) - center;
+		double sinc = (t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * t) / (pi * t));
+		double window = (nrTaps > 1 ? 0.54 - 0.46 * std::cos(2.0 * pi * static_cast<double>(i) / static_cast<double>(nrTaps - 1)) : 1.0);
+		h[i] = sinc * window;
+		sum += h[i];
+	}
+	for (auto& v : h) v /= sum;
+	return h;
+}
+
+/// <summary>
+/// fir_filter computes y[n] = sum_k h[k] * x[n - k]
+/// </summary>
+/// <typeparam name="Sample">type of the samples and of the arithmetic</typeparam>
+/// <typeparam name="Coef">type that the taps are rounded to</typeparam>
+template<typename Sample, typename Coef = Sample>
+class fir_filter {
+public:
+	using sample_type = Sample;
+	using coef_type   = Coef;
+
+	explicit fir_filter(const std::vector<double>& taps) : _taps(taps.size()), _history(taps.size()) {
+		size_t n = taps.size();
+		for (size_t k = 0; k < n; ++k) _taps[n - 1 - k] = coefficient_cast<Sample, Coef>(taps[k]);
+	}
+
+	size_t length() const noexcept { return _taps.size(); }
+	void reset() noexcept { _history.clear(); }
+
+	// filter a single sample
+	Sample process(const Sample& x) {
+		_history.push(x);
+		return dot(_acc, _taps.data(), _history.window(), _taps.size());
+	}
+	// filter a block of n samples, in and out may be the same buffer
+	void process(const Sample* in, Sample* out, size_t n) {
+		for (size_t i = 0; i < n; ++i) out[i] = process(in[i]);
+	}
+
+private:
+	std::vector<Sample>     _taps;     // taps in reverse order
+	delay_line<Sample>      _history;
+	mac_accumulator<Sample> _acc;
+};
+
+/// <summary>
+/// fir_decimator filters and downsamples by an integer factor. Only the outputs that are
+/// kept are computed, which is the work of the polyphase decomposition of the filter:
+/// one multiply-accumulate per tap per output sample.
+/// </summary>
+/// <typeparam name="Sample">type of the samples and of the arithmetic</typeparam>
+/// <typeparam name="Coef">type that the taps are rounded to</typeparam>
+template<typename Sample, typename Coef = Sample>
+class fir_decimator {
+public:
+	using sample_type = Sample;
+	using coef_type   = Coef;
+
+	fir_decimator(const std::vector<double>& taps, size_t factor)
+		: _taps(taps.size()), _history(taps.size()), _factor{ factor > 0 ? factor : 1 }, _phase{ 0 } {
+		size_t n = taps.size();
+		for (size_t k = 0; k < n; ++k) _taps[n - 1 - k] = coefficient_cast<Sample, Coef>(taps[k]);
+	}
+
+	size_t length() const noexcept { return _taps.size(); }
+	size_t factor() const noexcept { return _factor; }
+	void reset() noexcept { _history.clear(); _phase = 0; }
+
+	// consume n input samples, write at most n / factor() + 1 output samples, returns the number of outputs
+	size_t process(const Sample* in, Sample* out, size_t n) {
+		size_t nrOutputs{ 0 };
+		for (size_t i = 0; i < n; ++i) {
+			_history.push(in[i]);
+			if (_phase == 0) out[nrOutputs++] = dot(_acc, _taps.data(), _history.window(), _taps.size());
+			if (++_phase == _factor) _phase = 0;
+		}
+		return nrOutputs;
+	}
+
+private:
+	std::vector<Sample>     _taps;     // taps in reverse order
+	delay_line<Sample>      _history;
+	mac_accumulator<Sample> _acc;
+	size_t                  _factor;
+	size_t                  _phase;    // position of the next input within the decimation period
+};
+
+/// <summary>
+/// fir_interpolator upsamples by an integer factor L and filters, through the polyphase
+/// decomposition of the taps into L subfilters p_k[m] = h[m * L + k]: every input sample
+/// produces L outputs y[n * L + k] = sum_m p_k[m] * x[n - m], so the zeros that are
+/// inserted by the upsampler are never multiplied. The passband gain of the taps should
+/// be L to preserve the signal amplitude.
+/// </summary>
+/// <typeparam name="Sample">type of the samples and of the arithmetic</typeparam>
+/// <typeparam name="Coef">type that the taps are rounded to</typeparam>
+template<typename Sample, typename Coef = Sample>
+class fir_interpolator {
+public:
+	using sample_type = Sample;
+	using coef_type   = Coef;
+
+	fir_interpolator(const std::vector<double>& taps, size_t factor)
+		: _factor{ factor > 0 ? factor : 1 }, _phaseLength{ (taps.size() + _factor - 1) / _factor },
+		_phases(_factor * _phaseLength, Sample(0)), _history(_phaseLength) {
+		for (size_t k = 0; k < _factor; ++k) {
+			Sample* p = _phases.data() + k * _phaseLength;
+			for (size_t m = 0; m < _phaseLength; ++m) {
+				size_t i = m * _factor + k;
+				if (i < taps.size()) p[_phaseLength - 1 - m] = coefficient_cast<Sample, Coef>(taps[i]);
+			}
+		}
+	}
+
+	size_t length() const noexcept { return _phases.size(); }
+	size_t factor() const noexcept { return _factor; }
+	void reset() noexcept { _history.clear(); }
+
+	// consume n input samples and write n * factor() output samples
+	void process(const Sample* in, Sample* out, size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			_history.push(in[i]);
+			const Sample* window = _history.window();
+			for (size_t k = 0; k < _factor; ++k) {
+				*out++ = dot(_acc, _phases.data() + k * _phaseLength, window, _phaseLength);
+			}
+		}
+	}
+
+private:
+	size_t                  _factor;
+	size_t                  _phaseLength;  // taps per subfilter
+	std::vector<Sample>     _phases;       // subfilters, each in reverse order
+	delay_line<Sample>      _history;
+	mac_accumulator<Sample> _acc;
+};
+
+}}} // namespace sw::universal::dsp
@@ -0,0 +1,108 @@
+#pragma once
+// iir.hpp: cascades of second-order infinite impulse response sections
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <universal/dsp/accumulator.hpp>
+
+namespace sw { namespace universal { namespace dsp {
+
+/// <summary>
+/// coefficients of the section H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+/// </summary>
+struct biquad_coefficients {
+	double b0, b1, b2, a1, a2;
+};
+
+// second-order lowpass with cutoff fc and quality factor Q, from the audio EQ cookbook of R. Bristow-Johnson
+inline biquad_coefficients biquad_lowpass(double fc, double fs, double Q = 0.70710678118654752440) {
+	constexpr double pi = 3.14159265358979323846;
+	double w0 = 2.0 * pi * fc / fs;
+	double alpha = std::sin(w0) / (2.0 * Q);
+	double cosw0 = std::cos(w0);
+	double a0 = 1.0 + alpha;
+	return { (1.0 - cosw0) / (2.0 * a0), (1.0 - cosw0) / a0, (1.0 - cosw0) / (2.0 * a0), -2.0 * cosw0 / a0, (1.0 - alpha) / a0 };
+}
+
+// second-order highpass with cutoff fc and quality factor Q
+inline biquad_coefficients biquad_highpass(double fc, double fs, double Q = 0.70710678118654752440) {
+	constexpr double pi = 3.14159265358979323846;
+	double w0 = 2.0 * pi * fc / fs;
+	double alpha = std::sin(w0) / (2.0 * Q);
+	double cosw0 = std::cos(w0);
+	double a0 = 1.0 + alpha;
+	return { (1.0 + cosw0) / (2.0 * a0), -(1.0 + cosw0) / a0, (1.0 + cosw0) / (2.0 * a0), -2.0 * cosw0 / a0, (1.0 - alpha) / a0 };
+}
+
+/// <summary>
+/// biquad_cascade filters a signal through a series of second-order sections in the
+/// transposed direct form II, which needs two state variables per section.
+/// Blocks are filtered section by section, so the coefficients and the state of a
+/// section stay in registers for the whole block.
+/// </summary>
+/// <typeparam name="Sample">type of the samples, the state, and the arithmetic</typeparam>
+/// <typeparam name="Coef">type that the coefficients are rounded to</typeparam>
+template<typename Sample, typename Coef = Sample>
+class biquad_cascade {
+public:
+	using sample_type = Sample;
+	using coef_type   = Coef;
+
+	explicit biquad_cascade(const std::vector<biquad_coefficients>& sections) : _sections(sections.size()) {
+		for (size_t i = 0; i < sections.size(); ++i) {
+			section& s = _sections[i];
+			s.b0 = coefficient_cast<Sample, Coef>(sections[i].b0);
+			s.b1 = coefficient_cast<Sample, Coef>(sections[i].b1);
+			s.b2 = coefficient_cast<Sample, Coef>(sections[i].b2);
+			s.a1 = coefficient_cast<Sample, Coef>(sections[i].a1);
+			s.a2 = coefficient_cast<Sample, Coef>(sections[i].a2);
+		}
+		reset();
+	}
+
+	size_t sections() const noexcept { return _sections.size(); }
+	void reset() noexcept {
+		for (auto& s : _sections) s.s1 = s.s2 = Sample(0);
+	}
+
+	// filter a single sample
+	Sample process(const Sample& x) {
+		Sample y = x;
+		for (auto& s : _sections) y = step(s, y);
+		return y;
+	}
+	// filter a block of n samples, in and out may be the same buffer
+	void process(const Sample* in, Sample* out, size_t n) {
+		if (_sections.empty()) {
+			for (size_t i = 0; i < n; ++i) out[i] = in[i];
+			return;
+		}
+		const Sample* src = in;
+		for (auto& s : _sections) {
+			section local = s;
+			for (size_t i = 0; i < n; ++i) out[i] = step(local, src[i]);
+			s = local;
+			src = out;
+		}
+	}
+
+private:
+	struct section {
+		Sample b0, b1, b2, a1, a2;
+		Sample s1, s2;
+	};
+	std::vector<section> _sections;
+
+	static Sample step(section& s, const Sample& x) {
+		Sample y = s.b0 * x + s.s1;
+		s.s1 = s.b1 * x - s.a1 * y + s.s2;
+		s.s2 = s.b2 * x - s.a2 * y;
+		return y;
+	}
+};
+
+}}} // namespace sw::universal::dsp
@@ -0,0 +1,114 @@
+#pragma once
+// ring_buffer.hpp: fixed capacity sample buffers for streaming signal processing
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+#include <vector>
+
+namespace sw { namespace universal { namespace dsp {
+
+/// <summary>
+/// ring_buffer is a fixed capacity FIFO of samples. The storage is allocated once at
+/// construction, so streaming a signal through the buffer does not allocate.
+/// </summary>
+/// <typeparam name="Sample">sample type</typeparam>
+template<typename Sample>
+class ring_buffer {
+public:
+	using value_type = Sample;
+
+	explicit ring_buffer(size_t capacity = 0) : _data(capacity), _head{ 0 }, _size{ 0 } {}
+
+	size_t capacity() const noexcept { return _data.size(); }
+	size_t size()     const noexcept { return _size; }
+	size_t space()    const noexcept { return _data.size() - _size; }
+	bool   empty()    const noexcept { return _size == 0; }
+	bool   full()     const noexcept { return _size == _data.size(); }
+	void   clear()          noexcept { _head = 0; _size = 0; }
+
+	// append a sample, overwrites the oldest sample when the buffer is full
+	void push(const Sample& v) noexcept {
+		if (_data.empty()) return;
+		_data[wrap(_head + _size)] = v;
+		if (_size < _data.size()) ++_size; else _head = wrap(_head + 1);
+	}
+	// remove and return the oldest sample, precondition: !empty()
+	Sample pop() noexcept {
+		Sample v = _data[_head];
+		_head = wrap(_head + 1);
+		--_size;
+		return v;
+	}
+	// append up to n samples without overwriting, returns the number of samples written
+	size_t write(const Sample* src, size_t n) noexcept {
+		if (n > space()) n = space();
+		for (size_t i = 0; i < n; ++i) _data[wrap(_head + _size + i)] = src[i];
+		_size += n;
+		return n;
+	}
+	// remove up to n of the oldest samples, returns the number of samples read
+	size_t read(Sample* dst, size_t n) noexcept {
+		if (n > _size) n = _size;
+		for (size_t i = 0; i < n; ++i) dst[i] = _data[wrap(_head + i)];
+		_head = wrap(_head + n);
+		_size -= n;
+		return n;
+	}
+
+	// i-th oldest sample
+	const Sample& operator[](size_t i) const noexcept { return _data[wrap(_head + i)]; }
+	Sample& operator[](size_t i) noexcept { return _data[wrap(_head + i)]; }
+
+private:
+	std::vector<Sample> _data;
+	size_t              _head;   // index of the oldest sample
+	size_t              _size;
+
+	// indices are less than twice the capacity
+	size_t wrap(size_t i) const noexcept { return (i >= _data.size() ? i - _data.size() : i); }
+};
+
+/// <summary>
+/// delay_line holds the most recent length() samples of a stream in a contiguous window.
+/// Each sample is stored twice, at i and at i + length(), so that the window never wraps
+/// and the dot product of a filter with the window is a straight loop.
+/// </summary>
+/// <typeparam name="Sample">sample type</typeparam>
+template<typename Sample>
+class delay_line {
+public:
+	using value_type = Sample;
+
+	explicit delay_line(size_t length = 0) : _data(2 * length, Sample(0)), _length{ length }, _pos{ 0 } {}
+
+	size_t length() const noexcept { return _length; }
+
+	// set all samples to zero
+	void clear() noexcept {
+		for (auto& v : _data) v = Sample(0);
+		_pos = 0;
+	}
+
+	// insert the newest sample, the oldest sample leaves the window
+	void push(const Sample& v) noexcept {
+		if (_length == 0) return;
+		_data[_pos] = v;
+		_data[_pos + _length] = v;
+		if (++_pos == _length) _pos = 0;
+	}
+
+	// the most recent length() samples, ordered from oldest to newest
+	const Sample* window() const noexcept { return _data.data() + _pos; }
+
+	// the sample that was pushed i samples ago, precondition: i < length()
+	const Sample& operator[](size_t i) const noexcept { return _data[_pos + _length - 1 - i]; }
+
+private:
+	std::vector<Sample> _data;
+	size_t              _length;
+	size_t              _pos;     // index where the next sample is written
+};
+
+}}} // namespace sw::universal::dsp
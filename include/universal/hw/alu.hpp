@@ -1,8 +1,16 @@
+#pragma once
 // alu.hpp: a generic module to model a hardware ALU
 //
 // Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include <universal/number/shared/specific_value_encoding.hpp>
 
 namespace sw { namespace universal {
@@ -43,6 +51,195 @@ NumberSystemType ArithmeticLogicUnit(ALU_OPS op, const NumberSystemType& a, cons
 	return c;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// batch ALU: execute an opcode stream on structure-of-arrays operands
+//
+// The scalar ArithmeticLogicUnit dispatches every operation through the switch, which
+// dominates the simulation of long operation traces. The batch interface partitions the
+// stream into chunks, sorts the operations of a chunk by opcode, and executes each opcode
+// in a tight loop without any dispatch. Chunks are independent and can be distributed
+// over multiple threads. Opcodes outside of ALU_OPS are rejected before any operation is
+// executed.
+
+// exception flags of the batch ALU, accumulated per operation and sticky for the batch
+enum ALU_FLAGS : uint8_t {
+	ALU_FLAG_NONE      = 0x00,
+	ALU_FLAG_INVALID   = 0x01,  // result is NaN or NaR
+	ALU_FLAG_INFINITE  = 0x02,  // result is +-inf
+	ALU_FLAG_DIVBYZERO = 0x04,  // division by zero
+	ALU_FLAG_ZERO      = 0x08   // result is zero
+};
+
+namespace alu_detail {
+
+	template<typename T, typename = void> struct has_isnan : std::false_type {};
+	template<typename T> struct has_isnan<T, std::void_t<decltype(std::declval<const T&>().isnan())>> : std::true_type {};
+	template<typename T, typename = void> struct has_isnar : std::false_type {};
+	template<typename T> struct has_isnar<T, std::void_t<decltype(std::declval<const T&>().isnar())>> : std::true_type {};
+	template<typename T, typename = void> struct has_isinf : std::false_type {};
+	template<typename T> struct has_isinf<T, std::void_t<decltype(std::declval<const T&>().isinf())>> : std::true_type {};
+
+	template<typename NumberSystemType>
+	inline uint8_t flags(ALU_OPS op, const NumberSystemType& b, const NumberSystemType& c) {
+		uint8_t f = ALU_FLAG_NONE;
+		if constexpr (has_isnan<NumberSystemType>::value) { if (c.isnan()) f |= ALU_FLAG_INVALID; }
+		if constexpr (has_isnar<NumberSystemType>::value) { if (c.isnar()) f |= ALU_FLAG_INVALID; }
+		if constexpr (has_isinf<NumberSystemType>::value) { if (c.isinf()) f |= ALU_FLAG_INFINITE; }
+		if (c.iszero()) f |= ALU_FLAG_ZERO;
+		if (op == ALU_OPS::DIV && b.iszero()) f |= ALU_FLAG_DIVBYZERO;
+		return f;
+	}
+
+	// execute the operations of a chunk that have opcode op, gathered through the index list
+	template<ALU_OPS op, typename NumberSystemType>
+	uint8_t execute(const uint32_t* index, size_t n, const NumberSystemType* a, const NumberSystemType* b, NumberSystemType* c, uint8_t* flags) {
+		uint8_t sticky = ALU_FLAG_NONE;
+		for (size_t k = 0; k < n; ++k) {
+			size_t i = index[k];
+			NumberSystemType r;
+			if constexpr (op == ALU_OPS::ADD)       r = a[i] + b[i];
+			else if constexpr (op == ALU_OPS::SUB)  r = a[i] - b[i];
+			else if constexpr (op == ALU_OPS::MUL)  r = a[i] * b[i];
+			else if constexpr (op == ALU_OPS::DIV)  r = a[i] / b[i];
+			else if constexpr (op == ALU_OPS::SQRT) r = sqrt(a[i]);
+			else                                    r = 0;
+			c[i] = r;
+			uint8_t f = alu_detail::flags(op, b[i], r);
+			if (flags) flags[i] = f;
+			sticky |= f;
+		}
+		return sticky;
+	}
+
+	constexpr size_t   ALU_CHUNK_SIZE = 4096;
+	constexpr unsigned ALU_NR_OPS = static_cast<unsigned>(ALU_OPS::SQRT) + 1;
+
+	// counting sort of the opcodes of a chunk followed by one tight loop per opcode
+	template<typename NumberSystemType>
+	uint8_t execute_chunk(const ALU_OPS* op, const NumberSystemType* a, const NumberSystemType* b, NumberSystemType* c, uint8_t* flags, size_t n) {
+		size_t count[ALU_NR_OPS + 1] = { 0 };
+		for (size_t i = 0; i < n; ++i) ++count[static_cast<unsigned>(op[i]) + 1u];
+		for (unsigned o = 0; o < ALU_NR_OPS; ++o) count[o + 1] += count[o];
+		uint32_t index[ALU_CHUNK_SIZE];
+		size_t fill[ALU_NR_OPS];
+		std::copy(count, count + ALU_NR_OPS, fill);
+		for (size_t i = 0; i < n; ++i) index[fill[static_cast<unsigned>(op[i])]++] = static_cast<uint32_t>(i);
+		auto segment = [&count](ALU_OPS o) { return count[static_cast<unsigned>(o)]; };
+		auto length  = [&count](ALU_OPS o) { return count[static_cast<unsigned>(o) + 1] - count[static_cast<unsigned>(o)]; };
+		uint8_t sticky = ALU_FLAG_NONE;
+		sticky |= execute<ALU_OPS::NOP> (index + segment(ALU_OPS::NOP),  length(ALU_OPS::NOP),  a, b, c, flags);
+		sticky |= execute<ALU_OPS::ADD> (index + segment(ALU_OPS::ADD),  length(ALU_OPS::ADD),  a, b, c, flags);
+		sticky |= execute<ALU_OPS::SUB> (index + segment(ALU_OPS::SUB),  length(ALU_OPS::SUB),  a, b, c, flags);
+		sticky |= execute<ALU_OPS::MUL> (index + segment(ALU_OPS::MUL),  length(ALU_OPS::MUL),  a, b, c, flags);
+		sticky |= execute<ALU_OPS::DIV> (index + segment(ALU_OPS::DIV),  length(ALU_OPS::DIV),  a, b, c, flags);
+		sticky |= execute<ALU_OPS::SQRT>(index + segment(ALU_OPS::SQRT), length(ALU_OPS::SQRT), a, b, c, flags);
+		return sticky;
+	}
+
+	// throw on the first opcode that is not an ALU_OPS
+	inline void validate(const ALU_OPS* op, size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			if (static_cast<unsigned>(op[i]) >= ALU_NR_OPS) {
+				throw std::invalid_argument("ArithmeticLogicUnit: opcode " + std::to_string(static_cast<unsigned>(op[i])) + " at position " + std::to_string(i) + " is out of range");
+			}
+		}
+	}
+
+	// distribute the chunks of a stream of n operations over nrThreads threads:
+	// worker(firstChunk, lastChunk) executes the chunks and returns their sticky flags
+	template<typename Worker>
+	uint8_t distribute(size_t n, unsigned nrThreads, const Worker& worker) {
+		size_t nrChunks = (n + ALU_CHUNK_SIZE - 1) / ALU_CHUNK_SIZE;
+		nrThreads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(nrThreads, nrChunks)));
+		if (nrThreads == 1) return worker(0, nrChunks);
+
+		std::vector<uint8_t> sticky(nrThreads, ALU_FLAG_NONE);
+		std::vector<std::thread> threads;
+		size_t chunksPerThread = nrChunks / nrThreads, remainder = nrChunks % nrThreads, first = 0;
+		for (unsigned t = 0; t < nrThreads; ++t) {
+			size_t last = first + chunksPerThread + (t < remainder ? 1 : 0);
+			threads.emplace_back([&sticky, &worker, t, first, last]() { sticky[t] = worker(first, last); });
+			first = last;
+		}
+		uint8_t result = ALU_FLAG_NONE;
+		for (unsigned t = 0; t < nrThreads; ++t) {
+			threads[t].join();
+			result |= sticky[t];
+		}
+		return result;
+	}
+
+	template<typename T, typename = void> struct has_block : std::false_type {};
+	template<typename T> struct has_block<T, std::void_t<decltype(std::declval<const T&>().block(0u))>> : std::true_type {};
+	template<typename T, typename = void> struct has_encoding : std::false_type {};
+	template<typename T> struct has_encoding<T, std::void_t<decltype(std::declval<const T&>().encoding())>> : std::true_type {};
+
+	// raw encoding of a value of a number system of at most 64 bits, assembled from its blocks
+	template<typename NumberSystemType>
+	inline uint64_t raw_bits(const NumberSystemType& v) {
+		constexpr unsigned nbits = NumberSystemType::nbits;
+		static_assert(nbits <= 64, "raw encodings require a number system of at most 64 bits");
+		uint64_t raw{ 0 };
+		if constexpr (has_block<NumberSystemType>::value) {
+			constexpr unsigned bitsInBlock = 8u * sizeof(decltype(v.block(0u)));
+			for (unsigned i = 0; i * bitsInBlock < nbits; ++i) raw |= uint64_t(v.block(i)) << (i * bitsInBlock);
+		}
+		else {
+			static_assert(has_encoding<NumberSystemType>::value, "raw encodings require a block() or encoding() accessor");
+			raw = v.encoding();
+		}
+		return (nbits < 64 ? raw & ((1ull << (nbits % 64)) - 1ull) : raw);
+	}
+
+} // namespace alu_detail
+
+/// <summary>
+/// execute the operations op[i] on the operands a[i] and b[i], writing the results to c[i]
+/// and the exception flags of each operation to flags[i] when flags is not nullptr
+/// </summary>
+/// <param name="nrThreads">number of threads to distribute the chunks of the stream over</param>
+/// <returns>the union of the exception flags of all operations</returns>
+/// <exception cref="std::invalid_argument">an opcode is not an ALU_OPS</exception>
+template<typename NumberSystemType>
+uint8_t ArithmeticLogicUnit(const ALU_OPS* op, const NumberSystemType* a, const NumberSystemType* b, NumberSystemType* c, uint8_t* flags, size_t n, unsigned nrThreads = 1) {
+	using namespace alu_detail;
+	validate(op, n);
+	return distribute(n, nrThreads, [=](size_t firstChunk, size_t lastChunk) {
+		uint8_t sticky = ALU_FLAG_NONE;
+		for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+			size_t begin = chunk * ALU_CHUNK_SIZE, length = std::min(n - begin, ALU_CHUNK_SIZE);
+			sticky |= execute_chunk(op + begin, a + begin, b + begin, c + begin, (flags ? flags + begin : nullptr), length);
+		}
+		return sticky;
+	});
+}
+
+/// <summary>
+/// execute an operation trace of raw encodings: the operands are decoded with setbits
+/// and the results are returned as raw encodings of the number system. Each thread decodes
+/// one chunk at a time into its own chunk-sized buffers.
+/// </summary>
+/// <exception cref="std::invalid_argument">an opcode is not an ALU_OPS</exception>
+template<typename NumberSystemType>
+uint8_t ArithmeticLogicUnitEncoded(const ALU_OPS* op, const uint64_t* a, const uint64_t* b, uint64_t* c, uint8_t* flags, size_t n, unsigned nrThreads = 1) {
+	using namespace alu_detail;
+	validate(op, n);
+	return distribute(n, nrThreads, [=](size_t firstChunk, size_t lastChunk) {
+		std::vector<NumberSystemType> va(ALU_CHUNK_SIZE), vb(ALU_CHUNK_SIZE), vc(ALU_CHUNK_SIZE);
+		uint8_t sticky = ALU_FLAG_NONE;
+		for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+			size_t begin = chunk * ALU_CHUNK_SIZE, length = std::min(n - begin, ALU_CHUNK_SIZE);
+			for (size_t i = 0; i < length; ++i) {
+				va[i].setbits(a[begin + i]);
+				vb[i].setbits(b[begin + i]);
+			}
+			sticky |= execute_chunk(op + begin, va.data(), vb.data(), vc.data(), (flags ? flags + begin : nullptr), length);
+			for (size_t i = 0; i < length; ++i) c[begin + i] = raw_bits(vc[i]);
+		}
+		return sticky;
+	});
+}
+
 template<typename Real>
 void ExecuteOp(const std::string& op, float fa, float fb) {
 	Real a, b, c;
@@ -15,6 +15,7 @@
 #define LONG_DOUBLE_SUPPORT 0
 #endif
 #include <universal/number/shared/specific_value_encoding.hpp>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
 
 namespace sw { namespace universal {
 
@@ -82,11 +83,9 @@ void truncate(const blockbinary<srcbits, bt, nt>& src, blockbinary<tgtbits, bt,
 NOTES
 
 for block arithmetic, we need to manage a carry bit.
-This disqualifies using uint64_t as a block type as we can't catch the overflow condition
-in the same way as the other native types, uint8_t, uint16_t, uint32_t.
-
-We could use a sint64_t and then convert to uint64_t and observe the MSB. Very different 
-logic though.
+The carry chains use block_addc, which widens blocks of up to 32 bits to a uint64_t and
+uint64_t blocks to an unsigned __int128, so all of uint8_t, uint16_t, uint32_t, and uint64_t
+are valid block types for multi-block arithmetic.
 */
 
 // a block-based binary number configurable to be signed or unsigned. When signed it uses 2's complement encoding
@@ -110,7 +109,7 @@ public:
 	static constexpr bt       SIGN_BIT_MASK = (0 == nbits ? bt(0) : (bt(bt(1) << ((nbits - 1ull) % bitsInBlock))));
 
 	static constexpr bool     uniblock64 = (bitsInBlock == 64) && (nrBlocks == 1);
-	static_assert(bitsInBlock < 64 || uniblock64, "storage unit for multi-block arithmetic needs to be one of [uint8_t | uint16_t | uint32_t]");
+	static_assert(bitsInBlock <= 64, "storage unit for block arithmetic needs to be one of [uint8_t | uint16_t | uint32_t | uint64_t]");
 
 	/// trivial constructor
 	blockbinary() = default;
@@ -154,7 +153,7 @@ public:
 		if constexpr (1 < nrBlocks) {
 			for (unsigned i = 0; i < nrBlocks; ++i) {
 				_block[i] = rhs & storageMask;
-				rhs >>= bitsInBlock;
+				if constexpr (bitsInBlock < 64) rhs >>= bitsInBlock; else rhs = (rhs < 0 ? -1ll : 0ll);
 			}
 			// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
 			_block[MSU] &= MSU_MASK;
@@ -168,18 +167,18 @@ public:
 	}
 
 	// conversion operators
-	explicit operator int() const                { return int(to_long_long()); }
-	explicit operator long() const               { return long(to_long_long()); }
-	explicit operator long long() const          { return to_long_long(); }
-	explicit operator unsigned int() const       { return unsigned(to_ull()); }
-	explicit operator unsigned long() const      { return (unsigned long)to_ull(); }
-	explicit operator unsigned long long() const { return to_ull(); }
+	explicit constexpr operator int() const                { return int(to_long_long()); }
+	explicit constexpr operator long() const               { return long(to_long_long()); }
+	explicit constexpr operator long long() const          { return to_long_long(); }
+	explicit constexpr operator unsigned int() const       { return unsigned(to_ull()); }
+	explicit constexpr operator unsigned long() const      { return (unsigned long)to_ull(); }
+	explicit constexpr operator unsigned long long() const { return to_ull(); }
 	// TODO: these need proper implementations that can convert very large integers to the proper scale afforded by the floating-point formats
-	explicit operator float() const              { return float(to_long_long()); }
-	explicit operator double() const             { return double(to_long_long()); }
+	explicit constexpr operator float() const              { return float(to_long_long()); }
+	explicit constexpr operator double() const             { return double(to_long_long()); }
 
 #if LONG_DOUBLE_SUPPORT
-	explicit operator long double() const        { return (long double)to_long_long(); }
+	explicit constexpr operator long double() const        { return (long double)to_long_long(); }
 #endif
 
 	// limb access operators
@@ -241,11 +240,9 @@ public:
 			BlockType const* pB = rhs._block;
 			BlockType* pC = sum._block;
 			BlockType* pEnd = pC + nrBlocks;
-			std::uint64_t carry = 0;
+			bt carry{ 0 };
 			while (pC != pEnd) {
-				carry += static_cast<std::uint64_t>(*pA) + static_cast<std::uint64_t>(*pB);
-				*pC = static_cast<bt>(carry);
-				carry >>= bitsInBlock;
+				*pC = block_addc(*pA, *pB, carry);
 				++pA; ++pB; ++pC;
 			}
 			// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
@@ -258,82 +255,20 @@ public:
 	blockbinary& operator-=(const blockbinary& rhs) {
 		return operator+=(sw::universal::twosComplement(rhs));
 	}
-#define BLOCKBINARY_FAST_MUL
-#ifdef BLOCKBINARY_FAST_MUL
+	// modulo in-place: the low nbits of a 2's complement product are the low nbits of the unsigned product of the encodings
 	blockbinary& operator*=(const blockbinary& rhs) {
-		if constexpr (NumberType == BinaryNumberType::Signed) {
-			if constexpr (nrBlocks == 1) {
-				_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
-			}
-			else {
-				// is there a better way than upconverting to deal with maxneg in a 2's complement encoding?
-				blockbinary<nbits + 1, BlockType, NumberType> base(*this);
-				blockbinary<nbits + 1, BlockType, NumberType> multiplicant(rhs);
-				bool resultIsNeg = (base.isneg() ^ multiplicant.isneg());
-				if (base.isneg()) {
-					base.twosComplement();
-				}
-				if (multiplicant.isneg()) {
-					multiplicant.twosComplement();
-				}
-				clear();
-				for (unsigned i = 0; i < static_cast<unsigned>(nrBlocks); ++i) {
-					std::uint64_t segment(0);
-					for (unsigned j = 0; j < static_cast<unsigned>(nrBlocks); ++j) {
-						segment += static_cast<std::uint64_t>(base.block(i)) * static_cast<std::uint64_t>(multiplicant.block(j));
-
-						if (i + j < static_cast<unsigned>(nrBlocks)) {
-							segment += _block[i + j];
-							_block[i + j] = static_cast<bt>(segment);
-							segment >>= bitsInBlock;
-						}
-					}
-				}
-				if (resultIsNeg) twosComplement();
-			}
+		if constexpr (nrBlocks == 1) {
+			_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
 		}
-		else {  // unsigned
-			if constexpr (nrBlocks == 1) {
-				_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
-			}
-			else {
-				blockbinary base(*this);
-				blockbinary multiplicant(rhs);
-				clear();
-				for (unsigned i = 0; i < static_cast<unsigned>(nrBlocks); ++i) {
-					std::uint64_t segment(0);
-					for (unsigned j = 0; j < static_cast<unsigned>(nrBlocks); ++j) {
-						segment += static_cast<std::uint64_t>(base.block(i)) * static_cast<std::uint64_t>(multiplicant.block(j));
-
-						if (i + j < static_cast<unsigned>(nrBlocks)) {
-							segment += _block[i + j];
-							_block[i + j] = static_cast<bt>(segment);
-							segment >>= bitsInBlock;
-						}
-					}
-				}
-			}
+		else {
+			bt base[nrBlocks];
+			for (unsigned i = 0; i < nrBlocks; ++i) base[i] = _block[i];
+			block_multiply<bt, nrBlocks, nrBlocks, nrBlocks>(base, (this == &rhs ? base : rhs._block), _block);
 		}
 		// null any leading bits that fall outside of nbits
 		_block[MSU] = static_cast<bt>(MSU_MASK & _block[MSU]);
 		return *this;
 	}
-#else
-	blockbinary& operator*=(const blockbinary& rhs) { // modulo in-place
-		blockbinary base(*this);
-		blockbinary multiplicant(rhs);
-		clear();
-		for (unsigned i = 0; i < nbits; ++i) {
-			if (base.at(i)) {
-				operator+=(multiplicant);
-			}
-			multiplicant <<= 1;
-		}
-		// since we used operator+=, which enforces the nulling of leading bits
-		// we don't need to null here
-		return *this;
-	}
-#endif
 	blockbinary& operator/=(const blockbinary& rhs) {
 		if constexpr (nbits == (sizeof(BlockType) * 8)) {
 			if (rhs.iszero()) {
@@ -556,7 +491,7 @@ public:
 		else if constexpr (1 < nrBlocks) {
 			for (unsigned i = 0; i < nrBlocks; ++i) {
 				_block[i] = value & storageMask;
-				value >>= bitsInBlock;
+				if constexpr (bitsInBlock < 64) value >>= bitsInBlock; else value = 0;
 			}
 		}
 		_block[MSU] &= MSU_MASK; // enforce precondition for fast comparison by properly nulling bits that are outside of nbits
@@ -758,10 +693,10 @@ public:
 		return -1; // no significant bit found, all bits are zero
 	}
 	// conversion to native types
-	int64_t to_long_long() const {
+	constexpr int64_t to_long_long() const {
 		constexpr unsigned sizeoflonglong = 8 * sizeof(long long);
-		int64_t ll{ 0 };
-		int64_t mask{ 1 };
+		uint64_t ll{ 0 };
+		uint64_t mask{ 1 };
 		unsigned upper = (nbits < sizeoflonglong ? nbits : sizeoflonglong);
 		for (unsigned i = 0; i < upper; ++i) {
 			ll |= at(i) ? mask : 0;
@@ -773,9 +708,9 @@ public:
 				mask <<= 1;
 			}
 		}
-		return ll;
+		return static_cast<int64_t>(ll);
 	}
-	uint64_t to_ull() const {
+	constexpr uint64_t to_ull() const {
 		uint64_t ull{ 0 };
 		uint64_t mask{ 1 };
 		uint32_t msb = nbits < 64 ? nbits : 64;
@@ -990,43 +925,18 @@ inline blockbinary<N + 1, B, T> ursub(const blockbinary<N, B, T>& a, const block
 	return result -= blockbinary<N + 1, B, T>(b);
 }
 
-#define TRACE_URMUL 0
 // unrounded multiplication, returns a blockbinary that is of size 2*nbits
-// using brute-force sign-extending of operands to yield correct sign-extended result for 2*nbits 2's complement.
+// the sign-extended operands are multiplied modulo 2*nbits, which yields the 2's complement product
 template<unsigned N, typename B, BinaryNumberType T>
 inline blockbinary<2*N, B, T> urmul(const blockbinary<N, B, T>& a, const blockbinary<N, B, T>& b) {
 	using BlockBinary = blockbinary<2 * N, B, T>;
-	BlockBinary result(0);
-	if (a.iszero() || b.iszero()) return result;
-
-	// compute the result
-	BlockBinary signextended_a(a);
-	BlockBinary multiplicant(b);
-#if TRACE_URMUL
-	std::cout << "    " << to_binary(a) << " * " << to_binary(b) << std::endl;
-	std::cout << std::setw(3) << 0 << ' ' << to_binary(multiplicant) << ' ' << to_binary(result) << std::endl;
-#endif
-	for (unsigned i = 0; i < 2*N; ++i) {
-		if (signextended_a.at(i)) {
-			result += multiplicant;
-		}
-		multiplicant <<= 1;
-#if TRACE_URMUL
-		std::cout << std::setw(3) << i << ' ' << to_binary(multiplicant) << ' ' << to_binary(result) << std::endl;
-#endif
-
-	}
-#if TRACE_URMUL
-	std::cout << "fnl " << to_binary(result) << std::endl;
-#endif
-	//blockbinary<2 * nbits, bt> clipped(result);
-	// since we used operator+=, which enforces the nulling of leading bits
-	// we don't need to null here
-	return result;
+	BlockBinary result(a);
+	if (a.iszero() || b.iszero()) return BlockBinary(0);
+	return result *= BlockBinary(b);
 }
 
 // unrounded multiplication, returns a blockbinary that is of size 2*nbits
-// using nbits modulo arithmetic with final sign
+// using a full product of the nbits+1 magnitudes with final sign
 template<unsigned N, typename B, BinaryNumberType T>
 inline blockbinary<2 * N, B, T> urmul2(const blockbinary<N, B, T>& a, const blockbinary<N, B, T>& b) {
 	blockbinary<2 * N, B, T> result(0);
@@ -1035,29 +945,22 @@ inline blockbinary<2 * N, B, T> urmul2(const blockbinary<N, B, T>& a, const bloc
 	// compute the result
 	bool result_sign = a.sign() ^ b.sign();
 	// normalize both arguments to positive in new size
-	blockbinary<N + 1, B, T> a_new(a); // TODO optimize: now create a, create _a.bb, copy, destroy _a.bb_copy
+	blockbinary<N + 1, B, T> a_new(a);
 	blockbinary<N + 1, B, T> b_new(b);
 	if (a.sign()) a_new.twosComplement();
 	if (b.sign()) b_new.twosComplement();
-	blockbinary<2*N, B, T> multiplicant(b_new);
 
-#if TRACE_URMUL
-	std::cout << "    " << a_new << " * " << b_new << std::endl;
-	std::cout << std::setw(3) << 0 << ' ' << multiplicant << ' ' << result << std::endl;
-#endif
-	for (unsigned i = 0; i < (N+1); ++i) {
-		if (a_new.at(i)) {
-			result += multiplicant;  // if multiplicant is not the same size as result, the assignment will get sign-extended if the MSB is true, this is not correct because we are assuming unsigned binaries in this loop
-		}
-		multiplicant <<= 1;
-#if TRACE_URMUL
-		std::cout << std::setw(3) << i << ' ' << multiplicant << ' ' << result << std::endl;
-#endif
+	// the product of the magnitudes fits in 2*nbits
+	constexpr unsigned nrOperandBlocks = blockbinary<N + 1, B, T>::nrBlocks;
+	constexpr unsigned nrResultBlocks = blockbinary<2 * N, B, T>::nrBlocks;
+	B lhs[nrOperandBlocks], rhs[nrOperandBlocks], product[2 * nrOperandBlocks];
+	for (unsigned i = 0; i < nrOperandBlocks; ++i) {
+		lhs[i] = a_new.block(i);
+		rhs[i] = b_new.block(i);
 	}
+	block_multiply<B, nrOperandBlocks, nrOperandBlocks, 2 * nrOperandBlocks>(lhs, rhs, product);
+	for (unsigned i = 0; i < nrResultBlocks; ++i) result.setblock(i, product[i]);
 	if (result_sign) result.twosComplement();
-#if TRACE_URMUL
-	std::cout << "fnl " << result << std::endl;
-#endif
 	return result;
 }
 
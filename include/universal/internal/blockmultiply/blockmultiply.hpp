@@ -0,0 +1,230 @@
+#pragma once
+// blockmultiply.hpp: carry chains and multi-block unsigned multiplication kernels shared by the block number types
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <type_traits>
+#include <universal/utility/uint128.hpp>
+
+/*
+   The kernels multiply unsigned integers that are stored as arrays of blocks, least
+   significant block first. The block type is one of uint8_t, uint16_t, uint32_t, or uint64_t.
+
+       block_addc(a, b, carry)                         a + b + carry, with carry in and out
+       block_subb(a, b, borrow)                        a - b - borrow, with borrow in and out
+       block_mul64(a, b, hi, lo)                       full 64x64 -> 128-bit product
+       block_double_width_t<Block>                     unsigned word of twice the block width
+       block_multiply<Block, na, nb, nr>(a, b, r)      r = a * b modulo 2^(nr * bitsInBlock)
+
+   block_multiply is a schoolbook multiplication that only computes the columns of the
+   product that fall inside the nr result blocks, so the modulo products of blockbinary and
+   integer cost about half of a full product. Every step is a single multiply-accumulate of
+   two blocks into a double-width word: a uint64_t for blocks up to 32 bits, and the 128-bit
+   product of block_mul64 for uint64_t blocks.
+
+   Full products of equal length operands switch to Karatsuba's algorithm when the operands
+   are wider than karatsubaThresholdBits: three half-size products instead of four.
+
+   The carry and borrow steps widen blocks of up to 32 bits to a uint64_t, and uint64_t blocks
+   to the uint128_t of utility/uint128.hpp, which the compilers lower to add-with-carry and
+   subtract-with-borrow instructions. Without it the carry out of a uint64_t block is recovered
+   from unsigned comparisons. Either way uint64_t is a full width block type for the carry chains.
+
+   The kernels are constexpr, and the result must not alias the operands.
+*/
+
+namespace sw { namespace universal {
+
+// operand width in bits above which full products use Karatsuba's algorithm
+constexpr unsigned karatsubaThresholdBits = 1024;
+
+// unsigned word of twice the width of a block: the quotient digit estimates of long division use it
+template<typename Block>
+struct block_double_width { using type = uint64_t; };
+#if UINT128_SUPPORT
+template<>
+struct block_double_width<uint64_t> { using type = uint128_t; };
+#endif
+template<typename Block>
+using block_double_width_t = typename block_double_width<Block>::type;
+
+/// <summary>
+/// add with carry: returns the low block of a + b + carry, and leaves the carry out, 0 or 1, in carry
+/// </summary>
+template<typename Block>
+constexpr Block block_addc(Block a, Block b, Block& carry) noexcept {
+	static_assert(std::is_unsigned_v<Block> && sizeof(Block) <= 8, "block_addc requires an unsigned block type of at most 64 bits");
+	if constexpr (sizeof(Block) < 8) {
+		uint64_t s = static_cast<uint64_t>(a) + static_cast<uint64_t>(b) + static_cast<uint64_t>(carry);
+		carry = static_cast<Block>(s >> (sizeof(Block) * 8u));
+		return static_cast<Block>(s);
+	}
+	else {
+#if UINT128_SUPPORT
+		uint128_t s = static_cast<uint128_t>(a) + b + carry;
+		carry = static_cast<Block>(s >> 64);
+		return static_cast<Block>(s);
+#else
+		Block s = static_cast<Block>(a + b);
+		Block c = (s < a ? Block(1) : Block(0));
+		Block r = static_cast<Block>(s + carry);
+		carry = static_cast<Block>(c + (r < s ? Block(1) : Block(0)));
+		return r;
+#endif
+	}
+}
+
+/// <summary>
+/// subtract with borrow: returns the low block of a - b - borrow, and leaves the borrow out, 0 or 1, in borrow
+/// </summary>
+template<typename Block>
+constexpr Block block_subb(Block a, Block b, Block& borrow) noexcept {
+	static_assert(std::is_unsigned_v<Block> && sizeof(Block) <= 8, "block_subb requires an unsigned block type of at most 64 bits");
+	if constexpr (sizeof(Block) < 8) {
+		uint64_t d = static_cast<uint64_t>(a) - static_cast<uint64_t>(b) - static_cast<uint64_t>(borrow);
+		borrow = static_cast<Block>((d >> 63) & 1u);
+		return static_cast<Block>(d);
+	}
+	else {
+#if UINT128_SUPPORT
+		uint128_t d = static_cast<uint128_t>(a) - b - borrow;
+		borrow = static_cast<Block>((d >> 127) & 1u);
+		return static_cast<Block>(d);
+#else
+		Block d = static_cast<Block>(a - b);
+		Block c = (a < b ? Block(1) : Block(0));
+		Block r = static_cast<Block>(d - borrow);
+		borrow = static_cast<Block>(c + (d < borrow ? Block(1) : Block(0)));
+		return r;
+#endif
+	}
+}
+
+/// <summary>
+/// full 64x64 -> 128-bit product
+/// </summary>
+constexpr void block_mul64(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) noexcept {
+#if UINT128_SUPPORT
+	uint128_t p = static_cast<uint128_t>(a) * b;
+	hi = static_cast<uint64_t>(p >> 64);
+	lo = static_cast<uint64_t>(p);
+#else
+	uint64_t a0 = a & 0xFFFF'FFFFull, a1 = a >> 32, b0 = b & 0xFFFF'FFFFull, b1 = b >> 32;
+	uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	uint64_t mid = (p00 >> 32) + (p01 & 0xFFFF'FFFFull) + (p10 & 0xFFFF'FFFFull);
+	lo = (mid << 32) | (p00 & 0xFFFF'FFFFull);
+	hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+namespace blockmultiply_detail {
+
+	template<typename Block>
+	constexpr unsigned bitsInBlock = sizeof(Block) * 8u;
+
+	// t + a * b + carry, returns the low block and leaves the high block in carry: the sum cannot overflow
+	template<typename Block>
+	constexpr Block mac(Block a, Block b, Block t, Block& carry) noexcept {
+		if constexpr (std::is_same_v<Block, uint64_t>) {
+			uint64_t hi{ 0 }, lo{ 0 };
+			block_mul64(a, b, hi, lo);
+			lo += t;
+			hi += (lo < t ? 1u : 0u);
+			lo += carry;
+			hi += (lo < carry ? 1u : 0u);
+			carry = hi;
+			return lo;
+		}
+		else {
+			uint64_t s = static_cast<uint64_t>(a) * static_cast<uint64_t>(b) + static_cast<uint64_t>(t) + static_cast<uint64_t>(carry);
+			carry = static_cast<Block>(s >> bitsInBlock<Block>);
+			return static_cast<Block>(s);
+		}
+	}
+
+	// r = a * b modulo 2^(nr * bitsInBlock)
+	template<typename Block>
+	constexpr void schoolbook(const Block* a, unsigned na, const Block* b, unsigned nb, Block* r, unsigned nr) noexcept {
+		for (unsigned k = 0; k < nr; ++k) r[k] = Block(0);
+		for (unsigned i = 0; i < na && i < nr; ++i) {
+			if (a[i] == Block(0)) continue;
+			Block carry{ 0 };
+			unsigned j = 0;
+			for (; j < nb && i + j < nr; ++j) r[i + j] = mac(a[i], b[j], r[i + j], carry);
+			if (i + j < nr) r[i + j] = carry;  // the columns above i + nb are still zero
+		}
+	}
+
+	// r[0, n) += a[0, na), returns the carry out of r[n - 1]
+	template<typename Block>
+	constexpr Block add_to(Block* r, unsigned n, const Block* a, unsigned na) noexcept {
+		Block carry{ 0 };
+		for (unsigned i = 0; i < n; ++i) {
+			if (i >= na && carry == Block(0)) break;
+			r[i] = block_addc(r[i], (i < na ? a[i] : Block(0)), carry);
+		}
+		return carry;
+	}
+
+	// r[0, n) -= a[0, na), modulo 2^(n * bitsInBlock)
+	template<typename Block>
+	constexpr void subtract_from(Block* r, unsigned n, const Block* a, unsigned na) noexcept {
+		Block borrow{ 0 };
+		for (unsigned i = 0; i < n; ++i) {
+			if (i >= na && borrow == Block(0)) break;
+			r[i] = block_subb(r[i], (i < na ? a[i] : Block(0)), borrow);
+		}
+	}
+
+	template<typename Block>
+	constexpr unsigned karatsubaThreshold = (karatsubaThresholdBits / bitsInBlock<Block> < 4u ? 4u : karatsubaThresholdBits / bitsInBlock<Block>);
+
+	// r[0, 2n) = a[0, n) * b[0, n)
+	template<typename Block, unsigned n>
+	constexpr void karatsuba(const Block* a, const Block* b, Block* r) noexcept {
+		if constexpr (n < karatsubaThreshold<Block>) {
+			schoolbook(a, n, b, n, r, 2 * n);
+		}
+		else {
+			constexpr unsigned lo = n / 2, hi = n - lo;
+			// z0 = a0 * b0 and z2 = a1 * b1 go straight into the low and high halves of the result
+			karatsuba<Block, lo>(a, b, r);
+			karatsuba<Block, hi>(a + lo, b + lo, r + 2 * lo);
+			// z1 = (a0 + a1)(b0 + b1) - z0 - z2
+			Block sa[hi + 1]{}, sb[hi + 1]{}, z1[2 * (hi + 1)]{};
+			for (unsigned i = 0; i < hi; ++i) { sa[i] = a[lo + i]; sb[i] = b[lo + i]; }
+			sa[hi] = add_to(sa, hi, a, lo);
+			sb[hi] = add_to(sb, hi, b, lo);
+			karatsuba<Block, hi + 1>(sa, sb, z1);
+			subtract_from(z1, 2 * (hi + 1), r, 2 * lo);
+			subtract_from(z1, 2 * (hi + 1), r + 2 * lo, 2 * hi);
+			// r += z1 * 2^(lo * bitsInBlock): z1 = a0 b1 + a1 b0 fits in the remaining lo + 2 hi blocks
+			add_to(r + lo, lo + 2 * hi, z1, 2 * (hi + 1));
+		}
+	}
+
+} // namespace blockmultiply_detail
+
+/// <summary>
+/// r = a * b modulo 2^(nr * bitsInBlock), for unsigned operands of na and nb blocks
+/// </summary>
+/// <typeparam name="Block">block type: uint8_t, uint16_t, uint32_t, or uint64_t</typeparam>
+/// <param name="a">na blocks, least significant block first</param>
+/// <param name="b">nb blocks, least significant block first</param>
+/// <param name="r">nr blocks of result, must not alias a or b</param>
+template<typename Block, unsigned na, unsigned nb, unsigned nr>
+constexpr void block_multiply(const Block* a, const Block* b, Block* r) noexcept {
+	static_assert(std::is_unsigned_v<Block> && sizeof(Block) <= 8, "block_multiply requires an unsigned block type of at most 64 bits");
+	using namespace blockmultiply_detail;
+	if constexpr (na == nb && nr >= 2 * na && na >= karatsubaThreshold<Block>) {
+		karatsuba<Block, na>(a, b, r);
+		for (unsigned k = 2 * na; k < nr; ++k) r[k] = Block(0);
+	}
+	else {
+		schoolbook(a, na, b, nb, r, nr);
+	}
+}
+
+}} // namespace sw::universal
@@ -11,6 +11,7 @@
 #include <sstream>
 
 #include <universal/internal/blocksignificant/blocksignificant_fwd.hpp>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
 
 // should be defined by calling environment, just catching it here in case it is not
 #ifndef LONG_DOUBLE_SUPPORT
@@ -61,12 +62,9 @@ struct bsquorem {
 /*
 NOTE 1
    For block arithmetic, we need to manage a carry bit.
-This disqualifies using uint64_t as a block type as we can't catch the overflow condition
-in the same way as the other native types, uint8_t, uint16_t, uint32_t.
-   We could use a sint64_t and then convert to uint64_t and observe the MSB. 
-That requires different logic though. 
-TODO: the highest performance for 32bits and up would be to have a uint64_t base type
-for which we need asm to get the carry bit logic to work.
+The carry chains use block_addc, which recovers the carry out of a uint64_t block with an
+unsigned __int128 intermediate, so uint64_t is a full width block type, and the highest
+performance choice for significands of 64 bits and up.
 
 TODO: are there mechanisms where we can use SIMD for vector operations?
 If there are, then doing something with more fitting and smaller base types might
@@ -129,7 +127,7 @@ public:
 	template <size_t... I>
 	constexpr blocksignificant(const uint64_t raw, int radixPoint, std::index_sequence<I...>) noexcept
 	          : radixPoint{ radixPoint }, encoding{ BitEncoding::Flex }
-		  , _block{ static_cast<bt>(storageMask & (raw >> I*bitsInBlock))... } {}
+		  , _block{ static_cast<bt>(I * bitsInBlock < 64 ? (storageMask & (raw >> (I * bitsInBlock % 64))) : 0ull)... } {}
 
 	constexpr blocksignificant(const uint64_t raw, int radixPoint) noexcept
 	        : blocksignificant(raw, radixPoint, std::make_index_sequence<nrBlocks>{}) {}
@@ -209,13 +207,9 @@ public:
 	/// </summary>
 	/// <returns></returns>
 	constexpr void increment() noexcept {
-		bool carry = true;
-		for (unsigned i = 0; i < nrBlocks; ++i) {
-			// cast up so we can test for overflow
-			uint64_t l = uint64_t(_block[i]);
-			uint64_t s = l + (carry ? uint64_t(1) : uint64_t(0));
-			carry = (s > ALL_ONES);
-			_block[i] = bt(s);
+		bt carry{ 1 };
+		for (unsigned i = 0; i < nrBlocks && carry; ++i) {
+			_block[i] = block_addc(_block[i], bt(0), carry);
 		}
 		// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
 		_block[MSU] &= MSU_MASK;
@@ -227,37 +221,29 @@ public:
 	/// </summary>
 	/// <param name="lhs">nbits of fraction in the form 00h.ffff</param>
 	/// <param name="rhs">nbits of fraction in the form 00h.ffff</param>
-	void add(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
-		bool carry = false;
+	constexpr void add(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
+		bt carry{ 0 };
 		for (unsigned i = 0; i < nrBlocks; ++i) {
-			// cast up so we can test for overflow
-			uint64_t l = uint64_t(lhs._block[i]);
-			uint64_t r = uint64_t(rhs._block[i]);
-			uint64_t s = l + r + (carry ? uint64_t(1) : uint64_t(0));
-			carry = (s > ALL_ONES);
-			_block[i] = bt(s);
+			_block[i] = block_addc(lhs._block[i], rhs._block[i], carry);
 		}
 		// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
 		_block[MSU] &= MSU_MASK;
 	}
-	void sub(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
+	constexpr void sub(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
 		blocksignificant<nbits, bt> b(twosComplementFree(rhs)); 
 		add(lhs, b);
 	}
-	void mul(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
-		blocksignificant<nbits, bt> base(lhs);
-		blocksignificant<nbits, bt> multiplicant(rhs);
-		clear();
-		for (unsigned i = 0; i < nbits; ++i) {
-			if (base.at(i)) {
-				add(*this, multiplicant);
-			}
-			multiplicant <<= 1;
+	constexpr void mul(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
+		bt base[nrBlocks]{}, multiplicant[nrBlocks]{};
+		for (unsigned i = 0; i < nrBlocks; ++i) {
+			base[i] = lhs._block[i];
+			multiplicant[i] = rhs._block[i];
 		}
-		// since we used operator+=, which enforces the nulling of leading bits
-		// we don't need to null here
+		block_multiply<bt, nrBlocks, nrBlocks, nrBlocks>(base, multiplicant, _block);
+		// null any leading bits that fall outside of nbits
+		_block[MSU] &= MSU_MASK;
 	}
-	void div(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
+	constexpr void div(const blocksignificant& lhs, const blocksignificant& rhs) noexcept {
 		blocksignificant<nbits, bt> base(lhs);
 		blocksignificant<nbits, bt> divider(rhs);
 		clear();
@@ -393,8 +379,8 @@ public:
 		}
 		else if constexpr (1 < nrBlocks) {
 			if constexpr (bitsInBlock == 64) {
-				// just set the highest bits with the value provided
-				_block[MSU] = value;
+				_block[0] = value;
+				for (unsigned i = 1; i < nrBlocks; ++i) _block[i] = bt(0);
 			}
 			else {
 				for (unsigned i = 0; i < nrBlocks; ++i) {
@@ -477,7 +463,10 @@ public:
 			if constexpr (bitsInBlock < 64 && nrBlocks > 1) {
 				return blocksignificant::significant_ull(std::make_index_sequence<MSU>{});
 			}
-			else { // if bitsInBlock < 64, take top 64bits and ignore the rest
+			else if constexpr (nrBlocks > 1) { // the lower 64 bits are the least significant block
+				return uint64_t(_block[0]);
+			}
+			else {
 				return raw;
 			}
 		}
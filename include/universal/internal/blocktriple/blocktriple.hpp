@@ -161,9 +161,7 @@ public:
 //					(op == BlockTripleOperator::SQRT ? BitEncoding::Ones : BitEncoding::Ones))));
 	static constexpr unsigned normalBits = (bfbits < 64 ? bfbits : 64);
 	static constexpr uint64_t normalFormMask = (normalBits == 64) ? 0xFFFF'FFFF'FFFF'FFFFull : (~(0xFFFF'FFFF'FFFF'FFFFull << (normalBits - 1)));
-	// to maximize performance, can we make the default blocktype a uint64_t?
-	// storage unit for block arithmetic needs to be uin32_t until we can figure out 
-	// how to manage carry propagation on uint64_t using intrinsics/assembly code
+	// the carry chains of the significant use block_addc and block_subb, so uint64_t is a valid block type
 	using Significant = sw::universal::blocksignificant<bfbits, bt>;
 
 	static constexpr bt ALL_ONES = bt(~0);
@@ -446,7 +444,7 @@ public:
 	/// <param name="lhs">ephemeral blocktriple that may get modified</param>
 	/// <param name="rhs">ephemeral blocktriple that may get modified</param>
 	/// <param name="result">unrounded sum</param>
-	void add(blocktriple& lhs, blocktriple& rhs) {
+	constexpr void add(blocktriple& lhs, blocktriple& rhs) {
 		int lhs_scale = lhs.scale();
 		int rhs_scale = rhs.scale();
 		int scale_of_result = std::max(lhs_scale, rhs_scale);
@@ -515,7 +513,7 @@ public:
 		}
 	}
 
-	void sub(blocktriple& lhs, blocktriple& rhs) {
+	constexpr void sub(blocktriple& lhs, blocktriple& rhs) {
 		add(lhs, rhs.twosComplement());
 	}
 
@@ -536,7 +534,7 @@ public:
 	/// <param name="lhs">ephemeral blocktriple that may get modified</param>
 	/// <param name="rhs">ephemeral blocktriple that may get modified</param>
 	/// <param name="result">unrounded sum</param>
-	void mul(blocktriple& lhs, blocktriple& rhs) {
+	constexpr void mul(blocktriple& lhs, blocktriple& rhs) {
 		int lhs_scale = lhs.scale();
 		int rhs_scale = rhs.scale();
 		int scale_of_result = lhs_scale + rhs_scale;
@@ -584,7 +582,7 @@ public:
 		}
 	}
 
-	void div(blocktriple& lhs, blocktriple& rhs) {
+	constexpr void div(blocktriple& lhs, blocktriple& rhs) {
 		int lhs_scale = lhs.scale();
 		int rhs_scale = rhs.scale();
 		int scale_of_result = lhs_scale - rhs_scale;
@@ -75,25 +75,23 @@ namespace sw { namespace universal {
 ////////////////////////////////////////////////////////////////////////
 // nonconst extractFields for single precision floating-point
 
-	inline void extractFields(float value, bool& s, uint64_t& rawExponentBits, uint64_t& rawFractionBits, uint64_t& bits) noexcept {
-		float_decoder decoder;
-		decoder.f = value;
-		s = decoder.parts.sign ? true : false;
-		rawExponentBits = static_cast<uint64_t>(decoder.parts.exponent);
-		rawFractionBits = static_cast<uint64_t>(decoder.parts.fraction);
-		bits = uint64_t(decoder.bits);
+	inline BIT_CAST_CONSTEXPR void extractFields(float value, bool& s, uint64_t& rawExponentBits, uint64_t& rawFractionBits, uint64_t& bits) noexcept {
+		uint32_t bc = sw::bit_cast<uint32_t>(value);  // constexpr when the compiler provides a bit_cast builtin
+		s = (ieee754_parameter<float>::smask & bc);
+		rawExponentBits = (ieee754_parameter<float>::emask & bc) >> ieee754_parameter<float>::fbits;
+		rawFractionBits = (ieee754_parameter<float>::fmask & bc);
+		bits = bc;
 	}
 
 ////////////////////////////////////////////////////////////////////////
 // nonconst extractFields for double precision floating-point
 
-	inline void extractFields(double value, bool& s, uint64_t& rawExponentBits, uint64_t& rawFractionBits, uint64_t& bits) noexcept {
-		double_decoder decoder;
-		decoder.d = value;
-		s = decoder.parts.sign ? true : false;
-		rawExponentBits = decoder.parts.exponent;
-		rawFractionBits = decoder.parts.fraction;
-		bits = uint64_t(decoder.bits);
+	inline BIT_CAST_CONSTEXPR void extractFields(double value, bool& s, uint64_t& rawExponentBits, uint64_t& rawFractionBits, uint64_t& bits) noexcept {
+		uint64_t bc = sw::bit_cast<uint64_t>(value);  // constexpr when the compiler provides a bit_cast builtin
+		s = (ieee754_parameter<double>::smask & bc);
+		rawExponentBits = (ieee754_parameter<double>::emask & bc) >> ieee754_parameter<double>::fbits;
+		rawFractionBits = (ieee754_parameter<double>::fmask & bc);
+		bits = bc;
 	}
 
 #if LONG_DOUBLE_SUPPORT
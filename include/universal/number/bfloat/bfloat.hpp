@@ -49,6 +49,7 @@
 #include <universal/number/bfloat/bfloat8_impl.hpp>
 #include <universal/traits/bfloat8_traits.hpp>
 #include <universal/number/bfloat/bfloat16_impl.hpp>
+#include <universal/number/bfloat/bfloat16_kernels.hpp>
 #include <universal/traits/bfloat16_traits.hpp>
 #include <universal/number/bfloat/numeric_limits.hpp>
 
@@ -30,9 +30,9 @@ class bfloat16 {
 		}
 		else {
 			float f = float(v);
-			uint16_t pun[2];
-			std::memcpy(pun, &f, 4);
-			_bits = pun[1];
+			uint32_t u;
+			std::memcpy(&u, &f, 4);
+			_bits = static_cast<uint16_t>(u >> 16);
 		}
 		return *this;
 	}
@@ -44,9 +44,9 @@ class bfloat16 {
 		}
 		else {
 			float f = float(v);
-			uint16_t pun[2];
-			std::memcpy(pun, &f, 4);
-			_bits = pun[1];
+			uint32_t u;
+			std::memcpy(&u, &f, 4);
+			_bits = static_cast<uint16_t>(u >> 16);
 		}
 		return *this;
 	}
@@ -54,19 +54,17 @@ class bfloat16 {
 		typename = typename std::enable_if< std::is_floating_point<Real>::value, Real >::type>
 	constexpr bfloat16& convert_ieee754(Real rhs) noexcept {
 		float f = float(rhs);
-		uint16_t pun[2];
-		std::memcpy(pun, &f, 4);
-		_bits = pun[1];
+		uint32_t u;
+		std::memcpy(&u, &f, 4);
+		_bits = static_cast<uint16_t>(u >> 16);  // the upper half of the single precision encoding
 		return *this;
 	}
 		template<typename Real,
 		typename = typename std::enable_if< std::is_floating_point<Real>::value, Real >::type>
 	constexpr Real convert_to_ieee754() const noexcept {
 		float f;
-		uint16_t pun[2];
-		pun[1] = _bits;
-		pun[0] = 0;
-		std::memcpy(&f, pun, 4);
+		uint32_t u = static_cast<uint32_t>(_bits) << 16;
+		std::memcpy(&f, &u, 4);
 		return Real(f);
 	}
 public:
@@ -341,7 +339,7 @@ public:
 	constexpr bool isneg()     const noexcept { return (_bits & 0x8000u); }
 	constexpr bool isnan(int NaNType = NAN_TYPE_EITHER)  const noexcept { 
 		bool negative = isneg();
-		bool isNaN    = (_bits & 0x7F80u) && (_bits & 0x007F);
+		bool isNaN    = ((_bits & 0x7F80u) == 0x7F80u) && (_bits & 0x007F);
 		bool isNegNaN = isNaN && negative;
 		bool isPosNaN = isNaN && !negative;	
 		return (NaNType == NAN_TYPE_EITHER ? (isNegNaN || isPosNaN) :
@@ -350,7 +348,7 @@ public:
 	}
 	constexpr bool isinf(int InfType = INF_TYPE_EITHER)  const noexcept { 
 		bool negative = isneg();
-		bool isInf    = (_bits & 0x7F80u);
+		bool isInf    = ((_bits & 0x7F80u) == 0x7F80u) && !(_bits & 0x007F);
 		bool isNegInf = isInf && negative;
 		bool isPosInf = isInf && !negative;
 		return (InfType == INF_TYPE_EITHER ? (isNegInf || isPosInf) :
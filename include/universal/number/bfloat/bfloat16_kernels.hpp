@@ -0,0 +1,157 @@
+#pragma once
+// bfloat16_kernels.hpp: array kernels over contiguous bfloat16 buffers
+//
+// Copyright (C) 2022-2022 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+   The bfloat16 is the upper half of an IEEE-754 single precision float: widening is a
+   16-bit shift of the encoding and narrowing, which truncates like the conversion of the
+   bfloat16 class, drops the lower half. The kernels widen a block of elements into
+   float registers, compute, and narrow the block back, so that the inner loops are free
+   of per-element conversion calls and vectorize. Element-wise kernels produce the same
+   encodings as the scalar bfloat16 operators. The dot, matrix-vector, and matrix-matrix
+   kernels accumulate in float and round once to bfloat16 when the output is bfloat16.
+*/
+
+namespace sw { namespace universal {
+
+namespace bfloat16_detail {
+
+	// number of elements that the kernels widen per iteration
+	constexpr size_t BLOCK = 16;
+
+	inline float widen(uint16_t bits) noexcept {
+		uint32_t u = static_cast<uint32_t>(bits) << 16;
+		float f;
+		std::memcpy(&f, &u, sizeof(f));
+		return f;
+	}
+	inline uint16_t narrow(float f) noexcept {
+		uint32_t u;
+		std::memcpy(&u, &f, sizeof(u));
+		return static_cast<uint16_t>(u >> 16);
+	}
+
+	// widen n <= BLOCK encodings into floats
+	inline void widen_block(const bfloat16* src, float* dst, size_t n) noexcept {
+		uint16_t raw[BLOCK];
+		std::memcpy(raw, src, n * sizeof(uint16_t));
+		for (size_t i = 0; i < n; ++i) dst[i] = widen(raw[i]);
+	}
+	// narrow n <= BLOCK floats into encodings
+	inline void narrow_block(const float* src, bfloat16* dst, size_t n) noexcept {
+		uint16_t raw[BLOCK];
+		for (size_t i = 0; i < n; ++i) raw[i] = narrow(src[i]);
+		std::memcpy(dst, raw, n * sizeof(uint16_t));
+	}
+
+	// element-wise kernel driver: c[i] = op(a[i], b[i])
+	template<typename BinaryOp>
+	inline void elementwise(const bfloat16* a, const bfloat16* b, bfloat16* c, size_t n, BinaryOp op) noexcept {
+		float fa[BLOCK], fb[BLOCK], fc[BLOCK];
+		for (size_t i = 0; i < n; i += BLOCK) {
+			size_t m = (n - i < BLOCK ? n - i : BLOCK);
+			widen_block(a + i, fa, m);
+			widen_block(b + i, fb, m);
+			for (size_t k = 0; k < m; ++k) fc[k] = op(fa[k], fb[k]);
+			narrow_block(fc, c + i, m);
+		}
+	}
+
+} // namespace bfloat16_detail
+
+// conversions
+inline void bfloat16_to_float(const bfloat16* src, float* dst, size_t n) noexcept {
+	using namespace bfloat16_detail;
+	for (size_t i = 0; i < n; i += BLOCK) widen_block(src + i, dst + i, (n - i < BLOCK ? n - i : BLOCK));
+}
+inline void float_to_bfloat16(const float* src, bfloat16* dst, size_t n) noexcept {
+	using namespace bfloat16_detail;
+	for (size_t i = 0; i < n; i += BLOCK) narrow_block(src + i, dst + i, (n - i < BLOCK ? n - i : BLOCK));
+}
+
+// element-wise arithmetic: c = a op b
+inline void bfloat16_add(const bfloat16* a, const bfloat16* b, bfloat16* c, size_t n) noexcept {
+	bfloat16_detail::elementwise(a, b, c, n, [](float x, float y) { return x + y; });
+}
+inline void bfloat16_sub(const bfloat16* a, const bfloat16* b, bfloat16* c, size_t n) noexcept {
+	bfloat16_detail::elementwise(a, b, c, n, [](float x, float y) { return x - y; });
+}
+inline void bfloat16_mul(const bfloat16* a, const bfloat16* b, bfloat16* c, size_t n) noexcept {
+	bfloat16_detail::elementwise(a, b, c, n, [](float x, float y) { return x * y; });
+}
+inline void bfloat16_div(const bfloat16* a, const bfloat16* b, bfloat16* c, size_t n) noexcept {
+	bfloat16_detail::elementwise(a, b, c, n, [](float x, float y) { return x / y; });
+}
+
+// fused multiply-add: d = a * b + c, the product is exact in float
+inline void bfloat16_fma(const bfloat16* a, const bfloat16* b, const bfloat16* c, bfloat16* d, size_t n) noexcept {
+	using namespace bfloat16_detail;
+	float fa[BLOCK], fb[BLOCK], fc[BLOCK];
+	for (size_t i = 0; i < n; i += BLOCK) {
+		size_t m = (n - i < BLOCK ? n - i : BLOCK);
+		widen_block(a + i, fa, m);
+		widen_block(b + i, fb, m);
+		widen_block(c + i, fc, m);
+		for (size_t k = 0; k < m; ++k) fc[k] = fa[k] * fb[k] + fc[k];
+		narrow_block(fc, d + i, m);
+	}
+}
+
+// scale: y = alpha * x
+inline void bfloat16_scale(float alpha, const bfloat16* x, bfloat16* y, size_t n) noexcept {
+	using namespace bfloat16_detail;
+	float f[BLOCK];
+	for (size_t i = 0; i < n; i += BLOCK) {
+		size_t m = (n - i < BLOCK ? n - i : BLOCK);
+		widen_block(x + i, f, m);
+		for (size_t k = 0; k < m; ++k) f[k] *= alpha;
+		narrow_block(f, y + i, m);
+	}
+}
+
+// dot product with float accumulation: BLOCK independent partial sums are combined at the end
+inline float bfloat16_dot(const bfloat16* a, const bfloat16* b, size_t n) noexcept {
+	using namespace bfloat16_detail;
+	float fa[BLOCK], fb[BLOCK], partial[BLOCK] = { 0.0f };
+	for (size_t i = 0; i < n; i += BLOCK) {
+		size_t m = (n - i < BLOCK ? n - i : BLOCK);
+		widen_block(a + i, fa, m);
+		widen_block(b + i, fb, m);
+		for (size_t k = 0; k < m; ++k) partial[k] += fa[k] * fb[k];
+	}
+	float sum{ 0.0f };
+	for (size_t k = 0; k < BLOCK; ++k) sum += partial[k];
+	return sum;
+}
+
+// mixed-precision matrix-matrix product with float accumulation, row-major operands:
+// C[M x N] += A[M x K] * B[K x N]
+inline void bfloat16_gemm(size_t M, size_t N, size_t K, const bfloat16* A, size_t lda, const bfloat16* B, size_t ldb, float* C, size_t ldc) {
+	using namespace bfloat16_detail;
+	// widen a panel of rows of B once and reuse it for all rows of A
+	constexpr size_t KC = 64;
+	std::vector<float> panel(KC * N);
+	float arow[KC];
+	for (size_t kk = 0; kk < K; kk += KC) {
+		size_t kc = (K - kk < KC ? K - kk : KC);
+		for (size_t k = 0; k < kc; ++k) bfloat16_to_float(B + (kk + k) * ldb, panel.data() + k * N, N);
+		for (size_t i = 0; i < M; ++i) {
+			bfloat16_to_float(A + i * lda + kk, arow, kc);
+			float* c = C + i * ldc;
+			for (size_t k = 0; k < kc; ++k) {
+				float aik = arow[k];
+				const float* b = panel.data() + k * N;
+				for (size_t j = 0; j < N; ++j) c[j] += aik * b[j];
+			}
+		}
+	}
+}
+
+}} // namespace sw::universal
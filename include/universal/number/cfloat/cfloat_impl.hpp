@@ -43,6 +43,14 @@
 #define TRACE_CONVERSION 0
 #endif
 
+// ALPHA feature: per-thread operation counts, rounding events, and scale histograms
+#ifndef CFLOAT_INSTRUMENTATION
+#define CFLOAT_INSTRUMENTATION 0
+#endif
+#if CFLOAT_INSTRUMENTATION
+#include <universal/utility/instrumentation.hpp>
+#endif
+
 namespace sw { namespace universal {
 
 /*
@@ -112,7 +120,7 @@ int scale(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturati
 /// <param name="tgt">the resulting cfloat</param>
 template<unsigned srcbits, BlockTripleOperator op, unsigned nbits, unsigned es, typename bt,
 	bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline /*constexpr*/ void convert(const blocktriple<srcbits, op, bt>& src, cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& tgt) {
+inline constexpr void convert(const blocktriple<srcbits, op, bt>& src, cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& tgt) {
 	using btType = blocktriple<srcbits, op, bt>;
 	using cfloatType = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	// test special cases
@@ -142,12 +150,18 @@ inline /*constexpr*/ void convert(const blocktriple<srcbits, op, bt>& src, cfloa
 					std::pair<bool, unsigned> alignment = src.roundingDecision(adjustment);
 					if (alignment.first) ++tgt; // we are minpos
 				}
+#if CFLOAT_INSTRUMENTATION
+				instrumentation<cfloatType>::record(tgt.iszero() ? InstrumentedEvent::underflow : InstrumentedEvent::round);
+#endif
 				tgt.setsign(src.sign());
 				return;
 			}
 		}
 		else {
 			if (exponent + cfloatType::EXP_BIAS <= 0) {  // value is in the subnormal range, which maps to 0
+#if CFLOAT_INSTRUMENTATION
+				instrumentation<cfloatType>::record(InstrumentedEvent::underflow);
+#endif
 				tgt.setzero();
 				tgt.setsign(src.sign());
 				return;
@@ -157,12 +171,18 @@ inline /*constexpr*/ void convert(const blocktriple<srcbits, op, bt>& src, cfloa
 		if constexpr (hasSupernormals) {
 			if constexpr (isSaturating) {
 				if (exponent > cfloatType::MAX_EXP) {
+#if CFLOAT_INSTRUMENTATION
+					instrumentation<cfloatType>::record(InstrumentedEvent::saturate);
+#endif
 					if (src.sign()) tgt.maxneg(); else tgt.maxpos();
 					return;
 				}
 			}
 			else {
 				if (exponent > cfloatType::MAX_EXP) {
+#if CFLOAT_INSTRUMENTATION
+					instrumentation<cfloatType>::record(InstrumentedEvent::overflow);
+#endif
 					tgt.setinf(src.sign());
 					return;
 				}
@@ -171,12 +191,18 @@ inline /*constexpr*/ void convert(const blocktriple<srcbits, op, bt>& src, cfloa
 		else {  // no supernormals will saturate at a different encoding: TODO can we hide it all in maxpos?
 			if constexpr (isSaturating) {
 				if (exponent > cfloatType::MAX_EXP) {
+#if CFLOAT_INSTRUMENTATION
+					instrumentation<cfloatType>::record(InstrumentedEvent::saturate);
+#endif
 					if (src.sign()) tgt.maxneg(); else tgt.maxpos();
 					return;
 				}
 			}
 			else {
 				if (exponent > cfloatType::MAX_EXP) {
+#if CFLOAT_INSTRUMENTATION
+					instrumentation<cfloatType>::record(InstrumentedEvent::overflow);
+#endif
 					tgt.setinf(src.sign());
 					return;
 				}
@@ -215,6 +241,10 @@ inline /*constexpr*/ void convert(const blocktriple<srcbits, op, bt>& src, cfloa
 		// get the rounding direction and the LSB right shift: 
 		std::pair<bool, unsigned> alignment = src.roundingDecision(adjustment);
 		unsigned rightShift = alignment.second;  // this is the shift to get the LSB of the src to the LSB of the tgt
+#if CFLOAT_INSTRUMENTATION
+		instrumentation<cfloatType>::record_scale(exponent);
+		if (alignment.first) instrumentation<cfloatType>::record(InstrumentedEvent::round);
+#endif
 		//std::cout << "rightShift       " << rightShift << '\n';
 
 		if constexpr (btType::bfbits < 65) {
@@ -319,7 +349,7 @@ public:
 	static_assert(special, "when es == 1, cfloat must have both subnormals and supernormals");
 	static constexpr unsigned bitsInByte = 8u;
 	static constexpr unsigned bitsInBlock = sizeof(bt) * bitsInByte;
-	static_assert(bitsInBlock <= 64, "storage unit for block arithmetic needs to be <= uint64_t"); // TODO: carry propagation on uint64_t requires assembly code
+	static_assert(bitsInBlock <= 64, "storage unit for block arithmetic needs to be <= uint64_t");
 
 	static constexpr unsigned nbits = _nbits;
 	static constexpr unsigned es = _es;
@@ -443,8 +473,8 @@ public:
 	constexpr cfloat(unsigned int iv)                   noexcept : _block{} { *this = iv; }
 	constexpr cfloat(unsigned long iv)                  noexcept : _block{} { *this = iv; }
 	constexpr cfloat(unsigned long long iv)             noexcept : _block{} { *this = iv; }
-	CONSTEXPRESSION cfloat(float iv)                    noexcept : _block{} { *this = iv; }
-	CONSTEXPRESSION cfloat(double iv)                   noexcept : _block{} { *this = iv; }
+	BIT_CAST_CONSTEXPR cfloat(float iv)                    noexcept : _block{} { *this = iv; }
+	BIT_CAST_CONSTEXPR cfloat(double iv)                   noexcept : _block{} { *this = iv; }
 
 	// assignment operators
 	constexpr cfloat& operator=(signed char rhs)        noexcept { return convert_signed_integer(rhs); }
@@ -459,8 +489,8 @@ public:
 	constexpr cfloat& operator=(unsigned long rhs)      noexcept { return convert_unsigned_integer(rhs); }
 	constexpr cfloat& operator=(unsigned long long rhs) noexcept { return convert_unsigned_integer(rhs); }
 
-	CONSTEXPRESSION cfloat& operator=(float rhs)        noexcept { return convert_ieee754(rhs); }
-	CONSTEXPRESSION cfloat& operator=(double rhs)       noexcept { return convert_ieee754(rhs); }
+	BIT_CAST_CONSTEXPR cfloat& operator=(float rhs)        noexcept { return convert_ieee754(rhs); }
+	BIT_CAST_CONSTEXPR cfloat& operator=(double rhs)       noexcept { return convert_ieee754(rhs); }
 
 	// guard long double support to enable ARM and RISC-V embedded environments
 //#if LONG_DOUBLE_SUPPORT
@@ -471,14 +501,17 @@ public:
 
 	// arithmetic operators
 	// prefix operator
-	inline cfloat operator-() const {
+	constexpr cfloat operator-() const {
 		cfloat tmp(*this);
 		tmp._block[MSU] ^= SIGN_BIT_MASK;
 		return tmp;
 	}
 
-	cfloat& operator+=(const cfloat& rhs) {
+	constexpr cfloat& operator+=(const cfloat& rhs) {
 		if constexpr (_trace_add) std::cout << "---------------------- ADD -------------------" << std::endl;
+#if CFLOAT_INSTRUMENTATION
+		instrumentation<cfloat>::record(InstrumentedEvent::add);
+#endif
 		// special case handling of the inputs
 #if CFLOAT_THROW_ARITHMETIC_EXCEPTION
 		if (isnan(NAN_TYPE_SIGNALLING) || rhs.isnan(NAN_TYPE_SIGNALLING)) {
@@ -538,21 +571,28 @@ public:
 
 		return *this;
 	}
-	cfloat& operator+=(double rhs) {
+	BIT_CAST_CONSTEXPR cfloat& operator+=(double rhs) {
 		return *this += cfloat(rhs);
 	}
-	cfloat& operator-=(const cfloat& rhs) {
+	constexpr cfloat& operator-=(const cfloat& rhs) {
 		if constexpr (_trace_sub) std::cout << "---------------------- SUB -------------------" << std::endl;
+#if CFLOAT_INSTRUMENTATION
+		instrumentation<cfloat>::record(InstrumentedEvent::sub);
+		typename instrumentation<cfloat>::scoped_suppression suppress;  // subtraction is implemented by the addition operator
+#endif
 		if (rhs.isnan()) 
 			return *this += rhs;
 		else 
 			return *this += -rhs;
 	}
-	cfloat& operator-=(double rhs) {
+	BIT_CAST_CONSTEXPR cfloat& operator-=(double rhs) {
 		return *this -= cfloat(rhs);
 	}
-	cfloat& operator*=(const cfloat& rhs) {
+	constexpr cfloat& operator*=(const cfloat& rhs) {
 		if constexpr (_trace_mul) std::cout << "---------------------- MUL -------------------\n";
+#if CFLOAT_INSTRUMENTATION
+		instrumentation<cfloat>::record(InstrumentedEvent::mul);
+#endif
 		// special case handling of the inputs
 #if CFLOAT_THROW_ARITHMETIC_EXCEPTION
 		if (isnan(NAN_TYPE_SIGNALLING) || rhs.isnan(NAN_TYPE_SIGNALLING)) {
@@ -614,11 +654,14 @@ public:
 
 		return *this;
 	}
-	cfloat& operator*=(double rhs) {
+	BIT_CAST_CONSTEXPR cfloat& operator*=(double rhs) {
 		return *this *= cfloat(rhs);
 	}
-	cfloat& operator/=(const cfloat& rhs) {
+	constexpr cfloat& operator/=(const cfloat& rhs) {
 		if constexpr (_trace_div) std::cout << "---------------------- DIV -------------------" << std::endl;
+#if CFLOAT_INSTRUMENTATION
+		instrumentation<cfloat>::record(InstrumentedEvent::div);
+#endif
 
 		// special case handling of the inputs
 		// qnan / qnan = qnan
@@ -699,7 +742,7 @@ public:
 
 		return *this;
 	}
-	cfloat& operator/=(double rhs) {
+	BIT_CAST_CONSTEXPR cfloat& operator/=(double rhs) {
 		return *this /= cfloat(rhs);
 	}
 	/// <summary>
@@ -1736,7 +1779,7 @@ public:
 	constexpr uint64_t fraction_ull() const {
 		uint64_t raw{ 0 };
 		if constexpr (nbits - es - 1ull < 65ull) { // no-op if precondition doesn't hold
-			if constexpr (1 == nrBlocks) {
+			if constexpr (1 == nrBlocks || 64 == bitsInBlock) {  // all the fraction bits are in the first block
 				uint64_t fbitMask = 0xFFFF'FFFF'FFFF'FFFF >> (64 - fbits);
 				raw = fbitMask & uint64_t(_block[0]);
 			}
@@ -1815,9 +1858,9 @@ public:
 	}
 
 	// casts to native types
-	int to_int() const { return int(to_native<float>()); }
-	long to_long() const { return long(to_native<double>()); }
-	long long to_long_long() const { return (long long)(to_native<double>()); }
+	constexpr int to_int() const { return int(to_native<float>()); }
+	constexpr long to_long() const { return long(to_native<double>()); }
+	constexpr long long to_long_long() const { return (long long)(to_native<double>()); }
 
 	// transform an cfloat to a native C++ floating-point. We are using the native
 	// precision to compute, which means that all sub-values need to be representable 
@@ -1825,7 +1868,7 @@ public:
 	// A more accurate approximation would require an adaptive precision algorithm
 	// with a final rounding step.
 	template<typename TargetFloat>
-	TargetFloat to_native() const { 
+	constexpr TargetFloat to_native() const {
 		TargetFloat v{ 0.0 };
 		if (iszero()) {
 			// the optimizer might destroy the sign
@@ -1844,7 +1887,7 @@ public:
 				f += at(static_cast<unsigned>(i)) ? fbit : TargetFloat(0);
 				fbit *= TargetFloat(0.5);
 			}
-			blockbinary<es, bt> ebits;
+			blockbinary<es, bt> ebits{};
 			exponent(ebits);
 			if constexpr (hasSubnormals) {
 				if (ebits.iszero()) {
@@ -1897,11 +1940,11 @@ public:
 	}
 
 	// make conversions to native types explicit
-	explicit operator int()       const noexcept { return to_int(); }
-	explicit operator long()      const noexcept { return to_long(); }
-	explicit operator long long() const noexcept { return to_long_long(); }
-	explicit operator float()     const noexcept { return to_native<float>(); }
-	explicit operator double()    const noexcept { return to_native<double>(); }
+	explicit constexpr operator int()       const noexcept { return to_int(); }
+	explicit constexpr operator long()      const noexcept { return to_long(); }
+	explicit constexpr operator long long() const noexcept { return to_long_long(); }
+	explicit constexpr operator float()     const noexcept { return to_native<float>(); }
+	explicit constexpr operator double()    const noexcept { return to_native<double>(); }
 
 	// convert a cfloat to a blocktriple with the fraction format 1.ffff
 	// we are using the same block type so that we can use block copies to move bits around.
@@ -2227,7 +2270,7 @@ protected:
 	/// shift left is a bit level encoding helper for fast limb-based conversions between different cfloats
 	/// </summary>
 	/// <param name="bitsToShift"></param>
-	void shiftLeft(unsigned bitsToShift) {
+	constexpr void shiftLeft(unsigned bitsToShift) {
 		if (bitsToShift == 0) return;
 		if (bitsToShift > nbits) {
 			setzero();
@@ -2334,7 +2377,7 @@ protected:
 
 public:
 	template<typename Real>
-	CONSTEXPRESSION cfloat& convert_ieee754(Real rhs) noexcept {
+	BIT_CAST_CONSTEXPR cfloat& convert_ieee754(Real rhs) noexcept {
 		if constexpr (nbits == 32 && es == 8 && sizeof(Real) == 4) {
 			// we CANNOT use the native conversion to float as cfloats have supernormals
 			// which IEEE-754 does not have and thus a native conversion would destroy
@@ -2550,7 +2593,7 @@ public:
 				constexpr int rightShift = ieee754_parameter<Real>::fbits - fbits; // this is the bit shift to get the MSB of the src to the MSB of the tgt
 				uint32_t biasedExponent{ 0 };
 				int adjustment{ 0 }; // right shift adjustment for subnormal representation
-				uint64_t mask;
+				uint64_t mask{ 0 };
 				if (rawExponent != 0) {
 					// the source real is a normal number, 
 //					if (exponent >= (MIN_EXP_SUBNORMAL - 1) && exponent < MIN_EXP_NORMAL) {
@@ -2732,62 +2775,55 @@ public:
 					// we need to write the fields and then shifting them in place
 					// 
 					// common case: normal to normal
-					if constexpr (bitsInBlock < 64) {
-						if (rawExponent != 0) {
-							// reference example: nbits = 128, es = 15, fbits = 112: rhs = float: shift left by (112 - 23) = 89
-							setbits(biasedExponent);
-							shiftLeft(fbits);
-							bt fractionBlock[nrBlocks]{ 0 };
-							// copy fraction bits
-							unsigned blocksRequired = (8 * sizeof(rawFraction) + 1) / bitsInBlock;
-							unsigned maxBlockNr = (blocksRequired < nrBlocks ? blocksRequired : nrBlocks);
-							uint64_t mask = static_cast<uint64_t>(ALL_ONES); // set up the block mask
-							unsigned shift = 0;
-							for (unsigned i = 0; i < maxBlockNr; ++i) {
-								fractionBlock[i] = bt((mask & rawFraction) >> shift);
-								mask <<= bitsInBlock;
-								shift += bitsInBlock;
-							}
-							// shift fraction bits
-							int bitsToShift = upshift;
-							if (bitsToShift >= static_cast<int>(bitsInBlock)) {
-								int blockShift = static_cast<int>(bitsToShift / bitsInBlock);
-								for (int i = MSU; i >= blockShift; --i) {
-									fractionBlock[i] = fractionBlock[i - blockShift];
-								}
-								for (int i = blockShift - 1; i >= 0; --i) {
-									fractionBlock[i] = bt(0);
-								}
-								// adjust the shift
-								bitsToShift -= blockShift * bitsInBlock;
+					if (rawExponent != 0) {
+						// reference example: nbits = 128, es = 15, fbits = 112: rhs = float: shift left by (112 - 23) = 89
+						setbits(biasedExponent);
+						shiftLeft(fbits);
+						bt fractionBlock[nrBlocks]{ 0 };
+						// copy fraction bits
+						unsigned blocksRequired = (8 * sizeof(rawFraction) + 1) / bitsInBlock;
+						unsigned maxBlockNr = (blocksRequired < nrBlocks ? blocksRequired : nrBlocks);
+						unsigned shift = 0;
+						for (unsigned i = 0; i < maxBlockNr; ++i) {  // shift stays below 64 for the blocks that are required
+							fractionBlock[i] = bt(rawFraction >> shift);
+							shift += bitsInBlock;
+						}
+						// shift fraction bits
+						int bitsToShift = upshift;
+						if (bitsToShift >= static_cast<int>(bitsInBlock)) {
+							int blockShift = static_cast<int>(bitsToShift / bitsInBlock);
+							for (int i = MSU; i >= blockShift; --i) {
+								fractionBlock[i] = fractionBlock[i - blockShift];
 							}
-							if (bitsToShift > 0) {
-								// construct the mask for the upper bits in the block that need to move to the higher word
-								bt bitsToMoveMask = bt(ALL_ONES << (bitsInBlock - bitsToShift));
-								for (unsigned i = MSU; i > 0; --i) {
-									fractionBlock[i] <<= bitsToShift;
-									// mix in the bits from the right
-									bt fracbits = static_cast<bt>(bitsToMoveMask & fractionBlock[i - 1]); // operator & yields an int
-									fractionBlock[i] |= (fracbits >> (bitsInBlock - bitsToShift));
-								}
-								fractionBlock[0] <<= bitsToShift;
+							for (int i = blockShift - 1; i >= 0; --i) {
+								fractionBlock[i] = bt(0);
 							}
-							// OR the bits in
-							for (unsigned i = 0; i <= MSU; ++i) {
-								_block[i] |= fractionBlock[i];
+							// adjust the shift
+							bitsToShift -= blockShift * bitsInBlock;
+						}
+						if (bitsToShift > 0) {
+							// construct the mask for the upper bits in the block that need to move to the higher word
+							bt bitsToMoveMask = bt(ALL_ONES << (bitsInBlock - bitsToShift));
+							for (unsigned i = MSU; i > 0; --i) {
+								fractionBlock[i] <<= bitsToShift;
+								// mix in the bits from the right
+								bt fracbits = static_cast<bt>(bitsToMoveMask & fractionBlock[i - 1]); // operator & yields an int
+								fractionBlock[i] |= (fracbits >> (bitsInBlock - bitsToShift));
 							}
-							// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
-							_block[MSU] &= MSU_MASK;
-							// finally, set the sign bit
-							setsign(s);
+							fractionBlock[0] <<= bitsToShift;
 						}
-						else {
-							// rhs is a subnormal
-		//					std::cerr << "rhs is a subnormal : " << to_binary(rhs) << " : " << rhs << '\n';
+						// OR the bits in
+						for (unsigned i = 0; i <= MSU; ++i) {
+							_block[i] |= fractionBlock[i];
 						}
+						// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
+						_block[MSU] &= MSU_MASK;
+						// finally, set the sign bit
+						setsign(s);
 					}
 					else {
-						// BlockType is incorrect
+						// rhs is a subnormal
+	//					std::cerr << "rhs is a subnormal : " << to_binary(rhs) << " : " << rhs << '\n';
 					}
 				}
 			}
@@ -2911,7 +2947,7 @@ protected:
 			shift += bitsInBlock;
 		}
 	}
-	void shiftLeft(int leftShift) {
+	constexpr void shiftLeft(int leftShift) {
 		if (leftShift == 0) return;
 		if (leftShift < 0) return shiftRight(-leftShift);
 		if (leftShift > long(nbits)) leftShift = nbits; // clip to max
@@ -2939,7 +2975,7 @@ protected:
 		}
 		_block[0] <<= leftShift;
 	}
-	void shiftRight(int rightShift) {
+	constexpr void shiftRight(int rightShift) {
 		if (rightShift == 0) return;
 		if (rightShift < 0) return shiftLeft(-rightShift);
 		if (rightShift >= long(nbits)) {
@@ -3008,7 +3044,7 @@ protected:
 	}
 
 	// calculate the integer power 2 ^ b using exponentiation by squaring
-	double ipow(int exponent) const {
+	constexpr double ipow(int exponent) const {
 		bool negative = (exponent < 0);
 		exponent = negative ? -exponent : exponent;
 		double result(1.0);
@@ -3098,17 +3134,17 @@ private:
 	friend std::istream& operator>> (std::istream& istr, cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& r);
 
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator==(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator==(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator!=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator!=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator< (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator< (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator> (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator> (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator<=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator<=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 	template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-	friend bool operator>=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
+	friend constexpr bool operator>=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs);
 };
 
 ///////////////////////////// IOSTREAM operators ///////////////////////////////////////////////
@@ -3345,7 +3381,7 @@ void ReportCfloatClassParameters() {
 /// cfloat - cfloat binary logic operators
 
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator==(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) {
+inline constexpr bool operator==(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) {
 	if (lhs.isnan() || rhs.isnan()) return false;
 	for (unsigned i = 0; i < lhs.nrBlocks; ++i) {
 		if (lhs._block[i] != rhs._block[i]) {
@@ -3355,9 +3391,9 @@ inline bool operator==(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const c
 	return true;
 }
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator!=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { return !operator==(lhs, rhs); }
+inline constexpr bool operator!=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { return !operator==(lhs, rhs); }
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator< (const cfloat<nnbits, nes, nbt, nsub, nsup, nsat>& lhs, const cfloat<nnbits, nes, nbt, nsub, nsup, nsat>& rhs) {
+inline constexpr bool operator< (const cfloat<nnbits, nes, nbt, nsub, nsup, nsat>& lhs, const cfloat<nnbits, nes, nbt, nsub, nsup, nsat>& rhs) {
 	if (lhs.isnan() || rhs.isnan()) return false;
 	// need this as arithmetic difference is defined as snan(indeterminate)
 	if (lhs.isinf(INF_TYPE_NEGATIVE) && rhs.isinf(INF_TYPE_NEGATIVE)) return false;
@@ -3394,7 +3430,7 @@ inline bool operator< (const cfloat<nnbits, nes, nbt, nsub, nsup, nsat>& lhs, co
 	}
 }
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator> (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { 
+inline constexpr bool operator> (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { 
 	if (lhs.isnan() || rhs.isnan()) return false;
 	// need this as arithmetic difference is defined as snan(indeterminate)
 	if (lhs.isinf(INF_TYPE_NEGATIVE) && rhs.isinf(INF_TYPE_NEGATIVE)) return false;
@@ -3402,12 +3438,12 @@ inline bool operator> (const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const c
 	return  operator< (rhs, lhs); 
 }
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator<=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { 
+inline constexpr bool operator<=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) { 
 	if (lhs.isnan() || rhs.isnan()) return false;
 	return !operator> (lhs, rhs); 
 }
 template<unsigned nnbits, unsigned nes, typename nbt, bool nsub, bool nsup, bool nsat>
-inline bool operator>=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) {
+inline constexpr bool operator>=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& rhs) {
 	if (lhs.isnan() || rhs.isnan()) return false;
 	return !operator< (lhs, rhs); 
 }
@@ -3416,25 +3452,25 @@ inline bool operator>=(const cfloat<nnbits,nes,nbt,nsub,nsup,nsat>& lhs, const c
 /// cfloat - cfloat binary arithmetic operators
 
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline constexpr cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> sum(lhs);
 	sum += rhs;
 	return sum;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline constexpr cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline constexpr cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline constexpr cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
@@ -3443,50 +3479,50 @@ inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> opera
 /// binary cfloat - literal arithmetic operators
 
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> sum(lhs);
 	sum += rhs;
 	return sum;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(float lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
 }
 
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> sum(lhs);
 	sum += rhs;
 	return sum;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(double lhs, const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& rhs) {
 	cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
@@ -3595,28 +3631,28 @@ inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> opera
 ///  binary cfloat - literal arithmetic operators
 
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat sum(lhs);
 	sum += Cfloat(rhs);
 	return sum;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat mul(lhs);
 	mul *= Cfloat(rhs);
 	return mul;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, float rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat ratio(lhs);
 	ratio /= Cfloat(rhs);
@@ -3624,28 +3660,28 @@ inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> opera
 }
 
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator+(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat sum(lhs);
 	sum += Cfloat(rhs);
 	return sum;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator-(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator*(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat mul(lhs);
 	mul *= Cfloat(rhs);
 	return mul;
 }
 template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
-inline cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
+inline BIT_CAST_CONSTEXPR cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> operator/(const cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>& lhs, double rhs) {
 	using Cfloat = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
 	Cfloat ratio(lhs);
 	ratio /= Cfloat(rhs);
@@ -3944,4 +3980,13 @@ fma(cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> x,
 	return fused;
 }
 
+#if CFLOAT_INSTRUMENTATION
+// the scale histogram of a cfloat covers its full dynamic range, including the subnormals
+template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
+struct instrumentation_traits< cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> > {
+	static constexpr int minScale = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>::MIN_EXP_SUBNORMAL;
+	static constexpr int maxScale = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>::MAX_EXP;
+};
+#endif
+
 }} // namespace sw::universal
@@ -5,12 +5,12 @@
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 
-// ALPHA feature: occurrence is NOT an official API for any of the Universal number systems
+// ALPHA feature: instrumentation is NOT an official API for any of the Universal number systems
 #if !defined(EDECIMAL_OPERATIONS_COUNT)
 #define EDECIMAL_OPERATIONS_COUNT 0
 #endif
 #if EDECIMAL_OPERATIONS_COUNT
-#include <universal/utility/occurrence.hpp>
+#include <universal/utility/instrumentation.hpp>
 #endif
 
 namespace sw { namespace universal {
@@ -20,10 +20,6 @@ namespace sw { namespace universal {
 /// </summary>
 /// The digits are managed as a vector with the digit for 10^0 stored at index 0, 10^1 stored at index 1, etc.
 class edecimal : public std::vector<uint8_t> {
-#if EDECIMAL_OPERATIONS_COUNT
-	static bool enableAdd;
-	static occurrence<edecimal> ops;
-#endif
 public:
 	edecimal() { setzero(); }
 
@@ -105,7 +101,7 @@ public:
 		}
 		if (carry) push_back(1);
 #if EDECIMAL_OPERATIONS_COUNT
-		if (enableAdd) ++ops.add;
+		instrumentation<edecimal>::record(InstrumentedEvent::add);
 #endif
 		return *this;
 	}
@@ -159,24 +155,23 @@ public:
 			this->setsign(sign);
 		}
 #if EDECIMAL_OPERATIONS_COUNT
-		++ops.sub;
+		instrumentation<edecimal>::record(InstrumentedEvent::sub);
 #endif
 		return *this;
 	}
 	edecimal& operator*=(const edecimal& rhs) {
+#if EDECIMAL_OPERATIONS_COUNT
+		instrumentation<edecimal>::record(InstrumentedEvent::mul);
+		// the partial products are accumulated with operator+=, which should not count as additions
+		instrumentation<edecimal>::scoped_suppression suppress;
+#endif
 		// special case
 		if (iszero() || rhs.iszero()) {
 			setzero();
-#if EDECIMAL_OPERATIONS_COUNT
-			++ops.mul;
-#endif
 			return *this;
 		}
 		bool signOfFinalResult = (negative != rhs.negative) ? true : false;
 		edecimal product;
-#if EDECIMAL_OPERATIONS_COUNT
-		enableAdd = false;
-#endif
 		// find the smallest edecimal to minimize the amount of work
 		size_t l = size();
 		size_t r = rhs.size();
@@ -220,24 +215,24 @@ public:
 		product.unpad();
 		*this = product;
 		setsign(signOfFinalResult);
-#if EDECIMAL_OPERATIONS_COUNT
-		enableAdd = true;
-		++ops.mul;
-#endif
 		return *this;
 	}
 	edecimal& operator/=(const edecimal& rhs) {
-		*this = quotient(*this, rhs);
 #if EDECIMAL_OPERATIONS_COUNT
-		++ops.div;
+		instrumentation<edecimal>::record(InstrumentedEvent::div);
+		// the long division is implemented with the other arithmetic operators, which should not be counted
+		instrumentation<edecimal>::scoped_suppression suppress;
 #endif
+		*this = quotient(*this, rhs);
 		return *this;
 	}
 	edecimal& operator%=(const edecimal& rhs) {
-		*this = remainder(*this, rhs);
 #if EDECIMAL_OPERATIONS_COUNT
-		++ops.rem;
+		instrumentation<edecimal>::record(InstrumentedEvent::rem);
+		// the long division is implemented with the other arithmetic operators, which should not be counted
+		instrumentation<edecimal>::scoped_suppression suppress;
 #endif
+		*this = remainder(*this, rhs);
 		return *this;
 	}
 	edecimal& operator<<=(int shift) {
@@ -410,12 +405,13 @@ public:
 	}
 
 #if EDECIMAL_OPERATIONS_COUNT
-	// reset the operation statistics
+	// reset the operation statistics of all threads
 	void resetStats() {
-		ops.reset();
+		instrumentation<edecimal>::reset();
 	}
+	// print the operation statistics aggregated over all threads
 	void printStats(std::ostream& ostr) {
-		ops.report(ostr);
+		instrumentation<edecimal>::report().ops.report(ostr);
 	}
 #endif
 
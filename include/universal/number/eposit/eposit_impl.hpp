@@ -4,15 +4,17 @@
 // Copyright (C) 2017-2022 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
-#include <regex>
-#include <vector>
-#include <map>
+#include <type_traits>
 
 #include <universal/number/eposit/exceptions.hpp>
+#include <universal/number/eposit/limbs.hpp>
 
 namespace sw { namespace universal {
 
@@ -20,11 +22,27 @@ namespace sw { namespace universal {
 class eposit;
 bool parse(const std::string& number, eposit& v) noexcept;
 
-// eposit is an adaptive precision linear floating-point type
+/*
+   eposit is an elastic posit with es = 2, the exponent size of the posit standard. The value is
+   kept as a sign, a scale, and a significand of run time width. The result of an arithmetic
+   operation is the exact result rounded to posit<maxbits, 2>, and it is stored at the width of
+   the narrowest posit<nbits, 2> that represents it, so nbits grows on demand up to the maxbits
+   cap. The significands of posits up to 128 bits are stored in the object, wider significands
+   are allocated on the heap.
+
+   The result of an operation gets the larger maxbits of its operands, and native operands are
+   converted at the maxbits of the eposit operand.
+*/
 class eposit {
-	using BlockType = uint32_t;
+	using Significand = eposit_detail::limb_buffer<2>;  // a posit<128,2> significand fits inline
+	using Scratch = eposit_detail::limb_buffer<8>;      // working storage of the arithmetic operators
 public:
-	eposit() : sign(false), exp(0) { }
+	static constexpr unsigned es = 2;
+	static constexpr unsigned defaultMaxNbits = 128;
+	static constexpr unsigned minMaxNbits = 3;
+	static constexpr unsigned maxMaxNbits = 8192;
+
+	eposit() noexcept : _scale(0), _maxNbits(defaultMaxNbits), _sign(false), _nar(false) { }
 
 	eposit(const eposit&) = default;
 	eposit(eposit&&) = default;
@@ -33,27 +51,34 @@ public:
 	eposit& operator=(eposit&&) = default;
 
 	// initializers for native types
-	explicit eposit(const signed char initial_value)        { *this = initial_value; }
-	explicit eposit(const short initial_value)              { *this = initial_value; }
-	explicit eposit(const int initial_value)                { *this = initial_value; }
-	explicit eposit(const long initial_value)               { *this = initial_value; }
-	explicit eposit(const long long initial_value)          { *this = initial_value; }
-	explicit eposit(const char initial_value)               { *this = initial_value; }
-	explicit eposit(const unsigned short initial_value)     { *this = initial_value; }
-	explicit eposit(const unsigned int initial_value)       { *this = initial_value; }
-	explicit eposit(const unsigned long initial_value)      { *this = initial_value; }
-	explicit eposit(const unsigned long long initial_value) { *this = initial_value; }
-	explicit eposit(const float initial_value)              { *this = initial_value; }
-	explicit eposit(const double initial_value)             { *this = initial_value; }
-	explicit eposit(const long double initial_value)        { *this = initial_value; }
-
-	// assignment operators for native types
+	explicit eposit(const signed char initial_value)        : eposit() { *this = initial_value; }
+	explicit eposit(const short initial_value)              : eposit() { *this = initial_value; }
+	explicit eposit(const int initial_value)                : eposit() { *this = initial_value; }
+	explicit eposit(const long initial_value)               : eposit() { *this = initial_value; }
+	explicit eposit(const long long initial_value)          : eposit() { *this = initial_value; }
+	explicit eposit(const char initial_value)               : eposit() { *this = initial_value; }
+	explicit eposit(const unsigned short initial_value)     : eposit() { *this = initial_value; }
+	explicit eposit(const unsigned int initial_value)       : eposit() { *this = initial_value; }
+	explicit eposit(const unsigned long initial_value)      : eposit() { *this = initial_value; }
+	explicit eposit(const unsigned long long initial_value) : eposit() { *this = initial_value; }
+	explicit eposit(const float initial_value)              : eposit() { *this = initial_value; }
+	explicit eposit(const double initial_value)             : eposit() { *this = initial_value; }
+	explicit eposit(const long double initial_value)        : eposit() { *this = initial_value; }
+
+	// initializer for native types that sets the maxbits cap of the elastic posit
+	template<typename NativeType, typename = std::enable_if_t<std::is_arithmetic_v<NativeType>>>
+	eposit(const NativeType initial_value, unsigned maxNbits) : eposit() {
+		_maxNbits = clamp(maxNbits);
+		*this = initial_value;
+	}
+
+	// assignment operators for native types: the value is rounded to posit<maxbits, 2>
 	eposit& operator=(const signed char rhs)        { return convert(rhs); }
 	eposit& operator=(const short rhs)              { return convert(rhs); }
 	eposit& operator=(const int rhs)                { return convert(rhs); }
 	eposit& operator=(const long rhs)               { return convert(rhs); }
 	eposit& operator=(const long long rhs)          { return convert(rhs); }
-	eposit& operator=(const char rhs)               { return convert_unsigned(rhs); }
+	eposit& operator=(const char rhs)               { return convert(rhs); }
 	eposit& operator=(const unsigned short rhs)     { return convert_unsigned(rhs); }
 	eposit& operator=(const unsigned int rhs)       { return convert_unsigned(rhs); }
 	eposit& operator=(const unsigned long rhs)      { return convert_unsigned(rhs); }
@@ -73,8 +98,9 @@ public:
 #endif // ADAPTER_POSIT_AND_EPOSIT
 
 	// prefix operators
-	eposit operator-() const noexcept {
+	eposit operator-() const {
 		eposit negated(*this);
+		if (!negated.iszero() && !negated._nar) negated._sign = !negated._sign;
 		return negated;
 	}
 
@@ -84,194 +110,335 @@ public:
 	explicit operator long double() const noexcept { return convert_to_ieee754<long double>(); }
 
 	// arithmetic operators
-	eposit& operator+=(const eposit& rhs) noexcept {
-		return *this;
+	eposit& operator+=(const eposit& rhs) {
+		return add(rhs, false);
 	}
-	eposit& operator-=(const eposit& rhs) noexcept {
-		return *this;
+	eposit& operator-=(const eposit& rhs) {
+		return add(rhs, true);
 	}
-	eposit& operator*=(const eposit& rhs) noexcept {
+	eposit& operator*=(const eposit& rhs) {
+		using namespace eposit_detail;
+		_maxNbits = std::max(_maxNbits, rhs._maxNbits);
+		if (_nar || rhs._nar) { setnar(); return *this; }
+		if (iszero() || rhs.iszero()) { setzero(); return *this; }
+		// the product of the significands is exact, and has one or two integer bits
+		unsigned na = _significand.size(), nb = rhs._significand.size();
+		Scratch product(na + nb);
+		multiply(_significand.data(), na, rhs._significand.data(), nb, product.data());
+		int fbits = msb(_significand.data(), na) + msb(rhs._significand.data(), nb);
+		int64_t scale = _scale + rhs._scale + (msb(product.data(), na + nb) - fbits);
+		round(_sign != rhs._sign, scale, product.data(), na + nb, false);
 		return *this;
 	}
-	eposit& operator/=(const eposit& rhs) noexcept {
+	eposit& operator/=(const eposit& rhs) {
+		using namespace eposit_detail;
+		_maxNbits = std::max(_maxNbits, rhs._maxNbits);
+#if EPOSIT_THROW_ARITHMETIC_EXCEPTION
+		if (rhs.iszero()) throw eposit_divide_by_zero{};
+#endif
+		if (_nar || rhs._nar || rhs.iszero()) { setnar(); return *this; }  // not throwing is a quiet signalling NaR
+		if (iszero()) return *this;
+		// shift the dividend so that the quotient has maxbits + 4 significant bits,
+		// and keep a sticky bit below them for the remainder
+		int fa = msb(_significand.data(), _significand.size());
+		int fb = msb(rhs._significand.data(), rhs._significand.size());
+		int shift = std::max(0, fb - fa + int(_maxNbits) + 4);
+		unsigned nn = limbs_for(unsigned(fa + shift + 2));
+		Scratch dividend(nn), quotient(nn);
+		shift_left(_significand.data(), _significand.size(), unsigned(shift), dividend.data(), nn);
+		bool sticky = divide<8>(dividend.data(), nn, rhs._significand.data(), rhs._significand.size(), quotient.data());
+		shift_left(quotient.data(), nn, 1, quotient.data(), nn);
+		if (sticky) quotient[0] |= 1u;
+		int64_t lsb = (_scale - fa - shift) - (rhs._scale - fb) - 1;
+		round(_sign != rhs._sign, lsb + msb(quotient.data(), nn), quotient.data(), nn, false);
 		return *this;
 	}
 
 	// modifiers
-	inline void clear() noexcept { sign = false; exp = 0; coef.clear(); }
+	inline void clear() noexcept { _sign = false; _nar = false; _scale = 0; _significand.clear(); }
 	inline void setzero() noexcept { clear(); }
-	// use un-interpreted raw bits to set the bits of the eposit
-	inline void setbits(unsigned long long value) noexcept { clear(); }
+	inline void setnar() noexcept { clear(); _nar = true; }
+	// set the maxbits cap, the value is rounded to posit<maxbits, 2> when the cap shrinks
+	eposit& setmaxbits(unsigned maxNbits) {
+		unsigned cap = clamp(maxNbits);
+		bool shrinks = cap < _maxNbits;
+		_maxNbits = cap;
+		if (shrinks && !_nar && !iszero()) {
+			Scratch significand(_significand.size());
+			for (unsigned i = 0; i < _significand.size(); ++i) significand[i] = _significand[i];
+			round(_sign, _scale, significand.data(), significand.size(), false);
+		}
+		return *this;
+	}
+	// use un-interpreted raw bits to set the bits of the eposit: the bits are a posit<maxbits, 2> encoding
+	inline void setbits(unsigned long long value) {
+		using namespace eposit_detail;
+		clear();
+		unsigned nbits = _maxNbits;
+		if (nbits < 64) value &= (~0ull >> (64 - nbits));
+		if (value == 0) return;
+		if (nbits <= 64 && value == (1ull << (nbits - 1))) { setnar(); return; }
+		if (nbits <= 64 && (value >> (nbits - 1)) != 0) {
+			_sign = true;
+			value = (~value + 1) & (nbits < 64 ? (~0ull >> (64 - nbits)) : ~0ull);  // two's complement magnitude
+		}
+		limb magnitude = value;
+		decode(&magnitude, 1, nbits - 1);
+	}
 	inline eposit& assign(const std::string& txt) {
+		if (!parse(txt, *this)) setnar();
 		return *this;
 	}
 
 	// selectors
-	inline bool iszero() const noexcept { return !sign && coef.size() == 0; }
-	inline bool isone() const noexcept { return true; }
-	inline bool isodd() const noexcept { return false; }
-	inline bool iseven() const noexcept { return !isodd(); }
-	inline bool ispos() const noexcept { return !sign; }
-	inline bool isneg() const noexcept { return sign; }
-	inline int scale() const noexcept { return exp + int(coef.size()); }
+	inline bool isnar() const noexcept { return _nar; }
+	inline bool iszero() const noexcept { return !_nar && _significand.size() == 0; }
+	inline bool isone() const noexcept { return !_nar && !_sign && _scale == 0 && _significand.size() == 1 && _significand[0] == 1; }
+	inline bool ispos() const noexcept { return !_nar && !_sign; }
+	inline bool isneg() const noexcept { return !_nar && _sign; }
+	inline int scale() const noexcept { return int(_scale); }
+	inline unsigned maxbits() const noexcept { return _maxNbits; }
+	// width of the narrowest posit<nbits, 2> that represents the value
+	unsigned nbits() const noexcept {
+		if (_nar || iszero()) return 2;
+		int fbits = eposit_detail::msb(_significand.data(), _significand.size());
+		int64_t k = floor_div4(_scale);
+		unsigned e = unsigned(_scale - 4 * k);
+		if (k < 0) {
+			// the regime is -k zeros and a terminating one
+			return unsigned(2 - k) + (fbits > 0 ? es + unsigned(fbits) : exponent_bits(e));
+		}
+		// the regime is k + 1 ones, and the terminating zero is only needed when bits follow
+		if (fbits == 0 && e == 0) return unsigned(k) + 2;
+		return unsigned(k) + 3 + (fbits > 0 ? es + unsigned(fbits) : exponent_bits(e));
+	}
 
 	// convert to string containing digits number of digits
-	std::string str(size_t nrDigits = 0) const noexcept {
-		if (iszero()) return std::string("0.0");
-
-		int64_t magnitude = scale();
-		if (magnitude > 1 || magnitude < 0) {
-			// use scientific notation for non-trivial exponent values
-			return sci_notation(nrDigits);
-		}
+	std::string str(size_t nrDigits = 0) const {
+		if (_nar) return std::string("nar");
+		std::stringstream s;
+		s << std::setprecision(nrDigits == 0 ? std::numeric_limits<long double>::max_digits10 : int(nrDigits)) << convert_to_ieee754<long double>();
+		return s.str();
+	}
 
-		std::string str;
-		int64_t exponent = trimmed(nrDigits, str);
+protected:
+	int32_t     _scale;        // binary scale of the number
+	uint16_t    _maxNbits;     // cap on the width of the posit encoding
+	bool        _sign;         // sign of the number: -1 if true, +1 if false, zero is positive
+	bool        _nar;          // not a real
+	Significand _significand;  // 1.fraction as an odd integer: the trailing zeros are removed, empty for zero and NaR
 
-		if (magnitude == 0) {
-			if (sign)
-				return std::string("-0.0") + str;
-			else
-				return std::string("0.0") + str;
-		}
+	// HELPER methods
 
-		std::string before_decimal = std::to_string(coef.back());
+	static uint16_t clamp(unsigned maxNbits) noexcept {
+		return uint16_t(maxNbits < minMaxNbits ? minMaxNbits : (maxNbits > maxMaxNbits ? maxMaxNbits : maxNbits));
+	}
+	static int64_t floor_div4(int64_t scale) noexcept { return (scale >= 0 ? scale / 4 : -((-scale + 3) / 4)); }
+	// number of exponent bits needed when no fraction bits follow
+	static unsigned exponent_bits(unsigned e) noexcept { return (e == 0 ? 0u : (e == 2 ? 1u : 2u)); }
+
+	// set the significand to M without its trailing zeros
+	void assign_significand(const eposit_detail::limb* M, unsigned n) {
+		using namespace eposit_detail;
+		unsigned tz = trailing_zeros(M, n);
+		int top = msb(M, n);
+		unsigned size = limbs_for(unsigned(top) - tz + 1);
+		_significand.resize(size);
+		shift_right(M, n, tz, _significand.data(), size);
+	}
 
-		if (exponent >= 0) {
-			if (sign)
-				return std::string("-") + before_decimal + ".0";
-			else
-				return before_decimal + ".0";
+	// set the magnitude from a posit<width + 1, 2> magnitude encoding of width bits, which is not zero
+	void decode(const eposit_detail::limb* E, unsigned n, unsigned width) {
+		using namespace eposit_detail;
+		int i = int(width) - 1;
+		bool regimeBit = test_bit(E, n, unsigned(i));
+		int64_t run = 0;
+		while (i >= 0 && test_bit(E, n, unsigned(i)) == regimeBit) { ++run; --i; }
+		int64_t k = regimeBit ? run - 1 : -run;
+		--i;  // skip the terminating bit of the regime
+		unsigned e = 0;
+		for (unsigned b = 0; b < es; ++b) {
+			e <<= 1;
+			if (i >= 0) { e |= (test_bit(E, n, unsigned(i)) ? 1u : 0u); --i; }
 		}
+		unsigned fbits = (i >= 0 ? unsigned(i + 1) : 0u);
+		_scale = int32_t(4 * k + int64_t(e));
+		Scratch M(limbs_for(fbits + 1));
+		for (unsigned l = 0; l < M.size() && l < n; ++l) M[l] = E[l];
+		M[fbits / bitsInLimb] &= (limb(1) << (fbits % bitsInLimb)) - 1;  // clear the regime and the exponent
+		set_bit(M.data(), fbits);
+		assign_significand(M.data(), M.size());
+	}
 
-		// now the digits after the radix point
-		std::string after_decimal = str.substr((size_t)(str.size() + exponent), (size_t)-exponent);
-		if (sign)
-			return std::string("-") + before_decimal + "." + after_decimal;
-		else
-			return before_decimal + "." + after_decimal;
-
-		return std::string("bad");
+	/// <summary>
+	/// round (-1)^sign * M * 2^(scale - msb(M)) to posit<maxbits, 2>. The sticky flag stands for set bits below M.
+	/// The magnitude encoding is generated with a guard bit and rounded to nearest even: a carry out of the
+	/// fraction moves into the exponent and the regime, and posits do not round to zero or to NaR.
+	/// </summary>
+	void round(bool sign, int64_t scale, const eposit_detail::limb* M, unsigned n, bool sticky) {
+		using namespace eposit_detail;
+		_nar = false;
+		_sign = sign;
+		int fbits = msb(M, n);
+		int64_t maxScale = 4 * (int64_t(_maxNbits) - 2);
+		if (scale > maxScale) { setmagnitude(maxScale); return; }     // maxpos
+		if (scale < -maxScale) { setmagnitude(-maxScale); return; }   // minpos
+		unsigned width = _maxNbits;  // maxbits - 1 encoding bits followed by the guard bit
+		Scratch E(limbs_for(width));
+		unsigned pos = 0;
+		auto put = [&](bool bit) {
+			if (pos < width) { if (bit) set_bit(E.data(), width - 1 - pos); }
+			else sticky |= bit;
+			++pos;
+		};
+		int64_t k = floor_div4(scale);
+		unsigned e = unsigned(scale - 4 * k);
+		if (k >= 0) { for (int64_t r = 0; r <= k; ++r) put(true); put(false); }
+		else { for (int64_t r = 0; r < -k; ++r) put(false); put(true); }
+		for (unsigned b = es; b-- > 0; ) put(((e >> b) & 1u) != 0);
+		for (int j = fbits - 1; j >= 0; --j) {
+			if (pos >= width) { sticky |= (trailing_zeros(M, n) <= unsigned(j)); break; }
+			put(test_bit(M, n, unsigned(j)));
+		}
+		bool guard = test_bit(E.data(), E.size(), 0);
+		shift_right(E.data(), E.size(), 1, E.data(), E.size());
+		if (guard && (sticky || test_bit(E.data(), E.size(), 0))) {
+			for (unsigned l = 0; l < E.size(); ++l) if (++E[l] != 0) break;
+			if (test_bit(E.data(), E.size(), width - 1)) { setmagnitude(maxScale); return; }
+		}
+		if (msb(E.data(), E.size()) < 0) { setmagnitude(-maxScale); return; }
+		decode(E.data(), E.size(), width - 1);
 	}
 
-	void test(bool _sign, int _exp, std::vector<BlockType>& _coef) noexcept {
-		sign = _sign;
-		coef = _coef;
-		exp = _exp;
+	// set the magnitude to a power of 2
+	void setmagnitude(int64_t scale) {
+		_scale = int32_t(scale);
+		_significand.resize(1);
+		_significand[0] = 1;
 	}
-protected:
-	bool                   sign;  // sign of the number: -1 if true, +1 if false, zero is positive
-	int64_t                exp;   // exponent of the number
-	std::vector<BlockType> coef;  // coefficients of the polynomial
 
-	// HELPER methods
+	// the sum or difference, aligned to keep maxbits + 3 bits below the leading bit of the larger operand
+	eposit& add(const eposit& rhs, bool subtract) {
+		using namespace eposit_detail;
+		_maxNbits = std::max(_maxNbits, rhs._maxNbits);
+		if (_nar || rhs._nar) { setnar(); return *this; }
+		bool rhsSign = (rhs._sign != subtract);
+		if (rhs.iszero()) return *this;
+		if (iszero()) {
+			uint16_t maxNbits = _maxNbits;
+			*this = rhs;
+			_maxNbits = maxNbits;
+			_sign = rhsSign;
+			return *this;
+		}
+		bool thisIsLarger = (_scale >= rhs._scale);
+		const Significand& big = thisIsLarger ? _significand : rhs._significand;
+		const Significand& small = thisIsLarger ? rhs._significand : _significand;
+		int64_t bigScale = thisIsLarger ? _scale : rhs._scale;
+		int64_t smallScale = thisIsLarger ? rhs._scale : _scale;
+		bool bigSign = thisIsLarger ? _sign : rhsSign;
+		bool smallSign = thisIsLarger ? rhsSign : _sign;
+		int64_t bigLsb = bigScale - msb(big.data(), big.size());
+		int64_t smallLsb = smallScale - msb(small.data(), small.size());
+		// bits of the smaller operand below the floor are collected in a sticky bit one position below the floor
+		int64_t floor = std::min(bigLsb, bigScale - int64_t(_maxNbits) - 3);
+		unsigned n = limbs_for(unsigned(bigScale - floor + 3));
+		Scratch x(n), y(n);
+		shift_left(big.data(), big.size(), unsigned(bigLsb - floor + 1), x.data(), n);
+		if (smallLsb >= floor) {
+			shift_left(small.data(), small.size(), unsigned(smallLsb - floor + 1), y.data(), n);
+		}
+		else {
+			bool sticky = shift_right(small.data(), small.size(), unsigned(floor - smallLsb), y.data(), n);
+			shift_left(y.data(), n, 1, y.data(), n);
+			if (sticky) y[0] |= 1u;
+		}
+		bool sign = bigSign;
+		if (bigSign == smallSign) {
+			eposit_detail::add(x.data(), y.data(), n);
+		}
+		else if (compare(x.data(), y.data(), n) >= 0) {
+			eposit_detail::subtract(x.data(), y.data(), n);
+		}
+		else {
+			eposit_detail::subtract(y.data(), x.data(), n);
+			x = std::move(y);
+			sign = smallSign;
+		}
+		int top = msb(x.data(), n);
+		if (top < 0) {
+			setzero();
+			return *this;
+		}
+		round(sign, floor - 1 + top, x.data(), n, false);
+		return *this;
+	}
 
 	// convert to native floating-point
 	template<typename Real>
 	Real convert_to_ieee754() const noexcept {
-		Real r = 0;
-		return r;
+		using namespace eposit_detail;
+		if (_nar) return std::numeric_limits<Real>::quiet_NaN();
+		if (iszero()) return Real(0);
+		// the leading 64 bits of the significand, with a sticky bit for the bits below them
+		unsigned n = _significand.size();
+		int fbits = msb(_significand.data(), n);
+		limb top{ 0 };
+		if (fbits >= 63) {
+			bool sticky = shift_right(_significand.data(), n, unsigned(fbits - 63), &top, 1);
+			if (sticky) top |= 1u;
+		}
+		else {
+			top = _significand[0] << (63 - fbits);
+		}
+		Real r = std::ldexp(static_cast<Real>(top), int(_scale) - 63);
+		return (_sign ? -r : r);
 	}
 	template<typename SignedInt>
-	eposit& convert(SignedInt v) noexcept {
+	eposit& convert(SignedInt v) {
 		if (0 == v) {
 			setzero();
+			return *this;
 		}
-		else {
-			// convert 
-		}
+		unsigned long long magnitude = (v < 0 ? static_cast<unsigned long long>(-(v + 1)) + 1ull : static_cast<unsigned long long>(v));
+		convert_unsigned(magnitude);
+		_sign = (v < 0);
 		return *this;
 	}
 	template<typename UnsignedInt>
-	eposit& convert_unsigned(UnsignedInt v) noexcept {
+	eposit& convert_unsigned(UnsignedInt v) {
 		if (0 == v) {
 			setzero();
 		}
 		else {
-			// convert 
+			eposit_detail::limb M = static_cast<eposit_detail::limb>(v);
+			round(false, eposit_detail::msb(&M, 1), &M, 1, false);
 		}
 		return *this;
 	}
 	template<typename Real>
-	eposit& convert_ieee754(Real& rhs) noexcept {
-		clear();
-		long long base = (long long)rhs;
-		*this = base;
-		return *this;
-	}
-
-	// convert to string with nrDigits of significant digits and return the scale
-	// value = str + "10^" + scale
-	int64_t trimmed(size_t nrDigits, std::string& number) const noexcept {
-		if (coef.size() == 0) return 0;
-		int64_t exponent = exp;
-		size_t length = coef.size();
-		size_t index = 0; 
-		if (nrDigits == 0) {
-			nrDigits = length * 9;
-		}
-		else {
-			size_t nrSegments = (nrDigits + 17) / 9;
-			if (nrSegments < length) {
-				index = length - nrSegments;
-				exponent += index;
-				length = nrSegments;
-			}
-		}
-		exponent *= 9;
-		char segment[] = "012345678";
-		number.clear();
-		size_t i = length;
-		while (i-- > 0) {
-			BlockType w = coef[i];
-			for (int i = 8; i >= 0; --i) {
-				segment[i] = w % 10 + '0';
-				w /= 10;
-			}
-			number += segment;
+	eposit& convert_ieee754(const Real& rhs) {
+		if (std::isnan(rhs) || std::isinf(rhs)) {
+			setnar();
+			return *this;
 		}
-
-		// process leading zeros
-		size_t lz = 0;
-		while (number[lz] == '0') ++lz;
-		nrDigits += lz;
-		if (nrDigits < number.size()) {
-			exponent += number.size() - nrDigits;
-			number.resize(nrDigits);
-		}
-
-		return exponent;
-	}
-
-	std::string sci_notation(size_t nrDigits) const noexcept {
-		if (coef.size() == 0) return std::string("0.0");
-		std::string str;
-		int64_t exponent = trimmed(nrDigits, str);
-		// remove leading zeros
-		str.erase(str.begin(), std::find_if(str.begin(), str.end(), [](int ch) { return (ch != '0'); }));
-		exponent += str.size() - 1;
-		str = str.substr(0, 1) + "." + &str[1];
-		if (exponent != 0) {
-			str += "*10^";
-			str += std::to_string(exponent);
+		if (rhs == Real(0)) {
+			setzero();
+			return *this;
 		}
-		if (sign) str = std::string("-") + str;
-		return str;
+		int exponent{ 0 };
+		Real fraction = std::frexp(std::fabs(rhs), &exponent);  // fraction in [0.5, 1.0)
+		// the significand of float, double, and the 64-bit long double fits in a 64-bit limb
+		eposit_detail::limb M = static_cast<eposit_detail::limb>(std::ldexp(fraction, 64));
+		round(std::signbit(rhs), int64_t(exponent) - 1, &M, 1, false);
+		return *this;
 	}
 
 private:
 
 	// eposit - eposit logic comparisons
 	friend bool operator==(const eposit& lhs, const eposit& rhs);
-
-	// eposit - literal logic comparisons
-	friend bool operator==(const eposit& lhs, const long long rhs);
-
-	// literal - eposit logic comparisons
-	friend bool operator==(const long long lhs, const eposit& rhs);
-
-	// find the most significant bit set
-	friend signed findMsb(const eposit& v);
+	friend bool operator< (const eposit& lhs, const eposit& rhs);
 };
 
 ////////////////////////    functions   /////////////////////////////////
@@ -284,15 +451,27 @@ inline eposit abs(const eposit& a) {
 
 // divide eposit a and b and return result argument
 
-void divide(const eposit& a, const eposit& b, eposit& quotient) {
+inline void divide(const eposit& a, const eposit& b, eposit& quotient) {
+	quotient = a;
+	quotient /= b;
 }
 
 /// stream operators
 
 // parse a eposit ASCII format and make a binary eposit out of it
-bool parse(const std::string& number, eposit& value) noexcept {
+inline bool parse(const std::string& number, eposit& value) noexcept {
 	bool bSuccess = false;
-
+	try {
+		size_t pos{ 0 };
+		long double v = std::stold(number, &pos);
+		if (pos == number.size()) {
+			value = v;
+			bSuccess = true;
+		}
+	}
+	catch (...) {
+		bSuccess = false;
+	}
 	return bSuccess;
 }
 
@@ -328,17 +507,45 @@ inline std::istream& operator>>(std::istream& istr, eposit& p) {
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 // eposit - eposit binary logic operators
 
-// equal: precondition is that the storage is properly nulled in all arithmetic paths
+// equal: the value is independent of the maxbits cap, and NaR equals NaR
 inline bool operator==(const eposit& lhs, const eposit& rhs) {
-	return true;
+	if (lhs._nar || rhs._nar) return lhs._nar == rhs._nar;
+	if (lhs._sign != rhs._sign || lhs._scale != rhs._scale) return false;
+	unsigned n = lhs._significand.size();
+	if (n != rhs._significand.size()) return false;
+	return eposit_detail::compare(lhs._significand.data(), rhs._significand.data(), n) == 0;
 }
 
 inline bool operator!=(const eposit& lhs, const eposit& rhs) {
 	return !operator==(lhs, rhs);
 }
 
+// less than: NaR is smaller than all real values, as in the posit standard
 inline bool operator< (const eposit& lhs, const eposit& rhs) {
-	return false; // lhs and rhs are the same
+	using namespace eposit_detail;
+	if (lhs._nar || rhs._nar) return lhs._nar && !rhs._nar;
+	if (lhs.iszero() || rhs.iszero()) {
+		if (lhs.iszero()) return !rhs.iszero() && !rhs._sign;
+		return lhs._sign;
+	}
+	if (lhs._sign != rhs._sign) return lhs._sign;
+	// same sign: compare the magnitudes, and reverse the outcome for negative numbers
+	int magnitude;
+	if (lhs._scale != rhs._scale) {
+		magnitude = (lhs._scale < rhs._scale ? -1 : 1);
+	}
+	else {
+		// align the leading bits of the significands
+		unsigned na = lhs._significand.size(), nb = rhs._significand.size();
+		int fa = msb(lhs._significand.data(), na), fb = msb(rhs._significand.data(), nb);
+		int fbits = std::max(fa, fb);
+		unsigned n = limbs_for(unsigned(fbits + 1));
+		limb_buffer<8> a(n), b(n);
+		shift_left(lhs._significand.data(), na, unsigned(fbits - fa), a.data(), n);
+		shift_left(rhs._significand.data(), nb, unsigned(fbits - fb), b.data(), n);
+		magnitude = compare(a.data(), b.data(), n);
+	}
+	return (lhs._sign ? magnitude > 0 : magnitude < 0);
 }
 
 inline bool operator> (const eposit& lhs, const eposit& rhs) {
@@ -355,10 +562,10 @@ inline bool operator>=(const eposit& lhs, const eposit& rhs) {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 // eposit - literal binary logic operators
-// equal: precondition is that the byte-storage is properly nulled in all arithmetic paths
+// the literal is converted at the maxbits of the eposit operand
 
 inline bool operator==(const eposit& lhs, const long long rhs) {
-	return operator==(lhs, eposit(rhs));
+	return operator==(lhs, eposit(rhs, lhs.maxbits()));
 }
 
 inline bool operator!=(const eposit& lhs, const long long rhs) {
@@ -366,11 +573,11 @@ inline bool operator!=(const eposit& lhs, const long long rhs) {
 }
 
 inline bool operator< (const eposit& lhs, const long long rhs) {
-	return operator<(lhs, eposit(rhs));
+	return operator<(lhs, eposit(rhs, lhs.maxbits()));
 }
 
 inline bool operator> (const eposit& lhs, const long long rhs) {
-	return operator< (eposit(rhs), lhs);
+	return operator< (eposit(rhs, lhs.maxbits()), lhs);
 }
 
 inline bool operator<=(const eposit& lhs, const long long rhs) {
@@ -383,11 +590,11 @@ inline bool operator>=(const eposit& lhs, const long long rhs) {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 // literal - eposit binary logic operators
-// precondition is that the byte-storage is properly nulled in all arithmetic paths
+// the literal is converted at the maxbits of the eposit operand
 
 
 inline bool operator==(const long long lhs, const eposit& rhs) {
-	return operator==(eposit(lhs), rhs);
+	return operator==(eposit(lhs, rhs.maxbits()), rhs);
 }
 
 inline bool operator!=(const long long lhs, const eposit& rhs) {
@@ -395,7 +602,7 @@ inline bool operator!=(const long long lhs, const eposit& rhs) {
 }
 
 inline bool operator< (const long long lhs, const eposit& rhs) {
-	return operator<(eposit(lhs), rhs);
+	return operator<(eposit(lhs, rhs.maxbits()), rhs);
 }
 
 inline bool operator> (const long long lhs, const eposit& rhs) {
@@ -448,22 +655,22 @@ inline eposit operator/(const eposit& lhs, const eposit& rhs) {
 // BINARY ADDITION
 
 inline eposit operator+(const eposit& lhs, const long long rhs) {
-	return operator+(lhs, eposit(rhs));
+	return operator+(lhs, eposit(rhs, lhs.maxbits()));
 }
 // BINARY SUBTRACTION
 
 inline eposit operator-(const eposit& lhs, const long long rhs) {
-	return operator-(lhs, eposit(rhs));
+	return operator-(lhs, eposit(rhs, lhs.maxbits()));
 }
 // BINARY MULTIPLICATION
 
 inline eposit operator*(const eposit& lhs, const long long rhs) {
-	return operator*(lhs, eposit(rhs));
+	return operator*(lhs, eposit(rhs, lhs.maxbits()));
 }
 // BINARY DIVISION
 
 inline eposit operator/(const eposit& lhs, const long long rhs) {
-	return operator/(lhs, eposit(rhs));
+	return operator/(lhs, eposit(rhs, lhs.maxbits()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -471,22 +678,22 @@ inline eposit operator/(const eposit& lhs, const long long rhs) {
 // BINARY ADDITION
 
 inline eposit operator+(const long long lhs, const eposit& rhs) {
-	return operator+(eposit(lhs), rhs);
+	return operator+(eposit(lhs, rhs.maxbits()), rhs);
 }
 // BINARY SUBTRACTION
 
 inline eposit operator-(const long long lhs, const eposit& rhs) {
-	return operator-(eposit(lhs), rhs);
+	return operator-(eposit(lhs, rhs.maxbits()), rhs);
 }
 // BINARY MULTIPLICATION
 
 inline eposit operator*(const long long lhs, const eposit& rhs) {
-	return operator*(eposit(lhs), rhs);
+	return operator*(eposit(lhs, rhs.maxbits()), rhs);
 }
 // BINARY DIVISION
 
 inline eposit operator/(const long long lhs, const eposit& rhs) {
-	return operator/(eposit(lhs), rhs);
+	return operator/(eposit(lhs, rhs.maxbits()), rhs);
 }
 
 }} // namespace sw::universal
@@ -0,0 +1,207 @@
+#pragma once
+// limbs.hpp: runtime sized unsigned limb arithmetic with small-size inline storage for the elastic posit
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
+
+namespace sw { namespace universal { namespace eposit_detail {
+
+/*
+   The significands of an elastic posit are unsigned integers of a width that is only known at
+   run time. They are stored as 64-bit limbs, least significant limb first. The carry chains and
+   the products use the limb kernels of blockmultiply.hpp that are shared with the fixed-size
+   block types, so the elastic posit gets the add-with-carry and 64x64->128 product lowering of
+   those kernels.
+*/
+
+using limb = uint64_t;
+constexpr unsigned bitsInLimb = 64;
+
+// number of limbs to hold nbits bits
+inline constexpr unsigned limbs_for(unsigned nbits) noexcept { return (nbits + bitsInLimb - 1) / bitsInLimb; }
+
+/// <summary>
+/// limb_buffer is a zero-initialized array of limbs whose size is set at run time:
+/// up to inlineLimbs limbs are stored in the object, larger sizes are allocated on the heap
+/// </summary>
+template<unsigned inlineLimbs>
+class limb_buffer {
+public:
+	limb_buffer() noexcept : _size(0) {}
+	explicit limb_buffer(unsigned n) : _size(0) { resize(n); }
+	limb_buffer(const limb_buffer& rhs) : _size(0) {
+		resize(rhs._size);
+		if (_size > 0) std::memcpy(data(), rhs.data(), _size * sizeof(limb));
+	}
+	limb_buffer(limb_buffer&& rhs) noexcept : _size(rhs._size) {
+		if (onheap()) { _heap = rhs._heap; rhs._size = 0; }
+		else for (unsigned i = 0; i < _size; ++i) _local[i] = rhs._local[i];
+	}
+	limb_buffer& operator=(const limb_buffer& rhs) {
+		if (this != &rhs) {
+			resize(rhs._size);
+			if (_size > 0) std::memcpy(data(), rhs.data(), _size * sizeof(limb));
+		}
+		return *this;
+	}
+	limb_buffer& operator=(limb_buffer&& rhs) noexcept {
+		if (this != &rhs) {
+			release();
+			_size = rhs._size;
+			if (onheap()) { _heap = rhs._heap; rhs._size = 0; }
+			else for (unsigned i = 0; i < _size; ++i) _local[i] = rhs._local[i];
+		}
+		return *this;
+	}
+	~limb_buffer() { release(); }
+
+	// set the size to n limbs, all zero
+	void resize(unsigned n) {
+		if (n > inlineLimbs && n == _size) {
+			std::memset(_heap, 0, n * sizeof(limb));
+			return;
+		}
+		release();
+		if (n > inlineLimbs) _heap = new limb[n]();
+		else for (unsigned i = 0; i < n; ++i) _local[i] = 0;
+		_size = n;
+	}
+	// reduce the size to n limbs, keeping the n least significant limbs
+	void shrink(unsigned n) noexcept {
+		if (n >= _size) return;
+		if (onheap() && n <= inlineLimbs) {
+			limb* heap = _heap;
+			for (unsigned i = 0; i < n; ++i) _local[i] = heap[i];
+			delete[] heap;
+		}
+		_size = n;
+	}
+	void clear() noexcept { release(); _size = 0; }
+
+	unsigned size() const noexcept { return _size; }
+	limb* data() noexcept { return onheap() ? _heap : _local; }
+	const limb* data() const noexcept { return onheap() ? _heap : _local; }
+	limb& operator[](unsigned i) noexcept { return data()[i]; }
+	limb operator[](unsigned i) const noexcept { return data()[i]; }
+
+private:
+	uint32_t _size;
+	union {
+		limb  _local[inlineLimbs]{};
+		limb* _heap;
+	};
+
+	bool onheap() const noexcept { return _size > inlineLimbs; }
+	void release() noexcept { if (onheap()) delete[] _heap; _size = 0; }
+};
+
+// position of the most significant set bit, -1 when a is zero
+inline int msb(const limb* a, unsigned n) noexcept {
+	for (unsigned i = n; i-- > 0; ) {
+		if (a[i] != 0) {
+			int bit = bitsInLimb - 1;
+			while (((a[i] >> bit) & 1u) == 0) --bit;
+			return int(i * bitsInLimb) + bit;
+		}
+	}
+	return -1;
+}
+
+// number of trailing zero bits, n * bitsInLimb when a is zero
+inline unsigned trailing_zeros(const limb* a, unsigned n) noexcept {
+	for (unsigned i = 0; i < n; ++i) {
+		if (a[i] != 0) {
+			unsigned bit = 0;
+			while (((a[i] >> bit) & 1u) == 0) ++bit;
+			return i * bitsInLimb + bit;
+		}
+	}
+	return n * bitsInLimb;
+}
+
+inline bool test_bit(const limb* a, unsigned n, unsigned i) noexcept {
+	unsigned l = i / bitsInLimb;
+	return l < n && ((a[l] >> (i % bitsInLimb)) & 1u) != 0;
+}
+
+inline void set_bit(limb* a, unsigned i) noexcept { a[i / bitsInLimb] |= limb(1) << (i % bitsInLimb); }
+
+// r[0, nr) = a[0, na) << shift, the bits shifted beyond nr limbs are dropped
+inline void shift_left(const limb* a, unsigned na, unsigned shift, limb* r, unsigned nr) noexcept {
+	unsigned ls = shift / bitsInLimb, bs = shift % bitsInLimb;
+	for (unsigned i = nr; i-- > 0; ) {
+		limb v = 0;
+		if (i >= ls) {
+			unsigned j = i - ls;
+			if (j < na) v = a[j] << bs;
+			if (bs != 0 && j >= 1 && j - 1 < na) v |= a[j - 1] >> (bitsInLimb - bs);
+		}
+		r[i] = v;
+	}
+}
+
+// r[0, nr) = a[0, na) >> shift, returns true when a set bit was shifted out
+inline bool shift_right(const limb* a, unsigned na, unsigned shift, limb* r, unsigned nr) noexcept {
+	unsigned ls = shift / bitsInLimb, bs = shift % bitsInLimb;
+	bool sticky = shift > 0 && trailing_zeros(a, na) < shift;
+	for (unsigned i = 0; i < nr; ++i) {
+		limb v = 0;
+		unsigned j = i + ls;
+		if (j < na) v = a[j] >> bs;
+		if (bs != 0 && j + 1 < na) v |= a[j + 1] << (bitsInLimb - bs);
+		r[i] = v;
+	}
+	return sticky;
+}
+
+// three-way comparison of two unsigned integers of n limbs
+inline int compare(const limb* a, const limb* b, unsigned n) noexcept {
+	for (unsigned i = n; i-- > 0; ) {
+		if (a[i] != b[i]) return (a[i] > b[i] ? 1 : -1);
+	}
+	return 0;
+}
+
+// r[0, n) += a[0, n), returns the carry out
+inline limb add(limb* r, const limb* a, unsigned n) noexcept {
+	return blockmultiply_detail::add_to(r, n, a, n);
+}
+
+// r[0, n) -= a[0, n), precondition r >= a
+inline void subtract(limb* r, const limb* a, unsigned n) noexcept {
+	blockmultiply_detail::subtract_from(r, n, a, n);
+}
+
+// r[0, na + nb) = a[0, na) * b[0, nb)
+inline void multiply(const limb* a, unsigned na, const limb* b, unsigned nb, limb* r) noexcept {
+	blockmultiply_detail::schoolbook(a, na, b, nb, r, na + nb);
+}
+
+/// <summary>
+/// q[0, na) = a[0, na) / b[0, nb) by restoring long division, b is not zero
+/// </summary>
+/// <returns>true when the remainder is not zero</returns>
+template<unsigned inlineLimbs>
+bool divide(const limb* a, unsigned na, const limb* b, unsigned nb, limb* q) {
+	for (unsigned i = 0; i < na; ++i) q[i] = 0;
+	limb_buffer<inlineLimbs> remainder(nb + 1), divisor(nb + 1);
+	for (unsigned i = 0; i < nb; ++i) divisor[i] = b[i];
+	unsigned n = nb + 1;
+	for (int i = msb(a, na); i >= 0; --i) {
+		// remainder = 2 * remainder + bit i of a, remainder < 2 * divisor fits in nb + 1 limbs
+		shift_left(remainder.data(), n, 1, remainder.data(), n);
+		if (test_bit(a, na, unsigned(i))) remainder[0] |= 1u;
+		if (compare(remainder.data(), divisor.data(), n) >= 0) {
+			subtract(remainder.data(), divisor.data(), n);
+			set_bit(q, unsigned(i));
+		}
+	}
+	return msb(remainder.data(), n) >= 0;
+}
+
+}}} // namespace sw::universal::eposit_detail
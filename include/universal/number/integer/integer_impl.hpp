@@ -16,6 +16,7 @@
 // supporting types and functions
 #include <universal/number/shared/specific_value_encoding.hpp>
 #include <universal/number/shared/blocktype.hpp>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
 #include <universal/native/integers.hpp> // just for printing native integers in binary form
 
 /*
@@ -280,15 +281,13 @@ public:
 		}
 		else {
 			integer<nbits, BlockType, NumberType> sum;
-			std::uint64_t carry = 0;
+			bt carry{ 0 };
 			BlockType* pA = _block;
 			BlockType const* pB = rhs._block;
 			BlockType* pC = sum._block;
 			BlockType* pEnd = pC + nrBlocks;
 			while (pC != pEnd) {
-				carry += static_cast<std::uint64_t>(*pA) + static_cast<std::uint64_t>(*pB);
-				*pC = static_cast<bt>(carry);
-				if constexpr (bitsInBlock == 64) carry = 0; else carry >>= bitsInBlock;
+				*pC = block_addc(*pA, *pB, carry);
 				++pA; ++pB; ++pC;
 			}
 			// enforce precondition for fast comparison by properly nulling bits that are outside of nbits
@@ -325,70 +324,26 @@ public:
 		}
 		return *this;
 	}
+	// modulo in-place: the low nbits of a 2's complement product are the low nbits of the unsigned product of the encodings
 	integer& operator*=(const integer& rhs) {
-		if constexpr (NumberType == IntegerNumberType::IntegerNumber) {
-			if constexpr (nrBlocks == 1) {
-				_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
-			}
-			else {
-				// is there a better way than upconverting to deal with maxneg in a 2's complement encoding?
-				integer<nbits + 1, BlockType, NumberType> base(*this);
-				integer<nbits + 1, BlockType, NumberType> multiplicant(rhs);
-				bool resultIsNeg = (base.isneg() ^ multiplicant.isneg());
-				if (base.isneg()) {
-					base.twosComplement();
-				}
-				if (multiplicant.isneg()) {
-					multiplicant.twosComplement();
-				}
-				clear();
-				for (unsigned i = 0; i < static_cast<unsigned>(nrBlocks); ++i) {
-					std::uint64_t segment(0);
-					for (unsigned j = 0; j < static_cast<unsigned>(nrBlocks); ++j) {
-						segment += static_cast<std::uint64_t>(base.block(i)) * static_cast<std::uint64_t>(multiplicant.block(j));
-
-						if (i + j < static_cast<unsigned>(nrBlocks)) {
-							segment += _block[i + j];
-							_block[i + j] = static_cast<bt>(segment);
-							segment >>= bitsInBlock;
-						}
-					}
-				}
-				if (resultIsNeg) twosComplement();
-			}
+		if constexpr (nrBlocks == 1) {
+			_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
 		}
-		else {  // whole and natural numbers are closed under multiplication (modulo)
-			if constexpr (nrBlocks == 1) {
-				_block[0] = static_cast<bt>(_block[0] * rhs.block(0));
-			}
-			else {
-				integer<nbits, BlockType, NumberType> base(*this), multiplicant(rhs);
-				clear();
-				for (unsigned i = 0; i < static_cast<unsigned>(nrBlocks); ++i) {
-					std::uint64_t segment(0);
-					for (unsigned j = 0; j < static_cast<unsigned>(nrBlocks); ++j) {
-						segment += static_cast<std::uint64_t>(base.block(i)) * static_cast<std::uint64_t>(multiplicant.block(j));
-
-						if (i + j < static_cast<unsigned>(nrBlocks)) {
-							segment += _block[i + j];
-							_block[i + j] = static_cast<bt>(segment);
-							segment >>= bitsInBlock;
-						}
-					}
-				}
-			}
+		else {
+			bt base[nrBlocks];
+			for (unsigned i = 0; i < nrBlocks; ++i) base[i] = _block[i];
+			block_multiply<bt, nrBlocks, nrBlocks, nrBlocks>(base, (this == &rhs ? base : rhs._block), _block);
 		}
 		// null any leading bits that fall outside of nbits
 		_block[MSU] = static_cast<bt>(MSU_MASK & _block[MSU]);
 		return *this;
 	}
 	integer& operator*=(const BlockType& scale) noexcept {
-		std::uint64_t scaleFactor(scale), segment(0);
+		BlockType carry{ 0 };
 		for (unsigned i = 0; i < nrBlocks; ++i) {
-			segment += static_cast<std::uint64_t>(_block[i]) * scaleFactor;
-			_block[i] = static_cast<BlockType>(segment);
-			segment >>= bitsInBlock;
+			_block[i] = blockmultiply_detail::mac(_block[i], scale, BlockType(0), carry);
 		}
+		_block[MSU] = static_cast<bt>(MSU_MASK & _block[MSU]);
 		return *this;
 	}
 	integer& operator/=(const integer& rhs) {
@@ -907,13 +862,34 @@ public:
 				}
 			}
 
+#if !defined(__SIZEOF_INT128__)
+			if constexpr (bitsInBlock == 64) {
+				// without a 128-bit intermediate for the quotient digit estimate, divide one bit at a time
+				Integer remainder(0);
+				for (int i = static_cast<int>(m * bitsInBlock) - 1; i >= 0; --i) {
+					remainder <<= 1;
+					remainder.setbit(0u, _a.at(static_cast<unsigned>(i)));
+					if (!(remainder < _b)) {
+						remainder -= _b;
+						setbit(static_cast<unsigned>(i));
+					}
+				}
+				for (unsigned i = 0; i < nrBlocks; ++i) r.setblock(i, remainder.block(i));
+				if (sign_q) twosComplement();
+				return;
+			}
+			else
+#endif
+			{
+			using DoubleBlock = block_double_width_t<BlockType>;
+
 			// single limb divisor
 			if (n == 1) {
-				std::uint64_t remainder{ 0 };
-				auto divisor = _b.block(0);
+				DoubleBlock remainder{ 0 };
+				DoubleBlock divisor = _b.block(0);
 				for (unsigned j = m; j > 0; --j) {
-					std::uint64_t dividend = remainder * BASE + _a.block(j - 1);
-					std::uint64_t limbQuotient = dividend / divisor;
+					DoubleBlock dividend = (remainder << bitsInBlock) | _a.block(j - 1);
+					DoubleBlock limbQuotient = dividend / divisor;
 					_block[j - 1] = static_cast<BlockType>(limbQuotient);
 					remainder = dividend - limbQuotient * divisor;
 				}
@@ -929,74 +905,64 @@ public:
 			using OriginalInteger = integer<nbits, BlockType, NumberType>;
 			using ExpandedInteger = integer<nbits + sizeof(BlockType) * 8, BlockType, NumberType>; // need room for overflow to receive the normalization bits
 
+			// the bits of the lower limb that move into the next limb: none when the shift is 0
 			int shift = nlz(b.block(n - 1));
+			auto carryOut = [shift](BlockType limb) { return static_cast<BlockType>(shift == 0 ? 0 : (limb >> (bitsInBlock - shift))); };
 			ExpandedInteger normalized_a;
-			normalized_a.setblock(m, static_cast<BlockType>((_a.block(m - 1) >> (bitsInBlock - shift))));
+			normalized_a.setblock(m, carryOut(_a.block(m - 1)));
 			for (unsigned i = m - 1; i > 0; --i) {
-				normalized_a.setblock(i, static_cast<BlockType>((_a.block(i) << shift) | (_a.block(i - 1) >> (bitsInBlock - shift))));
+				normalized_a.setblock(i, static_cast<BlockType>((_a.block(i) << shift) | carryOut(_a.block(i - 1))));
 			}
 			normalized_a.setblock(0, static_cast<BlockType>(_a.block(0) << shift));
 			// normalize b
 			OriginalInteger normalized_b;
 			unsigned n_minus_1 = n - 1;
 			for (unsigned i = n_minus_1; i > 0; --i) {
-				normalized_b.setblock(i, static_cast<BlockType>((_b.block(i) << shift) | (_b.block(i - 1) >> (bitsInBlock - shift))));
+				normalized_b.setblock(i, static_cast<BlockType>((_b.block(i) << shift) | carryOut(_b.block(i - 1))));
 			}
 			normalized_b.setblock(0, static_cast<BlockType>(_b.block(0) << shift));
 
-//			std::cout << "normalized a : " << normalized_a.showLimbs() << " : " << normalized_a.showLimbValues() << '\n';
-//			std::cout << "normalized b :             " << normalized_b.showLimbs() << " : " << normalized_b.showLimbValues() << '\n';
-
 			// divide by limb
-			std::uint64_t divisor = normalized_b._block[n - 1];
-			std::uint64_t v_nminus2 = normalized_b._block[n - 2]; // n > 1 at this point
+			constexpr DoubleBlock radix = DoubleBlock(1) << bitsInBlock;
+			DoubleBlock divisor = normalized_b._block[n - 1];
+			DoubleBlock v_nminus2 = normalized_b._block[n - 2]; // n > 1 at this point
 			for (int j = static_cast<int>(m - n); j >= 0; --j) {
-				std::uint64_t dividend = normalized_a.block(j + n) * BASE + normalized_a.block(j + n - 1);
-				std::uint64_t qhat = dividend / divisor;
-				std::uint64_t rhat = dividend - qhat * divisor;
-
-				while (qhat >= BASE || qhat * v_nminus2 > BASE * rhat + normalized_a.block(j + n - 2)) {
+				DoubleBlock dividend = (DoubleBlock(normalized_a.block(j + n)) << bitsInBlock) | normalized_a.block(j + n - 1);
+				DoubleBlock qhat = dividend / divisor;
+				DoubleBlock rhat = dividend - qhat * divisor;
+				while (qhat >= radix || qhat * v_nminus2 > ((rhat << bitsInBlock) | normalized_a.block(j + n - 2))) {
 					--qhat;
 					rhat += divisor;
-					if (rhat < BASE) continue;
+					if (rhat >= radix) break;
 				}
-				std::uint64_t borrow{ 0 };
-				std::uint64_t diff{ 0 };
+				// multiply and subtract: a[j, j + n] -= qhat * b
+				BlockType q = static_cast<BlockType>(qhat);
+				BlockType product{ 0 }, borrow{ 0 };
 				for (unsigned i = 0; i < n; ++i) {
-					std::uint64_t p = qhat * normalized_b.block(i);
-					diff = normalized_a.block(i + j) - static_cast<BlockType>(p) - borrow;
-					normalized_a.setblock(i + j, static_cast<BlockType>(diff));
-					borrow = (p >> bitsInBlock) - (diff >> bitsInBlock);
+					BlockType low = blockmultiply_detail::mac(q, normalized_b.block(i), BlockType(0), product);
+					normalized_a.setblock(i + j, block_subb(normalized_a.block(i + j), low, borrow));
 				}
-				std::int64_t signedBorrow = static_cast<int64_t>(normalized_a.block(j + n) - borrow);
-				normalized_a.setblock(j + n, static_cast<BlockType>(signedBorrow));
-
-//				std::cout << "   updated a : " << normalized_a.showLimbs() << " : " << normalized_a.showLimbValues() << '\n';
+				normalized_a.setblock(j + n, block_subb(normalized_a.block(j + n), product, borrow));
 
-				setblock(static_cast<unsigned>(j), static_cast<BlockType>(qhat));
-				if (signedBorrow < 0) { // subtracted too much, add back
-					std::cout << "subtracted too much, add back\n";
-					_block[j] -= 1;
-					std::uint64_t carry{ 0 };
+				if (borrow) { // subtracted too much, add back
+					--q;
+					BlockType carry{ 0 };
 					for (unsigned i = 0; i < n; ++i) {
-						carry += static_cast<std::uint64_t>(normalized_a.block(i + j)) + static_cast<std::uint64_t>(normalized_b.block(i));
-						normalized_a.setblock(i + j, static_cast<BlockType>(carry));
-						carry >>= 32;
+						normalized_a.setblock(i + j, block_addc(normalized_a.block(i + j), normalized_b.block(i), carry));
 					}
-					BlockType rectified = static_cast<BlockType>(normalized_a.block(j + n) + carry);
-					normalized_a.setblock(j + n, rectified);
+					normalized_a.setblock(j + n, static_cast<BlockType>(normalized_a.block(j + n) + carry));
 				}
-//				std::cout << "   updated a : " << normalized_a.showLimbs() << " : " << normalized_a.showLimbValues() << '\n';
+				setblock(static_cast<unsigned>(j), q);
 			}
 			if (sign_q) twosComplement();
 
 			// remainder needs to be normalized
+			auto carryIn = [shift](BlockType limb) { return static_cast<BlockType>(shift == 0 ? 0 : (limb << (bitsInBlock - shift))); };
 			for (unsigned i = 0; i < n - 1; ++i) {
-				std::uint64_t remainder = static_cast<uint64_t>(normalized_a.block(i) >> shift);
-				remainder |= static_cast<uint64_t>(normalized_a.block(i + 1) << (32 - shift));
-				r.setblock(i, static_cast<BlockType>(remainder));
+				r.setblock(i, static_cast<BlockType>((normalized_a.block(i) >> shift) | carryIn(normalized_a.block(i + 1))));
 			}
 			r.setblock(n - 1, static_cast<BlockType>(normalized_a.block(n - 1) >> shift));
+			}
 		}
 	}
 	// signed integer conversion
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <vector>
 #include <universal/traits/posit_traits.hpp>
+#include <universal/number/quire/fdp_qc.hpp>
 
 namespace sw { namespace universal {
 
@@ -16,15 +17,6 @@ namespace sw { namespace universal {
 /// fdp_stride     fused dot product with non-negative stride
 /// fdp            fused dot product of two vectors
 
-// Fused dot product with quire continuation
-template<typename Qy, typename Vector>
-void fdp_qc(Qy& sum_of_products, size_t n, const Vector& x, size_t incx, const Vector& y, size_t incy) {
-	size_t ix, iy;
-	for (ix = 0, iy = 0; ix < n && iy < n; ix = ix + incx, iy = iy + incy) {
-		sum_of_products += sw::universal::quire_mul(x[ix], y[iy]);
-	}
-}
-
 // Resolved fused dot product, with the option to control capacity bits in the quire
 template<typename Vector>
 enable_if_posit<value_type<Vector>, value_type<Vector> > // as return type
@@ -17,6 +17,8 @@
 #define POSIT_T POSIT_MKNAME(t)
 #define POSIT_VEC_T(width) POSIT_GLUE5(posit, POSIT_NBITS, x, width, _t)
 #define POSIT_API POSIT_GLUE(capi, POSIT_NBITS)
+#define POSIT_QUIRE_T POSIT_MKNAME(quire_t)
+#define POSIT_QUIRE_S POSIT_MKNAME(quire_s)
 
 // creates:  posit8_t posit8_subull(posit8_t p, unsigned long long x)
 // and also: posit8_t posit8_ullsub(unsigned long long x, posit8_t p)
@@ -81,6 +83,15 @@
 #ifndef POSIT_IMPLS
 typedef struct POSIT_GLUE3(posit, POSIT_NBITS, x2_s) { POSIT_T x; POSIT_T y; } POSIT_VEC_T(2);
 #endif
+// posit4 has no quire, so it has no quire handle and no fused dot product
+#if POSIT_NBITS != 4
+#ifndef POSIT_IMPLS
+// opaque handle to a quire that accumulates across calls, e.g. posit32_quire_t
+typedef struct POSIT_QUIRE_S* POSIT_QUIRE_T;
+#else
+struct POSIT_QUIRE_S { POSIT_API::quire_type q; };
+#endif
+#endif
 
 #if defined(__cplusplus) || defined(_MSC_VER)
 void POSIT_MKNAME(str)(char* out, POSIT_T p) POSIT_IMPL({ POSIT_API::format(p, out); })
@@ -114,6 +125,38 @@ POSIT_INLINE(int POSIT_MKNAME(cmp)(POSIT_T x, POSIT_T y) {
     return POSIT_GLUE3(POSIT_MKNAME(cmp), p, POSIT_NBITS)(x, y);
 })
 
+// array functions, e.g. void posit32_add_array(const posit32_t* a, const posit32_t* b, posit32_t* c, size_t n)
+// c[i] = a[i] op b[i] for i in [0, n)
+#define POSIT_ARRAY_OP(__op__) \
+    void POSIT_MKNAME(POSIT_GLUE(__op__, _array))(const POSIT_T* a, const POSIT_T* b, POSIT_T* c, size_t n) POSIT_IMPL({ \
+        POSIT_API::op21_array<POSIT_GLUE(op_, __op__)<POSIT_API::nbits, POSIT_API::es>>(a, b, c, n); \
+    })
+POSIT_ARRAY_OP(add)
+POSIT_ARRAY_OP(sub)
+POSIT_ARRAY_OP(mul)
+POSIT_ARRAY_OP(div)
+
+void POSIT_MKNAME(from_double_array)(const double* a, POSIT_T* out, size_t n) POSIT_IMPL({ POSIT_API::from_array<double>(a, out, n); })
+void POSIT_MKNAME(from_float_array)(const float* a, POSIT_T* out, size_t n) POSIT_IMPL({ POSIT_API::from_array<float>(a, out, n); })
+void POSIT_MKNAME(to_double_array)(const POSIT_T* a, double* out, size_t n) POSIT_IMPL({ POSIT_API::to_array<double>(a, out, n); })
+void POSIT_MKNAME(to_float_array)(const POSIT_T* a, float* out, size_t n) POSIT_IMPL({ POSIT_API::to_array<float>(a, out, n); })
+
+// dot rounds every multiply and add, fdp is the fused dot product with a single rounding
+POSIT_T POSIT_MKNAME(dot)(const POSIT_T* x, const POSIT_T* y, size_t n) POSIT_IMPL({ return POSIT_API::dot(x, y, n); })
+#if POSIT_NBITS != 4
+POSIT_T POSIT_MKNAME(fdp)(const POSIT_T* x, const POSIT_T* y, size_t n) POSIT_IMPL({ return POSIT_API::fdp(x, y, n); })
+
+// quire handles: a quire is allocated once and accumulates exact products across calls
+// new returns NULL when the quire can't be allocated, and round rounds the accumulated sum to a posit
+POSIT_QUIRE_T POSIT_MKNAME(quire_new)(void) POSIT_IMPL({ return new (std::nothrow) POSIT_QUIRE_S(); })
+void POSIT_MKNAME(quire_free)(POSIT_QUIRE_T q) POSIT_IMPL({ delete q; })
+void POSIT_MKNAME(quire_clear)(POSIT_QUIRE_T q) POSIT_IMPL({ q->q.clear(); })
+void POSIT_MKNAME(quire_add)(POSIT_QUIRE_T q, POSIT_T a) POSIT_IMPL({ POSIT_API::quire_add(q->q, a); })
+void POSIT_MKNAME(quire_fma)(POSIT_QUIRE_T q, POSIT_T a, POSIT_T b) POSIT_IMPL({ POSIT_API::quire_fma(q->q, a, b); })
+void POSIT_MKNAME(quire_fdp)(POSIT_QUIRE_T q, const POSIT_T* x, const POSIT_T* y, size_t n) POSIT_IMPL({ POSIT_API::quire_fdp(q->q, x, y, n); })
+POSIT_T POSIT_MKNAME(quire_round)(POSIT_QUIRE_T q) POSIT_IMPL({ return POSIT_API::quire_round(q->q); })
+#endif
+
 // posit->posit conversions
 POSIT_INLINE(POSIT_T POSIT_GLUE(POSIT_MKNAME(fromp), POSIT_NBITS)(POSIT_T p) { return p; })
 #if POSIT_NBITS != 4
@@ -164,6 +207,9 @@ POSIT_FUNCS(ui, unsigned int)
 #undef POSIT_MKNAME
 #undef POSIT_T
 #undef POSIT_API
+#undef POSIT_QUIRE_T
+#undef POSIT_QUIRE_S
+#undef POSIT_ARRAY_OP
 #undef POSIT_OP
 #undef POSIT_OPS
 #undef POSIT_FUNCS
@@ -1831,25 +1831,25 @@ inline bool operator>=(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs)
 // posit - posit binary arithmetic operators
 // BINARY ADDITION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator+(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator+(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> sum = lhs;
 	return sum += rhs;
 }
 // BINARY SUBTRACTION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator-(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator-(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> diff = lhs;
 	return diff -= rhs;
 }
 // BINARY MULTIPLICATION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator*(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator*(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> mul = lhs;
 	return mul *= rhs;
 }
 // BINARY DIVISION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator/(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator/(const posit<nbits, es>& lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> ratio(lhs);
 	return ratio /= rhs;
 }
@@ -2534,7 +2534,7 @@ inline bool operator>=(long double lhs, const posit<nbits, es>& rhs) {
 
 // BINARY ADDITION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator+(const posit<nbits, es>& lhs, double rhs) {
+inline constexpr posit<nbits, es> operator+(const posit<nbits, es>& lhs, double rhs) {
 	posit<nbits, es> sum = lhs;
 	sum += posit<nbits, es>(rhs);
 	return sum;
@@ -2550,14 +2550,14 @@ using enable_intrinsic_numerical = std::enable_if_t<is_intrinsic_numerical<T>, U
 
 // More generic alternative to avoid ambiguities with intrinsic +
 template<unsigned nbits, unsigned es, typename Value, typename = enable_intrinsic_numerical<Value> >
-inline posit<nbits, es> operator+(const posit<nbits, es>& lhs, Value rhs) {
+inline constexpr posit<nbits, es> operator+(const posit<nbits, es>& lhs, Value rhs) {
 	posit<nbits, es> sum = lhs;
 	sum += posit<nbits, es>(rhs);
 	return sum;
 }
 
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator+(double lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator+(double lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> sum(lhs);
 	sum += rhs;
 	return sum;
@@ -2565,7 +2565,7 @@ inline posit<nbits, es> operator+(double lhs, const posit<nbits, es>& rhs) {
 
 // BINARY SUBTRACTION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator-(double lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator-(double lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> diff(lhs);
 	diff -= rhs;
 	return diff;
@@ -2573,35 +2573,35 @@ inline posit<nbits, es> operator-(double lhs, const posit<nbits, es>& rhs) {
 
 // More generic alternative to avoid ambiguities with intrinsic +
 template<unsigned nbits, unsigned es, typename Value, typename = enable_intrinsic_numerical<Value> >
-inline posit<nbits, es> operator-(const posit<nbits, es>& lhs, Value rhs) {
+inline constexpr posit<nbits, es> operator-(const posit<nbits, es>& lhs, Value rhs) {
 	posit<nbits, es> diff = lhs;
 	diff -= posit<nbits, es>(rhs);
 	return diff;
 }
 
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator-(const posit<nbits, es>& lhs, double rhs) {
+inline constexpr posit<nbits, es> operator-(const posit<nbits, es>& lhs, double rhs) {
 	posit<nbits, es> diff(lhs);
 	diff -= posit<nbits, es>(rhs);
 	return diff;
 }
 // BINARY MULTIPLICATION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator*(double lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator*(double lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
 
 template<unsigned nbits, unsigned es, typename Value, typename = enable_intrinsic_numerical<Value> >
-inline posit<nbits, es> operator*(Value lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator*(Value lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
     
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator*(const posit<nbits, es>& lhs, double rhs) {
+inline constexpr posit<nbits, es> operator*(const posit<nbits, es>& lhs, double rhs) {
 	posit<nbits, es> mul(lhs);
 	mul *= posit<nbits, es>(rhs);
 	return mul;
@@ -2609,28 +2609,28 @@ inline posit<nbits, es> operator*(const posit<nbits, es>& lhs, double rhs) {
 
 // BINARY DIVISION
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator/(double lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator/(double lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
 }
 
 template<unsigned nbits, unsigned es, typename Value, typename = enable_intrinsic_numerical<Value> >
-inline posit<nbits, es> operator/(Value lhs, const posit<nbits, es>& rhs) {
+inline constexpr posit<nbits, es> operator/(Value lhs, const posit<nbits, es>& rhs) {
 	posit<nbits, es> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
 }
 
 template<unsigned nbits, unsigned es>
-inline posit<nbits, es> operator/(const posit<nbits, es>& lhs, double rhs) {
+inline constexpr posit<nbits, es> operator/(const posit<nbits, es>& lhs, double rhs) {
 	posit<nbits, es> ratio(lhs);
 	ratio /= posit<nbits, es>(rhs);
 	return ratio;
 }
 
 template<unsigned nbits, unsigned es, typename Value, typename = enable_intrinsic_numerical<Value> >
-inline posit<nbits, es> operator/(const posit<nbits, es>& lhs, Value rhs) {
+inline constexpr posit<nbits, es> operator/(const posit<nbits, es>& lhs, Value rhs) {
 	posit<nbits, es> ratio(lhs);
 	ratio /= posit<nbits, es>(rhs);
 	return ratio;
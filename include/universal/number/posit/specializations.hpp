@@ -34,6 +34,9 @@
 #pragma warning( disable : 4365 ) // warning C4365: 'initializing': conversion from 'long' to 'uint32_t', signed/unsigned mismatch
 #endif
 
+// constexpr conversions between IEEE-754 double and the encodings of the fast specializations
+#include <universal/number/posit/specialized/native_conversion.hpp>
+
 // fast specializations for special posit configurations
 #ifndef POSIT_FAST_POSIT_2_0
 #define POSIT_FAST_POSIT_2_0 0
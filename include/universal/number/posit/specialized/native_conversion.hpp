@@ -0,0 +1,133 @@
+#pragma once
+// native_conversion.hpp: constexpr conversions between IEEE-754 double and the encodings of the fast posit specializations
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <limits>
+#include <universal/utility/bit_cast.hpp>
+
+namespace sw { namespace universal {
+
+/// <summary>
+/// round a double to the encoding of a posit<nbits, es> with nbits <= 64.
+/// The regime, exponent, and fraction are assembled in a 64-bit payload and rounded to nearest,
+/// ties to even. Values beyond maxpos and below minpos saturate, NaN and infinity map to NaR.
+/// </summary>
+/// <param name="v">value to convert</param>
+/// <returns>posit encoding in the lower nbits</returns>
+template<unsigned nbits, unsigned es>
+BIT_CAST_CONSTEXPR uint64_t posit_encode_double(double v) noexcept {
+	static_assert(nbits > 2 && nbits <= 64, "posit_encode_double requires 2 < nbits <= 64");
+	static_assert(es < 12, "posit_encode_double requires the exponent and double fraction to fit in 64 bits");
+	constexpr unsigned payloadBits = nbits - 1;          // bits after the sign bit
+	constexpr uint64_t encodingMask = (nbits == 64 ? ~0ull : (1ull << nbits) - 1ull);
+	constexpr uint64_t maxposPayload = (1ull << payloadBits) - 1ull;
+	constexpr uint64_t fractionMask = 0x000F'FFFF'FFFF'FFFFull;
+	constexpr unsigned tailBits = es + 52u;             // exponent and fraction bits that follow the regime
+
+	uint64_t raw = sw::bit_cast<uint64_t>(v);
+	bool s = (raw >> 63) != 0;
+	int biasedExponent = static_cast<int>((raw >> 52) & 0x7FFull);
+	uint64_t fraction = raw & fractionMask;
+	if (biasedExponent == 0x7FF) return (1ull << (nbits - 1));   // NaR
+	if (biasedExponent == 0 && fraction == 0) return 0;
+
+	int scale = biasedExponent - 1023;
+	if (biasedExponent == 0) { // subnormal: normalize the fraction
+		scale = -1022;
+		while (!(fraction & (1ull << 52))) {
+			fraction <<= 1;
+			--scale;
+		}
+		fraction &= fractionMask;
+	}
+	// scale = k * 2^es + e, with k rounded towards minus infinity
+	constexpr int useedExponent = (1 << es);
+	int k = (scale >= 0 ? scale / useedExponent : -((-scale + useedExponent - 1) / useedExponent));
+	uint64_t e = static_cast<uint64_t>(scale - k * useedExponent);
+
+	uint64_t payload{ 0 };
+	unsigned regimeBits{ 0 };
+	if (k >= 0) {
+		if (static_cast<unsigned>(k) + 1u >= payloadBits) return (s ? ((~maxposPayload + 1ull) & encodingMask) : maxposPayload);
+		payload = ((1ull << (k + 1)) - 1ull) << 1;  // run of k+1 ones terminated by a 0
+		regimeBits = static_cast<unsigned>(k) + 2u;
+	}
+	else {
+		if (static_cast<unsigned>(-k) + 1u > payloadBits) return (s ? encodingMask : 1ull);   // minneg : minpos
+		payload = 1ull;                             // run of -k zeros terminated by a 1
+		regimeBits = static_cast<unsigned>(-k) + 1u;
+	}
+
+	uint64_t tail = (e << 52) | fraction;
+	unsigned available = payloadBits - regimeBits;
+	if (available >= tailBits) {
+		payload = (payload << available) | (tail << (available - tailBits));
+	}
+	else {
+		unsigned shift = tailBits - available;
+		payload = (payload << available) | (tail >> shift);
+		bool guard = ((tail >> (shift - 1u)) & 0x1u) != 0;
+		bool sticky = (tail & ((1ull << (shift - 1u)) - 1ull)) != 0;
+		if (guard && (sticky || (payload & 0x1u))) ++payload;
+		if (payload > maxposPayload) payload = maxposPayload;
+	}
+	return (s ? ((~payload + 1ull) & encodingMask) : payload);
+}
+
+/// <summary>
+/// convert the encoding of a posit<nbits, es> with nbits <= 64 to a double.
+/// The conversion is exact when the posit has no more than 52 fraction bits
+/// and its scale is within the double range. NaR maps to a quiet NaN.
+/// </summary>
+/// <param name="bits">posit encoding in the lower nbits</param>
+/// <returns>value of the posit</returns>
+template<unsigned nbits, unsigned es>
+constexpr double posit_decode_double(uint64_t bits) noexcept {
+	static_assert(nbits > 2 && nbits <= 64, "posit_decode_double requires 2 < nbits <= 64");
+	constexpr unsigned payloadBits = nbits - 1;
+	constexpr uint64_t encodingMask = (nbits == 64 ? ~0ull : (1ull << nbits) - 1ull);
+	constexpr uint64_t signMask = (1ull << (nbits - 1));
+
+	bits &= encodingMask;
+	if (bits == 0) return 0.0;
+	if (bits == signMask) return std::numeric_limits<double>::quiet_NaN();
+	bool s = (bits & signMask) != 0;
+	if (s) bits = (~bits + 1ull) & encodingMask;
+
+	// regime run length
+	int msb = static_cast<int>(payloadBits) - 1;
+	bool runBit = ((bits >> msb) & 0x1u) != 0;
+	int run = 0;
+	while (msb >= 0 && (((bits >> msb) & 0x1u) != 0) == runBit) {
+		++run;
+		--msb;
+	}
+	int k = (runBit ? run - 1 : -run);
+	--msb; // skip the terminating bit
+
+	// exponent and fraction bits, the exponent is zero-extended when truncated by the regime
+	unsigned remainingBits = (msb >= 0 ? static_cast<unsigned>(msb) + 1u : 0u);
+	uint64_t remaining = bits & ((1ull << remainingBits) - 1ull);
+	uint64_t e{ 0 }, fraction{ 0 };
+	unsigned fbits{ 0 };
+	if (remainingBits >= es) {
+		fbits = remainingBits - es;
+		e = remaining >> fbits;
+		fraction = remaining & ((1ull << fbits) - 1ull);
+	}
+	else {
+		e = remaining << (es - remainingBits);
+	}
+
+	// value = (2^fbits + fraction) * 2^(scale - fbits)
+	double v = static_cast<double>((1ull << fbits) | fraction);
+	int shift = k * (1 << es) + static_cast<int>(e) - static_cast<int>(fbits);
+	for (; shift > 0; --shift) v *= 2.0;
+	for (; shift < 0; ++shift) v *= 0.5;
+	return (s ? -v : v);
+}
+
+}} // namespace sw::universal
@@ -82,8 +82,8 @@ public:
 	explicit constexpr posit(unsigned int initial_value) : _bits(0)       { *this = initial_value; }
 	explicit constexpr posit(unsigned long initial_value) : _bits(0)      { *this = initial_value; }
 	explicit constexpr posit(unsigned long long initial_value) : _bits(0) { *this = initial_value; }
-	explicit           posit(float initial_value) : _bits(0)              { *this = initial_value; }
-		               posit(double initial_value) : _bits(0)             { *this = initial_value; }
+	explicit BIT_CAST_CONSTEXPR posit(float initial_value) : _bits(0)     { *this = initial_value; }
+	         BIT_CAST_CONSTEXPR posit(double initial_value) : _bits(0)    { *this = initial_value; }
 	explicit           posit(long double initial_value) : _bits(0)        { *this = initial_value; }
 
 	// assignment operators for native types
@@ -97,13 +97,13 @@ public:
 	constexpr posit& operator=(unsigned int rhs)      { return integer_assign((long)rhs); }
 	constexpr posit& operator=(unsigned long rhs)     { return integer_assign((long)rhs); }
 	constexpr posit& operator=(unsigned long long rhs){ return integer_assign((long)rhs); }
-		      posit& operator=(float rhs)             { return float_assign(double(rhs)); }
-		      posit& operator=(double rhs)            { return float_assign(rhs); }
+	BIT_CAST_CONSTEXPR posit& operator=(float rhs)    { return float_assign(double(rhs)); }
+	BIT_CAST_CONSTEXPR posit& operator=(double rhs)   { return float_assign(rhs); }
 		      posit& operator=(long double rhs)       { return float_assign(double(rhs)); }
 
 	explicit operator long double() const { return to_long_double(); }
-	explicit operator double() const { return to_double(); }
-	explicit operator float() const { return to_float(); }
+	explicit constexpr operator double() const { return to_double(); }
+	explicit constexpr operator float() const { return to_float(); }
 	explicit operator long long() const { return to_long_long(); }
 	explicit operator long() const { return to_long(); }
 	explicit operator int() const { return to_int(); }
@@ -125,7 +125,7 @@ public:
 		posit p;
 		return p.setbits((~_bits) + 1ul);
 	}
-	posit& operator+=(const posit& b) {
+	constexpr posit& operator+=(const posit& b) {
 		// process special cases
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -148,7 +148,11 @@ public:
 			lhs = -lhs & 0xFFFF;
 			rhs = -rhs & 0xFFFF;
 		}
-		if (lhs < rhs) std::swap(lhs, rhs);
+		if (lhs < rhs) {
+			uint16_t tmp = lhs;
+			lhs = rhs;
+			rhs = tmp;
+		}
 			
 		// decode the regime of lhs
 		int8_t m = 0; // pattern length
@@ -191,7 +195,7 @@ public:
 		if (sign) _bits = -_bits & 0xFFFF;
 		return *this;
 	}
-	posit& operator-=(const posit& b) {
+	constexpr posit& operator-=(const posit& b) {
 		// process special cases
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -219,7 +223,9 @@ public:
 			return *this;
 		}
 		if (lhs < rhs) {
-			std::swap(lhs, rhs);
+			uint16_t tmp = lhs;
+			lhs = rhs;
+			rhs = tmp;
 			sign = !sign;
 		}
 
@@ -270,7 +276,7 @@ public:
 		if (sign) _bits = -_bits & 0xFFFF;
 		return *this;
 	}
-	posit& operator*=(const posit& b) {
+	constexpr posit& operator*=(const posit& b) {
 		// process special cases
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -326,7 +332,7 @@ public:
 		if (sign) _bits = -_bits & 0xFFFF;
 		return *this;
 	}
-	posit& operator/=(const posit& b) {
+	constexpr posit& operator/=(const posit& b) {
 		// process special cases
 	// since we are encoding error conditions as NaR (Not a Real), we need to process that condition first
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
@@ -375,9 +381,8 @@ public:
 		exp -= remaining >> 14;
 		uint16_t rhs_fraction = (0x4000 | remaining);
 
-		div_t result = div(fraction, rhs_fraction);
-		uint32_t result_fraction = result.quot;
-		uint32_t remainder = result.rem;
+		uint32_t result_fraction = fraction / rhs_fraction;
+		uint32_t remainder = fraction % rhs_fraction;
 
 		// adjust the exponent if needed
 		if (exp < 0) {
@@ -400,20 +405,20 @@ public:
 		return *this;
 	}
 	// prefix/postfix operators
-	posit& operator++() {
+	constexpr posit& operator++() {
 		++_bits;
 		return *this;
 	}
-	posit operator++(int) {
+	constexpr posit operator++(int) {
 		posit tmp(*this);
 		operator++();
 		return tmp;
 	}
-	posit& operator--() {
+	constexpr posit& operator--() {
 		--_bits;
 		return *this;
 	}
-	posit operator--(int) {
+	constexpr posit operator--(int) {
 		posit tmp(*this);
 		operator--();
 		return tmp;
@@ -423,7 +428,7 @@ public:
 		posit p = 1.0 / *this;
 		return p;
 	}
-	posit abs() const {
+	constexpr posit abs() const {
 		if (isneg()) {
 			return posit(-*this);
 		}
@@ -431,45 +436,45 @@ public:
 	}
 
 	// Selectors
-	inline bool sign() const       { return (_bits & sign_mask); }
-	inline bool isnar() const      { return (_bits == sign_mask); }
-	inline bool iszero() const     { return (_bits == 0x0); }
-	inline bool isone() const      { return (_bits == 0x4000); } // pattern 010000...
-	inline bool isminusone() const { return (_bits == 0xC000); } // pattern 110000...
-	inline bool isneg() const      { return (_bits & sign_mask); }
-	inline bool ispos() const      { return !isneg(); }
-	inline bool ispowerof2() const { return !(_bits & 0x1); }
+	inline constexpr bool sign() const       { return (_bits & sign_mask); }
+	inline constexpr bool isnar() const      { return (_bits == sign_mask); }
+	inline constexpr bool iszero() const     { return (_bits == 0x0); }
+	inline constexpr bool isone() const      { return (_bits == 0x4000); } // pattern 010000...
+	inline constexpr bool isminusone() const { return (_bits == 0xC000); } // pattern 110000...
+	inline constexpr bool isneg() const      { return (_bits & sign_mask); }
+	inline constexpr bool ispos() const      { return !isneg(); }
+	inline constexpr bool ispowerof2() const { return !(_bits & 0x1); }
 
-	inline int sign_value() const  { return (_bits & 0x8 ? -1 : 1); }
+	inline constexpr int sign_value() const  { return (_bits & 0x8 ? -1 : 1); }
 
 	bitblock<NBITS_IS_16> get() const { bitblock<NBITS_IS_16> bb; bb = int(_bits); return bb; }
 	unsigned long long encoding() const { return (unsigned long long)(_bits); }
 
 	// Modifiers
-	inline void clear() { _bits = 0; }
-	inline void setzero() { clear(); }
-	inline void setnar() { _bits = sign_mask; }
-	inline posit& minpos() {
+	inline constexpr void clear() { _bits = 0; }
+	inline constexpr void setzero() { clear(); }
+	inline constexpr void setnar() { _bits = sign_mask; }
+	inline constexpr posit& minpos() {
 		clear();
 		return ++(*this);
 	}
-	inline posit& maxpos() {
+	inline constexpr posit& maxpos() {
 		setnar();
 		return --(*this);
 	}
-	inline posit& zero() {
+	inline constexpr posit& zero() {
 		clear();
 		return *this;
 	}
-	inline posit& minneg() {
+	inline constexpr posit& minneg() {
 		clear();
 		return --(*this);
 	}
-	inline posit& maxneg() {
+	inline constexpr posit& maxneg() {
 		setnar();
 		return ++(*this);
 	}
-	inline posit twosComplement() const {
+	inline constexpr posit twosComplement() const {
 		posit p;
 		return p.setbits(~_bits + 1ul);
 	}
@@ -527,29 +532,11 @@ private:
 		return long(to_long_double());
 	}
 #endif
-	float       to_float() const {
+	constexpr float to_float() const {
 		return (float)to_double();
 	}
-	double      to_double() const {
-		if (iszero())	return 0.0;
-		if (isnar())	return NAN;
-		bool		     	 _sign;
-		regime<nbits, es>    _regime;
-		exponent<nbits, es>  _exponent;
-		fraction<fbits>      _fraction;
-		bitblock<nbits>		 _raw_bits;
-		_raw_bits.reset();
-		uint64_t mask = 1;
-		for (unsigned i = 0; i < nbits; i++) {
-			_raw_bits.set(i, (_bits & mask));
-			mask <<= 1;
-		}
-		decode(_raw_bits, _sign, _regime, _exponent, _fraction);
-		double s = (_sign ? -1.0 : 1.0);
-		double r = _regime.value();
-		double e = _exponent.value();
-		double f = (1.0 + _fraction.value());
-		return s * r * e * f;
+	constexpr double to_double() const {
+		return posit_decode_double<NBITS_IS_16, ES_IS_1>(_bits);
 	}
 	long double to_long_double() const {
 		if (iszero())  return 0.0;
@@ -619,27 +606,13 @@ private:
 	// convert a double precision IEEE floating point to a posit<16,1>. You need to use at least doubles to capture
 	// enough bits to correctly round mul/div and elementary function results. That is, if you use a single precision
 	// float, you will inject errors in the validation suites.
-	posit& float_assign(double rhs) {
-		constexpr int dfbits = std::numeric_limits<double>::digits - 1;
-		internal::value<dfbits> v(rhs);
-		// special case processing
-		if (v.iszero()) {
-			setzero();
-			return *this;
-		}
-		if (v.isinf() || v.isnan()) {  // posit encode for FP_INFINITE and NaN as NaR (Not a Real)
-			setnar();
-			return *this;
-		}
-
-		bitblock<NBITS_IS_16> ptt;
-		convert_to_bb<NBITS_IS_16, ES_IS_1, dfbits>(v.sign(), v.scale(), v.fraction(), ptt); // TODO: needs to be faster
-		_bits = uint16_t(ptt.to_ulong());
+	BIT_CAST_CONSTEXPR posit& float_assign(double rhs) {
+		_bits = uint16_t(posit_encode_double<NBITS_IS_16, ES_IS_1>(rhs));
 		return *this;
 	}
 
 	// decode_regime takes the raw bits of the posit, and returns the regime run-length, m, and the remaining fraction bits in remainder
-	inline void decode_regime(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
+	inline constexpr void decode_regime(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFF;
 		if (bits & 0x4000) {  // positive regimes
 			while (remaining >> 15) {
@@ -656,7 +629,7 @@ private:
 			remaining &= 0x7FFF;
 		}
 	}
-	inline void extractAddand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
+	inline constexpr void extractAddand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFF;
 		if (bits & 0x4000) {  // positive regimes
 			while (remaining >> 15) {
@@ -673,7 +646,7 @@ private:
 			remaining &= 0x7FFF;
 		}
 	}
-	inline void extractMultiplicand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
+	inline constexpr void extractMultiplicand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFF;
 		if (bits & 0x4000) {  // positive regimes
 			while (remaining >> 15) {
@@ -690,7 +663,7 @@ private:
 			remaining &= 0x7FFF;
 		}
 	}
-	inline void extractDividand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
+	inline constexpr void extractDividand(const uint16_t bits, int8_t& m, uint16_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFF;
 		if (bits & 0x4000) {  // positive regimes
 			while (remaining >> 15) {
@@ -707,8 +680,8 @@ private:
 			remaining &= 0x7FFF;
 		}
 	}
-	inline uint16_t round(const int8_t m, uint16_t exp, uint32_t fraction) const {
-		uint16_t scale, regime, bits;
+	inline constexpr uint16_t round(const int8_t m, uint16_t exp, uint32_t fraction) const {
+		uint16_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (m < 0) {
 			scale = (-m & 0xFFFF);
 			regime = 0x4000 >> scale;
@@ -747,8 +720,8 @@ private:
 		}
 		return bits;
 	}
-	inline uint16_t divRound(const int8_t m, uint16_t exp, uint32_t fraction, bool nonZeroRemainder) const {
-		uint16_t scale, regime, bits;
+	inline constexpr uint16_t divRound(const int8_t m, uint16_t exp, uint32_t fraction, bool nonZeroRemainder) const {
+		uint16_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (m < 0) {
 			scale = (-m & 0xFFFF);
 			regime = 0x4000 >> scale;
@@ -789,8 +762,8 @@ private:
 		}
 		return bits;
 	}
-	inline uint16_t adjustAndRound(const int8_t m, uint16_t exp, uint32_t fraction) const {
-		uint16_t scale, regime, bits;
+	inline constexpr uint16_t adjustAndRound(const int8_t m, uint16_t exp, uint32_t fraction) const {
+		uint16_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (m < 0) {
 			scale = (-m & 0xFFFF);
 			regime = 0x4000 >> scale;
@@ -835,12 +808,12 @@ private:
 	friend std::istream& operator>> (std::istream& istr, posit<NBITS_IS_16, ES_IS_1>& p);
 
 	// posit - posit logic functions
-	friend bool operator==(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
-	friend bool operator!=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
-	friend bool operator< (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
-	friend bool operator> (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
-	friend bool operator<=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
-	friend bool operator>=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator==(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator!=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator< (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator> (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator<=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
+	friend constexpr bool operator>=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs);
 
 	friend bool operator< (const posit<NBITS_IS_16, ES_IS_1>& lhs, double rhs);
 };
@@ -901,22 +874,22 @@ inline bool twosComplementLessThan(std::uint16_t lhs, std::uint16_t rhs) {
 }
 
 // posit - posit binary logic operators
-inline bool operator==(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator==(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return lhs._bits == rhs._bits;
 }
-inline bool operator!=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator!=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return !operator==(lhs, rhs);
 }
-inline bool operator< (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator< (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return int16_t(lhs._bits) < int16_t(rhs._bits);
 }
-inline bool operator> (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator> (const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return operator< (rhs, lhs);
 }
-inline bool operator<=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator<=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return operator< (lhs, rhs) || operator==(lhs, rhs);
 }
-inline bool operator>=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
+inline constexpr bool operator>=(const posit<NBITS_IS_16, ES_IS_1>& lhs, const posit<NBITS_IS_16, ES_IS_1>& rhs) {
 	return !operator< (lhs, rhs);
 }
 
@@ -82,8 +82,8 @@ public:
 	explicit constexpr posit(unsigned int initial_value) : _bits(0) { *this = initial_value; }
 	explicit           posit(unsigned long initial_value) : _bits(0) { *this = initial_value; }
 	explicit           posit(unsigned long long initial_value) : _bits(0) { *this = initial_value; }
-	explicit           posit(float initial_value) : _bits(0) { *this = initial_value; }
-	                   posit(double initial_value) : _bits(0) { *this = initial_value; }
+	explicit BIT_CAST_CONSTEXPR posit(float initial_value) : _bits(0) { *this = initial_value; }
+	         BIT_CAST_CONSTEXPR posit(double initial_value) : _bits(0) { *this = initial_value; }
 	explicit           posit(long double initial_value) : _bits(0) { *this = initial_value; }
 
 	// assignment operators for native types
@@ -97,13 +97,13 @@ public:
 	constexpr posit& operator=(unsigned int rhs) { return integer_assign((long)(rhs)); }
 	          posit& operator=(unsigned long rhs) { return float_assign((long double)(rhs)); }
 	          posit& operator=(unsigned long long rhs) { return float_assign((long double)(rhs)); }
-	          posit& operator=(float rhs) { return float_assign((long double)rhs); }
-	          posit& operator=(double rhs) { return float_assign((long double)rhs); }
+	BIT_CAST_CONSTEXPR posit& operator=(float rhs) { return float_assign(double(rhs)); }
+	BIT_CAST_CONSTEXPR posit& operator=(double rhs) { return float_assign(rhs); }
 	          posit& operator=(long double rhs) { return float_assign(rhs); }
 
 	explicit operator long double() const { return to_long_double(); }
-	explicit operator double() const { return to_double(); }
-	explicit operator float() const { return to_float(); }
+	explicit constexpr operator double() const { return to_double(); }
+	explicit constexpr operator float() const { return to_float(); }
 	explicit operator long long() const { return to_long_long(); }
 	explicit operator long() const { return to_long(); }
 	explicit operator int() const { return to_int(); }
@@ -119,13 +119,13 @@ public:
 		_bits = uint32_t(value & 0xFFFF'FFFFul);
 		return *this;
 	}
-	posit operator-() const {
+	constexpr posit operator-() const {
 		posit p;
 		uint64_t raw = _bits;
 		return p.setbits((~raw) + 1ull);
 	}
 	// arithmetic assignment operators
-	posit& operator+=(const posit& b) {
+	constexpr posit& operator+=(const posit& b) {
 		// special case handling of the inputs
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -148,7 +148,11 @@ public:
 			lhs = -int32_t(lhs) & 0xFFFFFFFF;
 			rhs = -int32_t(rhs) & 0xFFFFFFFF;
 		}
-		if (lhs < rhs) std::swap(lhs, rhs);
+		if (lhs < rhs) {
+			uint32_t tmp = lhs;
+			lhs = rhs;
+			rhs = tmp;
+		}
 
 		// decode the regime of lhs
 		int32_t m = 0; // pattern length
@@ -190,7 +194,7 @@ public:
 	posit& operator+=(double rhs) {
 		return *this += posit<nbits, es>(rhs);
 	}
-	posit& operator-=(const posit& b) {
+	constexpr posit& operator-=(const posit& b) {
 		// special case handling of the inputs
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -218,7 +222,9 @@ public:
 			return *this;
 		}
 		if (lhs < rhs) {
-			std::swap(lhs, rhs);
+			uint32_t tmp = lhs;
+			lhs = rhs;
+			rhs = tmp;
 			sign = !sign;
 		}
 
@@ -277,7 +283,7 @@ public:
 	posit& operator-=(double rhs) {
 		return *this -= posit<nbits, es>(rhs);
 	}
-	posit& operator*=(const posit& b) {
+	constexpr posit& operator*=(const posit& b) {
 		// special case handling of the inputs
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (isnar() || b.isnar()) {
@@ -338,7 +344,7 @@ public:
 	posit& operator*=(double rhs) {
 		return *this *= posit<nbits, es>(rhs);
 	}
-	posit& operator/=(const posit& b) {
+	constexpr posit& operator/=(const posit& b) {
 		// since we are encoding error conditions as NaR (Not a Real), we need to process that condition first
 #if POSIT_THROW_ARITHMETIC_EXCEPTION
 		if (b.iszero()) {
@@ -387,9 +393,8 @@ public:
 		uint32_t rhs_fraction = ((remaining << 1) | 0x40000000) & 0x7FFFFFFF;
 
 		// execute the integer division of fractions
-		lldiv_t result = lldiv(lhs64, uint64_t(rhs_fraction));
-		uint64_t result_fraction = result.quot;
-		uint64_t remainder = result.rem;
+		uint64_t result_fraction = lhs64 / rhs_fraction;
+		uint64_t remainder = lhs64 % rhs_fraction;
 
 		// adjust exponent if underflowed
 		if (exp < 0) {
@@ -421,20 +426,20 @@ public:
 	}
 
 	// prefix/postfix operators
-	posit& operator++() {
+	constexpr posit& operator++() {
 		++_bits;
 		return *this;
 	}
-	posit operator++(int) {
+	constexpr posit operator++(int) {
 		posit tmp(*this);
 		operator++();
 		return tmp;
 	}
-	posit& operator--() {
+	constexpr posit& operator--() {
 		--_bits;
 		return *this;
 	}
-	posit operator--(int) {
+	constexpr posit operator--(int) {
 		posit tmp(*this);
 		operator--();
 		return tmp;
@@ -443,7 +448,7 @@ public:
 		posit p = 1.0 / *this;
 		return p;
 	}
-	posit abs() const {
+	constexpr posit abs() const {
 		if (isneg()) {
 			return posit(-*this);
 		}
@@ -454,23 +459,23 @@ public:
 	inline constexpr void clear() { _bits = 0x0; }
 	inline constexpr void setzero() { clear(); }
 	inline constexpr void setnar() { _bits = 0x80000000; }
-	inline posit& minpos() {
+	inline constexpr posit& minpos() {
 		clear();
 		return ++(*this);
 	}
-	inline posit& maxpos() {
+	inline constexpr posit& maxpos() {
 		setnar();
 		return --(*this);
 	}
-	inline posit& zero() {
+	inline constexpr posit& zero() {
 		clear();
 		return *this;
 	}
-	inline posit& minneg() {
+	inline constexpr posit& minneg() {
 		clear();
 		return --(*this);
 	}
-	inline posit& maxneg() {
+	inline constexpr posit& maxneg() {
 		setnar();
 		return ++(*this);
 	}
@@ -485,11 +490,11 @@ public:
 	inline constexpr bool ispos() const      { return !isneg(); }
 	inline constexpr bool ispowerof2() const { return !(_bits & 0x1); }
 
-	inline int sign_value() const { return (_bits & 0x8) ? -1 : 1; }
+	inline constexpr int sign_value() const { return (_bits & 0x8) ? -1 : 1; }
 
 	bitblock<NBITS_IS_32> get() const { bitblock<NBITS_IS_32> bb; bb = long(_bits); return bb; }
 	unsigned long long encoding() const { return (unsigned long long)(_bits); }
-	inline posit twosComplement() const {
+	inline constexpr posit twosComplement() const {
 		posit p;
 		uint64_t raw = _bits;
 		return p.setbits((~raw) + 1ull);
@@ -565,29 +570,11 @@ private:
 		return long(to_long_double());
 	}
 #endif
-	float       to_float() const {
+	constexpr float to_float() const {
 		return (float)to_double();
 	}
-	double      to_double() const {
-		if (iszero())	return 0.0;
-		if (isnar())	return NAN;
-		bool		     	 _sign;
-		regime<nbits, es>    _regime;
-		exponent<nbits, es>  _exponent;
-		fraction<fbits>      _fraction;
-		bitblock<nbits>		 _raw_bits;
-		_raw_bits.reset();
-		uint64_t mask = 1;
-		for (unsigned i = 0; i < nbits; i++) {
-			_raw_bits.set(i, (_bits & mask));
-			mask <<= 1;
-		}
-		decode(_raw_bits, _sign, _regime, _exponent, _fraction);
-		double s = (_sign ? -1.0 : 1.0);
-		double r = _regime.value();
-		double e = _exponent.value();
-		double f = (1.0 + _fraction.value());
-		return s * r * e * f;
+	constexpr double to_double() const {
+		return posit_decode_double<NBITS_IS_32, ES_IS_2>(_bits);
 	}
 	long double to_long_double() const {
 		if (iszero())  return 0.0;
@@ -651,6 +638,10 @@ private:
 		_bits = sign ? -raw : raw;
 		return *this;
 	}
+	BIT_CAST_CONSTEXPR posit& float_assign(double rhs) {
+		_bits = uint32_t(posit_encode_double<NBITS_IS_32, ES_IS_2>(rhs));
+		return *this;
+	}
 	posit& float_assign(long double rhs) {
 		constexpr int dfbits = std::numeric_limits<long double>::digits - 1;
 		internal::value<dfbits> v(rhs);
@@ -671,7 +662,7 @@ private:
 	}
 
 	// decode_regime takes the raw bits of the posit, and returns the regime run-length, m, and the remaining fraction bits in remainder
-	inline void decode_regime(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
+	inline constexpr void decode_regime(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFFFFFF;
 		if (bits & 0x40000000) {  // positive regimes
 			while (remaining >> 31) {
@@ -688,7 +679,7 @@ private:
 			remaining &= 0x7FFFFFFF;
 		}
 	}
-	inline void extractAddand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
+	inline constexpr void extractAddand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFFFFFF;
 		if (bits & 0x40000000) {  // positive regimes
 			while (remaining >> 31) {
@@ -705,7 +696,7 @@ private:
 			remaining &= 0x7FFFFFFF;
 		}
 	}
-	inline void extractMultiplicand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
+	inline constexpr void extractMultiplicand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFFFFFF;
 		if (bits & 0x40000000) {  // positive regimes
 			while (remaining >> 31) {
@@ -722,7 +713,7 @@ private:
 			remaining &= 0x7FFFFFFF;
 		}
 	}
-	inline void extractDividand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
+	inline constexpr void extractDividand(const uint32_t bits, int32_t& m, uint32_t& remaining) const {
 		remaining = (bits << 2) & 0xFFFFFFFF;
 		if (bits & 0x40000000) {  // positive regimes
 			while (remaining >> 31) {
@@ -740,8 +731,8 @@ private:
 		}
 	}
 
-	inline uint32_t round(const int8_t m, uint32_t exp, uint64_t fraction) const {
-		uint32_t scale, regime, bits;
+	inline constexpr uint32_t round(const int8_t m, uint32_t exp, uint64_t fraction) const {
+		uint32_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (m < 0) {
 			scale = -m;
 			regime = 0x40000000 >> scale;
@@ -785,8 +776,8 @@ private:
 		}
 		return bits;
 	}
-	inline uint32_t round_mul(const int8_t m, uint32_t exp, uint64_t fraction) const {
-		uint32_t scale, regime, bits;
+	inline constexpr uint32_t round_mul(const int8_t m, uint32_t exp, uint64_t fraction) const {
+		uint32_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (m < 0) {
 			scale = -m;
 			regime = 0x40000000 >> scale;
@@ -844,8 +835,8 @@ private:
 		}
 		return bits;
 	}
-	inline uint32_t adjustAndRound(const int8_t k, uint32_t exp, uint64_t frac64, bool nonZeroRemainder) const {
-		uint32_t scale, regime, bits;
+	inline constexpr uint32_t adjustAndRound(const int8_t k, uint32_t exp, uint64_t frac64, bool nonZeroRemainder) const {
+		uint32_t scale{ 0 }, regime{ 0 }, bits{ 0 };
 		if (k < 0) {
 			scale = -k;
 			regime = 0x40000000 >> scale;
@@ -889,7 +880,7 @@ private:
 			bits = uint32_t(regime) + uint32_t(exp) + uint32_t(fraction);
 			if (bitNPlusOne) bits += (bits & 0x1) | moreBits;
 #define TRACE_DIV_
-#ifdef TRACE_DIV
+#if defined(TRACE_DIV) && TRACE_DIV
 			std::cout << "universal\n";
 			std::cout << "scale          = " << scale << std::endl;
 			std::cout << std::hex;
@@ -908,12 +899,12 @@ private:
 	friend std::istream& operator>> (std::istream& istr, posit<NBITS_IS_32, ES_IS_2>& p);
 
 	// posit - posit logic functions
-	friend bool operator==(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
-	friend bool operator!=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
-	friend bool operator< (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
-	friend bool operator> (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
-	friend bool operator<=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
-	friend bool operator>=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator==(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator!=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator< (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator> (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator<=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
+	friend constexpr bool operator>=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
 
 	friend bool operator< (const posit<NBITS_IS_32, ES_IS_2>& lhs, double rhs);
 	friend bool operator< (double lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs);
@@ -975,22 +966,22 @@ inline bool twosComplementLessThan(std::uint32_t lhs, std::uint32_t rhs) {
 }
 
 // posit - posit binary logic operators
-inline bool operator==(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator==(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return lhs._bits == rhs._bits;
 }
-inline bool operator!=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator!=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return !operator==(lhs, rhs);
 }
-inline bool operator< (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator< (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return int32_t(lhs._bits) < int32_t(rhs._bits);
 }
-inline bool operator> (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator> (const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return operator< (rhs, lhs);
 }
-inline bool operator<=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator<=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return operator< (lhs, rhs) || operator==(lhs, rhs);
 }
-inline bool operator>=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
+inline constexpr bool operator>=(const posit<NBITS_IS_32, ES_IS_2>& lhs, const posit<NBITS_IS_32, ES_IS_2>& rhs) {
 	return !operator< (lhs, rhs);
 }
 
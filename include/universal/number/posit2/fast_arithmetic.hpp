@@ -0,0 +1,373 @@
+#pragma once
+// fast_arithmetic.hpp: integer decode, encode, and arithmetic on posit encodings
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <type_traits>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
+#include <universal/utility/uint128.hpp>
+
+/*
+   The posit arithmetic operators work directly on the encodings, held in an unsigned integer
+   word of WB bits: a uint64_t when the configuration fits, and a posit_limbs<L> register of L
+   64-bit limbs above that.
+
+   The decoder is shift based: the regime run length is a count of leading zeros of the
+   encoding, or of its complement, and the exponent and fraction are shifted into place. The
+   significand 1.fff comes out with its hidden bit at position WB-2, which leaves one bit of
+   headroom for the carry of an addition. The configurations are sized so that the least
+   significant fraction bit sits at position 3 or above: the three bits below it are the
+   guard, round, and sticky bits of the alignment shift of an addition.
+
+   The encoder assembles the regime, exponent, and fraction of an unrounded (sign, scale,
+   significand, sticky) triple in a single word, and rounds the bit string to nearest, ties to
+   even, once. Values beyond maxpos and below minpos saturate.
+*/
+
+namespace sw { namespace universal { namespace internal {
+
+/// <summary>
+/// fixed-size unsigned integer of nrLimbs 64-bit limbs, least significant limb first,
+/// used as encoding and significand register for posit configurations of more than 64 bits
+/// </summary>
+template<unsigned nrLimbs>
+struct posit_limbs {
+	static_assert(nrLimbs > 0, "posit_limbs requires at least one limb");
+	static constexpr unsigned nbits = 64u * nrLimbs;
+
+	uint64_t limb[nrLimbs]{};
+
+	constexpr posit_limbs() noexcept = default;
+	constexpr posit_limbs(uint64_t v) noexcept : limb{} { limb[0] = v; }
+};
+
+template<unsigned L>
+constexpr posit_limbs<L> operator~(const posit_limbs<L>& a) noexcept {
+	posit_limbs<L> r;
+	for (unsigned i = 0; i < L; ++i) r.limb[i] = ~a.limb[i];
+	return r;
+}
+template<unsigned L>
+constexpr posit_limbs<L> operator|(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	posit_limbs<L> r;
+	for (unsigned i = 0; i < L; ++i) r.limb[i] = a.limb[i] | b.limb[i];
+	return r;
+}
+template<unsigned L>
+constexpr posit_limbs<L> operator&(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	posit_limbs<L> r;
+	for (unsigned i = 0; i < L; ++i) r.limb[i] = a.limb[i] & b.limb[i];
+	return r;
+}
+template<unsigned L>
+constexpr posit_limbs<L> operator+(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	posit_limbs<L> r;
+	uint64_t carry{ 0 };
+	for (unsigned i = 0; i < L; ++i) {
+		uint64_t s = a.limb[i] + carry;
+		carry = (s < carry ? 1u : 0u);
+		r.limb[i] = s + b.limb[i];
+		carry += (r.limb[i] < s ? 1u : 0u);
+	}
+	return r;
+}
+template<unsigned L>
+constexpr posit_limbs<L> operator-(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	posit_limbs<L> r;
+	uint64_t borrow{ 0 };
+	for (unsigned i = 0; i < L; ++i) {
+		uint64_t d = a.limb[i] - borrow;
+		borrow = (a.limb[i] < borrow ? 1u : 0u);
+		r.limb[i] = d - b.limb[i];
+		borrow += (d < b.limb[i] ? 1u : 0u);
+	}
+	return r;
+}
+template<unsigned L>
+constexpr bool operator==(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	for (unsigned i = 0; i < L; ++i) if (a.limb[i] != b.limb[i]) return false;
+	return true;
+}
+template<unsigned L>
+constexpr bool operator!=(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept { return !(a == b); }
+template<unsigned L>
+constexpr bool operator<(const posit_limbs<L>& a, const posit_limbs<L>& b) noexcept {
+	for (unsigned i = L; i-- > 0; ) {
+		if (a.limb[i] != b.limb[i]) return a.limb[i] < b.limb[i];
+	}
+	return false;
+}
+
+namespace posit_fast_detail {
+
+	template<typename Word> struct word_traits;
+	template<> struct word_traits<uint64_t> { static constexpr unsigned nbits = 64; };
+	template<unsigned L> struct word_traits<posit_limbs<L>> { static constexpr unsigned nbits = posit_limbs<L>::nbits; };
+
+	constexpr unsigned countl_zero(uint64_t x) noexcept {
+		if (x == 0) return 64;
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_clzll(x));
+#else
+		unsigned n = 0;
+		while (!(x & 0x8000'0000'0000'0000ull)) { x <<= 1; ++n; }
+		return n;
+#endif
+	}
+	template<unsigned L>
+	constexpr unsigned countl_zero(const posit_limbs<L>& x) noexcept {
+		for (unsigned i = L; i-- > 0; ) {
+			if (x.limb[i]) return 64u * (L - 1u - i) + countl_zero(x.limb[i]);
+		}
+		return posit_limbs<L>::nbits;
+	}
+
+	// shifts that are defined for any shift amount, and yield 0 when all bits are shifted out
+	constexpr uint64_t shl(uint64_t x, unsigned n) noexcept { return (n >= 64 ? 0ull : x << n); }
+	constexpr uint64_t shr(uint64_t x, unsigned n) noexcept { return (n >= 64 ? 0ull : x >> n); }
+	template<unsigned L>
+	constexpr posit_limbs<L> shl(const posit_limbs<L>& x, unsigned n) noexcept {
+		posit_limbs<L> r;
+		if (n >= posit_limbs<L>::nbits) return r;
+		unsigned limbShift = n / 64u, bitShift = n % 64u;
+		for (unsigned i = L; i-- > limbShift; ) {
+			uint64_t v = x.limb[i - limbShift] << bitShift;
+			if (bitShift && i > limbShift) v |= x.limb[i - limbShift - 1u] >> (64u - bitShift);
+			r.limb[i] = v;
+		}
+		return r;
+	}
+	template<unsigned L>
+	constexpr posit_limbs<L> shr(const posit_limbs<L>& x, unsigned n) noexcept {
+		posit_limbs<L> r;
+		if (n >= posit_limbs<L>::nbits) return r;
+		unsigned limbShift = n / 64u, bitShift = n % 64u;
+		for (unsigned i = 0; i + limbShift < L; ++i) {
+			uint64_t v = x.limb[i + limbShift] >> bitShift;
+			if (bitShift && i + limbShift + 1u < L) v |= x.limb[i + limbShift + 1u] << (64u - bitShift);
+			r.limb[i] = v;
+		}
+		return r;
+	}
+
+	constexpr uint64_t low64(uint64_t x) noexcept { return x; }
+	template<unsigned L>
+	constexpr uint64_t low64(const posit_limbs<L>& x) noexcept { return x.limb[0]; }
+
+	// full product of two 64-bit limbs
+	constexpr void mul_wide(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) noexcept {
+		block_mul64(a, b, hi, lo);
+	}
+	// full product of two limb registers
+	template<unsigned L>
+	constexpr void mul_wide(const posit_limbs<L>& a, const posit_limbs<L>& b, posit_limbs<L>& hi, posit_limbs<L>& lo) noexcept {
+		uint64_t t[2 * L]{};
+		block_multiply<uint64_t, L, L, 2 * L>(a.limb, b.limb, t);
+		for (unsigned i = 0; i < L; ++i) {
+			lo.limb[i] = t[i];
+			hi.limb[i] = t[i + L];
+		}
+	}
+
+	// q = floor(r * 2^(WB-2) / d) for d <= r < 2d, sticky is set when the remainder is not 0
+	template<typename Word>
+	constexpr Word divide_significands(Word r, const Word& d, bool& sticky) noexcept {
+		constexpr unsigned WB = word_traits<Word>::nbits;
+#if UINT128_SUPPORT
+		if constexpr (std::is_same_v<Word, uint64_t>) {
+			uint128_t n = static_cast<uint128_t>(r) << (WB - 2u);
+			sticky = (n % d) != 0;
+			return static_cast<uint64_t>(n / d);
+		}
+		else
+#endif
+		{
+			Word q{ 0 };
+			for (unsigned i = WB - 1u; i-- > 0; ) {
+				if (!(r < d)) {
+					q = q | shl(Word(1), i);
+					r = r - d;
+				}
+				r = shl(r, 1);
+			}
+			sticky = (r != Word(0));
+			return q;
+		}
+	}
+
+} // namespace posit_fast_detail
+
+/// <summary>
+/// decode the encoding of a posit<nbits, es> that is neither zero nor NaR
+/// </summary>
+/// <param name="raw">encoding in the lower nbits of the word</param>
+/// <param name="s">sign</param>
+/// <param name="scale">binary scale, k * 2^es + e</param>
+/// <param name="significand">1.fff with the hidden bit at position WB-2</param>
+template<unsigned nbits, unsigned es, typename Word>
+constexpr void posit_fast_decode(Word raw, bool& s, int& scale, Word& significand) noexcept {
+	using namespace posit_fast_detail;
+	constexpr unsigned WB = word_traits<Word>::nbits;
+	static_assert(nbits >= 2 && nbits <= WB, "encoding does not fit the word");
+	constexpr Word mask = shr(~Word(0), WB - nbits);
+
+	s = (low64(shr(raw, nbits - 1u)) & 1u) != 0;
+	if (s) raw = (~raw + Word(1)) & mask;
+	Word x = shl(raw, WB - nbits + 1u);    // the regime starts at the msb
+	bool r0 = (low64(shr(x, WB - 1u)) & 1u) != 0;
+	unsigned run = (r0 ? countl_zero(~x) : countl_zero(x));
+	int k = (r0 ? static_cast<int>(run) - 1 : -static_cast<int>(run));
+	x = shl(x, run + 1u);                  // drop the regime and its terminating bit
+	int e{ 0 };
+	if constexpr (es > 0) {
+		e = static_cast<int>(low64(shr(x, WB - es)));
+		x = shl(x, es);
+	}
+	scale = k * (1 << es) + e;
+	significand = shl(Word(1), WB - 2u) | shr(x, 2u);
+}
+
+/// <summary>
+/// round an unrounded (sign, scale, significand, sticky) triple to the encoding of a posit<nbits, es>
+/// </summary>
+/// <param name="s">sign</param>
+/// <param name="scale">binary scale</param>
+/// <param name="significand">1.fff with the hidden bit at position WB-2</param>
+/// <param name="sticky">true if there are nonzero bits below the significand</param>
+/// <returns>encoding in the lower nbits of the word</returns>
+template<unsigned nbits, unsigned es, typename Word>
+constexpr Word posit_fast_encode(bool s, int scale, const Word& significand, bool sticky) noexcept {
+	using namespace posit_fast_detail;
+	constexpr unsigned WB = word_traits<Word>::nbits;
+	static_assert(nbits >= 2 && nbits <= WB, "encoding does not fit the word");
+	constexpr Word mask = shr(~Word(0), WB - nbits);
+	constexpr int maxScale = static_cast<int>(nbits - 2u) * (1 << es);
+
+	Word keep{ 0 };
+	if (scale > maxScale) {
+		keep = shr(mask, 1u);             // maxpos
+	}
+	else if (scale < -maxScale) {
+		keep = Word(1);                   // minpos
+	}
+	else {
+		int k = (scale >= 0 ? scale >> es : -((-scale + (1 << es) - 1) >> es));
+		uint64_t e = static_cast<uint64_t>(scale - k * (1 << es));
+		unsigned regimeBits = static_cast<unsigned>(k >= 0 ? k + 2 : -k + 1);
+		Word regime = (k >= 0 ? shl(~Word(0), WB - static_cast<unsigned>(k + 1)) : shl(Word(1), WB - regimeBits));
+
+		// the exponent and fraction left aligned, followed by the regime
+		Word fraction = shl(significand, 2u);
+		Word tail = fraction;
+		if constexpr (es > 0) {
+			tail = shl(Word(e), WB - es) | shr(fraction, es);
+			sticky = sticky || (shl(fraction, WB - es) != Word(0));
+		}
+		Word body = regime | shr(tail, regimeBits);
+		sticky = sticky || (shl(tail, WB - regimeBits) != Word(0));
+
+		// round the bit string after the sign to nbits-1 bits
+		keep = shr(body, WB - nbits + 1u);
+		bool guard = (low64(shr(body, WB - nbits)) & 1u) != 0;
+		sticky = sticky || (shl(body, nbits) != Word(0));
+		if (guard && (sticky || (low64(keep) & 1u))) keep = keep + Word(1);
+	}
+	return (s ? (~keep + Word(1)) & mask : keep);
+}
+
+/// <summary>
+/// sum of two posit<nbits, es> encodings that are neither zero nor NaR
+/// </summary>
+template<unsigned nbits, unsigned es, typename Word>
+constexpr Word posit_fast_add(const Word& lhs, const Word& rhs) noexcept {
+	using namespace posit_fast_detail;
+	constexpr unsigned WB = word_traits<Word>::nbits;
+	constexpr unsigned fbits = (es + 2 >= nbits ? 0 : nbits - 3 - es);
+	static_assert(fbits + 5u <= WB, "the word needs room for hidden, carry, guard, round, and sticky bits");
+
+	bool sa{ false }, sb{ false };
+	int ea{ 0 }, eb{ 0 };
+	Word ma{ 0 }, mb{ 0 };
+	posit_fast_decode<nbits, es>(lhs, sa, ea, ma);
+	posit_fast_decode<nbits, es>(rhs, sb, eb, mb);
+	if (ea < eb || (ea == eb && ma < mb)) {   // order by magnitude
+		bool st = sa; sa = sb; sb = st;
+		int et = ea; ea = eb; eb = et;
+		Word mt = ma; ma = mb; mb = mt;
+	}
+	// align the smaller operand, collapsing the bits shifted out into the sticky bit 0
+	unsigned shift = static_cast<unsigned>(ea - eb);
+	if (shift > 0) {
+		bool sticky = (shl(mb, WB - (shift < WB ? shift : WB)) != Word(0));
+		mb = shr(mb, shift) | Word(sticky ? 1u : 0u);
+	}
+	Word m{ 0 };
+	if (sa == sb) {
+		m = ma + mb;
+		if (low64(shr(m, WB - 1u)) & 1u) {  // carry out: renormalize and keep the sticky bit
+			m = shr(m, 1u) | (m & Word(1));
+			++ea;
+		}
+	}
+	else {
+		m = ma - mb;
+		if (m == Word(0)) return Word(0);
+		unsigned lz = countl_zero(m) - 1u;
+		m = shl(m, lz);
+		ea -= static_cast<int>(lz);
+	}
+	return posit_fast_encode<nbits, es>(sa, ea, m, false);
+}
+
+/// <summary>
+/// product of two posit<nbits, es> encodings that are neither zero nor NaR
+/// </summary>
+template<unsigned nbits, unsigned es, typename Word>
+constexpr Word posit_fast_mul(const Word& lhs, const Word& rhs) noexcept {
+	using namespace posit_fast_detail;
+	constexpr unsigned WB = word_traits<Word>::nbits;
+
+	bool sa{ false }, sb{ false };
+	int ea{ 0 }, eb{ 0 };
+	Word ma{ 0 }, mb{ 0 };
+	posit_fast_decode<nbits, es>(lhs, sa, ea, ma);
+	posit_fast_decode<nbits, es>(rhs, sb, eb, mb);
+	Word hi{ 0 }, lo{ 0 };
+	mul_wide(ma, mb, hi, lo);
+	// the product 1.fff * 1.fff is in [1, 4): its msb is at position 2WB-4 or 2WB-3
+	int scale = ea + eb;
+	unsigned shift = WB - 2u;
+	if (low64(shr(hi, WB - 3u)) & 1u) {
+		++scale;
+		++shift;
+	}
+	Word m = shl(hi, WB - shift) | shr(lo, shift);
+	bool sticky = (shl(lo, WB - shift) != Word(0));
+	return posit_fast_encode<nbits, es>(sa != sb, scale, m, sticky);
+}
+
+/// <summary>
+/// quotient of two posit<nbits, es> encodings that are neither zero nor NaR
+/// </summary>
+template<unsigned nbits, unsigned es, typename Word>
+constexpr Word posit_fast_div(const Word& lhs, const Word& rhs) noexcept {
+	using namespace posit_fast_detail;
+
+	bool sa{ false }, sb{ false };
+	int ea{ 0 }, eb{ 0 };
+	Word ma{ 0 }, mb{ 0 };
+	posit_fast_decode<nbits, es>(lhs, sa, ea, ma);
+	posit_fast_decode<nbits, es>(rhs, sb, eb, mb);
+	int scale = ea - eb;
+	if (ma < mb) {  // the quotient is in (1/2, 1): double the dividend so that it is in [1, 2)
+		ma = shl(ma, 1u);
+		--scale;
+	}
+	bool sticky{ false };
+	Word q = divide_significands(ma, mb, sticky);
+	return posit_fast_encode<nbits, es>(sa != sb, scale, q, sticky);
+}
+
+}}} // namespace sw::universal::internal
@@ -40,6 +40,7 @@
 #include <universal/number/posit2/exponent.hpp>
 #include <universal/number/posit2/regime.hpp>
 #include <universal/number/posit2/attributes.hpp>
+#include <universal/number/posit2/fast_arithmetic.hpp>
 
 namespace sw { namespace universal {
 
@@ -176,7 +177,6 @@ void extract_fields(const blockbinary<nbits, bt, BinaryNumberType::Signed>& raw_
 	msb = msb - int(nrExponentBits);
 	unsigned nrFractionBits = (msb < 0 ? 0ull : static_cast<unsigned>(msb) + 1ull);
 	if (msb >= 0) {
-		std::cout <<  "  : " << to_binary(_frac) << '\n';
 		unsigned msfbit = static_cast<unsigned>(msb);
 		for (unsigned i = 0; i <= msfbit; ++i) {
 			_frac.setbit(fbits - 1ull - (msfbit - i), tmp.at(i));
@@ -463,6 +463,11 @@ public:
 
 	typedef bt BlockType;
 
+	// the arithmetic works on the encoding in a single 64-bit word when the significand and its
+	// carry, guard, round, and sticky bits fit in it, and in a register of 64-bit limbs otherwise
+	static constexpr bool     singleWord = (nbits <= 64 && fbits + 5 <= 64);
+	using EncodingWord = std::conditional_t<singleWord, std::uint64_t, internal::posit_limbs<(nbits + 2 + 63) / 64>>;
+
 	/// trivial constructor
 	posit() = default;
 	
@@ -636,7 +641,8 @@ public:
 		return tmp;
 	}
 
-	// we model a hw pipeline with register assignments, functional block, and conversion
+	// the arithmetic operators decode the encodings with shifts and a count of leading zeros,
+	// compute the unrounded result with integer arithmetic, and round it once when encoding
 	posit& operator+=(const posit& rhs) {
 		if (_trace_add) std::cout << "---------------------- ADD -------------------" << std::endl;
 		// special case handling of the inputs
@@ -656,29 +662,11 @@ public:
 		}
 		if (rhs.iszero()) return *this;
 
-		// arithmetic operation
-		blocktriple<fbits, BlockTripleOperator::ADD, bt> a, b, sum;
-
-		// transform the inputs into (sign,scale,fraction) triples
-		normalizeAddition(a);
-		rhs.normalizeAddition(b);
-		//module_add<fbits,abits>(a, b, sum);		// add the two inputs
-		sum.add(a, b);
-
-		// special case handling of the result
-		if (sum.iszero()) {
-			setzero();
-		}
-		else if (sum.isinf()) {
-			setnar();
-		}
-		else {
-			convert(sum, *this);
-		}
+		setencoding(internal::posit_fast_add<nbits, es>(encoding_word(), rhs.encoding_word()));
 		return *this;                
 	}
 	posit& operator+=(double rhs) {
-		return *this += posit<nbits, es>(rhs);
+		return *this += posit(rhs);
 	}
 	posit& operator-=(const posit& rhs) {
 		if (_trace_sub) std::cout << "---------------------- SUB -------------------" << std::endl;
@@ -699,31 +687,11 @@ public:
 		}
 		if (rhs.iszero()) return *this;
 
-		// arithmetic operation
-		//		internal::value<abits + 1> difference;
-		//		internal::value<fbits> a, b;
-//		blocktriple<fbits, BlockTripleOperator::ADD, bt> a, b, difference;
-		blocktriple<fbits, BlockTripleOperator::ADD, bt> difference;
-
-		// transform the inputs into (sign,scale,fraction) triples
-//		normalize(a);
-//		rhs.normalize(b);
-//		module_subtract<fbits, abits>(a, b, difference);	// add the two inputs
-
-		// special case handling of the result
-		if (difference.iszero()) {
-			setzero();
-		}
-		else if (difference.isinf()) {
-			setnar();
-		}
-		else {
-			// convert(difference, *this);
-		}
+		setencoding(internal::posit_fast_add<nbits, es>(encoding_word(), (-rhs).encoding_word()));
 		return *this;
 	}
 	posit& operator-=(double rhs) {
-		return *this -= posit<nbits, es>(rhs);
+		return *this -= posit(rhs);
 	}
 	posit& operator*=(const posit& rhs) {
 		static_assert(fhbits > 0, "posit configuration does not support multiplication");
@@ -744,29 +712,11 @@ public:
 			return *this;
 		}
 
-		// arithmetic operation
-		internal::value<mbits> product;
-		internal::value<fbits> a, b;
-		// transform the inputs into (sign,scale,fraction) triples
-		normalize(a);
-		rhs.normalize(b);
-
-		module_multiply(a, b, product);    // multiply the two inputs
-
-		// special case handling on the output
-		if (product.iszero()) {
-			setzero();
-		}
-		else if (product.isinf()) {
-			setnar();
-		}
-		else {
-			convert(product, *this);
-		}
+		setencoding(internal::posit_fast_mul<nbits, es>(encoding_word(), rhs.encoding_word()));
 		return *this;
 	}
 	posit& operator*=(double rhs) {
-		return *this *= posit<nbits, es>(rhs);
+		return *this *= posit(rhs);
 	}
 	posit& operator/=(const posit& rhs) {
 		if (_trace_div) std::cout << "---------------------- DIV -------------------" << std::endl;
@@ -797,37 +747,8 @@ public:
 			return *this;
 		}
 #endif
-		internal::value<divbits> ratio;
-		internal::value<fbits> a, b;
-		// transform the inputs into (sign,scale,fraction) triples
-		normalize(a);
-		rhs.normalize(b);
-
-		module_divide(a, b, ratio);
-
-		// special case handling on the output
-#if POSIT_THROW_ARITHMETIC_EXCEPTION
-		if (ratio.iszero()) {
-			throw posit_division_result_is_zero{};
-		}
-		else if (ratio.isinf()) {
-			throw posit_division_result_is_infinite{};
-		}
-		else {
-			convert<nbits, es, bt, divbits>(ratio, *this);
-		}
-#else
-		if (ratio.iszero()) {
-			setzero();  // this shouldn't happen as we should project back onto minpos
-		}
-		else if (ratio.isinf()) {
-			setnar();  // this shouldn't happen as we should project back onto maxpos
-		}
-		else {
-			convert<nbits, es, bt, divbits>(ratio, *this);
-		}
-#endif
-
+		// the quotient of two posits is never 0 or NaR: it saturates to minpos and maxpos
+		setencoding(internal::posit_fast_div<nbits, es>(encoding_word(), rhs.encoding_word()));
 		return *this;
 	}
 	posit& operator/=(double rhs) {
@@ -922,20 +843,19 @@ public:
 	// Selectors
 	constexpr bool sign() const noexcept { return _block.test(nbits - 1); }
 	int scale() const noexcept { 
-		blockbinary<nbits, bt> tmp(bits());
-		tmp = sign() ? twosComplement(tmp) : tmp;
-		regime<nbits, es, bt> r;
-		int k = decode_regime(tmp);
-		unsigned nrRegimeBits = r.assign_regime_pattern(k);
-		exponent<nbits, es, bt> e;
-		e.extract_exponent_bits(tmp, nrRegimeBits);
-		return r.scale() + e.scale();
-	}
-	constexpr bool isnar() const noexcept {
-		if (!_block.test(nbits - 1)) return false;
-		blockbinary<nbits, bt> tmp(_block);			
-		tmp.setbit(nbits - 1, false);
-		return tmp.none();
+		if (iszero() || isnar()) return 0;
+		bool s{ false };
+		int scale{ 0 };
+		EncodingWord significand{ 0 };
+		internal::posit_fast_decode<nbits, es>(encoding_word(), s, scale, significand);
+		return scale;
+	}
+	constexpr bool isnar() const noexcept { // pattern 100000..., compared a block at a time
+		if (_block.block(MSU) != SIGN_BIT_MASK) return false;
+		for (unsigned b = 0; b < MSU; ++b) {
+			if (_block.block(b) != 0) return false;
+		}
+		return true;
 	}
 	constexpr bool iszero() const noexcept { return _block.none() ? true : false; }
 	constexpr bool isone() const noexcept { // pattern 010000....
@@ -962,7 +882,7 @@ public:
 	constexpr bool isinteger() const noexcept { return true; } // TODO: return (floor(*this) == *this) ? true : false; }
 
 	blockbinary<nbits, bt, BinaryNumberType::Signed> bits() const noexcept { return _block; }
-	unsigned long long encoding() const noexcept { return _block.to_ullong(); }
+	unsigned long long encoding() const noexcept { return _block.to_ull(); }
 
 	// Modifiers
 	constexpr void clear() noexcept { _block.clear(); }
@@ -1006,14 +926,7 @@ public:
 	}
 	// Set the raw bits of the posit given an unsigned value starting from the lsb. Handy for enumerating a posit state space
 	constexpr posit<nbits, es, bt>& setbits(uint64_t value) {
-		clear();
-		blockbinary<nbits, bt, BinaryNumberType::Signed> raw_bits;
-		uint64_t mask = 1ull;
-		for ( unsigned i = 0; i < nbits; ++i ) {
-			raw_bits.setbit(i,(value & mask));
-			mask <<= 1;
-		}
-		_block = raw_bits;
+		_block.setbits(value);
 		return *this;
 	}
 
@@ -1055,54 +968,6 @@ public:
 	}
 */
 
-	constexpr void normalizeAddition(blocktriple<fbits, BlockTripleOperator::ADD, bt>& tgt) const {
-		using BlockTripleConfiguration = blocktriple<fbits, BlockTripleOperator::ADD, bt>;
-		// test special cases
-		if (isnar()) {
-			tgt.setnan();
-		}
-		else if (iszero()) {
-			tgt.setzero();
-		}
-		else {
-			tgt.setnormal(); // a blocktriple is always normalized
-			int scale = this->scale();
-			tgt.setsign(sign());
-			tgt.setscale(scale);
-			// set significant
-			// we are going to unify to the format 001.ffffeeee
-			// where 'f' is a fraction bit, and 'e' is an extension bit
-			// so that normalize can be used to generate blocktriples for add/sub/mul/div/sqrt
-/*
-			if constexpr (fbits < 64 && BlockTripleConfiguration::rbits < (64 - fbits)) {
-				uint64_t raw = fraction_ull();
-				raw |= (1ull << fbits); // add the hidden bit
-				//std::cout << "normalize      : " << *this << '\n';
-				//std::cout << "significant    : " << to_binary(raw, fbits + 2) << '\n';
-				raw <<= BlockTripleConfiguration::rbits;  // rounding bits required for correct rounding
-				//std::cout << "rounding shift : " << to_binary(raw, fbits + 2 + BlockTripleConfiguration::rbits) << '\n';
-				tgt.setbits(raw);
-			}
-			else {
-				blockcopy(tgt);
-				tgt.setradix();
-				tgt.setbit(fbits); // add the hidden bit
-				tgt.bitShift(BlockTripleConfiguration::rbits);  // rounding bits required for correct rounding
-			}
-*/
-			unsigned FSU = MSU;
-			unsigned FSU_MASK = 0x07FFu; // s rr ee fff ... fff  nbits is 16 es = 2, bt is uint16
-			for (unsigned i = 0; i < FSU; ++i) {
-				tgt.setblock(i, _block[i]);
-			}
-			tgt.setblock(FSU, static_cast<bt>(_block[FSU] & FSU_MASK));
-			tgt.setradix();
-			tgt.setbit(fbits); // add the hidden bit
-			tgt.bitShift(BlockTripleConfiguration::rbits);  // rounding bits required for correct rounding
-		}
-		// tgt.setradix(radix);
-	}
-	
 	// helper debug function
 	void constexprClassParameters() const noexcept {
 		std::cout << "-------------------------------------------------------------\n";
@@ -1130,41 +995,72 @@ private:
 
 	// HELPER methods
 
+	// the encoding in the lower nbits of an arithmetic word
+	constexpr EncodingWord encoding_word() const noexcept {
+		EncodingWord w{ 0 };
+		for (unsigned b = 0; b < nrBlocks; ++b) {
+			uint64_t limb = static_cast<uint64_t>(_block.block(b));
+			if constexpr (singleWord) {
+				w |= limb << (b * bitsInBlock);
+			}
+			else {
+				w.limb[(b * bitsInBlock) / 64] |= limb << ((b * bitsInBlock) % 64);
+			}
+		}
+		return w;
+	}
+	constexpr void setencoding(const EncodingWord& w) noexcept {
+		for (unsigned b = 0; b < nrBlocks; ++b) {
+			if constexpr (singleWord) {
+				_block.setblock(b, static_cast<bt>(w >> (b * bitsInBlock)));
+			}
+			else {
+				_block.setblock(b, static_cast<bt>(w.limb[(b * bitsInBlock) / 64] >> ((b * bitsInBlock) % 64)));
+			}
+		}
+	}
+
 	template<typename Real>
 	Real to_native() const {
-		if (iszero())  return 0.0l;
-		if (isnar())   return std::numeric_limits<Real>::quiet_NaN();;
-		bool		     		_sign{ false };
-		regime<nbits, es, bt>   _regime;
-		exponent<nbits, es, bt> _exponent;
-		fraction<fbits, bt>     _fraction;
-		decode(_block, _sign, _regime, _exponent, _fraction);
-		Real s = (_sign ? -1.0l : 1.0l);
-		Real r = _regime.value();
-		Real e = _exponent.value();
-		Real f = (1.0l + _fraction.value());
-		return s * r * e * f;
+		if (iszero())  return Real(0.0);
+		if (isnar())   return std::numeric_limits<Real>::quiet_NaN();
+		bool s{ false };
+		int scale{ 0 };
+		EncodingWord significand{ 0 };
+		internal::posit_fast_decode<nbits, es>(encoding_word(), s, scale, significand);
+		// the upper 64 bits of the significand, with the hidden bit at position 62
+		constexpr unsigned WB = internal::posit_fast_detail::word_traits<EncodingWord>::nbits;
+		uint64_t top = internal::posit_fast_detail::low64(internal::posit_fast_detail::shr(significand, WB - 64u));
+		Real v = std::ldexp(static_cast<Real>(top), scale - 62);
+		return (s ? -v : v);
 	}
 	
 	template <typename Real>
 	CONSTEXPRESSION posit<nbits, es, bt>& convert_ieee754(const Real& rhs) noexcept {
-		constexpr int dfbits = std::numeric_limits<Real>::digits - 1;
-		blocktriple<dfbits, BlockTripleOperator::REP, bt> v(rhs);
-
-		std::cout << "real fbits : " << dfbits << '\n';
-		std::cout << " >>> " << to_triple(v) << " : " << v << " vs " << rhs << '\n';
-
-		// special case processing
-		if (v.iszero()) {
+		using namespace internal::posit_fast_detail;
+		constexpr unsigned WB = internal::posit_fast_detail::word_traits<EncodingWord>::nbits;
+		if (rhs == Real(0)) {
 			setzero();
 			return *this;
 		}
-		if (v.isinf() || v.isnan()) {  // posit encode for FP_INFINITE and NaN as NaR (Not a Real)
+		if (std::isinf(rhs) || std::isnan(rhs)) {  // posit encode for FP_INFINITE and NaN as NaR (Not a Real)
 			setnar();
 			return *this;
 		}
-
-		convert(v, *this);
+		// significand with its msb at position 63
+		int exp{ 0 };
+		Real m = std::frexp(std::fabs(rhs), &exp);
+		uint64_t raw = static_cast<uint64_t>(std::ldexp(m, 64));
+		EncodingWord significand{ 0 };
+		bool sticky{ false };
+		if constexpr (WB == 64) {
+			significand = raw >> 1;
+			sticky = (raw & 1u) != 0;
+		}
+		else {
+			significand = shl(EncodingWord(raw), WB - 65u);
+		}
+		setencoding(internal::posit_fast_encode<nbits, es>(std::signbit(rhs), exp - 1, significand, sticky));
 		return *this;
 	}
 
@@ -0,0 +1,45 @@
+#pragma once
+// fdp.hpp: fused dot product interfaces for the number systems with a Kulisch quire
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/traits/integral_constant.hpp>
+#include <universal/number/quire/kulisch.hpp>
+#include <universal/number/quire/fdp_qc.hpp>
+
+namespace sw { namespace universal {
+
+/// //////////////////////////////////////////////////////////////////
+/// fused dot product operators for cfloat, fixpnt, lns, and bfloat16
+/// fdp_qc         fused dot product with quire continuation, use a kulisch_quire<Scalar> as continuation
+/// fdp_stride     fused dot product with non-negative stride
+/// fdp            fused dot product of two vectors
+
+// Resolved fused dot product with non-negative stride
+template<typename Vector>
+enable_if_kulisch<value_type<Vector>, value_type<Vector> > // as return type
+fdp_stride(size_t n, const Vector& x, size_t incx, const Vector& y, size_t incy) {
+	using Scalar = typename Vector::value_type;
+	kulisch_quire<Scalar> q;
+	size_t ix, iy;
+	for (ix = 0, iy = 0; ix < n && iy < n; ix = ix + incx, iy = iy + incy) {
+		q += sw::universal::quire_mul(x[ix], y[iy]);
+	}
+	return q.to_value();  // one and only rounding step of the fused-dot product
+}
+
+// Specialized resolved fused dot product that assumes unit stride
+template<typename Vector>
+enable_if_kulisch<value_type<Vector>, value_type<Vector> > // as return type
+fdp(const Vector& x, const Vector& y) {
+	using Scalar = typename Vector::value_type;
+	kulisch_quire<Scalar> q;
+	size_t ix, iy, n = size(x);
+	for (ix = 0, iy = 0; ix < n && iy < n; ++ix, ++iy) {
+		q += sw::universal::quire_mul(x[ix], y[iy]);
+	}
+	return q.to_value();  // one and only rounding step of the fused-dot product
+}
+
+}} // namespace sw::universal
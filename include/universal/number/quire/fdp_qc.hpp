@@ -0,0 +1,20 @@
+#pragma once
+// fdp_qc.hpp: fused dot product with quire continuation, shared by the posit quire and the Kulisch quire
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+
+namespace sw { namespace universal {
+
+// Fused dot product with quire continuation
+template<typename Qy, typename Vector>
+void fdp_qc(Qy& sum_of_products, size_t n, const Vector& x, size_t incx, const Vector& y, size_t incy) {
+	size_t ix, iy;
+	for (ix = 0, iy = 0; ix < n && iy < n; ix = ix + incx, iy = iy + incy) {
+		sum_of_products += quire_mul(x[ix], y[iy]);  // found through ADL at the point of instantiation
+	}
+}
+
+}} // namespace sw::universal
@@ -0,0 +1,392 @@
+#pragma once
+// kulisch.hpp: generic limb-based Kulisch super-accumulator for the fused dot product of non-posit number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <universal/utility/uint128.hpp>
+#include <universal/number/cfloat/cfloat_fwd.hpp>
+#include <universal/number/fixpnt/fixpnt_fwd.hpp>
+#include <universal/number/lns/lns_fwd.hpp>
+#include <universal/number/bfloat/bfloat16_fwd.hpp>
+
+/*
+   The kulisch_quire is a two's complement fixed-point accumulator, stored in 64-bit limbs,
+   that spans the dynamic range of the products of a number system plus capacity bits
+   to absorb carries. Values and unrounded products are accumulated without error, and
+   the sum is rounded once when it is converted back to the number system.
+
+   A number system participates through its quire_traits, which define
+     enabled     : the configuration is supported, see below
+     min_scale   : binary scale of the smallest ULP of the number system
+     max_scale   : binary scale of the largest value, i.e. |v| < 2^(max_scale + 1)
+     fixed_point : the values are integers scaled by 2^min_scale, such as fixpnt
+     exact       : the values are dyadic rationals of at most 53 significant bits
+
+   Floating-point values are decomposed through their double representation, and the final
+   conversion rounds to odd into a double and then to the target, which is a correct single
+   rounding for targets of at most 51 bits of precision. Floating-point configurations are
+   therefore enabled when they have at most 51 bits of precision and a dynamic range that
+   fits comfortably within the normal range of a double, and fixpnt configurations when
+   they are at most 64 bits wide. lns values are not dyadic rationals:
+   their products are exact in the logarithmic domain and are accumulated as their nearest
+   double, so the lns fused dot product is not exact but has a single rounding in the target.
+*/
+
+namespace sw { namespace universal {
+
+template<typename Scalar>
+struct quire_traits {
+	static constexpr bool enabled = false;
+};
+
+template<unsigned nbits, unsigned es, typename bt, bool hasSubnormals, bool hasSupernormals, bool isSaturating>
+struct quire_traits< cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating> > {
+	using Scalar = cfloat<nbits, es, bt, hasSubnormals, hasSupernormals, isSaturating>;
+	static constexpr bool fixed_point = false;
+	static constexpr bool exact       = true;
+	static constexpr int  precision   = static_cast<int>(nbits - es);
+	static constexpr int  min_scale   = Scalar::MIN_EXP_SUBNORMAL;
+	static constexpr int  max_scale   = Scalar::MAX_EXP;
+	static constexpr bool enabled     = (precision <= 51 && min_scale > -960 && max_scale < 960);
+};
+
+template<>
+struct quire_traits< bfloat16 > {
+	static constexpr bool enabled     = true;
+	static constexpr bool fixed_point = false;
+	static constexpr bool exact       = true;
+	static constexpr int  precision   = 8;
+	static constexpr int  min_scale   = -133;
+	static constexpr int  max_scale   = 127;
+};
+
+template<unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+struct quire_traits< fixpnt<nbits, rbits, arithmetic, bt> > {
+	static constexpr bool enabled     = (nbits <= 64);
+	static constexpr bool fixed_point = true;
+	static constexpr bool exact       = true;
+	static constexpr bool saturating  = !arithmetic;
+	static constexpr int  precision   = static_cast<int>(nbits);
+	static constexpr int  min_scale   = -static_cast<int>(rbits);
+	static constexpr int  max_scale   = static_cast<int>(nbits) - static_cast<int>(rbits) - 1;
+};
+
+template<unsigned nbits, unsigned rbits, typename bt, auto... xtra>
+struct quire_traits< lns<nbits, rbits, bt, xtra...> > {
+	using Scalar = lns<nbits, rbits, bt, xtra...>;
+	static constexpr bool fixed_point = false;
+	static constexpr bool exact       = false;
+	static constexpr int  precision   = static_cast<int>(rbits) + 1;
+	static constexpr bool enabled     = (Scalar::min_exponent > -900 && Scalar::max_exponent < 900 && precision <= 51);
+	static constexpr int  min_scale   = (enabled ? static_cast<int>(Scalar::min_exponent) - 53 : 0);
+	static constexpr int  max_scale   = (enabled ? static_cast<int>(Scalar::max_exponent) + 1 : 0);
+};
+
+template<typename Scalar>
+constexpr bool is_kulisch_enabled = quire_traits<Scalar>::enabled;
+
+template<typename Scalar, typename Type = void>
+using enable_if_kulisch = std::enable_if_t<is_kulisch_enabled<Scalar>, Type>;
+
+// unrounded product of two values of a number system: (-1)^sign * (hi * 2^64 + lo) * 2^scale
+template<typename Scalar>
+struct kulisch_product {
+	bool     special{ false };  // NaN or infinite operand
+	bool     sign{ false };
+	uint64_t hi{ 0 };
+	uint64_t lo{ 0 };
+	int      scale{ 0 };
+};
+
+namespace kulisch_detail {
+
+	inline unsigned countr_zero(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+		unsigned n = 0;
+		while ((x & 1ull) == 0) { x >>= 1; ++n; }
+		return n;
+#endif
+	}
+
+	inline unsigned bit_width(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		return (x == 0 ? 0u : 64u - static_cast<unsigned>(__builtin_clzll(x)));
+#else
+		unsigned n = 0;
+		while (x) { x >>= 1; ++n; }
+		return n;
+#endif
+	}
+
+	// full 64x64 -> 128-bit product
+	inline void mul64(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) noexcept {
+#if UINT128_SUPPORT
+		uint128_t p = static_cast<uint128_t>(a) * b;
+		hi = static_cast<uint64_t>(p >> 64);
+		lo = static_cast<uint64_t>(p);
+#else
+		uint64_t a0 = a & 0xFFFF'FFFFull, a1 = a >> 32, b0 = b & 0xFFFF'FFFFull, b1 = b >> 32;
+		uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+		uint64_t mid = (p00 >> 32) + (p01 & 0xFFFF'FFFFull) + (p10 & 0xFFFF'FFFFull);
+		lo = (mid << 32) | (p00 & 0xFFFF'FFFFull);
+		hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+	}
+
+	// decompose a value into (-1)^sign * mantissa * 2^scale with an odd mantissa; returns false for zero
+	template<typename Scalar>
+	bool decompose(const Scalar& v, bool& special, bool& sign, uint64_t& mantissa, int& scale) {
+		using Traits = quire_traits<Scalar>;
+		special = false;
+		if constexpr (Traits::fixed_point) {
+			constexpr unsigned nbits = Traits::precision;
+			static_assert(nbits <= 64, "the Kulisch quire supports fixpnt configurations of at most 64 bits");
+			auto bb = v.bits();
+			uint64_t raw{ 0 };
+			for (unsigned b = 0; b < bb.nrBlocks; ++b) raw |= static_cast<uint64_t>(bb.block(b)) << ((b * bb.bitsInBlock) % 64);
+			if constexpr (nbits < 64) raw &= (1ull << nbits) - 1ull;
+			if (raw == 0) return false;
+			sign = ((raw >> (nbits - 1)) & 1ull) != 0;
+			mantissa = sign ? ((~raw + 1ull) & (nbits < 64 ? ((1ull << (nbits % 64)) - 1ull) : ~0ull)) : raw;
+			scale = Traits::min_scale;
+		}
+		else {
+			double d = double(v);
+			if (d == 0.0) return false;
+			if (!std::isfinite(d)) {
+				special = true;
+				return true;
+			}
+			sign = std::signbit(d);
+			int e;
+			double f = std::frexp(std::fabs(d), &e);  // f in [0.5, 1)
+			mantissa = static_cast<uint64_t>(std::ldexp(f, 53));
+			scale = e - 53;
+		}
+		unsigned tz = countr_zero(mantissa);
+		mantissa >>= tz;
+		scale += static_cast<int>(tz);
+		return true;
+	}
+
+} // namespace kulisch_detail
+
+// the unrounded product of two values of a number system with a Kulisch quire
+template<typename Scalar, typename = enable_if_kulisch<Scalar>>
+kulisch_product<Scalar> quire_mul(const Scalar& a, const Scalar& b) {
+	kulisch_product<Scalar> p;
+	bool sa, sb, xa, xb;
+	uint64_t ma, mb;
+	int ea, eb;
+	bool nza = kulisch_detail::decompose(a, xa, sa, ma, ea);
+	bool nzb = kulisch_detail::decompose(b, xb, sb, mb, eb);
+	if (xa || xb) {
+		p.special = true;
+		return p;
+	}
+	if (!nza || !nzb) return p;  // zero product
+	p.sign = (sa != sb);
+	kulisch_detail::mul64(ma, mb, p.hi, p.lo);
+	p.scale = ea + eb;
+	return p;
+}
+
+/// <summary>
+/// kulisch_quire is an exact accumulator of values and unrounded products of a number system
+/// </summary>
+/// <typeparam name="Scalar">number system with quire_traits</typeparam>
+/// <typeparam name="capacity">number of carry bits, supports at least 2^capacity accumulations</typeparam>
+template<typename Scalar, unsigned capacity = 30>
+class kulisch_quire {
+	using Traits = quire_traits<Scalar>;
+	static_assert(Traits::enabled, "number system does not have a Kulisch quire");
+public:
+	static constexpr int      lsbScale = 2 * Traits::min_scale;                  // weight of bit 0 of the accumulator
+	static constexpr int      msbScale = 2 * Traits::max_scale + 1;              // weight of the largest product bit
+	static constexpr unsigned qbits    = static_cast<unsigned>(msbScale - lsbScale + 1) + capacity + 1;  // plus the sign bit
+	static constexpr unsigned nrLimbs  = (qbits + 63) / 64;
+
+	kulisch_quire() noexcept { clear(); }
+	kulisch_quire(const Scalar& v) { clear(); *this += v; }
+
+	kulisch_quire& operator=(const Scalar& v) { clear(); return *this += v; }
+
+	kulisch_quire& operator+=(const Scalar& v) { return accumulate(v, false); }
+	kulisch_quire& operator-=(const Scalar& v) { return accumulate(v, true); }
+	kulisch_quire& operator+=(const kulisch_product<Scalar>& p) {
+		if (p.special) _special = true; else add(p.sign, p.hi, p.lo, p.scale);
+		return *this;
+	}
+	kulisch_quire& operator-=(const kulisch_product<Scalar>& p) {
+		if (p.special) _special = true; else add(!p.sign, p.hi, p.lo, p.scale);
+		return *this;
+	}
+
+	void clear() noexcept {
+		for (unsigned i = 0; i < nrLimbs; ++i) _limb[i] = 0;
+		_special = false;
+	}
+	void reset() noexcept { clear(); }
+
+	bool iszero() const noexcept {
+		for (unsigned i = 0; i < nrLimbs; ++i) if (_limb[i]) return false;
+		return !_special;
+	}
+	bool isnan() const noexcept { return _special; }
+	bool sign() const noexcept { return (_limb[nrLimbs - 1] >> 63) != 0; }
+
+	// round the accumulated value to the number system: the one and only rounding step of the fused dot product
+	Scalar to_value() const {
+		if (_special) return Scalar(std::numeric_limits<double>::quiet_NaN());
+		uint64_t mag[nrLimbs];
+		bool negative = sign();
+		magnitude(mag, negative);
+		int msb = -1;
+		for (int i = static_cast<int>(nrLimbs) - 1; i >= 0; --i) {
+			if (mag[i]) {
+				msb = i * 64 + static_cast<int>(kulisch_detail::bit_width(mag[i])) - 1;
+				break;
+			}
+		}
+		if (msb < 0) return Scalar(0);
+		if constexpr (Traits::fixed_point) {
+			return round_fixed_point(mag, negative, msb);
+		}
+		else {
+			// round to odd to 53 bits so that the conversion to the target rounds once
+			uint64_t top = window(mag, msb - 63);
+			bool sticky = (top & 0x7FFull) != 0 || any_below(mag, msb - 63);
+			uint64_t mantissa53 = (top >> 11) | (sticky ? 1ull : 0ull);
+			double d = std::ldexp(static_cast<double>(mantissa53), msb - 52 + lsbScale);
+			return Scalar(negative ? -d : d);
+		}
+	}
+
+private:
+	uint64_t _limb[nrLimbs];
+	bool     _special;
+
+	kulisch_quire& accumulate(const Scalar& v, bool negate) {
+		bool special, sign;
+		uint64_t mantissa;
+		int scale;
+		if (!kulisch_detail::decompose(v, special, sign, mantissa, scale)) return *this;
+		if (special) {
+			_special = true;
+			return *this;
+		}
+		add(sign != negate, 0, mantissa, scale);
+		return *this;
+	}
+
+	// add or subtract the 128-bit magnitude (hi,lo) * 2^scale
+	void add(bool negative, uint64_t hi, uint64_t lo, int scale) noexcept {
+		if (hi == 0 && lo == 0) return;
+		int offset = scale - lsbScale;
+		if (offset < 0) {  // cannot happen for values of the number system, shift out the bits below the accumulator
+			unsigned s = static_cast<unsigned>(-offset);
+			if (s >= 128) return;
+			if (s >= 64) { lo = hi >> (s - 64); hi = 0; }
+			else { lo = (lo >> s) | (hi << (64 - s)); hi >>= s; }
+			offset = 0;
+		}
+		unsigned w = static_cast<unsigned>(offset) / 64, b = static_cast<unsigned>(offset) % 64;
+		uint64_t x[3];
+		x[0] = lo << b;
+		x[1] = (b ? (hi << b) | (lo >> (64 - b)) : hi);
+		x[2] = (b ? (hi >> (64 - b)) : 0);
+		if (!negative) {
+			uint64_t carry = 0;
+			for (unsigned i = 0; w + i < nrLimbs; ++i) {
+				uint64_t addend = (i < 3 ? x[i] : 0);
+				if (i >= 3 && carry == 0) break;
+				uint64_t s = _limb[w + i] + addend;
+				uint64_t c1 = (s < addend) ? 1u : 0u;
+				uint64_t r = s + carry;
+				uint64_t c2 = (r < s) ? 1u : 0u;
+				_limb[w + i] = r;
+				carry = c1 + c2;
+			}
+		}
+		else {
+			uint64_t borrow = 0;
+			for (unsigned i = 0; w + i < nrLimbs; ++i) {
+				uint64_t subtrahend = (i < 3 ? x[i] : 0);
+				if (i >= 3 && borrow == 0) break;
+				uint64_t l = _limb[w + i];
+				uint64_t d = l - subtrahend;
+				uint64_t b1 = (l < subtrahend) ? 1u : 0u;
+				uint64_t r = d - borrow;
+				uint64_t b2 = (d < borrow) ? 1u : 0u;
+				_limb[w + i] = r;
+				borrow = b1 + b2;
+			}
+		}
+	}
+
+	// magnitude of the two's complement accumulator
+	void magnitude(uint64_t* mag, bool negative) const noexcept {
+		if (!negative) {
+			for (unsigned i = 0; i < nrLimbs; ++i) mag[i] = _limb[i];
+			return;
+		}
+		uint64_t carry = 1;
+		for (unsigned i = 0; i < nrLimbs; ++i) {
+			uint64_t inv = ~_limb[i];
+			mag[i] = inv + carry;
+			carry = (mag[i] < inv) ? 1u : 0u;
+		}
+	}
+
+	// 64 bits of the magnitude starting at bit position lsb, which may be negative
+	static uint64_t window(const uint64_t* mag, int lsb) noexcept {
+		auto bit_block = [mag](int pos) -> uint64_t {  // 64 bits starting at pos >= 0
+			unsigned w = static_cast<unsigned>(pos) / 64, b = static_cast<unsigned>(pos) % 64;
+			uint64_t lo = (w < nrLimbs ? mag[w] : 0), hi = (w + 1 < nrLimbs ? mag[w + 1] : 0);
+			return (b ? (lo >> b) | (hi << (64 - b)) : lo);
+		};
+		if (lsb >= 0) return bit_block(lsb);
+		return bit_block(0) << static_cast<unsigned>(-lsb);
+	}
+
+	// true if any bit of the magnitude below position pos is set
+	static bool any_below(const uint64_t* mag, int pos) noexcept {
+		if (pos <= 0) return false;
+		unsigned w = static_cast<unsigned>(pos) / 64, b = static_cast<unsigned>(pos) % 64;
+		for (unsigned i = 0; i < w && i < nrLimbs; ++i) if (mag[i]) return true;
+		return (b && w < nrLimbs) ? (mag[w] & ((1ull << b) - 1ull)) != 0 : false;
+	}
+
+	// round to nearest, ties to even, at the LSB of the fixed-point target and wrap or saturate to its width
+	Scalar round_fixed_point(const uint64_t* mag, bool negative, int msb) const {
+		constexpr unsigned nbits = static_cast<unsigned>(Traits::precision);
+		constexpr int shift = Traits::min_scale - lsbScale;  // position of the target LSB in the accumulator
+		uint64_t value = window(mag, shift);
+		bool guard = (shift > 0) && ((window(mag, shift - 1) & 1ull) != 0);
+		bool sticky = any_below(mag, shift - 1);
+		if (guard && (sticky || (value & 1ull))) ++value;
+		bool overflow = (msb - shift >= static_cast<int>(nbits) - 1) || (value >> (nbits - 1)) != 0;
+		if constexpr (Traits::saturating) {
+			if (overflow && !(negative && value == (1ull << (nbits - 1)) && msb - shift < 64)) {
+				Scalar s;
+				s.setbits(negative ? (1ull << (nbits - 1)) : ((1ull << (nbits - 1)) - 1ull));
+				return s;
+			}
+		}
+		if (negative) value = ~value + 1ull;
+		if constexpr (nbits < 64) value &= (1ull << nbits) - 1ull;
+		Scalar s;
+		s.setbits(value);
+		return s;
+	}
+};
+
+}} // namespace sw::universal
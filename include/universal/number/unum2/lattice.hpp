@@ -0,0 +1,296 @@
+#pragma once
+// lattice.hpp: definition of the u-lattice of a unum2 and the lookup tables of its arithmetic
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+namespace sw { namespace universal {
+
+/*
+   A type II unum of nbits bits is defined by its u-lattice: the exact values in [1, inf).
+   The encodings form a ring of 2^nbits points: 0 is at index 0, inf at index 2^(nbits-1),
+   the even indices are exact values and the odd indices are the open intervals between
+   them. Negation is the two's complement of the index, and the reciprocal of index i is
+   2^(nbits-1) - i, so the lattice of m = 2^(nbits-3) exact values in [1, inf) generates all
+   the exact values: 0, +-l, +-1/l, and inf.
+
+   A lattice is a type that provides
+       static constexpr unsigned size;                  number of exact values in [1, inf)
+       static constexpr int64_t numerator(unsigned i);  value i is numerator(i) / denominator(i)
+       static constexpr int64_t denominator(unsigned i);
+   where value 0 is 1 and the values increase.
+*/
+
+// ulattice: a u-lattice given as a list of std::ratio values
+template<typename... Exacts>
+struct ulattice {
+	static constexpr unsigned size = sizeof...(Exacts);
+	static constexpr int64_t numerator(unsigned i) {
+		constexpr int64_t v[] = { static_cast<int64_t>(Exacts::num)... };
+		return v[i];
+	}
+	static constexpr int64_t denominator(unsigned i) {
+		constexpr int64_t v[] = { static_cast<int64_t>(Exacts::den)... };
+		return v[i];
+	}
+};
+
+// linear_lattice: the u-lattice 1, 2, 3, ..., m
+template<unsigned m>
+struct linear_lattice {
+	static constexpr unsigned size = m;
+	static constexpr int64_t numerator(unsigned i) { return int64_t(i) + 1; }
+	static constexpr int64_t denominator(unsigned) { return 1; }
+};
+
+// the decade lattice 1, 2, 5, 10 of a 5-bit unum2: 0, 0.1, 0.2, 0.5, 1, 2, 5, 10, inf and their negatives
+using decade_lattice = ulattice<std::ratio<1>, std::ratio<2>, std::ratio<5>, std::ratio<10>>;
+
+/// <summary>
+/// unum2_engine builds the lookup tables of the arithmetic of a unum2 and operates on the encodings.
+/// The tables hold the rounded results of the exact operands only, and the symmetries of the ring
+/// reduce them to a fraction of the full tables:
+///   - negation makes the tables of the positive operands enough for all signs, with a table for
+///     the difference of positive operands, and commutativity keeps the upper triangles only;
+///   - reciprocation reduces the product of positive operands to the product and the ratio of the
+///     values in [1, inf): 1/a * 1/b = 1/(a * b), and a * 1/b = a / b = 1/(b / a).
+/// For nbits = 8 the four tables take 5KB instead of the 256KB of full addition, subtraction,
+/// multiplication, and division tables. Up to 8 bits the tables are built at compile time, larger
+/// lattices build their tables once, at the first operation.
+/// </summary>
+template<unsigned nbits, typename Lattice>
+class unum2_engine {
+public:
+	static_assert(nbits >= 3, "a unum2 needs at least 3 bits");
+	static_assert(nbits <= 12, "the tables of a unum2 larger than 12 bits do not fit in a cache");
+	static_assert(Lattice::size == (1u << (nbits - 3)), "a lattice of nbits needs 2^(nbits-3) exact values in [1, inf)");
+
+	using index_type = std::conditional_t<(nbits <= 8), uint8_t, uint16_t>;
+
+	static constexpr unsigned NR_ENCODINGS = (1u << nbits);
+	static constexpr unsigned MASK         = NR_ENCODINGS - 1;
+	static constexpr unsigned INF          = (1u << (nbits - 1));    // the point at infinity
+	static constexpr unsigned ONE          = (1u << (nbits - 2));
+	static constexpr unsigned M            = Lattice::size;          // exact values in [1, inf)
+	static constexpr unsigned P            = 2 * M - 1;              // exact values in (0, inf)
+	static constexpr bool compileTimeTables = (nbits <= 8);
+
+	// the numerators and denominators are limited so that the products in the comparisons of the table builder fit 64 bits
+	static constexpr int64_t MAX_TERM = (int64_t(1) << 20);
+	static constexpr bool valid() {
+		if (Lattice::numerator(0) != Lattice::denominator(0)) return false;
+		for (unsigned i = 0; i < M; ++i) {
+			if (Lattice::numerator(i) <= 0 || Lattice::numerator(i) >= MAX_TERM) return false;
+			if (Lattice::denominator(i) <= 0 || Lattice::denominator(i) >= MAX_TERM) return false;
+			if (i > 0 && Lattice::numerator(i) * Lattice::denominator(i - 1) <= Lattice::numerator(i - 1) * Lattice::denominator(i)) return false;
+		}
+		return true;
+	}
+	static_assert(valid(), "a lattice starts at 1 and increases, and its terms are positive and smaller than 2^20");
+
+	// a positive rational number
+	struct rational { int64_t num, den; };
+
+	// value of the p-th positive exact value, p in [1, P], which is encoded at index 2p
+	static constexpr rational exact(unsigned p) {
+		return (p >= M ? rational{ Lattice::numerator(p - M), Lattice::denominator(p - M) }
+		               : rational{ Lattice::denominator(M - p), Lattice::numerator(M - p) });
+	}
+
+	// encoding of the positive value r: the exact value or the open interval that contains it
+	static constexpr unsigned round(rational r) {
+		// find the smallest exact value >= r
+		unsigned lo = 1, hi = P + 1;
+		while (lo < hi) {
+			unsigned mid = (lo + hi) / 2;
+			rational e = exact(mid);
+			if (e.num * r.den >= r.num * e.den) hi = mid; else lo = mid + 1;
+		}
+		if (lo > P) return INF - 1;  // (maxpos, inf)
+		rational e = exact(lo);
+		return (e.num * r.den == r.num * e.den ? 2 * lo : 2 * lo - 1);
+	}
+
+	// encoding of a native floating-point value
+	static unsigned round(double v) {
+		if (std::isnan(v) || std::isinf(v)) return INF;
+		if (v == 0.0) return 0;
+		double a = std::fabs(v);
+		unsigned lo = 1, hi = P + 1;
+		while (lo < hi) {
+			unsigned mid = (lo + hi) / 2;
+			rational e = exact(mid);
+			// the sign of the fused a * den - num is exact
+			if (std::fma(a, double(e.den), -double(e.num)) <= 0.0) hi = mid; else lo = mid + 1;
+		}
+		unsigned r;
+		if (lo > P) r = INF - 1;
+		else {
+			rational e = exact(lo);
+			r = (std::fma(a, double(e.den), -double(e.num)) == 0.0 ? 2 * lo : 2 * lo - 1);
+		}
+		return (v < 0.0 ? negate(r) : r);
+	}
+
+	static constexpr unsigned negate(unsigned i) noexcept { return (NR_ENCODINGS - i) & MASK; }
+	static constexpr unsigned reciprocal(unsigned i) noexcept { return (INF + NR_ENCODINGS - i) & MASK; }
+	static constexpr bool isexact(unsigned i) noexcept { return (i & 1u) == 0; }
+	static constexpr bool isneg(unsigned i) noexcept { return i > INF; }
+	// position on the real line, inf is the smallest
+	static constexpr int ordinal(unsigned i) noexcept { return (i >= INF ? int(i) - int(NR_ENCODINGS) : int(i)); }
+
+	// the lookup tables
+	struct tables {
+		std::array<index_type, P * (P + 1) / 2> sum;         // exact(p) + exact(q), p >= q
+		std::array<index_type, P * (P - 1) / 2> difference;  // exact(p) - exact(q), p > q
+		std::array<index_type, M * (M + 1) / 2> product;     // l(a) * l(b), a >= b
+		std::array<index_type, M * (M + 1) / 2> ratio;       // l(a) / l(b), a >= b
+	};
+
+	static constexpr tables build() {
+		tables t{};
+		for (unsigned p = 1; p <= P; ++p) {
+			for (unsigned q = 1; q <= p; ++q) {
+				rational a = exact(p), b = exact(q);
+				t.sum[triangle(p - 1, q - 1)] = index_type(round(rational{ a.num * b.den + b.num * a.den, a.den * b.den }));
+				if (q < p) t.difference[strict_triangle(p - 1, q - 1)] = index_type(round(rational{ a.num * b.den - b.num * a.den, a.den * b.den }));
+			}
+		}
+		for (unsigned a = 0; a < M; ++a) {
+			for (unsigned b = 0; b <= a; ++b) {
+				int64_t an = Lattice::numerator(a), ad = Lattice::denominator(a);
+				int64_t bn = Lattice::numerator(b), bd = Lattice::denominator(b);
+				t.product[triangle(a, b)] = index_type(round(rational{ an * bn, ad * bd }));
+				t.ratio[triangle(a, b)] = index_type(round(rational{ an * bd, ad * bn }));
+			}
+		}
+		return t;
+	}
+
+	static const tables& lookup() {
+		if constexpr (compileTimeTables) {
+			static constexpr tables t = build();
+			return t;
+		}
+		else {
+			static const tables t = build();
+			return t;
+		}
+	}
+
+	// the real interval of results of an operation: a range of encodings in the order of the real line
+	struct span { unsigned lo, hi; };
+
+	// sum of the encodings x and y
+	static span add_span(unsigned x, unsigned y) {
+		if (x == INF || y == INF) return span{ INF, INF };
+		if (isexact(x) && isexact(y)) {
+			unsigned r = add_exact(x, y);
+			return span{ r, r };
+		}
+		// addition is increasing in both operands: add the lower and the upper bounds, which are open
+		unsigned xlo = isexact(x) ? x : ((x - 1) & MASK), xhi = isexact(x) ? x : ((x + 1) & MASK);
+		unsigned ylo = isexact(y) ? y : ((y - 1) & MASK), yhi = isexact(y) ? y : ((y + 1) & MASK);
+		unsigned lo, hi;
+		if (xlo == INF || ylo == INF) lo = INF + 1;  // -inf is an open bound
+		else lo = open_bound(add_exact(xlo, ylo), true, true);
+		if (xhi == INF || yhi == INF) hi = INF - 1;  // +inf is an open bound
+		else hi = open_bound(add_exact(xhi, yhi), true, false);
+		return span{ lo, hi };
+	}
+
+	// product of the encodings x and y
+	static span mul_span(unsigned x, unsigned y) {
+		if (x == INF || y == INF) return span{ INF, INF };  // inf * 0 is undefined, which also maps to inf
+		if (x == 0 || y == 0) return span{ 0, 0 };
+		bool negative = (isneg(x) != isneg(y));
+		unsigned a = isneg(x) ? negate(x) : x;
+		unsigned b = isneg(y) ? negate(y) : y;
+		span s;
+		if (isexact(a) && isexact(b)) {
+			unsigned r = mul_exact(a, b);
+			s = span{ r, r };
+		}
+		else {
+			// the product of positive operands is increasing in both operands
+			unsigned alo = isexact(a) ? a : a - 1, ahi = isexact(a) ? a : a + 1;
+			unsigned blo = isexact(b) ? b : b - 1, bhi = isexact(b) ? b : b + 1;
+			s.lo = (alo == 0 || blo == 0) ? 1u : open_bound(mul_exact(alo, blo), true, true);
+			s.hi = (ahi == INF || bhi == INF) ? INF - 1 : open_bound(mul_exact(ahi, bhi), true, false);
+		}
+		return (negative ? span{ negate(s.hi), negate(s.lo) } : s);
+	}
+
+	static span sub_span(unsigned x, unsigned y) { return add_span(x, negate(y)); }
+	static span div_span(unsigned x, unsigned y) { return mul_span(x, reciprocal(y)); }
+
+	/// <summary>
+	/// the single encoding that represents a span: the span itself when it is a single exact value or
+	/// open interval, otherwise the encoding in the middle of the span, and the open interval on a tie,
+	/// which keeps the results symmetric under negation and reciprocation
+	/// </summary>
+	static constexpr unsigned middle(span s) noexcept {
+		int lo = ordinal(s.lo), hi = ordinal(s.hi);
+		if (s.lo == INF) return INF;
+		int mid = lo + (hi - lo) / 2;
+		if (((hi - lo) & 1) && (mid & 1) == 0) ++mid;
+		return unsigned(mid) & MASK;
+	}
+
+	static unsigned add(unsigned x, unsigned y) { return middle(add_span(x, y)); }
+	static unsigned sub(unsigned x, unsigned y) { return middle(sub_span(x, y)); }
+	static unsigned mul(unsigned x, unsigned y) { return middle(mul_span(x, y)); }
+	static unsigned div(unsigned x, unsigned y) { return middle(div_span(x, y)); }
+
+private:
+	static constexpr unsigned triangle(unsigned i, unsigned j) noexcept { return i * (i + 1) / 2 + j; }
+	static constexpr unsigned strict_triangle(unsigned i, unsigned j) noexcept { return i * (i - 1) / 2 + j; }
+
+	// an open bound at an exact value moves to the open interval inside the span
+	static constexpr unsigned open_bound(unsigned r, bool open, bool lower) noexcept {
+		if (open && isexact(r)) r = (lower ? r + 1 : r - 1);
+		return r & MASK;
+	}
+
+	// sum of two finite exact encodings
+	static unsigned add_exact(unsigned x, unsigned y) {
+		if (x == 0) return y;
+		if (y == 0) return x;
+		const tables& t = lookup();
+		bool sx = isneg(x), sy = isneg(y);
+		unsigned px = (sx ? negate(x) : x) / 2, py = (sy ? negate(y) : y) / 2;
+		unsigned r;
+		if (sx == sy) {
+			r = (px >= py ? t.sum[triangle(px - 1, py - 1)] : t.sum[triangle(py - 1, px - 1)]);
+			return (sx ? negate(r) : r);
+		}
+		if (px == py) return 0;
+		if (px > py) {
+			r = t.difference[strict_triangle(px - 1, py - 1)];
+			return (sx ? negate(r) : r);
+		}
+		r = t.difference[strict_triangle(py - 1, px - 1)];
+		return (sy ? negate(r) : r);
+	}
+
+	// product of two positive finite exact encodings
+	static unsigned mul_exact(unsigned x, unsigned y) {
+		const tables& t = lookup();
+		// u >= 0 is the lattice value l(u), u < 0 is 1/l(-u)
+		int u = int(x / 2) - int(M), v = int(y / 2) - int(M);
+		if (u >= 0 && v >= 0) return (u >= v ? t.product[triangle(u, v)] : t.product[triangle(v, u)]);
+		if (u < 0 && v < 0) return reciprocal(-u >= -v ? t.product[triangle(-u, -v)] : t.product[triangle(-v, -u)]);
+		if (u < 0) std::swap(u, v);
+		// l(u) / l(-v)
+		return (u >= -v ? t.ratio[triangle(u, -v)] : reciprocal(t.ratio[triangle(-v, u)]));
+	}
+};
+
+}} // namespace sw::universal
@@ -13,57 +13,86 @@
 #include <universal/utility/color_print.hpp>
 
 // This file contains functions that use the unum2 type.
-// If you have helper functions that the unum2 type could use, but dofsize not depend on 
+// If you have helper functions that the unum2 type could use, but do not depend on
 // the unum2 type, you can add them to the file unum_helpers.hpp.
 
 namespace sw { namespace universal {
 
 // DEBUG/REPORTING HELPERS
 
-template<size_t essize, size_t fsize>
-std::string unum2_range() {
+template<unsigned nbits, typename Lattice, typename bt>
+std::string unum2_range(const unum2<nbits, Lattice, bt>& = {}) {
 	std::stringstream ss;
-	ss << " unum2<" << std::setw(3) << essize << "," << fsize << "> ";
-	//ss << "minpos scale " << std::setw(10) << minpos_scale<essize, fsize>() << "     ";
-	//ss << "maxpos scale " << std::setw(10) << maxpos_scale<essize, fsize>() << "     ";
-	ss << "minimum " << std::setw(12) << std::numeric_limits<sw::universal::unum2<essize, fsize>>::min() << "     ";
-	ss << "maximum " << std::setw(12) << std::numeric_limits<sw::universal::unum2<essize, fsize>>::max() ;
+	unum2<nbits, Lattice, bt> minimum(SpecificValue::minpos), maximum(SpecificValue::maxpos);
+	ss << " unum2<" << std::setw(3) << nbits << "> ";
+	ss << "minimum " << std::setw(12) << minimum << "     ";
+	ss << "maximum " << std::setw(12) << maximum;
 	return ss.str();
 }
 
-// Generate a type tag for this unum, for example, unum<8,1>
-template<size_t essize, size_t fsize>
-std::string type_tag(const unum2<essize, fsize>& = {}) {
+// Generate a type tag for this unum2, for example, unum2<5,{1,2,5,10}>
+template<unsigned nbits, typename Lattice, typename bt>
+std::string type_tag(const unum2<nbits, Lattice, bt>& = {}) {
 	std::stringstream ss;
-	ss << "unum2<" << essize << "," << fsize << ">";
+	ss << "unum2<" << nbits << ",{";
+	for (unsigned i = 0; i < Lattice::size; ++i) {
+		ss << Lattice::numerator(i);
+		if (Lattice::denominator(i) != 1) ss << '/' << Lattice::denominator(i);
+		if (i + 1 < Lattice::size) ss << ',';
+	}
+	ss << "}>";
 	return ss.str();
 }
 
-// generate a unum2 format ASCII format essize.fsizexNN...NNp
-template<size_t essize, size_t fsize>
-inline std::string hex_print(const unum2<essize, fsize>& p) {
+// generate the binary encoding of a unum2: the ring index
+template<unsigned nbits, typename Lattice, typename bt>
+inline std::string to_binary(const unum2<nbits, Lattice, bt>& p, bool nibbleMarker = false) {
 	std::stringstream ss;
-	ss << essize << '.' << fsize << 'x' << to_hex(p.get()) << 'p';
+	ss << 'b';
+	for (int i = int(nbits) - 1; i >= 0; --i) {
+		ss << ((p.get() >> i) & 1u ? '1' : '0');
+		if (nibbleMarker && i > 0 && (i % 4) == 0) ss << '\'';
+	}
 	return ss.str();
 }
 
-template<size_t essize, size_t fsize>
-std::string pretty_print(const unum2<essize, fsize>& p, int printPrecision = std::numeric_limits<double>::max_digits10) {
+// generate a unum2 format ASCII format nbits.xNN...NNu
+template<unsigned nbits, typename Lattice, typename bt>
+inline std::string hex_print(const unum2<nbits, Lattice, bt>& p) {
 	std::stringstream ss;
+	ss << nbits << ".x" << std::hex << std::setw((nbits + 3) / 4) << std::setfill('0') << unsigned(p.get()) << 'u';
 	return ss.str();
 }
 
-template<size_t essize, size_t fsize>
-std::string info_print(const unum2<essize, fsize>& p, int printPrecision = 17) {
+template<unsigned nbits, typename Lattice, typename bt>
+std::string pretty_print(const unum2<nbits, Lattice, bt>& p, int printPrecision = std::numeric_limits<double>::max_digits10) {
 	std::stringstream ss;
+	ss << to_binary(p) << " : " << std::setprecision(printPrecision) << p;
 	return ss.str();
 }
 
-template<size_t essize, size_t fsize>
-std::string color_print(const unum2<essize, fsize>& p) {
+template<unsigned nbits, typename Lattice, typename bt>
+std::string info_print(const unum2<nbits, Lattice, bt>& p, int printPrecision = 17) {
 	std::stringstream ss;
+	ss << type_tag(p) << ' ' << to_binary(p) << (p.isexact() ? " exact " : " open interval ") << std::setprecision(printPrecision) << p;
 	return ss.str();
 }
 
-}}  // namespace sw::universal
+// the sign bit in red, exact values in cyan, open intervals in yellow
+template<unsigned nbits, typename Lattice, typename bt>
+std::string color_print(const unum2<nbits, Lattice, bt>& p) {
+	std::stringstream ss;
+	Color red(ColorCode::FG_RED);
+	Color cyan(ColorCode::FG_CYAN);
+	Color yellow(ColorCode::FG_YELLOW);
+	Color def(ColorCode::FG_DEFAULT);
+	ss << red << (((p.get() >> (nbits - 1)) & 1u) ? '1' : '0');
+	ss << (p.isexact() ? cyan : yellow);
+	for (int i = int(nbits) - 2; i >= 0; --i) {
+		ss << ((p.get() >> i) & 1u ? '1' : '0');
+	}
+	ss << def;
+	return ss.str();
+}
 
+}}  // namespace sw::universal
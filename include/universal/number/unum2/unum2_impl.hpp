@@ -1,36 +1,50 @@
 #pragma once
-// unum2.hpp: definition of the flexible configuration universal number system
+// unum2.hpp: definition of the type II universal number system
 //
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
 
 #include <universal/native/ieee754.hpp>
 #include <universal/number/shared/nan_encoding.hpp>
 #include <universal/number/shared/infinite_encoding.hpp>
 #include <universal/number/shared/specific_value_encoding.hpp>
+#include <universal/number/unum2/lattice.hpp>
 
 namespace sw { namespace universal {
-		
-// Forward definitions
-template<unsigned esizesize, unsigned fsizesize, typename bt> class unum2;
-template<unsigned esizesize, unsigned fsizesize, typename bt> unum2<esizesize,fsizesize,bt> abs(const unum2<esizesize,fsizesize,bt>& v);
 
-// template class reprfsizesizeenting a value in scientific notation, using a template size for the number of fraction bits
-template<unsigned esizesize, unsigned fsizesize, typename bt = uint8_t>
+// Forward definitions
+template<unsigned nbits, typename Lattice, typename bt> class unum2;
+template<unsigned nbits, typename Lattice, typename bt> unum2<nbits,Lattice,bt> abs(const unum2<nbits,Lattice,bt>& v);
+
+/*
+   unum2 is a type II unum: an nbits encoding of the projective real line defined by the u-lattice of
+   its exact values in [1, inf). The even encodings are exact values and the odd encodings are the open
+   intervals between them. Arithmetic is a lookup in the tables of unum2_engine on the encodings.
+   A result that is not an exact value is the open interval that contains it. When an open interval
+   operand makes the result span more than one encoding, the result is the encoding in the middle of
+   the span: the spans themselves are available from unum2_engine for set arithmetic.
+   The point at infinity is also the result of the undefined operations 0 * inf, inf - inf, and 0 / 0.
+*/
+template<unsigned _nbits, typename Lattice, typename bt = uint8_t>
 class unum2 {
 public:
-	static constexpr unsigned UTAGSIZE   = 1 + esizesize + fsizesize;
-	static constexpr unsigned UTAGMASK   = unsigned(~(int64_t(-1) << UTAGSIZE));
-	static constexpr unsigned EBITSMASK  = 1;
-	static constexpr unsigned FBITSMASK  = 2;
+	static constexpr unsigned nbits = _nbits;
+	using Engine = unum2_engine<nbits, Lattice>;
+	using BlockType = bt;
+	static_assert(nbits <= 8 * sizeof(bt), "the block type of a unum2 must hold nbits bits");
 
-	unum2() {}
+	unum2() : _bits{ 0 } {}
 
 	// specific value constructor
-	constexpr unum2(const SpecificValue code) {
+	constexpr unum2(const SpecificValue code) : _bits{ 0 } {
 		switch (code) {
 		case SpecificValue::maxpos:
 			maxpos();
@@ -47,6 +61,13 @@ public:
 		case SpecificValue::maxneg:
 			maxneg();
 			break;
+		case SpecificValue::infpos:
+		case SpecificValue::infneg:
+		case SpecificValue::qnan:
+		case SpecificValue::snan:
+		case SpecificValue::nar:
+			setinf();
+			break;
 		}
 	}
 
@@ -58,9 +79,11 @@ public:
 	unum2(float initial_value)              { *this = initial_value; }
 	unum2(double initial_value)             { *this = initial_value; }
 	unum2(long double initial_value)        { *this = initial_value; }
-	unum2(const unum2& rhs)                  { *this = rhs; }
+	unum2(const unum2& rhs) = default;
 
-	// assignment operators
+	unum2& operator=(const unum2& rhs) = default;
+
+	// assignment operators: a value that is not in the lattice becomes the open interval that contains it
 	unum2& operator=(signed char rhs) {
 		return *this = (long long)(rhs);
 	}
@@ -71,58 +94,62 @@ public:
 		return *this = (long long)(rhs);
 	}
 	unum2& operator=(long long rhs) {
-		return *this;
+		// integers beyond 2^53 are beyond the largest exact value of a lattice
+		return *this = double(rhs);
 	}
 	unum2& operator=(unsigned long long rhs) {
-		return *this;
+		return *this = double(rhs);
 	}
 	unum2& operator=(float rhs) {
-
-		return *this;
+		return *this = double(rhs);
 	}
 	unum2& operator=(double rhs) {
-
+		_bits = bt(Engine::round(rhs));
 		return *this;
 	}
 	unum2& operator=(long double rhs) {
-
-		return *this;
+		return *this = double(rhs);
 	}
 
 	// arithmetic operators
 	// prefix operator
-	unum2 operator-() const {				
-		return *this;
+	unum2 operator-() const {
+		unum2 negated;
+		negated.setbits(Engine::negate(_bits));
+		return negated;
 	}
 
 	unum2& operator+=(const unum2& rhs) {
+		_bits = bt(Engine::add(_bits, rhs._bits));
 		return *this;
 	}
 	unum2& operator+=(double rhs) {
 		return *this += unum2(rhs);
 	}
 	unum2& operator-=(const unum2& rhs) {
-
+		_bits = bt(Engine::sub(_bits, rhs._bits));
 		return *this;
 	}
 	unum2& operator-=(double rhs) {
-		return *this -= unum2<esizesize, fsizesize>(rhs);
+		return *this -= unum2(rhs);
 	}
 	unum2& operator*=(const unum2& rhs) {
-
+		_bits = bt(Engine::mul(_bits, rhs._bits));
 		return *this;
 	}
 	unum2& operator*=(double rhs) {
-		return *this *= unum2<esizesize, fsizesize>(rhs);
+		return *this *= unum2(rhs);
 	}
 	unum2& operator/=(const unum2& rhs) {
-
+		_bits = bt(Engine::div(_bits, rhs._bits));
 		return *this;
 	}
 	unum2& operator/=(double rhs) {
-		return *this /= unum2<esizesize, fsizesize>(rhs);
+		return *this /= unum2(rhs);
 	}
+	// move to the next encoding on the ring
 	unum2& operator++() {
+		_bits = bt((_bits + 1u) & Engine::MASK);
 		return *this;
 	}
 	unum2 operator++(int) {
@@ -131,6 +158,7 @@ public:
 		return tmp;
 	}
 	unum2& operator--() {
+		_bits = bt((_bits + Engine::MASK) & Engine::MASK);
 		return *this;
 	}
 	unum2 operator--(int) {
@@ -142,74 +170,88 @@ public:
 	// modifiers
 
 	/// <summary>
-	/// clear the content of this bfloat to zero
+	/// clear the content of this unum2 to zero
 	/// </summary>
 	/// <returns>void</returns>
-	inline constexpr void clear() noexcept {
-
-	}
+	inline constexpr void clear() noexcept { _bits = 0; }
 	/// <summary>
-	/// set the number to +0
+	/// set the number to 0
 	/// </summary>
 	/// <returns>void</returns>
 	inline constexpr void setzero() noexcept { clear(); }
 	/// <summary>
-	/// set the number to +inf
+	/// set the number to the point at infinity, which has no sign
 	/// </summary>
-	/// <param name="sign">boolean to make it + or - infinity, default is -inf</param>
-	/// <returns>void</returns> 
-	inline constexpr void setinf(bool sign = true) noexcept {
-
-	}
+	/// <param name="sign">ignored: the projective infinity is unsigned</param>
+	/// <returns>void</returns>
+	inline constexpr void setinf(bool sign = true) noexcept { (void)sign; _bits = bt(Engine::INF); }
 	/// <summary>
-	/// set the number to a quiet NaN (+nan) or a signalling NaN (-nan, default)
+	/// set the number to the result of an undefined operation, which is the point at infinity
 	/// </summary>
-	/// <param name="sign">boolean to make it + or - infinity, default is -inf</param>
-	/// <returns>void</returns> 
-	inline constexpr void setnan(int NaNType = NAN_TYPE_SIGNALLING) noexcept {
-	}
+	/// <param name="NaNType">ignored: there is a single encoding for undefined results</param>
+	/// <returns>void</returns>
+	inline constexpr void setnan(int NaNType = NAN_TYPE_SIGNALLING) noexcept { (void)NaNType; setinf(); }
+	// use un-interpreted raw bits to set the encoding
+	inline constexpr void setbits(uint64_t value) noexcept { _bits = bt(value & Engine::MASK); }
 	// specific number system values of interest
 	inline constexpr unum2& maxpos() noexcept {
-
+		_bits = bt(Engine::INF - 2);
 		return *this;
 	}
 	inline constexpr unum2& minpos() noexcept {
-
+		_bits = bt(2);
 		return *this;
 	}
 	inline constexpr unum2& zero() noexcept {
-
+		_bits = bt(0);
 		return *this;
 	}
 	inline constexpr unum2& minneg() noexcept {
-
+		_bits = bt(Engine::negate(2));
 		return *this;
 	}
 	inline constexpr unum2& maxneg() noexcept {
-
+		_bits = bt(Engine::INF + 2);
 		return *this;
 	}
 
 	// selectors
-	inline bool isneg() const { return false; }
-	inline bool iszero() const { return false; }
-	inline bool isinf() const { return false; }
-	inline bool isnan() const { return false; }
-	inline bool issnan() const { return false; }
-	inline bool isqnan() const { return false; }
-	inline bool sign() const { return false; }
-	inline int32_t scale() const { return false; } // 2^+-2^31 should be enough to capture empirical use cases
-	inline std::string get() const { return std::string("tbd"); }
-
-
+	inline bool isneg() const { return Engine::isneg(_bits); }
+	inline bool iszero() const { return _bits == 0; }
+	inline bool isinf() const { return _bits == Engine::INF; }
+	inline bool isnan() const { return isinf(); }
+	inline bool issnan() const { return isinf(); }
+	inline bool isqnan() const { return isinf(); }
+	inline bool isexact() const { return Engine::isexact(_bits); }
+	inline bool sign() const { return isneg(); }
+	// binary scale of the value, or of the lower bound of the magnitude of an open interval
+	inline int32_t scale() const {
+		if (iszero() || isinf()) return 0;
+		unsigned magnitude = isneg() ? Engine::negate(_bits) : _bits;
+		if (!Engine::isexact(magnitude)) --magnitude;
+		if (magnitude == 0) magnitude = 2;  // the scale of (0, minpos) is the scale of minpos
+		typename Engine::rational r = Engine::exact(magnitude / 2);
+		return int32_t(std::ilogb(double(r.num) / double(r.den)));
+	}
+	inline bt get() const { return _bits; }
+
+	// the bounds of an exact value or an open interval
+	double lower_bound() const { return bound(Engine::isexact(_bits) ? _bits : ((_bits - 1u) & Engine::MASK), true); }
+	double upper_bound() const { return bound(Engine::isexact(_bits) ? _bits : ((_bits + 1u) & Engine::MASK), false); }
+
+	// an open interval converts to the midpoint of its bounds, or to its finite bound next to infinity
 	long double to_long_double() const {
-		return 0.0l;
+		return (long double)(to_double());
 	}
 	double to_double() const {
-		return 0.0;
+		if (isinf()) return std::numeric_limits<double>::infinity();
+		double lo = lower_bound(), hi = upper_bound();
+		if (std::isinf(lo)) return hi;
+		if (std::isinf(hi)) return lo;
+		return (lo == hi ? lo : (lo + hi) / 2.0);
 	}
 	float to_float() const {
-		return 0.0f;
+		return float(to_double());
 	}
 	// Maybe remove explicit
 	explicit operator long double() const { return to_long_double(); }
@@ -217,103 +259,132 @@ public:
 	explicit operator float() const { return to_float(); }
 
 private:
-
-	// template parameters need namfsizesize different from class template parameters (for gcc and clang)
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend std::ostream& operator<< (std::ostream& ostr, const unum2<nesizesize,nfsizesize,nbt>& r);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend std::istream& operator>> (std::istream& istr, unum2<nesizesize,nfsizesize,nbt>& r);
-
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator==(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator!=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator< (const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator> (const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator<=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
-	template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-	friend bool operator>=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs);
+	bt _bits;
+
+	// value of the exact encoding i as a bound of a real interval
+	static double bound(unsigned i, bool lower) {
+		if (i == 0) return 0.0;
+		if (i == Engine::INF) return (lower ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity());
+		bool negative = Engine::isneg(i);
+		typename Engine::rational r = Engine::exact((negative ? Engine::negate(i) : i) / 2);
+		double v = double(r.num) / double(r.den);
+		return (negative ? -v : v);
+	}
+
+	// template parameters need names different from class template parameters (for gcc and clang)
+	template<unsigned nnbits, typename nLattice, typename nbt>
+	friend std::ostream& operator<< (std::ostream& ostr, const unum2<nnbits,nLattice,nbt>& r);
+	template<unsigned nnbits, typename nLattice, typename nbt>
+	friend std::istream& operator>> (std::istream& istr, unum2<nnbits,nLattice,nbt>& r);
+
+	template<unsigned nnbits, typename nLattice, typename nbt>
+	friend bool operator==(const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs);
+	template<unsigned nnbits, typename nLattice, typename nbt>
+	friend bool operator< (const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs);
 };
 
 ////////////////////// operators
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline std::ostream& operator<<(std::ostream& ostr, const unum2<nesizesize,nfsizesize,nbt>& v) {
-
-	return ostr;
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline std::ostream& operator<<(std::ostream& ostr, const unum2<nnbits,nLattice,nbt>& v) {
+	// to make certain that setw and left/right operators work properly
+	// we need to transform the unum2 into a string
+	std::stringstream ss;
+	ss << std::setprecision(ostr.precision());
+	if (v.isinf()) {
+		ss << "inf";
+	}
+	else if (v.isexact()) {
+		ss << v.lower_bound();
+	}
+	else {
+		ss << '(' << v.lower_bound() << ", " << v.upper_bound() << ')';
+	}
+	return ostr << std::setw(ostr.width()) << ss.str();
 }
 
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline std::istream& operator>>(std::istream& istr, const unum2<nesizesize,nfsizesize,nbt>& v) {
-	istr >> v._fraction;
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline std::istream& operator>>(std::istream& istr, unum2<nnbits,nLattice,nbt>& v) {
+	double value;
+	istr >> value;
+	v = value;
 	return istr;
 }
 
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator==(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return false; }
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator!=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return !operator==(lhs, rhs); }
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator< (const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return false; }
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator> (const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return  operator< (rhs, lhs); }
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator<=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return !operator> (lhs, rhs); }
-template<unsigned nesizesize, unsigned nfsizesize, typename nbt>
-inline bool operator>=(const unum2<nesizesize,nfsizesize,nbt>& lhs, const unum2<nesizesize,nfsizesize,nbt>& rhs) { return !operator< (lhs, rhs); }
-
-// posit - posit binary arithmetic operators
+// the encodings are unique, and infinity is the smallest value, like the posit NaR
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator==(const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) { return lhs._bits == rhs._bits; }
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator!=(const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) { return !operator==(lhs, rhs); }
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator< (const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) {
+	using Engine = typename unum2<nnbits, nLattice, nbt>::Engine;
+	return Engine::ordinal(lhs._bits) < Engine::ordinal(rhs._bits);
+}
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator> (const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) { return  operator< (rhs, lhs); }
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator<=(const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) { return !operator> (lhs, rhs); }
+template<unsigned nnbits, typename nLattice, typename nbt>
+inline bool operator>=(const unum2<nnbits,nLattice,nbt>& lhs, const unum2<nnbits,nLattice,nbt>& rhs) { return !operator< (lhs, rhs); }
+
+// unum2 - unum2 binary arithmetic operators
 // BINARY ADDITION
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-inline unum2<esizesize, fsizesize, bt> operator+(const unum2<esizesize, fsizesize, bt>& lhs, const unum2<esizesize, fsizesize, bt>& rhs) {
-	unum2<esizesize, fsizesize> sum(lhs);
+template<unsigned nbits, typename Lattice, typename bt>
+inline unum2<nbits, Lattice, bt> operator+(const unum2<nbits, Lattice, bt>& lhs, const unum2<nbits, Lattice, bt>& rhs) {
+	unum2<nbits, Lattice, bt> sum(lhs);
 	sum += rhs;
 	return sum;
 }
 // BINARY SUBTRACTION
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-inline unum2<esizesize, fsizesize, bt> operator-(const unum2<esizesize, fsizesize, bt>& lhs, const unum2<esizesize, fsizesize, bt>& rhs) {
-	unum2<esizesize, fsizesize> diff(lhs);
+template<unsigned nbits, typename Lattice, typename bt>
+inline unum2<nbits, Lattice, bt> operator-(const unum2<nbits, Lattice, bt>& lhs, const unum2<nbits, Lattice, bt>& rhs) {
+	unum2<nbits, Lattice, bt> diff(lhs);
 	diff -= rhs;
 	return diff;
 }
 // BINARY MULTIPLICATION
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-inline unum2<esizesize, fsizesize, bt> operator*(const unum2<esizesize, fsizesize, bt>& lhs, const unum2<esizesize, fsizesize, bt>& rhs) {
-	unum2<esizesize, fsizesize> mul(lhs);
+template<unsigned nbits, typename Lattice, typename bt>
+inline unum2<nbits, Lattice, bt> operator*(const unum2<nbits, Lattice, bt>& lhs, const unum2<nbits, Lattice, bt>& rhs) {
+	unum2<nbits, Lattice, bt> mul(lhs);
 	mul *= rhs;
 	return mul;
 }
 // BINARY DIVISION
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-inline unum2<esizesize, fsizesize, bt> operator/(const unum2<esizesize, fsizesize, bt>& lhs, const unum2<esizesize, fsizesize, bt>& rhs) {
-	unum2<esizesize, fsizesize> ratio(lhs);
+template<unsigned nbits, typename Lattice, typename bt>
+inline unum2<nbits, Lattice, bt> operator/(const unum2<nbits, Lattice, bt>& lhs, const unum2<nbits, Lattice, bt>& rhs) {
+	unum2<nbits, Lattice, bt> ratio(lhs);
 	ratio /= rhs;
 	return ratio;
 }
 
+// reciprocal is exact on the ring of a unum2
+template<unsigned nbits, typename Lattice, typename bt>
+inline unum2<nbits, Lattice, bt> reciprocate(const unum2<nbits, Lattice, bt>& v) {
+	using Engine = typename unum2<nbits, Lattice, bt>::Engine;
+	unum2<nbits, Lattice, bt> r;
+	r.setbits(Engine::reciprocal(v.get()));
+	return r;
+}
 
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-inline std::string components(const unum2<esizesize,fsizesize,bt>& v) {
+template<unsigned nbits, typename Lattice, typename bt>
+inline std::string components(const unum2<nbits,Lattice,bt>& v) {
 	std::stringstream s;
 	if (v.iszero()) {
-		s << " zero b" << std::setw(esizesize) << v.fraction();
+		s << " zero b" << unsigned(v.get());
 		return s.str();
 	}
 	else if (v.isinf()) {
-		s << " infinite b" << std::setw(esizesize) << v.fraction();
+		s << " infinite b" << unsigned(v.get());
 		return s.str();
 	}
-	s << "(" << (v.sign() ? "-" : "+") << "," << v.scale() << "," << v.fraction() << ")";
+	s << "(" << (v.sign() ? "-" : "+") << "," << v.scale() << "," << (v.isexact() ? "exact" : "open interval") << ")";
 	return s.str();
 }
 
-/// Magnitude of a scientific notation value (equivalent to turning the sign bit off).
-template<unsigned esizesize, unsigned fsizesize, typename bt>
-unum2<esizesize,fsizesize> abs(const unum2<esizesize,fsizesize,bt>& v) {
-	return unum2<esizesize,fsizesize>(false, v.scale(), v.fraction(), v.isZero());
+/// Magnitude of a unum2 value (equivalent to the two's complement of a negative encoding).
+template<unsigned nbits, typename Lattice, typename bt>
+unum2<nbits,Lattice,bt> abs(const unum2<nbits,Lattice,bt>& v) {
+	return (v.isneg() ? -v : v);
 }
 
 
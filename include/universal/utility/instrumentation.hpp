@@ -0,0 +1,194 @@
+#pragma once
+// instrumentation.hpp: lock-free, per-thread operation counters and scale histograms for number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <universal/utility/occurrence.hpp>
+#include <universal/utility/scale_tracker.hpp>
+
+/*
+   A number system opts into instrumentation at compile time by guarding its hooks
+   with its own configuration macro, for example
+
+       #if CFLOAT_INSTRUMENTATION
+           instrumentation<cfloat>::record(InstrumentedEvent::add);
+       #endif
+
+   so that a disabled build does not contain a single instruction of the instrumentation.
+
+   Each thread records into its own buffer of counters. Only the owning thread writes
+   a buffer, so an event is a relaxed load and store of a thread-private cache line,
+   without any locked read-modify-write or contention between threads. The buffers are
+   linked into a lock-free registry and report() aggregates them on demand. Buffers of
+   threads that have exited keep their counts and are recycled by new threads.
+
+   reset() clears the buffers of all threads: it is exact when the instrumented threads
+   are quiescent, for example between the phases of a computation.
+*/
+
+namespace sw { namespace universal {
+
+enum class InstrumentedEvent : unsigned {
+	load, store, add, sub, mul, div, rem, sqrt,
+	round, overflow, underflow, saturate,
+	NR_EVENTS
+};
+
+// the range of the scale histogram of a number system, specialize for number systems with a wider dynamic range
+template<typename NumberSystem>
+struct instrumentation_traits {
+	static constexpr int minScale = -128;
+	static constexpr int maxScale =  127;
+};
+
+// aggregated snapshot of the instrumentation of a number system
+template<typename NumberSystem>
+struct instrumentation_report {
+	instrumentation_report() : ops{}, scales(instrumentation_traits<NumberSystem>::minScale, instrumentation_traits<NumberSystem>::maxScale) {}
+	occurrence<NumberSystem> ops;
+	scaleTracker             scales;
+
+	void report(std::ostream& ostr) const {
+		ops.report(ostr);
+		scales.report(ostr);
+	}
+};
+
+template<typename NumberSystem>
+class instrumentation {
+	static constexpr int      minScale = instrumentation_traits<NumberSystem>::minScale;
+	static constexpr int      maxScale = instrumentation_traits<NumberSystem>::maxScale;
+	static constexpr unsigned nrEvents = static_cast<unsigned>(InstrumentedEvent::NR_EVENTS);
+	static constexpr size_t   nrScales = static_cast<size_t>(maxScale - minScale + 1);
+
+	// per-thread counters, aligned to avoid false sharing between the buffers of different threads
+	struct alignas(64) buffer {
+		buffer() : next{ nullptr }, inUse{ true }, suppressed{ 0 } {
+			for (auto& e : events) e.store(0, std::memory_order_relaxed);
+			for (auto& s : scales) s.store(0, std::memory_order_relaxed);
+			belowRange.store(0, std::memory_order_relaxed);
+			aboveRange.store(0, std::memory_order_relaxed);
+		}
+		std::atomic<uint64_t> events[nrEvents];
+		std::atomic<uint64_t> scales[nrScales];
+		std::atomic<uint64_t> belowRange;
+		std::atomic<uint64_t> aboveRange;
+		buffer*               next;        // immutable once the buffer is published in the registry
+		std::atomic<bool>     inUse;       // owned by a live thread
+		unsigned              suppressed;  // owner-only nesting count of suppressed operation counts
+	};
+
+	static void increment(std::atomic<uint64_t>& counter) noexcept {
+		// single writer: no locked read-modify-write is required
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	static std::atomic<buffer*>& registry() noexcept {
+		static std::atomic<buffer*> head{ nullptr };
+		return head;
+	}
+
+	// claim the buffer of an exited thread, or publish a new one
+	static buffer* acquire() {
+		for (buffer* b = registry().load(std::memory_order_acquire); b != nullptr; b = b->next) {
+			bool expected = false;
+			if (!b->inUse.load(std::memory_order_relaxed) && b->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) return b;
+		}
+		buffer* b = new buffer;  // buffers live for the duration of the process so that their counts survive their thread
+		buffer* head = registry().load(std::memory_order_relaxed);
+		do {
+			b->next = head;
+		} while (!registry().compare_exchange_weak(head, b, std::memory_order_release, std::memory_order_relaxed));
+		return b;
+	}
+
+	struct handle {
+		handle() : b{ acquire() } {}
+		~handle() { b->inUse.store(false, std::memory_order_release); }
+		buffer* b;
+	};
+
+	static buffer& local() {
+		thread_local handle h;
+		return *h.b;
+	}
+
+public:
+	// record an event in the buffer of the calling thread
+	static void record(InstrumentedEvent e) {
+		buffer& b = local();
+		if (b.suppressed == 0 || e >= InstrumentedEvent::round) increment(b.events[static_cast<unsigned>(e)]);
+	}
+
+	// record the scale of a result in the histogram of the calling thread
+	static void record_scale(int scale) {
+		buffer& b = local();
+		if (scale < minScale) {
+			increment(b.belowRange);
+		}
+		else if (scale > maxScale) {
+			increment(b.aboveRange);
+		}
+		else {
+			increment(b.scales[static_cast<size_t>(scale - minScale)]);
+		}
+	}
+
+	/// <summary>
+	/// suppress the operation counts of the calling thread for the lifetime of this object, so that
+	/// an operator that is implemented in terms of other instrumented operators counts once.
+	/// Rounding, overflow, underflow, and saturation events and the scales are still recorded.
+	/// </summary>
+	class scoped_suppression {
+	public:
+		scoped_suppression() : b{ local() } { ++b.suppressed; }
+		~scoped_suppression() { --b.suppressed; }
+		scoped_suppression(const scoped_suppression&) = delete;
+		scoped_suppression& operator=(const scoped_suppression&) = delete;
+	private:
+		buffer& b;
+	};
+
+	// aggregate the buffers of all threads
+	static instrumentation_report<NumberSystem> report() {
+		instrumentation_report<NumberSystem> r;
+		for (buffer* b = registry().load(std::memory_order_acquire); b != nullptr; b = b->next) {
+			occurrence<NumberSystem>& o = r.ops;
+			auto count = [b](InstrumentedEvent e) { return static_cast<size_t>(b->events[static_cast<unsigned>(e)].load(std::memory_order_relaxed)); };
+			o.load      += count(InstrumentedEvent::load);
+			o.store     += count(InstrumentedEvent::store);
+			o.add       += count(InstrumentedEvent::add);
+			o.sub       += count(InstrumentedEvent::sub);
+			o.mul       += count(InstrumentedEvent::mul);
+			o.div       += count(InstrumentedEvent::div);
+			o.rem       += count(InstrumentedEvent::rem);
+			o.sqrt      += count(InstrumentedEvent::sqrt);
+			o.round     += count(InstrumentedEvent::round);
+			o.overflow  += count(InstrumentedEvent::overflow);
+			o.underflow += count(InstrumentedEvent::underflow);
+			o.saturate  += count(InstrumentedEvent::saturate);
+			for (size_t i = 0; i < nrScales; ++i) {
+				r.scales.incr(minScale + static_cast<int>(i), static_cast<size_t>(b->scales[i].load(std::memory_order_relaxed)));
+			}
+			r.scales.incr(minScale - 1, static_cast<size_t>(b->belowRange.load(std::memory_order_relaxed)));
+			r.scales.incr(maxScale + 1, static_cast<size_t>(b->aboveRange.load(std::memory_order_relaxed)));
+		}
+		return r;
+	}
+
+	// clear the counters of all threads
+	static void reset() {
+		for (buffer* b = registry().load(std::memory_order_acquire); b != nullptr; b = b->next) {
+			for (auto& e : b->events) e.store(0, std::memory_order_relaxed);
+			for (auto& s : b->scales) s.store(0, std::memory_order_relaxed);
+			b->belowRange.store(0, std::memory_order_relaxed);
+			b->aboveRange.store(0, std::memory_order_relaxed);
+		}
+	}
+};
+
+}} // namespace sw::universal
@@ -4,6 +4,8 @@
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cstddef>
+#include <iostream>
 
 namespace sw { namespace universal {
 
@@ -18,8 +20,13 @@ namespace sw { namespace universal {
 		size_t div;
 		size_t rem;
 		size_t sqrt;
+		// exceptional events of the rounding and projection of results onto the encoding
+		size_t round;      // results that were rounded up in magnitude
+		size_t overflow;   // results that were projected to infinity
+		size_t underflow;  // results that were flushed to zero
+		size_t saturate;   // results that were clamped to maxpos/maxneg
 
-		occurrence() : load{ 0 }, store{ 0 }, add{ 0 }, sub{ 0 }, mul{ 0 }, div{ 0 }, rem{ 0 }, sqrt{ 0 } {};
+		occurrence() : load{ 0 }, store{ 0 }, add{ 0 }, sub{ 0 }, mul{ 0 }, div{ 0 }, rem{ 0 }, sqrt{ 0 }, round{ 0 }, overflow{ 0 }, underflow{ 0 }, saturate{ 0 } {};
 		void reset() {
 			load = 0;
 			store = 0;
@@ -29,8 +36,27 @@ namespace sw { namespace universal {
 			div = 0;
 			rem = 0;
 			sqrt = 0;
+			round = 0;
+			overflow = 0;
+			underflow = 0;
+			saturate = 0;
 		}
-		void report(std::ostream& ostr) {
+		occurrence& operator+=(const occurrence& rhs) {
+			load += rhs.load;
+			store += rhs.store;
+			add += rhs.add;
+			sub += rhs.sub;
+			mul += rhs.mul;
+			div += rhs.div;
+			rem += rhs.rem;
+			sqrt += rhs.sqrt;
+			round += rhs.round;
+			overflow += rhs.overflow;
+			underflow += rhs.underflow;
+			saturate += rhs.saturate;
+			return *this;
+		}
+		void report(std::ostream& ostr) const {
 			ostr << "Load    : " << load << '\n';
 			ostr << "Store   : " << store << '\n';
 			ostr << "Add     : " << add << '\n';
@@ -39,7 +65,13 @@ namespace sw { namespace universal {
 			ostr << "Div     : " << div << '\n';
 			ostr << "Rem     : " << rem << '\n';
 			ostr << "Sqrt    : " << sqrt << '\n';
+			if (round + overflow + underflow + saturate > 0) {
+				ostr << "Round   : " << round << '\n';
+				ostr << "Overflow: " << overflow << '\n';
+				ostr << "Undrflow: " << underflow << '\n';
+				ostr << "Saturate: " << saturate << '\n';
+			}
 		}
 	};
 
-}} // namespace sw::universal
\ No newline at end of file
+}} // namespace sw::universal
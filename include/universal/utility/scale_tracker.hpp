@@ -1,9 +1,11 @@
 #pragma once
-// occurrence.hpp: utility object to track arithmetic operation counts during execution of a specific number system
+// scale_tracker.hpp: utility object to track the histogram of scales of values during execution of a computation
 //
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -19,9 +21,40 @@ public:
 
 	// clear the occurrence counts, but keep the configuration of the scale tracker 
 	void clear() {
-		scales.clear();
+		std::fill(scales.begin(), scales.end(), 0);
+		underflows = 0;
+		overflows = 0;
 	}
 
+	// add the occurrence counts of a scale tracker with the same configuration
+	void merge(const scaleTracker& rhs) {
+		if (rhs.minScale != minScale || rhs.maxScale != maxScale) return;
+		for (size_t i = 0; i < scales.size(); ++i) scales[i] += rhs.scales[i];
+		underflows += rhs.underflows;
+		overflows += rhs.overflows;
+	}
+
+	// add count occurrences of scale in a single step
+	void incr(int scale, size_t count) {
+		if (scale < minScale) {
+			underflows += count;
+		}
+		else if (scale > maxScale) {
+			overflows += count;
+		}
+		else {
+			scales[static_cast<size_t>(static_cast<int64_t>(scale) - static_cast<int64_t>(minScale))] += count;
+		}
+	}
+
+	int    smallestScale() const noexcept { return minScale; }
+	int    biggestScale() const noexcept { return maxScale; }
+	size_t count(int scale) const noexcept {
+		return (scale < minScale || scale > maxScale) ? 0 : scales[static_cast<size_t>(static_cast<int64_t>(scale) - static_cast<int64_t>(minScale))];
+	}
+	size_t nrUnderflows() const noexcept { return underflows; }
+	size_t nrOverflows() const noexcept { return overflows; }
+
 	void incr(int scale) {
 		if (scale < minScale) {
 			++underflows;
@@ -37,7 +70,7 @@ public:
 		}
 	}
 
-	void report(std::ostream& ostr) {
+	void report(std::ostream& ostr) const {
 		int i = minScale;
 		for (auto f : scales) {
 			ostr << std::setw(4) << i++ << " : " << f << '\n';
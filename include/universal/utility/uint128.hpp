@@ -0,0 +1,24 @@
+#pragma once
+// uint128.hpp: compiler specialization for native 128-bit unsigned integer support
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+
+// GCC and Clang provide an unsigned __int128 on 64-bit targets, MSVC does not. The kernels
+// that carry or multiply 64-bit blocks use it through the alias sw::universal::uint128_t,
+// which is declared as an __extension__ so that pedantic builds do not warn about it. This
+// compiler check yields the define UINT128_SUPPORT with the answer whether the alias exists.
+
+#if defined(__SIZEOF_INT128__)
+#define UINT128_SUPPORT 1
+
+namespace sw { namespace universal {
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+}} // namespace sw::universal
+
+#else
+#define UINT128_SUPPORT 0
+#endif
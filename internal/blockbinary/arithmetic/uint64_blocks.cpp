@@ -0,0 +1,153 @@
+// uint64_blocks.cpp: functional tests of the carry chains of blockbinary with uint64_t blocks
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/utility/long_double.hpp>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include <universal/internal/blockbinary/blockbinary.hpp>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// the add-with-carry and subtract-with-borrow steps at the boundaries of a uint64_t block
+int VerifyCarryPrimitives(bool reportTestCases) {
+	using namespace sw::universal;
+	int nrOfFailedTests = 0;
+	constexpr uint64_t ones = ~uint64_t(0);
+	struct Case { uint64_t a, b, cin, sum, cout, diff, bout; };
+	constexpr Case cases[] = {
+		{ 0,    0,    0, 0,        0, 0,        0 },
+		{ ones, 1,    0, 0,        1, ones - 1, 0 },
+		{ ones, 0,    1, 0,        1, ones - 1, 0 },
+		{ ones, ones, 1, ones,     1, ones,     1 },
+		{ 0,    1,    0, 1,        0, ones,     1 },
+		{ 0,    0,    1, 1,        0, ones,     1 },
+		{ 1,    ones, 0, 0,        1, 2,        1 },
+	};
+	for (const auto& c : cases) {
+		uint64_t carry = c.cin, borrow = c.cin;
+		uint64_t sum = block_addc(c.a, c.b, carry);
+		uint64_t diff = block_subb(c.a, c.b, borrow);
+		if (sum != c.sum || carry != c.cout || diff != c.diff || borrow != c.bout) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: " << std::hex << c.a << " op " << c.b << " with carry " << c.cin << " : " << sum << ' ' << carry << ' ' << diff << ' ' << borrow << std::dec << '\n';
+		}
+	}
+	// the carry and borrow primitives must be usable in constant expressions
+	constexpr uint64_t folded = [] { uint64_t carry = 1; uint64_t s = block_addc(ones, uint64_t(0), carry); return s + carry; }();
+	static_assert(folded == 1, "block_addc is not constexpr");
+	return nrOfFailedTests;
+}
+
+// the arithmetic of blockbinary does not depend on the block type: compare uint64_t blocks to uint32_t blocks
+template<unsigned nbits>
+int VerifyBlockTypeInvariance(unsigned nrOfRandoms, bool reportTestCases) {
+	using namespace sw::universal;
+	using Reference = blockbinary<nbits, uint32_t>;
+	using Wide = blockbinary<nbits, uint64_t>;
+	std::mt19937_64 engine(nbits);
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		Reference a(0), b(0);
+		Wide wa(0), wb(0);
+		// runs of all ones drive the carries across the block boundaries
+		unsigned pattern = static_cast<unsigned>(engine() % 4);
+		for (unsigned i = 0; i < nbits; ++i) {
+			bool abit = (pattern == 0 ? true : (engine() & 1) != 0);
+			bool bbit = (pattern == 1 ? (i == 0) : (engine() & 1) != 0);
+			if (pattern == 2 && i >= nbits / 2) bbit = false;  // divisors much shorter than the dividend
+			a.setbit(i, abit); wa.setbit(i, abit);
+			b.setbit(i, bbit); wb.setbit(i, bbit);
+		}
+		if (b.iszero()) continue;
+		Reference r[5] = { a + b, a - b, a * b, a / b, a % b };
+		Wide w[5] = { wa + wb, wa - wb, wa * wb, wa / wb, wa % wb };
+		for (unsigned k = 0; k < 5; ++k) {
+			if (to_binary(r[k]) != to_binary(w[k])) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: operator " << "+-*/%"[k] << " of " << to_hex(a) << " and " << to_hex(b) << " : " << to_hex(w[k]) << " reference " << to_hex(r[k]) << '\n';
+			}
+		}
+		Reference na(-a);
+		Wide nwa(-wa);
+		if (to_binary(na) != to_binary(nwa)) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: negation of " << to_hex(a) << '\n';
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "blockbinary uint64_t block carry chains";
+	std::string test_tag    = "uint64_t blocks";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<128>(10, reportTestCases), "blockbinary<128,uint64_t>", test_tag);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS; // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyCarryPrimitives(reportTestCases), "block_addc/block_subb", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<64>(500, reportTestCases), "blockbinary<64,uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<100>(500, reportTestCases), "blockbinary<100,uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<128>(500, reportTestCases), "blockbinary<128,uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<200>(500, reportTestCases), "blockbinary<200,uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_3
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<256>(500, reportTestCases), "blockbinary<256,uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << msg << '\n';
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << '\n';
+	return EXIT_FAILURE;
+}
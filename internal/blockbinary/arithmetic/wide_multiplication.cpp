@@ -0,0 +1,222 @@
+// wide_multiplication.cpp: functional tests for the multi-block multiplication kernels of the wide block types
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/utility/long_double.hpp>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include <universal/internal/blockbinary/blockbinary.hpp>
+#include <universal/internal/blockmultiply/blockmultiply.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// bit-serial shift-and-add reference: r = a * b modulo 2^(nr * bitsInBlock)
+template<typename BlockType>
+void ReferenceMultiply(const BlockType* a, unsigned na, const BlockType* b, unsigned nb, BlockType* r, unsigned nr) {
+	constexpr unsigned bitsInBlock = sizeof(BlockType) * 8;
+	for (unsigned k = 0; k < nr; ++k) r[k] = 0;
+	for (unsigned bit = 0; bit < na * bitsInBlock; ++bit) {
+		if (((a[bit / bitsInBlock] >> (bit % bitsInBlock)) & 1u) == 0) continue;
+		unsigned shift = bit;
+		// r += b << shift
+		uint64_t carry = 0;
+		for (unsigned k = shift / bitsInBlock; k < nr; ++k) {
+			unsigned i = k - shift / bitsInBlock;
+			unsigned s = shift % bitsInBlock;
+			uint64_t bk = 0;
+			if (i < nb) bk = (uint64_t(b[i]) << s);
+			if (s > 0 && i > 0 && i - 1 < nb) bk |= (uint64_t(b[i - 1]) >> (bitsInBlock - s));
+			BlockType term = static_cast<BlockType>(bk);
+			BlockType sum = static_cast<BlockType>(r[k] + term);
+			uint64_t c = (sum < term ? 1u : 0u);
+			r[k] = static_cast<BlockType>(sum + carry);
+			c += (r[k] < carry ? 1u : 0u);
+			carry = c;
+		}
+	}
+}
+
+// random operands with runs of all ones and all zeros, to exercise the carry chains
+template<typename BlockType>
+void RandomOperand(std::mt19937_64& engine, BlockType* a, unsigned n) {
+	for (unsigned i = 0; i < n; ++i) {
+		switch (engine() % 4) {
+		case 0:  a[i] = BlockType(0); break;
+		case 1:  a[i] = BlockType(~BlockType(0)); break;
+		default: a[i] = static_cast<BlockType>(engine()); break;
+		}
+	}
+}
+
+// compare block_multiply of na x nb blocks into nr blocks to the bit-serial reference
+template<typename BlockType, unsigned na, unsigned nb, unsigned nr>
+int VerifyBlockMultiply(unsigned nrOfRandoms, bool reportTestCases) {
+	using namespace sw::universal;
+	std::mt19937_64 engine(na * 131 + nb * 17 + nr);
+	int nrOfFailedTests = 0;
+	BlockType a[na], b[nb], r[nr], ref[nr];
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		RandomOperand(engine, a, na);
+		RandomOperand(engine, b, nb);
+		if (t == 0) {  // the largest product
+			for (unsigned i = 0; i < na; ++i) a[i] = BlockType(~BlockType(0));
+			for (unsigned i = 0; i < nb; ++i) b[i] = BlockType(~BlockType(0));
+		}
+		block_multiply<BlockType, na, nb, nr>(a, b, r);
+		ReferenceMultiply(a, na, b, nb, ref, nr);
+		for (unsigned k = 0; k < nr; ++k) {
+			if (r[k] != ref[k]) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: block " << k << " of product " << t << " : " << std::hex << uint64_t(r[k]) << " != " << uint64_t(ref[k]) << std::dec << '\n';
+				break;
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// null the bits of the most significant block that fall outside of nbits
+template<unsigned nbits, typename BlockType>
+BlockType MostSignificantBlockMask() {
+	constexpr unsigned bitsInBlock = sizeof(BlockType) * 8;
+	constexpr unsigned rem = nbits % bitsInBlock;
+	if constexpr (rem == 0) return BlockType(~BlockType(0)); else return static_cast<BlockType>((uint64_t(1) << rem) - 1);
+}
+
+// compare the modulo multiplication and the unrounded multiplications of a wide signed blockbinary to the bit-serial reference
+template<unsigned nbits, typename BlockType>
+int VerifyWideBlockBinaryMultiply(unsigned nrOfRandoms, bool reportTestCases) {
+	using namespace sw::universal;
+	using BlockBinary = blockbinary<nbits, BlockType>;
+	using WideBlockBinary = blockbinary<2 * nbits, BlockType>;
+	constexpr unsigned nrBlocks = BlockBinary::nrBlocks;
+	constexpr unsigned nrWideBlocks = WideBlockBinary::nrBlocks;
+	std::mt19937_64 engine(nbits);
+	int nrOfFailedTests = 0;
+	BlockBinary a, b;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		BlockType ablocks[nrBlocks], bblocks[nrBlocks];
+		RandomOperand(engine, ablocks, nrBlocks);
+		RandomOperand(engine, bblocks, nrBlocks);
+		ablocks[nrBlocks - 1] &= MostSignificantBlockMask<nbits, BlockType>();
+		bblocks[nrBlocks - 1] &= MostSignificantBlockMask<nbits, BlockType>();
+		for (unsigned i = 0; i < nrBlocks; ++i) {
+			a.setblock(i, ablocks[i]);
+			b.setblock(i, bblocks[i]);
+		}
+		if (t == 0) { a.maxneg(); b.maxneg(); }
+		if (t == 1) { a.maxneg(); b = -1; }
+
+		// the reference works on the sign-extended 2*nbits encodings
+		WideBlockBinary wa(a), wb(b), reference;
+		BlockType wablocks[nrWideBlocks], wbblocks[nrWideBlocks], refblocks[nrWideBlocks];
+		for (unsigned i = 0; i < nrWideBlocks; ++i) {
+			wablocks[i] = wa.block(i);
+			wbblocks[i] = wb.block(i);
+		}
+		ReferenceMultiply(wablocks, nrWideBlocks, wbblocks, nrWideBlocks, refblocks, nrWideBlocks);
+		refblocks[nrWideBlocks - 1] &= MostSignificantBlockMask<2 * nbits, BlockType>();
+		for (unsigned i = 0; i < nrWideBlocks; ++i) reference.setblock(i, refblocks[i]);
+
+		BlockBinary modulo(a);
+		modulo *= b;
+		BlockBinary truncated(reference);
+		WideBlockBinary r1 = urmul(a, b), r2 = urmul2(a, b);
+		if (modulo != truncated || r1 != reference || r2 != reference) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: " << to_hex(a) << " * " << to_hex(b) << " = " << to_hex(r2) << " reference " << to_hex(reference) << '\n';
+		}
+		BlockBinary square(a);
+		square *= square;  // the operand aliases the result
+		BlockBinary copy(a);
+		if (square != (copy *= a)) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: aliased square of " << to_hex(a) << '\n';
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "wide block multiplication";
+	std::string test_tag    = "wide multiplication";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint64_t, 32, 32, 64>(10, reportTestCases), "uint64_t 32x32->64", test_tag);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS; // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	// schoolbook, full and truncated products, and unequal operand lengths
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint8_t, 5, 5, 10>(100, reportTestCases), "uint8_t 5x5->10", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint16_t, 7, 3, 10>(100, reportTestCases), "uint16_t 7x3->10", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint32_t, 8, 8, 8>(100, reportTestCases), "uint32_t 8x8->8", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint64_t, 4, 4, 8>(100, reportTestCases), "uint64_t 4x4->8", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint64_t, 3, 5, 6>(100, reportTestCases), "uint64_t 3x5->6", test_tag);
+
+	// Karatsuba: the operands are above the threshold, and odd lengths split unevenly
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint32_t, 32, 32, 64>(20, reportTestCases), "uint32_t 32x32->64", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint32_t, 67, 67, 134>(10, reportTestCases), "uint32_t 67x67->134", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockMultiply<uint64_t, 33, 33, 66>(10, reportTestCases), "uint64_t 33x33->66", test_tag);
+
+	// wide blockbinary modulo and unrounded multiplication
+	nrOfFailedTestCases += ReportTestResult(VerifyWideBlockBinaryMultiply<67, uint8_t>(50, reportTestCases), "blockbinary<67,uint8_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyWideBlockBinaryMultiply<128, uint32_t>(50, reportTestCases), "blockbinary<128,uint32_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyWideBlockBinaryMultiply<1023, uint32_t>(10, reportTestCases), "blockbinary<1023,uint32_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_2
+#endif
+
+#if REGRESSION_LEVEL_3
+#endif
+
+#if REGRESSION_LEVEL_4
+	nrOfFailedTestCases += ReportTestResult(VerifyWideBlockBinaryMultiply<4096, uint32_t>(4, reportTestCases), "blockbinary<4096,uint32_t>", test_tag);
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << msg << '\n';
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << '\n';
+	return EXIT_FAILURE;
+}
@@ -331,6 +331,8 @@ void TestBlockPerformanceOnMul() {
 	PerformanceRunner("blockbinary<1024,uint8>   mul   ", bb::MultiplicationWorkload< blockbinary<1024, uint8_t> >, NR_OPS / 1024);
 	PerformanceRunner("blockbinary<1024,uint16>  mul   ", bb::MultiplicationWorkload< blockbinary<1024, uint16_t> >, NR_OPS / 512);
 	PerformanceRunner("blockbinary<1024,uint32>  mul   ", bb::MultiplicationWorkload< blockbinary<1024, uint32_t> >, NR_OPS / 256);
+	PerformanceRunner("blockbinary<2048,uint32>  mul   ", bb::MultiplicationWorkload< blockbinary<2048, uint32_t> >, NR_OPS / 1024);
+	PerformanceRunner("blockbinary<4096,uint32>  mul   ", bb::MultiplicationWorkload< blockbinary<4096, uint32_t> >, NR_OPS / 4096);
 }
 
 #define MANUAL_TESTING 0
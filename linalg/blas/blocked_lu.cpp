@@ -0,0 +1,106 @@
+// blocked_lu.cpp: test of the right-looking blocked LU decomposition
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+// configure posit environment
+#define POSIT_FAST_POSIT_16_1 1
+#define POSIT_FAST_POSIT_32_2 1
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+template<typename Scalar>
+sw::universal::blas::matrix<Scalar> RandomSystem(unsigned N, unsigned seed) {
+	sw::universal::blas::matrix<Scalar> A(N, N);
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	for (auto& e : A) e = Scalar(dist(engine));
+	return A;
+}
+
+// the blocked algorithm applies the updates in the same order as the Crout loops of ludcmp:
+// for IEEE types the factors and the pivots must be identical for every block size and thread count
+template<typename Scalar>
+int VerifyBlockedLuMatchesLudcmp(unsigned N, unsigned blockSize, unsigned nrThreads, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	matrix<Scalar> A = RandomSystem<Scalar>(N, N), B(A);
+	vector<size_t> p, q;
+	ludcmp(A, p);
+	blocked_ludcmp(B, q, blockSize, nrThreads);
+	int nrOfFailedTestCases = 0;
+	for (unsigned i = 0; i < N; ++i) {
+		if (p[i] != q[i]) ++nrOfFailedTestCases;
+		for (unsigned j = 0; j < N; ++j) {
+			if (A(i, j) != B(i, j)) ++nrOfFailedTestCases;
+		}
+	}
+	if (nrOfFailedTestCases && reportTestCases) std::cerr << "blocked LU of size " << N << " with block size " << blockSize << " differs from ludcmp\n";
+	return nrOfFailedTestCases;
+}
+
+// solve A x = b with x = 1 and check the infinity norm of the error
+template<typename Scalar>
+int VerifyBlockedLuSolve(unsigned N, unsigned blockSize, unsigned nrThreads, double tolerance, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	using std::abs;
+	matrix<Scalar> A = RandomSystem<Scalar>(N, 2 * N);
+	vector<Scalar> x(N), b(N);
+	x = Scalar(1);
+	b = A * x;
+	vector<size_t> p;
+	if (blocked_ludcmp(A, p, blockSize, nrThreads) != 0) return 1;
+	vector<Scalar> xx = lubksb(A, p, b);
+	double infnorm = 0.0;
+	for (unsigned i = 0; i < N; ++i) infnorm = std::max(infnorm, abs(double(xx[i]) - 1.0));
+	if (infnorm > tolerance) {
+		if (reportTestCases) std::cerr << "blocked LU solve of size " << N << " error " << infnorm << " exceeds " << tolerance << '\n';
+		return 1;
+	}
+	return 0;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "blocked LU decomposition";
+	std::string test_tag    = "blocked_ludcmp";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuMatchesLudcmp<double>(50, 1, 1, reportTestCases), "double", "block size 1");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuMatchesLudcmp<double>(50, 8, 1, reportTestCases), "double", "block size 8");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuMatchesLudcmp<double>(67, 16, 4, reportTestCases), "double", "block size 16, 4 threads");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuMatchesLudcmp<float>(100, 100, 2, reportTestCases), "float", "single panel");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuSolve<double>(64, 16, 2, 1.0e-10, reportTestCases), "double", "solve");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedLuSolve< posit<32, 2> >(40, 8, 2, 1.0e-4, reportTestCases), "posit<32,2>", "fused solve");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::posit_arithmetic_exception& err) {
+	std::cerr << "Uncaught posit arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,261 @@
+// expression_templates.cpp: test of the element-wise expression templates of blas::vector and blas::matrix
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <cstdlib>
+#include <memory>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+// a double whose containers count their heap allocations, so that the tests can verify that an expression does not create temporaries
+struct counted {
+	counted() = default;
+	counted(double v) : value(v) {}
+	explicit operator double() const { return value; }
+	counted operator-() const { return counted(-value); }
+	counted& operator+=(counted rhs) { value += rhs.value; return *this; }
+	counted& operator-=(counted rhs) { value -= rhs.value; return *this; }
+	counted& operator*=(counted rhs) { value *= rhs.value; return *this; }
+	counted& operator/=(counted rhs) { value /= rhs.value; return *this; }
+	friend counted operator+(counted a, counted b) { return counted(a.value + b.value); }
+	friend counted operator-(counted a, counted b) { return counted(a.value - b.value); }
+	friend counted operator*(counted a, counted b) { return counted(a.value * b.value); }
+	friend counted operator/(counted a, counted b) { return counted(a.value / b.value); }
+	friend bool operator==(counted a, counted b) { return a.value == b.value; }
+	friend bool operator!=(counted a, counted b) { return a.value != b.value; }
+	friend std::ostream& operator<<(std::ostream& ostr, counted c) { return ostr << c.value; }
+	double value{ 0.0 };
+};
+// blas::vector<counted> stores its elements in a std::vector<counted>, which allocates through this specialization
+static size_t nrOfAllocations = 0;
+namespace std {
+template<>
+struct allocator<counted> {
+	using value_type = counted;
+	allocator() = default;
+	template<typename U> allocator(const std::allocator<U>&) {}
+	counted* allocate(size_t n) {
+		++nrOfAllocations;
+		return static_cast<counted*>(::operator new(n * sizeof(counted)));
+	}
+	void deallocate(counted* p, size_t) { ::operator delete(p); }
+	template<typename... Args> void construct(counted* p, Args&&... args) { ::new(static_cast<void*>(p)) counted(std::forward<Args>(args)...); }
+	void destroy(counted* p) { p->~counted(); }
+	size_t max_size() const noexcept { return size_t(-1) / sizeof(counted); }
+	friend bool operator==(const allocator&, const allocator&) { return true; }
+	friend bool operator!=(const allocator&, const allocator&) { return false; }
+};
+}
+
+// the expressions compute the same values as the element-wise loops
+template<typename Scalar>
+int VerifyVectorExpressions(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	constexpr size_t N = 37;
+	vector<Scalar> x(N), y(N), z(N);
+	for (size_t i = 0; i < N; ++i) {
+		x[i] = Scalar(double(i % 7) - 3.0);
+		y[i] = Scalar(double(i % 5) + 0.5);
+		z[i] = Scalar(double(i % 3) * 0.25);
+	}
+	Scalar alpha(0.5), beta(-2.0);
+	auto check = [&](const char* what, const vector<Scalar>& result, auto reference) {
+		for (size_t i = 0; i < N; ++i) {
+			if (result[i] != reference(i)) {
+				if (reportTestCases) std::cerr << what << " element " << i << " : " << result[i] << " != " << reference(i) << '\n';
+				++nrOfFailedTestCases;
+				return;
+			}
+		}
+	};
+
+	// the operators of containers return containers
+	static_assert(std::is_same_v<decltype(x - y), vector<Scalar>>, "the difference of two vectors is a vector");
+	static_assert(std::is_same_v<decltype(alpha * x), vector<Scalar>>, "a scaled vector is a vector");
+	vector<Scalar> r = x + alpha * y - z / beta;
+	check("x + alpha * y - z / beta", r, [&](size_t i) { return Scalar(Scalar(x[i] + Scalar(alpha * y[i])) - Scalar(z[i] / beta)); });
+	auto e = x - y;
+	e += z;
+	check("x - y + z", e, [&](size_t i) { return Scalar(Scalar(x[i] - y[i]) + z[i]); });
+	r = -x / 2;
+	check("-x / 2", r, [&](size_t i) { return Scalar(-x[i] / Scalar(2)); });
+
+	// the lazy expressions compute the same values
+	r = lazy(x) + alpha * lazy(y) - lazy(z) / beta;
+	check("lazy(x) + alpha * lazy(y) - lazy(z) / beta", r, [&](size_t i) { return Scalar(Scalar(x[i] + Scalar(alpha * y[i])) - Scalar(z[i] / beta)); });
+	r = -(lazy(x) - y) * beta;
+	check("-(lazy(x) - y) * beta", r, [&](size_t i) { return Scalar(Scalar(-Scalar(x[i] - y[i])) * beta); });
+
+	// the target appears on the right-hand side
+	vector<Scalar> w(x);
+	w = w + alpha * lazy(y);
+	check("w = w + alpha * lazy(y)", w, [&](size_t i) { return Scalar(x[i] + Scalar(alpha * y[i])); });
+	w = x;
+	w -= alpha * lazy(y) - z;
+	check("w -= alpha * lazy(y) - z", w, [&](size_t i) { return Scalar(x[i] - Scalar(Scalar(alpha * y[i]) - z[i])); });
+
+	// the fused kernels
+	w = y;
+	axpby(alpha, x, beta, w);
+	check("axpby", w, [&](size_t i) { return Scalar(Scalar(alpha * x[i]) + Scalar(beta * y[i])); });
+	w = y;
+	xpby(x, beta, w);
+	check("xpby", w, [&](size_t i) { return Scalar(x[i] + Scalar(beta * y[i])); });
+	w = y;
+	axpy(alpha, lazy(x) - z, w);
+	check("axpy", w, [&](size_t i) { return Scalar(y[i] + Scalar(alpha * Scalar(x[i] - z[i]))); });
+
+	// reductions and dot products of expressions
+	vector<Scalar> d = x - y;
+	if ((lazy(x) - y) * z != d * z || norm(lazy(x) - y, 1) != norm(d, 1) || (lazy(x) - y).infnorm() != d.infnorm() || sum(lazy(x) - y) != sum(d)) {
+		if (reportTestCases) std::cerr << "reductions of lazy(x) - y differ from the reductions of the evaluated vector\n";
+		++nrOfFailedTestCases;
+	}
+
+	// the sum of vectors of different sizes throws
+	bool caught = false;
+	try {
+		vector<Scalar> s = lazy(x) + vector<Scalar>(N + 1);
+	}
+	catch (const matmul_incompatible_matrices&) {
+		caught = true;
+	}
+	if (!caught) {
+		if (reportTestCases) std::cerr << "the sum of vectors of different sizes did not throw\n";
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+// the assignment of a lazy expression to an existing vector runs without allocating temporaries
+int VerifyNoTemporaries(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	using Scalar = counted;
+	int nrOfFailedTestCases = 0;
+	constexpr size_t N = 100;
+	vector<Scalar> x(N, Scalar(1)), p(N, Scalar(2)), q(N, Scalar(3)), rho(N, Scalar(4));
+	Scalar alpha(0.25), beta(0.5);
+	size_t before = nrOfAllocations;
+	x = x + alpha * lazy(p);
+	rho = rho - alpha * lazy(q);
+	p = rho + beta * lazy(p);
+	x += alpha * (lazy(p) - q);
+	size_t allocations = nrOfAllocations - before;
+	if (allocations != 0) {
+		if (reportTestCases) std::cerr << "the solver updates allocated " << allocations << " temporaries\n";
+		++nrOfFailedTestCases;
+	}
+	// the operators of containers allocate their results
+	before = nrOfAllocations;
+	x = x + alpha * p;
+	if (nrOfAllocations == before) {
+		if (reportTestCases) std::cerr << "x = x + alpha * p did not allocate its result\n";
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+// temporaries in an expression are held by value, so the expression can be stored and evaluated later
+template<typename Scalar>
+int VerifyExpressionLifetime(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	matrix<Scalar> A = { { 1, 2 }, { 3, 4 } };
+	vector<Scalar> x = { 1, -1 }, b = { 5, 6 };
+	auto residual = b - lazy(A * x);                 // A * x is a temporary
+	auto shifted = lazy(A) - Scalar(2) * eye<Scalar>(2);  // so is the identity
+	vector<Scalar> r(residual);
+	matrix<Scalar> S(shifted);
+	vector<Scalar> rref = { 6, 7 };
+	matrix<Scalar> Sref = { { -1, 2 }, { 3, 2 } };
+	if (r != rref || S != Sref) {
+		if (reportTestCases) std::cerr << "stored expressions evaluate to " << r << " and\n" << S;
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+// element-wise matrix expressions, and products with expression operands
+template<typename Scalar>
+int VerifyMatrixExpressions(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	matrix<Scalar> A = { { 1, 2, 3 }, { 4, 5, 6 } };
+	matrix<Scalar> B = { { 6, 5, 4 }, { 3, 2, 1 } };
+	matrix<Scalar> C = A + B - A / Scalar(2);
+	matrix<Scalar> Cref = { { 6.5, 6, 5.5 }, { 5, 4.5, 4 } };
+	matrix<Scalar> L = lazy(A) + B - lazy(A) / Scalar(2);
+	C -= -B;
+	L -= -lazy(B);
+	Cref += B;
+	auto D = A - B;  // a matrix, updated in place
+	D += B;
+	vector<Scalar> x = { 1, 0, -1 }, y = { 2, 1, 0 };
+	vector<Scalar> Ax = (A + B) * (x + y);
+	vector<Scalar> Lx = (lazy(A) + B) * (lazy(x) + y);
+	vector<Scalar> Axref = { 21, 21 };
+	if (C != Cref || L != Cref || D != A || Ax != Axref || Lx != Axref) {
+		if (reportTestCases) std::cerr << "matrix expressions evaluate to\n" << C << L << D << "and " << Ax << " " << Lx << '\n';
+		++nrOfFailedTestCases;
+	}
+	bool caught = false;
+	try {
+		matrix<Scalar> E = lazy(A) + matrix<Scalar>(3, 2);
+	}
+	catch (const matmul_incompatible_matrices&) {
+		caught = true;
+	}
+	if (!caught) {
+		if (reportTestCases) std::cerr << "the sum of incompatible matrices did not throw\n";
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "blas expression templates";
+	std::string test_tag    = "expression templates";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyVectorExpressions<double>(reportTestCases), "double", "vector expressions");
+	nrOfFailedTestCases += ReportTestResult(VerifyVectorExpressions<posit<32, 2>>(reportTestCases), "posit<32,2>", "vector expressions");
+	nrOfFailedTestCases += ReportTestResult(VerifyVectorExpressions<cfloat<32, 8, uint32_t, true, false, false>>(reportTestCases), "cfloat<32,8>", "vector expressions");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyNoTemporaries(reportTestCases), "counted", "no temporaries");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyExpressionLifetime<double>(reportTestCases), "double", "expression lifetime");
+	nrOfFailedTestCases += ReportTestResult(VerifyExpressionLifetime<posit<32, 2>>(reportTestCases), "posit<32,2>", "expression lifetime");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyMatrixExpressions<double>(reportTestCases), "double", "matrix expressions");
+	nrOfFailedTestCases += ReportTestResult(VerifyMatrixExpressions<posit<32, 2>>(reportTestCases), "posit<32,2>", "matrix expressions");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,232 @@
+// householder_qr.cpp: test of the in-place, blocked Householder QR factorizations and the least squares solver
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// the largest element of | Q R - A P |, and of | Q' Q - I |, relative to the largest element of A
+template<typename Scalar>
+double FactorizationError(const sw::universal::blas::matrix<Scalar>& A, const sw::universal::blas::matrix<Scalar>& Q, const sw::universal::blas::matrix<Scalar>& R, const std::vector<size_t>& perm) {
+	using namespace sw::universal::blas;
+	const size_t m = num_rows(A), n = num_cols(A), k = num_cols(Q);
+	double amax = 0.0, error = 0.0;
+	for (size_t i = 0; i < m; ++i) {
+		for (size_t j = 0; j < n; ++j) {
+			amax = std::max(amax, std::fabs(double(A(i, j))));
+			if (i > j && i < num_rows(R) && R(i, j) != Scalar(0)) return 1.0;  // R is not upper triangular
+			double qr = 0.0;
+			for (size_t p = 0; p < std::min(k, j + 1); ++p) qr += double(Q(i, p)) * double(R(p, j));
+			error = std::max(error, std::fabs(qr - double(A(i, perm[j]))));
+		}
+	}
+	error /= amax;
+	for (size_t p = 0; p < k; ++p) {
+		for (size_t q = 0; q < k; ++q) {
+			double qtq = 0.0;
+			for (size_t i = 0; i < m; ++i) qtq += double(Q(i, p)) * double(Q(i, q));
+			error = std::max(error, std::fabs(qtq - (p == q ? 1.0 : 0.0)));
+		}
+	}
+	return error;
+}
+
+// the blocked factorization is a QR factorization for all block sizes, and the same for all thread counts
+template<typename Scalar>
+int VerifyBlockedQR(unsigned m, unsigned n, double tolerance, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTests = 0;
+	matrix<Scalar> A(m, n);
+	uniform_random(A, -1.0, 1.0, random_stream(m * 1000 + n));
+	std::vector<size_t> identity(n);
+	for (size_t j = 0; j < n; ++j) identity[j] = j;
+	qr_workspace<Scalar> ws;
+	for (unsigned blockSize : { 1u, 5u, 16u, 64u }) {
+		matrix<Scalar> QR(A), QR3(A), Q(m, std::min(m, n));
+		vector<Scalar> tau, tau3;
+		householder_qr(QR, tau, ws, blockSize, 1);
+		householder_qr(QR3, tau3, ws, blockSize, 3);
+		if (!(QR == QR3)) {
+			if (reportTestCases) std::cerr << "FAIL: factors depend on the number of threads, block size " << blockSize << '\n';
+			++nrOfFailedTests;
+		}
+		householder_q(QR, tau, Q, ws, blockSize, 2);
+		matrix<Scalar> R(std::min(m, n), n);
+		for (size_t i = 0; i < num_rows(R); ++i) for (size_t j = i; j < n; ++j) R(i, j) = QR(i, j);
+		double error = FactorizationError(A, Q, R, identity);
+		if (error > tolerance) {
+			if (reportTestCases) std::cerr << "FAIL: " << m << 'x' << n << " block size " << blockSize << " error " << error << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the qr() entry points: Householder, Givens, and Householder with column pivoting
+template<typename Scalar>
+int VerifyQRMethods(double tolerance, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr unsigned m = 23, n = 9;
+	int nrOfFailedTests = 0;
+	matrix<Scalar> A(m, n);
+	uniform_random(A, -1.0, 1.0, random_stream(7));
+	// a column that is a multiple of another makes the pivoting matter
+	for (unsigned i = 0; i < m; ++i) A(i, 4) = A(i, 1) * Scalar(0.5);
+	std::vector<size_t> identity(n);
+	for (size_t j = 0; j < n; ++j) identity[j] = j;
+	for (size_t which : { size_t(1), size_t(3) }) {
+		auto [Q, R] = qr(A, which);
+		double error = FactorizationError(A, Q, R, identity);
+		if (error > tolerance) {
+			if (reportTestCases) std::cerr << "FAIL: qr method " << which << " error " << error << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	matrix<Scalar> Q(m, m), R, P(m, 2);
+	houseqrpivot(A, Q, R, P);
+	std::vector<size_t> perm(n);
+	for (size_t j = 0; j < n; ++j) perm[j] = size_t(double(P(j, 1)));
+	double error = FactorizationError(A, Q, R, perm);
+	if (error > tolerance) {
+		if (reportTestCases) std::cerr << "FAIL: pivoted qr error " << error << '\n';
+		++nrOfFailedTests;
+	}
+	// the diagonal of R decreases in magnitude, and the rank deficiency shows in the last element
+	for (size_t j = 1; j < n; ++j) {
+		if (std::fabs(double(R(j, j))) > std::fabs(double(R(j - 1, j - 1))) * (1.0 + tolerance)) ++nrOfFailedTests;
+	}
+	if (std::fabs(double(R(n - 1, n - 1))) > tolerance * std::fabs(double(R(0, 0)))) ++nrOfFailedTests;
+	return nrOfFailedTests;
+}
+
+// least squares fit of a consistent system, and the error returns
+template<typename Scalar>
+int VerifyLeastSquares(unsigned m, unsigned n, double tolerance, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTests = 0;
+	matrix<Scalar> A(m, n);
+	uniform_random(A, -1.0, 1.0, random_stream(m + n));
+	vector<Scalar> xtrue(n), b(m), x;
+	for (unsigned j = 0; j < n; ++j) xtrue[j] = Scalar(double(int(j % 5) - 2) / 4.0);
+	for (unsigned i = 0; i < m; ++i) {
+		Scalar sum(0);
+		for (unsigned j = 0; j < n; ++j) sum += A(i, j) * xtrue[j];
+		b[i] = sum;
+	}
+	x = lsq(A, b, 16, 2);
+	for (unsigned j = 0; j < n; ++j) {
+		if (std::fabs(double(x[j]) - double(xtrue[j])) > tolerance) {
+			if (reportTestCases) std::cerr << "FAIL: x[" << j << "] = " << x[j] << " != " << xtrue[j] << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	// the in-place solver reuses its workspace
+	qr_workspace<Scalar> ws;
+	matrix<Scalar> QR(A);
+	vector<Scalar> y(b), z;
+	if (lsq(QR, y, z, ws, 16, 1) != 0 || !(z == x)) ++nrOfFailedTests;
+
+	matrix<Scalar> wide(n, m);
+	vector<Scalar> c(n);
+	std::cerr.setstate(std::ios_base::failbit);  // silence the diagnostic of the underdetermined system
+	int status = lsq(wide, c, z, ws);
+	std::cerr.clear();
+	if (status != 1) ++nrOfFailedTests;
+	matrix<Scalar> deficient(m, n);  // zero
+	y = b;
+	if (lsq(deficient, y, z, ws) != 2) ++nrOfFailedTests;
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "blocked Householder QR";
+	std::string test_tag    = "householder qr";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	matrix<double> A = {
+		{ 1, -2, -1 },
+		{ 2,  0,  1 },
+		{ 2, -4,  2 },
+		{ 4,  0,  0 }
+	};
+	auto [Q, R] = qr(A);
+	std::cout << "Q\n" << Q << "R\n" << R << "QR\n" << Q * R << '\n';
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedQR<double>(40, 40, 1.0e-13, reportTestCases), "double", "square blocked qr");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedQR<double>(150, 37, 1.0e-13, reportTestCases), "double", "tall blocked qr");
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedQR<double>(20, 45, 1.0e-13, reportTestCases), "double", "wide blocked qr");
+	nrOfFailedTestCases += ReportTestResult(VerifyQRMethods<double>(1.0e-12, reportTestCases), "double", "qr methods");
+	nrOfFailedTestCases += ReportTestResult(VerifyLeastSquares<double>(500, 20, 1.0e-12, reportTestCases), "double", "least squares");
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockedQR<posit<32, 2>>(60, 24, 1.0e-6, reportTestCases), "posit<32,2>", "tall blocked qr");
+	nrOfFailedTestCases += ReportTestResult(VerifyLeastSquares<posit<32, 2>>(200, 10, 1.0e-6, reportTestCases), "posit<32,2>", "least squares");
+	nrOfFailedTestCases += ReportTestResult(VerifyLeastSquares<float>(2000, 30, 1.0e-4, reportTestCases), "float", "least squares");
+#endif
+
+#if REGRESSION_LEVEL_3
+
+#endif
+
+#if REGRESSION_LEVEL_4
+
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
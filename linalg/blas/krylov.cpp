@@ -0,0 +1,177 @@
+// krylov.cpp: test of the preconditioned Krylov solvers PCG, BiCGSTAB, and GMRES(m)
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/solvers/krylov.hpp>
+#include <universal/blas/matrices/saylr1.hpp>
+#include <universal/blas/matrices/west0132.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+// check the convergence status and the error of the solution x = 1
+template<typename Scalar>
+int VerifyKrylovSolution(const char* solver, const sw::universal::blas::krylov_report& report, const sw::universal::blas::vector<Scalar>& x, int expectedStatus, double tolerance, bool reportTestCases) {
+	if (report.status != expectedStatus) {
+		if (reportTestCases) std::cerr << solver << " status " << report.status << " after " << report.iterations << " iterations (residual " << report.residual << "), expected " << expectedStatus << '\n';
+		return 1;
+	}
+	if (expectedStatus != 0) return 0;
+	double error = 0.0;
+	for (size_t i = 0; i < size(x); ++i) {
+		double e = std::fabs(double(x[i]) - 1.0);
+		if (!(e <= error)) error = e;
+	}
+	if (error > tolerance) {
+		if (reportTestCases) std::cerr << solver << " error " << error << " exceeds " << tolerance << " (" << report.iterations << " iterations, residual " << report.residual << ")\n";
+		return 1;
+	}
+	return 0;
+}
+
+// b = A x for x = 1
+template<typename Operator, typename Scalar>
+sw::universal::blas::vector<Scalar> RightHandSide(const Operator& A) {
+	sw::universal::blas::vector<Scalar> one(A.size()), b(A.size());
+	one = Scalar(1);
+	A.apply(one, b);
+	return b;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "preconditioned Krylov solvers";
+	std::string test_tag    = "krylov";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	krylov_configuration cfg;
+
+	// PCG on the 2D Laplacian, with the same workspace for both solves
+	{
+		matrix<double> A;
+		laplace2D(A, 16, 16);
+		sparse_operator<double> op(A);
+		vector<double> b = RightHandSide<sparse_operator<double>, double>(op);
+		pcg_workspace<double> ws;
+		vector<double> x(size(b));
+		krylov_report report = pcg(op, jacobi_preconditioner<double>(A), b, x, ws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("pcg", report, x, 0, 1.0e-6, reportTestCases), "double", "pcg jacobi laplace2D");
+		x = 0.0;
+		report = pcg(op, ilu0_preconditioner<double>(op), b, x, ws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("pcg", report, x, 0, 1.0e-6, reportTestCases), "double", "pcg ilu0 laplace2D");
+	}
+
+	// matrix-free 1D Poisson operator
+	{
+		constexpr size_t N = 64;
+		auto op = make_operator<double>(N, [](const vector<double>& x, vector<double>& y) {
+			for (size_t i = 0; i < N; ++i) {
+				y[i] = 2.0 * x[i];
+				if (i > 0) y[i] -= x[i - 1];
+				if (i < N - 1) y[i] -= x[i + 1];
+			}
+		});
+		vector<double> b = RightHandSide<decltype(op), double>(op);
+		pcg_workspace<double> pcgws;
+		gmres_workspace<double> gmresws;
+		vector<double> x(N);
+		krylov_report report = pcg(op, identity_preconditioner<double>(), b, x, pcgws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("pcg", report, x, 0, 1.0e-6, reportTestCases), "double", "pcg matrix-free");
+		x = 0.0;
+		krylov_configuration full = cfg;
+		full.restart = N;
+		report = gmres(op, identity_preconditioner<double>(), b, x, gmresws, full);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("gmres", report, x, 0, 1.0e-6, reportTestCases), "double", "gmres matrix-free");
+	}
+
+	// nonsymmetric systems: saylr1 needs the ILU(0) preconditioner
+	{
+		sparse_operator<double> op(saylr1);
+		ilu0_preconditioner<double> ilu(op);
+		vector<double> b = RightHandSide<sparse_operator<double>, double>(op);
+		bicgstab_workspace<double> bicgws;
+		gmres_workspace<double> gmresws;
+		vector<double> x(size(b));
+		krylov_report report = bicgstab(op, ilu, b, x, bicgws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("bicgstab", report, x, 0, 1.0e-4, reportTestCases), "double", "bicgstab ilu0 saylr1");
+		x = 0.0;
+		report = gmres(op, ilu, b, x, gmresws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("gmres", report, x, 0, 1.0e-4, reportTestCases), "double", "gmres ilu0 saylr1");
+		x = 0.0;
+		report = gmres<compensated_dot>(op, ilu, b, x, gmresws, cfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("gmres", report, x, 0, 1.0e-4, reportTestCases), "double", "gmres ilu0 saylr1 compensated dot");
+	}
+	// west0132 has structurally zero diagonals: ILU(0) is computed on the permuted system P A x = P b,
+	// and the condition number of 4.2e11 asks for a small residual to get a small error
+	{
+		krylov_configuration tight = cfg;
+		tight.tolerance = 1.0e-13;
+		std::vector<size_t> perm = zero_free_diagonal(west0132);
+		const size_t N = num_rows(west0132);
+		matrix<double> PA(N, N);
+		for (size_t i = 0; i < N; ++i) {
+			for (size_t j = 0; j < N; ++j) PA(i, j) = west0132(perm[i], j);
+		}
+		sparse_operator<double> op(PA);
+		ilu0_preconditioner<double> ilu(op);
+		vector<double> b = RightHandSide<sparse_operator<double>, double>(op);
+		gmres_workspace<double> gmresws;
+		bicgstab_workspace<double> bicgws;
+		vector<double> x(N);
+		krylov_report report = gmres(op, ilu, b, x, gmresws, tight);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("gmres", report, x, 0, 1.0e-2, reportTestCases), "double", "gmres ilu0 west0132");
+		x = 0.0;
+		report = bicgstab(op, ilu, b, x, bicgws, tight);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("bicgstab", report, x, 0, 1.0e-2, reportTestCases), "double", "bicgstab ilu0 west0132");
+	}
+
+	// posits with a fused dot product
+	{
+		using Scalar = posit<32, 2>;
+		matrix<Scalar> A;
+		laplace2D(A, 8, 8);
+		dense_operator<Scalar> op(A);
+		vector<Scalar> b = RightHandSide<dense_operator<Scalar>, Scalar>(op);
+		pcg_workspace<Scalar> ws;
+		vector<Scalar> x(size(b));
+		krylov_configuration pcfg;
+		pcfg.tolerance = 1.0e-6;
+		krylov_report report = pcg<fused_dot>(op, jacobi_preconditioner<Scalar>(A), b, x, ws, pcfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("pcg", report, x, 0, 1.0e-5, reportTestCases), "posit<32,2>", "pcg jacobi fused dot");
+		x = Scalar(0);
+		bicgstab_workspace<Scalar> bicgws;
+		report = bicgstab<fused_dot>(op, ilu0_preconditioner<Scalar>(A), b, x, bicgws, pcfg);
+		nrOfFailedTestCases += ReportTestResult(VerifyKrylovSolution("bicgstab", report, x, 0, 1.0e-5, reportTestCases), "posit<32,2>", "bicgstab ilu0 fused dot");
+	}
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
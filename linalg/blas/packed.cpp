@@ -0,0 +1,276 @@
+// packed.cpp: test of the packed storage of vectors and matrices of 2 to 16-bit number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/packed.hpp>
+#include <universal/blas/quantization.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// a scrambled sequence of all the encodings of the Scalar
+template<typename Scalar>
+uint64_t TestEncoding(size_t i) {
+	return (i * 37 + 5) & ((uint64_t(1) << Scalar::nbits) - 1);
+}
+
+// the proxies store the encodings in the packed bit layout, and the bulk kernels agree with the proxies
+template<typename Scalar>
+int VerifyPackedVector(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr unsigned nbits = Scalar::nbits;
+	constexpr size_t N = 1000;
+	int nrOfFailedTests = 0;
+
+	packed_vector<Scalar> v(N);
+	if (v.storage() != (N * nbits + 63) / 64 * 8) ++nrOfFailedTests;
+	for (size_t i = 0; i < N; ++i) {
+		Scalar s;
+		s.setbits(TestEncoding<Scalar>(i));
+		v[i] = s;
+	}
+	// the reference layout: a bit stream, least significant bit first
+	std::vector<uint8_t> reference((N * nbits + 7) / 8, 0);
+	for (size_t i = 0; i < N; ++i) {
+		for (unsigned b = 0; b < nbits; ++b) {
+			size_t p = i * nbits + b;
+			if ((TestEncoding<Scalar>(i) >> b) & 1) reference[p / 8] |= uint8_t(1u << (p % 8));
+		}
+	}
+	if (v.bytes() != reference) {
+		if (reportTestCases) std::cerr << "FAIL: packed layout of " << sw::universal::type_tag(Scalar()) << '\n';
+		++nrOfFailedTests;
+	}
+	packed_vector<Scalar> w(reference.data(), N);
+	for (size_t i = 0; i < N; ++i) {
+		if (v.encoding(i) != TestEncoding<Scalar>(i) || w.encoding(i) != TestEncoding<Scalar>(i)) {
+			if (reportTestCases) std::cerr << "FAIL: encoding " << i << " : " << v.encoding(i) << " != " << TestEncoding<Scalar>(i) << '\n';
+			++nrOfFailedTests;
+		}
+	}
+
+	// unpack and pack runs at all the bit offsets, the neighbours of the run are unchanged
+	std::vector<Scalar> registers(N);
+	for (size_t first : { size_t(0), size_t(1), size_t(7), size_t(63), size_t(64), size_t(65), size_t(333) }) {
+		for (size_t n : { size_t(1), size_t(2), size_t(9), size_t(64), size_t(129), size_t(600) }) {
+			if (first + n > N) continue;
+			v.unpack(first, n, registers.data());
+			for (size_t i = 0; i < n; ++i) {
+				Scalar s = v[first + i];
+				if (!(registers[i] == s) && !(registers[i] != registers[i])) ++nrOfFailedTests;
+			}
+			// pack the run reversed, then restore it
+			std::vector<Scalar> reversed(registers.rbegin() + long(N - n), registers.rend());
+			v.pack(reversed.data(), n, first);
+			for (size_t i = 0; i < N; ++i) {
+				size_t source = (i >= first && i < first + n) ? first + (first + n - 1 - i) : i;
+				if (v.encoding(i) != TestEncoding<Scalar>(source)) {
+					if (reportTestCases) std::cerr << "FAIL: pack [" << first << ',' << first + n << ") element " << i << '\n';
+					++nrOfFailedTests;
+					break;
+				}
+			}
+			v.pack(registers.data(), n, first);
+			if (v.bytes() != reference) ++nrOfFailedTests;
+		}
+	}
+
+	// resize keeps the elements and zeroes the new ones
+	v.resize(N / 2 + 3);
+	v.resize(N);
+	for (size_t i = 0; i < N; ++i) {
+		uint64_t expected = (i < N / 2 + 3) ? TestEncoding<Scalar>(i) : sw::universal::blas::packed_detail::encoding(Scalar(0));
+		if (v.encoding(i) != expected) { ++nrOfFailedTests; break; }
+	}
+	return nrOfFailedTests;
+}
+
+// the arithmetic on the unpacked registers is the arithmetic of the number system, in the order of the elements
+template<typename Scalar>
+int VerifyPackedArithmetic(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr unsigned M = 37, N = 600;
+	int nrOfFailedTests = 0;
+	vector<Scalar> x(N), y(N);
+	matrix<Scalar> A(M, N);
+	for (unsigned j = 0; j < N; ++j) {
+		x[j] = Scalar(double(int(j % 7) - 3) / 4.0);
+		y[j] = Scalar(double(int(j % 5) - 2) / 2.0);
+		for (unsigned i = 0; i < M; ++i) A(i, j) = Scalar(double(int((i + 3 * j) % 9) - 4) / 8.0);
+	}
+	packed_vector<Scalar> px(x), py(y);
+	packed_matrix<Scalar> pA(A);
+
+	Scalar sum(0);
+	for (unsigned j = 0; j < N; ++j) sum += x[j] * y[j];
+	if (!(dot(px, py) == sum)) {
+		if (reportTestCases) std::cerr << "FAIL: dot " << dot(px, py) << " != " << sum << '\n';
+		++nrOfFailedTests;
+	}
+
+	Scalar a(0.5);
+	axpy(a, px, py);
+	for (unsigned j = 0; j < N; ++j) {
+		Scalar ref = y[j];
+		ref += a * x[j];
+		if (py[j] != ref) { ++nrOfFailedTests; break; }
+	}
+	scale(a, px);
+	for (unsigned j = 0; j < N; ++j) {
+		Scalar ref = x[j];
+		ref *= a;
+		if (px[j] != ref) { ++nrOfFailedTests; break; }
+	}
+
+	if (!(pA.unpacked() == A)) ++nrOfFailedTests;
+	vector<Scalar> b = pA * x;
+	for (unsigned i = 0; i < M; ++i) {
+		Scalar ref(0);
+		for (unsigned j = 0; j < N; ++j) ref += A(i, j) * x[j];
+		if (b[i] != ref) {
+			if (reportTestCases) std::cerr << "FAIL: row " << i << " of A x " << b[i] << " != " << ref << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	pA(3, 5) = Scalar(1);
+	pA(3, 5) += Scalar(1);
+	if (pA(3, 5) != Scalar(2) || pA(3, 4) != A(3, 4) || pA(3, 6) != A(3, 6)) ++nrOfFailedTests;
+
+	// operands of different size are an error, as in the dense kernels
+	packed_vector<Scalar> shorter(N - 1);
+	vector<Scalar> xshort(N - 1);
+	int nrOfThrows = 0;
+	try { dot(px, shorter); } catch (const matmul_incompatible_matrices&) { ++nrOfThrows; }
+	try { axpy(a, px, shorter); } catch (const matmul_incompatible_matrices&) { ++nrOfThrows; }
+	try { b = pA * xshort; } catch (const matmul_incompatible_matrices&) { ++nrOfThrows; }
+	if (nrOfThrows != 3) {
+		if (reportTestCases) std::cerr << "FAIL: " << 3 - nrOfThrows << " size mismatches were not detected\n";
+		++nrOfFailedTests;
+	}
+	return nrOfFailedTests;
+}
+
+// the output of the quantizer loads into a packed vector
+template<typename Target>
+int VerifyQuantizedLoad(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr size_t N = 999;
+	vector<double> data(N);
+	for (size_t i = 0; i < N; ++i) data[i] = std::sin(double(i)) * 3.0;
+	quantization_scale q = quantization_parameters<Target>(data);
+	std::vector<uint8_t> bytes = quantize_packed<Target>(data, q);
+	vector<Target> values = quantize<Target>(data, q);
+	packed_vector<Target> pv(bytes.data(), N);
+	int nrOfFailedTests = 0;
+	for (size_t i = 0; i < N; ++i) {
+		if (pv[i] != values[i]) {
+			if (reportTestCases) std::cerr << "FAIL: element " << i << " : " << pv[i] << " != " << values[i] << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	if (pv.bytes() != bytes || !(packed_vector<Target>(values).bytes() == bytes)) ++nrOfFailedTests;
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "packed storage";
+	std::string test_tag    = "packed";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	packed_vector<posit<4, 0>> v = { 0.25f, 0.5f, 1.0f, 2.0f, -1.0f };
+	std::cout << v << " in " << v.storage() << " bytes\n";
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<posit<2, 0>>(reportTestCases), "posit<2,0>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<posit<4, 0>>(reportTestCases), "posit<4,0>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<posit<7, 1>>(reportTestCases), "posit<7,1>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<cfloat<6, 2, uint8_t, true, true, false>>(reportTestCases), "cfloat<6,2>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<lns<5, 2>>(reportTestCases), "lns<5,2>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<fixpnt<3, 1>>(reportTestCases), "fixpnt<3,1>", "packed vector");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedVector<posit<16, 1>>(reportTestCases), "posit<16,1>", "packed vector");
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedArithmetic<posit<6, 1>>(reportTestCases), "posit<6,1>", "packed arithmetic");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedArithmetic<cfloat<7, 3, uint8_t, true, true, false>>(reportTestCases), "cfloat<7,3>", "packed arithmetic");
+	nrOfFailedTestCases += ReportTestResult(VerifyPackedArithmetic<fixpnt<7, 3, Saturate>>(reportTestCases), "fixpnt<7,3>", "packed arithmetic");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyQuantizedLoad<posit<4, 0>>(reportTestCases), "posit<4,0>", "quantized load");
+	nrOfFailedTestCases += ReportTestResult(VerifyQuantizedLoad<cfloat<6, 2, uint8_t, true, true, false>>(reportTestCases), "cfloat<6,2>", "quantized load");
+
+	// the footprint of a million 4-bit elements
+	{
+		constexpr size_t N = 1024 * 1024;
+		packed_vector<posit<4, 0>> v(N);
+		int nrOfFailedTests = (v.storage() == N / 2) ? 0 : 1;
+		if (reportTestCases) std::cout << "posit<4,0> x " << N << " : " << v.storage() << " bytes packed, " << N * sizeof(posit<4, 0>) << " bytes unpacked\n";
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "posit<4,0>", "packed footprint");
+	}
+#endif
+
+#if REGRESSION_LEVEL_3
+
+#endif
+
+#if REGRESSION_LEVEL_4
+
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,237 @@
+// random_stream.cpp: test of the counter-based random streams and the parallel random fills
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/statistics.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// the known answers of Philox4x32-10 of the Random123 distribution
+int VerifyPhilox(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	struct kat { philox4x32::counter_type counter; philox4x32::key_type key; philox4x32::counter_type result; };
+	const kat vectors[] = {
+		{ { 0, 0, 0, 0 }, { 0, 0 }, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+		{ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+		{ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+	};
+	int nrOfFailedTests = 0;
+	for (const kat& v : vectors) {
+		if (philox4x32(v.key)(v.counter) != v.result) {
+			if (reportTestCases) std::cerr << "FAIL: philox4x32 known answer " << std::hex << v.result[0] << std::dec << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the fills do not depend on the number of threads
+template<typename Scalar>
+int VerifyThreadIndependence(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	random_stream rng(0x5eed, 7);
+	int nrOfFailedTests = 0;
+	constexpr size_t N = 10000;
+	vector<Scalar> u1(N), u4(N), g1(N), g3(N);
+	uniform_random(u1, -1.0, 1.0, rng, 1);
+	uniform_random(u4, -1.0, 1.0, rng, 4);
+	gaussian_random(g1, 0.0, 1.0, rng, 1);
+	gaussian_random(g3, 0.0, 1.0, rng, 3);
+	for (size_t i = 0; i < N; ++i) {
+		if (u1[i] != u4[i] || g1[i] != g3[i] || g1[i] != Scalar(rng.normal(i))) {
+			if (reportTestCases) std::cerr << "FAIL: element " << i << " depends on the number of threads\n";
+			++nrOfFailedTests;
+			break;
+		}
+	}
+	// element (i, j) of a matrix is element i * cols + j of the stream
+	matrix<Scalar> A(37, 101), B(37, 101);
+	gaussian_random(A, 0.0, 1.0, rng, 1);
+	gaussian_random(B, 0.0, 1.0, rng, 0);
+	vector<Scalar> flat(37 * 101);
+	gaussian_random(flat, 0.0, 1.0, rng);
+	for (unsigned i = 0; i < 37; ++i) {
+		for (unsigned j = 0; j < 101; ++j) {
+			if (A(i, j) != B(i, j) || A(i, j) != flat[i * 101 + j]) ++nrOfFailedTests;
+		}
+	}
+	// a different stream, or seed, is a different sequence
+	vector<Scalar> other(N);
+	uniform_random(other, -1.0, 1.0, random_stream(0x5eed, 8));
+	size_t equal = 0;
+	for (size_t i = 0; i < N; ++i) if (other[i] == u1[i]) ++equal;
+	if (equal > N / 100) ++nrOfFailedTests;
+	return nrOfFailedTests;
+}
+
+// the moments of the uniform and gaussian samples
+int VerifyDistributions(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr size_t N = 1000000;
+	random_stream rng(2023);
+	int nrOfFailedTests = 0;
+	streaming_statistics<double> uniform, normal;
+	for (size_t i = 0; i < N; ++i) {
+		uniform.push(rng.uniform(i));
+		normal.push(rng.normal(i));
+	}
+	// five standard errors of the mean and of the variance
+	if (std::fabs(uniform.mean() - 0.5) > 5.0 * std::sqrt(1.0 / 12.0 / N) || std::fabs(uniform.variance() - 1.0 / 12.0) > 5.0 * std::sqrt(1.0 / 180.0 / N)) {
+		if (reportTestCases) std::cerr << "FAIL: uniform mean " << uniform.mean() << " variance " << uniform.variance() << '\n';
+		++nrOfFailedTests;
+	}
+	if (uniform.min() < 0.0 || uniform.max() >= 1.0) ++nrOfFailedTests;
+	if (std::fabs(normal.mean()) > 5.0 / std::sqrt(double(N)) || std::fabs(normal.variance() - 1.0) > 5.0 * std::sqrt(2.0 / N)) {
+		if (reportTestCases) std::cerr << "FAIL: normal mean " << normal.mean() << " variance " << normal.variance() << '\n';
+		++nrOfFailedTests;
+	}
+	// elements 2k and 2k + 1 are the two halves of one Box-Muller transform: the cosine and the sine
+	// of the same angle, and uncorrelated
+	double sumOfProducts = 0.0;
+	for (size_t k = 0; k < N / 2; ++k) {
+		auto z = rng.normal_pair(k);
+		if (z.first != rng.normal(2 * k) || z.second != rng.normal(2 * k + 1)) {
+			++nrOfFailedTests;
+			break;
+		}
+		sumOfProducts += z.first * z.second;
+	}
+	if (std::fabs(sumOfProducts / double(N / 2)) > 5.0 / std::sqrt(double(N / 2))) {
+		if (reportTestCases) std::cerr << "FAIL: correlation of the Box-Muller pairs " << sumOfProducts / double(N / 2) << '\n';
+		++nrOfFailedTests;
+	}
+	// the fraction of the normal samples within one standard deviation is erf(1/sqrt(2))
+	size_t within = 0;
+	for (size_t i = 0; i < N; ++i) if (std::fabs(rng.normal(i)) < 1.0) ++within;
+	if (std::fabs(double(within) / N - 0.682689492137) > 0.003) ++nrOfFailedTests;
+	return nrOfFailedTests;
+}
+
+// every encoding is equally likely, the finite draws exclude the encodings that are not finite
+template<typename Scalar>
+int VerifyRandomEncodings(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	constexpr size_t nrEncodings = size_t(1) << Scalar::nbits;
+	constexpr size_t samplesPerEncoding = 400;
+	constexpr size_t N = nrEncodings * samplesPerEncoding;
+	int nrOfFailedTests = 0;
+	random_stream rng(42);
+	vector<Scalar> v(N), w(N);
+	random_encodings(v, rng, false, 1);
+	random_encodings(w, rng, false, 3);
+	std::vector<size_t> histogram(nrEncodings, 0);
+	for (size_t i = 0; i < N; ++i) {
+		uint64_t e = rng.bits(i) & (nrEncodings - 1);
+		Scalar s;
+		s.setbits(e);
+		if (!(v[i] == s) && !(std::isnan(double(v[i])) && std::isnan(double(s)))) ++nrOfFailedTests;
+		if (!(v[i] == w[i]) && !(std::isnan(double(v[i])) && std::isnan(double(w[i])))) ++nrOfFailedTests;
+		++histogram[e];
+	}
+	// chi-square of the counts, with nrEncodings - 1 degrees of freedom: mean k, stddev sqrt(2k)
+	double chi2 = 0.0;
+	for (size_t c : histogram) chi2 += (double(c) - samplesPerEncoding) * (double(c) - samplesPerEncoding) / samplesPerEncoding;
+	double k = double(nrEncodings - 1);
+	if (chi2 > k + 5.0 * std::sqrt(2.0 * k)) {
+		if (reportTestCases) std::cerr << "FAIL: chi-square " << chi2 << " of " << nrEncodings << " encodings\n";
+		++nrOfFailedTests;
+	}
+
+	random_encodings(v, rng, true, 2);
+	for (size_t i = 0; i < N; ++i) {
+		if (!std::isfinite(double(v[i]))) {
+			if (reportTestCases) std::cerr << "FAIL: encoding that is not finite " << v[i] << '\n';
+			++nrOfFailedTests;
+			break;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "counter-based random streams";
+	std::string test_tag    = "random streams";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	vector<posit<8, 0>> v(16);
+	random_encodings(v, random_stream(1), true);
+	std::cout << v << '\n';
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyPhilox(reportTestCases), "philox4x32", "known answers");
+	nrOfFailedTestCases += ReportTestResult(VerifyThreadIndependence<double>(reportTestCases), "double", "thread independence");
+	nrOfFailedTestCases += ReportTestResult(VerifyThreadIndependence<posit<16, 1>>(reportTestCases), "posit<16,1>", "thread independence");
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyDistributions(reportTestCases), "double", "uniform and normal moments");
+	nrOfFailedTestCases += ReportTestResult(VerifyRandomEncodings<posit<8, 0>>(reportTestCases), "posit<8,0>", "random encodings");
+	nrOfFailedTestCases += ReportTestResult(VerifyRandomEncodings<cfloat<8, 2, uint8_t, true, true, false>>(reportTestCases), "cfloat<8,2>", "random encodings");
+	nrOfFailedTestCases += ReportTestResult(VerifyRandomEncodings<posit<12, 1>>(reportTestCases), "posit<12,1>", "random encodings");
+#endif
+
+#if REGRESSION_LEVEL_3
+
+#endif
+
+#if REGRESSION_LEVEL_4
+
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,201 @@
+// reductions.cpp: test of the reduction policies of the blas reductions
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+// sum of N copies of 0.1: recursive summation loses about log2(N) bits, pairwise summation a few,
+// and compensated summation none, as long as N times the unit roundoff is small
+template<typename Scalar>
+int VerifySumAccuracy(size_t N, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	vector<Scalar> x(N);
+	x = Scalar(0.1);
+	double exact = double(N) * double(Scalar(0.1));
+	double ulp = double(std::numeric_limits<Scalar>::epsilon()) * exact;
+	double naive = std::fabs(double(sum<naive_reduction>(x)) - exact);
+	double pairwise = std::fabs(double(sum<pairwise_reduction>(x)) - exact);
+	double neumaier = std::fabs(double(sum<neumaier_reduction>(x)) - exact);
+	double dot2 = std::fabs(double(sum<dot2_reduction>(x)) - exact);
+	if (naive < 16.0 * ulp) {
+		if (reportTestCases) std::cerr << "recursive summation error " << naive << " is unexpectedly small\n";
+		++nrOfFailedTestCases;
+	}
+	if (pairwise > 8.0 * ulp) {
+		if (reportTestCases) std::cerr << "pairwise summation error " << pairwise << " exceeds " << 8.0 * ulp << '\n';
+		++nrOfFailedTestCases;
+	}
+	if (neumaier > ulp || dot2 > ulp) {
+		if (reportTestCases) std::cerr << "compensated summation error " << neumaier << " and " << dot2 << " exceed " << ulp << '\n';
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+// x = [1 + e, -1, ...], y = [1 - e, 1, ...]: every pair contributes -e^2, which a rounded product loses,
+// unless the compiler contracts the multiply-add of the naive policy into an fma
+template<typename Scalar>
+int VerifyDotAccuracy(size_t pairs, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	constexpr int halfDigits = std::numeric_limits<Scalar>::digits / 2 + 1;
+	Scalar e = Scalar(std::ldexp(1.0, -halfDigits));
+	vector<Scalar> x(2 * pairs), y(2 * pairs);
+	for (size_t i = 0; i < pairs; ++i) {
+		x[2 * i] = Scalar(1) + e;   y[2 * i] = Scalar(1) - e;
+		x[2 * i + 1] = Scalar(-1);  y[2 * i + 1] = Scalar(1);
+	}
+	double exact = -double(pairs) * double(e) * double(e);
+	double dot2 = double(dot<dot2_reduction>(x, y));
+	double quire = double(dot<quire_reduction>(x, y));
+	if (dot2 != exact || quire != exact) {
+		if (reportTestCases) std::cerr << "dot2 " << dot2 << " and quire " << quire << " differ from " << exact << '\n';
+		++nrOfFailedTestCases;
+	}
+	return nrOfFailedTestCases;
+}
+
+// the policies agree on a well-conditioned problem, for the strided and the matrix reductions as well
+template<typename Scalar>
+int VerifyReductionInterfaces(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	constexpr size_t N = 301;  // not a multiple of the number of lanes or of the pairwise block
+	vector<Scalar> x(N), y(N);
+	for (size_t i = 0; i < N; ++i) {
+		x[i] = Scalar(double(i % 7) - 3.0);
+		y[i] = Scalar(double(i % 5) + 1.0);
+	}
+	double reference = 0.0, absSum = 0.0, stridedDot = 0.0;
+	for (size_t i = 0; i < N; ++i) {
+		reference += double(x[i]) * double(y[i]);
+		if (i % 3 == 0) { absSum += std::fabs(double(x[i])); stridedDot += double(x[i]) * double(y[i]); }
+	}
+	auto check = [&](const char* what, double result, double expected) {
+		if (result != expected) {
+			if (reportTestCases) std::cerr << what << ' ' << result << " != " << expected << '\n';
+			++nrOfFailedTestCases;
+		}
+	};
+	check("naive dot", double(dot<naive_reduction>(x, y)), reference);
+	check("unrolled dot", double(dot<unrolled_reduction>(x, y)), reference);
+	check("pairwise dot", double(dot<pairwise_reduction>(x, y)), reference);
+	check("neumaier dot", double(dot<neumaier_reduction>(x, y)), reference);
+	check("dot2 dot", double(dot<dot2_reduction>(x, y)), reference);
+	check("quire dot", double(dot<quire_reduction>(x, y)), reference);
+	check("strided dot", double(dot<dot2_reduction>(N, x, 3, y, 3)), stridedDot);
+	check("asum", double(asum<pairwise_reduction>(N, x, 3)), absSum);
+
+	vector<Scalar> z(N);
+	z = Scalar(2);
+	check("nrm2", double(nrm2<dot2_reduction>(N, z)), double(Scalar(std::sqrt(4.0 * N))));
+
+	matrix<Scalar> A(17, 23);
+	for (unsigned i = 0; i < 17; ++i) {
+		for (unsigned j = 0; j < 23; ++j) A(i, j) = Scalar(double(i) - double(j));
+	}
+	auto total = sumOfElements<neumaier_reduction>(A);
+	auto rowSums = sumOfElements<pairwise_reduction>(A, 1);
+	auto colSums = sumOfElements<quire_reduction>(A, 2);
+	check("sumOfElements", double(total[0]), 23.0 * 136.0 - 17.0 * 253.0);
+	check("row sum", double(rowSums[16]), 23.0 * 16.0 - 253.0);
+	check("column sum", double(colSums[22]), 136.0 - 17.0 * 22.0);
+	return nrOfFailedTestCases;
+}
+
+// the default policy rounds as the element-order loop does, and nrm2 neither overflows nor underflows
+template<typename Scalar>
+int VerifyDefaultReduction(bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTestCases = 0;
+	constexpr size_t N = 1001;
+	vector<Scalar> x(N), y(N);
+	Scalar loopSum(0), loopDot(0);
+	for (size_t i = 0; i < N; ++i) {
+		x[i] = Scalar(1.0 / double(i + 1));
+		y[i] = Scalar(double(i % 3) + 0.5);
+		loopSum += x[i];
+		loopDot += x[i] * y[i];
+	}
+	if (sum(x) != loopSum || dot(x, y) != loopDot) {
+		if (reportTestCases) std::cerr << "default reductions " << sum(x) << " and " << dot(x, y) << " differ from the loops " << loopSum << " and " << loopDot << '\n';
+		++nrOfFailedTestCases;
+	}
+	// the unrolled policy sums four interleaved lanes
+	Scalar lane[4] = { Scalar(0), Scalar(0), Scalar(0), Scalar(0) };
+	for (size_t i = 0; i < N; ++i) lane[(i < N - N % 4) ? i % 4 : 0] += x[i];
+	if (sum<unrolled_reduction>(x) != Scalar((lane[0] + lane[1]) + (lane[2] + lane[3]))) {
+		if (reportTestCases) std::cerr << "unrolled reduction " << sum<unrolled_reduction>(x) << " differs from its lanes\n";
+		++nrOfFailedTestCases;
+	}
+
+	constexpr int big = std::numeric_limits<Scalar>::max_exponent - 4;
+	constexpr int tiny = std::numeric_limits<Scalar>::min_exponent + 4;
+	for (int scale : { big, tiny }) {
+		vector<Scalar> v = { Scalar(std::ldexp(3.0, scale)), Scalar(std::ldexp(4.0, scale)) };
+		double expected = std::ldexp(5.0, scale);
+		if (double(nrm2(2, v)) != expected) {
+			if (reportTestCases) std::cerr << "nrm2 " << nrm2(2, v) << " != " << expected << '\n';
+			++nrOfFailedTestCases;
+		}
+	}
+	return nrOfFailedTestCases;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "blas reduction policies";
+	std::string test_tag    = "reductions";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	nrOfFailedTestCases += ReportTestResult(VerifySumAccuracy<float>(100000, reportTestCases), "float", "sum accuracy");
+	nrOfFailedTestCases += ReportTestResult(VerifySumAccuracy<double>(1000000, reportTestCases), "double", "sum accuracy");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyDotAccuracy<float>(1000, reportTestCases), "float", "dot accuracy");
+	nrOfFailedTestCases += ReportTestResult(VerifyDotAccuracy<double>(1000, reportTestCases), "double", "dot accuracy");
+	nrOfFailedTestCases += ReportTestResult(VerifyDotAccuracy<cfloat<32, 8, uint32_t, true, false, false>>(1000, reportTestCases), "cfloat<32,8>", "dot accuracy");
+	nrOfFailedTestCases += ReportTestResult(VerifyDotAccuracy<posit<32, 2>>(1000, reportTestCases), "posit<32,2>", "dot accuracy");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyDefaultReduction<float>(reportTestCases), "float", "default reduction");
+	nrOfFailedTestCases += ReportTestResult(VerifyDefaultReduction<double>(reportTestCases), "double", "default reduction");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyReductionInterfaces<float>(reportTestCases), "float", "reduction interfaces");
+	nrOfFailedTestCases += ReportTestResult(VerifyReductionInterfaces<double>(reportTestCases), "double", "reduction interfaces");
+	nrOfFailedTestCases += ReportTestResult(VerifyReductionInterfaces<cfloat<32, 8, uint32_t, true, false, false>>(reportTestCases), "cfloat<32,8>", "reduction interfaces");
+	nrOfFailedTestCases += ReportTestResult(VerifyReductionInterfaces<posit<32, 2>>(reportTestCases), "posit<32,2>", "reduction interfaces");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
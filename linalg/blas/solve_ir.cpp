@@ -0,0 +1,167 @@
+// solve_ir.cpp: test of the mixed-precision iterative refinement solvers
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/solvers/ir.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+// A = H1 diag(sigma) H2 with Householder reflections H1 and H2, and singular values
+// that are geometrically spaced from 1 down to 1/kappa
+sw::universal::blas::matrix<double> SystemWithConditionNumber(unsigned N, double kappa, unsigned seed) {
+	using namespace sw::universal::blas;
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	auto reflector = [&]() {
+		vector<double> v(N);
+		double vtv = 0.0;
+		for (unsigned i = 0; i < N; ++i) { v[i] = dist(engine); vtv += v[i] * v[i]; }
+		matrix<double> H(N, N);
+		for (unsigned i = 0; i < N; ++i) {
+			for (unsigned j = 0; j < N; ++j) H(i, j) = (i == j ? 1.0 : 0.0) - 2.0 * v[i] * v[j] / vtv;
+		}
+		return H;
+	};
+	matrix<double> H1 = reflector(), H2 = reflector(), A(N, N);
+	for (unsigned i = 0; i < N; ++i) {
+		for (unsigned j = 0; j < N; ++j) {
+			double sum = 0.0;
+			for (unsigned k = 0; k < N; ++k) {
+				double sigma = std::pow(kappa, -double(k) / double(N - 1));
+				sum += H1(i, k) * sigma * H2(k, j);
+			}
+			A(i, j) = sum;
+		}
+	}
+	return A;
+}
+
+// solve A x = b for x = 1 and check the convergence status, the backward error, and the error of the solution
+template<typename Low, typename Working, typename Residual>
+int VerifySolveIR(const sw::universal::blas::matrix<double>& Ad, const sw::universal::blas::ir_configuration& cfg, int expectedStatus, double tolerance, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	const size_t N = num_rows(Ad);
+	matrix<Working> A(Ad);
+	vector<Working> x(N);
+	x = Working(1);
+	vector<Residual> bh = matrix<Residual>(A) * vector<Residual>(x);
+	vector<Working> b(bh);
+
+	ir_report report;
+	vector<Working> xx = solve_ir<Low, Working, Residual>(A, b, cfg, &report);
+	if (report.status != expectedStatus) {
+		if (reportTestCases) std::cerr << "solve_ir status " << report.status << " after " << report.iterations << " iterations, expected " << expectedStatus << '\n';
+		return 1;
+	}
+	if (expectedStatus != 0) return 0;
+	// a converged solution meets the backward error tolerance, N u by default
+	double u = double(std::numeric_limits<Working>::epsilon()) / 2.0;
+	double backwardErrorTolerance = (cfg.tolerance > 0.0 ? cfg.tolerance : double(N) * u);
+	if (!(report.backwardError <= backwardErrorTolerance)) {
+		if (reportTestCases) std::cerr << "solve_ir backward error " << report.backwardError << " exceeds " << backwardErrorTolerance << '\n';
+		return 1;
+	}
+	double error = 0.0;
+	for (size_t i = 0; i < N; ++i) {
+		double e = std::fabs(double(xx[i]) - 1.0);
+		if (!(e <= error)) error = e;
+	}
+	if (error > tolerance) {
+		if (reportTestCases) std::cerr << "solve_ir error " << error << " exceeds " << tolerance << " (backward error " << report.backwardError << ", " << report.iterations << " iterations)\n";
+		return 1;
+	}
+	return 0;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "mixed-precision iterative refinement";
+	std::string test_tag    = "solve_ir";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	using fp16 = cfloat<16, 5, uint16_t, true, false, false>;
+	matrix<double> wellConditioned = SystemWithConditionNumber(40, 1.0e2, 1);
+	matrix<double> illConditioned = SystemWithConditionNumber(40, 1.0e5, 2);
+
+	ir_configuration lu;
+	ir_configuration gmres;
+	gmres.solver = RefinementSolver::GMRES;
+	ir_configuration scaled;
+	scaled.squeeze = SqueezeMethod::TwoSidedScaleRound;
+
+	// LU-IR converges when the condition number is below the inverse unit roundoff of Low,
+	// to a forward error of about kappa N u of Working
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<fp16, double, double>(wellConditioned, lu, 0, 1.0e-12, reportTestCases), "fp16/double", "LU-IR");
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<fp16, double, double>(wellConditioned, scaled, 0, 1.0e-12, reportTestCases), "fp16/double", "LU-IR two-sided squeeze");
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<float, double, double>(illConditioned, lu, 0, 1.0e-8, reportTestCases), "float/double", "LU-IR");
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<posit<16, 1>, posit<32, 2>, posit<32, 2>>(wellConditioned, lu, 0, 1.0e-5, reportTestCases), "posit<16,1>/posit<32,2>", "LU-IR fused residual");
+
+	// a looser tolerance stops the refinement earlier
+	{
+		ir_configuration loose;
+		loose.tolerance = 1.0e-8;
+		ir_report strict, relaxed;
+		matrix<double> A(wellConditioned);
+		vector<double> ones(num_cols(A));
+		ones = 1.0;
+		vector<double> b = A * ones;
+		solve_ir<fp16, double>(A, b, lu, &strict);
+		solve_ir<fp16, double>(A, b, loose, &relaxed);
+		int nrOfFailures = (relaxed.status != 0 || relaxed.iterations >= strict.iterations || relaxed.backwardError > loose.tolerance) ? 1 : 0;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailures, "fp16/double", "LU-IR configurable tolerance");
+
+		// a tolerance below the attainable backward error does not converge, even when the correction is negligible:
+		// x[1] = 1/49 rounded leaves a residual of about u, exact in long double, and a correction far below u |x|
+		ir_configuration unattainable;
+		unattainable.tolerance = 1.0e-30;
+		matrix<double> D = { { 1.0, 0.0 }, { 0.0, 49.0 } };
+		vector<double> d = { 1.0, 1.0 };
+		ir_report report;
+		solve_ir<double, double, long double>(D, d, unattainable, &report);
+		nrOfFailures = (report.status != 3 || !(report.backwardError > unattainable.tolerance) || report.iterations != 1) ? 1 : 0;
+		if (nrOfFailures && reportTestCases) std::cerr << "solve_ir status " << report.status << " with backward error " << report.backwardError << " after " << report.iterations << " iterations\n";
+		nrOfFailedTestCases += ReportTestResult(nrOfFailures, "double/double/long double", "LU-IR unattainable tolerance");
+	}
+
+	// an fp16 factorization of an ill-conditioned matrix needs GMRES-IR: LU-IR contracts too slowly
+	// to converge in 10 refinement steps, where GMRES-IR needs a single one
+	ir_configuration limited;
+	limited.maxIterations = 10;
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<fp16, double, double>(illConditioned, limited, 3, 0.0, reportTestCases), "fp16/double", "LU-IR does not converge");
+	gmres.maxIterations = limited.maxIterations;
+	nrOfFailedTestCases += ReportTestResult(VerifySolveIR<fp16, double, double>(illConditioned, gmres, 0, 1.0e-8, reportTestCases), "fp16/double", "GMRES-IR");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Uncaught quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,237 @@
+// stencil.cpp: test of the matrix-free stencil operators and the solvers on them
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/solvers/gauss_seidel.hpp>
+#include <universal/blas/solvers/sor.hpp>
+#include <universal/blas/solvers/cg.hpp>
+#include <universal/blas/solvers/krylov.hpp>
+#include <universal/blas/solvers/stencil.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+// compare the stencil operator with its dense matrix: the elements, and the products with an integer valued vector
+template<typename Scalar>
+int VerifyStencilOperator(const sw::universal::blas::stencil_operator<Scalar>& S, const sw::universal::blas::matrix<Scalar>& A, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTests = 0;
+	const size_t N = S.size();
+	if (num_rows(A) != N || num_cols(A) != N) return 1;
+	matrix<Scalar> B = S.to_matrix();
+	for (size_t i = 0; i < N; ++i) {
+		for (size_t j = 0; j < N; ++j) {
+			if (A(i, j) != B(i, j)) {
+				if (reportTestCases) std::cerr << "FAIL: element (" << i << ',' << j << ") " << B(i, j) << " != " << A(i, j) << '\n';
+				++nrOfFailedTests;
+			}
+		}
+	}
+	vector<Scalar> x(N), y(N), ref(N);
+	for (size_t i = 0; i < N; ++i) x[i] = Scalar(int((i * 7) % 11) - 5);
+	S.apply(x, y);
+	matvec(ref, A, x);
+	for (size_t i = 0; i < N; ++i) {
+		if (y[i] != ref[i]) {
+			if (reportTestCases) std::cerr << "FAIL: row " << i << " of A x " << y[i] << " != " << ref[i] << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the maximum error of the solution x = 1
+template<typename Scalar>
+double SolutionError(const sw::universal::blas::vector<Scalar>& x) {
+	double error = 0.0;
+	for (size_t i = 0; i < size(x); ++i) {
+		double e = std::fabs(double(x[i]) - 1.0);
+		if (!(e <= error)) error = e;
+	}
+	return error;
+}
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "matrix-free stencil operators";
+	std::string test_tag    = "stencil";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	// the stencil operators against their dense matrices, tiled and threaded
+	{
+		stencil_operator<double> S;
+		matrix<double> A;
+		laplace2D(S, 5, 7);
+		laplace2D(A, 5, 7);
+		nrOfFailedTestCases += ReportTestResult(VerifyStencilOperator(S, A, reportTestCases), "double", "laplace2D 5-point");
+		S.tile(2, 3);
+		S.threads(3);
+		nrOfFailedTestCases += ReportTestResult(VerifyStencilOperator(S, A, reportTestCases), "double", "laplace2D tiled and threaded");
+
+		diffusion(S, 7, 5, 1, [](size_t, size_t, size_t) { return 1.0; });
+		nrOfFailedTestCases += ReportTestResult(VerifyStencilOperator(S, A, reportTestCases), "double", "diffusion kappa = 1");
+
+		laplace2D_9point(S, 6, 4);
+		matrix<double> B = S.to_matrix();
+		int nrOfFailedTests = (B(5, 5) == 20.0 && B(5, 4) == -4.0 && B(5, 1) == -4.0 && B(5, 0) == -1.0 && B(5, 10) == -1.0 && B(0, 5) == -1.0) ? 0 : 1;
+		S.tile(4, 2);
+		S.threads(2);
+		nrOfFailedTests += VerifyStencilOperator(S, B, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "laplace2D 9-point");
+
+		laplace3D(S, 4, 3, 5);
+		B = S.to_matrix();
+		nrOfFailedTests = (B(S.index(2, 1, 1), S.index(2, 1, 1)) == 6.0 && B(S.index(2, 1, 1), S.index(2, 1, 0)) == -1.0 && B(S.index(2, 1, 1), S.index(2, 2, 2)) == 0.0) ? 0 : 1;
+		S.tile(2, 2);
+		S.threads(4);
+		nrOfFailedTests += VerifyStencilOperator(S, B, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "laplace3D 7-point");
+
+		laplace3D_27point(S, 3, 4, 5);
+		B = S.to_matrix();
+		size_t nnz = 0;
+		for (size_t j = 0; j < num_cols(B); ++j) if (B(S.index(2, 1, 1), j) != 0.0) ++nnz;
+		nrOfFailedTests = (nnz == 27 && B(0, 0) == 26.0) ? 0 : 1;
+		S.tile(3, 2);
+		S.threads(3);
+		nrOfFailedTests += VerifyStencilOperator(S, B, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "laplace3D 27-point");
+
+		// variable coefficients: the operator is symmetric with zero row sums in the interior
+		diffusion(S, 6, 5, 4, [](size_t i, size_t j, size_t k) { return 1.0 + double(i) + 2.0 * double(j * k); });
+		B = S.to_matrix();
+		nrOfFailedTests = 0;
+		for (size_t i = 0; i < num_rows(B); ++i) {
+			for (size_t j = 0; j < i; ++j) if (B(i, j) != B(j, i)) ++nrOfFailedTests;
+		}
+		size_t p = S.index(2, 2, 2);
+		double rowSum = 0.0;
+		for (size_t j = 0; j < num_cols(B); ++j) rowSum += B(p, j);
+		if (std::fabs(rowSum) > 1.0e-12) ++nrOfFailedTests;
+		S.tile(2, 4);
+		S.threads(2);
+		nrOfFailedTests += VerifyStencilOperator(S, B, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "variable coefficient diffusion");
+	}
+
+	// on a grid two columns wide the points (1,0,0) and (-1,1,0) have the same linear offset: setting one again replaces it
+	{
+		stencil_operator<double> S(2, 3);
+		S.set(-1, 1, 0, -1.0);
+		S.set(1, 0, 0, -1.0);
+		S.set(-1, 1, 0, -2.0);
+		S.set(0, 0, 0, 4.0);
+		matrix<double> A(6, 6);
+		A.setzero();
+		for (size_t j = 0; j < 3; ++j) {
+			for (size_t i = 0; i < 2; ++i) {
+				size_t p = S.index(i, j, 0);
+				A(p, p) = 4.0;
+				if (i + 1 < 2) A(p, S.index(i + 1, j, 0)) = -1.0;
+				if (i > 0 && j + 1 < 3) A(p, S.index(i - 1, j + 1, 0)) = -2.0;
+			}
+		}
+		int nrOfFailedTests = (S.points() == 3) ? 0 : 1;
+		nrOfFailedTests += VerifyStencilOperator(S, A, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "narrow grid with shared offsets");
+	}
+
+	// Gauss-Seidel and SOR sweep in the order of the dense solvers, and produce the same iterates
+	{
+		stencil_operator<double> S;
+		matrix<double> A;
+		laplace2D(S, 4, 3);
+		laplace2D(A, 4, 3);
+		vector<double> b(S.size()), x(S.size()), xs(S.size());
+		for (size_t i = 0; i < S.size(); ++i) b[i] = double(i % 3) - 0.5;
+		size_t itr = GaussSeidel<matrix<double>, vector<double>, 5>(A, b, x, 1.0e-12);
+		size_t itrs = GaussSeidel<double, 5>(S, b, xs, 1.0e-12);
+		nrOfFailedTestCases += ReportTestResult((itr == itrs && x == xs) ? 0 : 1, "double", "Gauss-Seidel");
+		x = 0.0;
+		xs = 0.0;
+		itr = sor<matrix<double>, vector<double>, 5>(A, b, x, 1.25, 1.0e-12);
+		itrs = sor<double, 5>(S, b, xs, 1.25, 1.0e-12);
+		nrOfFailedTestCases += ReportTestResult((itr == itrs && x == xs) ? 0 : 1, "double", "SOR");
+	}
+
+	// Jacobi on the threads of the operator
+	{
+		stencil_operator<double> S;
+		laplace2D(S, 16, 16);
+		S.threads(4);
+		vector<double> one(S.size()), b(S.size()), x(S.size());
+		one = 1.0;
+		S.apply(one, b);
+		Jacobi<double, 2000>(S, b, x, 1.0e-10);
+		nrOfFailedTestCases += ReportTestResult(SolutionError(x) < 1.0e-8 ? 0 : 1, "double", "Jacobi 16x16");
+	}
+
+	// a grid that is beyond the reach of the dense laplace2D: PCG with the Jacobi preconditioner
+	{
+		stencil_operator<double> S;
+		laplace2D(S, 300, 300);
+		S.threads(0);
+		vector<double> one(S.size()), b(S.size()), x(S.size());
+		one = 1.0;
+		S.apply(one, b);
+		pcg_workspace<double> ws;
+		krylov_configuration cfg;
+		cfg.tolerance = 1.0e-10;
+		krylov_report report = pcg(S, inverse_diagonal(S), b, x, ws, cfg);
+		if (report.status != 0 && reportTestCases) std::cerr << "pcg status " << report.status << " after " << report.iterations << " iterations\n";
+		nrOfFailedTestCases += ReportTestResult((report.status == 0 && SolutionError(x) < 1.0e-6) ? 0 : 1, "double", "pcg laplace2D 300x300");
+
+		laplace3D_27point(S, 24, 24, 24);
+		S.threads(0);
+		b.resize(S.size()); one.resize(S.size()); x.resize(S.size());
+		one = 1.0;
+		x = 0.0;
+		S.apply(one, b);
+		report = pcg(S, inverse_diagonal(S), b, x, ws, cfg);
+		nrOfFailedTestCases += ReportTestResult((report.status == 0 && SolutionError(x) < 1.0e-6) ? 0 : 1, "double", "pcg laplace3D 27-point 24^3");
+	}
+
+	// the cg solver of cg.hpp with a stencil operator and its inverse diagonal
+	{
+		using Scalar = posit<32, 2>;
+		stencil_operator<Scalar> A;
+		laplace2D(A, 16, 16);
+		stencil_operator<Scalar> M = inverse_diagonal(A);
+		vector<Scalar> one(A.size()), b(A.size()), x(A.size()), residuals;
+		one = Scalar(1);
+		b = A * one;
+		cg<stencil_operator<Scalar>, vector<Scalar>, 200>(M, A, b, x, residuals, Scalar(1.0e-6));
+		nrOfFailedTestCases += ReportTestResult(SolutionError(x) < 1.0e-5 ? 0 : 1, "posit<32,2>", "cg laplace2D");
+	}
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::quire_exception& err) {
+	std::cerr << "Caught unexpected quire exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,242 @@
+// quantization.cpp: test suite for the bulk quantization of double data to low-precision number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <cmath>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/quantization.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// the bulk quantizer rounds to nearest exactly as the constructor of the Target does:
+// all values of the Target, the midpoints between them, their neighbors, and random samples
+template<typename Target>
+int VerifyNearest(size_t nrSamples, bool reportTestCases) {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+	int nrOfFailedTests = 0;
+	constexpr uint32_t NR_ENCODINGS = uint32_t(1) << Target::nbits;
+	std::vector<double> values;
+	for (uint32_t e = 0; e < NR_ENCODINGS; ++e) {
+		Target t;
+		t.setbits(e);
+		double v = double(t);
+		if (std::isfinite(v)) values.push_back(v);
+	}
+	std::sort(values.begin(), values.end());
+	std::vector<double> x;
+	for (size_t i = 0; i < values.size(); ++i) {
+		x.push_back(values[i]);
+		if (i + 1 < values.size()) {
+			double m = values[i] + (values[i + 1] - values[i]) / 2.0;
+			x.push_back(m);
+			x.push_back(std::nextafter(m, -INFINITY));
+			x.push_back(std::nextafter(m, INFINITY));
+		}
+	}
+	x.push_back(2.0 * values.back());
+	x.push_back(2.0 * values.front());
+	x.push_back(-0.0);
+	x.push_back(std::numeric_limits<double>::quiet_NaN());
+	x.push_back(std::numeric_limits<double>::infinity());
+	std::mt19937_64 engine(Target::nbits);
+	std::uniform_real_distribution<double> dist(values.front() * 1.1, values.back() * 1.1);
+	for (size_t i = 0; i < nrSamples; ++i) x.push_back(dist(engine));
+
+	quantizer<Target> quant;
+	std::vector<Target> q(x.size());
+	quant.quantize(x.data(), x.size(), q.data());
+	for (size_t i = 0; i < x.size(); ++i) {
+		Target ref(x[i]);
+		bool same = (q[i] == ref) || (std::isnan(double(q[i])) && std::isnan(double(ref)));
+		if (!same || std::signbit(double(q[i])) != std::signbit(double(ref))) {
+			if (reportTestCases && nrOfFailedTests < 10) std::cerr << "FAIL: " << type_tag(ref) << " quantize(" << x[i] << ") = " << q[i] << " != " << ref << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// packed encodings unpack to the values of the unpacked quantization
+template<typename Target>
+int VerifyPacked(const sw::universal::blas::vector<double>& x, bool reportTestCases) {
+	using namespace sw::universal::blas;
+	int nrOfFailedTests = 0;
+	quantization_scale param = quantization_parameters<Target>(x);
+	vector<Target> q = quantize<Target>(x, param);
+	vector<double> reference = dequantize(q, param);
+	std::vector<uint8_t> packed = quantize_packed<Target>(x, param);
+	if (packed.size() != (size(x) * Target::nbits + 7) / 8) ++nrOfFailedTests;
+	std::vector<double> y(size(x));
+	quantizer<Target>(param).dequantize_packed(packed.data(), size(x), y.data());
+	for (size_t i = 0; i < size(x); ++i) {
+		if (y[i] != reference[i]) {
+			if (reportTestCases && nrOfFailedTests < 10) std::cerr << "FAIL: packed element " << i << " : " << y[i] << " != " << reference[i] << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "bulk quantization";
+	std::string test_tag    = "quantization";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	vector<double> x = { -1.5, -0.3, 0.0, 0.1, 0.7, 2.25 };
+	quantization_scale param = quantization_parameters<posit<8, 0>>(x);
+	vector<posit<8, 0>> q = quantize<posit<8, 0>>(x, param);
+	std::cout << "scale " << param.scale << '\n' << x << '\n' << dequantize(q, param) << '\n';
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< posit<4, 0> >(1000, reportTestCases), "posit<4,0>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< posit<8, 0> >(10000, reportTestCases), "posit<8,0>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< cfloat<8, 2, uint8_t, true, false, false> >(10000, reportTestCases), "cfloat<8,2>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< cfloat<6, 2, uint8_t, true, false, false> >(1000, reportTestCases), "cfloat<6,2>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< fixpnt<8, 4, Saturate, uint8_t> >(10000, reportTestCases), "fixpnt<8,4>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< lns<8, 3, uint8_t> >(10000, reportTestCases), "lns<8,3>", "round to nearest");
+
+	// the quantization parameters
+	{
+		int nrOfFailedTests = 0;
+		vector<double> x = { -3.0, 0.5, 2.0, 1.0e9 * 0.0 };
+		quantization_scale s = quantization_parameters<posit<8, 0>>(x);   // maxpos 64: 3 / 64 rounds up to 1 / 16
+		if (s.scale != 0.0625 || s.offset != 0.0) ++nrOfFailedTests;
+		s = quantization_parameters<posit<8, 0>>(-64.0, 64.0);
+		if (s.scale != 1.0) ++nrOfFailedTests;
+		s = quantization_parameters<posit<8, 0>>(-64.0, 64.5);
+		if (s.scale != 2.0) ++nrOfFailedTests;
+		s = quantization_parameters<fixpnt<8, 4, Saturate, uint8_t>>(10.0, 20.0, QuantizationMode::affine);
+		if (s.offset != 15.0 || s.scale != 5.0 / double(std::numeric_limits<fixpnt<8, 4, Saturate, uint8_t>>::max())) ++nrOfFailedTests;
+		streaming_statistics<double> stats;
+		stats.push(x.begin(), x.end());
+		quantization_scale t = quantization_parameters<posit<8, 0>>(stats);
+		if (t.scale != 0.0625) ++nrOfFailedTests;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "posit<8,0>", "quantization parameters");
+	}
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< posit<16, 1> >(100000, reportTestCases), "posit<16,1>", "round to nearest");
+	nrOfFailedTestCases += ReportTestResult(VerifyNearest< cfloat<16, 5, uint16_t, true, false, false> >(100000, reportTestCases), "cfloat<16,5>", "round to nearest");
+
+	// stochastic rounding is unbiased and reproducible across chunks
+	{
+		using Target = posit<8, 0>;
+		constexpr size_t N = 100000;
+		std::vector<double> x(N, 0.3);                // between the posit<8,0> values 0.296875 and 0.3125
+		std::vector<Target> q(N), chunked(N);
+		quantizer<Target> sr(quantization_scale{}, QuantizationRounding::stochastic, 0xC0FFEE);
+		sr.quantize(x.data(), N, q.data());
+		double sum = 0.0;
+		size_t up = 0;
+		for (size_t i = 0; i < N; ++i) {
+			sum += double(q[i]);
+			if (q[i] == Target(0.3125)) ++up;
+		}
+		int nrOfFailedTests = 0;
+		if (std::fabs(sum / double(N) - 0.3) > 2.0e-4) {
+			if (reportTestCases) std::cerr << "FAIL: stochastic rounding mean " << sum / double(N) << '\n';
+			++nrOfFailedTests;
+		}
+		if (up == 0 || up == N) ++nrOfFailedTests;
+		sr.quantize(x.data(), 1000, chunked.data());
+		sr.quantize(x.data() + 1000, N - 1000, chunked.data() + 1000, 1000);
+		for (size_t i = 0; i < N; ++i) if (!(chunked[i] == q[i])) { ++nrOfFailedTests; break; }
+		// a chunk that starts in the middle of a Philox block
+		sr.quantize(x.data(), 1001, chunked.data());
+		sr.quantize(x.data() + 1001, N - 1001, chunked.data() + 1001, 1001);
+		for (size_t i = 0; i < N; ++i) if (!(chunked[i] == q[i])) { ++nrOfFailedTests; break; }
+		// values of the Target are exact under stochastic rounding
+		std::vector<double> exact = { 0.296875, 0.3125, -1.0, 64.0 };
+		std::vector<Target> e(exact.size());
+		sr.quantize(exact.data(), exact.size(), e.data());
+		for (size_t i = 0; i < exact.size(); ++i) if (double(e[i]) != exact[i]) ++nrOfFailedTests;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "posit<8,0>", "stochastic rounding");
+	}
+
+	// packed encodings: two 4-bit encodings per byte, and encodings that straddle bytes
+	{
+		vector<double> x(1001);
+		std::mt19937_64 engine(47);
+		std::normal_distribution<double> normal(0.0, 1.0);
+		for (size_t i = 0; i < size(x); ++i) x[i] = normal(engine);
+		nrOfFailedTestCases += ReportTestResult(VerifyPacked< posit<4, 0> >(x, reportTestCases), "posit<4,0>", "packed");
+		nrOfFailedTestCases += ReportTestResult(VerifyPacked< cfloat<6, 2, uint8_t, true, false, false> >(x, reportTestCases), "cfloat<6,2>", "packed");
+		nrOfFailedTestCases += ReportTestResult(VerifyPacked< lns<5, 2, uint8_t> >(x, reportTestCases), "lns<5,2>", "packed");
+		nrOfFailedTestCases += ReportTestResult(VerifyPacked< posit<12, 1> >(x, reportTestCases), "posit<12,1>", "packed");
+
+		int nrOfFailedTests = 0;
+		vector<double> one = { 1.0, -1.0, 0.0 };
+		std::vector<uint8_t> packed = quantize_packed< posit<4, 0> >(one, quantization_scale{});
+		if (packed.size() != 2 || packed[0] != 0xC4 || packed[1] != 0x00) ++nrOfFailedTests;   // 1 = 0100, -1 = 1100, 0 = 0000
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "posit<4,0>", "packed layout");
+	}
+#endif
+
+#if REGRESSION_LEVEL_3
+
+#endif
+
+#if REGRESSION_LEVEL_4
+
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
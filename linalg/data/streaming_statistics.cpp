@@ -0,0 +1,230 @@
+// streaming_statistics.cpp: test suite for the one-pass, mergeable statistics accumulator for data preprocessing
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <cmath>
+#include <universal/number/posit/posit.hpp>
+#include <universal/blas/blas.hpp>
+#include <universal/blas/generators.hpp>
+#include <universal/blas/statistics.hpp>
+#include <universal/verification/test_suite.hpp>
+
+// the quantiles of the sketch are within the relative accuracy of the quantiles of the sorted data
+template<typename Scalar, typename Accumulator>
+int VerifyQuantiles(const sw::universal::blas::streaming_statistics<Scalar, Accumulator>& stats, std::vector<double> data, bool reportTestCases) {
+	int nrOfFailedTests = 0;
+	std::sort(data.begin(), data.end());
+	double alpha = stats.sketch().relative_accuracy();
+	for (double q : { 0.0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 1.0 }) {
+		double exact = data[size_t(q * double(data.size() - 1))];
+		double approximation = stats.quantile(q);
+		if (std::fabs(approximation - exact) > alpha * std::fabs(exact)) {
+			if (reportTestCases) std::cerr << "FAIL: quantile " << q << " : " << approximation << " vs " << exact << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the moments of an accumulator against a reference within a relative tolerance
+template<typename Scalar, typename Accumulator>
+int VerifyMoments(const sw::universal::blas::streaming_statistics<Scalar, Accumulator>& stats, double mean, double variance, double tolerance, bool reportTestCases) {
+	int nrOfFailedTests = 0;
+	if (std::fabs(double(stats.mean()) - mean) > tolerance * std::max(1.0, std::fabs(mean))) {
+		if (reportTestCases) std::cerr << "FAIL: mean " << stats.mean() << " != " << mean << '\n';
+		++nrOfFailedTests;
+	}
+	if (std::fabs(double(stats.sample_variance()) - variance) > tolerance * variance) {
+		if (reportTestCases) std::cerr << "FAIL: variance " << stats.sample_variance() << " != " << variance << '\n';
+		++nrOfFailedTests;
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+	using namespace sw::universal::blas;
+
+	std::string test_suite  = "streaming statistics";
+	std::string test_tag    = "streaming statistics";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	size_t N = 1024 * 1024;
+	std::vector<double> data(N);
+	gaussian_random(data, 0.0, 1.0);
+	std::cout << "Streaming statistics:\n" << streamingStatistics(data, 0) << '\n';
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;
+#else
+
+#if REGRESSION_LEVEL_1
+	// the integers 1..1000 in a scrambled order: mean 500.5, sample variance n(n+1)/12
+	{
+		constexpr size_t N = 1000;
+		std::vector<double> data(N);
+		for (size_t i = 0; i < N; ++i) data[i] = double((i * 337) % N + 1);
+		streaming_statistics<double> stats;
+		stats.push(data.begin(), data.end());
+		int nrOfFailedTests = VerifyMoments(stats, 500.5, double(N * (N + 1)) / 12.0, 1.0e-14, reportTestCases);
+		if (stats.count() != N || stats.min() != 1.0 || stats.max() != 1000.0 || stats.amax() != 1000.0) ++nrOfFailedTests;
+		nrOfFailedTests += VerifyQuantiles(stats, data, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "welford 1..1000");
+
+		// three chunks merged are the statistics of the whole: the sketch is identical
+		streaming_statistics<double> a, b, c;
+		a.push(data.begin(), data.begin() + 100);
+		b.push(data.begin() + 100, data.begin() + 700);
+		c.push(data.begin() + 700, data.end());
+		c.merge(a);
+		c.merge(b);
+		nrOfFailedTests = VerifyMoments(c, 500.5, double(N * (N + 1)) / 12.0, 1.0e-14, reportTestCases);
+		if (c.count() != N || c.min() != 1.0 || c.max() != 1000.0) ++nrOfFailedTests;
+		for (double q : { 0.0, 0.1, 0.5, 0.9, 1.0 }) if (c.quantile(q) != stats.quantile(q)) ++nrOfFailedTests;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "chan merge");
+
+		// merging into and from an empty accumulator
+		streaming_statistics<double> empty, whole;
+		whole.merge(stats);
+		whole.merge(empty);
+		nrOfFailedTests = VerifyMoments(whole, stats.mean(), stats.sample_variance(), 0.0, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "empty merge");
+	}
+
+	// a large offset makes the textbook sum of squares lose all digits, Welford keeps them
+	{
+		streaming_statistics<float> stats;
+		for (int i = 0; i < 4; ++i) stats.push(1.0e4f + float(i));
+		nrOfFailedTestCases += ReportTestResult(VerifyMoments(stats, 10001.5, 5.0 / 3.0, 1.0e-12, reportTestCases), "float", "offset data");
+	}
+
+	// nonfinite values are counted and propagate to the moments, the binary scales of the values are counted
+	{
+		streaming_statistics<double> stats;
+		for (double v : { 0.75, 1.0, 1.5, 3.0, 1024.0, -0.25, 0.0, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() }) stats.push(v);
+		int nrOfFailedTests = 0;
+		if (stats.count() != 7 || stats.nonfinite() != 2 || stats.zeros() != 1) ++nrOfFailedTests;
+		if (stats.scale_count(-1) != 1 || stats.scale_count(0) != 2 || stats.scale_count(1) != 1 || stats.scale_count(10) != 1 || stats.scale_count(-2) != 1) ++nrOfFailedTests;
+		if (stats.scale_range() != std::pair<int, int>(-2, 10)) ++nrOfFailedTests;
+		if (stats.min() != -0.25 || stats.max() != 1024.0) ++nrOfFailedTests;
+		if (stats.quantile(0.0) >= -0.24 || stats.quantile(0.0) < -0.26) ++nrOfFailedTests;
+		if (!std::isnan(stats.mean()) || !std::isnan(stats.variance())) ++nrOfFailedTests;
+		streaming_statistics<double> infinite;
+		for (double v : { 1.0, 2.0, std::numeric_limits<double>::infinity() }) infinite.push(v);
+		if (infinite.mean() != std::numeric_limits<double>::infinity() || !std::isnan(infinite.stddev())) ++nrOfFailedTests;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "nonfinite and scales");
+
+		// the moments are accumulated in a type that is at least as precise as the data
+		static_assert(std::is_same_v<statistics_accumulator_t<float>, double>, "float accumulates in double");
+		static_assert(std::is_same_v<statistics_accumulator_t<posit<32, 2>>, double>, "posit<32,2> accumulates in double");
+		static_assert(std::is_same_v<statistics_accumulator_t<posit<64, 3>>, posit<128, 4>>, "posit<64,3> accumulates in posit<128,4>");
+		static_assert(std::is_same_v<statistics_accumulator_t<long double>, long double>, "long double accumulates in long double");
+	}
+#endif
+
+#if REGRESSION_LEVEL_2
+	// threads: the moments agree with the single thread, the sketches are identical
+	{
+		constexpr size_t N = 100000;
+		std::vector<double> data(N);
+		gaussian_random(data, 0.0, 1.0);
+		auto serial = streamingStatistics(data);
+		auto parallel = streamingStatistics(data, 4);
+		int nrOfFailedTests = VerifyMoments(parallel, double(serial.mean()), double(serial.sample_variance()), 1.0e-12, reportTestCases);
+		if (parallel.count() != N || parallel.min() != serial.min() || parallel.max() != serial.max()) ++nrOfFailedTests;
+		for (double q : { 0.0, 0.01, 0.25, 0.5, 0.75, 0.99, 1.0 }) if (parallel.quantile(q) != serial.quantile(q)) ++nrOfFailedTests;
+		nrOfFailedTests += VerifyQuantiles(parallel, data, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, "double", "threads gaussian");
+
+		auto coarse = streamingStatistics(data, 2, 0.05);
+		nrOfFailedTestCases += ReportTestResult(VerifyQuantiles(coarse, data, reportTestCases), "double", "relative accuracy 0.05");
+	}
+
+	// Universal types: the moments are accumulated in double, or in a wider posit
+	{
+		using Scalar = posit<16, 1>;
+		constexpr size_t N = 10000;
+		vector<Scalar> data(N);
+		std::vector<double> reference(N);
+		for (size_t i = 0; i < N; ++i) {
+			data[i] = Scalar(std::sin(double(i)) * 8.0 + 2.0);
+			reference[i] = double(data[i]);
+		}
+		streaming_statistics<double> exact;
+		exact.push(reference.begin(), reference.end());
+		auto stats = streamingStatistics(data, 3);
+		int nrOfFailedTests = VerifyMoments(stats, double(exact.mean()), double(exact.sample_variance()), 1.0e-12, reportTestCases);
+		if (double(stats.min()) != exact.min() || double(stats.max()) != exact.max()) ++nrOfFailedTests;
+		nrOfFailedTests += VerifyQuantiles(stats, reference, reportTestCases);
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, type_tag(Scalar()), "accumulate in double");
+
+		auto wide = streamingStatistics<vector<Scalar>, posit<64, 3>>(data, 3);
+		nrOfFailedTestCases += ReportTestResult(VerifyMoments(wide, double(exact.mean()), double(exact.sample_variance()), 1.0e-12, reportTestCases), type_tag(Scalar()), "accumulate in posit<64,3>");
+
+		// the summary statistics are computed in the type of the data
+		SummaryStats<Scalar> summary = summaryStatistics(data);
+		Scalar sum(0), sumOfSquares(0);
+		for (size_t i = 0; i < N; ++i) sum += data[i];
+		Scalar mean = sum / Scalar(N);
+		for (size_t i = 0; i < N; ++i) sumOfSquares += (data[i] - mean) * (data[i] - mean);
+		nrOfFailedTests = (summary.mean == mean && summary.stddev == sqrt(sumOfSquares / Scalar(N - 1))) ? 0 : 1;
+		nrOfFailedTestCases += ReportTestResult(nrOfFailedTests, type_tag(Scalar()), "summary statistics");
+	}
+#endif
+
+#if REGRESSION_LEVEL_3
+
+#endif
+
+#if REGRESSION_LEVEL_4
+
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Uncaught universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Uncaught universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
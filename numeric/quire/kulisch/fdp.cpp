@@ -0,0 +1,168 @@
+// fdp.cpp: test suite for the fused dot product of cfloat, fixpnt, lns, and bfloat16 through the Kulisch quire
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <cmath>
+#include <random>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <universal/number/lns/lns.hpp>
+#include <universal/number/bfloat/bfloat.hpp>
+// blas::dot and blas::matvec dispatch to the Kulisch quire
+#define BLAS_FUSED_DOT_PRODUCT 1
+#include <universal/blas/blas.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+namespace sw { namespace universal {
+
+	// catastrophic cancellation: the fused dot product recovers the small term that the rounded sum loses
+	template<typename Scalar>
+	int VerifyCancellation(bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		Scalar big(SpecificValue::maxpos);
+		std::vector<Scalar> x = { big, Scalar(1), big }, y = { Scalar(1), Scalar(0.5f), Scalar(-1) };
+		Scalar v = fdp(x, y);
+		if (v != Scalar(0.5f)) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: fdp cancellation " << v << " != 0.5\n";
+		}
+		// quire continuation and subtraction
+		kulisch_quire<Scalar> q;
+		fdp_qc(q, 3, x, 1, y, 1);
+		q -= Scalar(0.5f);
+		if (!q.iszero()) ++nrOfFailedTestCases;
+		return nrOfFailedTestCases;
+	}
+
+	// values on a grid of 2^-4 in [-8, 8] have products and sums that are exact in double:
+	// the fused dot product must equal the single rounding of the exact double result
+	template<typename Scalar>
+	int VerifyCorrectRounding(size_t N, unsigned nrTrials, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		std::mt19937_64 engine(N);
+		std::uniform_int_distribution<int> grid(-128, 128);
+		for (unsigned t = 0; t < nrTrials; ++t) {
+			blas::vector<Scalar> x(N), y(N);
+			double exact{ 0.0 };
+			for (size_t i = 0; i < N; ++i) {
+				x[i] = Scalar(grid(engine) / 16.0);
+				y[i] = Scalar(grid(engine) / 16.0);
+				exact += double(x[i]) * double(y[i]);
+			}
+			Scalar reference(exact), v = fdp(x, y);
+			if (v != reference) {
+				++nrOfFailedTestCases;
+				if (reportTestCases) std::cerr << "FAIL: fdp " << v << " != " << reference << " (" << exact << ")\n";
+			}
+			if (blas::dot(x, y) != v) ++nrOfFailedTestCases;
+			if (fdp_stride(N, x, 1, y, 1) != v) ++nrOfFailedTestCases;
+		}
+		return nrOfFailedTestCases;
+	}
+
+	// fixed-point: the reference is the integer sum of the raw products rounded once, ties to even
+	template<unsigned nbits, unsigned rbits>
+	int VerifyFixpntRounding(size_t N, unsigned nrTrials, bool reportTestCases) {
+		using Scalar = fixpnt<nbits, rbits, Modulo, uint16_t>;
+		int nrOfFailedTestCases = 0;
+		std::mt19937_64 engine(N);
+		std::uniform_int_distribution<int64_t> raw(-(1ll << (nbits - 1)), (1ll << (nbits - 1)) - 1);
+		for (unsigned t = 0; t < nrTrials; ++t) {
+			std::vector<Scalar> x(N), y(N);
+			int64_t sum{ 0 };
+			for (size_t i = 0; i < N; ++i) {
+				int64_t a = raw(engine), b = raw(engine);
+				x[i].setbits(static_cast<uint64_t>(a));
+				y[i].setbits(static_cast<uint64_t>(b));
+				sum += a * b;
+			}
+			int64_t q = sum >> rbits, r = sum - (q << rbits), half = 1ll << (rbits - 1);
+			if (r > half || (r == half && (q & 1))) ++q;
+			Scalar reference;
+			reference.setbits(static_cast<uint64_t>(q));
+			Scalar v = fdp(x, y);
+			if (v != reference) {
+				++nrOfFailedTestCases;
+				if (reportTestCases) std::cerr << "FAIL: fdp " << to_binary(v) << " != " << to_binary(reference) << '\n';
+			}
+		}
+		return nrOfFailedTestCases;
+	}
+
+	// matvec dispatches to the Kulisch quire
+	template<typename Scalar>
+	int VerifyFusedMatvec(size_t N, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		std::mt19937_64 engine(N);
+		std::uniform_real_distribution<double> dist(-1.0, 1.0);
+		blas::matrix<Scalar> A(N, N);
+		blas::vector<Scalar> x(N), b(N);
+		for (auto& e : A) e = Scalar(dist(engine));
+		for (size_t i = 0; i < N; ++i) x[i] = Scalar(dist(engine));
+		blas::matvec(b, A, x);
+		for (size_t i = 0; i < N; ++i) {
+			kulisch_quire<Scalar> q;
+			for (size_t j = 0; j < N; ++j) q += quire_mul(A(i, j), x[j]);
+			if (b[i] != q.to_value()) ++nrOfFailedTestCases;
+		}
+		if (nrOfFailedTestCases && reportTestCases) std::cerr << "FAIL: matvec is not fused\n";
+		return nrOfFailedTestCases;
+	}
+
+}} // namespace sw::universal
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "Kulisch quire fused dot product";
+	std::string test_tag    = "fdp";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	using fp16 = cfloat<16, 5, uint16_t, true, false, false>;
+	using fp32 = cfloat<32, 8, uint32_t, true, false, false>;
+	using lns16 = lns<16, 8, uint16_t>;
+
+	nrOfFailedTestCases += ReportTestResult(VerifyCancellation<fp16>(reportTestCases), "cfloat<16,5>", "cancellation");
+	nrOfFailedTestCases += ReportTestResult(VerifyCancellation<fp32>(reportTestCases), "cfloat<32,8>", "cancellation");
+	nrOfFailedTestCases += ReportTestResult(VerifyCancellation<bfloat16>(reportTestCases), "bfloat16", "cancellation");
+	nrOfFailedTestCases += ReportTestResult(VerifyCancellation<lns16>(reportTestCases), "lns<16,8>", "cancellation");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyCorrectRounding<fp16>(100, 50, reportTestCases), "cfloat<16,5>", "correct rounding");
+	nrOfFailedTestCases += ReportTestResult(VerifyCorrectRounding<fp32>(1000, 20, reportTestCases), "cfloat<32,8>", "correct rounding");
+	nrOfFailedTestCases += ReportTestResult(VerifyCorrectRounding<bfloat16>(100, 50, reportTestCases), "bfloat16", "correct rounding");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyFixpntRounding<16, 8>(100, 50, reportTestCases), "fixpnt<16,8>", "correct rounding");
+	nrOfFailedTestCases += ReportTestResult(VerifyFixpntRounding<12, 4>(10, 50, reportTestCases), "fixpnt<12,4>", "modulo wrap");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyFusedMatvec<fp16>(20, reportTestCases), "cfloat<16,5>", "fused matvec");
+	nrOfFailedTestCases += ReportTestResult(VerifyFusedMatvec<lns16>(20, reportTestCases), "lns<16,8>", "fused matvec");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
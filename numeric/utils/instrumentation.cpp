@@ -0,0 +1,123 @@
+// instrumentation.cpp: tester of the per-thread operation counters and scale histograms of the number systems
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+// enable the instrumentation of the number systems under test
+#define CFLOAT_INSTRUMENTATION 1
+#include <universal/number/cfloat/cfloat.hpp>
+#define EDECIMAL_OPERATIONS_COUNT 1
+#include <universal/number/edecimal/edecimal.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+namespace sw { namespace universal {
+
+	// every thread runs the same sequence of operations, so the aggregate is an exact multiple of a single thread
+	template<typename Real>
+	void Workload(size_t nrOps) {
+		Real a{ 1.5f }, b{ 0.75f }, c{ 0.0f };
+		for (size_t i = 0; i < nrOps; ++i) {
+			c = a + b;
+			c = a - b;
+			c = a * b;
+			c = a / b;
+		}
+	}
+
+	template<typename Real>
+	int VerifyMultithreadedOperationCounts(unsigned nrThreads, size_t nrOps, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		instrumentation<Real>::reset();
+		std::vector<std::thread> workers;
+		for (unsigned t = 0; t < nrThreads; ++t) workers.emplace_back(Workload<Real>, nrOps);
+		for (auto& w : workers) w.join();
+
+		instrumentation_report<Real> r = instrumentation<Real>::report();
+		size_t expected = nrThreads * nrOps;
+		if (r.ops.add != expected || r.ops.sub != expected || r.ops.mul != expected || r.ops.div != expected) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) r.ops.report(std::cerr);
+		}
+		return nrOfFailedTestCases;
+	}
+
+}} // namespace sw::universal
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "instrumentation of number systems";
+	std::string test_tag    = "instrumentation";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	using Real = cfloat<16, 5, uint16_t, true, false, false>;
+	nrOfFailedTestCases += ReportTestResult(VerifyMultithreadedOperationCounts<Real>(4, 1000, reportTestCases), "cfloat<16,5>", "multithreaded op counts");
+
+	// a second round recycles the buffers of the exited threads
+	nrOfFailedTestCases += ReportTestResult(VerifyMultithreadedOperationCounts<Real>(4, 500, reportTestCases), "cfloat<16,5>", "recycled thread buffers");
+
+	{
+		// rounding, overflow, underflow and the scale histogram
+		Real maxpos(SpecificValue::maxpos), minpos(SpecificValue::minpos), c;
+		instrumentation<Real>::reset();
+		c = maxpos * maxpos;  // projects to inf
+		c = minpos * minpos;  // flushes to zero
+		c = Real(2.0f) * Real(4.0f);  // exact with scale 3
+		instrumentation_report<Real> r = instrumentation<Real>::report();
+		int failures = 0;
+		if (r.ops.overflow != 1) ++failures;
+		if (r.ops.underflow != 1) ++failures;
+		if (r.scales.count(3) != 1) ++failures;
+		// quotients that are not representable, some of which round up
+		for (int i = 3; i < 32; i += 2) c = Real(1.0f) / Real(i);
+		r = instrumentation<Real>::report();
+		if (r.ops.round == 0) ++failures;
+		if (failures && reportTestCases) r.report(std::cerr);
+		nrOfFailedTestCases += ReportTestResult(failures, "cfloat<16,5>", "exceptional events");
+	}
+
+	{
+		// the additions that accumulate the partial products of a multiplication are not counted
+		edecimal a(12345), b(678), c;
+		a.resetStats();
+		c = a * b;
+		c = a + b;
+		c = a / b;
+		instrumentation_report<edecimal> r = instrumentation<edecimal>::report();
+		int failures = 0;
+		if (r.ops.mul != 1 || r.ops.add != 1 || r.ops.div != 1) ++failures;
+		if (failures && reportTestCases) a.printStats(std::cerr);
+		nrOfFailedTestCases += ReportTestResult(failures, "edecimal", "nested operator counts");
+	}
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+// array_kernels.cpp: test suite runner for the bfloat16 array kernels
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <vector>
+#include <universal/number/bfloat/bfloat.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+namespace sw { namespace universal {
+
+	// random encodings, including the special values, for N elements
+	std::vector<bfloat16> RandomEncodings(size_t N, unsigned seed) {
+		std::mt19937_64 engine(seed);
+		std::uniform_int_distribution<unsigned> encoding(0, 0xFFFFu);
+		std::vector<bfloat16> v(N);
+		for (auto& e : v) e.setbits(static_cast<unsigned short>(encoding(engine)));
+		return v;
+	}
+
+	bool SameEncoding(const bfloat16& a, const bfloat16& b) {
+		return (a.bits() == b.bits()) || (a.isnan() && b.isnan());
+	}
+
+	// the element-wise kernels must produce the encodings of the scalar operators
+	int VerifyElementwiseKernels(size_t N, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		std::vector<bfloat16> a = RandomEncodings(N, 1), b = RandomEncodings(N, 2), c = RandomEncodings(N, 3), r(N);
+
+		auto check = [&](const char* op, auto scalarOp) {
+			for (size_t i = 0; i < N; ++i) {
+				bfloat16 ref = scalarOp(a[i], b[i], c[i]);
+				if (!SameEncoding(r[i], ref)) {
+					++nrOfFailedTestCases;
+					if (reportTestCases && nrOfFailedTestCases < 10) std::cerr << "FAIL: " << op << ' ' << to_binary(a[i]) << ' ' << to_binary(b[i]) << " : " << to_binary(r[i]) << " != " << to_binary(ref) << '\n';
+				}
+			}
+		};
+		bfloat16_add(a.data(), b.data(), r.data(), N);
+		check("add", [](bfloat16 x, bfloat16 y, bfloat16) { return x + y; });
+		bfloat16_sub(a.data(), b.data(), r.data(), N);
+		check("sub", [](bfloat16 x, bfloat16 y, bfloat16) { return x - y; });
+		bfloat16_mul(a.data(), b.data(), r.data(), N);
+		check("mul", [](bfloat16 x, bfloat16 y, bfloat16) { return x * y; });
+		bfloat16_div(a.data(), b.data(), r.data(), N);
+		check("div", [](bfloat16 x, bfloat16 y, bfloat16) { return x / y; });
+		bfloat16_fma(a.data(), b.data(), c.data(), r.data(), N);
+		check("fma", [](bfloat16 x, bfloat16 y, bfloat16 z) { return bfloat16(float(x) * float(y) + float(z)); });
+
+		// round trip through float is exact
+		std::vector<float> f(N);
+		bfloat16_to_float(a.data(), f.data(), N);
+		float_to_bfloat16(f.data(), r.data(), N);
+		for (size_t i = 0; i < N; ++i) {
+			if (!SameEncoding(r[i], a[i]) || !SameEncoding(bfloat16(f[i]), a[i])) ++nrOfFailedTestCases;
+		}
+		return nrOfFailedTestCases;
+	}
+
+	// dot and gemm accumulate in float: values on a grid of 2^-4 keep all sums exact
+	int VerifyAccumulatingKernels(size_t N, bool reportTestCases) {
+		int nrOfFailedTestCases = 0;
+		std::mt19937_64 engine(N);
+		std::uniform_int_distribution<int> grid(-64, 64);
+		std::vector<bfloat16> a(N * N), b(N * N);
+		for (auto& e : a) e = bfloat16(grid(engine) / 16.0f);
+		for (auto& e : b) e = bfloat16(grid(engine) / 16.0f);
+
+		double ref{ 0.0 };
+		for (size_t i = 0; i < N; ++i) ref += double(a[i]) * double(b[i]);
+		float dot = bfloat16_dot(a.data(), b.data(), N);
+		if (double(dot) != ref) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: dot " << dot << " != " << ref << '\n';
+		}
+
+		// N x N times N x N, sizes above the panel depth of 64 exercise the panel loop
+		std::vector<float> C(N * N, 0.0f);
+		bfloat16_gemm(N, N, N, a.data(), N, b.data(), N, C.data(), N);
+		for (size_t i = 0; i < N; ++i) {
+			for (size_t j = 0; j < N; ++j) {
+				float cij{ 0.0f };
+				for (size_t k = 0; k < N; ++k) cij += float(a[i * N + k]) * float(b[k * N + j]);
+				if (C[i * N + j] != cij) ++nrOfFailedTestCases;
+			}
+		}
+		if (nrOfFailedTestCases && reportTestCases) std::cerr << "FAIL: gemm\n";
+		return nrOfFailedTestCases;
+	}
+
+}} // namespace sw::universal
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "bfloat16 array kernels";
+	std::string test_tag    = "bfloat16 kernels";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyElementwiseKernels(10007, reportTestCases), "bfloat16", "element-wise kernels");
+	nrOfFailedTestCases += ReportTestResult(VerifyAccumulatingKernels(37, reportTestCases), "bfloat16", "dot and gemm kernels");
+	nrOfFailedTestCases += ReportTestResult(VerifyAccumulatingKernels(130, reportTestCases), "bfloat16", "dot and gemm kernels");
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -13,6 +13,7 @@
 #define CFLOAT_THROW_ARITHMETIC_EXCEPTION 1
 #include <universal/number/cfloat/cfloat.hpp>
 #include <universal/verification/test_suite.hpp>
+#include <array>
 
 #if BIT_CAST_SUPPORT
 // stylistic constexpr of pi that we'll assign constexpr to an cfloat
@@ -102,6 +103,58 @@ void TestConstexprSpecificValues() {
 	}
 }
 
+#if BIT_CAST_IS_CONSTEXPR
+// table of reciprocals 1/(i+1) generated by the cfloat arithmetic in a constant expression
+template<typename Real, size_t N>
+constexpr std::array<Real, N> ReciprocalTable() {
+	std::array<Real, N> table{};
+	for (size_t i = 0; i < N; ++i) {
+		Real d(static_cast<int>(i + 1));
+		table[i] = Real(1) / d;
+	}
+	return table;
+}
+
+// Horner evaluation of the Taylor polynomial of exp(x) around 0
+template<typename Real>
+constexpr Real ExpTaylor(const Real& x) {
+	constexpr double c[] = { 1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0 };
+	Real p(c[5]);
+	for (int i = 4; i >= 0; --i) {
+		p *= x;
+		p += Real(c[i]);
+	}
+	return p;
+}
+
+template<typename Real>
+int VerifyConstexprArithmetic(bool reportTestCases) {
+	int nrOfFailedTestCases = 0;
+
+	constexpr auto table = ReciprocalTable<Real, 8>();
+	static_assert(double(table[0]) == 1.0, "constexpr division failed");
+	static_assert(double(table[1]) == 0.5, "constexpr division failed");
+	static_assert(double(table[3]) == 0.25, "constexpr division failed");
+	for (size_t i = 0; i < table.size(); ++i) {
+		Real ref = Real(1) / Real(static_cast<int>(i + 1));
+		if (table[i] != ref) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: 1/" << (i + 1) << " : " << table[i] << " != " << ref << '\n';
+		}
+	}
+
+	constexpr Real e = ExpTaylor(Real(1));
+	static_assert(e > Real(2.5) && e < Real(3), "constexpr polynomial evaluation failed");
+	constexpr Real a(1.5), b(-0.25);
+	static_assert(a + b == Real(1.25), "constexpr addition failed");
+	static_assert(a - b == Real(1.75), "constexpr subtraction failed");
+	static_assert(a * b == Real(-0.375), "constexpr multiplication failed");
+	static_assert(b / a < Real(0), "constexpr division failed");
+	if (e != ExpTaylor(Real(1))) ++nrOfFailedTestCases;
+	return nrOfFailedTestCases;
+}
+#endif // BIT_CAST_IS_CONSTEXPR
+
 int main()
 try {
 	using namespace sw::universal;
@@ -121,6 +174,12 @@ try {
 	TestConstexprAssignment<Real>();
 	TestConstexprSpecificValues<Real>();
 
+#if BIT_CAST_IS_CONSTEXPR
+	nrOfFailedTestCases += ReportTestResult(VerifyConstexprArithmetic< cfloat<16, 5, uint16_t, true, false, false> >(reportTestCases), "cfloat<16,5>", "constexpr arithmetic");
+	nrOfFailedTestCases += ReportTestResult(VerifyConstexprArithmetic< cfloat<32, 8, uint32_t, true, false, false> >(reportTestCases), "cfloat<32,8>", "constexpr arithmetic");
+	nrOfFailedTestCases += ReportTestResult(VerifyConstexprArithmetic< cfloat<64, 11, uint32_t, true, false, false> >(reportTestCases), "cfloat<64,11>", "constexpr arithmetic");
+#endif // BIT_CAST_IS_CONSTEXPR
+
 	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
 	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
 }
@@ -0,0 +1,125 @@
+// uint64_blocks.cpp: test suite runner for the arithmetic of classic floats with uint64_t blocks
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/verification/test_suite.hpp>
+
+/*
+   A cfloat with uint64_t blocks must produce the same encodings as the same cfloat with
+   uint32_t blocks. The configurations cover a single uint64_t block, whose blocktriple
+   significant spans two blocks in a multiplication, and the multi-block extended and
+   quad precision formats.
+*/
+
+template<unsigned nbits, unsigned es>
+int VerifyBlockTypeInvariance(unsigned nrOfRandoms, bool reportTestCases) {
+	using namespace sw::universal;
+	using Reference = cfloat<nbits, es, uint32_t, true, false, false>;
+	using Wide = cfloat<nbits, es, uint64_t, true, false, false>;
+	std::mt19937_64 engine(nbits);
+	std::uniform_real_distribution<double> distribution(-1.0e3, 1.0e3);
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		double x = distribution(engine), y = distribution(engine);
+		Reference a(x), b(y);
+		Wide wa(x), wb(y);
+		if (to_binary(a) != to_binary(wa)) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: conversion of " << x << " : " << to_binary(wa) << " reference " << to_binary(a) << '\n';
+			continue;
+		}
+		Reference r[4] = { a + b, a - b, a * b, a / b };
+		Wide w[4] = { wa + wb, wa - wb, wa * wb, wa / wb };
+		for (unsigned k = 0; k < 4; ++k) {
+			if (to_binary(r[k]) != to_binary(w[k])) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: operator " << "+-*/"[k] << " of " << x << " and " << y << " : " << to_binary(w[k]) << " reference " << to_binary(r[k]) << '\n';
+			}
+		}
+		if (double(w[2]) != double(r[2])) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: conversion to double of " << to_binary(w[2]) << '\n';
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "cfloat arithmetic with uint64_t blocks";
+	std::string test_tag    = "uint64_t blocks";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<64, 11>(10, reportTestCases), "cfloat<64,11,uint64_t>", test_tag);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS; // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance< 64, 11>(1000, reportTestCases), "cfloat< 64,11,uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance< 80, 11>(1000, reportTestCases), "cfloat< 80,11,uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<128, 15>(1000, reportTestCases), "cfloat<128,15,uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<256, 19>(500, reportTestCases), "cfloat<256,19,uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_3
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << msg << '\n';
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << '\n';
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,125 @@
+// uint64_blocks.cpp: test suite runner for the arithmetic of fixed-size arbitrary precision integers with uint64_t blocks
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/integer/integer.hpp>
+#include <universal/verification/test_suite.hpp>
+
+/*
+   The carry chains, the multiplication, and the long division of integer<> with uint64_t
+   blocks must produce the same encodings as the same integer<> with uint32_t blocks.
+   The dividend and divisor lengths are varied so that the division runs through the
+   single limb path, and through the normalization and quotient digit correction of the
+   multi-limb path.
+*/
+
+template<unsigned nbits>
+int VerifyBlockTypeInvariance(unsigned nrOfRandoms, bool reportTestCases) {
+	using namespace sw::universal;
+	using Reference = integer<nbits, uint32_t, IntegerNumber>;
+	using Wide = integer<nbits, uint64_t, IntegerNumber>;
+	std::mt19937_64 engine(nbits);
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		Reference a(0), b(0);
+		Wide wa(0), wb(0);
+		unsigned divisorBits = 1 + static_cast<unsigned>(engine() % nbits);
+		bool allOnes = (t % 8 == 0);  // the largest quotient digits and the longest carry chains
+		for (unsigned i = 0; i < nbits; ++i) {
+			bool abit = allOnes || (engine() & 1) != 0;
+			bool bbit = (i < divisorBits) && (allOnes || (engine() & 1) != 0);
+			a.setbit(i, abit); wa.setbit(i, abit);
+			b.setbit(i, bbit); wb.setbit(i, bbit);
+		}
+		if (b.iszero()) continue;
+		Reference r[5] = { a + b, a - b, a * b, a / b, a % b };
+		Wide w[5] = { wa + wb, wa - wb, wa * wb, wa / wb, wa % wb };
+		for (unsigned k = 0; k < 5; ++k) {
+			if (to_binary(r[k]) != to_binary(w[k])) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: operator " << "+-*/%"[k] << " of " << a << " and " << b << " : " << w[k] << " reference " << r[k] << '\n';
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "Integer Arithmetic with uint64_t blocks verification";
+	std::string test_tag    = "integer<> uint64_t blocks";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<128>(10, reportTestCases), "integer<128, uint64_t>", test_tag);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS; // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance< 64>(1000, reportTestCases), "integer< 64, uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<120>(1000, reportTestCases), "integer<120, uint64_t>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<128>(1000, reportTestCases), "integer<128, uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<256>(1000, reportTestCases), "integer<256, uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_3
+	nrOfFailedTestCases += ReportTestResult(VerifyBlockTypeInvariance<1024>(200, reportTestCases), "integer<1024, uint64_t>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << '\n';
+	return EXIT_FAILURE;
+}
@@ -1,23 +1,119 @@
-// constexpr_test.cpp: see whether posits can be constexpr 
+// constexpr_test.cpp: compile time tests for posit constexpr arithmetic
 //
 // Copyright (C) 2017-2021 Stillwater Supercomputing, Inc.
 //
 // This file is part of the universal numbers project, which is released under an MIT Open Source license.
 #include <universal/utility/directives.hpp>
-// forth: enable/disable the ability to use literals in binary logic and arithmetic operators
-#define POSIT_ENABLE_LITERALS 1
+// first: enable the fast specializations, the generic posit is built on a std::bitset and is not constexpr
+#define POSIT_FAST_POSIT_16_1 1
+#define POSIT_FAST_POSIT_32_2 1
+// second: enable/disable posit arithmetic exceptions
+#define POSIT_THROW_ARITHMETIC_EXCEPTION 0
+#include <universal/number/posit/posit.hpp>
+#include <universal/verification/test_suite.hpp>
+#include <array>
 
-// requires C++20 <bit>
+#if BIT_CAST_IS_CONSTEXPR
+// quantization table of the values k/8 for k in [-8, 8], generated in a constant expression
+template<typename Real, size_t N = 17>
+constexpr std::array<Real, N> QuantizationTable() {
+	std::array<Real, N> table{};
+	Real step(0.125);
+	Real v(-1);
+	for (size_t i = 0; i < N; ++i) {
+		table[i] = v;
+		v += step;
+	}
+	return table;
+}
 
-#include <universal/number/posit/posit.hpp>
+// Horner evaluation of the Taylor polynomial of exp(x) around 0
+template<typename Real>
+constexpr Real ExpTaylor(const Real& x) {
+	constexpr double c[] = { 1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0 };
+	Real p(c[5]);
+	for (int i = 4; i >= 0; --i) {
+		p *= x;
+		p += Real(c[i]);
+	}
+	return p;
+}
+
+template<typename Real>
+int VerifyConstexprArithmetic(bool reportTestCases) {
+	int nrOfFailedTestCases = 0;
+
+	constexpr auto table = QuantizationTable<Real>();
+	static_assert(double(table[0]) == -1.0, "constexpr conversion failed");
+	static_assert(double(table[8]) == 0.0, "constexpr addition failed");
+	static_assert(double(table[16]) == 1.0, "constexpr addition failed");
+	for (size_t i = 0; i < table.size(); ++i) {
+		double ref = -1.0 + 0.125 * double(i);
+		if (double(table[i]) != ref) {
+			++nrOfFailedTestCases;
+			if (reportTestCases) std::cerr << "FAIL: table[" << i << "] : " << table[i] << " != " << ref << '\n';
+		}
+	}
+
+	constexpr Real e = ExpTaylor(Real(1));
+	static_assert(e > Real(2.7) && e < Real(2.72), "constexpr polynomial evaluation failed");
+	constexpr Real a(1.5), b(-0.25);
+	static_assert(a + b == Real(1.25), "constexpr addition failed");
+	static_assert(a - b == Real(1.75), "constexpr subtraction failed");
+	static_assert(a * b == Real(-0.375), "constexpr multiplication failed");
+	static_assert(b / a < Real(0), "constexpr division failed");
+	static_assert(Real(0.1) < Real(0.2), "constexpr comparison failed");
+
+	// the constant evaluation must agree with the run-time arithmetic
+	Real x(1);
+	if (e != ExpTaylor(x)) {
+		++nrOfFailedTestCases;
+		if (reportTestCases) std::cerr << "FAIL: exp(1) : " << e << " != " << ExpTaylor(x) << '\n';
+	}
+	constexpr Real c = Real(1) / Real(3);
+	if (c != Real(1) / x / Real(3)) ++nrOfFailedTestCases;
+	return nrOfFailedTestCases;
+}
+#endif // BIT_CAST_IS_CONSTEXPR
 
 int main()
-{
-    using namespace sw::universal;
-
-//     constexpr sw::universal::posit<32, 2> p1{4.2};
-//     constexpr sw::universal::posit<32, 2> p2= 4.3;
-    posit<32, 2> a(SpecificValue::maxpos);
-    
-    return 0;
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "posit constexpr arithmetic";
+	std::string test_tag    = "constexpr";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if BIT_CAST_IS_CONSTEXPR
+	nrOfFailedTestCases += ReportTestResult(VerifyConstexprArithmetic< posit<16, 1> >(reportTestCases), "posit<16,1>", "constexpr arithmetic");
+	nrOfFailedTestCases += ReportTestResult(VerifyConstexprArithmetic< posit<32, 2> >(reportTestCases), "posit<32,2>", "constexpr arithmetic");
+#else
+	std::cout << "constexpr posit arithmetic requires bit_cast support\n";
+#endif // BIT_CAST_IS_CONSTEXPR
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
 }
@@ -0,0 +1,260 @@
+// arithmetic.cpp: test suite runner for the integer decode/round arithmetic of generalized posits
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <cmath>
+#include <random>
+// Configure the posit template environment
+// first: enable general or specialized configurations
+#define POSIT_FAST_SPECIALIZATION
+// second: enable/disable arithmetic exceptions
+#define POSIT_THROW_ARITHMETIC_EXCEPTION 0
+#include <universal/number/posit2/posit.hpp>
+#include <universal/verification/test_suite.hpp>
+
+/*
+   The posit2 operators decode the encodings into a sign, scale, and significand word,
+   compute the result in that word, and round the bit string of the result once. The
+   reference below decodes the encoding bit by bit into a double, and rounds a double
+   to the nearest encoding by bisection: the rounding midpoint between two adjacent
+   posit<nbits,es> encodings is the posit<nbits+1,es> encoding in between them, and
+   ties round to the even encoding. For nbits <= 10 the sum, difference, product, and
+   quotient of two posits are exact in a double, so the reference is exact.
+*/
+
+// decode a posit<nbits,es> encoding into a double, field by field
+template<unsigned nbits, unsigned es>
+double ReferenceValue(std::uint64_t bits) {
+	std::uint64_t mask = (nbits == 64 ? ~0ull : (1ull << nbits) - 1);
+	bits &= mask;
+	if (bits == 0) return 0.0;
+	if (bits == (1ull << (nbits - 1))) return std::nan("");
+	bool s = (bits >> (nbits - 1)) & 1;
+	if (s) bits = (~bits + 1) & mask;
+	int i = int(nbits) - 2;
+	bool r0 = (bits >> i) & 1;
+	int run = 0;
+	while (i >= 0 && (((bits >> i) & 1) == r0)) { ++run; --i; }
+	--i; // regime terminator
+	int k = (r0 ? run - 1 : -run);
+	int e = 0;
+	for (unsigned j = 0; j < es; ++j) {
+		e <<= 1;
+		if (i >= 0) { e |= (bits >> i) & 1; --i; }
+	}
+	double f = 1.0, w = 0.5;
+	for (; i >= 0; --i, w /= 2) if ((bits >> i) & 1) f += w;
+	double v = std::ldexp(f, k * (1 << es) + e);
+	return (s ? -v : v);
+}
+
+// round a double to the nearest posit<nbits,es> encoding
+template<unsigned nbits, unsigned es>
+std::uint64_t ReferenceRound(double v) {
+	std::uint64_t mask = (nbits == 64 ? ~0ull : (1ull << nbits) - 1);
+	if (v == 0.0) return 0;
+	bool s = v < 0;
+	double a = std::fabs(v);
+	std::uint64_t maxpos = (1ull << (nbits - 1)) - 1;
+	std::uint64_t r;
+	if (a >= ReferenceValue<nbits, es>(maxpos)) r = maxpos;
+	else if (a <= ReferenceValue<nbits, es>(1)) r = 1;
+	else {
+		std::uint64_t lo = 1, hi = maxpos;  // largest encoding lo with a value <= a
+		while (hi - lo > 1) {
+			std::uint64_t mid = (lo + hi) / 2;
+			if (ReferenceValue<nbits, es>(mid) <= a) lo = mid; else hi = mid;
+		}
+		if (ReferenceValue<nbits, es>(lo) == a) r = lo;
+		else {
+			double midpoint = ReferenceValue<nbits + 1, es>((lo << 1) | 1);
+			if (a < midpoint) r = lo; else if (a > midpoint) r = lo + 1; else r = ((lo & 1) ? lo + 1 : lo);
+		}
+	}
+	return (s ? ((~r + 1) & mask) : r);
+}
+
+// enumerate all conversions and all arithmetic operations of a small posit configuration
+template<unsigned nbits, unsigned es>
+int VerifyArithmetic(bool reportTestCases) {
+	using namespace sw::universal;
+	using Posit = posit<nbits, es>;
+	constexpr std::uint64_t NR_ENCODINGS = (1ull << nbits);
+
+	int nrOfFailedTests = 0;
+	Posit a, b, c;
+	auto report = [&](const char* op, double da, double db, std::uint64_t ref) {
+		if (reportTestCases && nrOfFailedTests < 10) {
+			std::cerr << "FAIL " << type_tag(a) << ' ' << op << ' ' << da << ", " << db << " = " << to_binary(c) << " reference " << ref << '\n';
+		}
+		++nrOfFailedTests;
+	};
+	for (std::uint64_t i = 0; i < NR_ENCODINGS; ++i) {
+		a.setbits(i);
+		if (a.isnar()) continue;
+		double da = ReferenceValue<nbits, es>(i);
+		if (double(a) != da) report("to_native", da, 0.0, i);
+		c = Posit(da);
+		if (c.encoding() != i) report("assign", da, 0.0, i);
+		for (std::uint64_t j = 0; j < NR_ENCODINGS; ++j) {
+			b.setbits(j);
+			if (b.isnar()) continue;
+			double db = ReferenceValue<nbits, es>(j);
+			std::uint64_t ref;
+			c = a + b; ref = ReferenceRound<nbits, es>(da + db); if (c.encoding() != ref) report("+", da, db, ref);
+			c = a - b; ref = ReferenceRound<nbits, es>(da - db); if (c.encoding() != ref) report("-", da, db, ref);
+			c = a * b; ref = ReferenceRound<nbits, es>(da * db); if (c.encoding() != ref) report("*", da, db, ref);
+			if (b.iszero()) continue;
+			c = a / b; ref = ReferenceRound<nbits, es>(da / db); if (c.encoding() != ref) report("/", da, db, ref);
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the uint64_t register and the limb register must produce the same encodings
+template<unsigned nbits, unsigned es, unsigned nrLimbs>
+int VerifyLimbRegister(unsigned nrRandoms, bool reportTestCases) {
+	using namespace sw::universal::internal;
+	std::uint64_t mask = (nbits == 64 ? ~0ull : (1ull << nbits) - 1);
+	std::uint64_t nar = 1ull << (nbits - 1);
+	std::mt19937_64 engine(nbits);
+
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrRandoms; ++t) {
+		std::uint64_t a = engine() & mask, b = engine() & mask;
+		if (t % 4 == 1) b = (a + (engine() & 0xF)) & mask;       // close operands
+		if (t % 4 == 2) b = (~a + 1 + (engine() & 0x3)) & mask;  // cancellation
+		if (a == 0 || b == 0 || a == nar || b == nar) continue;
+		posit_limbs<nrLimbs> A(a), B(b);
+		bool fail = (posit_fast_add<nbits, es>(a, b) != posit_fast_add<nbits, es>(A, B).limb[0])
+			|| (posit_fast_mul<nbits, es>(a, b) != posit_fast_mul<nbits, es>(A, B).limb[0])
+			|| (posit_fast_div<nbits, es>(a, b) != posit_fast_div<nbits, es>(A, B).limb[0]);
+		if (fail) {
+			if (reportTestCases && nrOfFailedTests < 10) std::cerr << "FAIL posit<" << nbits << ',' << es << "> limb register " << std::hex << a << ", " << b << std::dec << '\n';
+			++nrOfFailedTests;
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// limb configurations: the operations on small integers are exact
+template<unsigned nbits, unsigned es, typename bt>
+int VerifyWideConfiguration(bool reportTestCases) {
+	using namespace sw::universal;
+	using Posit = posit<nbits, es, bt>;
+
+	int nrOfFailedTests = 0;
+	Posit a(1.5), b(2.25), three(3.0), one(1.0);
+	auto check = [&](const char* op, const Posit& c, double ref) {
+		if (double(c) != ref) {
+			if (reportTestCases) std::cerr << "FAIL " << type_tag(c) << ' ' << op << " : " << c << " reference " << ref << '\n';
+			++nrOfFailedTests;
+		}
+	};
+	check("+", a + b, 3.75);
+	check("-", a - b, -0.75);
+	check("*", a * b, 3.375);
+	check("/", b / a, 1.5);
+	check("/", one / three * three, 1.0);
+	if ((a + b).scale() != 1) {
+		if (reportTestCases) std::cerr << "FAIL " << type_tag(a) << " scale\n";
+		++nrOfFailedTests;
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 0
+#define REGRESSION_LEVEL_4 0
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "generalized posit arithmetic";
+	std::string test_tag    = "arithmetic";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+#if MANUAL_TESTING
+
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<5, 1>(reportTestCases), "posit< 5,1>", test_tag);
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS;   // ignore failures
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<3, 0>(reportTestCases), "posit< 3,0>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<4, 0>(reportTestCases), "posit< 4,0>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<4, 1>(reportTestCases), "posit< 4,1>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<5, 1>(reportTestCases), "posit< 5,1>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<6, 0>(reportTestCases), "posit< 6,0>", test_tag);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyWideConfiguration< 64, 0, std::uint8_t >(reportTestCases), "posit< 64,0>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyWideConfiguration< 80, 2, std::uint8_t >(reportTestCases), "posit< 80,2>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyWideConfiguration<128, 2, std::uint32_t>(reportTestCases), "posit<128,2>", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<8, 0>(reportTestCases), "posit< 8,0>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<8, 1>(reportTestCases), "posit< 8,1>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<8, 2>(reportTestCases), "posit< 8,2>", test_tag);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<16, 1, 1>(10000, reportTestCases), "posit<16,1> limbs", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<32, 2, 2>(10000, reportTestCases), "posit<32,2> limbs", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_3
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<8, 3>(reportTestCases), "posit< 8,3>", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyArithmetic<10, 1>(reportTestCases), "posit<10,1>", test_tag);
+
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<48, 2, 2>(100000, reportTestCases), "posit<48,2> limbs", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<64, 2, 1>(100000, reportTestCases), "posit<64,2> limbs", test_tag);
+#endif
+
+#if REGRESSION_LEVEL_4
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<32, 2, 2>(1000000, reportTestCases), "posit<32,2> limbs", test_tag);
+	nrOfFailedTestCases += ReportTestResult(VerifyLimbRegister<64, 3, 2>(1000000, reportTestCases), "posit<64,3> limbs", test_tag);
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << "Caught ad-hoc exception: " << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Caught unexpected universal arithmetic exception : " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Caught unexpected universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Caught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
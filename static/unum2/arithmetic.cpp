@@ -0,0 +1,279 @@
+// arithmetic.cpp: functional tests of the lattice lookup-table arithmetic of type II unums
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <random>
+#include <universal/number/unum2/unum2_impl.hpp>
+#include <universal/number/unum2/manipulators.hpp>
+#include <universal/verification/test_reporters.hpp>
+
+/*
+   The reference arithmetic computes the exact rational result of an operation on exact values,
+   and finds its encoding with a linear scan of the lattice: it shares no code with the tables.
+*/
+
+// a signed rational number
+struct Rational { int64_t num, den; };
+
+template<typename Engine>
+Rational ExactValue(unsigned i) {
+	bool negative = Engine::isneg(i);
+	auto r = Engine::exact((negative ? Engine::negate(i) : i) / 2);
+	return Rational{ negative ? -r.num : r.num, r.den };
+}
+
+// encoding of a rational number by a linear scan of the exact values
+template<typename Engine>
+unsigned ReferenceEncoding(Rational r) {
+	if (r.den < 0) { r.num = -r.num; r.den = -r.den; }
+	if (r.num == 0) return 0;
+	bool negative = r.num < 0;
+	int64_t n = negative ? -r.num : r.num;
+	unsigned encoding = Engine::INF - 1;
+	for (unsigned p = 1; p <= Engine::P; ++p) {
+		auto e = Engine::exact(p);
+		if (e.num * r.den == n * e.den) { encoding = 2 * p; break; }
+		if (e.num * r.den > n * e.den) { encoding = 2 * p - 1; break; }
+	}
+	return negative ? Engine::negate(encoding) : encoding;
+}
+
+// the four operations on all pairs of finite exact values
+template<unsigned nbits, typename Lattice>
+int VerifyExactArithmetic(bool reportTestCases) {
+	using Engine = sw::universal::unum2_engine<nbits, Lattice>;
+	int nrOfFailedTests = 0;
+	for (unsigned x = 0; x < Engine::NR_ENCODINGS; x += 2) {
+		if (x == Engine::INF) continue;
+		for (unsigned y = 0; y < Engine::NR_ENCODINGS; y += 2) {
+			if (y == Engine::INF) continue;
+			Rational a = ExactValue<Engine>(x), b = ExactValue<Engine>(y);
+			if (x == 0) a = Rational{ 0, 1 };
+			if (y == 0) b = Rational{ 0, 1 };
+			unsigned ref[4] = {
+				ReferenceEncoding<Engine>(Rational{ a.num * b.den + b.num * a.den, a.den * b.den }),
+				ReferenceEncoding<Engine>(Rational{ a.num * b.den - b.num * a.den, a.den * b.den }),
+				ReferenceEncoding<Engine>(Rational{ a.num * b.num, a.den * b.den }),
+				(y == 0 ? Engine::INF : ReferenceEncoding<Engine>(Rational{ a.num * b.den, a.den * b.num }))
+			};
+			unsigned result[4] = { Engine::add(x, y), Engine::sub(x, y), Engine::mul(x, y), Engine::div(x, y) };
+			for (unsigned k = 0; k < 4; ++k) {
+				if (result[k] != ref[k]) {
+					++nrOfFailedTests;
+					if (reportTestCases) std::cerr << "FAIL: " << x << ' ' << "+-*/"[k] << ' ' << y << " = " << result[k] << " reference " << ref[k] << '\n';
+				}
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the results of an open interval operand contain the result of a point in the interval
+template<unsigned nbits, typename Lattice>
+int VerifyContainment(bool reportTestCases) {
+	using Engine = sw::universal::unum2_engine<nbits, Lattice>;
+	// a point inside every encoding: the exact value, or a point between the bounds of an open interval
+	auto sample = [](unsigned i) {
+		if (Engine::isexact(i)) return (i == 0 ? Rational{ 0, 1 } : ExactValue<Engine>(i));
+		unsigned lo = (i - 1) & Engine::MASK, hi = (i + 1) & Engine::MASK;
+		bool negative = Engine::isneg(i);
+		if (negative) { unsigned t = Engine::negate(lo); lo = Engine::negate(hi); hi = t; }
+		Rational r;
+		if (lo == 0) { Rational h = ExactValue<Engine>(hi); r = Rational{ h.num, 2 * h.den }; }
+		else if (hi == Engine::INF) { Rational l = ExactValue<Engine>(lo); r = Rational{ 2 * l.num, l.den }; }
+		else { Rational l = ExactValue<Engine>(lo), h = ExactValue<Engine>(hi); r = Rational{ l.num * h.den + h.num * l.den, 2 * l.den * h.den }; }
+		return (negative ? Rational{ -r.num, r.den } : r);
+	};
+	auto inside = [](unsigned r, typename Engine::span s) {
+		return Engine::ordinal(s.lo) <= Engine::ordinal(r) && Engine::ordinal(r) <= Engine::ordinal(s.hi);
+	};
+	int nrOfFailedTests = 0;
+	for (unsigned x = 0; x < Engine::NR_ENCODINGS; ++x) {
+		if (x == Engine::INF) continue;
+		for (unsigned y = 0; y < Engine::NR_ENCODINGS; ++y) {
+			if (y == Engine::INF) continue;
+			Rational a = sample(x), b = sample(y);
+			typename Engine::span s[3] = { Engine::add_span(x, y), Engine::sub_span(x, y), Engine::mul_span(x, y) };
+			unsigned ref[3] = {
+				ReferenceEncoding<Engine>(Rational{ a.num * b.den + b.num * a.den, a.den * b.den }),
+				ReferenceEncoding<Engine>(Rational{ a.num * b.den - b.num * a.den, a.den * b.den }),
+				ReferenceEncoding<Engine>(Rational{ a.num * b.num, a.den * b.den })
+			};
+			for (unsigned k = 0; k < 3; ++k) {
+				unsigned result = Engine::middle(s[k]);
+				if (!inside(ref[k], s[k]) || !inside(result, s[k])) {
+					++nrOfFailedTests;
+					if (reportTestCases) std::cerr << "FAIL: " << x << ' ' << "+-*"[k] << ' ' << y << " span [" << s[k].lo << ", " << s[k].hi << "] does not contain " << ref[k] << '\n';
+				}
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// the results are symmetric under commutation, negation, and reciprocation
+template<unsigned nbits, typename Lattice>
+int VerifySymmetries(bool reportTestCases) {
+	using Engine = sw::universal::unum2_engine<nbits, Lattice>;
+	int nrOfFailedTests = 0;
+	for (unsigned x = 0; x < Engine::NR_ENCODINGS; ++x) {
+		for (unsigned y = 0; y < Engine::NR_ENCODINGS; ++y) {
+			bool pass = true;
+			pass = pass && Engine::add(x, y) == Engine::add(y, x);
+			pass = pass && Engine::mul(x, y) == Engine::mul(y, x);
+			pass = pass && Engine::add(Engine::negate(x), Engine::negate(y)) == Engine::negate(Engine::add(x, y));
+			pass = pass && Engine::mul(Engine::negate(x), y) == Engine::negate(Engine::mul(x, y));
+			bool finite = (x != 0 && y != 0 && x != Engine::INF && y != Engine::INF);
+			if (finite) pass = pass && Engine::mul(Engine::reciprocal(x), Engine::reciprocal(y)) == Engine::reciprocal(Engine::mul(x, y));
+			if (!pass) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: symmetries of " << x << " and " << y << '\n';
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// conversion and the arithmetic operators of the unum2 class
+template<unsigned nbits, typename Lattice>
+int VerifyOperators(bool reportTestCases) {
+	using namespace sw::universal;
+	using Unum = unum2<nbits, Lattice>;
+	int nrOfFailedTests = 0;
+	Unum a(0.5), b(2), c(3), inf(SpecificValue::infpos);
+	auto check = [&](bool pass, const char* what) {
+		if (!pass) {
+			++nrOfFailedTests;
+			if (reportTestCases) std::cerr << "FAIL: " << what << '\n';
+		}
+	};
+	check(double(a) == 0.5 && a.isexact(), "0.5 is exact");
+	check(double(b) == 2.0 && b.isexact(), "2 is exact");
+	check(!c.isexact() && c.lower_bound() == 2.0 && c.upper_bound() == 5.0, "3 is in (2, 5)");
+	check(a * b == Unum(1), "0.5 * 2 == 1");
+	check(b / a == Unum(4) && !(b / a).isexact(), "2 / 0.5 is in (2, 5)");
+	check(reciprocate(b) == a, "1 / 2 == 0.5");
+	check(b - b == Unum(0) && (b - b).iszero(), "2 - 2 == 0");
+	check(b + Unum(5) == Unum(7) && (b + Unum(5)).lower_bound() == 5.0, "2 + 5 is in (5, 10)");
+	check(Unum(10) * Unum(10) == Unum(SpecificValue::maxpos) + Unum(1e6), "10 * 10 is in (10, inf)");
+	check((inf + b).isinf() && (inf * Unum(0)).isinf() && (Unum(1) / Unum(0)).isinf(), "inf absorbs");
+	check(-b < a && a < b && inf < -b, "order");
+	Unum x(1);
+	++x;
+	check(!x.isexact() && x.lower_bound() == 1.0 && x.upper_bound() == 2.0, "the encoding after 1 is (1, 2)");
+	check(type_tag(a) == "unum2<5,{1,2,5,10}>", "type tag");
+	return nrOfFailedTests;
+}
+
+// random exact operands of a lattice whose tables are built at the first operation
+template<unsigned nbits, typename Lattice>
+int VerifyRandomExactArithmetic(unsigned nrOfRandoms, bool reportTestCases) {
+	using Engine = sw::universal::unum2_engine<nbits, Lattice>;
+	static_assert(!Engine::compileTimeTables, "this test is for the tables built at run time");
+	std::mt19937 engine(nbits);
+	std::uniform_int_distribution<unsigned> distribution(0, Engine::NR_ENCODINGS / 2 - 1);
+	int nrOfFailedTests = 0;
+	for (unsigned t = 0; t < nrOfRandoms; ++t) {
+		unsigned x = 2 * distribution(engine), y = 2 * distribution(engine);
+		if (x == 0 || y == 0 || x == Engine::INF || y == Engine::INF) continue;
+		Rational a = ExactValue<Engine>(x), b = ExactValue<Engine>(y);
+		unsigned ref[3] = {
+			ReferenceEncoding<Engine>(Rational{ a.num * b.den + b.num * a.den, a.den * b.den }),
+			ReferenceEncoding<Engine>(Rational{ a.num * b.num, a.den * b.den }),
+			ReferenceEncoding<Engine>(Rational{ a.num * b.den, a.den * b.num })
+		};
+		unsigned result[3] = { Engine::add(x, y), Engine::mul(x, y), Engine::div(x, y) };
+		for (unsigned k = 0; k < 3; ++k) {
+			if (result[k] != ref[k]) {
+				++nrOfFailedTests;
+				if (reportTestCases) std::cerr << "FAIL: " << x << ' ' << "+*/"[k] << ' ' << y << " = " << result[k] << " reference " << ref[k] << '\n';
+			}
+		}
+	}
+	return nrOfFailedTests;
+}
+
+// Regression testing guards: typically set by the cmake configuration, but MANUAL_TESTING is an override
+#define MANUAL_TESTING 0
+// REGRESSION_LEVEL_OVERRIDE is set by the cmake file to drive a specific regression intensity
+// It is the responsibility of the regression test to organize the tests in a quartile progression.
+//#undef REGRESSION_LEVEL_OVERRIDE
+#ifndef REGRESSION_LEVEL_OVERRIDE
+#undef REGRESSION_LEVEL_1
+#undef REGRESSION_LEVEL_2
+#undef REGRESSION_LEVEL_3
+#undef REGRESSION_LEVEL_4
+#define REGRESSION_LEVEL_1 1
+#define REGRESSION_LEVEL_2 1
+#define REGRESSION_LEVEL_3 1
+#define REGRESSION_LEVEL_4 1
+#endif
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "unum2 lattice arithmetic";
+	std::string test_tag    = "arithmetic";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	ReportTestSuiteHeader(test_suite, reportTestCases);
+
+	// a lattice with fractions: 1, 3/2, 2, 4
+	using fractional_lattice = ulattice<std::ratio<1>, std::ratio<3, 2>, std::ratio<2>, std::ratio<4>>;
+
+#if MANUAL_TESTING
+
+	using Unum = unum2<5, decade_lattice>;
+	for (unsigned i = 0; i < 32; ++i) {
+		Unum u;
+		u.setbits(i);
+		std::cout << info_print(u) << '\n';
+	}
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return EXIT_SUCCESS; // ignore errors
+#else
+
+#if REGRESSION_LEVEL_1
+	nrOfFailedTestCases += ReportTestResult(VerifyExactArithmetic<5, decade_lattice>(reportTestCases), "unum2<5,{1,2,5,10}>", "exact operands");
+	nrOfFailedTestCases += ReportTestResult(VerifyExactArithmetic<5, fractional_lattice>(reportTestCases), "unum2<5,{1,3/2,2,4}>", "exact operands");
+	nrOfFailedTestCases += ReportTestResult(VerifyExactArithmetic<6, linear_lattice<8>>(reportTestCases), "unum2<6,{1..8}>", "exact operands");
+	nrOfFailedTestCases += ReportTestResult(VerifyContainment<5, decade_lattice>(reportTestCases), "unum2<5,{1,2,5,10}>", "open intervals");
+	nrOfFailedTestCases += ReportTestResult(VerifyContainment<5, fractional_lattice>(reportTestCases), "unum2<5,{1,3/2,2,4}>", "open intervals");
+	nrOfFailedTestCases += ReportTestResult(VerifySymmetries<5, decade_lattice>(reportTestCases), "unum2<5,{1,2,5,10}>", "symmetries");
+	nrOfFailedTestCases += ReportTestResult(VerifyOperators<5, decade_lattice>(reportTestCases), "unum2<5,{1,2,5,10}>", "operators");
+#endif
+
+#if REGRESSION_LEVEL_2
+	nrOfFailedTestCases += ReportTestResult(VerifyExactArithmetic<8, linear_lattice<32>>(reportTestCases), "unum2<8,{1..32}>", "exact operands");
+	nrOfFailedTestCases += ReportTestResult(VerifyContainment<6, linear_lattice<8>>(reportTestCases), "unum2<6,{1..8}>", "open intervals");
+	nrOfFailedTestCases += ReportTestResult(VerifySymmetries<8, linear_lattice<32>>(reportTestCases), "unum2<8,{1..32}>", "symmetries");
+#endif
+
+#if REGRESSION_LEVEL_3
+	nrOfFailedTestCases += ReportTestResult(VerifyRandomExactArithmetic<10, linear_lattice<128>>(10000, reportTestCases), "unum2<10,{1..128}>", "exact operands");
+#endif
+
+#if REGRESSION_LEVEL_4
+#endif
+
+	ReportTestSuiteResults(test_suite, nrOfFailedTestCases);
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+#endif  // MANUAL_TESTING
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,82 @@
+// benchmark_compare.cpp: cli to detect performance regressions between two benchmark harness result files
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <universal/utility/directives.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <universal/benchmark/benchmark_report.hpp>
+
+void usage(const char* program) {
+	std::cerr << "usage: " << program << " baseline.json candidate.json [--threshold PERCENT] [--noise FACTOR]\n"
+		<< "  compares the median time per operation of each workload in two benchmark harness JSON files\n"
+		<< "  --threshold : minimum relative change to report, default 5%\n"
+		<< "  --noise     : multiple of the combined MAD-based dispersion a change must exceed, default 3\n"
+		<< "  returns EXIT_FAILURE when at least one workload regressed\n";
+}
+
+sw::universal::BenchmarkResultSet load(const std::string& filename) {
+	std::ifstream ifs(filename);
+	if (!ifs) throw std::runtime_error(std::string("unable to open ") + filename);
+	return sw::universal::ReadBenchmarkJSON(ifs);
+}
+
+int main(int argc, char* argv[])
+try {
+	using namespace sw::universal;
+
+	if (argc < 3) {
+		usage(argv[0]);
+		return EXIT_SUCCESS;  // print usage when run without arguments, i.e. as part of the regression suite
+	}
+
+	double threshold{ 0.05 }, noiseFactor{ 3.0 };
+	for (int i = 3; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg == "--threshold" && i + 1 < argc) threshold = std::stod(argv[++i]) / 100.0;
+		else if (arg == "--noise" && i + 1 < argc) noiseFactor = std::stod(argv[++i]);
+		else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	BenchmarkResultSet baseline = load(argv[1]);
+	BenchmarkResultSet candidate = load(argv[2]);
+	std::cout << "baseline : " << argv[1] << " : " << baseline.context.suite << " : " << baseline.context.compiler << " : " << baseline.context.timestamp << '\n';
+	std::cout << "candidate: " << argv[2] << " : " << candidate.context.suite << " : " << candidate.context.compiler << " : " << candidate.context.timestamp << '\n';
+
+	std::vector<BenchmarkComparison> comparisons = CompareBenchmarkResults(baseline, candidate, threshold, noiseFactor);
+	size_t nameWidth = 8;
+	for (const BenchmarkComparison& c : comparisons) nameWidth = std::max(nameWidth, c.name.size());
+
+	int nrOfRegressions{ 0 };
+	std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << "workload" << std::right
+		<< std::setw(15) << "baseline" << std::setw(15) << "candidate" << std::setw(10) << "change" << "  verdict\n";
+	for (const BenchmarkComparison& c : comparisons) {
+		std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << c.name << std::right
+			<< std::setw(15) << c.baseline << std::setw(15) << c.candidate
+			<< std::setw(9) << std::fixed << std::setprecision(1) << 100.0 * c.change << '%' << std::defaultfloat << std::setprecision(6)
+			<< "  " << to_string(c.verdict) << '\n';
+		if (c.verdict == BenchmarkVerdict::Regression) ++nrOfRegressions;
+	}
+	std::cout << nrOfRegressions << " regression" << (nrOfRegressions == 1 ? "" : "s") << " detected\n";
+
+	return (nrOfRegressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (const char* const msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const std::runtime_error& err) {
+	std::cerr << "Uncaught runtime exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,172 @@
+// batch.cpp: testbench for the batch interface of the hardware ALU model
+//
+// Copyright (C) 2017-2023 Stillwater Supercomputing, Inc.
+//
+// This file is part of the universal numbers project, which is released under an MIT Open Source license.
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <universal/number/cfloat/cfloat.hpp>
+#include <universal/number/posit/posit.hpp>
+#include <universal/hw/alu.hpp>
+
+#include <universal/verification/test_status.hpp> // ReportTestResult
+
+namespace sw { namespace universal {
+
+	// the exception flags of an operation, derived from the operands and the scalar reference result
+	template<typename NumberSystemType>
+	uint8_t ReferenceFlags(ALU_OPS op, const NumberSystemType& b, const NumberSystemType& ref) {
+		uint8_t f = ALU_FLAG_NONE;
+		double v = double(ref);
+		if (std::isnan(v)) f |= ALU_FLAG_INVALID;
+		else if (std::isinf(v)) f |= ALU_FLAG_INFINITE;
+		else if (v == 0.0) f |= ALU_FLAG_ZERO;
+		if (op == ALU_OPS::DIV && double(b) == 0.0) f |= ALU_FLAG_DIVBYZERO;
+		return f;
+	}
+
+	// an opcode outside of ALU_OPS is rejected before any operation is executed
+	template<typename NumberSystemType>
+	int VerifyOpcodeRange() {
+		constexpr size_t N = 100;
+		std::vector<ALU_OPS> op(N, ALU_OPS::ADD);
+		std::vector<uint64_t> raw(N, 0), rc(N, 0);
+		std::vector<NumberSystemType> a(N), b(N), c(N);
+		op[N / 2] = static_cast<ALU_OPS>(static_cast<unsigned>(ALU_OPS::SQRT) + 1);
+		int nrOfFailedTestCases = 0;
+		try {
+			ArithmeticLogicUnit(op.data(), a.data(), b.data(), c.data(), nullptr, N);
+			++nrOfFailedTestCases;
+		}
+		catch (const std::invalid_argument&) {}
+		try {
+			ArithmeticLogicUnitEncoded<NumberSystemType>(op.data(), raw.data(), raw.data(), rc.data(), nullptr, N);
+			++nrOfFailedTestCases;
+		}
+		catch (const std::invalid_argument&) {}
+		return nrOfFailedTestCases;
+	}
+
+	// compare the batch ALU against the scalar ALU on a random opcode stream of random encodings
+	template<typename NumberSystemType>
+	int VerifyBatchAlu(size_t N, unsigned nrThreads, bool reportTestCases) {
+		constexpr unsigned nbits = NumberSystemType::nbits;
+		std::mt19937_64 engine(nbits * 1000 + nrThreads);
+		std::uniform_int_distribution<uint64_t> encoding(0, (1ull << nbits) - 1ull);
+		std::uniform_int_distribution<unsigned> opcode(static_cast<unsigned>(ALU_OPS::NOP), static_cast<unsigned>(ALU_OPS::SQRT));
+
+		std::vector<ALU_OPS> op(N);
+		std::vector<uint64_t> ra(N), rb(N), rc(N);
+		std::vector<NumberSystemType> a(N), b(N), c(N);
+		std::vector<uint8_t> flags(N);
+		for (size_t i = 0; i < N; ++i) {
+			op[i] = static_cast<ALU_OPS>(opcode(engine));
+			ra[i] = encoding(engine);
+			rb[i] = encoding(engine);
+			a[i].setbits(ra[i]);
+			b[i].setbits(rb[i]);
+		}
+
+		int nrOfFailedTestCases = 0;
+		uint8_t sticky = ArithmeticLogicUnit(op.data(), a.data(), b.data(), c.data(), flags.data(), N, nrThreads);
+		uint8_t expectedSticky = ALU_FLAG_NONE;
+		for (size_t i = 0; i < N; ++i) {
+			NumberSystemType ref = ArithmeticLogicUnit(op[i], a[i], b[i]);
+			uint8_t expected = ReferenceFlags(op[i], b[i], ref);
+			expectedSticky |= expected;
+			if (c[i] != ref && !(ref.isnar() && c[i].isnar())) {
+				++nrOfFailedTestCases;
+				if (reportTestCases && nrOfFailedTestCases < 10) std::cerr << "FAIL: " << to_binary(a[i]) << ' ' << to_binary(b[i]) << " : " << to_binary(c[i]) << " != " << to_binary(ref) << '\n';
+			}
+			if (flags[i] != expected) {
+				++nrOfFailedTestCases;
+				if (reportTestCases && nrOfFailedTestCases < 10) std::cerr << "FAIL: flags " << int(flags[i]) << " != " << int(expected) << " of " << to_binary(a[i]) << ' ' << to_binary(b[i]) << '\n';
+			}
+		}
+		if (sticky != expectedSticky) ++nrOfFailedTestCases;
+
+		// the raw encoding interface must produce the same encodings
+		std::vector<uint8_t> encodedFlags(N);
+		if (ArithmeticLogicUnitEncoded<NumberSystemType>(op.data(), ra.data(), rb.data(), rc.data(), encodedFlags.data(), N, nrThreads) != expectedSticky) ++nrOfFailedTestCases;
+		for (size_t i = 0; i < N; ++i) {
+			NumberSystemType v;
+			v.setbits(rc[i]);
+			if (v != c[i] && !(v.isnar() && c[i].isnar())) ++nrOfFailedTestCases;
+			if (encodedFlags[i] != flags[i]) ++nrOfFailedTestCases;
+		}
+		return nrOfFailedTestCases;
+	}
+
+	template<typename NumberSystemType>
+	int VerifyBatchAluCfloat(size_t N, unsigned nrThreads, bool reportTestCases) {
+		constexpr unsigned nbits = NumberSystemType::nbits;
+		std::mt19937_64 engine(nbits * 1000 + nrThreads);
+		std::uniform_int_distribution<uint64_t> encoding(0, (1ull << nbits) - 1ull);
+		std::uniform_int_distribution<unsigned> opcode(static_cast<unsigned>(ALU_OPS::NOP), static_cast<unsigned>(ALU_OPS::SQRT));
+
+		std::vector<ALU_OPS> op(N);
+		std::vector<NumberSystemType> a(N), b(N), c(N);
+		std::vector<uint8_t> flags(N);
+		constexpr uint64_t signMask = ~(1ull << (nbits - 1));
+		for (size_t i = 0; i < N; ++i) {
+			op[i] = static_cast<ALU_OPS>(opcode(engine));
+			// cfloat sqrt reports negative arguments on std::cerr, keep the sqrt operands positive
+			a[i].setbits(op[i] == ALU_OPS::SQRT ? (encoding(engine) & signMask) : encoding(engine));
+			b[i].setbits(encoding(engine));
+		}
+
+		int nrOfFailedTestCases = 0;
+		uint8_t sticky = ArithmeticLogicUnit(op.data(), a.data(), b.data(), c.data(), flags.data(), N, nrThreads);
+		uint8_t expectedSticky = ALU_FLAG_NONE;
+		for (size_t i = 0; i < N; ++i) {
+			NumberSystemType ref = ArithmeticLogicUnit(op[i], a[i], b[i]);
+			uint8_t expected = ReferenceFlags(op[i], b[i], ref);
+			expectedSticky |= expected;
+			if (flags[i] != expected) ++nrOfFailedTestCases;
+			if (ref.isnan()) {
+				if (!c[i].isnan() || !(flags[i] & ALU_FLAG_INVALID)) ++nrOfFailedTestCases;
+			}
+			else if (c[i] != ref) {
+				++nrOfFailedTestCases;
+				if (reportTestCases && nrOfFailedTestCases < 10) std::cerr << "FAIL: " << to_binary(a[i]) << ' ' << to_binary(b[i]) << " : " << to_binary(c[i]) << " != " << to_binary(ref) << '\n';
+			}
+		}
+		if (sticky != expectedSticky) ++nrOfFailedTestCases;
+		return nrOfFailedTestCases;
+	}
+
+}} // namespace sw::universal
+
+int main()
+try {
+	using namespace sw::universal;
+
+	std::string test_suite  = "batch ALU";
+	bool reportTestCases    = true;
+	int nrOfFailedTestCases = 0;
+
+	std::cout << test_suite << '\n';
+
+	constexpr size_t N = 10000;  // spans multiple chunks, the last one partial
+	nrOfFailedTestCases += ReportTestResult(VerifyBatchAlu< posit<8, 2> >(N, 1, reportTestCases), "posit<8,2>", "batch ALU");
+	nrOfFailedTestCases += ReportTestResult(VerifyBatchAlu< posit<16, 1> >(N, 1, reportTestCases), "posit<16,1>", "batch ALU");
+	nrOfFailedTestCases += ReportTestResult(VerifyBatchAlu< posit<16, 1> >(N, 3, reportTestCases), "posit<16,1>", "multithreaded batch ALU");
+	nrOfFailedTestCases += ReportTestResult(VerifyBatchAluCfloat< cfloat<8, 2, uint8_t, true, true, false> >(N, 1, reportTestCases), "cfloat<8,2>", "batch ALU");
+	nrOfFailedTestCases += ReportTestResult(VerifyBatchAluCfloat< cfloat<16, 5, uint16_t, true, false, false> >(N, 2, reportTestCases), "cfloat<16,5>", "multithreaded batch ALU");
+
+	nrOfFailedTestCases += ReportTestResult(VerifyOpcodeRange< posit<16, 1> >(), "posit<16,1>", "opcode range");
+
+	std::cout << test_suite << (nrOfFailedTestCases > 0 ? ": FAIL" : ": PASS") << '\n';
+	return (nrOfFailedTestCases > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+catch (char const* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}